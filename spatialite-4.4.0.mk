@@ -136,6 +136,7 @@ LOCAL_SRC_FILES := \
  $(SPATIALITE_PATH)/src/spatialite/virtualbbox.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualdbf.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualelementary.c \
+ $(SPATIALITE_PATH)/src/spatialite/virtualexif.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualfdo.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualgpkg.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualknn.c \
@@ -143,6 +144,8 @@ LOCAL_SRC_FILES := \
  $(SPATIALITE_PATH)/src/spatialite/virtualrouting.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualshape.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualspatialindex.c \
+ $(SPATIALITE_PATH)/src/spatialite/virtualspatialjoin.c \
+ $(SPATIALITE_PATH)/src/spatialite/virtualzonemap.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualXL.c \
  $(SPATIALITE_PATH)/src/spatialite/virtualxpath.c \
  $(SPATIALITE_PATH)/src/srsinit/epsg_inlined_00.c \
@@ -70,6 +70,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <spatialite_private.h>
 #include <spatialite/gg_advanced.h>
 #include <spatialite/gaiamatrix.h>
+#include <spatialite/stored_procedures.h>
 
 #ifndef OMIT_GEOS		/* including GEOS */
 #ifdef GEOS_REENTRANT
@@ -370,6 +371,8 @@ init_splite_internal_cache (struct splite_internal_cache *cache)
     cache->SqlProcLogfile = NULL;
     cache->SqlProcLog = NULL;
     cache->SqlProcContinue = 1;
+    cache->SqlProcCompiled = NULL;
+    cache->SqlProcStmtCache = 0;
     cache->pool_index = -1;
     cache->gaia_geos_error_msg = NULL;
     cache->gaia_geos_warning_msg = NULL;
@@ -413,12 +416,14 @@ init_splite_internal_cache (struct splite_internal_cache *cache)
     p->crc32 = 0;
     p->geosGeom = NULL;
     p->preparedGeosGeom = NULL;
+    p->pipIndex = NULL;
     p = &(cache->cacheItem2);
     memset (p->gaiaBlob, '\0', 64);
     p->gaiaBlobSize = 0;
     p->crc32 = 0;
     p->geosGeom = NULL;
     p->preparedGeosGeom = NULL;
+    p->pipIndex = NULL;
     for (i = 0; i < MAX_XMLSCHEMA_CACHE; i++)
       {
 	  /* initializing the XmlSchema cache */
@@ -429,6 +434,17 @@ init_splite_internal_cache (struct splite_internal_cache *cache)
 	  p_xmlSchema->parserCtxt = NULL;
 	  p_xmlSchema->schema = NULL;
       }
+    for (i = 0; i < MAX_ELLPS_CACHE; i++)
+      {
+	  /* initializing the Ellipsoid cache */
+	  cache->ellpsCache[i].srid = -1;
+	  cache->ellpsCache[i].a = 0.0;
+	  cache->ellpsCache[i].b = 0.0;
+	  cache->ellpsCache[i].rf = 0.0;
+      }
+    cache->next_ellps_cache = 0;
+    cache->ellps_total_changes = -1;
+    cache->ellps_data_version = 0;
 }
 
 #ifdef GEOS_REENTRANT		/* reentrant (thread-safe) initialization */
@@ -776,6 +792,7 @@ free_internal_cache (struct splite_internal_cache *cache)
     if (cache->SqlProcLog != NULL)
 	fclose (cache->SqlProcLog);
     cache->SqlProcLog = NULL;
+    gaia_stored_proc_reset_compiled (cache, NULL);
     free_sequences (cache);
     free_shp_extents (cache);
 
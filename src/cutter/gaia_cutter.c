@@ -75,6 +75,7 @@ CIG: 6038019AE5
 
 #include <spatialite.h>
 #include <spatialite_private.h>
+#include <splite_thread.h>
 #include <spatialite/gaiaaux.h>
 
 #ifndef OMIT_GEOS		/* only if GEOS is enabled */
@@ -173,6 +174,45 @@ struct cut_solution
     struct cut_item *last;
 };
 
+#define CUTTER_MAX_THREADS	64
+#define CUTTER_BATCH_SIZE	4096
+
+#define CUTTER_JOB_INTERSECTION	1
+#define CUTTER_JOB_DIFF_LINES	2
+#define CUTTER_JOB_DIFF_POLYGS	3
+
+struct cutter_job
+{
+/* a struct wrapping a GEOS operation delegated to some worker */
+    int mode;
+    sqlite3_int64 pk;
+    struct temporary_row row;
+    gaiaGeomCollPtr input;
+    gaiaGeomCollPtr blade;
+    int owns_blade;
+    int n_results;
+    gaiaGeomCollPtr *results;
+};
+
+struct cutter_pool
+{
+/* a struct wrapping the worker threads and the pending batch */
+    int num_threads;
+    const void *caches[CUTTER_MAX_THREADS];
+    struct cutter_job *jobs;
+    int count;
+    int size;
+    int next_job;
+    splite_mutex_t mutex;
+};
+
+struct cutter_worker
+{
+/* a struct wrapping a single worker thread */
+    struct cutter_pool *pool;
+    const void *cache;
+};
+
 static struct multivar *
 alloc_multivar (void)
 {
@@ -3629,6 +3669,398 @@ do_populate_temp_linestrings (struct output_table *tbl, sqlite3 * handle,
     return 0;
 }
 
+static struct cutter_pool *
+create_cutter_pool (const void *cache, int num_threads)
+{
+/* creating the worker threads pool - NULL means sequential mode */
+    struct cutter_pool *pool;
+    int i;
+
+    if (num_threads > CUTTER_MAX_THREADS)
+	num_threads = CUTTER_MAX_THREADS;
+    if (num_threads <= 1 || cache == NULL)
+	return NULL;
+    pool = malloc (sizeof (struct cutter_pool));
+    if (pool == NULL)
+	return NULL;
+    pool->caches[0] = cache;
+    pool->num_threads = 1;
+    for (i = 1; i < num_threads; i++)
+      {
+	  /* each worker requires its own private GEOS handle */
+	  void *worker_cache = spatialite_alloc_connection ();
+	  if (worker_cache == NULL)
+	      break;
+	  pool->caches[i] = worker_cache;
+	  pool->num_threads += 1;
+      }
+    pool->jobs = NULL;
+    pool->count = 0;
+    pool->size = 0;
+    pool->next_job = 0;
+    splite_mutex_init (&(pool->mutex));
+    return pool;
+}
+
+static void
+reset_cutter_batch (struct cutter_pool *pool)
+{
+/* memory cleanup - resetting the pending batch */
+    int i;
+    int j;
+
+    for (i = 0; i < pool->count; i++)
+      {
+	  struct cutter_job *job = pool->jobs + i;
+	  reset_temporary_row (&(job->row));
+	  if (job->input != NULL)
+	      gaiaFreeGeomColl (job->input);
+	  if (job->owns_blade && job->blade != NULL)
+	      gaiaFreeGeomColl (job->blade);
+	  for (j = 0; j < job->n_results; j++)
+	    {
+		if (job->results[j] != NULL)
+		    gaiaFreeGeomColl (job->results[j]);
+	    }
+	  if (job->results != NULL)
+	      free (job->results);
+      }
+    pool->count = 0;
+}
+
+static void
+destroy_cutter_pool (struct cutter_pool *pool)
+{
+/* memory cleanup - destroying the worker threads pool */
+    int i;
+
+    if (pool == NULL)
+	return;
+    reset_cutter_batch (pool);
+    if (pool->jobs != NULL)
+	free (pool->jobs);
+    for (i = 1; i < pool->num_threads; i++)
+	spatialite_internal_cleanup (pool->caches[i]);
+    splite_mutex_destroy (&(pool->mutex));
+    free (pool);
+}
+
+static struct cutter_job *
+add_cutter_job (struct cutter_pool *pool, int mode, sqlite3_int64 pk,
+		struct temporary_row *row, gaiaGeomCollPtr input,
+		gaiaGeomCollPtr blade, int owns_blade)
+{
+/* appending a Job to the pending batch */
+    struct cutter_job *job;
+
+    if (pool->count >= pool->size)
+      {
+	  /* expanding the batch */
+	  int size = pool->size + CUTTER_BATCH_SIZE;
+	  struct cutter_job *jobs =
+	      realloc (pool->jobs, sizeof (struct cutter_job) * size);
+	  if (jobs == NULL)
+	      return NULL;
+	  pool->jobs = jobs;
+	  pool->size = size;
+      }
+    job = pool->jobs + pool->count;
+    pool->count += 1;
+    job->mode = mode;
+    job->pk = pk;
+    job->row.first_input = NULL;
+    job->row.last_input = NULL;
+    job->row.first_blade = NULL;
+    job->row.last_blade = NULL;
+    if (row != NULL)
+      {
+	  /* the Job takes ownership of all PK values */
+	  job->row = *row;
+	  row->first_input = NULL;
+	  row->last_input = NULL;
+	  row->first_blade = NULL;
+	  row->last_blade = NULL;
+      }
+    job->input = input;
+    job->blade = blade;
+    job->owns_blade = owns_blade;
+    job->n_results = 0;
+    job->results = NULL;
+    return job;
+}
+
+static gaiaGeomCollPtr
+do_snap_difference (const void *cache, gaiaGeomCollPtr input,
+		    gaiaGeomCollPtr union_g)
+{
+/* same as ST_Difference(ST_Snap(input, union, 0.000000001), union) */
+    gaiaGeomCollPtr snapped;
+    gaiaGeomCollPtr result;
+
+    snapped = gaiaSnap_r (cache, input, union_g, 0.000000001);
+    if (snapped == NULL)
+	return NULL;
+    snapped->Srid = input->Srid;
+    result = gaiaGeometryDifference_r (cache, snapped, union_g);
+    gaiaFreeGeomColl (snapped);
+    if (result == NULL)
+	return NULL;
+    if (gaiaIsEmpty (result))
+      {
+	  gaiaFreeGeomColl (result);
+	  return NULL;
+      }
+    return result;
+}
+
+static void
+do_cutter_job (const void *cache, struct cutter_job *job)
+{
+/* executing a single Job - always invoked by some worker thread */
+    gaiaLinestringPtr ln;
+    gaiaPolygonPtr pg;
+    gaiaGeomCollPtr geom;
+    int n = 0;
+
+    if (job->input == NULL || job->blade == NULL)
+	return;                 /* nothing to compute */
+    if (job->mode == CUTTER_JOB_INTERSECTION)
+	n = 1;
+    ln = job->input->FirstLinestring;
+    while (ln != NULL && job->mode == CUTTER_JOB_DIFF_LINES)
+      {
+	  n++;
+	  ln = ln->Next;
+      }
+    pg = job->input->FirstPolygon;
+    while (pg != NULL && job->mode == CUTTER_JOB_DIFF_POLYGS)
+      {
+	  n++;
+	  pg = pg->Next;
+      }
+    if (n == 0)
+	return;
+    job->results = malloc (sizeof (gaiaGeomCollPtr) * n);
+    if (job->results == NULL)
+	return;
+    job->n_results = n;
+    n = 0;
+    switch (job->mode)
+      {
+      case CUTTER_JOB_INTERSECTION:
+	  job->results[0] =
+	      gaiaGeometryIntersection_r (cache, job->input, job->blade);
+	  break;
+      case CUTTER_JOB_DIFF_LINES:
+	  ln = job->input->FirstLinestring;
+	  while (ln != NULL)
+	    {
+		geom = do_prepare_linestring (ln, job->input->Srid);
+		job->results[n++] =
+		    do_snap_difference (cache, geom, job->blade);
+		gaiaFreeGeomColl (geom);
+		ln = ln->Next;
+	    }
+	  break;
+      case CUTTER_JOB_DIFF_POLYGS:
+	  pg = job->input->FirstPolygon;
+	  while (pg != NULL)
+	    {
+		geom = do_prepare_polygon (pg, job->input->Srid);
+		job->results[n++] =
+		    do_snap_difference (cache, geom, job->blade);
+		gaiaFreeGeomColl (geom);
+		pg = pg->Next;
+	    }
+	  break;
+      };
+}
+
+SPLITE_THREAD_PROC (do_cutter_worker, arg)
+{
+/* a worker thread processing Jobs until none is left */
+    struct cutter_worker *worker = (struct cutter_worker *) arg;
+    struct cutter_pool *pool = worker->pool;
+    while (1)
+      {
+	  int i;
+	  splite_mutex_lock (&(pool->mutex));
+	  i = pool->next_job;
+	  pool->next_job += 1;
+	  splite_mutex_unlock (&(pool->mutex));
+	  if (i >= pool->count)
+	      break;
+	  do_cutter_job (worker->cache, pool->jobs + i);
+      }
+    SPLITE_THREAD_RETURN;
+}
+
+static void
+run_cutter_batch (struct cutter_pool *pool)
+{
+/* processing the pending batch on all worker threads */
+    splite_thread_t threads[CUTTER_MAX_THREADS];
+    struct cutter_worker workers[CUTTER_MAX_THREADS];
+    int num_threads = pool->num_threads;
+    int started = 0;
+    int i;
+
+    if (num_threads > pool->count)
+	num_threads = pool->count;
+    pool->next_job = 0;
+    for (i = 0; i < num_threads; i++)
+      {
+	  workers[i].pool = pool;
+	  workers[i].cache = pool->caches[i];
+      }
+    for (i = 1; i < num_threads; i++)
+      {
+	  if (!splite_thread_start
+	      (threads + started, do_cutter_worker, workers + i))
+	      break;
+	  started++;
+      }
+/* the calling thread always acts as a worker as well */
+    do_cutter_worker (workers);
+    for (i = 0; i < started; i++)
+	splite_thread_join (threads[i]);
+}
+
+static int
+do_queue_tmp_cut (struct cutter_pool *pool, sqlite3 * handle,
+		  const void *cache, sqlite3_stmt * stmt_in,
+		  gaiaGeomCollPtr blade_g, char **message)
+{
+/* queuing all Input geoms intersecting the renoded Blade */
+    int ret;
+    int owns_blade = 1;
+    int gpkg_amphibious = 0;
+    int gpkg_mode = 0;
+
+    if (cache != NULL)
+      {
+	  struct splite_internal_cache *pcache =
+	      (struct splite_internal_cache *) cache;
+	  gpkg_amphibious = pcache->gpkg_amphibious_mode;
+	  gpkg_mode = pcache->gpkg_mode;
+      }
+
+    while (1)
+      {
+	  /* scrolling the result set rows - Input geoms to be cut */
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;            /* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		/* fetched one row from the resultset */
+		if (sqlite3_column_type (stmt_in, 0) == SQLITE_INTEGER
+		    && sqlite3_column_type (stmt_in, 1) == SQLITE_BLOB)
+		  {
+		      sqlite3_int64 pk = sqlite3_column_int64 (stmt_in, 0);
+		      const unsigned char *blob =
+			  sqlite3_column_blob (stmt_in, 1);
+		      int blob_sz = sqlite3_column_bytes (stmt_in, 1);
+		      gaiaGeomCollPtr input_g =
+			  gaiaFromSpatiaLiteBlobWkbEx (blob, blob_sz,
+						       gpkg_mode,
+						       gpkg_amphibious);
+		      if (input_g == NULL)
+			  continue;
+		      /* the first Job becomes the owner of the Blade */
+		      if (add_cutter_job
+			  (pool, CUTTER_JOB_INTERSECTION, pk, NULL, input_g,
+			   blade_g, owns_blade) == NULL)
+			{
+			    gaiaFreeGeomColl (input_g);
+			    do_update_message (message,
+					       "ERROR: insufficient memory (Cutter Job)");
+			    goto error;
+			}
+		      owns_blade = 0;
+		  }
+	    }
+	  else
+	    {
+		do_update_sql_error (message,
+				     "step: cut Input geoms",
+				     sqlite3_errmsg (handle));
+		goto error;
+	    }
+      }
+    if (owns_blade)
+	gaiaFreeGeomColl (blade_g);
+    return 1;
+
+  error:
+    if (owns_blade)
+	gaiaFreeGeomColl (blade_g);
+    return 0;
+}
+
+static int
+do_flush_tmp_cut (struct cutter_pool *pool, sqlite3 * handle,
+		  const void *cache, sqlite3_stmt * stmt_upd, char **message)
+{
+/* computing all pending Intersections and saving the cut geoms */
+    int i;
+    int ret;
+    int gpkg_mode = 0;
+
+    if (cache != NULL)
+      {
+	  struct splite_internal_cache *pcache =
+	      (struct splite_internal_cache *) cache;
+	  gpkg_mode = pcache->gpkg_mode;
+      }
+
+    run_cutter_batch (pool);
+    for (i = 0; i < pool->count; i++)
+      {
+	  struct cutter_job *job = pool->jobs + i;
+	  unsigned char *blob = NULL;
+	  int blob_sz = 0;
+	  if (job->n_results < 1 || job->results[0] == NULL)
+	      continue;
+	  gaiaToSpatiaLiteBlobWkbEx (job->results[0], &blob, &blob_sz,
+				     gpkg_mode);
+	  if (blob == NULL)
+	      continue;
+	  sqlite3_reset (stmt_upd);
+	  sqlite3_clear_bindings (stmt_upd);
+	  sqlite3_bind_blob (stmt_upd, 1, blob, blob_sz, free);
+	  sqlite3_bind_int64 (stmt_upd, 2, job->pk);
+	  ret = sqlite3_step (stmt_upd);
+	  if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	      continue;
+	  do_update_sql_error (message,
+			       "step: UPDATE TMP SET cut-Geometry",
+			       sqlite3_errmsg (handle));
+	  reset_cutter_batch (pool);
+	  return 0;
+      }
+    reset_cutter_batch (pool);
+    return 1;
+}
+
+static int
+do_queue_uncovered (struct cutter_pool *pool, int mode,
+		    struct temporary_row *row, gaiaGeomCollPtr input_g,
+		    gaiaGeomCollPtr union_g, char **message)
+{
+/* queuing an Input geom to be differenced against the Blades union */
+    if (add_cutter_job (pool, mode, 0, row, input_g, union_g, 1) == NULL)
+      {
+	  reset_temporary_row (row);
+	  gaiaFreeGeomColl (input_g);
+	  gaiaFreeGeomColl (union_g);
+	  do_update_message (message,
+			     "ERROR: insufficient memory (Cutter Job)");
+	  return 0;
+      }
+    return 1;
+}
+
 static int
 do_update_tmp_cut_linestring (sqlite3 * handle, sqlite3_stmt * stmt_upd,
 			      sqlite3_int64 pk, const unsigned char *blob,
@@ -3655,10 +4087,11 @@ do_update_tmp_cut_linestring (sqlite3 * handle, sqlite3_stmt * stmt_upd,
 }
 
 static int
-do_cut_tmp_linestrings (sqlite3 * handle, const void *cache,
-			sqlite3_stmt * stmt_in, sqlite3_stmt * stmt_upd,
-			struct temporary_row *row, char **message,
-			const unsigned char *blade_blob, int blade_blob_sz)
+do_cut_tmp_linestrings (struct cutter_pool *pool, sqlite3 * handle,
+			const void *cache, sqlite3_stmt * stmt_in,
+			sqlite3_stmt * stmt_upd, struct temporary_row *row,
+			char **message, const unsigned char *blade_blob,
+			int blade_blob_sz)
 {
 /* cutting all Input Linestrings intersecting the renoded Blade */
     int ret;
@@ -3707,6 +4140,13 @@ do_cut_tmp_linestrings (sqlite3 * handle, const void *cache,
 	  var = var->next;
       }
 
+    if (pool != NULL)
+      {
+	  /* multi-threaded mode: Intersections will be computed later */
+	  return do_queue_tmp_cut (pool, handle, cache, stmt_in, blade_g,
+				   message);
+      }
+
     while (1)
       {
 	  /* scrolling the result set rows - cut Linestrings */
@@ -3764,12 +4204,12 @@ do_cut_tmp_linestrings (sqlite3 * handle, const void *cache,
 }
 
 static int
-do_split_linestrings (struct output_table *tbl, sqlite3 * handle,
-		      const void *cache, const char *input_db_prefix,
-		      const char *input_table, const char *input_geom,
-		      const char *blade_db_prefix, const char *blade_table,
-		      const char *blade_geom, const char *tmp_table,
-		      char **message)
+do_split_linestrings (struct output_table *tbl, struct cutter_pool *pool,
+		      sqlite3 * handle, const void *cache,
+		      const char *input_db_prefix, const char *input_table,
+		      const char *input_geom, const char *blade_db_prefix,
+		      const char *blade_table, const char *blade_geom,
+		      const char *tmp_table, char **message)
 {
 /* cutting all Input Linestrings intersecting some Blade */
     int ret;
@@ -4053,8 +4493,8 @@ do_split_linestrings (struct output_table *tbl, sqlite3 * handle,
 		      int blob_sz = sqlite3_column_bytes (stmt_blades, icol);
 		      /* cutting all Input geoms intersecting the Blade */
 		      if (!do_cut_tmp_linestrings
-			  (handle, cache, stmt_in, stmt_upd, &row, message,
-			   blob, blob_sz))
+			  (pool, handle, cache, stmt_in, stmt_upd, &row,
+			   message, blob, blob_sz))
 			{
 			    reset_temporary_row (&row);
 			    goto error;
@@ -4068,6 +4508,13 @@ do_split_linestrings (struct output_table *tbl, sqlite3 * handle,
 		  }
 
 		reset_temporary_row (&row);
+		if (pool != NULL && pool->count >= CUTTER_BATCH_SIZE)
+		  {
+		      /* processing the pending batch */
+		      if (!do_flush_tmp_cut
+			  (pool, handle, cache, stmt_upd, message))
+			  goto error;
+		  }
 	    }
 	  else
 	    {
@@ -4076,6 +4523,12 @@ do_split_linestrings (struct output_table *tbl, sqlite3 * handle,
 		goto error;
 	    }
       }
+    if (pool != NULL && pool->count > 0)
+      {
+	  /* processing the last pending batch */
+	  if (!do_flush_tmp_cut (pool, handle, cache, stmt_upd, message))
+	      goto error;
+      }
 
     sqlite3_finalize (stmt_blades);
     sqlite3_finalize (stmt_in);
@@ -4851,10 +5304,11 @@ do_update_tmp_cut_polygon (sqlite3 * handle, sqlite3_stmt * stmt_upd,
 }
 
 static int
-do_cut_tmp_polygons (sqlite3 * handle, const void *cache,
-		     sqlite3_stmt * stmt_in, sqlite3_stmt * stmt_upd,
-		     struct temporary_row *row, char **message,
-		     const unsigned char *blade_blob, int blade_blob_sz)
+do_cut_tmp_polygons (struct cutter_pool *pool, sqlite3 * handle,
+		     const void *cache, sqlite3_stmt * stmt_in,
+		     sqlite3_stmt * stmt_upd, struct temporary_row *row,
+		     char **message, const unsigned char *blade_blob,
+		     int blade_blob_sz)
 {
 /* cutting all Input Polygons intersecting the renoded Blade */
     int ret;
@@ -4903,6 +5357,13 @@ do_cut_tmp_polygons (sqlite3 * handle, const void *cache,
 	  var = var->next;
       }
 
+    if (pool != NULL)
+      {
+	  /* multi-threaded mode: Intersections will be computed later */
+	  return do_queue_tmp_cut (pool, handle, cache, stmt_in, blade_g,
+				   message);
+      }
+
     while (1)
       {
 	  /* scrolling the result set rows - cut Polygons */
@@ -4960,12 +5421,12 @@ do_cut_tmp_polygons (sqlite3 * handle, const void *cache,
 }
 
 static int
-do_split_polygons (struct output_table *tbl, sqlite3 * handle,
-		   const void *cache, const char *input_db_prefix,
-		   const char *input_table, const char *input_geom,
-		   const char *blade_db_prefix, const char *blade_table,
-		   const char *blade_geom, const char *tmp_table,
-		   char **message)
+do_split_polygons (struct output_table *tbl, struct cutter_pool *pool,
+		   sqlite3 * handle, const void *cache,
+		   const char *input_db_prefix, const char *input_table,
+		   const char *input_geom, const char *blade_db_prefix,
+		   const char *blade_table, const char *blade_geom,
+		   const char *tmp_table, char **message)
 {
 /* cutting all Input Polygons intersecting some Blade */
     int ret;
@@ -5241,8 +5702,8 @@ do_split_polygons (struct output_table *tbl, sqlite3 * handle,
 		      int blob_sz = sqlite3_column_bytes (stmt_blades, icol);
 		      /* cutting all Input geoms intersecting the Blade */
 		      if (!do_cut_tmp_polygons
-			  (handle, cache, stmt_in, stmt_upd, &row, message,
-			   blob, blob_sz))
+			  (pool, handle, cache, stmt_in, stmt_upd, &row,
+			   message, blob, blob_sz))
 			{
 			    reset_temporary_row (&row);
 			    goto error;
@@ -5256,6 +5717,13 @@ do_split_polygons (struct output_table *tbl, sqlite3 * handle,
 		  }
 
 		reset_temporary_row (&row);
+		if (pool != NULL && pool->count >= CUTTER_BATCH_SIZE)
+		  {
+		      /* processing the pending batch */
+		      if (!do_flush_tmp_cut
+			  (pool, handle, cache, stmt_upd, message))
+			  goto error;
+		  }
 	    }
 	  else
 	    {
@@ -5264,6 +5732,12 @@ do_split_polygons (struct output_table *tbl, sqlite3 * handle,
 		goto error;
 	    }
       }
+    if (pool != NULL && pool->count > 0)
+      {
+	  /* processing the last pending batch */
+	  if (!do_flush_tmp_cut (pool, handle, cache, stmt_upd, message))
+	      goto error;
+      }
 
     sqlite3_finalize (stmt_blades);
     sqlite3_finalize (stmt_in);
@@ -5280,6 +5754,68 @@ do_split_polygons (struct output_table *tbl, sqlite3 * handle,
     return 0;
 }
 
+static int
+do_flush_uncovered (struct output_table *tbl, struct cutter_pool *pool,
+		    sqlite3 * handle, const void *cache,
+		    sqlite3_stmt * stmt_out, char **message)
+{
+/* computing all pending Differences and saving the uncovered portions */
+    int i;
+    int j;
+    int ret;
+
+    run_cutter_batch (pool);
+    for (i = 0; i < pool->count; i++)
+      {
+	  struct cutter_job *job = pool->jobs + i;
+	  if (job->blade == NULL)
+	    {
+		/* fully uncovered Input Geometry */
+		if (job->mode == CUTTER_JOB_DIFF_LINES)
+		    ret =
+			do_insert_temporary_linestrings (tbl, handle, cache,
+							 stmt_out, &(job->row),
+							 job->input, message,
+							 -1);
+		else
+		    ret =
+			do_insert_temporary_polygons (tbl, handle, cache,
+						      stmt_out, &(job->row),
+						      job->input, message,
+						      -1);
+		if (!ret)
+		    goto error;
+		continue;
+	    }
+	  for (j = 0; j < job->n_results; j++)
+	    {
+		/* partialy uncovered Input Geometry */
+		if (job->results[j] == NULL)
+		    continue;
+		if (job->mode == CUTTER_JOB_DIFF_LINES)
+		    ret =
+			do_insert_temporary_linestrings (tbl, handle, cache,
+							 stmt_out, &(job->row),
+							 job->results[j],
+							 message, j + 1);
+		else
+		    ret =
+			do_insert_temporary_polygons (tbl, handle, cache,
+						      stmt_out, &(job->row),
+						      job->results[j],
+						      message, j + 1);
+		if (!ret)
+		    goto error;
+	    }
+      }
+    reset_cutter_batch (pool);
+    return 1;
+
+  error:
+    reset_cutter_batch (pool);
+    return 0;
+}
+
 static gaiaGeomCollPtr
 do_compute_diff_polygs (const void *cache, sqlite3_stmt * stmt_diff,
 			gaiaPolygonPtr input_pg, int srid,
@@ -5342,7 +5878,8 @@ do_compute_diff_polygs (const void *cache, sqlite3_stmt * stmt_diff,
 }
 
 static int
-do_get_uncovered_polygons (struct output_table *tbl, sqlite3 * handle,
+do_get_uncovered_polygons (struct output_table *tbl,
+			   struct cutter_pool *pool, sqlite3 * handle,
 			   const void *cache, const char *input_db_prefix,
 			   const char *input_table, const char *input_geom,
 			   const char *tmp_table, int type, char **message)
@@ -5644,6 +6181,22 @@ do_get_uncovered_polygons (struct output_table *tbl, sqlite3 * handle,
 						       gpkg_mode,
 						       gpkg_amphibious);
 		  }
+		if (pool != NULL)
+		  {
+		      /* multi-threaded mode: postponing the Differences */
+		      if (!do_queue_uncovered
+			  (pool, CUTTER_JOB_DIFF_POLYGS, &row, input_g, union_g,
+			   message))
+			  goto error;
+		      if (pool->count >= CUTTER_BATCH_SIZE)
+			{
+			    /* processing the pending batch */
+			    if (!do_flush_uncovered
+				(tbl, pool, handle, cache, stmt_out, message))
+				goto error;
+			}
+		      continue;
+		  }
 		if (union_g == NULL)
 		  {
 		      /* fully uncovered Input Geometry */
@@ -5698,6 +6251,13 @@ do_get_uncovered_polygons (struct output_table *tbl, sqlite3 * handle,
 		goto error;
 	    }
       }
+    if (pool != NULL && pool->count > 0)
+      {
+	  /* processing the last pending batch */
+	  if (!do_flush_uncovered
+	      (tbl, pool, handle, cache, stmt_out, message))
+	      goto error;
+      }
 
     sqlite3_finalize (stmt_in);
     sqlite3_finalize (stmt_out);
@@ -6091,7 +6651,8 @@ do_compute_diff_lines (const void *cache, sqlite3_stmt * stmt_diff,
 }
 
 static int
-do_get_uncovered_linestrings (struct output_table *tbl, sqlite3 * handle,
+do_get_uncovered_linestrings (struct output_table *tbl,
+			      struct cutter_pool *pool, sqlite3 * handle,
 			      const void *cache, const char *input_db_prefix,
 			      const char *input_table, const char *input_geom,
 			      const char *tmp_table, int type, char **message)
@@ -6393,6 +6954,22 @@ do_get_uncovered_linestrings (struct output_table *tbl, sqlite3 * handle,
 						       gpkg_mode,
 						       gpkg_amphibious);
 		  }
+		if (pool != NULL)
+		  {
+		      /* multi-threaded mode: postponing the Differences */
+		      if (!do_queue_uncovered
+			  (pool, CUTTER_JOB_DIFF_LINES, &row, input_g, union_g,
+			   message))
+			  goto error;
+		      if (pool->count >= CUTTER_BATCH_SIZE)
+			{
+			    /* processing the pending batch */
+			    if (!do_flush_uncovered
+				(tbl, pool, handle, cache, stmt_out, message))
+				goto error;
+			}
+		      continue;
+		  }
 		if (union_g == NULL)
 		  {
 		      /* fully uncovered Input Geometry */
@@ -6447,6 +7024,13 @@ do_get_uncovered_linestrings (struct output_table *tbl, sqlite3 * handle,
 		goto error;
 	    }
       }
+    if (pool != NULL && pool->count > 0)
+      {
+	  /* processing the last pending batch */
+	  if (!do_flush_uncovered
+	      (tbl, pool, handle, cache, stmt_out, message))
+	      goto error;
+      }
 
     sqlite3_finalize (stmt_in);
     sqlite3_finalize (stmt_out);
@@ -7410,7 +7994,7 @@ do_cut_linestrings (struct output_table *tbl, sqlite3 * handle,
 		    const char *blade_geom, const char *spatial_index_prefix,
 		    const char *spatial_index, const char *out_table,
 		    char **tmp_table, int *drop_tmp_table, int type,
-		    char **message)
+		    struct cutter_pool *pool, char **message)
 {
 /* cutting Input LINESTRINGs */
     if (!do_create_temp_linestrings (tbl, handle, tmp_table, message))
@@ -7421,11 +8005,11 @@ do_cut_linestrings (struct output_table *tbl, sqlite3 * handle,
 	 spatial_index, *tmp_table, type, message))
 	return 0;
     if (!do_split_linestrings
-	(tbl, handle, cache, input_db_prefix, input_table, input_geom,
+	(tbl, pool, handle, cache, input_db_prefix, input_table, input_geom,
 	 blade_db_prefix, blade_table, blade_geom, *tmp_table, message))
 	return 0;
     if (!do_get_uncovered_linestrings
-	(tbl, handle, cache, input_db_prefix, input_table, input_geom,
+	(tbl, pool, handle, cache, input_db_prefix, input_table, input_geom,
 	 *tmp_table, type, message))
 	return 0;
     if (!do_insert_output_linestrings
@@ -7447,7 +8031,7 @@ do_cut_polygons (struct output_table *tbl, sqlite3 * handle, const void *cache,
 		 const char *blade_table, const char *blade_geom,
 		 const char *spatial_index_prefix, const char *spatial_index,
 		 const char *out_table, char **tmp_table, int *drop_tmp_table,
-		 int type, char **message)
+		 int type, struct cutter_pool *pool, char **message)
 {
 /* cutting Input POLYGONs */
     if (!do_create_temp_polygons (tbl, handle, tmp_table, message))
@@ -7458,11 +8042,11 @@ do_cut_polygons (struct output_table *tbl, sqlite3 * handle, const void *cache,
 	 spatial_index, *tmp_table, type, message))
 	return 0;
     if (!do_split_polygons
-	(tbl, handle, cache, input_db_prefix, input_table, input_geom,
+	(tbl, pool, handle, cache, input_db_prefix, input_table, input_geom,
 	 blade_db_prefix, blade_table, blade_geom, *tmp_table, message))
 	return 0;
     if (!do_get_uncovered_polygons
-	(tbl, handle, cache, input_db_prefix, input_table, input_geom,
+	(tbl, pool, handle, cache, input_db_prefix, input_table, input_geom,
 	 *tmp_table, type, message))
 	return 0;
     if (!do_insert_output_polygons
@@ -7483,6 +8067,20 @@ gaiaCutter (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
 	    const char *xblade_geom, const char *out_table, int transaction,
 	    int ram_tmp_store, char **message)
 {
+/* main Cutter tool implementation - always single-threaded */
+    return gaiaCutterEx (handle, cache, xin_db_prefix, input_table,
+			 xinput_geom, xblade_db_prefix, blade_table,
+			 xblade_geom, out_table, transaction, ram_tmp_store, 1,
+			 message);
+}
+
+SPATIALITE_DECLARE int
+gaiaCutterEx (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
+	      const char *input_table, const char *xinput_geom,
+	      const char *xblade_db_prefix, const char *blade_table,
+	      const char *xblade_geom, const char *out_table, int transaction,
+	      int ram_tmp_store, int num_threads, char **message)
+{
 /* main Cutter tool implementation */
     const char *in_db_prefix = "MAIN";
     const char *blade_db_prefix = "MAIN";
@@ -7501,6 +8099,7 @@ gaiaCutter (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
     int drop_spatial_index = 0;
     int drop_tmp_table = 0;
     struct output_table *tbl = NULL;
+    struct cutter_pool *pool = NULL;
     const char *sql;
     int pt_type = 0;
     int ln_type = 0;
@@ -7658,6 +8257,12 @@ gaiaCutter (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
 	  break;
       };
 
+    if (ln_type || pg_type)
+      {
+	  /* preparing the worker threads (if required) */
+	  pool = create_cutter_pool (cache, num_threads);
+      }
+
     if (pt_type)
       {
 	  /* processing Input of (multi)POINT type */
@@ -7674,7 +8279,7 @@ gaiaCutter (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
 	      (tbl, handle, cache, in_db_prefix, input_table, input_geom,
 	       blade_db_prefix, blade_table, blade_geom, spatial_index_prefix,
 	       spatial_index, out_table, &tmp_table, &drop_tmp_table,
-	       input_type, message))
+	       input_type, pool, message))
 	      goto end;
       }
     if (pg_type)
@@ -7684,7 +8289,7 @@ gaiaCutter (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
 	      (tbl, handle, cache, in_db_prefix, input_table, input_geom,
 	       blade_db_prefix, blade_table, blade_geom, spatial_index_prefix,
 	       spatial_index, out_table, &tmp_table, &drop_tmp_table,
-	       input_type, message))
+	       input_type, pool, message))
 	      goto end;
       }
 
@@ -7747,6 +8352,8 @@ gaiaCutter (sqlite3 * handle, const void *cache, const char *xin_db_prefix,
 	sqlite3_free (tmp_table);
     if (tbl != NULL)
 	destroy_output_table (tbl);
+    if (pool != NULL)
+	destroy_cutter_pool (pool);
     if (transaction && pending)
       {
 	  /* rolling back the Transaction */
@@ -732,7 +732,8 @@ create_layer_polyg_extra_attr_table (sqlite3 * handle, const char *name,
 }
 
 DXF_PRIVATE int
-import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
+import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append,
+		 int num_threads)
 {
 /* populating the target DB - by distinct layers */
     int ret;
@@ -742,10 +743,6 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
     unsigned char *blob;
     int blob_size;
     gaiaGeomCollPtr geom;
-    gaiaLinestringPtr p_ln;
-    gaiaPolygonPtr p_pg;
-    gaiaRingPtr p_rng;
-    int iv;
     char *name;
     char *attr_name = "";
     char *block;
@@ -755,6 +752,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
     gaiaDxfPolylinePtr pg;
     gaiaDxfHatchPtr p_hatch;
     gaiaDxfInsertPtr ins;
+    struct dxf_encoder *enc;
 
     gaiaDxfLayerPtr lyr = dxf->first_layer;
     while (lyr != NULL)
@@ -856,6 +854,22 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			  sqlite3_free (attr_name);
 		      return 0;
 		  }
+		enc =
+		    dxf_encoder_create (dxf, lyr, DXF_ENCODE_TEXT,
+					lyr->is3Dtext, num_threads);
+		if (enc == NULL)
+		  {
+		      spatialite_e ("ENCODER %s error: insufficient memory\n",
+				    name);
+		      sqlite3_finalize (stmt);
+		      if (stmt_ext != NULL)
+			  sqlite3_finalize (stmt_ext);
+		      ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		      sqlite3_free (name);
+		      if (attr_name)
+			  sqlite3_free (attr_name);
+		      return 0;
+		  }
 		txt = lyr->first_text;
 		while (txt != NULL)
 		  {
@@ -869,18 +883,8 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 3, txt->label,
 					 strlen (txt->label), SQLITE_STATIC);
 		      sqlite3_bind_double (stmt, 4, txt->angle);
-		      if (lyr->is3Dtext)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      if (lyr->is3Dtext)
-			  gaiaAddPointToGeomCollXYZ (geom, txt->x, txt->y,
-						     txt->z);
-		      else
-			  gaiaAddPointToGeomColl (geom, txt->x, txt->y);
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, txt, lyr->is3Dtext, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 5, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -889,6 +893,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -925,6 +930,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      attr_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					sqlite3_free (name);
@@ -940,6 +946,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			}
 		      txt = txt->next;
 		  }
+		dxf_encoder_destroy (enc);
 		sqlite3_finalize (stmt);
 		if (stmt_ext != NULL)
 		    sqlite3_finalize (stmt_ext);
@@ -1025,6 +1032,22 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			  sqlite3_free (attr_name);
 		      return 0;
 		  }
+		enc =
+		    dxf_encoder_create (dxf, lyr, DXF_ENCODE_POINT,
+					lyr->is3Dpoint, num_threads);
+		if (enc == NULL)
+		  {
+		      spatialite_e ("ENCODER %s error: insufficient memory\n",
+				    name);
+		      sqlite3_finalize (stmt);
+		      if (stmt_ext != NULL)
+			  sqlite3_finalize (stmt_ext);
+		      ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		      sqlite3_free (name);
+		      if (attr_name)
+			  sqlite3_free (attr_name);
+		      return 0;
+		  }
 		pt = lyr->first_point;
 		while (pt != NULL)
 		  {
@@ -1035,17 +1058,8 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 2, lyr->layer_name,
 					 strlen (lyr->layer_name),
 					 SQLITE_STATIC);
-		      if (lyr->is3Dpoint)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      if (lyr->is3Dpoint)
-			  gaiaAddPointToGeomCollXYZ (geom, pt->x, pt->y, pt->z);
-		      else
-			  gaiaAddPointToGeomColl (geom, pt->x, pt->y);
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, pt, lyr->is3Dpoint, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 3, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -1054,6 +1068,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -1090,6 +1105,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      attr_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					sqlite3_free (name);
@@ -1105,6 +1121,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			}
 		      pt = pt->next;
 		  }
+		dxf_encoder_destroy (enc);
 		sqlite3_finalize (stmt);
 		if (stmt_ext != NULL)
 		    sqlite3_finalize (stmt_ext);
@@ -1190,6 +1207,22 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			  sqlite3_free (attr_name);
 		      return 0;
 		  }
+		enc =
+		    dxf_encoder_create (dxf, lyr, DXF_ENCODE_LINE,
+					lyr->is3Dline, num_threads);
+		if (enc == NULL)
+		  {
+		      spatialite_e ("ENCODER %s error: insufficient memory\n",
+				    name);
+		      sqlite3_finalize (stmt);
+		      if (stmt_ext != NULL)
+			  sqlite3_finalize (stmt_ext);
+		      ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		      sqlite3_free (name);
+		      if (attr_name)
+			  sqlite3_free (attr_name);
+		      return 0;
+		  }
 		ln = lyr->first_line;
 		while (ln != NULL)
 		  {
@@ -1200,29 +1233,8 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 2, lyr->layer_name,
 					 strlen (lyr->layer_name),
 					 SQLITE_STATIC);
-		      if (lyr->is3Dline)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      gaiaAddLinestringToGeomColl (geom, ln->points);
-		      p_ln = geom->FirstLinestring;
-		      for (iv = 0; iv < ln->points; iv++)
-			{
-			    if (lyr->is3Dline)
-			      {
-				  gaiaSetPointXYZ (p_ln->Coords, iv,
-						   *(ln->x + iv), *(ln->y + iv),
-						   *(ln->z + iv));
-			      }
-			    else
-			      {
-				  gaiaSetPoint (p_ln->Coords, iv, *(ln->x + iv),
-						*(ln->y + iv));
-			      }
-			}
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, ln, lyr->is3Dline, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 3, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -1231,6 +1243,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -1267,6 +1280,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      attr_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					sqlite3_free (name);
@@ -1282,6 +1296,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			}
 		      ln = ln->next;
 		  }
+		dxf_encoder_destroy (enc);
 		sqlite3_finalize (stmt);
 		if (stmt_ext != NULL)
 		    sqlite3_finalize (stmt_ext);
@@ -1367,12 +1382,25 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			  sqlite3_free (attr_name);
 		      return 0;
 		  }
+		enc =
+		    dxf_encoder_create (dxf, lyr, DXF_ENCODE_POLYG,
+					lyr->is3Dpolyg, num_threads);
+		if (enc == NULL)
+		  {
+		      spatialite_e ("ENCODER %s error: insufficient memory\n",
+				    name);
+		      sqlite3_finalize (stmt);
+		      if (stmt_ext != NULL)
+			  sqlite3_finalize (stmt_ext);
+		      ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		      sqlite3_free (name);
+		      if (attr_name)
+			  sqlite3_free (attr_name);
+		      return 0;
+		  }
 		pg = lyr->first_polyg;
 		while (pg != NULL)
 		  {
-		      int unclosed = check_unclosed_polyg (pg, lyr->is3Dpolyg);
-		      int num_holes;
-		      gaiaDxfHolePtr hole;
 		      sqlite3_reset (stmt);
 		      sqlite3_clear_bindings (stmt);
 		      sqlite3_bind_text (stmt, 1, dxf->filename,
@@ -1380,100 +1408,8 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 2, lyr->layer_name,
 					 strlen (lyr->layer_name),
 					 SQLITE_STATIC);
-		      if (lyr->is3Dpolyg)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      num_holes = 0;
-		      hole = pg->first_hole;
-		      while (hole != NULL)
-			{
-			    num_holes++;
-			    hole = hole->next;
-			}
-		      gaiaAddPolygonToGeomColl (geom, pg->points + unclosed,
-						num_holes);
-		      p_pg = geom->FirstPolygon;
-		      p_rng = p_pg->Exterior;
-		      for (iv = 0; iv < pg->points; iv++)
-			{
-			    if (lyr->is3Dpolyg)
-			      {
-				  gaiaSetPointXYZ (p_rng->Coords, iv,
-						   *(pg->x + iv), *(pg->y + iv),
-						   *(pg->z + iv));
-			      }
-			    else
-			      {
-				  gaiaSetPoint (p_rng->Coords, iv,
-						*(pg->x + iv), *(pg->y + iv));
-			      }
-			}
-		      if (unclosed)
-			{
-			    /* forcing the Ring to be closed */
-			    if (lyr->is3Dpolyg)
-			      {
-				  gaiaSetPointXYZ (p_rng->Coords, pg->points,
-						   *(pg->x + 0), *(pg->y + 0),
-						   *(pg->z + 0));
-			      }
-			    else
-			      {
-				  gaiaSetPoint (p_rng->Coords, pg->points,
-						*(pg->x + 0), *(pg->y + 0));
-			      }
-			}
-		      num_holes = 0;
-		      hole = pg->first_hole;
-		      while (hole != NULL)
-			{
-			    int unclosed =
-				check_unclosed_hole (hole, lyr->is3Dpolyg);
-			    p_rng =
-				gaiaAddInteriorRing (p_pg, num_holes,
-						     hole->points + unclosed);
-			    for (iv = 0; iv < hole->points; iv++)
-			      {
-				  if (lyr->is3Dpolyg)
-				    {
-					gaiaSetPointXYZ (p_rng->Coords, iv,
-							 *(hole->x + iv),
-							 *(hole->y + iv),
-							 *(hole->z + iv));
-				    }
-				  else
-				    {
-					gaiaSetPoint (p_rng->Coords, iv,
-						      *(hole->x + iv),
-						      *(hole->y + iv));
-				    }
-			      }
-			    if (unclosed)
-			      {
-				  /* forcing the Ring to be closed */
-				  if (lyr->is3Dpolyg)
-				    {
-					gaiaSetPointXYZ (p_rng->Coords,
-							 hole->points,
-							 *(hole->x + 0),
-							 *(hole->y + 0),
-							 *(hole->z + 0));
-				    }
-				  else
-				    {
-					gaiaSetPoint (p_rng->Coords,
-						      hole->points,
-						      *(hole->x + 0),
-						      *(hole->y + 0));
-				    }
-			      }
-			    num_holes++;
-			    hole = hole->next;
-			}
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, pg, lyr->is3Dpolyg, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 3, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -1482,6 +1418,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -1518,6 +1455,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      attr_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					sqlite3_free (name);
@@ -1533,6 +1471,7 @@ import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			}
 		      pg = pg->next;
 		  }
+		dxf_encoder_destroy (enc);
 		sqlite3_finalize (stmt);
 		if (stmt_ext != NULL)
 		    sqlite3_finalize (stmt_ext);
@@ -764,7 +764,8 @@ create_mixed_polyg_extra_attr_table (sqlite3 * handle, const char *name,
 }
 
 DXF_PRIVATE int
-import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
+import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append,
+	      int num_threads)
 {
 /* populating the target DB - all layers mixed altogether */
     int text = 0;
@@ -803,6 +804,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
     char *name;
     char *extra_name;
     char *block;
+    struct dxf_encoder *enc;
 
     gaiaDxfLayerPtr lyr = dxf->first_layer;
     while (lyr != NULL)
@@ -917,6 +919,19 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		    sqlite3_finalize (stmt_ext);
 		return 0;
 	    }
+	  enc =
+	      dxf_encoder_create (dxf, NULL, DXF_ENCODE_TEXT, text3D,
+				  num_threads);
+	  if (enc == NULL)
+	    {
+		spatialite_e ("ENCODER %s error: insufficient memory\n",
+			      name);
+		sqlite3_finalize (stmt);
+		if (stmt_ext != NULL)
+		  sqlite3_finalize (stmt_ext);
+		ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		return 0;
+	    }
 	  lyr = dxf->first_layer;
 	  while (lyr != NULL)
 	    {
@@ -933,18 +948,8 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 3, txt->label,
 					 strlen (txt->label), SQLITE_STATIC);
 		      sqlite3_bind_double (stmt, 4, txt->angle);
-		      if (text3D)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      if (text3D)
-			  gaiaAddPointToGeomCollXYZ (geom, txt->x, txt->y,
-						     txt->z);
-		      else
-			  gaiaAddPointToGeomColl (geom, txt->x, txt->y);
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, txt, text3D, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 5, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -953,6 +958,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -986,6 +992,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      extra_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					ret =
@@ -1003,6 +1010,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 	  sqlite3_free (name);
 	  if (extra_name)
 	      sqlite3_free (extra_name);
+	  dxf_encoder_destroy (enc);
 	  sqlite3_finalize (stmt);
 	  if (stmt_ext != NULL)
 	      sqlite3_finalize (stmt_ext);
@@ -1069,6 +1077,19 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		    sqlite3_finalize (stmt_ext);
 		return 0;
 	    }
+	  enc =
+	      dxf_encoder_create (dxf, NULL, DXF_ENCODE_POINT, point3D,
+				  num_threads);
+	  if (enc == NULL)
+	    {
+		spatialite_e ("ENCODER %s error: insufficient memory\n",
+			      name);
+		sqlite3_finalize (stmt);
+		if (stmt_ext != NULL)
+		  sqlite3_finalize (stmt_ext);
+		ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		return 0;
+	    }
 	  lyr = dxf->first_layer;
 	  while (lyr != NULL)
 	    {
@@ -1082,17 +1103,8 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 2, lyr->layer_name,
 					 strlen (lyr->layer_name),
 					 SQLITE_STATIC);
-		      if (point3D)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      if (point3D)
-			  gaiaAddPointToGeomCollXYZ (geom, pt->x, pt->y, pt->z);
-		      else
-			  gaiaAddPointToGeomColl (geom, pt->x, pt->y);
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, pt, point3D, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 3, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -1101,6 +1113,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -1134,6 +1147,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      extra_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					ret =
@@ -1151,6 +1165,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 	  sqlite3_free (name);
 	  if (extra_name)
 	      sqlite3_free (extra_name);
+	  dxf_encoder_destroy (enc);
 	  sqlite3_finalize (stmt);
 	  if (stmt_ext != NULL)
 	      sqlite3_finalize (stmt_ext);
@@ -1217,14 +1232,25 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		    sqlite3_finalize (stmt_ext);
 		return 0;
 	    }
+	  enc =
+	      dxf_encoder_create (dxf, NULL, DXF_ENCODE_LINE, line3D,
+				  num_threads);
+	  if (enc == NULL)
+	    {
+		spatialite_e ("ENCODER %s error: insufficient memory\n",
+			      name);
+		sqlite3_finalize (stmt);
+		if (stmt_ext != NULL)
+		  sqlite3_finalize (stmt_ext);
+		ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		return 0;
+	    }
 	  lyr = dxf->first_layer;
 	  while (lyr != NULL)
 	    {
 		gaiaDxfPolylinePtr ln = lyr->first_line;
 		while (ln != NULL)
 		  {
-		      int iv;
-		      gaiaLinestringPtr p_ln;
 		      sqlite3_reset (stmt);
 		      sqlite3_clear_bindings (stmt);
 		      sqlite3_bind_text (stmt, 1, dxf->filename,
@@ -1232,29 +1258,8 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 2, lyr->layer_name,
 					 strlen (lyr->layer_name),
 					 SQLITE_STATIC);
-		      if (line3D)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      gaiaAddLinestringToGeomColl (geom, ln->points);
-		      p_ln = geom->FirstLinestring;
-		      for (iv = 0; iv < ln->points; iv++)
-			{
-			    if (line3D)
-			      {
-				  gaiaSetPointXYZ (p_ln->Coords, iv,
-						   *(ln->x + iv), *(ln->y + iv),
-						   *(ln->z + iv));
-			      }
-			    else
-			      {
-				  gaiaSetPoint (p_ln->Coords, iv, *(ln->x + iv),
-						*(ln->y + iv));
-			      }
-			}
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, ln, line3D, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 3, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -1263,6 +1268,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -1296,6 +1302,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      extra_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					sqlite3_finalize (stmt_ext);
 					ret =
@@ -1313,6 +1320,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 	  sqlite3_free (name);
 	  if (extra_name)
 	      sqlite3_free (extra_name);
+	  dxf_encoder_destroy (enc);
 	  sqlite3_finalize (stmt);
 	  if (stmt_ext != NULL)
 	      sqlite3_finalize (stmt_ext);
@@ -1379,18 +1387,25 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		    sqlite3_finalize (stmt_ext);
 		return 0;
 	    }
+	  enc =
+	      dxf_encoder_create (dxf, NULL, DXF_ENCODE_POLYG, polyg3D,
+				  num_threads);
+	  if (enc == NULL)
+	    {
+		spatialite_e ("ENCODER %s error: insufficient memory\n",
+			      name);
+		sqlite3_finalize (stmt);
+		if (stmt_ext != NULL)
+		  sqlite3_finalize (stmt_ext);
+		ret = sqlite3_exec (handle, "ROLLBACK", NULL, NULL, NULL);
+		return 0;
+	    }
 	  lyr = dxf->first_layer;
 	  while (lyr != NULL)
 	    {
 		gaiaDxfPolylinePtr pg = lyr->first_polyg;
 		while (pg != NULL)
 		  {
-		      int unclosed = check_unclosed_polyg (pg, lyr->is3Dpolyg);
-		      gaiaDxfHolePtr hole;
-		      int num_holes;
-		      int iv;
-		      gaiaPolygonPtr p_pg;
-		      gaiaRingPtr p_rng;
 		      sqlite3_reset (stmt);
 		      sqlite3_clear_bindings (stmt);
 		      sqlite3_bind_text (stmt, 1, dxf->filename,
@@ -1398,100 +1413,8 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 		      sqlite3_bind_text (stmt, 2, lyr->layer_name,
 					 strlen (lyr->layer_name),
 					 SQLITE_STATIC);
-		      if (polyg3D)
-			  geom = gaiaAllocGeomCollXYZ ();
-		      else
-			  geom = gaiaAllocGeomColl ();
-		      geom->Srid = dxf->srid;
-		      num_holes = 0;
-		      hole = pg->first_hole;
-		      while (hole != NULL)
-			{
-			    num_holes++;
-			    hole = hole->next;
-			}
-		      gaiaAddPolygonToGeomColl (geom, pg->points + unclosed,
-						num_holes);
-		      p_pg = geom->FirstPolygon;
-		      p_rng = p_pg->Exterior;
-		      for (iv = 0; iv < pg->points; iv++)
-			{
-			    if (lyr->is3Dpolyg)
-			      {
-				  gaiaSetPointXYZ (p_rng->Coords, iv,
-						   *(pg->x + iv), *(pg->y + iv),
-						   *(pg->z + iv));
-			      }
-			    else
-			      {
-				  gaiaSetPoint (p_rng->Coords, iv,
-						*(pg->x + iv), *(pg->y + iv));
-			      }
-			}
-		      if (unclosed)
-			{
-			    /* forcing the Ring to be closed */
-			    if (lyr->is3Dpolyg)
-			      {
-				  gaiaSetPointXYZ (p_rng->Coords, pg->points,
-						   *(pg->x + 0), *(pg->y + 0),
-						   *(pg->z + 0));
-			      }
-			    else
-			      {
-				  gaiaSetPoint (p_rng->Coords, pg->points,
-						*(pg->x + 0), *(pg->y + 0));
-			      }
-			}
-		      num_holes = 0;
-		      hole = pg->first_hole;
-		      while (hole != NULL)
-			{
-			    int unclosed =
-				check_unclosed_hole (hole, lyr->is3Dpolyg);
-			    p_rng =
-				gaiaAddInteriorRing (p_pg, num_holes,
-						     hole->points + unclosed);
-			    for (iv = 0; iv < hole->points; iv++)
-			      {
-				  if (lyr->is3Dpolyg)
-				    {
-					gaiaSetPointXYZ (p_rng->Coords, iv,
-							 *(hole->x + iv),
-							 *(hole->y + iv),
-							 *(hole->z + iv));
-				    }
-				  else
-				    {
-					gaiaSetPoint (p_rng->Coords, iv,
-						      *(hole->x + iv),
-						      *(hole->y + iv));
-				    }
-			      }
-			    if (unclosed)
-			      {
-				  /* forcing the Ring to be closed */
-				  if (lyr->is3Dpolyg)
-				    {
-					gaiaSetPointXYZ (p_rng->Coords,
-							 hole->points,
-							 *(hole->x + 0),
-							 *(hole->y + 0),
-							 *(hole->z + 0));
-				    }
-				  else
-				    {
-					gaiaSetPoint (p_rng->Coords,
-						      hole->points,
-						      *(hole->x + 0),
-						      *(hole->y + 0));
-				    }
-			      }
-			    num_holes++;
-			    hole = hole->next;
-			}
-		      gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
-		      gaiaFreeGeomColl (geom);
+		      dxf_encoder_next (enc, pg, lyr->is3Dpolyg, &blob,
+					&blob_size);
 		      sqlite3_bind_blob (stmt, 3, blob, blob_size, free);
 		      ret = sqlite3_step (stmt);
 		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
@@ -1500,6 +1423,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 			{
 			    spatialite_e ("INSERT %s error: %s\n", name,
 					  sqlite3_errmsg (handle));
+			    dxf_encoder_destroy (enc);
 			    sqlite3_finalize (stmt);
 			    if (stmt_ext != NULL)
 				sqlite3_finalize (stmt_ext);
@@ -1533,6 +1457,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 					spatialite_e ("INSERT %s error: %s\n",
 						      extra_name,
 						      sqlite3_errmsg (handle));
+					dxf_encoder_destroy (enc);
 					sqlite3_finalize (stmt);
 					if (stmt_ext != NULL)
 					    sqlite3_finalize (stmt_ext);
@@ -1551,6 +1476,7 @@ import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
 	  sqlite3_free (name);
 	  if (extra_name)
 	      sqlite3_free (extra_name);
+	  dxf_encoder_destroy (enc);
 	  sqlite3_finalize (stmt);
 	  if (stmt_ext != NULL)
 	      sqlite3_finalize (stmt_ext);
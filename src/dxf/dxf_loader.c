@@ -71,6 +71,7 @@ Regione Toscana - Settore Sistema Informativo Territoriale ed Ambientale
 #include <spatialite/gg_dxf.h>
 #include <spatialite.h>
 #include <spatialite_private.h>
+#include <splite_thread.h>
 
 #include "dxf_private.h"
 
@@ -3922,11 +3923,612 @@ import_blocks (sqlite3 * handle, gaiaDxfParserPtr dxf, int append)
     return 1;
 }
 
+/*
+/ multithreaded Geometry encoding
+/
+/ when more than a single thread is requested, all the Text, Point, Line
+/ and Polygon Geometries belonging to the same target table are encoded
+/ into BLOBs by a pool of worker threads, while the calling thread
+/ (the only one ever touching the DB connection) drains the pre-encoded
+/ BLOBs in their original order
+*/
+
+#define DXF_ENCODE_CHUNK	256
+#define DXF_ENCODE_MIN_ITEMS	(2 * DXF_ENCODE_CHUNK)
+#define DXF_MAX_THREADS		GAIA_DXF_MAX_THREADS
+
+static void
+encode_dxf_text (int srid, int geom3d, gaiaDxfTextPtr txt,
+		 unsigned char **blob, int *blob_size)
+{
+/* encoding a Text Geometry */
+    gaiaGeomCollPtr geom;
+    if (geom3d)
+	geom = gaiaAllocGeomCollXYZ ();
+    else
+	geom = gaiaAllocGeomColl ();
+    geom->Srid = srid;
+    if (geom3d)
+	gaiaAddPointToGeomCollXYZ (geom, txt->x, txt->y, txt->z);
+    else
+	gaiaAddPointToGeomColl (geom, txt->x, txt->y);
+    gaiaToSpatiaLiteBlobWkb (geom, blob, blob_size);
+    gaiaFreeGeomColl (geom);
+}
+
+static void
+encode_dxf_point (int srid, int geom3d, gaiaDxfPointPtr pt,
+		  unsigned char **blob, int *blob_size)
+{
+/* encoding a Point Geometry */
+    gaiaGeomCollPtr geom;
+    if (geom3d)
+	geom = gaiaAllocGeomCollXYZ ();
+    else
+	geom = gaiaAllocGeomColl ();
+    geom->Srid = srid;
+    if (geom3d)
+	gaiaAddPointToGeomCollXYZ (geom, pt->x, pt->y, pt->z);
+    else
+	gaiaAddPointToGeomColl (geom, pt->x, pt->y);
+    gaiaToSpatiaLiteBlobWkb (geom, blob, blob_size);
+    gaiaFreeGeomColl (geom);
+}
+
+static void
+encode_dxf_line (int srid, int geom3d, gaiaDxfPolylinePtr ln,
+		 unsigned char **blob, int *blob_size)
+{
+/* encoding a Linestring Geometry */
+    gaiaGeomCollPtr geom;
+    gaiaLinestringPtr p_ln;
+    int iv;
+    if (geom3d)
+	geom = gaiaAllocGeomCollXYZ ();
+    else
+	geom = gaiaAllocGeomColl ();
+    geom->Srid = srid;
+    gaiaAddLinestringToGeomColl (geom, ln->points);
+    p_ln = geom->FirstLinestring;
+    for (iv = 0; iv < ln->points; iv++)
+      {
+	  if (geom3d)
+	    {
+		gaiaSetPointXYZ (p_ln->Coords, iv,
+				 *(ln->x + iv), *(ln->y + iv), *(ln->z + iv));
+	    }
+	  else
+	    {
+		gaiaSetPoint (p_ln->Coords, iv, *(ln->x + iv), *(ln->y + iv));
+	    }
+      }
+    gaiaToSpatiaLiteBlobWkb (geom, blob, blob_size);
+    gaiaFreeGeomColl (geom);
+}
+
+static void
+encode_dxf_polyg (int srid, int geom3d, int coord3d, gaiaDxfPolylinePtr pg,
+		  unsigned char **blob, int *blob_size)
+{
+/* 
+/ encoding a Polygon Geometry 
+/
+/ please note: the dimensions of the Geometry and the ones used
+/ for setting the vertices could differ in MIXED mode
+*/
+    gaiaGeomCollPtr geom;
+    gaiaPolygonPtr p_pg;
+    gaiaRingPtr p_rng;
+    gaiaDxfHolePtr hole;
+    int num_holes;
+    int iv;
+    int unclosed = check_unclosed_polyg (pg, coord3d);
+    if (geom3d)
+	geom = gaiaAllocGeomCollXYZ ();
+    else
+	geom = gaiaAllocGeomColl ();
+    geom->Srid = srid;
+    num_holes = 0;
+    hole = pg->first_hole;
+    while (hole != NULL)
+      {
+	  num_holes++;
+	  hole = hole->next;
+      }
+    gaiaAddPolygonToGeomColl (geom, pg->points + unclosed, num_holes);
+    p_pg = geom->FirstPolygon;
+    p_rng = p_pg->Exterior;
+    for (iv = 0; iv < pg->points; iv++)
+      {
+	  if (coord3d)
+	    {
+		gaiaSetPointXYZ (p_rng->Coords, iv,
+				 *(pg->x + iv), *(pg->y + iv), *(pg->z + iv));
+	    }
+	  else
+	    {
+		gaiaSetPoint (p_rng->Coords, iv, *(pg->x + iv), *(pg->y + iv));
+	    }
+      }
+    if (unclosed)
+      {
+	  /* forcing the Ring to be closed */
+	  if (coord3d)
+	    {
+		gaiaSetPointXYZ (p_rng->Coords, pg->points,
+				 *(pg->x + 0), *(pg->y + 0), *(pg->z + 0));
+	    }
+	  else
+	    {
+		gaiaSetPoint (p_rng->Coords, pg->points,
+			      *(pg->x + 0), *(pg->y + 0));
+	    }
+      }
+    num_holes = 0;
+    hole = pg->first_hole;
+    while (hole != NULL)
+      {
+	  int unclosed = check_unclosed_hole (hole, coord3d);
+	  p_rng = gaiaAddInteriorRing (p_pg, num_holes, hole->points + unclosed);
+	  for (iv = 0; iv < hole->points; iv++)
+	    {
+		if (coord3d)
+		  {
+		      gaiaSetPointXYZ (p_rng->Coords, iv,
+				       *(hole->x + iv), *(hole->y + iv),
+				       *(hole->z + iv));
+		  }
+		else
+		  {
+		      gaiaSetPoint (p_rng->Coords, iv,
+				    *(hole->x + iv), *(hole->y + iv));
+		  }
+	    }
+	  if (unclosed)
+	    {
+		/* forcing the Ring to be closed */
+		if (coord3d)
+		  {
+		      gaiaSetPointXYZ (p_rng->Coords, hole->points,
+				       *(hole->x + 0), *(hole->y + 0),
+				       *(hole->z + 0));
+		  }
+		else
+		  {
+		      gaiaSetPoint (p_rng->Coords, hole->points,
+				    *(hole->x + 0), *(hole->y + 0));
+		  }
+	    }
+	  num_holes++;
+	  hole = hole->next;
+      }
+    gaiaToSpatiaLiteBlobWkb (geom, blob, blob_size);
+    gaiaFreeGeomColl (geom);
+}
+
+static void
+encode_dxf_entity (int kind, int srid, int geom3d, int coord3d, void *entity,
+		   unsigned char **blob, int *blob_size)
+{
+/* encoding the Geometry of any supported DXF entity */
+    *blob = NULL;
+    *blob_size = 0;
+    switch (kind)
+      {
+      case DXF_ENCODE_TEXT:
+	  encode_dxf_text (srid, geom3d, (gaiaDxfTextPtr) entity, blob,
+			   blob_size);
+	  break;
+      case DXF_ENCODE_POINT:
+	  encode_dxf_point (srid, geom3d, (gaiaDxfPointPtr) entity, blob,
+			    blob_size);
+	  break;
+      case DXF_ENCODE_LINE:
+	  encode_dxf_line (srid, geom3d, (gaiaDxfPolylinePtr) entity, blob,
+			   blob_size);
+	  break;
+      case DXF_ENCODE_POLYG:
+	  encode_dxf_polyg (srid, geom3d, coord3d,
+			    (gaiaDxfPolylinePtr) entity, blob, blob_size);
+	  break;
+      };
+}
+
+struct dxf_encode_item
+{
+/* a DXF entity waiting to be encoded */
+    void *entity;
+    int coord3d;
+    unsigned char *blob;
+    int blob_size;
+};
+
+struct dxf_encoder
+{
+/* a pool of threads encoding Geometries on behalf of a single writer */
+    int kind;
+    int srid;
+    int geom3d;
+    int count;
+    struct dxf_encode_item *items;
+    int next_fetch;
+    int num_chunks;
+    int next_chunk;
+    int window;
+    char *ready;
+    int abort;
+    int num_threads;
+    splite_thread_t threads[DXF_MAX_THREADS];
+    splite_mutex_t mutex;
+    splite_cond_t cond;
+};
+
+static void
+add_encode_items (struct dxf_encoder *enc, gaiaDxfLayerPtr lyr)
+{
+/* 
+/ appending all the entities of a Layer into the items array
+/ (simply counting them if the array has not yet been allocated)
+*/
+    void *entity = NULL;
+    int coord3d = enc->geom3d;
+    switch (enc->kind)
+      {
+      case DXF_ENCODE_TEXT:
+	  entity = lyr->first_text;
+	  break;
+      case DXF_ENCODE_POINT:
+	  entity = lyr->first_point;
+	  break;
+      case DXF_ENCODE_LINE:
+	  entity = lyr->first_line;
+	  break;
+      case DXF_ENCODE_POLYG:
+	  entity = lyr->first_polyg;
+	  coord3d = lyr->is3Dpolyg;
+	  break;
+      };
+    while (entity != NULL)
+      {
+	  if (enc->items != NULL)
+	    {
+		struct dxf_encode_item *item = enc->items + enc->count;
+		item->entity = entity;
+		item->coord3d = coord3d;
+		item->blob = NULL;
+		item->blob_size = 0;
+	    }
+	  enc->count += 1;
+	  switch (enc->kind)
+	    {
+	    case DXF_ENCODE_TEXT:
+		entity = ((gaiaDxfTextPtr) entity)->next;
+		break;
+	    case DXF_ENCODE_POINT:
+		entity = ((gaiaDxfPointPtr) entity)->next;
+		break;
+	    default:
+		entity = ((gaiaDxfPolylinePtr) entity)->next;
+		break;
+	    };
+      }
+}
+
+SPLITE_THREAD_PROC (dxf_encoder_worker, arg)
+{
+/* a worker thread encoding chunks of Geometries */
+    struct dxf_encoder *enc = (struct dxf_encoder *) arg;
+    splite_mutex_lock (&(enc->mutex));
+    while (1)
+      {
+	  int chunk;
+	  int first;
+	  int last;
+	  int i;
+	  if (enc->abort || enc->next_chunk >= enc->num_chunks)
+	      break;
+	  if (enc->next_chunk >
+	      (enc->next_fetch / DXF_ENCODE_CHUNK) + enc->window)
+	    {
+		/* too far ahead of the writer: waiting */
+		splite_cond_wait (&(enc->cond), &(enc->mutex));
+		continue;
+	    }
+	  chunk = enc->next_chunk;
+	  enc->next_chunk += 1;
+	  splite_mutex_unlock (&(enc->mutex));
+	  first = chunk * DXF_ENCODE_CHUNK;
+	  last = first + DXF_ENCODE_CHUNK;
+	  if (last > enc->count)
+	      last = enc->count;
+	  for (i = first; i < last; i++)
+	    {
+		struct dxf_encode_item *item = enc->items + i;
+		encode_dxf_entity (enc->kind, enc->srid, enc->geom3d,
+				   item->coord3d, item->entity, &(item->blob),
+				   &(item->blob_size));
+	    }
+	  splite_mutex_lock (&(enc->mutex));
+	  *(enc->ready + chunk) = 1;
+	  splite_cond_broadcast (&(enc->cond));
+      }
+    splite_mutex_unlock (&(enc->mutex));
+    SPLITE_THREAD_RETURN;
+}
+
+DXF_PRIVATE struct dxf_encoder *
+dxf_encoder_create (gaiaDxfParserPtr dxf, gaiaDxfLayerPtr layer, int kind,
+		    int geom3d, int num_threads)
+{
+/* 
+/ creating a Geometry Encoder for a single target table
+/ (a single Layer, or all Layers when layer is NULL)
+*/
+    gaiaDxfLayerPtr lyr;
+    struct dxf_encoder *enc = malloc (sizeof (struct dxf_encoder));
+    if (enc == NULL)
+	return NULL;
+    enc->kind = kind;
+    enc->srid = dxf->srid;
+    enc->geom3d = geom3d;
+    enc->count = 0;
+    enc->items = NULL;
+    enc->next_fetch = 0;
+    enc->num_chunks = 0;
+    enc->next_chunk = 0;
+    enc->window = 0;
+    enc->ready = NULL;
+    enc->abort = 0;
+    enc->num_threads = 0;
+    if (num_threads > DXF_MAX_THREADS)
+	num_threads = DXF_MAX_THREADS;
+    if (num_threads <= 1)
+	return enc;
+
+/* counting the entities */
+    lyr = (layer != NULL) ? layer : dxf->first_layer;
+    while (lyr != NULL)
+      {
+	  add_encode_items (enc, lyr);
+	  if (layer != NULL)
+	      break;
+	  lyr = lyr->next;
+      }
+    if (enc->count < DXF_ENCODE_MIN_ITEMS)
+      {
+	  /* too few entities: encoding them in the writer thread */
+	  enc->count = 0;
+	  return enc;
+      }
+
+/* collecting the entities */
+    enc->items = malloc (sizeof (struct dxf_encode_item) * enc->count);
+    enc->num_chunks = (enc->count + DXF_ENCODE_CHUNK - 1) / DXF_ENCODE_CHUNK;
+    enc->ready = calloc (enc->num_chunks, sizeof (char));
+    if (enc->items == NULL || enc->ready == NULL)
+      {
+	  if (enc->items != NULL)
+	      free (enc->items);
+	  if (enc->ready != NULL)
+	      free (enc->ready);
+	  enc->items = NULL;
+	  enc->ready = NULL;
+	  enc->count = 0;
+	  enc->num_chunks = 0;
+	  return enc;
+      }
+    enc->count = 0;
+    lyr = (layer != NULL) ? layer : dxf->first_layer;
+    while (lyr != NULL)
+      {
+	  add_encode_items (enc, lyr);
+	  if (layer != NULL)
+	      break;
+	  lyr = lyr->next;
+      }
+    enc->window = 4 * num_threads;
+
+/* starting the worker threads */
+    splite_mutex_init (&(enc->mutex));
+    splite_cond_init (&(enc->cond));
+    while (enc->num_threads < num_threads)
+      {
+	  if (!splite_thread_start
+	      (enc->threads + enc->num_threads, dxf_encoder_worker, enc))
+	      break;
+	  enc->num_threads += 1;
+      }
+    if (enc->num_threads == 0)
+      {
+	  /* unable to start any thread: encoding in the writer thread */
+	  splite_mutex_destroy (&(enc->mutex));
+	  splite_cond_destroy (&(enc->cond));
+	  free (enc->items);
+	  free (enc->ready);
+	  enc->items = NULL;
+	  enc->ready = NULL;
+	  enc->count = 0;
+	  enc->num_chunks = 0;
+      }
+    return enc;
+}
+
+DXF_PRIVATE void
+dxf_encoder_next (struct dxf_encoder *enc, void *entity, int coord3d,
+		  unsigned char **blob, int *blob_size)
+{
+/* 
+/ returning the BLOB-Geometry of the next entity
+/ (the caller takes ownership of the BLOB, to be released by free)
+*/
+    if (enc->num_threads > 0 && enc->next_fetch < enc->count)
+      {
+	  struct dxf_encode_item *item = enc->items + enc->next_fetch;
+	  if (item->entity == entity)
+	    {
+		int chunk = enc->next_fetch / DXF_ENCODE_CHUNK;
+		splite_mutex_lock (&(enc->mutex));
+		while (*(enc->ready + chunk) == 0)
+		    splite_cond_wait (&(enc->cond), &(enc->mutex));
+		enc->next_fetch += 1;
+		if (enc->next_fetch % DXF_ENCODE_CHUNK == 0)
+		    splite_cond_broadcast (&(enc->cond));
+		splite_mutex_unlock (&(enc->mutex));
+		*blob = item->blob;
+		*blob_size = item->blob_size;
+		item->blob = NULL;
+		return;
+	    }
+      }
+/* encoding the Geometry in the writer thread */
+    encode_dxf_entity (enc->kind, enc->srid, enc->geom3d, coord3d, entity,
+		       blob, blob_size);
+}
+
+DXF_PRIVATE void
+dxf_encoder_destroy (struct dxf_encoder *enc)
+{
+/* stopping all worker threads and destroying a Geometry Encoder */
+    int i;
+    if (enc == NULL)
+	return;
+    if (enc->num_threads > 0)
+      {
+	  splite_mutex_lock (&(enc->mutex));
+	  enc->abort = 1;
+	  splite_cond_broadcast (&(enc->cond));
+	  splite_mutex_unlock (&(enc->mutex));
+	  for (i = 0; i < enc->num_threads; i++)
+	      splite_thread_join (enc->threads[i]);
+	  splite_mutex_destroy (&(enc->mutex));
+	  splite_cond_destroy (&(enc->cond));
+      }
+    if (enc->items != NULL)
+      {
+	  for (i = 0; i < enc->count; i++)
+	    {
+		struct dxf_encode_item *item = enc->items + i;
+		if (item->blob != NULL)
+		    free (item->blob);
+	    }
+	  free (enc->items);
+      }
+    if (enc->ready != NULL)
+	free (enc->ready);
+    free (enc);
+}
+
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+
+struct dxf_parse_pool
+{
+/* a pool of threads concurrently parsing many DXF files */
+    gaiaDxfParserPtr *parsers;
+    const char **filenames;
+    int *results;
+    int count;
+    int next_file;
+    splite_mutex_t mutex;
+    splite_cond_t cond;
+};
+
+SPLITE_THREAD_PROC (dxf_parse_worker, arg)
+{
+/* a worker thread parsing DXF files */
+    struct dxf_parse_pool *pool = (struct dxf_parse_pool *) arg;
+    void *cache;
+
+/* each thread owns a private connection cache (and GEOS handle) */
+    cache = spatialite_alloc_connection ();
+    if (cache == NULL)
+	SPLITE_THREAD_RETURN;
+    while (1)
+      {
+	  int i;
+	  splite_mutex_lock (&(pool->mutex));
+	  i = pool->next_file;
+	  if (i < pool->count)
+	      pool->next_file += 1;
+	  splite_mutex_unlock (&(pool->mutex));
+	  if (i >= pool->count)
+	      break;
+	  *(pool->results + i) =
+	      gaiaParseDxfFile_r (cache, *(pool->parsers + i),
+				  *(pool->filenames + i));
+      }
+    spatialite_internal_cleanup (cache);
+    SPLITE_THREAD_RETURN;
+}
+
 GAIAGEO_DECLARE int
-gaiaLoadFromDxfParser (sqlite3 * handle,
-		       gaiaDxfParserPtr dxf, int mode, int append)
+gaiaParseDxfFiles_r (const void *p_cache, gaiaDxfParserPtr * parsers,
+		     const char **filenames, int *results, int count,
+		     int num_threads)
 {
-/* populating the target DB */
+/* concurrently parsing many DXF files */
+    struct dxf_parse_pool pool;
+    splite_thread_t threads[DXF_MAX_THREADS];
+    int started = 0;
+    int i;
+    int ok = 0;
+
+    if (parsers == NULL || filenames == NULL || results == NULL)
+	return 0;
+    for (i = 0; i < count; i++)
+	*(results + i) = 0;
+    pool.parsers = parsers;
+    pool.filenames = filenames;
+    pool.results = results;
+    pool.count = count;
+    pool.next_file = 0;
+    if (num_threads > count)
+	num_threads = count;
+    if (num_threads > DXF_MAX_THREADS)
+	num_threads = DXF_MAX_THREADS;
+    if (num_threads > 1)
+      {
+	  splite_mutex_init (&(pool.mutex));
+	  splite_cond_init (&(pool.cond));
+	  while (started < num_threads)
+	    {
+		if (!splite_thread_start
+		    (threads + started, dxf_parse_worker, &pool))
+		    break;
+		started++;
+	    }
+	  for (i = 0; i < started; i++)
+	      splite_thread_join (threads[i]);
+	  splite_mutex_destroy (&(pool.mutex));
+	  splite_cond_destroy (&(pool.cond));
+      }
+
+/* parsing in the calling thread any file left unclaimed */
+    for (i = pool.next_file; i < count; i++)
+      {
+	  if (p_cache != NULL)
+	      *(results + i) =
+		  gaiaParseDxfFile_r (p_cache, *(parsers + i),
+				      *(filenames + i));
+	  else
+	      *(results + i) =
+		  gaiaParseDxfFile (*(parsers + i), *(filenames + i));
+      }
+    for (i = 0; i < count; i++)
+      {
+	  if (*(results + i))
+	      ok++;
+      }
+    return ok;
+}
+
+#endif /* GEOS enabled */
+
+GAIAGEO_DECLARE int
+gaiaLoadFromDxfParserEx (sqlite3 * handle,
+			 gaiaDxfParserPtr dxf, int mode, int append,
+			 int num_threads)
+{
+/* populating the target DB - possibly using many encoding threads */
     int ret;
 
     if (dxf == NULL)
@@ -3941,8 +4543,16 @@ gaiaLoadFromDxfParser (sqlite3 * handle,
       }
 
     if (mode == GAIA_DXF_IMPORT_MIXED)
-	ret = import_mixed (handle, dxf, append);
+	ret = import_mixed (handle, dxf, append, num_threads);
     else
-	ret = import_by_layer (handle, dxf, append);
+	ret = import_by_layer (handle, dxf, append, num_threads);
     return ret;
 }
+
+GAIAGEO_DECLARE int
+gaiaLoadFromDxfParser (sqlite3 * handle,
+		       gaiaDxfParserPtr dxf, int mode, int append)
+{
+/* populating the target DB */
+    return gaiaLoadFromDxfParserEx (handle, dxf, mode, append, 1);
+}
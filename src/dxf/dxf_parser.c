@@ -103,6 +103,90 @@ typedef struct dxf_rings_collection
 } dxfRingsCollection;
 typedef dxfRingsCollection *dxfRingsCollectionPtr;
 
+#define DXF_READ_BLOCK		(1024 * 1024)
+#define DXF_MAX_LINE		4192
+#define DXF_ARENA_POINTS	4096
+
+typedef struct dxf_arena_block
+{
+/* a block of DXF Point objects */
+    gaiaDxfPoint points[DXF_ARENA_POINTS];
+    int used;
+    struct dxf_arena_block *next;
+} dxfArenaBlock;
+typedef dxfArenaBlock *dxfArenaBlockPtr;
+
+typedef struct dxf_arena
+{
+/* a per-parse memory arena for DXF Point objects */
+    dxfArenaBlockPtr first;
+    gaiaDxfPointPtr free_list;
+} dxfArena;
+typedef dxfArena *dxfArenaPtr;
+
+static dxfArenaPtr
+alloc_dxf_arena ()
+{
+/* allocating an empty memory arena */
+    dxfArenaPtr arena = malloc (sizeof (dxfArena));
+    arena->first = NULL;
+    arena->free_list = NULL;
+    return arena;
+}
+
+static void
+destroy_dxf_arena (dxfArenaPtr arena)
+{
+/* memory cleanup - destroying a memory arena and all its Points */
+    dxfArenaBlockPtr blk;
+    dxfArenaBlockPtr n_blk;
+    if (arena == NULL)
+	return;
+    blk = arena->first;
+    while (blk != NULL)
+      {
+	  n_blk = blk->next;
+	  free (blk);
+	  blk = n_blk;
+      }
+    free (arena);
+}
+
+static gaiaDxfPointPtr
+arena_alloc_point (dxfArenaPtr arena)
+{
+/* carving a DXF Point object from the memory arena */
+    gaiaDxfPointPtr pt;
+    if (arena->free_list != NULL)
+      {
+	  /* recycling a released Point */
+	  pt = arena->free_list;
+	  arena->free_list = pt->next;
+	  return pt;
+      }
+    if (arena->first == NULL || arena->first->used == DXF_ARENA_POINTS)
+      {
+	  /* allocating a further block */
+	  dxfArenaBlockPtr blk = malloc (sizeof (dxfArenaBlock));
+	  blk->used = 0;
+	  blk->next = arena->first;
+	  arena->first = blk;
+      }
+    pt = arena->first->points + arena->first->used;
+    arena->first->used += 1;
+    return pt;
+}
+
+static void
+alloc_dxf_coords (int points, double **x, double **y, double **z)
+{
+/* allocating the X, Y and Z arrays as a single memory block */
+    double *buf = malloc (sizeof (double) * points * 3);
+    *x = buf;
+    *y = buf + points;
+    *z = buf + (points * 2);
+}
+
 static gaiaDxfHatchSegmPtr
 alloc_dxf_hatch_segm (double x0, double y0, double x1, double y1)
 {
@@ -458,9 +542,7 @@ alloc_dxf_hole (int points)
     int i;
     gaiaDxfHolePtr hole = malloc (sizeof (gaiaDxfHole));
     hole->points = points;
-    hole->x = malloc (sizeof (double) * points);
-    hole->y = malloc (sizeof (double) * points);
-    hole->z = malloc (sizeof (double) * points);
+    alloc_dxf_coords (points, &(hole->x), &(hole->y), &(hole->z));
     for (i = 0; i < points; i++)
       {
 	  *(hole->x + i) = 0.0;
@@ -489,11 +571,7 @@ destroy_dxf_hole (gaiaDxfHolePtr hole)
     if (hole == NULL)
 	return;
     if (hole->x != NULL)
-	free (hole->x);
-    if (hole->y != NULL)
-	free (hole->y);
-    if (hole->z != NULL)
-	free (hole->z);
+	free (hole->x);		/* Y and Z share the same memory block */
     free (hole);
 }
 
@@ -507,20 +585,16 @@ force_closure (gaiaDxfPolylinePtr line)
 	  double *ptr_x;
 	  double *ptr_y;
 	  double *ptr_z;
-	  ptr_x = realloc (line->x, sizeof (double) * (line->points + 1));
-	  ptr_y = realloc (line->y, sizeof (double) * (line->points + 1));
-	  ptr_z = realloc (line->z, sizeof (double) * (line->points + 1));
-	  if (ptr_x == NULL || ptr_y == NULL || ptr_z == NULL)
+	  alloc_dxf_coords (line->points + 1, &ptr_x, &ptr_y, &ptr_z);
+	  if (ptr_x == NULL)
 	    {
 		/* some unexpected error happened - giving up */
-		if (ptr_x == NULL)
-		    free (ptr_x);
-		if (ptr_y == NULL)
-		    free (ptr_y);
-		if (ptr_z == NULL)
-		    free (ptr_z);
 		return 0;
 	    }
+	  memcpy (ptr_x, line->x, sizeof (double) * line->points);
+	  memcpy (ptr_y, line->y, sizeof (double) * line->points);
+	  memcpy (ptr_z, line->z, sizeof (double) * line->points);
+	  free (line->x);
 	  line->x = ptr_x;
 	  line->y = ptr_y;
 	  line->z = ptr_z;
@@ -663,12 +737,9 @@ linked_rings (const void *p_cache, gaiaDxfPolylinePtr line)
 	  rng = pg->Exterior;
 	  /* rebuilding the exterior ring */
 	  free (line->x);
-	  free (line->y);
-	  free (line->z);
 	  line->points = rng->Points;
-	  line->x = malloc (sizeof (double) * line->points);
-	  line->y = malloc (sizeof (double) * line->points);
-	  line->z = malloc (sizeof (double) * line->points);
+	  alloc_dxf_coords (line->points, &(line->x), &(line->y),
+			    &(line->z));
 	  for (i = 0; i < line->points; i++)
 	    {
 		/* setting the exterior ring points */
@@ -1052,10 +1123,10 @@ insert_dxf_insert (gaiaDxfParserPtr dxf, const char *layer_name,
 }
 
 static gaiaDxfPointPtr
-alloc_dxf_point (double x, double y, double z)
+alloc_dxf_point (gaiaDxfParserPtr dxf, double x, double y, double z)
 {
 /* allocating and initializing a DXF Point object */
-    gaiaDxfPointPtr pt = malloc (sizeof (gaiaDxfPoint));
+    gaiaDxfPointPtr pt = arena_alloc_point (dxf->arena);
     pt->x = x;
     pt->y = y;
     pt->z = z;
@@ -1066,7 +1137,7 @@ alloc_dxf_point (double x, double y, double z)
 }
 
 static void
-destroy_dxf_point (gaiaDxfPointPtr pt)
+destroy_dxf_point (gaiaDxfParserPtr dxf, gaiaDxfPointPtr pt)
 {
 /* memory cleanup - destroying a DXF Point object */
     gaiaDxfExtraAttrPtr ext;
@@ -1080,7 +1151,9 @@ destroy_dxf_point (gaiaDxfPointPtr pt)
 	  destroy_dxf_extra (ext);
 	  ext = n_ext;
       }
-    free (pt);
+/* returning the Point to the memory arena */
+    pt->next = ((dxfArenaPtr) (dxf->arena))->free_list;
+    ((dxfArenaPtr) (dxf->arena))->free_list = pt;
 }
 
 static int
@@ -1126,7 +1199,7 @@ insert_dxf_point (gaiaDxfParserPtr dxf, const char *layer_name,
 	    }
 	  lyr = lyr->next;
       }
-    destroy_dxf_point (pt);
+    destroy_dxf_point (dxf, pt);
 }
 
 static void
@@ -1156,9 +1229,7 @@ alloc_dxf_polyline (int is_closed, int points)
     gaiaDxfPolylinePtr ln = malloc (sizeof (gaiaDxfPolyline));
     ln->is_closed = is_closed;
     ln->points = points;
-    ln->x = malloc (sizeof (double) * points);
-    ln->y = malloc (sizeof (double) * points);
-    ln->z = malloc (sizeof (double) * points);
+    alloc_dxf_coords (points, &(ln->x), &(ln->y), &(ln->z));
     for (i = 0; i < points; i++)
       {
 	  *(ln->x + i) = 0.0;
@@ -1181,9 +1252,7 @@ alloc_dxf_line (double x0, double y0, double z0, double x1, double y1,
     gaiaDxfPolylinePtr ln = malloc (sizeof (gaiaDxfPolyline));
     ln->is_closed = 0;
     ln->points = 2;
-    ln->x = malloc (sizeof (double) * 2);
-    ln->y = malloc (sizeof (double) * 2);
-    ln->z = malloc (sizeof (double) * 2);
+    alloc_dxf_coords (2, &(ln->x), &(ln->y), &(ln->z));
     *(ln->x + 0) = x0;
     *(ln->y + 0) = y0;
     *(ln->z + 0) = z0;
@@ -1209,11 +1278,7 @@ destroy_dxf_polyline (gaiaDxfPolylinePtr ln)
     if (ln == NULL)
 	return;
     if (ln->x != NULL)
-	free (ln->x);
-    if (ln->y != NULL)
-	free (ln->y);
-    if (ln->z != NULL)
-	free (ln->z);
+	free (ln->x);		/* Y and Z share the same memory block */
     ext = ln->first;
     while (ext != NULL)
       {
@@ -1421,12 +1486,9 @@ unlinked_rings (const void *p_cache, gaiaDxfPolylinePtr line)
 	  rng = pg->Exterior;
 	  /* rebuilding the exterior ring */
 	  free (line->x);
-	  free (line->y);
-	  free (line->z);
 	  line->points = rng->Points;
-	  line->x = malloc (sizeof (double) * line->points);
-	  line->y = malloc (sizeof (double) * line->points);
-	  line->z = malloc (sizeof (double) * line->points);
+	  alloc_dxf_coords (line->points, &(line->x), &(line->y),
+			    &(line->z));
 	  for (i = 0; i < line->points; i++)
 	    {
 		/* setting the exterior ring points */
@@ -1601,7 +1663,7 @@ alloc_dxf_block (const char *layer, const char *id)
 }
 
 static void
-destroy_dxf_block (gaiaDxfBlockPtr blk)
+destroy_dxf_block (gaiaDxfParserPtr dxf, gaiaDxfBlockPtr blk)
 {
 /* memory cleanup - destroying a DXF Block object */
     gaiaDxfTextPtr txt;
@@ -1629,7 +1691,7 @@ destroy_dxf_block (gaiaDxfBlockPtr blk)
     while (pt != NULL)
       {
 	  n_pt = pt->next;
-	  destroy_dxf_point (pt);
+	  destroy_dxf_point (dxf, pt);
 	  pt = n_pt;
       }
     ln = blk->first_line;
@@ -1772,7 +1834,7 @@ alloc_dxf_layer (const char *name, int force_dims)
 }
 
 static void
-destroy_dxf_layer (gaiaDxfLayerPtr lyr)
+destroy_dxf_layer (gaiaDxfParserPtr dxf, gaiaDxfLayerPtr lyr)
 {
 /* memory cleanup - destroying a DXF Layer object */
     gaiaDxfTextPtr txt;
@@ -1798,7 +1860,7 @@ destroy_dxf_layer (gaiaDxfLayerPtr lyr)
     while (pt != NULL)
       {
 	  n_pt = pt->next;
-	  destroy_dxf_point (pt);
+	  destroy_dxf_point (dxf, pt);
 	  pt = n_pt;
       }
     ln = lyr->first_line;
@@ -1910,7 +1972,7 @@ static void
 set_dxf_vertex (gaiaDxfParserPtr dxf)
 {
 /* saving the current Polyline Vertex */
-    gaiaDxfPointPtr pt = malloc (sizeof (gaiaDxfPoint));
+    gaiaDxfPointPtr pt = arena_alloc_point (dxf->arena);
     pt->x = dxf->curr_point.x;
     pt->y = dxf->curr_point.y;
     pt->z = dxf->curr_point.z;
@@ -1969,7 +2031,7 @@ save_current_polyline (const void *p_cache, gaiaDxfParserPtr dxf)
     while (pt != NULL)
       {
 	  n_pt = pt->next;
-	  destroy_dxf_point (pt);
+	  destroy_dxf_point (dxf, pt);
 	  pt = n_pt;
       }
     /* resetting curr_layer */
@@ -2019,7 +2081,7 @@ reset_dxf_block (gaiaDxfParserPtr dxf)
     while (pt != NULL)
       {
 	  n_pt = pt->next;
-	  destroy_dxf_point (pt);
+	  destroy_dxf_point (dxf, pt);
 	  pt = n_pt;
       }
     ln = dxf->curr_block.first_line;
@@ -2363,7 +2425,7 @@ reset_dxf_entity (const void *p_cache, gaiaDxfParserPtr dxf)
       {
 	  /* saving the current Point */
 	  gaiaDxfPointPtr pt =
-	      alloc_dxf_point (dxf->curr_point.x, dxf->curr_point.y,
+	      alloc_dxf_point (dxf, dxf->curr_point.x, dxf->curr_point.y,
 			       dxf->curr_point.z);
 	  if (dxf->is_block)
 	      insert_dxf_block_point (dxf, pt);
@@ -3389,6 +3451,7 @@ gaiaCreateDxfParser (int srid,
     if (special_rings == GAIA_DXF_RING_UNLINKED)
 	dxf->unlinked_rings = 1;
     dxf->undeclared_layers = 1;
+    dxf->arena = alloc_dxf_arena ();
     return dxf;
 }
 
@@ -3416,14 +3479,14 @@ gaiaDestroyDxfParser (gaiaDxfParserPtr dxf)
     while (lyr != NULL)
       {
 	  n_lyr = lyr->next;
-	  destroy_dxf_layer (lyr);
+	  destroy_dxf_layer (dxf, lyr);
 	  lyr = n_lyr;
       }
     pt = dxf->first_pt;
     while (pt != NULL)
       {
 	  n_pt = pt->next;
-	  destroy_dxf_point (pt);
+	  destroy_dxf_point (dxf, pt);
 	  pt = n_pt;
       }
     if (dxf->extra_key != NULL)
@@ -3441,12 +3504,13 @@ gaiaDestroyDxfParser (gaiaDxfParserPtr dxf)
     while (blk != NULL)
       {
 	  n_blk = blk->next;
-	  destroy_dxf_block (blk);
+	  destroy_dxf_block (dxf, blk);
 	  blk = n_blk;
       }
     if (dxf->curr_hatch != NULL)
 	destroy_dxf_hatch (dxf->curr_hatch);
     reset_dxf_block (dxf);
+    destroy_dxf_arena (dxf->arena);
     free (dxf);
 }
 
@@ -3494,14 +3558,33 @@ save_dxf_filename (gaiaDxfParserPtr dxf, const char *path)
       }
 }
 
+static int
+strip_dxf_cr (char *start, char *end)
+{
+/* removing in place any CR from a line; returns the new length */
+    char *in;
+    char *out;
+    in = memchr (start, '\r', end - start);
+    if (in == NULL)
+	return end - start;
+    out = in;
+    while (in < end)
+      {
+	  if (*in != '\r')
+	      *out++ = *in;
+	  in++;
+      }
+    return out - start;
+}
+
 static int
 gaiaParseDxfFileCommon (const void *p_cache, gaiaDxfParserPtr dxf,
 			const char *path)
 {
 /* parsing the whole DXF file */
-    int c;
-    char line[4192];
-    char *p = line;
+    char *buf;
+    size_t pending = 0;
+    size_t rd;
     FILE *fl;
 
     if (dxf == NULL)
@@ -3515,38 +3598,52 @@ gaiaParseDxfFileCommon (const void *p_cache, gaiaDxfParserPtr dxf,
     if (fl == NULL)
 	return 0;
 
-/* scanning the DXF file */
-    while ((c = getc (fl)) != EOF)
+/* 
+/ scanning the DXF file by large blocks; each line is parsed in place
+/ directly from the read buffer, and only the trailing incomplete line
+/ (never longer than DXF_MAX_LINE) is carried over to the next block
+*/
+    buf = malloc (DXF_READ_BLOCK + DXF_MAX_LINE);
+    while ((rd = fread (buf + pending, 1, DXF_READ_BLOCK, fl)) > 0)
       {
-	  if (c == '\r')
-	    {
-		/* ignoring any CR */
-		continue;
-	    }
-	  if (c == '\n')
+	  char *start = buf;
+	  char *end = buf + pending + rd;
+	  while (1)
 	    {
+		char *eol = memchr (start, '\n', end - start);
+		int len;
+		if (eol == NULL)
+		    break;
 		/* end line found */
-		*p = '\0';
-		if (!parse_dxf_line (p_cache, dxf, line))
+		len = strip_dxf_cr (start, eol);
+		/* Even Rouault 2013-06-02 - avoiding a potential buffer overflow */
+		if (len >= DXF_MAX_LINE - 1)
+		    goto stop;
+		/* END - Even Rouault 2013-06-02 */
+		*(start + len) = '\0';
+		if (!parse_dxf_line (p_cache, dxf, start))
 		    goto stop;
 		if (dxf->eof)
 		  {
 		      /* EOF marker found - quitting */
-		      break;
+		      goto done;
 		  }
-		p = line;
-		continue;
+		start = eol + 1;
 	    }
-	  *p++ = (char) c;
-	  /* Even Rouault 2013-06-02 - avoiding a potential buffer overflow */
-	  if (p - line == sizeof (line) - 1)
+	  /* carrying over the incomplete line */
+	  pending = strip_dxf_cr (start, end);
+	  if (pending >= DXF_MAX_LINE - 1)
 	      goto stop;
-	  /* END - Even Rouault 2013-06-02 */
+	  if (pending > 0)
+	      memmove (buf, start, pending);
       }
 
+  done:
+    free (buf);
     fclose (fl);
     return 1;
   stop:
+    free (buf);
     fclose (fl);
     return 0;
 }
@@ -160,10 +160,12 @@ extern "C"
 				sqlite3_stmt ** xstmt);
 
     DXF_PRIVATE int
-	import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append);
+	import_mixed (sqlite3 * handle, gaiaDxfParserPtr dxf, int append,
+		      int num_threads);
 
     DXF_PRIVATE int
-	import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append);
+	import_by_layer (sqlite3 * handle, gaiaDxfParserPtr dxf, int append,
+			 int num_threads);
 
     DXF_PRIVATE int
 	create_instext_table (sqlite3 * handle, const char *name,
@@ -198,6 +200,24 @@ extern "C"
 
     DXF_PRIVATE int check_unclosed_hole (gaiaDxfHolePtr hole, int is3d);
 
+#define DXF_ENCODE_TEXT		1
+#define DXF_ENCODE_POINT	2
+#define DXF_ENCODE_LINE		3
+#define DXF_ENCODE_POLYG	4
+
+    struct dxf_encoder;
+
+    DXF_PRIVATE struct dxf_encoder *dxf_encoder_create (gaiaDxfParserPtr dxf,
+							gaiaDxfLayerPtr layer,
+							int kind, int geom3d,
+							int num_threads);
+
+    DXF_PRIVATE void dxf_encoder_next (struct dxf_encoder *enc,
+				       void *entity, int coord3d,
+				       unsigned char **blob, int *blob_size);
+
+    DXF_PRIVATE void dxf_encoder_destroy (struct dxf_encoder *enc);
+
 #ifdef __cplusplus
 }
 #endif
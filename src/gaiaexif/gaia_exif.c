@@ -2354,6 +2354,315 @@ gaiaExifTagGetHumanReadable (const gaiaExifTagPtr tag, char *str, int len,
     *ok = 0;
 }
 
+#define EXIF_SCAN_MAX_IFD	16
+
+struct exif_gps_scan
+{
+/* the bare GPS tags extracted by the allocation-free EXIF scanner */
+    int exif;
+    int gps_tags;
+    char lat_ref;
+    char long_ref;
+    double lat[3];
+    double lon[3];
+};
+
+static int
+exifScanRange (int size, unsigned int offset, unsigned int length)
+{
+/* checks if [offset, offset + length) lies within the BLOB */
+    if (offset > (unsigned int) size)
+	return 0;
+    if (length > (unsigned int) size - offset)
+	return 0;
+    return 1;
+}
+
+static int
+exifScanRationals (const unsigned char *blob, int size, const unsigned char *p,
+		   int endian_mode, int endian_arch, int app1_offset,
+		   double *values)
+{
+/* fetching the three RATIONAL values of some GPS Lat/Long tag */
+    int i;
+    unsigned int num;
+    unsigned int den;
+    unsigned int offset = exifImportU32 (p + 8, endian_mode, endian_arch);
+    offset += app1_offset + 10;
+    if (!exifScanRange (size, offset, 24))
+	return 0;
+    for (i = 0; i < 3; i++)
+      {
+	  num = exifImportU32 (blob + offset + (i * 8), endian_mode,
+			       endian_arch);
+	  den = exifImportU32 (blob + offset + (i * 8) + 4, endian_mode,
+			       endian_arch);
+	  if (den)
+	      values[i] = (double) num / (double) den;
+      }
+    return 1;
+}
+
+static int
+exifScanGps (const unsigned char *blob, int size, struct exif_gps_scan *scan)
+{
+/*
+/ scanning an EXIF photo just for its GPS position
+/
+/ this one walks the very same APP1/IFD0/Exif-IFD/GPS-IFD path
+/ followed by gaiaGetExifTags(), but directly reads the few tags
+/ of interest from the BLOB itself, so to avoid building the full
+/ list of EXIF tags.
+/ returns 0 if some required offset lies beyond the end of the
+/ BLOB (a truncated or malformed photo), 1 in any other case;
+/ any out of range IFD or value will simply be skipped
+*/
+    int endian_arch = gaiaEndianArch ();
+    int endian_mode;
+    unsigned short app1_size;
+    int app1_offset;
+    unsigned int ifd[EXIF_SCAN_MAX_IFD];
+    unsigned int gps[EXIF_SCAN_MAX_IFD];
+    int n_ifd = 0;
+    int n_gps = 0;
+    int truncated = 0;
+    int k;
+    unsigned int offset;
+    unsigned short items;
+    unsigned short i;
+    unsigned short tag_id;
+    unsigned short type;
+    unsigned short count;
+    const unsigned char *p;
+    const unsigned char *str;
+
+    scan->exif = 0;
+    scan->gps_tags = 0;
+    scan->lat_ref = '\0';
+    scan->long_ref = '\0';
+    for (k = 0; k < 3; k++)
+      {
+	  scan->lat[k] = -DBL_MAX;
+	  scan->lon[k] = -DBL_MAX;
+      }
+    if (!blob || size < 14)
+	return 0;
+/* checking for SOI [Start Of Image] */
+    if (*(blob + 0) != 0xff || *(blob + 1) != 0xd8)
+	return 1;
+    for (app1_offset = 2; app1_offset < size - 1; app1_offset++)
+      {
+	  if (*(blob + app1_offset) == 0xff
+	      && *(blob + app1_offset + 1) == 0xe1)
+	    {
+		/* found APP1 marker */
+		break;
+	    }
+      }
+    if (app1_offset == size - 1)
+	return 0;
+    if (!exifScanRange (size, app1_offset, 18))
+	return 0;
+/* checking for EXIF identifier, Pad and byte order */
+    if (memcmp (blob + app1_offset + 4, "Exif", 4) != 0)
+	return 1;
+    if (*(blob + app1_offset + 8) != 0x00 || *(blob + app1_offset + 9) != 0x00)
+	return 1;
+    if (memcmp (blob + app1_offset + 10, "II", 2) == 0)
+	endian_mode = GAIA_LITTLE_ENDIAN;
+    else if (memcmp (blob + app1_offset + 10, "MM", 2) == 0)
+	endian_mode = GAIA_BIG_ENDIAN;
+    else
+	return 1;
+    app1_size =
+	exifImportU16 (blob + app1_offset + 2, endian_mode, endian_arch);
+    if ((app1_size + app1_offset + 4) > size)
+	return 0;
+/* checking for marker */
+    if (endian_mode == GAIA_BIG_ENDIAN)
+      {
+	  if (*(blob + app1_offset + 12) != 0x00
+	      || *(blob + app1_offset + 13) != 0x2a)
+	      return 1;
+      }
+    else
+      {
+	  if (*(blob + app1_offset + 12) != 0x2a
+	      || *(blob + app1_offset + 13) != 0x00)
+	      return 1;
+      }
+    scan->exif = 1;
+
+/*
+/ visiting IFD0 and then any Exif-IFD in list order, collecting
+/ the GPSinfo-IFD pointers exactly as exifExpandGPS() would see them
+*/
+    offset = exifImportU32 (blob + app1_offset + 14, endian_mode, endian_arch);
+    ifd[n_ifd++] = offset + app1_offset + 10;
+    for (k = 0; k < n_ifd; k++)
+      {
+	  offset = ifd[k];
+	  if (!exifScanRange (size, offset, 2))
+	    {
+		truncated = 1;
+		continue;
+	    }
+	  items = exifImportU16 (blob + offset, endian_mode, endian_arch);
+	  offset += 2;
+	  if (!exifScanRange (size, offset, items * 12))
+	    {
+		truncated = 1;
+		continue;
+	    }
+	  for (i = 0; i < items; i++, offset += 12)
+	    {
+		p = blob + offset;
+		tag_id = exifImportU16 (p, endian_mode, endian_arch);
+		if (tag_id != 34665 && tag_id != 34853)
+		    continue;
+		if (tag_id == 34665 && n_ifd < EXIF_SCAN_MAX_IFD)
+		    ifd[n_ifd++] =
+			exifImportU32 (p + 8, endian_mode,
+				       endian_arch) + app1_offset + 10;
+		if (tag_id == 34853 && n_gps < EXIF_SCAN_MAX_IFD)
+		    gps[n_gps++] =
+			exifImportU32 (p + 8, endian_mode,
+				       endian_arch) + app1_offset + 10;
+	    }
+      }
+
+/* visiting the GPS-IFDs; later tags will override earlier ones */
+    for (k = 0; k < n_gps; k++)
+      {
+	  offset = gps[k];
+	  if (!exifScanRange (size, offset, 2))
+	    {
+		truncated = 1;
+		continue;
+	    }
+	  items = exifImportU16 (blob + offset, endian_mode, endian_arch);
+	  offset += 2;
+	  if (!exifScanRange (size, offset, items * 12))
+	    {
+		truncated = 1;
+		continue;
+	    }
+	  for (i = 0; i < items; i++, offset += 12)
+	    {
+		p = blob + offset;
+		scan->gps_tags += 1;
+		tag_id = exifImportU16 (p, endian_mode, endian_arch);
+		type = exifImportU16 (p + 2, endian_mode, endian_arch);
+		count =
+		    (unsigned short) exifImportU32 (p + 4, endian_mode,
+						    endian_arch);
+		if (tag_id == 34853 && n_gps < EXIF_SCAN_MAX_IFD)
+		    gps[n_gps++] =
+			exifImportU32 (p + 8, endian_mode,
+				       endian_arch) + app1_offset + 10;
+		if ((tag_id == 0x01 || tag_id == 0x03) && type == 2
+		    && count > 0)
+		  {
+		      /* GPSLatitudeRef or GPSLongitudeRef */
+		      if (count <= 4)
+			  str = p + 8;
+		      else
+			{
+			    unsigned int str_offset =
+				exifImportU32 (p + 8, endian_mode,
+					       endian_arch) + app1_offset + 10;
+			    if (!exifScanRange (size, str_offset, 1))
+			      {
+				  truncated = 1;
+				  continue;
+			      }
+			    str = blob + str_offset;
+			}
+		      if (tag_id == 0x01)
+			  scan->lat_ref = (char) *str;
+		      else
+			  scan->long_ref = (char) *str;
+		  }
+		if (tag_id == 0x02 && type == 5 && count == 3)
+		  {
+		      /* GPSLatitude */
+		      if (!exifScanRationals
+			  (blob, size, p, endian_mode, endian_arch,
+			   app1_offset, scan->lat))
+			  truncated = 1;
+		  }
+		if (tag_id == 0x04 && type == 5 && count == 3)
+		  {
+		      /* GPSLongitude */
+		      if (!exifScanRationals
+			  (blob, size, p, endian_mode, endian_arch,
+			   app1_offset, scan->lon))
+			  truncated = 1;
+		  }
+	    }
+      }
+    return truncated ? 0 : 1;
+}
+
+static int
+exifScanHasCoords (const struct exif_gps_scan *scan)
+{
+/* checks if the scanned GPS tags define a valid position */
+    if ((scan->lat_ref == 'N' || scan->lat_ref == 'S'
+	 || scan->long_ref == 'E' || scan->long_ref == 'W')
+	&& scan->lat[0] != -DBL_MAX && scan->lat[1] != -DBL_MAX
+	&& scan->lat[2] != -DBL_MAX && scan->lon[0] != -DBL_MAX
+	&& scan->lon[1] != -DBL_MAX && scan->lon[2] != -DBL_MAX)
+	return 1;
+    return 0;
+}
+
+static int
+exifScanCoords (const struct exif_gps_scan *scan, double *longitude,
+		double *latitude)
+{
+/* computing the decimal degrees position from the scanned GPS tags */
+    double degs;
+    double mins;
+    double secs;
+    double sign;
+    if (!exifScanHasCoords (scan))
+	return 0;
+    if (scan->lat_ref == 'S')
+	sign = -1.0;
+    else
+	sign = 1.0;
+    degs = math_round (scan->lat[0] * 1000000.0);
+    mins = math_round (scan->lat[1] * 1000000.0);
+    secs = math_round (scan->lat[2] * 1000000.0);
+    *latitude =
+	math_round (degs + (mins / 60.0) +
+		    (secs / 3600.0)) * (sign / 1000000.0);
+    if (scan->long_ref == 'W')
+	sign = -1.0;
+    else
+	sign = 1.0;
+    degs = math_round (scan->lon[0] * 1000000.0);
+    mins = math_round (scan->lon[1] * 1000000.0);
+    secs = math_round (scan->lon[2] * 1000000.0);
+    *longitude =
+	math_round (degs + (mins / 60.0) +
+		    (secs / 3600.0)) * (sign / 1000000.0);
+    return 1;
+}
+
+GAIAEXIF_DECLARE int
+gaiaScanExifGps (const unsigned char *blob, int size, int *exif, int *gps,
+		 double *longitude, double *latitude)
+{
+/* quickly checking some JPEG photo for EXIF and GPS position */
+    struct exif_gps_scan scan;
+    int ret = exifScanGps (blob, size, &scan);
+    *exif = scan.exif;
+    *gps = exifScanCoords (&scan, longitude, latitude);
+    return ret;
+}
+
 GAIAEXIF_DECLARE int
 gaiaGuessBlobType (const unsigned char *blob, int size)
 {
@@ -2362,8 +2671,7 @@ gaiaGuessBlobType (const unsigned char *blob, int size)
     int exif = 0;
     int exif_gps = 0;
     int geom = 1;
-    gaiaExifTagListPtr exif_list;
-    gaiaExifTagPtr pT;
+    struct exif_gps_scan scan;
     unsigned char jpeg1_signature[2];
     unsigned char jpeg2_signature[2];
     unsigned char jpeg3_signature[4];
@@ -2503,21 +2811,12 @@ gaiaGuessBlobType (const unsigned char *blob, int size)
       }
     if (jpeg)
       {
-	  exif_list = gaiaGetExifTags (blob, size);
-	  if (exif_list)
+	  exifScanGps (blob, size, &scan);
+	  if (scan.exif)
 	    {
 		exif = 1;
-		pT = exif_list->First;
-		while (pT)
-		  {
-		      if (pT->Gps)
-			{
-			    exif_gps = 1;
-			    break;
-			}
-		      pT = pT->Next;
-		  }
-		gaiaExifTagsFree (exif_list);
+		if (scan.gps_tags)
+		    exif_gps = 1;
 	    }
       }
     if (jpeg && exif && exif_gps)
@@ -2573,106 +2872,11 @@ gaiaGetGpsCoords (const unsigned char *blob, int size, double *longitude,
 		  double *latitude)
 {
 /* returns the ExifGps coords, if they exists */
-    gaiaExifTagListPtr exif_list;
-    gaiaExifTagPtr pT;
-    char lat_ref = '\0';
-    char long_ref = '\0';
-    double lat_degs = -DBL_MAX;
-    double lat_mins = -DBL_MAX;
-    double lat_secs = -DBL_MAX;
-    double long_degs = -DBL_MAX;
-    double long_mins = -DBL_MAX;
-    double long_secs = -DBL_MAX;
-    double dblval;
-    double sign;
-    int ok;
+    struct exif_gps_scan scan;
     if (size < 1 || !blob)
 	return 0;
-    exif_list = gaiaGetExifTags (blob, size);
-    if (exif_list)
-      {
-	  pT = exif_list->First;
-	  while (pT)
-	    {
-		if (pT->Gps && pT->TagId == 0x01)
-		  {
-		      /* ok, this one is the GPSLatitudeRef tag */
-		      if (pT->Type == 2)
-			  lat_ref = *(pT->StringValue);
-		  }
-		if (pT->Gps && pT->TagId == 0x03)
-		  {
-		      /* ok, this one is the GPSLongitudeRef tag */
-		      if (pT->Type == 2)
-			  long_ref = *(pT->StringValue);
-		  }
-		if (pT->Gps && pT->TagId == 0x02)
-		  {
-		      /* ok, this one is the GPSLatitude tag */
-		      if (pT->Type == 5 && pT->Count == 3)
-			{
-			    dblval = gaiaExifTagGetRationalValue (pT, 0, &ok);
-			    if (ok)
-				lat_degs = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 1, &ok);
-			    if (ok)
-				lat_mins = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 2, &ok);
-			    if (ok)
-				lat_secs = dblval;
-			}
-		  }
-		if (pT->Gps && pT->TagId == 0x04)
-		  {
-		      /* ok, this one is the GPSLongitude tag */
-		      if (pT->Type == 5 && pT->Count == 3)
-			{
-			    dblval = gaiaExifTagGetRationalValue (pT, 0, &ok);
-			    if (ok)
-				long_degs = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 1, &ok);
-			    if (ok)
-				long_mins = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 2, &ok);
-			    if (ok)
-				long_secs = dblval;
-			}
-		  }
-		pT = pT->Next;
-	    }
-	  gaiaExifTagsFree (exif_list);
-	  if ((lat_ref == 'N' || lat_ref == 'S' || long_ref == 'E'
-	       || long_ref == 'W') && lat_degs != -DBL_MAX
-	      && lat_mins != -DBL_MAX && lat_secs != -DBL_MAX
-	      && long_degs != -DBL_MAX && long_mins != -DBL_MAX
-	      && long_secs != -DBL_MAX)
-	    {
-		if (lat_ref == 'S')
-		    sign = -1.0;
-		else
-		    sign = 1.0;
-		lat_degs = math_round (lat_degs * 1000000.0);
-		lat_mins = math_round (lat_mins * 1000000.0);
-		lat_secs = math_round (lat_secs * 1000000.0);
-		dblval =
-		    math_round (lat_degs + (lat_mins / 60.0) +
-				(lat_secs / 3600.0)) * (sign / 1000000.0);
-		*latitude = dblval;
-		if (long_ref == 'W')
-		    sign = -1.0;
-		else
-		    sign = 1.0;
-		long_degs = math_round (long_degs * 1000000.0);
-		long_mins = math_round (long_mins * 1000000.0);
-		long_secs = math_round (long_secs * 1000000.0);
-		dblval =
-		    math_round (long_degs + (long_mins / 60.0) +
-				(long_secs / 3600.0)) * (sign / 1000000.0);
-		*longitude = dblval;
-		return 1;
-	    }
-      }
-    return 0;
+    exifScanGps (blob, size, &scan);
+    return exifScanCoords (&scan, longitude, latitude);
 }
 
 GAIAEXIF_DECLARE int
@@ -2680,101 +2884,35 @@ gaiaGetGpsLatLong (const unsigned char *blob, int size, char *latlong,
 		   int ll_size)
 {
 /* returns the ExifGps Latitude and Longitude, if they exists */
-    gaiaExifTagListPtr exif_list;
-    gaiaExifTagPtr pT;
-    char lat_ref = '\0';
-    char long_ref = '\0';
-    double lat_degs = -DBL_MAX;
-    double lat_mins = -DBL_MAX;
-    double lat_secs = -DBL_MAX;
-    double long_degs = -DBL_MAX;
-    double long_mins = -DBL_MAX;
-    double long_secs = -DBL_MAX;
-    double dblval;
-    int ok;
+    struct exif_gps_scan scan;
     char ll[1024];
     int len;
     *latlong = '\0';
     if (size < 1 || !blob)
 	return 0;
-    exif_list = gaiaGetExifTags (blob, size);
-    if (exif_list)
+    exifScanGps (blob, size, &scan);
+    if (exifScanHasCoords (&scan))
       {
-	  pT = exif_list->First;
-	  while (pT)
-	    {
-		if (pT->Gps && pT->TagId == 0x01)
-		  {
-		      /* ok, this one is the GPSLatitudeRef tag */
-		      if (pT->Type == 2)
-			  lat_ref = *(pT->StringValue);
-		  }
-		if (pT->Gps && pT->TagId == 0x03)
-		  {
-		      /* ok, this one is the GPSLongitudeRef tag */
-		      if (pT->Type == 2)
-			  long_ref = *(pT->StringValue);
-		  }
-		if (pT->Gps && pT->TagId == 0x02)
-		  {
-		      /* ok, this one is the GPSLatitude tag */
-		      if (pT->Type == 5 && pT->Count == 3)
-			{
-			    dblval = gaiaExifTagGetRationalValue (pT, 0, &ok);
-			    if (ok)
-				lat_degs = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 1, &ok);
-			    if (ok)
-				lat_mins = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 2, &ok);
-			    if (ok)
-				lat_secs = dblval;
-			}
-		  }
-		if (pT->Gps && pT->TagId == 0x04)
-		  {
-		      /* ok, this one is the GPSLongitude tag */
-		      if (pT->Type == 5 && pT->Count == 3)
-			{
-			    dblval = gaiaExifTagGetRationalValue (pT, 0, &ok);
-			    if (ok)
-				long_degs = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 1, &ok);
-			    if (ok)
-				long_mins = dblval;
-			    dblval = gaiaExifTagGetRationalValue (pT, 2, &ok);
-			    if (ok)
-				long_secs = dblval;
-			}
-		  }
-		pT = pT->Next;
-	    }
-	  gaiaExifTagsFree (exif_list);
-	  if ((lat_ref == 'N' || lat_ref == 'S' || long_ref == 'E'
-	       || long_ref == 'W') && lat_degs != -DBL_MAX
-	      && lat_mins != -DBL_MAX && lat_secs != -DBL_MAX
-	      && long_degs != -DBL_MAX && long_mins != -DBL_MAX
-	      && long_secs != -DBL_MAX)
+	  char lat_ref = scan.lat_ref;
+	  char long_ref = scan.long_ref;
+	  int long_d = scan.lon[0];
+	  int long_m = scan.lon[1];
+	  int long_s = scan.lon[2];
+	  int lat_d = scan.lat[0];
+	  int lat_m = scan.lat[1];
+	  int lat_s = scan.lat[2];
+	  sprintf (ll, "%02d°%02d′%02d″%c %03d°%02d′%02d″%c",
+		   lat_d, lat_m, lat_s, lat_ref, long_d, long_m, long_s,
+		   long_ref);
+	  len = strlen (ll);
+	  if (len < ll_size)
+	      strcpy (latlong, ll);
+	  else
 	    {
-		int long_d = long_degs;
-		int long_m = long_mins;
-		int long_s = long_secs;
-		int lat_d = lat_degs;
-		int lat_m = lat_mins;
-		int lat_s = lat_secs;
-		sprintf (ll, "%02d°%02d′%02d″%c %03d°%02d′%02d″%c",
-			 lat_d, lat_m, lat_s, lat_ref, long_d, long_m, long_s,
-			 long_ref);
-		len = strlen (ll);
-		if (len < ll_size)
-		    strcpy (latlong, ll);
-		else
-		  {
-		      memcpy (latlong, ll, ll_size - 1);
-		      latlong[ll_size] = '\0';
-		  }
-		return 1;
+		memcpy (latlong, ll, ll_size - 1);
+		latlong[ll_size] = '\0';
 	    }
+	  return 1;
       }
     return 0;
 }
@@ -56,6 +56,16 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include "config.h"
 #endif
 
+#ifndef OMIT_GEOS		/* including GEOS */
+#ifdef GEOS_REENTRANT
+#ifdef GEOS_ONLY_REENTRANT
+#define GEOS_USE_ONLY_R_API	/* only fully thread-safe GEOS API */
+#endif
+#endif
+#include <geos_c.h>
+#endif
+
+#include <spatialite_private.h>
 #include <spatialite/sqlite.h>
 #include <spatialite/gaiageo.h>
 
@@ -762,6 +772,478 @@ get_grid_base (double min_x, double min_y, double origin_x, double origin_y,
 	*base_y = y;
 }
 
+/*
+/ the grid functions classify whole rows of candidate cells
+/ by performing a scanline pass over the edges of the input
+/ geometry: any cell whose BBOX isn't crossed by any edge
+/ is either completely inside or completely outside, and
+/ can be resolved by simply counting the crossings on the
+/ left side.
+/ only the cells lying across the boundary will be checked
+/ by GEOS, always using a Prepared Geometry
+*/
+
+#define GRID_CELL_OUTSIDE	0
+#define GRID_CELL_INSIDE	1
+#define GRID_CELL_UNKNOWN	-1
+
+struct grid_edge
+{
+/* an edge [or isolated point] of the input geometry */
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+    double min_y;
+    double max_y;
+    int ring;
+};
+
+struct grid_scanline
+{
+/* the scanline helper */
+    struct grid_edge *edges;
+    int count;
+    int next;
+    int *active;
+    int n_active;
+    double *dirty;
+    int n_dirty;
+    double *cross;
+    int n_cross;
+};
+
+struct grid_prepared
+{
+/* the input geometry as a GEOS Prepared Geometry */
+    const void *p_cache;
+    gaiaGeomCollPtr geom;
+    GEOSGeometry *geos;
+    const GEOSPreparedGeometry *prepared;
+};
+
+static void
+grid_get_xy (double *coords, int dims, int iv, double *x, double *y)
+{
+/* fetching X and Y from a coords array */
+    double z;
+    double m;
+    if (dims == GAIA_XY_Z)
+      {
+	  gaiaGetPointXYZ (coords, iv, x, y, &z);
+      }
+    else if (dims == GAIA_XY_M)
+      {
+	  gaiaGetPointXYM (coords, iv, x, y, &m);
+      }
+    else if (dims == GAIA_XY_Z_M)
+      {
+	  gaiaGetPointXYZM (coords, iv, x, y, &z, &m);
+      }
+    else
+      {
+	  gaiaGetPoint (coords, iv, x, y);
+      }
+}
+
+static void
+grid_add_edge (struct grid_scanline *sl, double x1, double y1, double x2,
+	       double y2, int ring)
+{
+/* adding an edge to the scanline helper */
+    struct grid_edge *edge = sl->edges + sl->count;
+    edge->x1 = x1;
+    edge->y1 = y1;
+    edge->x2 = x2;
+    edge->y2 = y2;
+    edge->min_y = (y1 < y2) ? y1 : y2;
+    edge->max_y = (y1 > y2) ? y1 : y2;
+    edge->ring = ring;
+    sl->count += 1;
+}
+
+static void
+grid_add_vertices (struct grid_scanline *sl, double *coords, int points,
+		   int dims, int ring)
+{
+/* adding all edges from a Linestring or Ring */
+    int iv;
+    double x0;
+    double y0;
+    double x;
+    double y;
+    if (points < 1)
+	return;
+    grid_get_xy (coords, dims, 0, &x0, &y0);
+    if (points == 1)
+	grid_add_edge (sl, x0, y0, x0, y0, 0);
+    for (iv = 1; iv < points; iv++)
+      {
+	  grid_get_xy (coords, dims, iv, &x, &y);
+	  grid_add_edge (sl, x0, y0, x, y, ring);
+	  x0 = x;
+	  y0 = y;
+      }
+}
+
+static int
+grid_cmp_edges (const void *p1, const void *p2)
+{
+/* ordering edges by min-Y */
+    const struct grid_edge *e1 = (const struct grid_edge *) p1;
+    const struct grid_edge *e2 = (const struct grid_edge *) p2;
+    if (e1->min_y < e2->min_y)
+	return -1;
+    if (e1->min_y > e2->min_y)
+	return 1;
+    return 0;
+}
+
+static int
+grid_cmp_doubles (const void *p1, const void *p2)
+{
+/* ordering doubles */
+    double d1 = *((const double *) p1);
+    double d2 = *((const double *) p2);
+    if (d1 < d2)
+	return -1;
+    if (d1 > d2)
+	return 1;
+    return 0;
+}
+
+static int
+grid_cmp_intervals (const void *p1, const void *p2)
+{
+/* ordering intervals [pairs of doubles] by start */
+    return grid_cmp_doubles (p1, p2);
+}
+
+static struct grid_scanline *
+grid_scanline_create (struct grid_prepared *gp)
+{
+/* creating the scanline helper for the input geometry */
+    gaiaGeomCollPtr geom = gp->geom;
+    struct grid_scanline *sl;
+    gaiaPointPtr pt;
+    gaiaLinestringPtr ln;
+    gaiaPolygonPtr pg;
+    gaiaRingPtr rng;
+    int ib;
+    int count = 0;
+
+    if (gp->prepared == NULL)
+      {
+	  /* invalid geometry: always falling back to GEOS */
+	  return NULL;
+      }
+
+/* counting how many edges are there */
+    pt = geom->FirstPoint;
+    while (pt)
+      {
+	  count++;
+	  pt = pt->Next;
+      }
+    ln = geom->FirstLinestring;
+    while (ln)
+      {
+	  count += ln->Points;
+	  ln = ln->Next;
+      }
+    pg = geom->FirstPolygon;
+    while (pg)
+      {
+	  count += pg->Exterior->Points;
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	      count += pg->Interiors[ib].Points;
+	  pg = pg->Next;
+      }
+    if (count == 0)
+	return NULL;
+
+    sl = malloc (sizeof (struct grid_scanline));
+    sl->edges = malloc (sizeof (struct grid_edge) * count);
+    sl->active = malloc (sizeof (int) * count);
+    sl->dirty = malloc (sizeof (double) * 2 * count);
+    sl->cross = malloc (sizeof (double) * count);
+    sl->count = 0;
+    sl->next = 0;
+    sl->n_active = 0;
+    sl->n_dirty = 0;
+    sl->n_cross = 0;
+
+    pt = geom->FirstPoint;
+    while (pt)
+      {
+	  grid_add_edge (sl, pt->X, pt->Y, pt->X, pt->Y, 0);
+	  pt = pt->Next;
+      }
+    ln = geom->FirstLinestring;
+    while (ln)
+      {
+	  grid_add_vertices (sl, ln->Coords, ln->Points, ln->DimensionModel,
+			     0);
+	  ln = ln->Next;
+      }
+    pg = geom->FirstPolygon;
+    while (pg)
+      {
+	  rng = pg->Exterior;
+	  grid_add_vertices (sl, rng->Coords, rng->Points,
+			     rng->DimensionModel, 1);
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	    {
+		rng = pg->Interiors + ib;
+		grid_add_vertices (sl, rng->Coords, rng->Points,
+				   rng->DimensionModel, 1);
+	    }
+	  pg = pg->Next;
+      }
+    qsort (sl->edges, sl->count, sizeof (struct grid_edge), grid_cmp_edges);
+    return sl;
+}
+
+static void
+grid_scanline_destroy (struct grid_scanline *sl)
+{
+/* memory cleanup - destroying the scanline helper */
+    if (sl == NULL)
+	return;
+    free (sl->edges);
+    free (sl->active);
+    free (sl->dirty);
+    free (sl->cross);
+    free (sl);
+}
+
+static void
+grid_scanline_row (struct grid_scanline *sl, double y_lo, double y_hi)
+{
+/* 
+/ preparing a row of cells [y_lo, y_hi]
+/ rows are always expected to be processed northward
+*/
+    int i;
+    int j;
+    double y_mid = (y_lo + y_hi) / 2.0;
+
+/* updating the active edges list */
+    j = 0;
+    for (i = 0; i < sl->n_active; i++)
+      {
+	  struct grid_edge *edge = sl->edges + sl->active[i];
+	  if (edge->max_y >= y_lo)
+	      sl->active[j++] = sl->active[i];
+      }
+    sl->n_active = j;
+    while (sl->next < sl->count && sl->edges[sl->next].min_y <= y_hi)
+      {
+	  if (sl->edges[sl->next].max_y >= y_lo)
+	      sl->active[sl->n_active++] = sl->next;
+	  sl->next += 1;
+      }
+
+/* clipping each active edge against the row */
+    sl->n_dirty = 0;
+    sl->n_cross = 0;
+    for (i = 0; i < sl->n_active; i++)
+      {
+	  struct grid_edge *edge = sl->edges + sl->active[i];
+	  double min_x;
+	  double max_x;
+	  if (edge->y1 == edge->y2)
+	    {
+		min_x = (edge->x1 < edge->x2) ? edge->x1 : edge->x2;
+		max_x = (edge->x1 > edge->x2) ? edge->x1 : edge->x2;
+	    }
+	  else
+	    {
+		double dx = (edge->x2 - edge->x1) / (edge->y2 - edge->y1);
+		double ya = (edge->min_y > y_lo) ? edge->min_y : y_lo;
+		double yb = (edge->max_y < y_hi) ? edge->max_y : y_hi;
+		double xa = edge->x1 + ((ya - edge->y1) * dx);
+		double xb = edge->x1 + ((yb - edge->y1) * dx);
+		min_x = (xa < xb) ? xa : xb;
+		max_x = (xa > xb) ? xa : xb;
+	    }
+	  sl->dirty[sl->n_dirty * 2] = min_x;
+	  sl->dirty[(sl->n_dirty * 2) + 1] = max_x;
+	  sl->n_dirty += 1;
+	  if (edge->ring && ((edge->y1 > y_mid) != (edge->y2 > y_mid)))
+	    {
+		/* this edge crosses the row's mid-line */
+		sl->cross[sl->n_cross++] =
+		    edge->x1 + ((y_mid - edge->y1) * (edge->x2 - edge->x1) /
+				(edge->y2 - edge->y1));
+	    }
+      }
+
+/* merging all overlapping dirty intervals */
+    if (sl->n_dirty > 1)
+      {
+	  qsort (sl->dirty, sl->n_dirty, sizeof (double) * 2,
+		 grid_cmp_intervals);
+	  j = 0;
+	  for (i = 1; i < sl->n_dirty; i++)
+	    {
+		if (sl->dirty[i * 2] <= sl->dirty[(j * 2) + 1])
+		  {
+		      if (sl->dirty[(i * 2) + 1] > sl->dirty[(j * 2) + 1])
+			  sl->dirty[(j * 2) + 1] = sl->dirty[(i * 2) + 1];
+		  }
+		else
+		  {
+		      j++;
+		      sl->dirty[j * 2] = sl->dirty[i * 2];
+		      sl->dirty[(j * 2) + 1] = sl->dirty[(i * 2) + 1];
+		  }
+	    }
+	  sl->n_dirty = j + 1;
+      }
+    if (sl->n_cross > 1)
+	qsort (sl->cross, sl->n_cross, sizeof (double), grid_cmp_doubles);
+}
+
+static int
+grid_scanline_cell (struct grid_scanline *sl, double min_x, double max_x)
+{
+/* classifying a cell [min_x, max_x] within the current row */
+    int lo;
+    int hi;
+    double mid_x;
+    if (sl == NULL)
+	return GRID_CELL_UNKNOWN;
+
+/* searching the first dirty interval ending after min_x */
+    lo = 0;
+    hi = sl->n_dirty;
+    while (lo < hi)
+      {
+	  int mid = (lo + hi) / 2;
+	  if (sl->dirty[(mid * 2) + 1] < min_x)
+	      lo = mid + 1;
+	  else
+	      hi = mid;
+      }
+    if (lo < sl->n_dirty && sl->dirty[lo * 2] <= max_x)
+	return GRID_CELL_UNKNOWN;
+
+/* counting the crossings on the left side */
+    mid_x = (min_x + max_x) / 2.0;
+    lo = 0;
+    hi = sl->n_cross;
+    while (lo < hi)
+      {
+	  int mid = (lo + hi) / 2;
+	  if (sl->cross[mid] < mid_x)
+	      lo = mid + 1;
+	  else
+	      hi = mid;
+      }
+    if (lo % 2)
+	return GRID_CELL_INSIDE;
+    return GRID_CELL_OUTSIDE;
+}
+
+static void
+grid_prepare (struct grid_prepared *gp, const void *p_cache,
+	      gaiaGeomCollPtr geom)
+{
+/* preparing the input geometry once for all */
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) p_cache;
+    gp->p_cache = p_cache;
+    gp->geom = geom;
+    gp->geos = NULL;
+    gp->prepared = NULL;
+    if (cache != NULL)
+      {
+	  GEOSContextHandle_t handle;
+	  if (cache->magic1 != SPATIALITE_CACHE_MAGIC1
+	      || cache->magic2 != SPATIALITE_CACHE_MAGIC2)
+	      return;
+	  handle = cache->GEOS_handle;
+	  if (handle == NULL)
+	      return;
+	  if (gaiaIsToxic_r (cache, geom))
+	      return;
+	  gp->geos = gaiaToGeos_r (cache, geom);
+	  if (gp->geos == NULL)
+	      return;
+	  gp->prepared = GEOSPrepare_r (handle, gp->geos);
+	  return;
+      }
+#ifndef GEOS_USE_ONLY_R_API	/* obsolete versions non fully thread-safe */
+    if (gaiaIsToxic (geom))
+	return;
+    gp->geos = gaiaToGeos (geom);
+    if (gp->geos == NULL)
+	return;
+    gp->prepared = GEOSPrepare (gp->geos);
+#endif
+}
+
+static void
+grid_prepared_cleanup (struct grid_prepared *gp)
+{
+/* memory cleanup - destroying the Prepared Geometry */
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) (gp->p_cache);
+    if (cache != NULL)
+      {
+	  GEOSContextHandle_t handle = cache->GEOS_handle;
+	  if (gp->prepared != NULL)
+	      GEOSPreparedGeom_destroy_r (handle, gp->prepared);
+	  if (gp->geos != NULL)
+	      GEOSGeom_destroy_r (handle, gp->geos);
+      }
+#ifndef GEOS_USE_ONLY_R_API	/* obsolete versions non fully thread-safe */
+    else
+      {
+	  if (gp->prepared != NULL)
+	      GEOSPreparedGeom_destroy (gp->prepared);
+	  if (gp->geos != NULL)
+	      GEOSGeom_destroy (gp->geos);
+      }
+#endif
+    gp->geos = NULL;
+    gp->prepared = NULL;
+}
+
+static int
+grid_cell_intersects (struct grid_prepared *gp, gaiaGeomCollPtr item)
+{
+/* checking a boundary cell against the Prepared Geometry */
+    GEOSGeometry *g;
+    int ret;
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) (gp->p_cache);
+    if (gp->prepared == NULL)
+      {
+	  /* fallback - unprepared evaluation */
+	  if (gp->p_cache != NULL)
+	      return gaiaGeomCollIntersects_r (gp->p_cache, gp->geom, item);
+	  return gaiaGeomCollIntersects (gp->geom, item);
+      }
+    if (cache != NULL)
+      {
+	  GEOSContextHandle_t handle = cache->GEOS_handle;
+	  g = gaiaToGeos_r (cache, item);
+	  ret = GEOSPreparedIntersects_r (handle, gp->prepared, g);
+	  GEOSGeom_destroy_r (handle, g);
+	  return ret;
+      }
+#ifndef GEOS_USE_ONLY_R_API	/* obsolete versions non fully thread-safe */
+    g = gaiaToGeos (item);
+    ret = GEOSPreparedIntersects (gp->prepared, g);
+    GEOSGeom_destroy (g);
+    return ret;
+#else
+    return -1;
+#endif
+}
+
 static gaiaGeomCollPtr
 gaiaSquareGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 		      double origin_x, double origin_y, double size, int mode)
@@ -788,6 +1270,8 @@ gaiaSquareGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
     gaiaGeomCollPtr result = NULL;
     gaiaGeomCollPtr item = NULL;
     int ret;
+    struct grid_scanline *sl;
+    struct grid_prepared gp;
 
     if (size <= 0.0)
 	return NULL;
@@ -796,6 +1280,8 @@ gaiaSquareGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
     result->Srid = geom->Srid;
     get_grid_bbox (geom, &min_x, &min_y, &max_x, &max_y);
     get_grid_base (min_x, min_y, origin_x, origin_y, size, &base_x, &base_y);
+    grid_prepare (&gp, p_cache, geom);
+    sl = grid_scanline_create (&gp);
     while (base_y < max_y)
       {
 	  /* looping on grid rows */
@@ -807,24 +1293,29 @@ gaiaSquareGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 	  y3 = y1 + size;
 	  x4 = x1;
 	  y4 = y3;
+	  if (sl != NULL)
+	      grid_scanline_row (sl, y1, y3);
 	  while (x1 < max_x)
 	    {
 		/* looping on grid columns */
-		item = gaiaAllocGeomColl ();
-
-		pg = gaiaAddPolygonToGeomColl (item, 5, 0);
-		rng = pg->Exterior;
-		gaiaSetPoint (rng->Coords, 0, x1, y1);
-		gaiaSetPoint (rng->Coords, 1, x2, y2);
-		gaiaSetPoint (rng->Coords, 2, x3, y3);
-		gaiaSetPoint (rng->Coords, 3, x4, y4);
-		gaiaSetPoint (rng->Coords, 4, x1, y1);
-
-		gaiaMbrGeometry (item);
-		if (p_cache != NULL)
-		    ret = gaiaGeomCollIntersects_r (p_cache, geom, item);
-		else
-		    ret = gaiaGeomCollIntersects (geom, item);
+		ret = grid_scanline_cell (sl, x1, x2);
+		if (ret == GRID_CELL_UNKNOWN)
+		  {
+		      /* boundary cell: checking by GEOS */
+		      item = gaiaAllocGeomColl ();
+
+		      pg = gaiaAddPolygonToGeomColl (item, 5, 0);
+		      rng = pg->Exterior;
+		      gaiaSetPoint (rng->Coords, 0, x1, y1);
+		      gaiaSetPoint (rng->Coords, 1, x2, y2);
+		      gaiaSetPoint (rng->Coords, 2, x3, y3);
+		      gaiaSetPoint (rng->Coords, 3, x4, y4);
+		      gaiaSetPoint (rng->Coords, 4, x1, y1);
+
+		      gaiaMbrGeometry (item);
+		      ret = grid_cell_intersects (&gp, item);
+		      gaiaFreeGeomColl (item);
+		  }
 		if (ret == 1)
 		  {
 		      /* ok, inserting a valid cell */
@@ -865,7 +1356,6 @@ gaiaSquareGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 			    gaiaSetPoint (rng->Coords, 4, x1, y1);
 			}
 		  }
-		gaiaFreeGeomColl (item);
 		x1 += size;
 		x2 += size;
 		x3 += size;
@@ -873,6 +1363,8 @@ gaiaSquareGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 	    }
 	  base_y += size;
       }
+    grid_scanline_destroy (sl);
+    grid_prepared_cleanup (&gp);
 
 /* final check */
     if (!count)
@@ -1016,6 +1508,8 @@ gaiaTriangularGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
     gaiaGeomCollPtr result = NULL;
     gaiaGeomCollPtr item = NULL;
     int ret;
+    struct grid_scanline *sl;
+    struct grid_prepared gp;
 
     if (size <= 0.0)
 	return NULL;
@@ -1030,6 +1524,8 @@ gaiaTriangularGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 		      shift_h_even, shift_v, &odd_even, &base_x, &base_y);
     base_x -= base_x;
     base_y -= shift_v;
+    grid_prepare (&gp, p_cache, geom);
+    sl = grid_scanline_create (&gp);
     while (base_y < max_y)
       {
 	  /* looping on grid rows */
@@ -1044,23 +1540,28 @@ gaiaTriangularGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 	  y3 = y1 + shift_v;
 	  x4 = x3 + shift_h_even;
 	  y4 = y3;
+	  if (sl != NULL)
+	      grid_scanline_row (sl, y1, y3);
 	  while (x1 < max_x)
 	    {
 		/* looping on grid columns */
-		item = gaiaAllocGeomColl ();
-
-		pg = gaiaAddPolygonToGeomColl (item, 4, 0);
-		rng = pg->Exterior;
-		gaiaSetPoint (rng->Coords, 0, x1, y1);
-		gaiaSetPoint (rng->Coords, 1, x2, y2);
-		gaiaSetPoint (rng->Coords, 2, x3, y3);
-		gaiaSetPoint (rng->Coords, 3, x1, y1);
-
-		gaiaMbrGeometry (item);
-		if (p_cache != NULL)
-		    ret = gaiaGeomCollIntersects_r (p_cache, geom, item);
-		else
-		    ret = gaiaGeomCollIntersects (geom, item);
+		ret = grid_scanline_cell (sl, x1, x2);
+		if (ret == GRID_CELL_UNKNOWN)
+		  {
+		      /* boundary cell: checking by GEOS */
+		      item = gaiaAllocGeomColl ();
+
+		      pg = gaiaAddPolygonToGeomColl (item, 4, 0);
+		      rng = pg->Exterior;
+		      gaiaSetPoint (rng->Coords, 0, x1, y1);
+		      gaiaSetPoint (rng->Coords, 1, x2, y2);
+		      gaiaSetPoint (rng->Coords, 2, x3, y3);
+		      gaiaSetPoint (rng->Coords, 3, x1, y1);
+
+		      gaiaMbrGeometry (item);
+		      ret = grid_cell_intersects (&gp, item);
+		      gaiaFreeGeomColl (item);
+		  }
 		if (ret == 1)
 		  {
 		      /* ok, inserting a valid cell [pointing upside] */
@@ -1096,22 +1597,24 @@ gaiaTriangularGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 			    gaiaSetPoint (rng->Coords, 3, x1, y1);
 			}
 		  }
-		gaiaFreeGeomColl (item);
-
-		item = gaiaAllocGeomColl ();
-
-		pg = gaiaAddPolygonToGeomColl (item, 4, 0);
-		rng = pg->Exterior;
-		gaiaSetPoint (rng->Coords, 0, x3, y3);
-		gaiaSetPoint (rng->Coords, 1, x2, y2);
-		gaiaSetPoint (rng->Coords, 2, x4, y4);
-		gaiaSetPoint (rng->Coords, 3, x3, y3);
 
-		gaiaMbrGeometry (item);
-		if (p_cache != NULL)
-		    ret = gaiaGeomCollIntersects_r (p_cache, geom, item);
-		else
-		    ret = gaiaGeomCollIntersects (geom, item);
+		ret = grid_scanline_cell (sl, x3, x4);
+		if (ret == GRID_CELL_UNKNOWN)
+		  {
+		      /* boundary cell: checking by GEOS */
+		      item = gaiaAllocGeomColl ();
+
+		      pg = gaiaAddPolygonToGeomColl (item, 4, 0);
+		      rng = pg->Exterior;
+		      gaiaSetPoint (rng->Coords, 0, x3, y3);
+		      gaiaSetPoint (rng->Coords, 1, x2, y2);
+		      gaiaSetPoint (rng->Coords, 2, x4, y4);
+		      gaiaSetPoint (rng->Coords, 3, x3, y3);
+
+		      gaiaMbrGeometry (item);
+		      ret = grid_cell_intersects (&gp, item);
+		      gaiaFreeGeomColl (item);
+		  }
 		if (ret == 1)
 		  {
 		      /* ok, inserting a valid cell [pointing downside] */
@@ -1147,7 +1650,6 @@ gaiaTriangularGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 			    gaiaSetPoint (rng->Coords, 3, x3, y3);
 			}
 		  }
-		gaiaFreeGeomColl (item);
 
 		x1 += shift_h_even;
 		x2 += shift_h_even;
@@ -1160,6 +1662,8 @@ gaiaTriangularGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 	  else
 	      odd_even = 1;
       }
+    grid_scanline_destroy (sl);
+    grid_prepared_cleanup (&gp);
 
 /* final check */
     if (!count)
@@ -1309,6 +1813,8 @@ gaiaHexagonalGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
     double shift3;
     double shift4;
     int ret;
+    struct grid_scanline *sl;
+    struct grid_prepared gp;
 
     if (size <= 0.0)
 	return NULL;
@@ -1324,6 +1830,8 @@ gaiaHexagonalGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 		      shift, &odd_even, &base_x, &base_y);
     base_x -= shift3;
     base_y -= shift;
+    grid_prepare (&gp, p_cache, geom);
+    sl = grid_scanline_create (&gp);
     while ((base_y - shift) < max_y)
       {
 	  /* looping on grid rows */
@@ -1342,26 +1850,31 @@ gaiaHexagonalGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 	  y5 = y1 + shift;
 	  x6 = x2;
 	  y6 = y5;
+	  if (sl != NULL)
+	      grid_scanline_row (sl, y2, y5);
 	  while (x1 < max_x)
 	    {
 		/* looping on grid columns */
-		item = gaiaAllocGeomColl ();
-
-		pg = gaiaAddPolygonToGeomColl (item, 7, 0);
-		rng = pg->Exterior;
-		gaiaSetPoint (rng->Coords, 0, x1, y1);
-		gaiaSetPoint (rng->Coords, 1, x2, y2);
-		gaiaSetPoint (rng->Coords, 2, x3, y3);
-		gaiaSetPoint (rng->Coords, 3, x4, y4);
-		gaiaSetPoint (rng->Coords, 4, x5, y5);
-		gaiaSetPoint (rng->Coords, 5, x6, y6);
-		gaiaSetPoint (rng->Coords, 6, x1, y1);
-
-		gaiaMbrGeometry (item);
-		if (p_cache != NULL)
-		    ret = gaiaGeomCollIntersects_r (p_cache, geom, item);
-		else
-		    ret = gaiaGeomCollIntersects (geom, item);
+		ret = grid_scanline_cell (sl, x1, x4);
+		if (ret == GRID_CELL_UNKNOWN)
+		  {
+		      /* boundary cell: checking by GEOS */
+		      item = gaiaAllocGeomColl ();
+
+		      pg = gaiaAddPolygonToGeomColl (item, 7, 0);
+		      rng = pg->Exterior;
+		      gaiaSetPoint (rng->Coords, 0, x1, y1);
+		      gaiaSetPoint (rng->Coords, 1, x2, y2);
+		      gaiaSetPoint (rng->Coords, 2, x3, y3);
+		      gaiaSetPoint (rng->Coords, 3, x4, y4);
+		      gaiaSetPoint (rng->Coords, 4, x5, y5);
+		      gaiaSetPoint (rng->Coords, 5, x6, y6);
+		      gaiaSetPoint (rng->Coords, 6, x1, y1);
+
+		      gaiaMbrGeometry (item);
+		      ret = grid_cell_intersects (&gp, item);
+		      gaiaFreeGeomColl (item);
+		  }
 		if (ret == 1)
 		  {
 		      /* ok, inserting a valid cell */
@@ -1412,7 +1925,6 @@ gaiaHexagonalGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 			    gaiaSetPoint (rng->Coords, 6, x1, y1);
 			}
 		  }
-		gaiaFreeGeomColl (item);
 
 		x1 += shift3;
 		x2 += shift3;
@@ -1427,6 +1939,8 @@ gaiaHexagonalGridCommon (const void *p_cache, gaiaGeomCollPtr geom,
 	  else
 	      odd_even = 1;
       }
+    grid_scanline_destroy (sl);
+    grid_prepared_cleanup (&gp);
 
 /* final check */
     if (!count)
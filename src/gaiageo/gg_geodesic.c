@@ -160,6 +160,33 @@ gaiaEllipseParams (const char *name, double *a, double *b, double *rf)
     return 0;
 }
 
+static double
+great_circle_arc (double latrad1, double coslat1, double lonrad1,
+		  double latrad2, double coslat2, double lonrad2)
+{
+/* 
+/ computing the great-circle arc (in radians) between two points
+/ sin/cos of both latitudes are expected to be already known,
+/ so to be evaluated just once for each vertex
+*/
+    double k1 = (sin ((latrad1 - latrad2) / 2.0));
+    double k2 = (sin ((lonrad1 - lonrad2) / 2.0));
+    double dist;
+    dist = 2.0 * asin (sqrt (k1 * k1 + coslat1 * coslat2 * k2 * k2));
+    if (dist < 0.0)
+	dist = dist + PI;
+    return dist;
+}
+
+static double
+great_circle_radius (double a, double b)
+{
+/* returning the average radius */
+    if (a == b)
+	return a;
+    return (2.0 * a + b) / 3.0;
+}
+
 GAIAGEO_DECLARE double
 gaiaGreatCircleDistance (double a, double b, double lat1, double lon1,
 			 double lat2, double lon2)
@@ -175,63 +202,111 @@ gaiaGreatCircleDistance (double a, double b, double lat1, double lon1,
     double lonrad1 = lon1 * DEG2RAD;
     double latrad2 = lat2 * DEG2RAD;
     double lonrad2 = lon2 * DEG2RAD;
-    double avg_radius;
-    double k1 = (sin ((latrad1 - latrad2) / 2.0));
-    double k2 = (sin ((lonrad1 - lonrad2) / 2.0));
-    double dist;
-    dist =
-	2.0 * asin (sqrt (k1 * k1 + cos (latrad1) * cos (latrad2) * k2 * k2));
-    if (dist < 0.0)
-	dist = dist + PI;
-    if (a == b)
-	avg_radius = a;
-    else
-	avg_radius = (2.0 * a + b) / 3.0;
-    dist = dist * avg_radius;
-    return dist;
+    double dist = great_circle_arc (latrad1, cos (latrad1), lonrad1, latrad2,
+				    cos (latrad2), lonrad2);
+    return dist * great_circle_radius (a, b);
 }
 
-GAIAGEO_DECLARE double
-gaiaGeodesicDistance (double a, double b, double rf, double lat1, double lon1,
-		      double lat2, double lon2)
+/* number of vertices processed by a single batch */
+#define GEODESIC_CHUNK	256
+
+struct great_circle_vertices
 {
-/*
-/ Calculate geodesic distance (in m) 
-/ between two points specified by latitude/longitude 
-/ (in decimal degrees) 
+/* a chunk of vertices and their trigonometric terms */
+    int count;
+    double latrad[GEODESIC_CHUNK + 1];
+    double lonrad[GEODESIC_CHUNK + 1];
+    double coslat[GEODESIC_CHUNK + 1];
+};
+
+static void
+great_circle_prepare (struct great_circle_vertices *v, int first)
+{
+/* 
+/ converting all vertices from degrees to radians, 
+/ and then evaluating cos(lat) just once for each vertex
 */
+    int i;
+    for (i = first; i < v->count; i++)
+      {
+	  v->latrad[i] *= DEG2RAD;
+	  v->lonrad[i] *= DEG2RAD;
+	  v->coslat[i] = cos (v->latrad[i]);
+      }
+}
 
-#if PROJ_GEODESIC
+static void
+great_circle_kernel (double avg_radius, const struct great_circle_vertices *v1,
+		     int off1, const struct great_circle_vertices *v2,
+		     int off2, int count, double *dist)
+{
+/* computing the great-circle distances between two sets of vertices */
+    int i;
+    for (i = 0; i < count; i++)
+      {
+	  int i1 = off1 + i;
+	  int i2 = off2 + i;
+	  dist[i] =
+	      great_circle_arc (v1->latrad[i1], v1->coslat[i1], v1->lonrad[i1],
+				v2->latrad[i2], v2->coslat[i2],
+				v2->lonrad[i2]) * avg_radius;
+      }
+}
+
+GAIAGEO_DECLARE void
+gaiaGreatCircleDistances (double a, double b, int count, const double *lat1,
+			  const double *lon1, const double *lat2,
+			  const double *lon2, double *dist)
+{
 /*
-/ using the PROJ.4 own implementation
-/
-/ requires PROJ.4 >= 4.9.0
-/
-/ (accepting a patch suggested by Charles Karney <charles@karney.com>
+/ Calculate great-circle distances (in m) for an array of
+/ point pairs specified by latitude/longitude (in decimal degrees)
 */
-    double s12;
-    struct geod_geodesic gd;
-    if (b == a)
-	b = a;			/* silencing stupid compiler warnings */
-    geod_init (&gd, a, 1 / rf);
-    geod_inverse (&gd, lat1, lon1, lat2, lon2, &s12, 0, 0);
-    return s12;
-#else
+    int base;
+    int n;
+    double avg_radius = great_circle_radius (a, b);
+    struct great_circle_vertices v1;
+    struct great_circle_vertices v2;
+    for (base = 0; base < count; base += GEODESIC_CHUNK)
+      {
+	  n = count - base;
+	  if (n > GEODESIC_CHUNK)
+	      n = GEODESIC_CHUNK;
+	  memcpy (v1.latrad, lat1 + base, sizeof (double) * n);
+	  memcpy (v1.lonrad, lon1 + base, sizeof (double) * n);
+	  memcpy (v2.latrad, lat2 + base, sizeof (double) * n);
+	  memcpy (v2.lonrad, lon2 + base, sizeof (double) * n);
+	  v1.count = n;
+	  v2.count = n;
+	  great_circle_prepare (&v1, 0);
+	  great_circle_prepare (&v2, 0);
+	  great_circle_kernel (avg_radius, &v1, 0, &v2, 0, n, dist + base);
+      }
+}
+
+#if !PROJ_GEODESIC
+static void
+vincenty_reduced_latitude (double f, double lat, double *sinU, double *cosU)
+{
+/* computing the reduced latitude (sin and cos) for some point */
+    double U = atan ((1.0 - f) * tan (lat * DEG2RAD));
+    *sinU = sin (U);
+    *cosU = cos (U);
+}
+
+static double
+vincenty_distance (double a, double b, double f, double sinU1, double cosU1,
+		   double sinU2, double cosU2, double L)
+{
 /*
 / using Vincenty inverse formula for ellipsoids
 /
 / based on original JavaScript by (c) Chris Veness 2002-2008 
 / http://www.movable-type.co.uk/scripts/latlong-vincenty.html
 /
+/ the reduced latitudes of both points are expected to be
+/ already known, so to be evaluated just once for each vertex
 */
-    double f = 1.0 / rf;
-    double L = (lon2 - lon1) * DEG2RAD;
-    double U1 = atan ((1.0 - f) * tan (lat1 * DEG2RAD));
-    double U2 = atan ((1.0 - f) * tan (lat2 * DEG2RAD));
-    double sinU1 = sin (U1);
-    double cosU1 = cos (U1);
-    double sinU2 = sin (U2);
-    double cosU2 = cos (U2);
     double lambda = L;
     double lambdaP;
     double sinLambda;
@@ -298,9 +373,182 @@ gaiaGeodesicDistance (double a, double b, double rf, double lat1, double lon1,
 									cos2SigmaM)));
     s = b * A * (sigma - deltaSigma);
     return s;
+}
+#endif
+
+GAIAGEO_DECLARE double
+gaiaGeodesicDistance (double a, double b, double rf, double lat1, double lon1,
+		      double lat2, double lon2)
+{
+/*
+/ Calculate geodesic distance (in m) 
+/ between two points specified by latitude/longitude 
+/ (in decimal degrees) 
+/ a negative distance is returned on failure
+*/
+
+#if PROJ_GEODESIC
+/*
+/ using the PROJ.4 own implementation
+/
+/ requires PROJ.4 >= 4.9.0
+/
+/ (accepting a patch suggested by Charles Karney <charles@karney.com>
+*/
+    double s12;
+    struct geod_geodesic gd;
+    if (b == a)
+	b = a;			/* silencing stupid compiler warnings */
+    geod_init (&gd, a, 1 / rf);
+    geod_inverse (&gd, lat1, lon1, lat2, lon2, &s12, 0, 0);
+    if (isnan (s12))
+	return -1.0;		/* PROJ.4 failure */
+    return s12;
+#else
+/* using Vincenty inverse formula for ellipsoids */
+    double f = 1.0 / rf;
+    double sinU1;
+    double cosU1;
+    double sinU2;
+    double cosU2;
+    double s;
+    vincenty_reduced_latitude (f, lat1, &sinU1, &cosU1);
+    vincenty_reduced_latitude (f, lat2, &sinU2, &cosU2);
+    s = vincenty_distance (a, b, f, sinU1, cosU1, sinU2, cosU2,
+			   (lon2 - lon1) * DEG2RAD);
+    if (isnan (s))
+	return -1.0;		/* invalid coordinates */
+    return s;
 #endif /* end Vincenty formula */
 }
 
+struct geodesic_ellipsoid
+{
+/* the Ellipsoid, initialized just once for a whole batch */
+#if PROJ_GEODESIC
+    struct geod_geodesic gd;
+#else
+    double a;
+    double b;
+    double f;
+#endif
+};
+
+struct geodesic_vertices
+{
+/* a chunk of vertices and their precomputed terms */
+    int count;
+    double lat[GEODESIC_CHUNK + 1];
+    double lon[GEODESIC_CHUNK + 1];
+#if !PROJ_GEODESIC
+    double sinU[GEODESIC_CHUNK + 1];
+    double cosU[GEODESIC_CHUNK + 1];
+#endif
+};
+
+static void
+geodesic_init (struct geodesic_ellipsoid *ellps, double a, double b,
+	       double rf)
+{
+/* initializing the Ellipsoid */
+#if PROJ_GEODESIC
+    if (b == a)
+	b = a;			/* silencing stupid compiler warnings */
+    geod_init (&(ellps->gd), a, 1 / rf);
+#else
+    ellps->a = a;
+    ellps->b = b;
+    ellps->f = 1.0 / rf;
+#endif
+}
+
+static void
+geodesic_prepare (const struct geodesic_ellipsoid *ellps,
+		  struct geodesic_vertices *v, int first)
+{
+/* evaluating the reduced latitude just once for each vertex */
+#if PROJ_GEODESIC
+    if (ellps == NULL || v == NULL || first)
+	first = 0;		/* nothing to be precomputed */
+#else
+    int i;
+    for (i = first; i < v->count; i++)
+	vincenty_reduced_latitude (ellps->f, v->lat[i], v->sinU + i,
+				   v->cosU + i);
+#endif
+}
+
+static int
+geodesic_kernel (const struct geodesic_ellipsoid *ellps,
+		 const struct geodesic_vertices *v1, int off1,
+		 const struct geodesic_vertices *v2, int off2, int count,
+		 double *dist)
+{
+/* 
+/ computing the geodesic distances between two sets of vertices
+/ returns 0 if any distance is invalid (set to -1.0)
+*/
+    int i;
+    int ok = 1;
+    for (i = 0; i < count; i++)
+      {
+	  int i1 = off1 + i;
+	  int i2 = off2 + i;
+#if PROJ_GEODESIC
+	  geod_inverse (&(ellps->gd), v1->lat[i1], v1->lon[i1], v2->lat[i2],
+			v2->lon[i2], dist + i, 0, 0);
+#else
+	  dist[i] =
+	      vincenty_distance (ellps->a, ellps->b, ellps->f, v1->sinU[i1],
+				 v1->cosU[i1], v2->sinU[i2], v2->cosU[i2],
+				 (v2->lon[i2] - v1->lon[i1]) * DEG2RAD);
+#endif
+	  if (isnan (dist[i]) || dist[i] < 0.0)
+	    {
+		/* failure: NaN or formula not converging */
+		dist[i] = -1.0;
+		ok = 0;
+	    }
+      }
+    return ok;
+}
+
+GAIAGEO_DECLARE int
+gaiaGeodesicDistances (double a, double b, double rf, int count,
+		       const double *lat1, const double *lon1,
+		       const double *lat2, const double *lon2, double *dist)
+{
+/*
+/ Calculate geodesic distances (in m) for an array of
+/ point pairs specified by latitude/longitude (in decimal degrees)
+/ the ellipsoid is initialized just once for the whole array
+*/
+    int base;
+    int n;
+    int ok = 1;
+    struct geodesic_ellipsoid ellps;
+    struct geodesic_vertices v1;
+    struct geodesic_vertices v2;
+    geodesic_init (&ellps, a, b, rf);
+    for (base = 0; base < count; base += GEODESIC_CHUNK)
+      {
+	  n = count - base;
+	  if (n > GEODESIC_CHUNK)
+	      n = GEODESIC_CHUNK;
+	  memcpy (v1.lat, lat1 + base, sizeof (double) * n);
+	  memcpy (v1.lon, lon1 + base, sizeof (double) * n);
+	  memcpy (v2.lat, lat2 + base, sizeof (double) * n);
+	  memcpy (v2.lon, lon2 + base, sizeof (double) * n);
+	  v1.count = n;
+	  v2.count = n;
+	  geodesic_prepare (&ellps, &v1, 0);
+	  geodesic_prepare (&ellps, &v2, 0);
+	  if (!geodesic_kernel (&ellps, &v1, 0, &v2, 0, n, dist + base))
+	      ok = 0;
+      }
+    return ok;
+}
+
 GAIAGEO_DECLARE void
 gaiaFree (void *ptr)
 {
@@ -310,41 +558,67 @@ gaiaFree (void *ptr)
     free (ptr);
 }
 
+static void
+geodesic_get_xy (int dims, double *coords, int iv, double *x, double *y)
+{
+/* fetching X and Y from a COORD mem-array */
+    double z;
+    double m;
+    if (dims == GAIA_XY_Z)
+      {
+	  gaiaGetPointXYZ (coords, iv, x, y, &z);
+      }
+    else if (dims == GAIA_XY_M)
+      {
+	  gaiaGetPointXYM (coords, iv, x, y, &m);
+      }
+    else if (dims == GAIA_XY_Z_M)
+      {
+	  gaiaGetPointXYZM (coords, iv, x, y, &z, &m);
+      }
+    else
+      {
+	  gaiaGetPoint (coords, iv, x, y);
+      }
+}
+
 GAIAGEO_DECLARE double
 gaiaGreatCircleTotalLength (double a, double b, int dims, double *coords,
 			    int vert)
 {
-/* computing the GreatCircle total length for some Linestring/Ring */
-    int iv;
-    double x1 = 0.0;
-    double y1 = 0.0;
-    double x2;
-    double y2;
-    double z;
-    double m;
+/* 
+/ computing the GreatCircle total length for some Linestring/Ring 
+/ the vertices are processed by batches; each vertex is shared by
+/ two consecutive segments, so its trigonometric terms are 
+/ evaluated just once
+*/
+    int iv = 0;
+    int first = 0;
+    int i;
+    double avg_radius = great_circle_radius (a, b);
     double len = 0.0;
-    for (iv = 0; iv < vert; iv++)
+    double dist[GEODESIC_CHUNK];
+    struct great_circle_vertices v;
+    v.count = 0;
+    while (iv < vert)
       {
-	  if (dims == GAIA_XY_Z)
-	    {
-		gaiaGetPointXYZ (coords, iv, &x2, &y2, &z);
-	    }
-	  else if (dims == GAIA_XY_M)
+	  while (iv < vert && v.count <= GEODESIC_CHUNK)
 	    {
-		gaiaGetPointXYM (coords, iv, &x2, &y2, &m);
+		geodesic_get_xy (dims, coords, iv, v.lonrad + v.count,
+				 v.latrad + v.count);
+		v.count += 1;
+		iv++;
 	    }
-	  else if (dims == GAIA_XY_Z_M)
-	    {
-		gaiaGetPointXYZM (coords, iv, &x2, &y2, &z, &m);
-	    }
-	  else
-	    {
-		gaiaGetPoint (coords, iv, &x2, &y2);
-	    }
-	  if (iv > 0)
-	      len += gaiaGreatCircleDistance (a, b, y1, x1, y2, x2);
-	  x1 = x2;
-	  y1 = y2;
+	  great_circle_prepare (&v, first);
+	  great_circle_kernel (avg_radius, &v, 0, &v, 1, v.count - 1, dist);
+	  for (i = 0; i < v.count - 1; i++)
+	      len += dist[i];
+	  /* the last vertex will start the next batch */
+	  v.latrad[0] = v.latrad[v.count - 1];
+	  v.lonrad[0] = v.lonrad[v.count - 1];
+	  v.coslat[0] = v.coslat[v.count - 1];
+	  v.count = 1;
+	  first = 1;
       }
     return len;
 }
@@ -353,43 +627,45 @@ GAIAGEO_DECLARE double
 gaiaGeodesicTotalLength (double a, double b, double rf, int dims,
 			 double *coords, int vert)
 {
-/* computing the Geodesic total length for some Linestring/Ring */
-    int iv;
-    double x1 = 0.0;
-    double y1 = 0.0;
-    double x2;
-    double y2;
-    double z;
-    double m;
-    double l;
+/* 
+/ computing the Geodesic total length for some Linestring/Ring
+/ the ellipsoid is initialized just once for the whole 
+/ Linestring/Ring, and each reduced latitude is evaluated
+/ just once for each vertex
+/ a negative length is returned on failure
+*/
+    int iv = 0;
+    int first = 0;
+    int i;
     double len = 0.0;
-    for (iv = 0; iv < vert; iv++)
+    double dist[GEODESIC_CHUNK];
+    struct geodesic_ellipsoid ellps;
+    struct geodesic_vertices v;
+    geodesic_init (&ellps, a, b, rf);
+    v.count = 0;
+    while (iv < vert)
       {
-	  if (dims == GAIA_XY_Z)
-	    {
-		gaiaGetPointXYZ (coords, iv, &x2, &y2, &z);
-	    }
-	  else if (dims == GAIA_XY_M)
-	    {
-		gaiaGetPointXYM (coords, iv, &x2, &y2, &m);
-	    }
-	  else if (dims == GAIA_XY_Z_M)
+	  while (iv < vert && v.count <= GEODESIC_CHUNK)
 	    {
-		gaiaGetPointXYZM (coords, iv, &x2, &y2, &z, &m);
+		geodesic_get_xy (dims, coords, iv, v.lon + v.count,
+				 v.lat + v.count);
+		v.count += 1;
+		iv++;
 	    }
-	  else
-	    {
-		gaiaGetPoint (coords, iv, &x2, &y2);
-	    }
-	  if (iv > 0)
-	    {
-		l = gaiaGeodesicDistance (a, b, rf, y1, x1, y2, x2);
-		if (l < 0.0)
-		    return -1.0;
-		len += l;
-	    }
-	  x1 = x2;
-	  y1 = y2;
+	  geodesic_prepare (&ellps, &v, first);
+	  if (!geodesic_kernel (&ellps, &v, 0, &v, 1, v.count - 1, dist))
+	      return -1.0;
+	  for (i = 0; i < v.count - 1; i++)
+	      len += dist[i];
+	  /* the last vertex will start the next batch */
+	  v.lat[0] = v.lat[v.count - 1];
+	  v.lon[0] = v.lon[v.count - 1];
+#if !PROJ_GEODESIC
+	  v.sinU[0] = v.sinU[v.count - 1];
+	  v.cosU[0] = v.cosU[v.count - 1];
+#endif
+	  v.count = 1;
+	  first = 1;
       }
     return len;
 }
@@ -3894,6 +3894,256 @@ gaiaParseGml_r (const void *p_cache, const unsigned char *dirty_buffer,
     return gaiaParseGmlCommon (p_cache, dirty_buffer, sqlite_handle);
 }
 
+/*
+** a GML tree directly built from an already parsed XML document
+** (so to avoid serializing it to text and then lexing it again)
+*/
+
+struct gml_tree
+{
+/* a GML tree under construction */
+    int error;
+    gmlNodePtr first;
+    gmlNodePtr last;
+};
+
+static char *
+gml_tree_keyword (const char *prefix, const char *name)
+{
+/* building a Tag or Key exactly as the GML lexer would accept it */
+    int len;
+    char *keyword;
+    const char *p;
+    if (name == NULL)
+	return NULL;
+    len = strlen (name);
+    if (prefix != NULL)
+	len += strlen (prefix) + 1;
+    keyword = malloc (len + 1);
+    if (prefix != NULL)
+	sprintf (keyword, "%s:%s", prefix, name);
+    else
+	strcpy (keyword, name);
+    p = keyword;
+    if (!((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_'))
+	goto invalid;
+    for (p = keyword + 1; *p != '\0'; p++)
+      {
+	  if ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z')
+	      || (*p >= '0' && *p <= '9') || *p == '_' || *p == ':')
+	      continue;
+	  goto invalid;
+      }
+    return keyword;
+  invalid:
+    free (keyword);
+    return NULL;
+}
+
+static int
+gml_tree_is_coord (char c)
+{
+/* checking for a char allowed within a GML coordinate token */
+    if ((c >= '0' && c <= '9') || c == 'E' || c == 'e' || c == ','
+	|| c == '.' || c == '+' || c == '-')
+	return 1;
+    return 0;
+}
+
+SPATIALITE_PRIVATE void *
+gaia_gml_tree_alloc (void)
+{
+/* allocating an empty GML tree */
+    struct gml_tree *tree = malloc (sizeof (struct gml_tree));
+    tree->error = 0;
+    tree->first = NULL;
+    tree->last = NULL;
+    return tree;
+}
+
+SPATIALITE_PRIVATE void
+gaia_gml_tree_free (void *p_tree)
+{
+/* destroying a GML tree */
+    gmlNodePtr n;
+    gmlNodePtr nn;
+    struct gml_tree *tree = (struct gml_tree *) p_tree;
+    if (tree == NULL)
+	return;
+    n = tree->first;
+    while (n)
+      {
+	  nn = n->Next;
+	  gml_free_node (n);
+	  n = nn;
+      }
+    free (tree);
+}
+
+static void
+gml_tree_append (struct gml_tree *tree, const char *prefix, const char *name,
+		 int type)
+{
+/* appending a further node into the GML tree */
+    gmlNodePtr n;
+    char *tag = gml_tree_keyword (prefix, name);
+    if (tag == NULL)
+      {
+	  tree->error = 1;
+	  return;
+      }
+    n = malloc (sizeof (gmlNode));
+    n->Tag = tag;
+    n->Type = type;
+    n->Error = 0;
+    n->Attributes = NULL;
+    n->Coordinates = NULL;
+    n->Next = NULL;
+    if (tree->first == NULL)
+	tree->first = n;
+    if (tree->last != NULL)
+	tree->last->Next = n;
+    tree->last = n;
+}
+
+SPATIALITE_PRIVATE void
+gaia_gml_tree_open_tag (void *p_tree, const char *prefix, const char *name,
+			int self_closed)
+{
+/* opening a GML tag */
+    struct gml_tree *tree = (struct gml_tree *) p_tree;
+    if (tree == NULL || tree->error)
+	return;
+    gml_tree_append (tree, prefix, name,
+		     self_closed ? GML_PARSER_SELF_CLOSED_NODE :
+		     GML_PARSER_OPEN_NODE);
+}
+
+SPATIALITE_PRIVATE void
+gaia_gml_tree_close_tag (void *p_tree, const char *prefix, const char *name)
+{
+/* closing a GML tag */
+    struct gml_tree *tree = (struct gml_tree *) p_tree;
+    if (tree == NULL || tree->error)
+	return;
+    gml_tree_append (tree, prefix, name, GML_PARSER_CLOSED_NODE);
+}
+
+SPATIALITE_PRIVATE void
+gaia_gml_tree_add_attribute (void *p_tree, const char *prefix,
+			     const char *name, const char *value)
+{
+/* adding an attribute to the currently open GML tag */
+    gmlAttrPtr a;
+    gmlAttrPtr last;
+    char *key;
+    struct gml_tree *tree = (struct gml_tree *) p_tree;
+    if (tree == NULL || tree->error)
+	return;
+    if (tree->last == NULL || tree->last->Type == GML_PARSER_CLOSED_NODE)
+      {
+	  tree->error = 1;
+	  return;
+      }
+    key = gml_tree_keyword (prefix, name);
+    if (key == NULL)
+      {
+	  tree->error = 1;
+	  return;
+      }
+    if (value == NULL)
+	value = "";
+    a = malloc (sizeof (gmlAttr));
+    a->Key = key;
+    a->Value = malloc (strlen (value) + 1);
+    strcpy (a->Value, value);
+    a->Next = NULL;
+    last = tree->last->Attributes;
+    while (last != NULL && last->Next != NULL)
+	last = last->Next;
+    if (last == NULL)
+	tree->last->Attributes = a;
+    else
+	last->Next = a;
+}
+
+SPATIALITE_PRIVATE void
+gaia_gml_tree_add_coords (void *p_tree, const char *text)
+{
+/* splitting a text string into GML coordinate tokens */
+    gmlCoordPtr c;
+    gmlCoordPtr last;
+    const char *p = text;
+    const char *start;
+    int len;
+    struct gml_tree *tree = (struct gml_tree *) p_tree;
+    if (tree == NULL || tree->error || text == NULL)
+	return;
+    if (tree->last == NULL || tree->last->Type != GML_PARSER_OPEN_NODE)
+      {
+	  tree->error = 1;
+	  return;
+      }
+    last = tree->last->Coordinates;
+    while (last != NULL && last->Next != NULL)
+	last = last->Next;
+    while (1)
+      {
+	  while (*p == ' ' || *p == '\t' || *p == '\n')
+	      p++;
+	  if (*p == '\0')
+	      break;
+	  start = p;
+	  while (gml_tree_is_coord (*p))
+	      p++;
+	  if (p == start
+	      || !(*p == ' ' || *p == '\t' || *p == '\n' || *p == '\0'))
+	    {
+		/* not a valid coordinate token */
+		tree->error = 1;
+		return;
+	    }
+	  len = p - start;
+	  c = malloc (sizeof (gmlCoord));
+	  c->Value = malloc (len + 1);
+	  memcpy (c->Value, start, len);
+	  *(c->Value + len) = '\0';
+	  c->Next = NULL;
+	  if (last == NULL)
+	      tree->last->Coordinates = c;
+	  else
+	      last->Next = c;
+	  last = c;
+      }
+}
+
+SPATIALITE_PRIVATE void *
+gaia_gml_tree_geometry (const void *p_cache, void *p_tree,
+			const void *sqlite_handle)
+{
+/* attempting to build a geometry from a GML tree */
+    gaiaGeomCollPtr geom;
+    struct gml_data str_data;
+    struct gml_tree *tree = (struct gml_tree *) p_tree;
+    if (tree == NULL || tree->error || tree->first == NULL)
+	return NULL;
+
+/* initializing the helper struct */
+    str_data.gml_line = 1;
+    str_data.gml_col = 1;
+    str_data.gml_parse_error = 0;
+    str_data.gml_first_dyn_block = NULL;
+    str_data.gml_last_dyn_block = NULL;
+    str_data.result = NULL;
+    str_data.GmlLval.pval = NULL;
+
+    geom =
+	gml_build_geometry (p_cache, &str_data, tree->first,
+			    (sqlite3 *) sqlite_handle);
+    gmlCleanMapDynAlloc (&str_data, 0);
+    return geom;
+}
+
 
 /*
 ** CAVEAT: we must now undefine any Lemon/Flex own macro
@@ -47,6 +47,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <float.h>
 
 #if defined(_WIN32) && !defined(__MINGW32__)
@@ -65,15 +66,61 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #endif
 
 #include <spatialite_private.h>
+#include <splite_thread.h>
 #include <spatialite/sqlite.h>
 
 #include <spatialite/gaiageo.h>
+#include <spatialite.h>
 
 /* GLOBAL variables */
 char *gaia_geos_error_msg = NULL;
 char *gaia_geos_warning_msg = NULL;
 char *gaia_geosaux_error_msg = NULL;
 
+struct splite_pip_index
+{
+/* 
+/ native Point-in-Polygon edge index
+/
+/ all edges of a (Multi)Polygon are bucketed into horizontal bands
+/ of equal height; an edge spanning many bands will be duplicated
+/ into each one of them, so that every band simply is a contiguous
+/ run of edge coordinates (arranged as separate arrays so to allow
+/ the compiler to vectorize the crossing-number loop)
+*/
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    double band_height;
+    int n_bands;
+    int *band_start;
+    double *x1;
+    double *y1;
+    double *x2;
+    double *y2;
+};
+
+static void
+splite_free_pip_index (void *p)
+{
+/* memory cleanup - destroying a Point-in-Polygon edge index */
+    struct splite_pip_index *idx = (struct splite_pip_index *) p;
+    if (idx == NULL)
+	return;
+    if (idx->band_start != NULL)
+	free (idx->band_start);
+    if (idx->x1 != NULL)
+	free (idx->x1);
+    if (idx->y1 != NULL)
+	free (idx->y1);
+    if (idx->x2 != NULL)
+	free (idx->x2);
+    if (idx->y2 != NULL)
+	free (idx->y2);
+    free (idx);
+}
+
 SPATIALITE_PRIVATE void
 splite_free_geos_cache_item (struct splite_geos_cache_item *p)
 {
@@ -85,8 +132,10 @@ splite_free_geos_cache_item (struct splite_geos_cache_item *p)
 	GEOSGeom_destroy (p->geosGeom);
 #endif
 #endif
+    splite_free_pip_index (p->pipIndex);
     p->geosGeom = NULL;
     p->preparedGeosGeom = NULL;
+    p->pipIndex = NULL;
 }
 
 SPATIALITE_PRIVATE void
@@ -119,8 +168,10 @@ splite_free_geos_cache_item_r (const void *p_cache,
     if (p->geosGeom)
 	GEOSGeom_destroy_r (handle, p->geosGeom);
 #endif
+    splite_free_pip_index (p->pipIndex);
     p->geosGeom = NULL;
     p->preparedGeosGeom = NULL;
+    p->pipIndex = NULL;
 }
 
 GAIAGEO_DECLARE void
@@ -468,8 +519,10 @@ evalGeosCache (struct splite_internal_cache *cache, gaiaGeomCollPtr geom1,
 	GEOSPreparedGeom_destroy_r (handle, p1->preparedGeosGeom);
     if (p1->geosGeom)
 	GEOSGeom_destroy_r (handle, p1->geosGeom);
+    splite_free_pip_index (p1->pipIndex);
     p1->geosGeom = NULL;
     p1->preparedGeosGeom = NULL;
+    p1->pipIndex = NULL;
 
 /* updating the GEOS cache item#2 */
     memcpy (p2->gaiaBlob, blob2, 46);
@@ -479,12 +532,754 @@ evalGeosCache (struct splite_internal_cache *cache, gaiaGeomCollPtr geom1,
 	GEOSPreparedGeom_destroy_r (handle, p2->preparedGeosGeom);
     if (p2->geosGeom)
 	GEOSGeom_destroy_r (handle, p2->geosGeom);
+    splite_free_pip_index (p2->pipIndex);
     p2->geosGeom = NULL;
     p2->preparedGeosGeom = NULL;
+    p2->pipIndex = NULL;
 
     return 0;
 }
 
+/* max number of bands supported by a Point-in-Polygon edge index */
+#define SPLITE_PIP_MAX_BANDS	4096
+
+/* 
+/ relative error bound for the orientation test: any result smaller
+/ than this will be considered as not reliable (Point on boundary)
+*/
+#define SPLITE_PIP_ERRBOUND	1.0e-12
+
+static int
+splite_is_single_point (gaiaGeomCollPtr geom)
+{
+/* checks if this Geometry is a single Point */
+    if (geom->FirstLinestring != NULL || geom->FirstPolygon != NULL)
+	return 0;
+    if (geom->FirstPoint == NULL || geom->FirstPoint != geom->LastPoint)
+	return 0;
+    return 1;
+}
+
+static int
+splite_is_polygonal (gaiaGeomCollPtr geom)
+{
+/* checks if this Geometry is a (Multi)Polygon */
+    if (geom->FirstPoint != NULL || geom->FirstLinestring != NULL)
+	return 0;
+    if (geom->FirstPolygon == NULL)
+	return 0;
+    return 1;
+}
+
+static void
+splite_pip_ring_vertex (gaiaRingPtr ring, int iv, double *x, double *y)
+{
+/* retrieving a Ring's vertex (XY only) */
+    double z;
+    double m;
+    if (ring->DimensionModel == GAIA_XY_Z)
+      {
+	  gaiaGetPointXYZ (ring->Coords, iv, x, y, &z);
+      }
+    else if (ring->DimensionModel == GAIA_XY_M)
+      {
+	  gaiaGetPointXYM (ring->Coords, iv, x, y, &m);
+      }
+    else if (ring->DimensionModel == GAIA_XY_Z_M)
+      {
+	  gaiaGetPointXYZM (ring->Coords, iv, x, y, &z, &m);
+      }
+    else
+      {
+	  gaiaGetPoint (ring->Coords, iv, x, y);
+      }
+}
+
+static void
+splite_pip_ring_bands (struct splite_pip_index *idx, gaiaRingPtr ring,
+		       int *counts, int *cursors)
+{
+/* 
+/ bucketing all edges of a Ring
+/
+/ if cursors is NULL the edges will be simply counted band by band,
+/ otherwise their coordinates will be stored into the index
+*/
+    int iv;
+    int ib;
+    int b0;
+    int b1;
+    double x0;
+    double y0;
+    double x;
+    double y;
+    splite_pip_ring_vertex (ring, 0, &x0, &y0);
+    for (iv = 1; iv < ring->Points; iv++)
+      {
+	  splite_pip_ring_vertex (ring, iv, &x, &y);
+	  if (idx->n_bands == 1)
+	    {
+		b0 = 0;
+		b1 = 0;
+	    }
+	  else
+	    {
+		b0 = (int) ((((y0 < y) ? y0 : y) - idx->miny) /
+			    idx->band_height);
+		b1 = (int) ((((y0 > y) ? y0 : y) - idx->miny) /
+			    idx->band_height);
+		if (b0 >= idx->n_bands)
+		    b0 = idx->n_bands - 1;
+		if (b1 >= idx->n_bands)
+		    b1 = idx->n_bands - 1;
+	    }
+	  for (ib = b0; ib <= b1; ib++)
+	    {
+		if (cursors == NULL)
+		    *(counts + ib) += 1;
+		else
+		  {
+		      int pos = *(cursors + ib);
+		      *(idx->x1 + pos) = x0;
+		      *(idx->y1 + pos) = y0;
+		      *(idx->x2 + pos) = x;
+		      *(idx->y2 + pos) = y;
+		      *(cursors + ib) += 1;
+		  }
+	    }
+	  x0 = x;
+	  y0 = y;
+      }
+}
+
+static int
+splite_pip_count_bands (struct splite_pip_index *idx, gaiaGeomCollPtr geom,
+			int *counts)
+{
+/* counting the edges for each band; returns the total */
+    int ib;
+    int total = 0;
+    gaiaPolygonPtr pg;
+    for (ib = 0; ib < idx->n_bands; ib++)
+	*(counts + ib) = 0;
+    pg = geom->FirstPolygon;
+    while (pg)
+      {
+	  splite_pip_ring_bands (idx, pg->Exterior, counts, NULL);
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	      splite_pip_ring_bands (idx, pg->Interiors + ib, counts, NULL);
+	  pg = pg->Next;
+      }
+    for (ib = 0; ib < idx->n_bands; ib++)
+	total += *(counts + ib);
+    return total;
+}
+
+static struct splite_pip_index *
+splite_create_pip_index (gaiaGeomCollPtr geom)
+{
+/* creating a Point-in-Polygon edge index for a (Multi)Polygon */
+    int ib;
+    int n_edges = 0;
+    int total;
+    int *counts;
+    int *cursors;
+    gaiaPolygonPtr pg;
+    struct splite_pip_index *idx;
+
+    pg = geom->FirstPolygon;
+    while (pg)
+      {
+	  n_edges += pg->Exterior->Points - 1;
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	      n_edges += (pg->Interiors + ib)->Points - 1;
+	  pg = pg->Next;
+      }
+    if (n_edges <= 0)
+	return NULL;
+
+    idx = malloc (sizeof (struct splite_pip_index));
+    idx->minx = geom->MinX;
+    idx->miny = geom->MinY;
+    idx->maxx = geom->MaxX;
+    idx->maxy = geom->MaxY;
+    idx->band_start = NULL;
+    idx->x1 = NULL;
+    idx->y1 = NULL;
+    idx->x2 = NULL;
+    idx->y2 = NULL;
+
+/* 
+/ about 8 edges for each band; the number of bands will be then 
+/ progressively reduced if too many long edges get duplicated
+*/
+    idx->n_bands = n_edges / 8;
+    if (idx->n_bands < 1)
+	idx->n_bands = 1;
+    if (idx->n_bands > SPLITE_PIP_MAX_BANDS)
+	idx->n_bands = SPLITE_PIP_MAX_BANDS;
+    if (idx->maxy <= idx->miny)
+	idx->n_bands = 1;
+    counts = malloc (sizeof (int) * (idx->n_bands + 1));
+    while (1)
+      {
+	  idx->band_height = (idx->maxy - idx->miny) / idx->n_bands;
+	  total = splite_pip_count_bands (idx, geom, counts);
+	  if (idx->n_bands == 1 || total <= n_edges * 4)
+	      break;
+	  idx->n_bands /= 2;
+      }
+
+    idx->band_start = malloc (sizeof (int) * (idx->n_bands + 1));
+    cursors = malloc (sizeof (int) * idx->n_bands);
+    *(idx->band_start + 0) = 0;
+    for (ib = 0; ib < idx->n_bands; ib++)
+      {
+	  *(cursors + ib) = *(idx->band_start + ib);
+	  *(idx->band_start + ib + 1) =
+	      *(idx->band_start + ib) + *(counts + ib);
+      }
+    idx->x1 = malloc (sizeof (double) * total);
+    idx->y1 = malloc (sizeof (double) * total);
+    idx->x2 = malloc (sizeof (double) * total);
+    idx->y2 = malloc (sizeof (double) * total);
+    pg = geom->FirstPolygon;
+    while (pg)
+      {
+	  splite_pip_ring_bands (idx, pg->Exterior, counts, cursors);
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	      splite_pip_ring_bands (idx, pg->Interiors + ib, counts,
+				     cursors);
+	  pg = pg->Next;
+      }
+    free (counts);
+    free (cursors);
+    return idx;
+}
+
+static int
+splite_pip_test (struct splite_pip_index *idx, double x, double y)
+{
+/* 
+/ native Point-in-Polygon test (even-odd crossing number)
+/
+/ returns 1 if the Point is in the interior, 0 if it is in the 
+/ exterior, or -1 if it lies on (or very close to) the boundary
+*/
+    int ib;
+    int i;
+    int first;
+    int last;
+    int crossings = 0;
+    int uncertain = 0;
+    const double *x1 = idx->x1;
+    const double *y1 = idx->y1;
+    const double *x2 = idx->x2;
+    const double *y2 = idx->y2;
+
+    if (x < idx->minx || x > idx->maxx || y < idx->miny || y > idx->maxy)
+	return 0;
+    if (idx->n_bands == 1)
+	ib = 0;
+    else
+      {
+	  ib = (int) ((y - idx->miny) / idx->band_height);
+	  if (ib >= idx->n_bands)
+	      ib = idx->n_bands - 1;
+      }
+    first = *(idx->band_start + ib);
+    last = *(idx->band_start + ib + 1);
+
+/* 
+/ branch-free kernel: the side of the Point is given by the sign of
+/ the orientation test, that will be considered as uncertain when its
+/ magnitude falls within the error bound
+*/
+    for (i = first; i < last; i++)
+      {
+	  double dx = x2[i] - x1[i];
+	  double dy = y2[i] - y1[i];
+	  double ax = x - x1[i];
+	  double ay = y - y1[i];
+	  double left = dx * ay;
+	  double right = dy * ax;
+	  double cross = left - right;
+	  double bound =
+	      SPLITE_PIP_ERRBOUND * (fabs (left) + fabs (right));
+	  int up = (y1[i] <= y) & (y2[i] > y);
+	  int down = (y2[i] <= y) & (y1[i] > y);
+	  int in_range = ((y1[i] <= y) | (y2[i] <= y))
+	      & ((y1[i] >= y) | (y2[i] >= y));
+	  crossings += (up & (cross > bound)) | (down & (cross < -bound));
+	  uncertain |= in_range & (fabs (cross) <= bound);
+      }
+    if (uncertain)
+	return -1;
+    return crossings & 1;
+}
+
+static int
+evalPipCache (struct splite_internal_cache *cache, gaiaGeomCollPtr point,
+	      gaiaGeomCollPtr polyg, unsigned char *blob, int size)
+{
+/* 
+/ attempting to evaluate a Point-in-Polygon test by using a cached
+/ edge index; the Polygon is expected to match an item of the
+/ internal GEOS cache (i.e. it was already seen by the previous call)
+/
+/ returns 1 (interior), 0 (exterior) or -1 (undecided: GEOS required)
+*/
+    struct splite_geos_cache_item *p = NULL;
+    uLong crc = crc32 (0L, blob, size);
+    if (evalGeosCacheItem (blob, size, crc, &(cache->cacheItem1)))
+	p = &(cache->cacheItem1);
+    else if (evalGeosCacheItem (blob, size, crc, &(cache->cacheItem2)))
+	p = &(cache->cacheItem2);
+    if (p == NULL)
+	return -1;
+    if (p->pipIndex == NULL)
+	p->pipIndex = splite_create_pip_index (polyg);
+    if (p->pipIndex == NULL)
+	return -1;
+    return splite_pip_test ((struct splite_pip_index *) (p->pipIndex),
+			    point->FirstPoint->X, point->FirstPoint->Y);
+}
+
+#define SPLITE_PIPJOIN_MAX_CELLS	1024
+#define SPLITE_PIPJOIN_MAX_THREADS	64
+#define SPLITE_PIPJOIN_CHUNK		4096
+
+struct splite_pip_join
+{
+/* 
+/ a Point-in-Polygon join index
+/
+/ all Polygons are bucketed into a regular grid accordingly to their
+/ MBRs, and each one of them gets its own edge index
+*/
+    gaiaGeomCollPtr *polygons;
+    struct splite_pip_index **indexes;
+    int count;
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    int nx;
+    int ny;
+    double cell_width;
+    double cell_height;
+    int *cell_start;
+    int *cell_items;
+};
+
+struct pipjoin_chunk
+{
+/* a chunk of Points to be joined */
+    int first;
+    int last;
+    int *pairs;
+    int n_pairs;
+    int max_pairs;
+};
+
+struct pipjoin_pool
+{
+/* a struct wrapping all Point chunks */
+    struct splite_pip_join *join;
+    const double *x;
+    const double *y;
+    struct pipjoin_chunk *chunks;
+    int count;
+    int next_chunk;
+    splite_mutex_t mutex;
+};
+
+struct pipjoin_worker
+{
+/* a struct wrapping a single worker thread */
+    struct pipjoin_pool *pool;
+    const void *cache;
+};
+
+static void
+pipjoin_cell_range (struct splite_pip_join *join, double min, double max,
+		    int vertical, int *first, int *last)
+{
+/* computing the range of grid cells covered by some interval */
+    int n = (vertical) ? join->ny : join->nx;
+    double origin = (vertical) ? join->miny : join->minx;
+    double size = (vertical) ? join->cell_height : join->cell_width;
+    if (n == 1)
+      {
+	  *first = 0;
+	  *last = 0;
+	  return;
+      }
+    *first = (int) ((min - origin) / size);
+    *last = (int) ((max - origin) / size);
+    if (*first < 0)
+	*first = 0;
+    if (*last >= n)
+	*last = n - 1;
+}
+
+static int
+pipjoin_fill_grid (struct splite_pip_join *join, int *counts, int *cursors)
+{
+/* 
+/ bucketing all Polygons into the grid cells
+/
+/ if cursors is NULL Polygons will be simply counted cell by cell,
+/ otherwise their positions will be stored into the index
+/ returns the total number of bucketed items
+*/
+    int i;
+    int ix;
+    int iy;
+    int ix0;
+    int ix1;
+    int iy0;
+    int iy1;
+    int total = 0;
+    if (cursors == NULL)
+      {
+	  for (i = 0; i < join->nx * join->ny; i++)
+	      *(counts + i) = 0;
+      }
+    for (i = 0; i < join->count; i++)
+      {
+	  gaiaGeomCollPtr geom = *(join->polygons + i);
+	  if (*(join->indexes + i) == NULL)
+	      continue;
+	  pipjoin_cell_range (join, geom->MinX, geom->MaxX, 0, &ix0, &ix1);
+	  pipjoin_cell_range (join, geom->MinY, geom->MaxY, 1, &iy0, &iy1);
+	  for (iy = iy0; iy <= iy1; iy++)
+	    {
+		for (ix = ix0; ix <= ix1; ix++)
+		  {
+		      int cell = (iy * join->nx) + ix;
+		      if (cursors == NULL)
+			  *(counts + cell) += 1;
+		      else
+			{
+			    *(join->cell_items + *(cursors + cell)) = i;
+			    *(cursors + cell) += 1;
+			}
+		      total++;
+		  }
+	    }
+      }
+    return total;
+}
+
+GAIAGEO_DECLARE void *
+gaiaCreatePointInPolygonJoin (gaiaGeomCollPtr * polygons, int count)
+{
+/* creating a Point-in-Polygon join index */
+    int i;
+    int n;
+    int total;
+    int valid = 0;
+    int *counts;
+    int *cursors;
+    struct splite_pip_join *join;
+    if (polygons == NULL || count <= 0)
+	return NULL;
+
+    join = malloc (sizeof (struct splite_pip_join));
+    join->polygons = polygons;
+    join->count = count;
+    join->indexes = malloc (sizeof (struct splite_pip_index *) * count);
+    join->cell_start = NULL;
+    join->cell_items = NULL;
+    for (i = 0; i < count; i++)
+      {
+	  /* creating the edge index for each Polygon */
+	  gaiaGeomCollPtr geom = *(polygons + i);
+	  *(join->indexes + i) = NULL;
+	  if (geom == NULL)
+	      continue;
+	  if (!splite_is_polygonal (geom))
+	      continue;
+	  gaiaMbrGeometry (geom);
+	  *(join->indexes + i) = splite_create_pip_index (geom);
+	  if (*(join->indexes + i) == NULL)
+	      continue;
+	  if (valid == 0)
+	    {
+		join->minx = geom->MinX;
+		join->miny = geom->MinY;
+		join->maxx = geom->MaxX;
+		join->maxy = geom->MaxY;
+	    }
+	  else
+	    {
+		if (geom->MinX < join->minx)
+		    join->minx = geom->MinX;
+		if (geom->MinY < join->miny)
+		    join->miny = geom->MinY;
+		if (geom->MaxX > join->maxx)
+		    join->maxx = geom->MaxX;
+		if (geom->MaxY > join->maxy)
+		    join->maxy = geom->MaxY;
+	    }
+	  valid++;
+      }
+    if (valid == 0)
+      {
+	  gaiaFreePointInPolygonJoin (join);
+	  return NULL;
+      }
+
+/* 
+/ about one Polygon for each cell; the grid will be then 
+/ progressively coarsened if too many large Polygons get duplicated
+*/
+    n = (int) sqrt ((double) valid);
+    if (n < 1)
+	n = 1;
+    if (n > SPLITE_PIPJOIN_MAX_CELLS)
+	n = SPLITE_PIPJOIN_MAX_CELLS;
+    counts = malloc (sizeof (int) * n * n);
+    while (1)
+      {
+	  join->nx = (join->maxx > join->minx) ? n : 1;
+	  join->ny = (join->maxy > join->miny) ? n : 1;
+	  join->cell_width = (join->maxx - join->minx) / join->nx;
+	  join->cell_height = (join->maxy - join->miny) / join->ny;
+	  total = pipjoin_fill_grid (join, counts, NULL);
+	  if (n == 1 || total <= valid * 16)
+	      break;
+	  n /= 2;
+      }
+
+    join->cell_start = malloc (sizeof (int) * ((join->nx * join->ny) + 1));
+    cursors = malloc (sizeof (int) * join->nx * join->ny);
+    *(join->cell_start + 0) = 0;
+    for (i = 0; i < join->nx * join->ny; i++)
+      {
+	  *(cursors + i) = *(join->cell_start + i);
+	  *(join->cell_start + i + 1) = *(join->cell_start + i) + *(counts + i);
+      }
+    join->cell_items = malloc (sizeof (int) * total);
+    pipjoin_fill_grid (join, counts, cursors);
+    free (counts);
+    free (cursors);
+    return join;
+}
+
+GAIAGEO_DECLARE void
+gaiaFreePointInPolygonJoin (void *p_join)
+{
+/* memory cleanup - destroying a Point-in-Polygon join index */
+    int i;
+    struct splite_pip_join *join = (struct splite_pip_join *) p_join;
+    if (join == NULL)
+	return;
+    for (i = 0; i < join->count; i++)
+	splite_free_pip_index (*(join->indexes + i));
+    free (join->indexes);
+    if (join->cell_start != NULL)
+	free (join->cell_start);
+    if (join->cell_items != NULL)
+	free (join->cell_items);
+    free (join);
+}
+
+static int
+pipjoin_fallback (const void *p_cache, gaiaGeomCollPtr polyg, double x,
+		  double y)
+{
+/* Point on (or very close to) the boundary: asking GEOS */
+    int ret;
+    gaiaGeomCollPtr point = gaiaAllocGeomColl ();
+    point->Srid = polyg->Srid;
+    gaiaAddPointToGeomColl (point, x, y);
+    gaiaMbrGeometry (point);
+    ret = gaiaGeomCollContains_r (p_cache, polyg, point);
+    gaiaFreeGeomColl (point);
+    return (ret == 1) ? 1 : 0;
+}
+
+static void
+pipjoin_add_pair (struct pipjoin_chunk *chunk, int point, int polyg)
+{
+/* appending a matching pair into the chunk's output buffer */
+    if (chunk->n_pairs >= chunk->max_pairs)
+      {
+	  chunk->max_pairs =
+	      (chunk->max_pairs == 0) ? 1024 : chunk->max_pairs * 2;
+	  chunk->pairs =
+	      realloc (chunk->pairs, sizeof (int) * 2 * chunk->max_pairs);
+      }
+    *(chunk->pairs + (chunk->n_pairs * 2)) = point;
+    *(chunk->pairs + (chunk->n_pairs * 2) + 1) = polyg;
+    chunk->n_pairs += 1;
+}
+
+static void
+pipjoin_do_chunk (const void *p_cache, struct pipjoin_pool *pool,
+		  struct pipjoin_chunk *chunk)
+{
+/* joining all Points of a chunk */
+    int i;
+    int j;
+    struct splite_pip_join *join = pool->join;
+    for (i = chunk->first; i < chunk->last; i++)
+      {
+	  int ix;
+	  int iy;
+	  int cell;
+	  double x = *(pool->x + i);
+	  double y = *(pool->y + i);
+	  if (x < join->minx || x > join->maxx || y < join->miny
+	      || y > join->maxy)
+	      continue;
+	  pipjoin_cell_range (join, x, x, 0, &ix, &ix);
+	  pipjoin_cell_range (join, y, y, 1, &iy, &iy);
+	  cell = (iy * join->nx) + ix;
+	  for (j = *(join->cell_start + cell);
+	       j < *(join->cell_start + cell + 1); j++)
+	    {
+		int ret;
+		int ip = *(join->cell_items + j);
+		gaiaGeomCollPtr polyg = *(join->polygons + ip);
+		if (x < polyg->MinX || x > polyg->MaxX || y < polyg->MinY
+		    || y > polyg->MaxY)
+		    continue;
+		ret = splite_pip_test (*(join->indexes + ip), x, y);
+		if (ret < 0)
+		    ret = pipjoin_fallback (p_cache, polyg, x, y);
+		if (ret)
+		    pipjoin_add_pair (chunk, i, ip);
+	    }
+      }
+}
+
+SPLITE_THREAD_PROC (do_pipjoin_worker, arg)
+{
+/* a worker thread processing chunks until none is left */
+    struct pipjoin_worker *worker = (struct pipjoin_worker *) arg;
+    struct pipjoin_pool *pool = worker->pool;
+    while (1)
+      {
+	  int i;
+	  splite_mutex_lock (&(pool->mutex));
+	  i = pool->next_chunk;
+	  pool->next_chunk += 1;
+	  splite_mutex_unlock (&(pool->mutex));
+	  if (i >= pool->count)
+	      break;
+	  pipjoin_do_chunk (worker->cache, pool, pool->chunks + i);
+      }
+    SPLITE_THREAD_RETURN;
+}
+
+GAIAGEO_DECLARE int
+gaiaPointInPolygonJoin (const void *p_cache, void *p_join, const double *x,
+			const double *y, int n_points, int num_threads,
+			int **pairs, int *n_pairs)
+{
+/* 
+/ joining a set of Points against a Point-in-Polygon join index
+/
+/ Points are split into fixed-size chunks dispatched to a pool of
+/ worker threads (each one owning its own GEOS handle, only required
+/ by Points lying on some boundary); matching pairs are finally
+/ collected in the same order as a sequential scan would produce
+*/
+    splite_thread_t threads[SPLITE_PIPJOIN_MAX_THREADS];
+    struct pipjoin_worker workers[SPLITE_PIPJOIN_MAX_THREADS];
+    struct pipjoin_pool pool;
+    struct splite_pip_join *join = (struct splite_pip_join *) p_join;
+    int started = 0;
+    int total = 0;
+    int i;
+    int *out;
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) p_cache;
+    *pairs = NULL;
+    *n_pairs = 0;
+    if (cache == NULL)
+	return 0;
+    if (cache->magic1 != SPATIALITE_CACHE_MAGIC1
+	|| cache->magic2 != SPATIALITE_CACHE_MAGIC2)
+	return 0;
+    if (cache->GEOS_handle == NULL)
+	return 0;
+    gaiaResetGeosMsg_r (cache);
+    if (join == NULL || x == NULL || y == NULL || n_points < 0)
+	return 0;
+    if (n_points == 0)
+	return 1;
+    if (num_threads < 1)
+	num_threads = 1;
+    if (num_threads > SPLITE_PIPJOIN_MAX_THREADS)
+	num_threads = SPLITE_PIPJOIN_MAX_THREADS;
+
+    pool.join = join;
+    pool.x = x;
+    pool.y = y;
+    pool.count = (n_points + SPLITE_PIPJOIN_CHUNK - 1) / SPLITE_PIPJOIN_CHUNK;
+    pool.next_chunk = 0;
+    pool.chunks = malloc (sizeof (struct pipjoin_chunk) * pool.count);
+    for (i = 0; i < pool.count; i++)
+      {
+	  struct pipjoin_chunk *chunk = pool.chunks + i;
+	  chunk->first = i * SPLITE_PIPJOIN_CHUNK;
+	  chunk->last = chunk->first + SPLITE_PIPJOIN_CHUNK;
+	  if (chunk->last > n_points)
+	      chunk->last = n_points;
+	  chunk->pairs = NULL;
+	  chunk->n_pairs = 0;
+	  chunk->max_pairs = 0;
+      }
+    if (num_threads > pool.count)
+	num_threads = pool.count;
+    splite_mutex_init (&(pool.mutex));
+    workers[0].pool = &pool;
+    workers[0].cache = p_cache;
+    for (i = 1; i < num_threads; i++)
+      {
+	  workers[i].pool = &pool;
+	  workers[i].cache = spatialite_alloc_connection ();
+      }
+    for (i = 1; i < num_threads; i++)
+      {
+	  if (!splite_thread_start
+	      (threads + started, do_pipjoin_worker, workers + i))
+	      break;
+	  started++;
+      }
+/* the calling thread always acts as a worker as well */
+    do_pipjoin_worker (workers);
+    for (i = 0; i < started; i++)
+	splite_thread_join (threads[i]);
+    for (i = 1; i < num_threads; i++)
+	spatialite_internal_cleanup (workers[i].cache);
+    splite_mutex_destroy (&(pool.mutex));
+
+/* collecting all matching pairs */
+    for (i = 0; i < pool.count; i++)
+	total += (pool.chunks + i)->n_pairs;
+    out = (total > 0) ? malloc (sizeof (int) * 2 * total) : NULL;
+    total = 0;
+    for (i = 0; i < pool.count; i++)
+      {
+	  struct pipjoin_chunk *chunk = pool.chunks + i;
+	  if (chunk->n_pairs > 0)
+	      memcpy (out + (total * 2), chunk->pairs,
+		      sizeof (int) * 2 * chunk->n_pairs);
+	  total += chunk->n_pairs;
+	  if (chunk->pairs != NULL)
+	      free (chunk->pairs);
+      }
+    free (pool.chunks);
+    *pairs = out;
+    *n_pairs = total;
+    return 1;
+}
+
 GAIAGEO_DECLARE int
 gaiaGeomCollEquals (gaiaGeomCollPtr geom1, gaiaGeomCollPtr geom2)
 {
@@ -669,6 +1464,139 @@ gaiaGeomCollPreparedIntersects (const void *p_cache, gaiaGeomCollPtr geom1,
     return ret;
 }
 
+GAIAGEO_DECLARE int
+gaiaGeomCollPreparedPredicateBatch (const void *p_cache, int predicate,
+				    gaiaGeomCollPtr reference,
+				    gaiaGeomCollPtr * candidates, int count,
+				    int *results)
+{
+/*
+/ evaluates a Spatial Predicate between a single reference Geometry
+/ and a whole batch of candidate Geometries
+/
+/ the reference Geometry is converted and prepared just once, 
+/ so that every candidate will simply require its own conversion
+*/
+    int i;
+    char ret;
+    GEOSGeometry *g1;
+    GEOSGeometry *g2;
+    const GEOSPreparedGeometry *gPrep;
+    gaiaGeomCollPtr geom;
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) p_cache;
+    GEOSContextHandle_t handle = NULL;
+    if (cache == NULL)
+	return 0;
+    if (cache->magic1 != SPATIALITE_CACHE_MAGIC1
+	|| cache->magic2 != SPATIALITE_CACHE_MAGIC2)
+	return 0;
+    handle = cache->GEOS_handle;
+    if (handle == NULL)
+	return 0;
+    gaiaResetGeosMsg_r (cache);
+    if (reference == NULL || candidates == NULL || results == NULL)
+	return 0;
+    if (count <= 0)
+	return 0;
+    switch (predicate)
+      {
+      case GAIA_PREDICATE_INTERSECTS:
+      case GAIA_PREDICATE_DISJOINT:
+      case GAIA_PREDICATE_CONTAINS:
+      case GAIA_PREDICATE_WITHIN:
+      case GAIA_PREDICATE_COVERS:
+      case GAIA_PREDICATE_COVEREDBY:
+      case GAIA_PREDICATE_TOUCHES:
+      case GAIA_PREDICATE_CROSSES:
+      case GAIA_PREDICATE_OVERLAPS:
+	  break;
+      default:
+	  return 0;
+      }
+    if (gaiaIsToxic_r (cache, reference))
+	return 0;
+
+    g1 = gaiaToGeos_r (cache, reference);
+    if (g1 == NULL)
+	return 0;
+    gPrep = GEOSPrepare_r (handle, g1);
+    if (gPrep == NULL)
+      {
+	  GEOSGeom_destroy_r (handle, g1);
+	  return 0;
+      }
+
+    for (i = 0; i < count; i++)
+      {
+	  geom = *(candidates + i);
+	  if (geom == NULL)
+	    {
+		*(results + i) = -1;
+		continue;
+	    }
+	  if (gaiaIsToxic_r (cache, geom))
+	    {
+		*(results + i) = -1;
+		continue;
+	    }
+	  /* quick check based on MBRs comparison */
+	  if (!splite_mbr_overlaps (reference, geom))
+	    {
+		if (predicate == GAIA_PREDICATE_DISJOINT)
+		    *(results + i) = 1;
+		else
+		    *(results + i) = 0;
+		continue;
+	    }
+	  g2 = gaiaToGeos_r (cache, geom);
+	  if (g2 == NULL)
+	    {
+		*(results + i) = -1;
+		continue;
+	    }
+	  switch (predicate)
+	    {
+	    case GAIA_PREDICATE_DISJOINT:
+		ret = GEOSPreparedDisjoint_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_CONTAINS:
+		ret = GEOSPreparedContains_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_WITHIN:
+		ret = GEOSPreparedWithin_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_COVERS:
+		ret = GEOSPreparedCovers_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_COVEREDBY:
+		ret = GEOSPreparedCoveredBy_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_TOUCHES:
+		ret = GEOSPreparedTouches_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_CROSSES:
+		ret = GEOSPreparedCrosses_r (handle, gPrep, g2);
+		break;
+	    case GAIA_PREDICATE_OVERLAPS:
+		ret = GEOSPreparedOverlaps_r (handle, gPrep, g2);
+		break;
+	    default:
+		ret = GEOSPreparedIntersects_r (handle, gPrep, g2);
+		break;
+	    }
+	  GEOSGeom_destroy_r (handle, g2);
+	  if (ret == 0 || ret == 1)
+	      *(results + i) = ret;
+	  else
+	      *(results + i) = -1;	/* GEOS exception */
+      }
+
+    GEOSPreparedGeom_destroy_r (handle, gPrep);
+    GEOSGeom_destroy_r (handle, g1);
+    return 1;
+}
+
 GAIAGEO_DECLARE int
 gaiaGeomCollDisjoint (gaiaGeomCollPtr geom1, gaiaGeomCollPtr geom2)
 {
@@ -1241,6 +2169,14 @@ gaiaGeomCollPreparedWithin (const void *p_cache, gaiaGeomCollPtr geom1,
     if (!splite_mbr_within (geom1, geom2))
 	return 0;
 
+    if (splite_is_single_point (geom1) && splite_is_polygonal (geom2))
+      {
+	  /* native Point-in-Polygon fast path */
+	  ret = evalPipCache (cache, geom1, geom2, blob2, size2);
+	  if (ret >= 0)
+	      return ret;
+      }
+
 /* handling the internal GEOS cache */
     if (evalGeosCache
 	(cache, geom1, blob1, size1, geom2, blob2, size2, &gPrep, &geom))
@@ -1362,6 +2298,14 @@ gaiaGeomCollPreparedContains (const void *p_cache, gaiaGeomCollPtr geom1,
     if (!splite_mbr_contains (geom1, geom2))
 	return 0;
 
+    if (splite_is_single_point (geom2) && splite_is_polygonal (geom1))
+      {
+	  /* native Point-in-Polygon fast path */
+	  ret = evalPipCache (cache, geom2, geom1, blob1, size1);
+	  if (ret >= 0)
+	      return ret;
+      }
+
 /* handling the internal GEOS cache */
     if (evalGeosCache
 	(cache, geom1, blob1, size1, geom2, blob2, size2, &gPrep, &geom))
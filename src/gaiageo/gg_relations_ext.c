@@ -65,9 +65,11 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #endif
 
 #include <spatialite_private.h>
+#include <splite_thread.h>
 #include <spatialite/sqlite.h>
 
 #include <spatialite/gaiageo.h>
+#include <spatialite.h>
 
 #ifndef OMIT_GEOS		/* including GEOS */
 
@@ -4849,6 +4851,527 @@ gaiaConcaveHull_r (const void *p_cache, gaiaGeomCollPtr geom, double factor,
     return result;
 }
 
+#define GAIA_SUBDIVIDE_MIN_VERTICES	5
+#define GAIA_SUBDIVIDE_MAX_DEPTH	50
+#define GAIA_SUBDIVIDE_MAX_THREADS	64
+/* a cell this much longer than wide will only be split in halves */
+#define GAIA_SUBDIVIDE_ELONGATION	2.0
+
+struct subdivide_job
+{
+/* a struct wrapping a sub-tree still to be subdivided */
+    gaiaGeomCollPtr geom;
+    int depth;
+    gaiaGeomCollPtr result;
+};
+
+struct subdivide_pool
+{
+/* a struct wrapping a set of Subdivide jobs */
+    struct subdivide_job *jobs;
+    int count;
+    int next_job;
+    int max_vertices;
+    splite_mutex_t mutex;
+};
+
+struct subdivide_worker
+{
+/* a struct wrapping a single worker thread */
+    struct subdivide_pool *pool;
+    const void *cache;
+};
+
+static int
+subdivide_count_vertices (gaiaGeomCollPtr geom)
+{
+/* counting how many vertices are into a Geometry */
+    int ib;
+    int count = 0;
+    gaiaPointPtr pt;
+    gaiaLinestringPtr ln;
+    gaiaPolygonPtr pg;
+
+    pt = geom->FirstPoint;
+    while (pt)
+      {
+	  count++;
+	  pt = pt->Next;
+      }
+    ln = geom->FirstLinestring;
+    while (ln)
+      {
+	  count += ln->Points;
+	  ln = ln->Next;
+      }
+    pg = geom->FirstPolygon;
+    while (pg)
+      {
+	  count += pg->Exterior->Points;
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	      count += (pg->Interiors + ib)->Points;
+	  pg = pg->Next;
+      }
+    return count;
+}
+
+static gaiaGeomCollPtr
+subdivide_alloc_result (gaiaGeomCollPtr geom)
+{
+/* allocating an empty Geometry having the same dimensions */
+    gaiaGeomCollPtr result;
+    if (geom->DimensionModel == GAIA_XY_Z)
+	result = gaiaAllocGeomCollXYZ ();
+    else if (geom->DimensionModel == GAIA_XY_M)
+	result = gaiaAllocGeomCollXYM ();
+    else if (geom->DimensionModel == GAIA_XY_Z_M)
+	result = gaiaAllocGeomCollXYZM ();
+    else
+	result = gaiaAllocGeomColl ();
+    result->Srid = geom->Srid;
+    return result;
+}
+
+static void
+subdivide_append (gaiaGeomCollPtr result, gaiaGeomCollPtr piece)
+{
+/* moving all items from a piece into the result (no copy at all) */
+    if (piece->FirstPoint != NULL)
+      {
+	  if (result->FirstPoint == NULL)
+	      result->FirstPoint = piece->FirstPoint;
+	  else
+	    {
+		result->LastPoint->Next = piece->FirstPoint;
+		piece->FirstPoint->Prev = result->LastPoint;
+	    }
+	  result->LastPoint = piece->LastPoint;
+      }
+    if (piece->FirstLinestring != NULL)
+      {
+	  if (result->FirstLinestring == NULL)
+	      result->FirstLinestring = piece->FirstLinestring;
+	  else
+	      result->LastLinestring->Next = piece->FirstLinestring;
+	  result->LastLinestring = piece->LastLinestring;
+      }
+    if (piece->FirstPolygon != NULL)
+      {
+	  if (result->FirstPolygon == NULL)
+	      result->FirstPolygon = piece->FirstPolygon;
+	  else
+	      result->LastPolygon->Next = piece->FirstPolygon;
+	  result->LastPolygon = piece->LastPolygon;
+      }
+    piece->FirstPoint = NULL;
+    piece->LastPoint = NULL;
+    piece->FirstLinestring = NULL;
+    piece->LastLinestring = NULL;
+    piece->FirstPolygon = NULL;
+    piece->LastPolygon = NULL;
+    gaiaFreeGeomColl (piece);
+}
+
+static int
+subdivide_dimension (gaiaGeomCollPtr geom)
+{
+/* returning the topological dimension of a Geometry (-1 if empty) */
+    if (geom->FirstPolygon != NULL)
+	return 2;
+    if (geom->FirstLinestring != NULL)
+	return 1;
+    if (geom->FirstPoint != NULL)
+	return 0;
+    return -1;
+}
+
+static void
+subdivide_drop_lower_dims (gaiaGeomCollPtr geom, int dims)
+{
+/* 
+/ removing all items having a lower dimension than the input Geometry
+/ (e.g. isolated Points left by a Linestring touching the cell's boundary)
+*/
+    if (dims >= 1)
+      {
+	  gaiaPointPtr pt = geom->FirstPoint;
+	  while (pt)
+	    {
+		gaiaPointPtr next = pt->Next;
+		gaiaFreePoint (pt);
+		pt = next;
+	    }
+	  geom->FirstPoint = NULL;
+	  geom->LastPoint = NULL;
+      }
+    if (dims >= 2)
+      {
+	  gaiaLinestringPtr ln = geom->FirstLinestring;
+	  while (ln)
+	    {
+		gaiaLinestringPtr next = ln->Next;
+		gaiaFreeLinestring (ln);
+		ln = next;
+	    }
+	  geom->FirstLinestring = NULL;
+	  geom->LastLinestring = NULL;
+      }
+}
+
+static int
+subdivide_clip (const void *p_cache, gaiaGeomCollPtr geom, double minx,
+		double miny, double maxx, double maxy,
+		gaiaGeomCollPtr * piece)
+{
+/* 
+/ clipping a Geometry against a rectangle
+/ returns 0 on GEOS failure; *piece will be NULL if nothing is left
+*/
+    GEOSGeometry *g1;
+    GEOSGeometry *g2;
+    gaiaGeomCollPtr clipped;
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) p_cache;
+    GEOSContextHandle_t handle = cache->GEOS_handle;
+
+    *piece = NULL;
+    g1 = gaiaToGeos_r (cache, geom);
+    if (g1 == NULL)
+	return 0;
+#ifdef GEOS_REENTRANT		/* GEOS >= 3.5.0 directly supports ClipByRect */
+    if (geom->FirstPoint == NULL && geom->FirstLinestring == NULL)
+	g2 = GEOSClipByRect_r (handle, g1, minx, miny, maxx, maxy);
+    else
+#endif
+      {
+	  /* 
+	   / Points and Linestrings laying exactly on the rectangle's
+	   / boundary would be discarded by ClipByRect
+	   */
+	  GEOSGeometry *rect;
+	  gaiaGeomCollPtr frame = gaiaAllocGeomColl ();
+	  gaiaPolygonPtr pg = gaiaAddPolygonToGeomColl (frame, 5, 0);
+	  gaiaRingPtr rng = pg->Exterior;
+	  gaiaSetPoint (rng->Coords, 0, minx, miny);
+	  gaiaSetPoint (rng->Coords, 1, maxx, miny);
+	  gaiaSetPoint (rng->Coords, 2, maxx, maxy);
+	  gaiaSetPoint (rng->Coords, 3, minx, maxy);
+	  gaiaSetPoint (rng->Coords, 4, minx, miny);
+	  frame->Srid = geom->Srid;
+	  rect = gaiaToGeos_r (cache, frame);
+	  gaiaFreeGeomColl (frame);
+	  g2 = GEOSIntersection_r (handle, g1, rect);
+	  GEOSGeom_destroy_r (handle, rect);
+      }
+    GEOSGeom_destroy_r (handle, g1);
+    if (g2 == NULL)
+	return 0;
+    if (GEOSisEmpty_r (handle, g2) == 1)
+      {
+	  GEOSGeom_destroy_r (handle, g2);
+	  return 1;
+      }
+    if (subdivide_dimension (geom) == 1)
+      {
+	  /* the Intersection breaks Linestrings at every node */
+	  g1 = GEOSLineMerge_r (handle, g2);
+	  GEOSGeom_destroy_r (handle, g2);
+	  if (g1 == NULL)
+	      return 0;
+	  g2 = g1;
+	  if (GEOSisEmpty_r (handle, g2) == 1)
+	    {
+		GEOSGeom_destroy_r (handle, g2);
+		return 1;
+	    }
+      }
+    if (geom->DimensionModel == GAIA_XY_Z)
+	clipped = gaiaFromGeos_XYZ_r (cache, g2);
+    else if (geom->DimensionModel == GAIA_XY_M)
+	clipped = gaiaFromGeos_XYM_r (cache, g2);
+    else if (geom->DimensionModel == GAIA_XY_Z_M)
+	clipped = gaiaFromGeos_XYZM_r (cache, g2);
+    else
+	clipped = gaiaFromGeos_XY_r (cache, g2);
+    GEOSGeom_destroy_r (handle, g2);
+    if (clipped == NULL)
+	return 0;
+    subdivide_drop_lower_dims (clipped, subdivide_dimension (geom));
+    if (subdivide_dimension (clipped) < 0)
+      {
+	  gaiaFreeGeomColl (clipped);
+	  return 1;
+      }
+    clipped->Srid = geom->Srid;
+    *piece = clipped;
+    return 1;
+}
+
+static int
+subdivide_split (const void *p_cache, gaiaGeomCollPtr geom,
+		 gaiaGeomCollPtr * cells)
+{
+/* 
+/ splitting a Geometry into (up to) four quadrants, or into two
+/ halves along the longer axis when its MBR is elongated
+/ returns the number of non-empty cells, or -1 if not splittable
+*/
+    int ix;
+    int iy;
+    int nx;
+    int ny;
+    int count = 0;
+    double width;
+    double height;
+
+    gaiaMbrGeometry (geom);
+    width = geom->MaxX - geom->MinX;
+    height = geom->MaxY - geom->MinY;
+    if (width <= 0.0 && height <= 0.0)
+	return -1;
+    nx = (width > 0.0) ? 2 : 1;
+    ny = (height > 0.0) ? 2 : 1;
+    if (width > height * GAIA_SUBDIVIDE_ELONGATION)
+	ny = 1;
+    else if (height > width * GAIA_SUBDIVIDE_ELONGATION)
+	nx = 1;
+    for (iy = 0; iy < ny; iy++)
+      {
+	  double miny = geom->MinY + ((height / ny) * iy);
+	  double maxy =
+	      (iy == ny - 1) ? geom->MaxY : geom->MinY + ((height / ny) *
+							  (iy + 1));
+	  for (ix = 0; ix < nx; ix++)
+	    {
+		double minx = geom->MinX + ((width / nx) * ix);
+		double maxx =
+		    (ix == nx - 1) ? geom->MaxX : geom->MinX +
+		    ((width / nx) * (ix + 1));
+		if (!subdivide_clip
+		    (p_cache, geom, minx, miny, maxx, maxy, cells + count))
+		  {
+		      /* GEOS failure: never loosing any vertex */
+		      int i;
+		      for (i = 0; i < count; i++)
+			  gaiaFreeGeomColl (*(cells + i));
+		      return -1;
+		  }
+		if (*(cells + count) != NULL)
+		    count++;
+	    }
+      }
+    return count;
+}
+
+static void
+do_subdivide (const void *p_cache, gaiaGeomCollPtr geom, int depth,
+	      int max_vertices, gaiaGeomCollPtr result)
+{
+/* recursively subdividing a Geometry (the Geometry will be consumed) */
+    int i;
+    int count;
+    gaiaGeomCollPtr cells[4];
+
+    count = subdivide_count_vertices (geom);
+    if (count == 0)
+      {
+	  gaiaFreeGeomColl (geom);
+	  return;
+      }
+    if (count <= max_vertices || depth >= GAIA_SUBDIVIDE_MAX_DEPTH)
+      {
+	  subdivide_append (result, geom);
+	  return;
+      }
+    count = subdivide_split (p_cache, geom, cells);
+    if (count < 0)
+      {
+	  subdivide_append (result, geom);
+	  return;
+      }
+    gaiaFreeGeomColl (geom);
+    for (i = 0; i < count; i++)
+	do_subdivide (p_cache, cells[i], depth + 1, max_vertices, result);
+}
+
+SPLITE_THREAD_PROC (do_subdivide_worker, arg)
+{
+/* a worker thread processing Jobs until none is left */
+    struct subdivide_worker *worker = (struct subdivide_worker *) arg;
+    struct subdivide_pool *pool = worker->pool;
+    while (1)
+      {
+	  int i;
+	  struct subdivide_job *job;
+	  splite_mutex_lock (&(pool->mutex));
+	  i = pool->next_job;
+	  pool->next_job += 1;
+	  splite_mutex_unlock (&(pool->mutex));
+	  if (i >= pool->count)
+	      break;
+	  job = pool->jobs + i;
+	  do_subdivide (worker->cache, job->geom, job->depth,
+			pool->max_vertices, job->result);
+	  job->geom = NULL;
+      }
+    SPLITE_THREAD_RETURN;
+}
+
+static struct subdivide_job *
+subdivide_expand_jobs (const void *p_cache, struct subdivide_job *jobs,
+		       int *count, int max_vertices, int *expanded)
+{
+/* splitting all oversized Jobs by one more level */
+    int i;
+    int j;
+    int n = 0;
+    struct subdivide_job *next =
+	malloc (sizeof (struct subdivide_job) * (*count) * 4);
+
+    *expanded = 0;
+    for (i = 0; i < *count; i++)
+      {
+	  struct subdivide_job *job = jobs + i;
+	  gaiaGeomCollPtr cells[4];
+	  int cnt = -1;
+	  if (subdivide_count_vertices (job->geom) > max_vertices
+	      && job->depth < GAIA_SUBDIVIDE_MAX_DEPTH)
+	      cnt = subdivide_split (p_cache, job->geom, cells);
+	  if (cnt < 0)
+	    {
+		/* preserving the Job as it is */
+		next[n++] = *job;
+		continue;
+	    }
+	  for (j = 0; j < cnt; j++)
+	    {
+		next[n].geom = cells[j];
+		next[n].depth = job->depth + 1;
+		next[n].result = NULL;
+		n++;
+	    }
+	  gaiaFreeGeomColl (job->geom);
+	  *expanded = 1;
+      }
+    free (jobs);
+    *count = n;
+    return next;
+}
+
+static void
+subdivide_parallel (const void *p_cache, gaiaGeomCollPtr geom,
+		    int max_vertices, int num_threads,
+		    gaiaGeomCollPtr result)
+{
+/* 
+/ subdividing a Geometry on a pool of worker threads
+/
+/ the first levels are split by the calling thread until there are
+/ enough independent sub-trees, then each sub-tree is processed by
+/ the first available worker (each one owning its own GEOS handle)
+/ results are finally collected in the same order as the sequential
+/ algorithm would produce
+*/
+    splite_thread_t threads[GAIA_SUBDIVIDE_MAX_THREADS];
+    struct subdivide_worker workers[GAIA_SUBDIVIDE_MAX_THREADS];
+    struct subdivide_pool pool;
+    struct subdivide_job *jobs;
+    int count = 1;
+    int expanded = 1;
+    int started = 0;
+    int i;
+
+    jobs = malloc (sizeof (struct subdivide_job));
+    jobs->geom = geom;
+    jobs->depth = 0;
+    jobs->result = NULL;
+    while (expanded && count < num_threads * 4)
+	jobs =
+	    subdivide_expand_jobs (p_cache, jobs, &count, max_vertices,
+				   &expanded);
+    for (i = 0; i < count; i++)
+	(jobs + i)->result = subdivide_alloc_result (result);
+    if (num_threads > count)
+	num_threads = count;
+
+    pool.jobs = jobs;
+    pool.count = count;
+    pool.next_job = 0;
+    pool.max_vertices = max_vertices;
+    splite_mutex_init (&(pool.mutex));
+    workers[0].pool = &pool;
+    workers[0].cache = p_cache;
+    for (i = 1; i < num_threads; i++)
+      {
+	  workers[i].pool = &pool;
+	  workers[i].cache = spatialite_alloc_connection ();
+      }
+    for (i = 1; i < num_threads; i++)
+      {
+	  if (!splite_thread_start
+	      (threads + started, do_subdivide_worker, workers + i))
+	      break;
+	  started++;
+      }
+/* the calling thread always acts as a worker as well */
+    do_subdivide_worker (workers);
+    for (i = 0; i < started; i++)
+	splite_thread_join (threads[i]);
+    for (i = 1; i < num_threads; i++)
+	spatialite_internal_cleanup (workers[i].cache);
+    splite_mutex_destroy (&(pool.mutex));
+
+/* collecting all results */
+    for (i = 0; i < count; i++)
+	subdivide_append (result, (jobs + i)->result);
+    free (jobs);
+}
+
+GAIAGEO_DECLARE gaiaGeomCollPtr
+gaiaSubdivide (const void *p_cache, gaiaGeomCollPtr geom, int max_vertices,
+	       int num_threads)
+{
+/* 
+/ recursively splitting a Geometry by quadrant clipping, so that
+/ each resulting piece will contain no more than max_vertices
+*/
+    gaiaGeomCollPtr work;
+    gaiaGeomCollPtr result;
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) p_cache;
+    if (cache == NULL)
+	return NULL;
+    if (cache->magic1 != SPATIALITE_CACHE_MAGIC1
+	|| cache->magic2 != SPATIALITE_CACHE_MAGIC2)
+	return NULL;
+    if (cache->GEOS_handle == NULL)
+	return NULL;
+    gaiaResetGeosMsg_r (cache);
+    if (geom == NULL)
+	return NULL;
+    if (max_vertices < GAIA_SUBDIVIDE_MIN_VERTICES)
+	return NULL;
+    if (gaiaIsToxic_r (cache, geom))
+	return NULL;
+
+    work = gaiaCloneGeomColl (geom);
+    work->Srid = geom->Srid;
+    result = subdivide_alloc_result (geom);
+    if (num_threads > GAIA_SUBDIVIDE_MAX_THREADS)
+	num_threads = GAIA_SUBDIVIDE_MAX_THREADS;
+    if (num_threads > 1)
+	subdivide_parallel (cache, work, max_vertices, num_threads, result);
+    else
+	do_subdivide (cache, work, 0, max_vertices, result);
+    if (result->FirstPoint == NULL && result->FirstLinestring == NULL
+	&& result->FirstPolygon == NULL)
+      {
+	  gaiaFreeGeomColl (result);
+	  return NULL;
+      }
+    return result;
+}
+
 #endif /* end GEOS advanced features */
 
 #endif /* end including GEOS */
@@ -59,6 +59,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 
 #include <spatialite/gaiageo.h>
 #include <spatialite/geopackage.h>
+#include <spatialite_private.h>
 
 static void
 ParseWkbPoint (gaiaGeomCollPtr geo)
@@ -2264,6 +2265,65 @@ gaiaToSpatiaLiteBlobWkb (gaiaGeomCollPtr geom, unsigned char **result,
     gaiaToSpatiaLiteBlobWkbEx (geom, result, size, 0);
 }
 
+SPATIALITE_PRIVATE void
+gaia_elementary_blob_from_item (const void *point, const void *linestring,
+				const void *polygon, int srid,
+				unsigned char **blob, int *size)
+{
+/*
+/ encoding a single Point, Linestring or Polygon as an Elementary Geometry
+/ 
+/ a lightweight Geometry is simply wrapped around the original item
+/ (no coordinate copy at all); the item is temporarily unlinked from
+/ its siblings while encoding
+*/
+    gaiaPointPtr pt = (gaiaPointPtr) point;
+    gaiaLinestringPtr ln = (gaiaLinestringPtr) linestring;
+    gaiaPolygonPtr pg = (gaiaPolygonPtr) polygon;
+    gaiaGeomColl elem;
+    memset (&elem, '\0', sizeof (gaiaGeomColl));
+    elem.Srid = srid;
+    elem.endian = ' ';
+    if (pt != NULL)
+      {
+	  gaiaPointPtr next = pt->Next;
+	  elem.DimensionModel = pt->DimensionModel;
+	  elem.DeclaredType = GAIA_POINT;
+	  elem.FirstPoint = pt;
+	  elem.LastPoint = pt;
+	  pt->Next = NULL;
+	  gaiaToSpatiaLiteBlobWkb (&elem, blob, size);
+	  pt->Next = next;
+      }
+    else if (ln != NULL)
+      {
+	  gaiaLinestringPtr next = ln->Next;
+	  elem.DimensionModel = ln->DimensionModel;
+	  elem.DeclaredType = GAIA_LINESTRING;
+	  elem.FirstLinestring = ln;
+	  elem.LastLinestring = ln;
+	  ln->Next = NULL;
+	  gaiaToSpatiaLiteBlobWkb (&elem, blob, size);
+	  ln->Next = next;
+      }
+    else if (pg != NULL)
+      {
+	  gaiaPolygonPtr next = pg->Next;
+	  elem.DimensionModel = pg->DimensionModel;
+	  elem.DeclaredType = GAIA_POLYGON;
+	  elem.FirstPolygon = pg;
+	  elem.LastPolygon = pg;
+	  pg->Next = NULL;
+	  gaiaToSpatiaLiteBlobWkb (&elem, blob, size);
+	  pg->Next = next;
+      }
+    else
+      {
+	  *blob = NULL;
+	  *size = 0;
+      }
+}
+
 GAIAGEO_DECLARE void
 gaiaToCompressedBlobWkb (gaiaGeomCollPtr geom, unsigned char **result,
 			 int *size)
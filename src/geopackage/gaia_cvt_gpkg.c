@@ -56,6 +56,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <spatialite.h>
 #include <spatialite/gaiaaux.h>
 #include <spatialite/geopackage.h>
+#include <splite_thread.h>
 
 struct pk_item
 {
@@ -422,7 +423,7 @@ create_Spatialite2GPKG_statements (sqlite3 * handle_in, sqlite3 * handle_out,
 				   const char *table_name,
 				   const char *geometry_column,
 				   sqlite3_stmt ** stmt_in,
-				   sqlite3_stmt ** stmt_out)
+				   sqlite3_stmt ** stmt_out, int *geom_col)
 {
 /* attempting to create the IN and OUT prepared stmts */
     int ret;
@@ -440,6 +441,7 @@ create_Spatialite2GPKG_statements (sqlite3 * handle_in, sqlite3 * handle_out,
     char *xtable;
     int first_in = 1;
     int first_out = 1;
+    int n_col = 0;
     char *sql_err = NULL;
     sqlite3_stmt *xstmt_in;
     sqlite3_stmt *xstmt_out;
@@ -469,7 +471,7 @@ create_Spatialite2GPKG_statements (sqlite3 * handle_in, sqlite3 * handle_out,
 	;
     else
       {
-	  for (i = 1; i <= rows; i++)
+	  for (i = 1; i <= rows; i++, n_col++)
 	    {
 		const char *name;
 		char *xname;
@@ -477,19 +479,19 @@ create_Spatialite2GPKG_statements (sqlite3 * handle_in, sqlite3 * handle_out,
 		xname = gaiaDoubleQuotedSql (name);
 		if (strcasecmp (name, geometry_column) == 0)
 		  {
-		      /* the geometry column */
+		      /* the geometry column: will be directly transcoded */
+		      *geom_col = n_col;
 		      prev_sql = in_sql;
 		      if (first_in)
 			{
 			    in_sql =
-				sqlite3_mprintf ("%s AsGPB(\"%s\")", prev_sql,
-						 xname);
+				sqlite3_mprintf ("%s \"%s\"", prev_sql, xname);
 			    first_in = 0;
 			}
 		      else
 			{
 			    in_sql =
-				sqlite3_mprintf ("%s, AsGPB(\"%s\")", prev_sql,
+				sqlite3_mprintf ("%s, \"%s\"", prev_sql,
 						 xname);
 			}
 		      sqlite3_free (prev_sql);
@@ -595,7 +597,7 @@ create_GPKG2Spatialite_statements (sqlite3 * handle_in, sqlite3 * handle_out,
 				   const char *table_name,
 				   const char *geometry_column,
 				   sqlite3_stmt ** stmt_in,
-				   sqlite3_stmt ** stmt_out)
+				   sqlite3_stmt ** stmt_out, int *geom_col)
 {
 /* attempting to create the IN and OUT prepared stmts */
     int ret;
@@ -613,6 +615,7 @@ create_GPKG2Spatialite_statements (sqlite3 * handle_in, sqlite3 * handle_out,
     char *xtable;
     int first_in = 1;
     int first_out = 1;
+    int n_col = 0;
     char *sql_err = NULL;
     sqlite3_stmt *xstmt_in;
     sqlite3_stmt *xstmt_out;
@@ -642,7 +645,7 @@ create_GPKG2Spatialite_statements (sqlite3 * handle_in, sqlite3 * handle_out,
 	;
     else
       {
-	  for (i = 1; i <= rows; i++)
+	  for (i = 1; i <= rows; i++, n_col++)
 	    {
 		const char *name;
 		char *xname;
@@ -650,20 +653,20 @@ create_GPKG2Spatialite_statements (sqlite3 * handle_in, sqlite3 * handle_out,
 		xname = gaiaDoubleQuotedSql (name);
 		if (strcasecmp (name, geometry_column) == 0)
 		  {
-		      /* the geometry column */
+		      /* the geometry column: will be directly transcoded */
+		      *geom_col = n_col;
 		      prev_sql = in_sql;
 		      if (first_in)
 			{
 			    in_sql =
-				sqlite3_mprintf ("%s GeomFromGPB(\"%s\")",
-						 prev_sql, xname);
+				sqlite3_mprintf ("%s \"%s\"", prev_sql, xname);
 			    first_in = 0;
 			}
 		      else
 			{
 			    in_sql =
-				sqlite3_mprintf ("%s, GeomFromGPB(\"%s\")",
-						 prev_sql, xname);
+				sqlite3_mprintf ("%s, \"%s\"", prev_sql,
+						 xname);
 			}
 		      sqlite3_free (prev_sql);
 		      prev_sql = out_sql;
@@ -763,82 +766,362 @@ create_GPKG2Spatialite_statements (sqlite3 * handle_in, sqlite3 * handle_out,
     return 0;
 }
 
-static int
-do_copy_table (sqlite3 * handle_in, sqlite3 * handle_out,
-	       sqlite3_stmt * stmt_in, sqlite3_stmt * stmt_out,
-	       const char *table_name)
+/*
+/ copying rows on a reader/writer thread pair
+/
+/ a dedicated reader thread scrolls the IN result set (the only thread
+/ ever touching handle_in), copies each row and transcodes its Geometry
+/ into the destination format, then queues batches of rows into a small
+/ bounded ring; the calling thread (the only one touching handle_out)
+/ concurrently drains the ring inserting rows into the OUT table.
+/ when SQLite is built without thread support, or when no thread can be
+/ started, the calling thread simply alternates between both roles
+*/
+
+#define CVT_BATCH_ROWS	256
+#define CVT_QUEUE_SLOTS	4
+
+struct cvt_value
 {
-/* copying all rows from IN and OUT tables */
+/* a struct wrapping a copied column value */
+    int type;
+    sqlite3_int64 int_value;
+    double dbl_value;
+    unsigned char *blob;
+    int size;
+};
+
+struct cvt_batch
+{
+/* a struct wrapping a batch of copied rows */
+    int rows;
+    struct cvt_value *values;
+};
+
+struct cvt_pipe
+{
+/* a struct wrapping the reader/writer cvt */
+    sqlite3 *handle_in;
+    sqlite3_stmt *stmt_in;
+    const char *table_name;
+    int columns;
+    int geom_col;
+    int to_gpkg;
+    struct cvt_batch slots[CVT_QUEUE_SLOTS];
+    int head;
+    int count;
+    int eof;
+    int error;
+    int abort;
+    splite_mutex_t mutex;
+    splite_cond_t cond;
+};
+
+static void
+cvt_reset_batch (struct cvt_pipe *cvt, struct cvt_batch *batch)
+{
+/* releasing any value still owned by a batch */
+    int i;
+    for (i = 0; i < batch->rows * cvt->columns; i++)
+      {
+	  struct cvt_value *value = batch->values + i;
+	  if (value->blob != NULL)
+	      free (value->blob);
+	  value->blob = NULL;
+      }
+    batch->rows = 0;
+}
+
+static void
+cvt_copy_geometry (struct cvt_pipe *cvt, struct cvt_value *value)
+{
+/* transcoding the current Geometry into the destination format */
+    const unsigned char *blob = sqlite3_column_blob (cvt->stmt_in,
+						     cvt->geom_col);
+    int size = sqlite3_column_bytes (cvt->stmt_in, cvt->geom_col);
     int ret;
-    char *sql_err = NULL;
+    if (cvt->to_gpkg)
+	ret = gaiaSpatiaLiteBlobToGPB (blob, size, &(value->blob),
+				       &(value->size));
+    else
+	ret = gaiaGPBToSpatiaLiteBlob (blob, size, &(value->blob),
+				       &(value->size));
+    if (ret)
+	value->type = SQLITE_BLOB;
+    else
+	value->type = SQLITE_NULL;	/* invalid Geometry */
+}
 
-    while (1)
+static int
+cvt_read_batch (struct cvt_pipe *cvt, struct cvt_batch *batch)
+{
+/*
+/ filling a batch from the IN result set
+/ returns 1 if more rows could follow, 0 on end of result set, -1 on error
+*/
+    int ret;
+    int c;
+    struct cvt_value *value;
+    const void *data;
+    batch->rows = 0;
+    while (batch->rows < CVT_BATCH_ROWS)
       {
-	  /* scrolling the result set rows */
-	  ret = sqlite3_step (stmt_in);
+	  ret = sqlite3_step (cvt->stmt_in);
 	  if (ret == SQLITE_DONE)
-	      break;		/* end of result set */
-	  if (ret == SQLITE_ROW)
+	      return 0;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	    {
+		/* an unexpected error occurred */
+		spatialite_e ("Error while querying from \"%s\": %s\n",
+			      cvt->table_name, sqlite3_errmsg (cvt->handle_in));
+		cvt_reset_batch (cvt, batch);
+		return -1;
+	    }
+	  value = batch->values + (batch->rows * cvt->columns);
+	  batch->rows += 1;
+	  for (c = 0; c < cvt->columns; c++, value++)
 	    {
-		int c;
-		int cols = sqlite3_column_count (stmt_in);
-		sqlite3_reset (stmt_out);
-		sqlite3_clear_bindings (stmt_out);
-		for (c = 0; c < cols; c++)
+		/* copying column values */
+		value->type = sqlite3_column_type (cvt->stmt_in, c);
+		value->blob = NULL;
+		value->size = 0;
+		if (c == cvt->geom_col)
 		  {
-		      /* binding column values */
-		      switch (sqlite3_column_type (stmt_in, c))
-			{
-			case SQLITE_INTEGER:
-			    sqlite3_bind_int64 (stmt_out, c + 1,
-						sqlite3_column_int64 (stmt_in,
-								      c));
-			    break;
-			case SQLITE_FLOAT:
-			    sqlite3_bind_double (stmt_out, c + 1,
-						 sqlite3_column_double (stmt_in,
-									c));
-			    break;
-			case SQLITE_TEXT:
-			    sqlite3_bind_text (stmt_out, c + 1,
-					       (const char *)
-					       sqlite3_column_text (stmt_in, c),
-					       sqlite3_column_bytes (stmt_in,
-								     c),
-					       SQLITE_STATIC);
-			    break;
-			case SQLITE_BLOB:
-			    sqlite3_bind_blob (stmt_out, c + 1,
-					       sqlite3_column_blob (stmt_in, c),
-					       sqlite3_column_bytes (stmt_in,
-								     c),
-					       SQLITE_STATIC);
-			    break;
-			default:
-			    sqlite3_bind_null (stmt_out, c + 1);
-			    break;
-			};
+		      if (value->type == SQLITE_BLOB)
+			  cvt_copy_geometry (cvt, value);
+		      else
+			  value->type = SQLITE_NULL;
+		      continue;
 		  }
-		ret = sqlite3_step (stmt_out);
-		if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-		    ;
-		else
+		switch (value->type)
 		  {
-		      /* an unexpected error occurred */
-		      spatialite_e ("Error while inserting into \"%s\": %s\n",
-				    table_name, sqlite3_errmsg (handle_out));
-		      goto stop;
-		  }
+		  case SQLITE_INTEGER:
+		      value->int_value = sqlite3_column_int64 (cvt->stmt_in, c);
+		      break;
+		  case SQLITE_FLOAT:
+		      value->dbl_value =
+			  sqlite3_column_double (cvt->stmt_in, c);
+		      break;
+		  case SQLITE_TEXT:
+		  case SQLITE_BLOB:
+		      if (value->type == SQLITE_TEXT)
+			  data = sqlite3_column_text (cvt->stmt_in, c);
+		      else
+			  data = sqlite3_column_blob (cvt->stmt_in, c);
+		      value->size = sqlite3_column_bytes (cvt->stmt_in, c);
+		      value->blob = malloc (value->size + 1);
+		      if (value->blob == NULL)
+			{
+			    spatialite_e
+				("Error while querying from \"%s\": out of memory\n",
+				 cvt->table_name);
+			    cvt_reset_batch (cvt, batch);
+			    return -1;
+			}
+		      if (value->size > 0)
+			  memcpy (value->blob, data, value->size);
+		      break;
+		  };
+	    }
+      }
+    return 1;
+}
+
+static int
+cvt_write_batch (struct cvt_pipe *cvt, struct cvt_batch *batch,
+		 sqlite3 * handle_out, sqlite3_stmt * stmt_out)
+{
+/* inserting all rows from a batch into the OUT table */
+    int ret;
+    int r;
+    int c;
+    struct cvt_value *value = batch->values;
+    for (r = 0; r < batch->rows; r++)
+      {
+	  sqlite3_reset (stmt_out);
+	  sqlite3_clear_bindings (stmt_out);
+	  for (c = 0; c < cvt->columns; c++, value++)
+	    {
+		/* binding column values */
+		switch (value->type)
+		  {
+		  case SQLITE_INTEGER:
+		      sqlite3_bind_int64 (stmt_out, c + 1, value->int_value);
+		      break;
+		  case SQLITE_FLOAT:
+		      sqlite3_bind_double (stmt_out, c + 1, value->dbl_value);
+		      break;
+		  case SQLITE_TEXT:
+		      sqlite3_bind_text (stmt_out, c + 1,
+					 (const char *) (value->blob),
+					 value->size, free);
+		      value->blob = NULL;
+		      break;
+		  case SQLITE_BLOB:
+		      sqlite3_bind_blob (stmt_out, c + 1, value->blob,
+					 value->size, free);
+		      value->blob = NULL;
+		      break;
+		  default:
+		      sqlite3_bind_null (stmt_out, c + 1);
+		      break;
+		  };
 	    }
+	  ret = sqlite3_step (stmt_out);
+	  if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	      ;
 	  else
 	    {
 		/* an unexpected error occurred */
-		spatialite_e ("Error while querying from \"%s\": %s\n",
-			      table_name, sqlite3_errmsg (handle_in));
-		goto stop;
+		spatialite_e ("Error while inserting into \"%s\": %s\n",
+			      cvt->table_name, sqlite3_errmsg (handle_out));
+		return 0;
+	    }
+      }
+    return 1;
+}
+
+SPLITE_THREAD_PROC (cvt_reader, arg)
+{
+/* the reader thread */
+    struct cvt_pipe *cvt = (struct cvt_pipe *) arg;
+    struct cvt_batch *batch;
+    int ret = 1;
+    while (ret > 0)
+      {
+	  splite_mutex_lock (&(cvt->mutex));
+	  while (cvt->count == CVT_QUEUE_SLOTS && !cvt->abort)
+	      splite_cond_wait (&(cvt->cond), &(cvt->mutex));
+	  if (cvt->abort)
+	    {
+		splite_mutex_unlock (&(cvt->mutex));
+		break;
+	    }
+	  batch = cvt->slots + ((cvt->head + cvt->count) % CVT_QUEUE_SLOTS);
+	  splite_mutex_unlock (&(cvt->mutex));
+
+	  /* the free slot is only owned by this thread until it gets queued */
+	  ret = cvt_read_batch (cvt, batch);
+
+	  splite_mutex_lock (&(cvt->mutex));
+	  cvt->count += 1;
+	  if (ret <= 0)
+	    {
+		cvt->eof = 1;
+		if (ret < 0)
+		    cvt->error = 1;
+	    }
+	  splite_cond_broadcast (&(cvt->cond));
+	  splite_mutex_unlock (&(cvt->mutex));
+      }
+    SPLITE_THREAD_RETURN;
+}
+
+static int
+do_pipe_rows (struct cvt_pipe *cvt, sqlite3 * handle_out,
+	      sqlite3_stmt * stmt_out)
+{
+/* draining all rows from the IN result set into the OUT table */
+    splite_thread_t reader;
+    struct cvt_batch *batch;
+    int ret;
+    int ok = 1;
+
+    if (sqlite3_threadsafe () == 0 || cvt->handle_in == handle_out
+	|| !splite_thread_start (&reader, cvt_reader, cvt))
+      {
+	  /* serial mode: the calling thread plays both roles */
+	  batch = cvt->slots;
+	  while (1)
+	    {
+		ret = cvt_read_batch (cvt, batch);
+		if (ret >= 0 && !cvt_write_batch (cvt, batch, handle_out,
+						  stmt_out))
+		    ret = -1;
+		cvt_reset_batch (cvt, batch);
+		if (ret <= 0)
+		    return (ret == 0) ? 1 : 0;
 	    }
       }
 
+    while (1)
+      {
+	  splite_mutex_lock (&(cvt->mutex));
+	  while (cvt->count == 0 && !cvt->eof)
+	      splite_cond_wait (&(cvt->cond), &(cvt->mutex));
+	  if (cvt->count == 0)
+	    {
+		/* the reader has already finished */
+		splite_mutex_unlock (&(cvt->mutex));
+		break;
+	    }
+	  batch = cvt->slots + cvt->head;
+	  splite_mutex_unlock (&(cvt->mutex));
+
+	  if (!cvt_write_batch (cvt, batch, handle_out, stmt_out))
+	      ok = 0;
+	  cvt_reset_batch (cvt, batch);
+
+	  splite_mutex_lock (&(cvt->mutex));
+	  cvt->head = (cvt->head + 1) % CVT_QUEUE_SLOTS;
+	  cvt->count -= 1;
+	  if (!ok)
+	      cvt->abort = 1;
+	  splite_cond_broadcast (&(cvt->cond));
+	  splite_mutex_unlock (&(cvt->mutex));
+	  if (!ok)
+	      break;
+      }
+    splite_thread_join (reader);
+    if (cvt->error)
+	ok = 0;
+    return ok;
+}
+
+static int
+do_copy_table (sqlite3 * handle_in, sqlite3 * handle_out,
+	       sqlite3_stmt * stmt_in, sqlite3_stmt * stmt_out,
+	       const char *table_name, int geom_col, int to_gpkg)
+{
+/* copying all rows from IN and OUT tables */
+    int ret;
+    int i;
+    int ok = 0;
+    char *sql_err = NULL;
+    struct cvt_pipe cvt;
+
+    memset (&cvt, 0, sizeof (struct cvt_pipe));
+    cvt.handle_in = handle_in;
+    cvt.stmt_in = stmt_in;
+    cvt.table_name = table_name;
+    cvt.columns = sqlite3_column_count (stmt_in);
+    cvt.geom_col = geom_col;
+    cvt.to_gpkg = to_gpkg;
+    for (i = 0; i < CVT_QUEUE_SLOTS; i++)
+      {
+	  cvt.slots[i].values =
+	      calloc (CVT_BATCH_ROWS * cvt.columns,
+		      sizeof (struct cvt_value));
+	  if (cvt.slots[i].values == NULL)
+	      goto stop;
+      }
+    splite_mutex_init (&(cvt.mutex));
+    splite_cond_init (&(cvt.cond));
+    ok = do_pipe_rows (&cvt, handle_out, stmt_out);
+    splite_mutex_destroy (&(cvt.mutex));
+    splite_cond_destroy (&(cvt.cond));
+
+  stop:
+    for (i = 0; i < CVT_QUEUE_SLOTS; i++)
+      {
+	  if (cvt.slots[i].values == NULL)
+	      continue;
+	  cvt_reset_batch (&cvt, cvt.slots + i);
+	  free (cvt.slots[i].values);
+      }
+    if (!ok)
+	goto rollback;
+
 /* committing the still pending transaction */
     ret = sqlite3_exec (handle_out, "COMMIT", NULL, NULL, &sql_err);
     if (ret != SQLITE_OK)
@@ -849,7 +1132,7 @@ do_copy_table (sqlite3 * handle_in, sqlite3 * handle_out,
       }
     return 1;
 
-  stop:
+  rollback:
 /* invalidating the still pending transaction */
     ret = sqlite3_exec (handle_out, "ROLLBACK", NULL, NULL, &sql_err);
     if (ret != SQLITE_OK)
@@ -907,6 +1190,7 @@ copy_spatialite2GPKG (sqlite3 * handle_in, sqlite3 * handle_out, int legacy)
     char *create_sql;
     sqlite3_stmt *stmt_in = NULL;
     sqlite3_stmt *stmt_out = NULL;
+    int geom_col;
 
     if (legacy)
       {
@@ -1063,16 +1347,18 @@ copy_spatialite2GPKG (sqlite3 * handle_in, sqlite3 * handle_out, int legacy)
 		      return 0;
 		  }
 		sqlite3_free (create_sql);
+		geom_col = -1;
 		if (!create_Spatialite2GPKG_statements
 		    (handle_in, handle_out, table_name, geometry_column,
-		     &stmt_in, &stmt_out))
+		     &stmt_in, &stmt_out, &geom_col))
 		  {
 		      /* error: unable to create the IN and OUT stmts */
 		      sqlite3_free_table (results);
 		      return 0;
 		  }
 		if (!do_copy_table
-		    (handle_in, handle_out, stmt_in, stmt_out, table_name))
+		    (handle_in, handle_out, stmt_in, stmt_out, table_name,
+		     geom_col, 1))
 		  {
 		      sqlite3_finalize (stmt_in);
 		      sqlite3_finalize (stmt_out);
@@ -1106,6 +1392,7 @@ copy_GPKG2Spatialite (sqlite3 * handle_in, sqlite3 * handle_out)
     char *create_sql;
     sqlite3_stmt *stmt_in = NULL;
     sqlite3_stmt *stmt_out = NULL;
+    int geom_col;
 
     sql = "SELECT table_name, column_name, geometry_type_name, "
 	"srs_id, z, m FROM gpkg_geometry_columns";
@@ -1158,16 +1445,18 @@ copy_GPKG2Spatialite (sqlite3 * handle_in, sqlite3 * handle_out)
 		      return 0;
 		  }
 		sqlite3_free (create_sql);
+		geom_col = -1;
 		if (!create_GPKG2Spatialite_statements
 		    (handle_in, handle_out, table_name, geometry_column,
-		     &stmt_in, &stmt_out))
+		     &stmt_in, &stmt_out, &geom_col))
 		  {
 		      /* error: unable to create the IN and OUT stmts */
 		      sqlite3_free_table (results);
 		      return 0;
 		  }
 		if (!do_copy_table
-		    (handle_in, handle_out, stmt_in, stmt_out, table_name))
+		    (handle_in, handle_out, stmt_in, stmt_out, table_name,
+		     geom_col, 0))
 		  {
 		      sqlite3_finalize (stmt_in);
 		      sqlite3_finalize (stmt_out);
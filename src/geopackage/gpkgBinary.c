@@ -37,6 +37,8 @@ the terms of any one of the MPL, the GPL or the LGPL.
  
 */
 
+#include <float.h>
+
 #include "spatialite/geopackage.h"
 #include "config.h"
 #include "geopackage_internal.h"
@@ -114,7 +116,6 @@ fnct_ToGPB (sqlite3_context * context, int argc, sqlite3_value ** argv)
 */
     unsigned char *p_blob;
     int n_bytes;
-    gaiaGeomCollPtr geo = NULL;
     int len;
     unsigned char *p_result = NULL;
     GEOPACKAGE_UNUSED ();	/* LCOV_EXCL_LINE */
@@ -125,25 +126,10 @@ fnct_ToGPB (sqlite3_context * context, int argc, sqlite3_value ** argv)
       }
     p_blob = (unsigned char *) sqlite3_value_blob (argv[0]);
     n_bytes = sqlite3_value_bytes (argv[0]);
-    geo = gaiaFromSpatiaLiteBlobWkb (p_blob, n_bytes);
-    if (!geo)
-      {
-	  sqlite3_result_null (context);
-	  return;
-      }
+    if (!gaiaSpatiaLiteBlobToGPB (p_blob, n_bytes, &p_result, &len))
+	sqlite3_result_null (context);
     else
-      {
-	  gaiaToGPB (geo, &p_result, &len);
-	  if (!p_result)
-	    {
-		sqlite3_result_null (context);
-	    }
-	  else
-	    {
-		sqlite3_result_blob (context, p_result, len, free);
-	    }
-      }
-    gaiaFreeGeomColl (geo);
+	sqlite3_result_blob (context, p_result, len, free);
 }
 
 static int
@@ -247,9 +233,7 @@ fnct_GeomFromGPB (sqlite3_context * context, int argc, sqlite3_value ** argv)
     int len;
     unsigned char *p_result = NULL;
     const unsigned char *gpb;
-    unsigned int gpb_len;
-    gaiaGeomCollPtr geo = NULL;
-
+    int gpb_len;
 
     GEOPACKAGE_UNUSED ();	/* LCOV_EXCL_LINE */
     if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
@@ -260,16 +244,365 @@ fnct_GeomFromGPB (sqlite3_context * context, int argc, sqlite3_value ** argv)
     gpb = sqlite3_value_blob (argv[0]);
     gpb_len = sqlite3_value_bytes (argv[0]);
 
-    geo = gaiaFromGeoPackageGeometryBlob (gpb, gpb_len);
-    if (geo == NULL)
+    if (!gaiaGPBToSpatiaLiteBlob (gpb, gpb_len, &p_result, &len))
+	sqlite3_result_null (context);
+    else
+	sqlite3_result_blob (context, p_result, len, free);
+}
+
+/*
+/ direct transcoding between SpatiaLite BLOB-Geometries and GPB
+/
+/ both formats carry the very same little-endian payload (the class
+/ type followed by counts and coordinates); they only differ in the
+/ header/envelope and in the one-byte mark preceding every item of a
+/ collection (0x69 for SpatiaLite, the WKB byte order for GPB).
+/ so a well-formed payload is simply copied as a whole and then
+/ patched in place while walking it, computing the MBR on the fly
+/ exactly as gaiaMbrGeometry() does.
+/ anything unusual (big-endian, compressed, GEOS-style Z codes, empty
+/ or heterogeneous items) is rejected here and left to the full
+/ decode/encode path, so that the output is always the same produced
+/ by gaiaToGPB() / gaiaToSpatiaLiteBlobWkb()
+*/
+
+struct gpb_transcoder
+{
+/* a struct supporting the direct transcoding */
+    unsigned char *buf;
+    int size;
+    int offset;
+    unsigned char mark_in;
+    unsigned char mark_out;
+    int endian_arch;
+    double min_x;
+    double min_y;
+    double max_x;
+    double max_y;
+};
+
+static int
+transcode_vertex_size (int type)
+{
+/* returns the size of a single vertex, 0 on unsupported types */
+    int base;
+    if (type < 1 || type > 3999)
+	return 0;
+    base = type % 1000;
+    if (base < 1 || base > 7)
+	return 0;
+    switch (type / 1000)
       {
-	  sqlite3_result_null (context);
-	  return;
+      case 0:
+	  return 16;
+      case 1:
+      case 2:
+	  return 24;
+      default:
+	  return 32;
+      };
+}
+
+static int
+transcode_vertices (struct gpb_transcoder *tc, int points, int vert_size,
+		    int mbr)
+{
+/* walking a sequence of vertices */
+    int iv;
+    double x;
+    double y;
+    const unsigned char *p;
+    if (points < 1)
+	return 0;
+    if (points > (tc->size - tc->offset) / vert_size)
+	return 0;
+    if (!mbr)
+      {
+	  /* interior rings never contribute to the MBR */
+	  tc->offset += points * vert_size;
+	  return 1;
+      }
+    p = tc->buf + tc->offset;
+    for (iv = 0; iv < points; iv++)
+      {
+	  x = gaiaImport64 (p, GAIA_LITTLE_ENDIAN, tc->endian_arch);
+	  y = gaiaImport64 (p + 8, GAIA_LITTLE_ENDIAN, tc->endian_arch);
+	  if (x < tc->min_x)
+	      tc->min_x = x;
+	  if (y < tc->min_y)
+	      tc->min_y = y;
+	  if (x > tc->max_x)
+	      tc->max_x = x;
+	  if (y > tc->max_y)
+	      tc->max_y = y;
+	  p += vert_size;
+      }
+    tc->offset += points * vert_size;
+    return 1;
+}
+
+static int
+transcode_count (struct gpb_transcoder *tc, int *count)
+{
+/* fetching a 32-bit count */
+    if (tc->size - tc->offset < 4)
+	return 0;
+    *count =
+	gaiaImport32 (tc->buf + tc->offset, GAIA_LITTLE_ENDIAN,
+		      tc->endian_arch);
+    tc->offset += 4;
+    return 1;
+}
+
+static int
+transcode_elementary (struct gpb_transcoder *tc, int type)
+{
+/* walking a Point, Linestring or Polygon */
+    int vert_size = transcode_vertex_size (type);
+    int count;
+    int nverts;
+    int ib;
+    switch (type % 1000)
+      {
+      case GAIA_POINT:
+	  return transcode_vertices (tc, 1, vert_size, 1);
+      case GAIA_LINESTRING:
+	  if (!transcode_count (tc, &count))
+	      return 0;
+	  return transcode_vertices (tc, count, vert_size, 1);
+      case GAIA_POLYGON:
+	  if (!transcode_count (tc, &count))
+	      return 0;
+	  if (count < 1)
+	      return 0;
+	  for (ib = 0; ib < count; ib++)
+	    {
+		if (!transcode_count (tc, &nverts))
+		    return 0;
+		if (!transcode_vertices (tc, nverts, vert_size, ib == 0))
+		    return 0;
+	    }
+	  return 1;
+      };
+    return 0;
+}
+
+static int
+transcode_geometry (struct gpb_transcoder *tc, int type)
+{
+/* walking the whole payload of some Geometry */
+    int base;
+    int count;
+    int ie;
+    int sub_type;
+    int sub_base;
+    int last_base = GAIA_POINT;
+    if (transcode_vertex_size (type) == 0)
+	return 0;
+    base = type % 1000;
+    if (base <= GAIA_POLYGON)
+	return transcode_elementary (tc, type);
+
+/* a MultiXX or GeometryCollection */
+    if (!transcode_count (tc, &count))
+	return 0;
+    if (count < 1)
+	return 0;
+    for (ie = 0; ie < count; ie++)
+      {
+	  if (tc->size - tc->offset < 5)
+	      return 0;
+	  if (*(tc->buf + tc->offset) != tc->mark_in)
+	      return 0;
+	  *(tc->buf + tc->offset) = tc->mark_out;
+	  sub_type =
+	      gaiaImport32 (tc->buf + tc->offset + 1, GAIA_LITTLE_ENDIAN,
+			    tc->endian_arch);
+	  tc->offset += 5;
+	  if (transcode_vertex_size (sub_type) == 0)
+	      return 0;
+	  if (sub_type / 1000 != type / 1000)
+	      return 0;		/* mismatching dimensions */
+	  sub_base = sub_type % 1000;
+	  if (base == GAIA_GEOMETRYCOLLECTION)
+	    {
+		/* items must already be ordered as Points, Linestrings, Polygons */
+		if (sub_base > GAIA_POLYGON || sub_base < last_base)
+		    return 0;
+		last_base = sub_base;
+	    }
+	  else if (sub_base != base - 3)
+	      return 0;
+	  if (!transcode_elementary (tc, sub_type))
+	      return 0;
       }
+    return 1;
+}
 
-    gaiaToSpatiaLiteBlobWkb (geo, &p_result, &len);
+static void
+transcode_init (struct gpb_transcoder *tc, unsigned char *buf, int size,
+		int offset, unsigned char mark_in, unsigned char mark_out)
+{
+/* initializing a transcoder */
+    tc->buf = buf;
+    tc->size = size;
+    tc->offset = offset;
+    tc->mark_in = mark_in;
+    tc->mark_out = mark_out;
+    tc->endian_arch = gaiaEndianArch ();
+    tc->min_x = DBL_MAX;
+    tc->min_y = DBL_MAX;
+    tc->max_x = -DBL_MAX;
+    tc->max_y = -DBL_MAX;
+}
+
+static int
+direct_blob_to_gpb (const unsigned char *blob, int blob_size,
+		    unsigned char **gpb, int *gpb_size)
+{
+/* directly transcoding a SpatiaLite BLOB into GPB */
+    struct gpb_transcoder tc;
+    unsigned char *out;
+    int out_size;
+    int payload;
+    int type;
+    int srid;
+    int endian_arch = gaiaEndianArch ();
+    if (blob_size < 45)
+	return 0;
+    if (*(blob + 0) != GAIA_MARK_START || *(blob + 38) != GAIA_MARK_MBR
+	|| *(blob + (blob_size - 1)) != GAIA_MARK_END)
+	return 0;
+    if (*(blob + 1) != GAIA_LITTLE_ENDIAN)
+	return 0;
+    srid = gaiaImport32 (blob + 2, GAIA_LITTLE_ENDIAN, endian_arch);
+    type = gaiaImport32 (blob + 39, GAIA_LITTLE_ENDIAN, endian_arch);
+
+/* class type and body will be copied as they are */
+    payload = blob_size - 40;
+    out_size = GEOPACKAGE_HEADER_LEN + GEOPACKAGE_2D_ENVELOPE_LEN + 1 + payload;
+    out = malloc (out_size);
+    if (out == NULL)
+	return 0;
+    gpkgSetHeader2DLittleEndian (out, srid, endian_arch);
+    *(out + GEOPACKAGE_HEADER_LEN + GEOPACKAGE_2D_ENVELOPE_LEN) = 0x01;
+    memcpy (out + GEOPACKAGE_HEADER_LEN + GEOPACKAGE_2D_ENVELOPE_LEN + 1,
+	    blob + 39, payload);
+    transcode_init (&tc, out, out_size,
+		    GEOPACKAGE_HEADER_LEN + GEOPACKAGE_2D_ENVELOPE_LEN + 5,
+		    GAIA_MARK_ENTITY, 0x01);
+    if (!transcode_geometry (&tc, type) || tc.offset != out_size)
+      {
+	  free (out);
+	  return 0;
+      }
+    gpkgSetHeader2DMbr (out + GEOPACKAGE_HEADER_LEN, tc.min_x, tc.min_y,
+			tc.max_x, tc.max_y, endian_arch);
+    *gpb = out;
+    *gpb_size = out_size;
+    return 1;
+}
+
+static int
+direct_gpb_to_blob (const unsigned char *gpb, int gpb_size,
+		    unsigned char **blob, int *blob_size)
+{
+/* directly transcoding a GPB into a SpatiaLite BLOB */
+    struct gpb_transcoder tc;
+    unsigned char *out;
+    int out_size;
+    const unsigned char *wkb;
+    int wkb_size;
+    int type;
+    int srid;
+    unsigned int envelope_length;
+    int endian_arch = gaiaEndianArch ();
+    if (!sanity_check_gpb (gpb, gpb_size, &srid, &envelope_length))
+	return 0;
+    if (!(*(gpb + 3) & GEOPACKAGE_WKB_LITTLEENDIAN))
+	return 0;
+    if (*(gpb + 3) & GEOPACKAGE_WKB_EMPTY_FLAG)
+	return 0;
+    wkb_size = gpb_size - (GEOPACKAGE_HEADER_LEN + (int) envelope_length);
+    if (wkb_size < 5)
+	return 0;
+    wkb = gpb + GEOPACKAGE_HEADER_LEN + envelope_length;
+    if (*(wkb + 0) != 0x01)
+	return 0;
+    type = gaiaImport32 (wkb + 1, GAIA_LITTLE_ENDIAN, endian_arch);
+
+/* class type and body will be copied as they are */
+    out_size = 39 + (wkb_size - 1) + 1;
+    out = malloc (out_size);
+    if (out == NULL)
+	return 0;
+    *(out + 0) = GAIA_MARK_START;
+    *(out + 1) = GAIA_LITTLE_ENDIAN;
+    gaiaExport32 (out + 2, srid, GAIA_LITTLE_ENDIAN, endian_arch);
+    *(out + 38) = GAIA_MARK_MBR;
+    memcpy (out + 39, wkb + 1, wkb_size - 1);
+    *(out + (out_size - 1)) = GAIA_MARK_END;
+    transcode_init (&tc, out, out_size - 1, 43, 0x01, GAIA_MARK_ENTITY);
+    if (!transcode_geometry (&tc, type) || tc.offset != out_size - 1)
+      {
+	  free (out);
+	  return 0;
+      }
+    gaiaExport64 (out + 6, tc.min_x, GAIA_LITTLE_ENDIAN, endian_arch);
+    gaiaExport64 (out + 14, tc.min_y, GAIA_LITTLE_ENDIAN, endian_arch);
+    gaiaExport64 (out + 22, tc.max_x, GAIA_LITTLE_ENDIAN, endian_arch);
+    gaiaExport64 (out + 30, tc.max_y, GAIA_LITTLE_ENDIAN, endian_arch);
+    *blob = out;
+    *blob_size = out_size;
+    return 1;
+}
+
+GEOPACKAGE_DECLARE int
+gaiaSpatiaLiteBlobToGPB (const unsigned char *blob, int blob_size,
+			 unsigned char **gpb, int *gpb_size)
+{
+/* converting a SpatiaLite BLOB-Geometry into GPB */
+    gaiaGeomCollPtr geo;
+    *gpb = NULL;
+    *gpb_size = 0;
+    if (blob == NULL)
+	return 0;
+    if (direct_blob_to_gpb (blob, blob_size, gpb, gpb_size))
+	return 1;
+
+/* full decoding and re-encoding */
+    geo = gaiaFromSpatiaLiteBlobWkb (blob, blob_size);
+    if (geo == NULL)
+	return 0;
+    gaiaToGPB (geo, gpb, gpb_size);
     gaiaFreeGeomColl (geo);
-    sqlite3_result_blob (context, p_result, len, free);
+    if (*gpb == NULL)
+	return 0;
+    return 1;
+}
+
+GEOPACKAGE_DECLARE int
+gaiaGPBToSpatiaLiteBlob (const unsigned char *gpb, int gpb_size,
+			 unsigned char **blob, int *blob_size)
+{
+/* converting a GPB into a SpatiaLite BLOB-Geometry */
+    gaiaGeomCollPtr geo;
+    *blob = NULL;
+    *blob_size = 0;
+    if (gpb == NULL)
+	return 0;
+    if (direct_gpb_to_blob (gpb, gpb_size, blob, blob_size))
+	return 1;
+
+/* full decoding and re-encoding */
+    geo = gaiaFromGeoPackageGeometryBlob (gpb, gpb_size);
+    if (geo == NULL)
+	return 0;
+    gaiaToSpatiaLiteBlobWkb (geo, blob, blob_size);
+    gaiaFreeGeomColl (geo);
+    if (*blob == NULL)
+	return 0;
+    return 1;
 }
 
 /* Sandro Furieri - 2014-05-19 */
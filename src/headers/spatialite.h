@@ -69,6 +69,13 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #define SPLITE_AXIS_NAME	0x3e
 #define SPLITE_AXIS_ORIENTATION	0x3f
 
+/** update_layer_statistics_ex: full table scan */
+#define SPLITE_STATS_FULL		0
+/** update_layer_statistics_ex: only folding in rows added since last run */
+#define SPLITE_STATS_INCREMENTAL	1
+/** update_layer_statistics_ex: approximating from a sample of rows */
+#define SPLITE_STATS_SAMPLED		2
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -645,13 +652,17 @@ extern "C"
  Inserts the inlined EPSG dataset into the "spatial_ref_sys" table
 
  \param sqlite handle to current DB connection
- \param mode can be one of GAIA_EPSG_ANY, GAIA_EPSG_NONE or GAIA_EPSG_WGS84_ONLY
+ \param mode can be one of GAIA_EPSG_ANY, GAIA_EPSG_NONE, GAIA_EPSG_WGS84_ONLY
+ or GAIA_EPSG_LAZY
  \param verbose if TRUE a short report is shown on stderr
 
  \return 0 on failure, any other value on success
 
  \note this function is internally invoked by the SQL function 
   InitSpatialMetadata(), and is not usually intended for direct use.
+ \n GAIA_EPSG_LAZY inserts only the WGS84-related definitions; any other
+ EPSG SRID will then be inserted on demand the first time it is
+ referenced by AddGeometryColumn(), RecoverGeometryColumn() or Transform().
  */
     SPATIALITE_DECLARE int spatial_ref_sys_init2 (sqlite3 * sqlite, int mode,
 						  int verbose);
@@ -1106,6 +1117,41 @@ extern "C"
 						    const char *table,
 						    const char *column);
 
+/**
+ Updates the LAYER_STATICS metadata table (incremental / sampled modes)
+
+ \param sqlite handle to current DB connection
+ \param table name of the table to be processed
+ \param column name of the geometry to be processed
+ \param mode one of SPLITE_STATS_FULL, SPLITE_STATS_INCREMENTAL or
+ SPLITE_STATS_SAMPLED
+ \param sample_rate the fraction of rows to be examined (0.0 < rate <= 1.0);
+ only meaningful in SPLITE_STATS_SAMPLED mode.
+
+ \note SPLITE_STATS_FULL is exactly the same as update_layer_statistics().
+ SPLITE_STATS_INCREMENTAL will only fold in rows whose ROWID is greater 
+ than the one recorded by the previous run (the watermark stored into the
+ GEOMETRY_COLUMNS_WATERMARK table, implicitly created on first use); a full 
+ scan will be performed anyway if any UPDATE or DELETE was registered by 
+ GEOMETRY_COLUMNS_TIME, if the table layout changed or if the row count
+ does not match.
+ SPLITE_STATS_SAMPLED will take the exact row count, the extent from the
+ root node of the Spatial Index (if any) and will approximate all FIELD_INFOS
+ by examining only a sample of rows evenly spread across the ROWID range.
+ \n Both modes only apply to ordinary tables supported by current style
+ metadata; Spatial Views, VirtualShapes and legacy metadata layouts will
+ always be fully scanned.
+
+ \sa update_layer_statistics
+
+ \return 0 on failure, any other value on success
+ */
+    SPATIALITE_DECLARE int update_layer_statistics_ex (sqlite3 * sqlite,
+						       const char *table,
+						       const char *column,
+						       int mode,
+						       double sample_rate);
+
 /**
  Immediately and unconditionally invalidates the already existing Statistics
 
@@ -1671,6 +1717,57 @@ extern "C"
 				       int transaction, int ram_tmp_store,
 				       char **message);
 
+/**
+  Will precisely cut the input dataset against polygonal blade(s)
+  distributing all GEOS computations on many worker threads
+  
+ \param db_handle handle to the current SQLite connection
+ \param cache a memory pointer returned by spatialite_alloc_connection()
+ \param in_db_prefix prefix of the database where the input table
+ is expected to be found. if NULL then "MAIN" will be assumed.
+ \param input_table name of the input table to be processed.
+ \param input_geometry name of the input table Geometry column;
+ it could be NULL.
+ \param blade_db_prefix prefix of the database where the "blade" table
+ is expected to be found. if NULL then "MAIN" will be assumed.
+ \param blade_table name of the table expected to contain Polygons
+ or MultiPolygon Geometries acting as blades.
+ \param blade_geometry name of the "blade" table Geometry column;
+ it could be NULL.
+ \param output_table name to assinged to the destination table intended
+ to permanently store all results. this table must non exists.
+ \param transaction boolean; if set to TRUE will internally handle
+ a SQL Transaction.
+ \param ram_tmp_store boolean: if set to TRUE all TEMPORARY tables
+ and indices will be created in RAM, otherwise in a file.
+ \param num_threads max number of concurrent threads computing
+ Intersections and Differences.
+ \param message pointer to a string buffer; if not NULL it will point
+ on completion an eventual error message.
+ 
+ \return 0 on failure, any other value on success
+ 
+ \sa gaiaCutter
+ 
+ \note all the SQL activity is still performed by the calling thread;
+ worker threads are just intended to compute all the Intersections between
+ Input and Blade geometries and the Differences recovering the uncovered
+ portions, so the results are exactly the same returned by gaiaCutter().
+ passing a num_threads value of 1 (or less) is the same as calling
+ gaiaCutter().
+ */
+    SPATIALITE_DECLARE int gaiaCutterEx (sqlite3 * db_handle,
+					 const void *cache,
+					 const char *in_db_prefix,
+					 const char *input_table,
+					 const char *input_geom,
+					 const char *blade_db_prefix,
+					 const char *blade_table,
+					 const char *blade_geom,
+					 const char *output_table,
+					 int transaction, int ram_tmp_store,
+					 int num_threads, char **message);
+
 /**
   Will attempt to create a VirtualRouting from an input table
   
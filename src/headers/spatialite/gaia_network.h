@@ -234,6 +234,57 @@ extern "C"
  */
     GAIANET_DECLARE void gaiaNetworkDestroy (GaiaNetworkAccessorPtr ptr);
 
+/**
+ creates a memory-resident replica of an already existing Topology-Network
+
+ \param ptr pointer to the Topology-Network Accessor Object to be replicated.
+
+ \return the pointer to a Topology-Network Accessor Object working on a
+ private in-memory DB: NULL on failure.
+
+ \note all Nodes and Links are copied into a private in-memory DB, so that
+ any subsequent editing operation will never touch the main DB.
+ The in-memory replica must be explicitly written back by calling
+ gaiaNetworkMemoryFlush(), and must always be destroyed by calling
+ gaiaNetworkMemoryDestroy().
+
+ \sa gaiaNetworkFromDBMS, gaiaNetworkMemoryFlush, gaiaNetworkMemoryDestroy
+ */
+    GAIANET_DECLARE GaiaNetworkAccessorPtr
+	gaiaNetworkMemoryCreate (GaiaNetworkAccessorPtr ptr);
+
+/**
+ writes back a memory-resident Topology-Network replica into its own DB
+
+ \param ptr pointer to the Topology-Network Accessor Object returned by
+ gaiaNetworkMemoryCreate().
+
+ \return 0 on failure: any other value on success.
+
+ \note Nodes and Links will be inserted, updated or deleted accordingly
+ to their current state in the replica; unchanged items are never
+ rewritten. Wrapping the call within a transaction (or a SAVEPOINT)
+ is strongly recommended.
+
+ \sa gaiaNetworkMemoryCreate, gaiaNetworkMemoryDestroy
+ */
+    GAIANET_DECLARE int gaiaNetworkMemoryFlush (GaiaNetworkAccessorPtr ptr);
+
+/**
+ destroys a memory-resident Topology-Network replica
+
+ \param ptr pointer to the Topology-Network Accessor Object returned by
+ gaiaNetworkMemoryCreate().
+
+ \note any pending error message will be forwarded to the main
+ Topology-Network Accessor Object. Not yet flushed changes will be
+ discarded.
+
+ \sa gaiaNetworkMemoryCreate, gaiaNetworkMemoryFlush
+ */
+    GAIANET_DECLARE void gaiaNetworkMemoryDestroy (GaiaNetworkAccessorPtr
+						   ptr);
+
 /**
  Adds an isolated node into the Topology-Network
 
@@ -440,6 +491,28 @@ extern "C"
  */
     GAIANET_DECLARE int gaiaValidLogicalNet (GaiaNetworkAccessorPtr ptr);
 
+/**
+ Creates a temporary table containing a validation report for a given 
+ Logical TopoNet - Extended mode.
+
+ \param ptr pointer to the Topology Accessor Object.
+ \param num_threads max number of concurrent threads. If greater than 1
+ each check will be performed on its own read-only connection.
+ \param progress_callback an optional callback function to be invoked
+ each time that a check is completed (could be NULL).
+ \param callback_ptr an arbitrary pointer to be passed to the
+ callback function.
+
+ \return 1 on success; 0 on failure.
+
+ \sa gaiaNetworkFromDBMS, gaiaValidLogicalNet
+ */
+    GAIANET_DECLARE int gaiaValidLogicalNetEx (GaiaNetworkAccessorPtr ptr,
+					       int num_threads,
+					       void (*progress_callback) (int,
+									  void *),
+					       void *callback_ptr);
+
 /**
  Creates a temporary table containing a validation report for a given 
  Spatial TopoNet.
@@ -452,6 +525,28 @@ extern "C"
  */
     GAIANET_DECLARE int gaiaValidSpatialNet (GaiaNetworkAccessorPtr ptr);
 
+/**
+ Creates a temporary table containing a validation report for a given 
+ Spatial TopoNet - Extended mode.
+
+ \param ptr pointer to the Topology Accessor Object.
+ \param num_threads max number of concurrent threads. If greater than 1
+ each check will be performed on its own read-only connection.
+ \param progress_callback an optional callback function to be invoked
+ each time that a check is completed (could be NULL).
+ \param callback_ptr an arbitrary pointer to be passed to the
+ callback function.
+
+ \return 1 on success; 0 on failure.
+
+ \sa gaiaNetworkFromDBMS, gaiaValidSpatialNet
+ */
+    GAIANET_DECLARE int gaiaValidSpatialNetEx (GaiaNetworkAccessorPtr ptr,
+					       int num_threads,
+					       void (*progress_callback) (int,
+									  void *),
+					       void *callback_ptr);
+
 /**
  Find the ID of a NetNode at a Point location
 
@@ -222,6 +222,57 @@ extern "C"
  */
     GAIATOPO_DECLARE void gaiaTopologyDestroy (GaiaTopologyAccessorPtr ptr);
 
+/**
+ creates a memory-resident replica of an already existing Topology
+
+ \param ptr pointer to the Topology Accessor Object to be replicated.
+
+ \return the pointer to a Topology Accessor Object working on a private
+ in-memory DB: NULL on failure.
+
+ \note all Faces, Nodes and Edges are copied into a private in-memory DB,
+ so that any subsequent editing operation will never touch the main DB.
+ The in-memory replica must be explicitly written back by calling
+ gaiaTopologyMemoryFlush(), and must always be destroyed by calling
+ gaiaTopologyMemoryDestroy().
+
+ \sa gaiaTopologyFromDBMS, gaiaTopologyMemoryFlush, gaiaTopologyMemoryDestroy
+ */
+    GAIATOPO_DECLARE GaiaTopologyAccessorPtr
+	gaiaTopologyMemoryCreate (GaiaTopologyAccessorPtr ptr);
+
+/**
+ writes back a memory-resident Topology replica into its own DB
+
+ \param ptr pointer to the Topology Accessor Object returned by
+ gaiaTopologyMemoryCreate().
+
+ \return 0 on failure: any other value on success.
+
+ \note Faces, Nodes and Edges will be inserted, updated or deleted
+ accordingly to their current state in the replica; unchanged items
+ are never rewritten. Wrapping the call within a transaction (or
+ a SAVEPOINT) is strongly recommended.
+
+ \sa gaiaTopologyMemoryCreate, gaiaTopologyMemoryDestroy
+ */
+    GAIATOPO_DECLARE int gaiaTopologyMemoryFlush (GaiaTopologyAccessorPtr
+						  ptr);
+
+/**
+ destroys a memory-resident Topology replica
+
+ \param ptr pointer to the Topology Accessor Object returned by
+ gaiaTopologyMemoryCreate().
+
+ \note any pending error message will be forwarded to the Internal Cache
+ of the main DB connection. Not yet flushed changes will be discarded.
+
+ \sa gaiaTopologyMemoryCreate, gaiaTopologyMemoryFlush
+ */
+    GAIATOPO_DECLARE void gaiaTopologyMemoryDestroy (GaiaTopologyAccessorPtr
+						     ptr);
+
 /**
  Adds an isolated node into the Topology
 
@@ -718,6 +769,46 @@ extern "C"
 					double tolerance, int line_max_points,
 					double max_length);
 
+/**
+ Populates a Topology by importing a whole GeoTable - Partitioned mode
+
+ \param ptr pointer to the Topology Accessor Object.
+ \param db_prefix prefix of the DB containing the input GeoTable.
+ If NULL the "main" DB will be intended by default.
+ \param table name of the input GeoTable.
+ \param column name of the input Geometry Column.
+ Could be NULL is the input table has just a single Geometry Column.
+ \param tolerance approximation factor.
+ \param line_max_points if set to a positive number all input Linestrings
+ and/or Polygon Rings will be split into simpler Linestrings having no more 
+ than this maximum number of points. 
+ \param max_length if set to a positive value all input Linestrings 
+ and/or Polygon Rings will be split into simpler Lines having a length
+ not exceeding this threshold.
+ \param tiles the full extent of the input GeoTable will be split into
+ a grid of tiles x tiles rectangles.
+ \param num_threads max number of concurrent threads building the
+ Topology of each single tile.
+
+ \return 1 on success; 0 on failure.
+
+ \note the target Topology is expected to be empty. Each tile is built 
+ in its own in-memory Topology, then all tiles are merged by stitching 
+ all Edges laying along the seams and finally all Faces are determined
+ at once.
+
+ \sa gaiaTopologyFromDBMS, gaiaTopoGeo_FromGeoTable, gaiaTopoGeo_Polygonize
+ */
+    GAIATOPO_DECLARE int
+	gaiaTopoGeo_FromGeoTablePartitioned (GaiaTopologyAccessorPtr ptr,
+					     const char *db_prefix,
+					     const char *table,
+					     const char *column,
+					     double tolerance,
+					     int line_max_points,
+					     double max_length, int tiles,
+					     int num_threads);
+
 /**
  Populates a Topology by importing a whole GeoTable - Extended mode
 
@@ -828,6 +919,31 @@ extern "C"
  */
     GAIATOPO_DECLARE int gaiaValidateTopoGeo (GaiaTopologyAccessorPtr ptr);
 
+/**
+ Creates a temporary table containing a validation report for a given 
+ TopoGeo - Extended mode.
+
+ \param ptr pointer to the Topology Accessor Object.
+ \param num_threads max number of concurrent threads. If greater than 1
+ each check will be performed on its own read-only connection.
+ \param progress_callback an optional callback function to be invoked
+ each time that a check is completed (could be NULL).
+ \param callback_ptr an arbitrary pointer to be passed to the
+ callback function.
+
+ \return 1 on success; 0 on failure.
+
+ \note concurrent checks silently fall back to sequential mode for
+ memory-resident DBs or when some uncommitted change is pending.
+
+ \sa gaiaTopologyFromDBMS, gaiaValidateTopoGeo
+ */
+    GAIATOPO_DECLARE int gaiaValidateTopoGeoEx (GaiaTopologyAccessorPtr ptr,
+						int num_threads,
+						void (*progress_callback) (int,
+									   void *),
+						void *callback_ptr);
+
 /**
  Return a Point geometry (seed) identifying a Topology Edge
 
@@ -658,6 +658,31 @@ extern "C"
 					    int size, char *latlong,
 					    int ll_size);
 
+/**
+ Quickly checks a JPEG photo for EXIF and GPS position
+
+ \param blob the BLOB to be parsed (may be just the leading part of a file)
+ \param size length of the BLOB (in bytes)
+ \param exif on completion will be set to TRUE if a valid EXIF header
+ was found, FALSE if not
+ \param gps on completion will be set to TRUE if a valid GPS position
+ was found, FALSE if not
+ \param longitude if gps is TRUE will contain the longitude coordinate
+ \param latitude if gps is TRUE will contain the latitude coordinate
+
+ \return 0 if some EXIF offset lies beyond the end of the BLOB (i.e. a
+ truncated BLOB): any other value on success
+
+ \sa gaiaGetGpsCoords
+
+ \note this one doesn't allocate any memory; exactly the same results
+ returned by gaiaGetGpsCoords() will be reported.
+ */
+    GAIAEXIF_DECLARE int gaiaScanExifGps (const unsigned char *blob,
+					  int size, int *exif, int *gps,
+					  double *longitude,
+					  double *latitude);
+
 #ifdef __cplusplus
 }
 #endif
@@ -182,6 +182,20 @@ extern "C"
 	gaiaToGPB (gaiaGeomCollPtr geom, unsigned char **result, int *size);
 /* end Sandro Furieri - 2015-06-14 */
 
+/*
+ converting between SpatiaLite BLOB-Geometries and GPB: well-formed
+ little-endian payloads are directly transcoded (header and item marks
+ only), anything else is fully decoded and re-encoded.
+ both return 1 on success (the result must be released by calling free),
+ 0 if the input isn't a valid Geometry
+*/
+    GEOPACKAGE_DECLARE int
+	gaiaSpatiaLiteBlobToGPB (const unsigned char *blob, int blob_size,
+				 unsigned char **gpb, int *gpb_size);
+    GEOPACKAGE_DECLARE int
+	gaiaGPBToSpatiaLiteBlob (const unsigned char *gpb, int gpb_size,
+				 unsigned char **blob, int *blob_size);
+
 
 
 /* Markers for unused arguments / variable */
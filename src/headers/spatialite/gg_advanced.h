@@ -1322,6 +1322,101 @@ extern "C"
 							unsigned char *blob2,
 							int size2);
 
+/**
+ Spatial relationship evalution: batch evaluation (GEOSPreparedGeometry)
+
+ \param p_cache a memory pointer returned by spatialite_alloc_connection()
+ \param predicate the Spatial Predicate to be evaluated: one of 
+ GAIA_PREDICATE_INTERSECTS, GAIA_PREDICATE_DISJOINT, GAIA_PREDICATE_CONTAINS,
+ GAIA_PREDICATE_WITHIN, GAIA_PREDICATE_COVERS, GAIA_PREDICATE_COVEREDBY,
+ GAIA_PREDICATE_TOUCHES, GAIA_PREDICATE_CROSSES or GAIA_PREDICATE_OVERLAPS
+ \param reference the reference Geometry object (will be prepared just once)
+ \param candidates an array of candidate Geometry objects
+ \param count number of items into the candidates array
+ \param results an array of at least \e count items: on completion will
+ contain the outcome of Predicate(reference, candidate) for each candidate 
+ (1 if TRUE, 0 if FALSE, -1 on invalid candidate).
+
+ \return 0 on failure: any other value on success.
+
+ \sa gaiaGeomCollPreparedIntersects
+
+ \note reentrant and thread-safe.
+ 
+ \remark \b GEOS support required.
+ */
+    GAIAGEO_DECLARE int gaiaGeomCollPreparedPredicateBatch (const void
+							    *p_cache,
+							    int predicate,
+							    gaiaGeomCollPtr
+							    reference,
+							    gaiaGeomCollPtr *
+							    candidates,
+							    int count,
+							    int *results);
+
+/**
+ Creates a Point-in-Polygon join index
+
+ \param polygons an array of Geometry objects (only the ones of the 
+ Polygon or MultiPolygon type will be indexed, any other will be ignored)
+ \param count number of items into the polygons array
+
+ \return an opaque pointer to the join index, or NULL on failure.
+
+ \sa gaiaPointInPolygonJoin, gaiaFreePointInPolygonJoin
+
+ \note the join index simply references the input Polygons, that must
+ be kept alive until gaiaFreePointInPolygonJoin() is called.
+
+ \remark \b GEOS support required.
+ */
+    GAIAGEO_DECLARE void *gaiaCreatePointInPolygonJoin (gaiaGeomCollPtr *
+							polygons, int count);
+
+/**
+ Destroys a Point-in-Polygon join index
+
+ \param join pointer to the join index to be destroyed
+
+ \sa gaiaCreatePointInPolygonJoin
+
+ \remark \b GEOS support required.
+ */
+    GAIAGEO_DECLARE void gaiaFreePointInPolygonJoin (void *join);
+
+/**
+ Joins a set of Points against a Point-in-Polygon join index
+
+ \param p_cache a memory pointer returned by spatialite_alloc_connection()
+ \param join pointer to a join index returned by gaiaCreatePointInPolygonJoin()
+ \param x array of X coordinates (one for each Point)
+ \param y array of Y coordinates (one for each Point)
+ \param n_points number of Points
+ \param num_threads number of parallel threads to be used (max 64)
+ \param pairs on completion will point to an array of matching pairs;
+ each pair is made of two items: the index of the Point and the index
+ of the Polygon (as in the array passed to gaiaCreatePointInPolygonJoin)
+ containing it. Pairs are sorted by Point then by Polygon.
+ \param n_pairs on completion will contain the number of matching pairs.
+
+ \return 0 on failure: any other value on success.
+
+ \sa gaiaCreatePointInPolygonJoin, gaiaGeomCollContains_r
+
+ \note reentrant and thread-safe.
+ \n a Point lying on the boundary of some Polygon will never be considered
+ to be contained by it (exactly as gaiaGeomCollContains_r would do).
+ \n you are responsible to free() the array of pairs.
+
+ \remark \b GEOS support required.
+ */
+    GAIAGEO_DECLARE int gaiaPointInPolygonJoin (const void *p_cache,
+						void *join, const double *x,
+						const double *y, int n_points,
+						int num_threads, int **pairs,
+						int *n_pairs);
+
 /**
  Spatial relationship evalution: Overlaps
 
@@ -1518,6 +1613,10 @@ extern "C"
  \sa gaiaGeomCollContains, gaiaGeomCollContains_r
 
  \note reentrant and thread-safe.
+ \n a single Point evaluated against a (Multi)Polygon will be directly
+ resolved by a native Point-in-Polygon test (based on an edge index
+ cached together with the Polygon); GEOS will be invoked only when
+ the Point lies on (or very close to) the Polygon's boundary.
  
  \remark \b GEOS support required.
  */
@@ -1587,6 +1686,10 @@ extern "C"
  \sa gaiaGeomCollWithin, gaiaGeomCollWithin_r
 
  \note reentrant and thread-safe.
+ \n a single Point evaluated against a (Multi)Polygon will be directly
+ resolved by a native Point-in-Polygon test (based on an edge index
+ cached together with the Polygon); GEOS will be invoked only when
+ the Point lies on (or very close to) the Polygon's boundary.
  
  \remark \b GEOS support required.
  */
@@ -3277,6 +3380,35 @@ extern "C"
 							 double origin_y,
 							 double size, int mode);
 
+/**
+ Utility function: Subdivide
+   
+ \param p_cache a memory pointer returned by spatialite_alloc_connection()
+ \param geom the Geometry to be subdivided.
+ \param max_vertices the max number of vertices allowed for each piece
+ (cannot be less than 5).
+ \param num_threads number of concurrent threads to be used; any value
+ less than 2 implies sequential processing.
+ 
+ \return the pointer to newly created Geometry object: NULL on failure.
+ \n the returned Geometry will contain all pieces obtained by recursively
+ clipping the input Geometry into quadrants until each piece contains no
+ more than max_vertices; the same pieces will be returned in the same
+ order independently from the number of threads.
+ \n NULL will be returned if any argument is invalid.
+
+ \sa gaiaFreeGeomColl
+
+ \note you are responsible to destroy (before or after) any allocated Geometry,
+ this including any Geometry returned by gaiaSubdivide()\n
+ reentrant and thread-safe.
+
+ */
+    GAIAGEO_DECLARE gaiaGeomCollPtr gaiaSubdivide (const void *p_cache,
+						   gaiaGeomCollPtr geom,
+						   int max_vertices,
+						   int num_threads);
+
 #endif				/* end GEOS advanced features */
 
 #ifndef DOXYGEN_SHOULD_IGNORE_THIS
@@ -421,6 +421,26 @@ extern "C"
 /** Convert all DBF column names to UpperCase */
 #define GAIA_DBF_COLNAME_UPPERCASE	2
 
+/* constants used for batch Spatial Predicates */
+/** Spatial Predicate: Intersects */
+#define GAIA_PREDICATE_INTERSECTS	1
+/** Spatial Predicate: Disjoint */
+#define GAIA_PREDICATE_DISJOINT		2
+/** Spatial Predicate: Contains */
+#define GAIA_PREDICATE_CONTAINS		3
+/** Spatial Predicate: Within */
+#define GAIA_PREDICATE_WITHIN		4
+/** Spatial Predicate: Covers */
+#define GAIA_PREDICATE_COVERS		5
+/** Spatial Predicate: CoveredBy */
+#define GAIA_PREDICATE_COVEREDBY	6
+/** Spatial Predicate: Touches */
+#define GAIA_PREDICATE_TOUCHES		7
+/** Spatial Predicate: Crosses */
+#define GAIA_PREDICATE_CROSSES		8
+/** Spatial Predicate: Overlaps */
+#define GAIA_PREDICATE_OVERLAPS		9
+
 /* macros */
 /**
  macro extracting XY coordinates
@@ -1886,7 +1886,7 @@ extern "C"
  \param lat2 Latitude of second Point.
  \param lon2 Longitude of second Point.
 
- \return the calculated Geodesic Distance.
+ \return the calculated Geodesic Distance: a negative value on failure.
 
  \sa gaiaEllipseParams, gaiaGreatCircleDistance, gaiaGreatCircleTotalLength,
  gaiaGeodesicTotalLength
@@ -1899,6 +1899,62 @@ extern "C"
 						 double lon1, double lat2,
 						 double lon2);
 
+/**
+ Calculates the Great Circle Distances for an array of Point pairs
+
+ \param a first geodesic parameter.
+ \param b second geodesic parameter.
+ \param count number of Point pairs.
+ \param lat1 array of Latitudes of first Points.
+ \param lon1 array of Longitudes of first Points.
+ \param lat2 array of Latitudes of second Points.
+ \param lon2 array of Longitudes of second Points.
+ \param dist on completion this array will contain the calculated
+ Great Circle Distances (\b count items).
+
+ \sa gaiaGreatCircleDistance, gaiaGeodesicDistances
+
+ \note the same as calling gaiaGreatCircleDistance() for each pair,
+ but all Ellipsoid-related terms are evaluated just once.
+ */
+    GAIAGEO_DECLARE void gaiaGreatCircleDistances (double a, double b,
+						   int count,
+						   const double *lat1,
+						   const double *lon1,
+						   const double *lat2,
+						   const double *lon2,
+						   double *dist);
+
+/**
+ Calculates the Geodesic Distances for an array of Point pairs
+
+ \param a first geodesic parameter.
+ \param b second geodesic parameter.
+ \param rf third geodesic parameter.
+ \param count number of Point pairs.
+ \param lat1 array of Latitudes of first Points.
+ \param lon1 array of Longitudes of first Points.
+ \param lat2 array of Latitudes of second Points.
+ \param lon2 array of Longitudes of second Points.
+ \param dist on completion this array will contain the calculated
+ Geodesic Distances (\b count items).
+
+ \return 0 if the formula failed to converge or PROJ.4 returned NaN
+ for any pair (the corresponding distance will be negative): any other
+ value on success.
+
+ \sa gaiaGeodesicDistance, gaiaGreatCircleDistances
+
+ \note the same as calling gaiaGeodesicDistance() for each pair,
+ but the Ellipsoid is initialized just once.
+ */
+    GAIAGEO_DECLARE int gaiaGeodesicDistances (double a, double b, double rf,
+					       int count, const double *lat1,
+					       const double *lon1,
+					       const double *lat2,
+					       const double *lon2,
+					       double *dist);
+
 /**
  Calculates the Great Circle Total Length for a Linestring / Ring
 
@@ -1934,7 +1990,7 @@ extern "C"
  \param coords pointed to COORD mem-array
  \param vert number of Points (aka Vertices) within the COORD mem-array
 
- \return the calculated Geodesic Total Length.
+ \return the calculated Geodesic Total Length: a negative value on failure.
 
  \sa gaiaEllipseParams, gaiaGreatCircleDistance, gaiaGeodesicDistance,
  gaiaGreatCircleTotalLength
@@ -77,6 +77,8 @@ extern "C"
 #define GAIA_DXF_RING_LINKED		7
 /** apply special "unlinked rings" handling */
 #define GAIA_DXF_RING_UNLINKED		8
+/** max number of concurrent threads when importing DXF files */
+#define GAIA_DXF_MAX_THREADS		64
 
 
 /** DXF version [Writer] */
@@ -635,6 +637,8 @@ extern "C"
 	gaiaDxfHatchPtr curr_hatch;
 /** internal parser variable */
 	int undeclared_layers;
+/** internal parser variable: memory arena for DXF Points */
+	void *arena;
     } gaiaDxfParser;
 /**
  Typedef for DXF Layer object
@@ -770,6 +774,55 @@ extern "C"
 					       gaiaDxfParserPtr parser,
 					       int mode, int append);
 
+/**
+ Populating a DB so to permanently store all Geometries from a DXF Parser
+ using many threads for encoding Geometries
+
+ \param db_handle handle to a valid DB connection
+ \param parser pointer to DXF Parser object
+ \param mode should be one of GAIA_DXF_IMPORT_BY_LAYER or GAIA_DXF_IMPORT_MIXED
+ \param append boolean flag: if set and some required DB table already exists 
+  will attempt to append further rows into the existing table.
+  otherwise an error will be returned.
+ \param num_threads max number of worker threads encoding Text, Point,
+  Line and Polygon Geometries; 1 (or less) means no worker threads.
+
+ \return 0 on failure, any other value on success
+
+ \sa gaiaLoadFromDxfParser
+
+ \note the calling thread will always be the only one accessing the DB;
+ the resulting tables are exactly the same produced by gaiaLoadFromDxfParser
+ */
+    GAIAGEO_DECLARE int gaiaLoadFromDxfParserEx (sqlite3 * db_handle,
+						 gaiaDxfParserPtr parser,
+						 int mode, int append,
+						 int num_threads);
+
+/**
+ Concurrently parsing many DXF files
+
+ \param p_cache a memory pointer returned by spatialite_alloc_connection()
+ \param parsers array of pointers to DXF Parser objects, one for each file
+ \param filenames array of paths to the DXF input files
+ \param results array of integers receiving the outcome of each file
+  (0 on failure, any other value on success)
+ \param count number of items in all the above arrays
+ \param num_threads max number of files to be parsed at the same time
+
+ \return the number of succesfully parsed files
+
+ \sa gaiaParseDxfFile_r, gaiaLoadFromDxfParserEx
+
+ \note each worker thread will use its own private connection cache;
+ p_cache will only be used by the calling thread.
+ */
+    GAIAGEO_DECLARE int gaiaParseDxfFiles_r (const void *p_cache,
+					     gaiaDxfParserPtr * parsers,
+					     const char **filenames,
+					     int *results, int count,
+					     int num_threads);
+
 /**
  Initializing a DXF Writer Object
 
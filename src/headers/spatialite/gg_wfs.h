@@ -99,6 +99,9 @@ extern "C"
  by invoking free()
  \n please note: this one simply is a convenience method, and exactly corresponds
  to load_from_wfs_paged() setting a negative page size. 
+ \n the WFS payload is streamed by a pull-parser, so that memory usage doesn't
+ depend on the size of the response; the progress callback will be invoked
+ every 1024 imported features, and once more on completion.
  */
     SPATIALITE_DECLARE int load_from_wfs (sqlite3 * sqlite,
 					  const char *path_or_url,
@@ -126,7 +129,8 @@ extern "C"
  then "PK_UID" will be assumed by default.
  \param spatial_index if TRUE an R*Tree Spatial Index will be created
  \param page_size max number of features for each single WFS call; if zero or
- negative a single monolithic page is assumed (i.e. paging will not be applied).
+ negative a single monolithic page is assumed (i.e. paging will not be applied)
+ and the whole WFS payload will be streamed by a pull-parser.
  \param rows on completion will contain the total number of actually imported rows
  \param err_msg on completion will contain an error message (if any)
  \param progress_callback pointer to a callback function to be invoked immediately
@@ -178,7 +182,8 @@ extern "C"
  then "PK_UID" will be assumed by default.
  \param spatial_index if TRUE an R*Tree Spatial Index will be created
  \param page_size max number of features for each single WFS call; if zero or
- negative a single monolithic page is assumed (i.e. paging will not be applied).
+ negative a single monolithic page is assumed (i.e. paging will not be applied)
+ and the whole WFS payload will be streamed by a pull-parser.
  \param rows on completion will contain the total number of actually imported rows
  \param err_msg on completion will contain an error message (if any)
  \param progress_callback pointer to a callback function to be invoked immediately
@@ -634,6 +634,75 @@ extern "C"
 					       const void *cache,
 					       const char *sql);
 
+/**
+ Executing a permanently registered Stored Procedure via its compiled form
+  
+ \param handle pointer to the current DB connection.
+ \param cache the same memory pointer passed to the corresponding call to
+ spatialite_init_ex() and returned by spatialite_alloc_connection()
+ \param name unique identifier of the Stored Procedure.
+ \param blob pointer to the SQL Procedure BLOB.
+ \param blob_sz the size (in bytes) of the SQL Procedure BLOB.
+ \param variables list of Variables with Values.
+ 
+ \return 0 on failure: any other different value on success.
+ 
+ \note the SQL Body is split into statements only once and the result is
+ kept in the connection cache. Variables whose Value is a plain literal
+ (NULL, a number or a quoted string) are bound as SQL parameters of
+ SELECT/INSERT/UPDATE/DELETE statements; any other Value is replaced as
+ text exactly as gaia_sql_proc_cooked_sql() does. When a Logfile is
+ enabled the classic cooked execution is used instead.
+ The prepared statements are finalized at the end of each call unless
+ their retention has been explicitly enabled by calling
+ gaia_stored_proc_set_stmt_cache().
+ 
+ \sa gaia_stored_proc_reset_compiled, gaia_stored_proc_set_stmt_cache,
+ gaia_sql_proc_cooked_sql, gaia_sql_proc_execute
+*/
+    SQLPROC_DECLARE int gaia_stored_proc_execute_compiled (sqlite3 *
+							   handle,
+							   const void *cache,
+							   const char *name,
+							   const unsigned char
+							   *blob, int blob_sz,
+							   SqlProc_VarListPtr
+							   variables);
+
+/**
+ Discarding compiled Stored Procedures
+  
+ \param cache the same memory pointer passed to the corresponding call to
+ spatialite_init_ex() and returned by spatialite_alloc_connection()
+ \param name unique identifier of the Stored Procedure to be discarded;
+ NULL will discard all compiled Stored Procedures.
+ 
+ \sa gaia_stored_proc_execute_compiled
+*/
+    SQLPROC_DECLARE void gaia_stored_proc_reset_compiled (const void *cache,
+							  const char *name);
+
+/**
+ Enabling/disabling the retention of prepared statements
+  
+ \param cache the same memory pointer passed to the corresponding call to
+ spatialite_init_ex() and returned by spatialite_alloc_connection()
+ \param mode if TRUE the prepared statements of compiled Stored Procedures
+ will be kept alive between calls; if FALSE (default) they will be
+ finalized at the end of each call. A retained statement whose Variables
+ were all bound as SQL parameters is executed again without expanding its
+ Raw SQL as long as the types of the Variable Values are unchanged.
+ 
+ \note retained statements will prevent sqlite3_close() from succeeding
+ until they are released by calling this function with mode FALSE or
+ by gaia_stored_proc_reset_compiled(); sqlite3_close_v2() and
+ spatialite_cleanup_ex() are not affected.
+ 
+ \sa gaia_stored_proc_execute_compiled
+*/
+    SQLPROC_DECLARE void gaia_stored_proc_set_stmt_cache (const void *cache,
+							  int mode);
+
 #ifdef __cplusplus
 }
 #endif
@@ -85,6 +85,10 @@ extern "C"
 /** spatial_ref_sys_init2: will create the "spatial_ref_sys" table
  but will avoid to insert any row at all */
 #define GAIA_EPSG_NONE -9997
+/** spatial_ref_sys_init2: will create the "spatial_ref_sys" table
+ only inserting WGS84-related definitions; any other EPSG SRID will
+ be lazily inserted on first reference */
+#define GAIA_EPSG_LAZY -9996
 
 #define SPATIALITE_STATISTICS_GENUINE	1
 #define SPATIALITE_STATISTICS_VIEWS	2
@@ -116,6 +120,7 @@ extern "C"
 	uLong crc32;
 	void *geosGeom;
 	void *preparedGeosGeom;
+	void *pipIndex;
     };
 
     struct splite_xmlSchema_cache_item
@@ -148,6 +153,16 @@ extern "C"
 
 #define MAX_XMLSCHEMA_CACHE	16
 
+    struct splite_ellps_cache_item
+    {
+	int srid;
+	double a;
+	double b;
+	double rf;
+    };
+
+#define MAX_ELLPS_CACHE	4
+
     struct splite_internal_cache
     {
 	unsigned char magic1;
@@ -166,6 +181,10 @@ extern "C"
 	struct splite_geos_cache_item cacheItem1;
 	struct splite_geos_cache_item cacheItem2;
 	struct splite_xmlSchema_cache_item xmlSchemaCache[MAX_XMLSCHEMA_CACHE];
+	struct splite_ellps_cache_item ellpsCache[MAX_ELLPS_CACHE];
+	int next_ellps_cache;
+	int ellps_total_changes;
+	unsigned int ellps_data_version;
 	int pool_index;
 	void (*geos_warning) (const char *fmt, ...);
 	void (*geos_error) (const char *fmt, ...);
@@ -194,6 +213,8 @@ extern "C"
 	char *SqlProcLogfile;
 	FILE *SqlProcLog;
 	int SqlProcContinue;
+	void *SqlProcCompiled;
+	int SqlProcStmtCache;
 	unsigned char magic2;
     };
 
@@ -310,6 +331,8 @@ extern "C"
 
     SPATIALITE_PRIVATE int exists_spatial_ref_sys (void *handle);
 
+    SPATIALITE_PRIVATE int lazy_insert_epsg_srid (void *handle, int srid);
+
     SPATIALITE_PRIVATE int checkSpatialMetaData (const void *sqlite);
 
     SPATIALITE_PRIVATE int checkSpatialMetaData_ex (const void *sqlite,
@@ -379,6 +402,19 @@ extern "C"
 						const unsigned char *table,
 						const char *column);
 
+    SPATIALITE_PRIVATE int enableDeferredSpatialIndex (void *p_sqlite,
+						       const char *table,
+						       const char *column,
+						       int batch_size);
+
+    SPATIALITE_PRIVATE int disableDeferredSpatialIndex (void *p_sqlite,
+							const char *table,
+							const char *column);
+
+    SPATIALITE_PRIVATE int flushDeferredSpatialIndex (void *p_sqlite,
+						      const char *table,
+						      const char *column);
+
     SPATIALITE_PRIVATE int validateRowid (void *p_sqlite, const char *table);
 
     SPATIALITE_PRIVATE int doComputeFieldInfos (void *p_sqlite,
@@ -389,6 +425,11 @@ extern "C"
     SPATIALITE_PRIVATE void getProjParams (void *p_sqlite, int srid,
 					   char **params);
 
+    SPATIALITE_PRIVATE int getEllipsoidParamsEx (const void *p_cache,
+						 void *p_sqlite, int srid,
+						 double *a, double *b,
+						 double *rf);
+
     SPATIALITE_PRIVATE int getEllipsoidParams (void *p_sqlite, int srid,
 					       double *a, double *b,
 					       double *rf);
@@ -955,6 +996,11 @@ extern "C"
 
     SPATIALITE_PRIVATE int gaiaAuxClonerExecute (const void *cloner);
 
+    SPATIALITE_PRIVATE int gaiaAuxClusterGeoTable (const void *sqlite,
+						   const char *table,
+						   const char *geom,
+						   int resequence);
+
     SPATIALITE_PRIVATE const void *gaiaElemGeomOptionsCreate ();
 
     SPATIALITE_PRIVATE void gaiaElemGeomOptionsAdd (const void *options,
@@ -1089,6 +1135,13 @@ extern "C"
 								const void
 								*argv);
 
+    SPATIALITE_PRIVATE void fnctaux_TopoGeo_FromGeoTablePartitioned (const
+								     void
+								     *context,
+								     int argc,
+								     const void
+								     *argv);
+
     SPATIALITE_PRIVATE void fnctaux_TopoGeo_FromGeoTableExt (const void
 							     *context,
 							     int argc,
@@ -1423,6 +1476,17 @@ extern "C"
 
     SPATIALITE_PRIVATE int gaia_do_check_linestring (const void *geom);
 
+    SPATIALITE_PRIVATE void gaia_elementary_blob_from_item (const void
+							    *point,
+							    const void
+							    *linestring,
+							    const void
+							    *polygon,
+							    int srid,
+							    unsigned char
+							    **blob,
+							    int *size);
+
     SPATIALITE_PRIVATE void spatialite_internal_init (void *db_handle,
 						      const void *ptr);
 
@@ -1431,6 +1495,32 @@ extern "C"
     SPATIALITE_PRIVATE void gaia_sql_proc_set_error (const void *p_cache,
 						     const char *errmsg);
 
+    SPATIALITE_PRIVATE void *gaia_gml_tree_alloc (void);
+
+    SPATIALITE_PRIVATE void gaia_gml_tree_free (void *tree);
+
+    SPATIALITE_PRIVATE void gaia_gml_tree_open_tag (void *tree,
+						    const char *prefix,
+						    const char *name,
+						    int self_closed);
+
+    SPATIALITE_PRIVATE void gaia_gml_tree_close_tag (void *tree,
+						     const char *prefix,
+						     const char *name);
+
+    SPATIALITE_PRIVATE void gaia_gml_tree_add_attribute (void *tree,
+							 const char *prefix,
+							 const char *name,
+							 const char *value);
+
+    SPATIALITE_PRIVATE void gaia_gml_tree_add_coords (void *tree,
+						      const char *text);
+
+    SPATIALITE_PRIVATE void *gaia_gml_tree_geometry (const void *p_cache,
+						     void *tree,
+						     const void
+						     *sqlite_handle);
+
 #ifdef __cplusplus
 }
 #endif
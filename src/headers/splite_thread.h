@@ -0,0 +1,122 @@
+/*
+ splite_thread.h -- portable threading primitives [private header]
+
+ version 4.3, 2015 June 29
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2008-2015
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+/**
+ \file splite_thread.h
+
+ SpatiaLite private header file: Mutexes, Condition Variables and Threads
+ shared by all worker pools (Win32 threads on MSVC, POSIX threads elsewhere)
+ */
+
+#ifndef _SPLITE_THREAD_H
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define _SPLITE_THREAD_H
+#endif
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+
+#include <windows.h>
+
+typedef CRITICAL_SECTION splite_mutex_t;
+typedef CONDITION_VARIABLE splite_cond_t;
+typedef HANDLE splite_thread_t;
+
+/* declaring a thread procedure */
+#define SPLITE_THREAD_PROC(name, arg) static DWORD WINAPI name (LPVOID arg)
+/* returning from a thread procedure */
+#define SPLITE_THREAD_RETURN return 0
+
+#define splite_mutex_init(mutex) InitializeCriticalSection (mutex)
+#define splite_mutex_destroy(mutex) DeleteCriticalSection (mutex)
+#define splite_mutex_lock(mutex) EnterCriticalSection (mutex)
+#define splite_mutex_unlock(mutex) LeaveCriticalSection (mutex)
+
+#define splite_cond_init(cond) InitializeConditionVariable (cond)
+/* Windows Condition Variables need no cleanup */
+#define splite_cond_destroy(cond)
+#define splite_cond_wait(cond, mutex) \
+	SleepConditionVariableCS ((cond), (mutex), INFINITE)
+#define splite_cond_signal(cond) WakeConditionVariable (cond)
+#define splite_cond_broadcast(cond) WakeAllConditionVariable (cond)
+
+/* starting a new thread: TRUE on success */
+#define splite_thread_start(thread, proc, arg) \
+	((*(thread) = CreateThread (NULL, 0, (proc), (arg), 0, NULL)) != NULL)
+/* waiting for a thread to terminate */
+#define splite_thread_join(thread) \
+	(WaitForSingleObject ((thread), INFINITE), CloseHandle (thread))
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_mutex_t splite_mutex_t;
+typedef pthread_cond_t splite_cond_t;
+typedef pthread_t splite_thread_t;
+
+/* declaring a thread procedure */
+#define SPLITE_THREAD_PROC(name, arg) static void * name (void *arg)
+/* returning from a thread procedure */
+#define SPLITE_THREAD_RETURN return NULL
+
+#define splite_mutex_init(mutex) pthread_mutex_init ((mutex), NULL)
+#define splite_mutex_destroy(mutex) pthread_mutex_destroy (mutex)
+#define splite_mutex_lock(mutex) pthread_mutex_lock (mutex)
+#define splite_mutex_unlock(mutex) pthread_mutex_unlock (mutex)
+
+#define splite_cond_init(cond) pthread_cond_init ((cond), NULL)
+#define splite_cond_destroy(cond) pthread_cond_destroy (cond)
+#define splite_cond_wait(cond, mutex) pthread_cond_wait ((cond), (mutex))
+#define splite_cond_signal(cond) pthread_cond_signal (cond)
+#define splite_cond_broadcast(cond) pthread_cond_broadcast (cond)
+
+/* starting a new thread: TRUE on success */
+#define splite_thread_start(thread, proc, arg) \
+	(pthread_create ((thread), NULL, (proc), (arg)) == 0)
+/* waiting for a thread to terminate */
+#define splite_thread_join(thread) pthread_join ((thread), NULL)
+
+#endif
+
+#endif /* _SPLITE_THREAD_H */
@@ -5389,221 +5389,29 @@ check_elementary (sqlite3 * sqlite, const char *inTable, const char *geom,
     return ok;
 }
 
-static gaiaGeomCollPtr
-elemGeomFromPoint (gaiaPointPtr pt, int srid)
-{
-/* creating a Geometry containing a single Point */
-    gaiaGeomCollPtr g = NULL;
-    switch (pt->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  g = gaiaAllocGeomCollXYZM ();
-	  break;
-      case GAIA_XY_Z:
-	  g = gaiaAllocGeomCollXYZ ();
-	  break;
-      case GAIA_XY_M:
-	  g = gaiaAllocGeomCollXYM ();
-	  break;
-      default:
-	  g = gaiaAllocGeomColl ();
-	  break;
-      };
-    if (!g)
-	return NULL;
-    g->Srid = srid;
-    g->DeclaredType = GAIA_POINT;
-    switch (pt->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  gaiaAddPointToGeomCollXYZM (g, pt->X, pt->Y, pt->Z, pt->M);
-	  break;
-      case GAIA_XY_Z:
-	  gaiaAddPointToGeomCollXYZ (g, pt->X, pt->Y, pt->Z);
-	  break;
-      case GAIA_XY_M:
-	  gaiaAddPointToGeomCollXYM (g, pt->X, pt->Y, pt->M);
-	  break;
-      default:
-	  gaiaAddPointToGeomColl (g, pt->X, pt->Y);
-	  break;
-      };
-    return g;
-}
-
-static gaiaGeomCollPtr
-elemGeomFromLinestring (gaiaLinestringPtr ln, int srid)
-{
-/* creating a Geometry containing a single Linestring */
-    gaiaGeomCollPtr g = NULL;
-    gaiaLinestringPtr ln2;
-    int iv;
-    double x;
-    double y;
-    double z;
-    double m;
-    switch (ln->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  g = gaiaAllocGeomCollXYZM ();
-	  break;
-      case GAIA_XY_Z:
-	  g = gaiaAllocGeomCollXYZ ();
-	  break;
-      case GAIA_XY_M:
-	  g = gaiaAllocGeomCollXYM ();
-	  break;
-      default:
-	  g = gaiaAllocGeomColl ();
-	  break;
-      };
-    if (!g)
-	return NULL;
-    g->Srid = srid;
-    g->DeclaredType = GAIA_LINESTRING;
-    ln2 = gaiaAddLinestringToGeomColl (g, ln->Points);
-    switch (ln->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPointXYZM (ln->Coords, iv, &x, &y, &z, &m);
-		gaiaSetPointXYZM (ln2->Coords, iv, x, y, z, m);
-	    }
-	  break;
-      case GAIA_XY_Z:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPointXYZ (ln->Coords, iv, &x, &y, &z);
-		gaiaSetPointXYZ (ln2->Coords, iv, x, y, z);
-	    }
-	  break;
-      case GAIA_XY_M:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPointXYM (ln->Coords, iv, &x, &y, &m);
-		gaiaSetPointXYM (ln2->Coords, iv, x, y, m);
-	    }
-	  break;
-      default:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPoint (ln->Coords, iv, &x, &y);
-		gaiaSetPoint (ln2->Coords, iv, x, y);
-	    }
-	  break;
-      };
-    return g;
-}
-
-static gaiaGeomCollPtr
-elemGeomFromPolygon (gaiaPolygonPtr pg, int srid)
+static int
+elemgeom_insert_item (sqlite3 * sqlite, sqlite3_stmt * stmt_out, int geom_idx,
+		      gaiaPointPtr pt, gaiaLinestringPtr ln, gaiaPolygonPtr pg,
+		      int srid)
 {
-/* creating a Geometry containing a single Polygon */
-    gaiaGeomCollPtr g = NULL;
-    gaiaPolygonPtr pg2;
-    gaiaRingPtr rng;
-    gaiaRingPtr rng2;
-    int ib;
-    int iv;
-    double x;
-    double y;
-    double z;
-    double m;
-    switch (pg->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  g = gaiaAllocGeomCollXYZM ();
-	  break;
-      case GAIA_XY_Z:
-	  g = gaiaAllocGeomCollXYZ ();
-	  break;
-      case GAIA_XY_M:
-	  g = gaiaAllocGeomCollXYM ();
-	  break;
-      default:
-	  g = gaiaAllocGeomColl ();
-	  break;
-      };
-    if (!g)
-	return NULL;
-    g->Srid = srid;
-    g->DeclaredType = GAIA_POLYGON;
-    rng = pg->Exterior;
-    pg2 = gaiaAddPolygonToGeomColl (g, rng->Points, pg->NumInteriors);
-    rng2 = pg2->Exterior;
-    switch (pg->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPointXYZM (rng->Coords, iv, &x, &y, &z, &m);
-		gaiaSetPointXYZM (rng2->Coords, iv, x, y, z, m);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPointXYZM (rng->Coords, iv, &x, &y, &z, &m);
-		      gaiaSetPointXYZM (rng2->Coords, iv, x, y, z, m);
-		  }
-	    }
-	  break;
-      case GAIA_XY_Z:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPointXYZ (rng->Coords, iv, &x, &y, &z);
-		gaiaSetPointXYZ (rng2->Coords, iv, x, y, z);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPointXYZ (rng->Coords, iv, &x, &y, &z);
-		      gaiaSetPointXYZ (rng2->Coords, iv, x, y, z);
-		  }
-	    }
-	  break;
-      case GAIA_XY_M:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPointXYM (rng->Coords, iv, &x, &y, &m);
-		gaiaSetPointXYM (rng2->Coords, iv, x, y, m);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPointXYM (rng->Coords, iv, &x, &y, &m);
-		      gaiaSetPointXYM (rng2->Coords, iv, x, y, m);
-		  }
-	    }
-	  break;
-      default:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPoint (rng->Coords, iv, &x, &y);
-		gaiaSetPoint (rng2->Coords, iv, x, y);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPoint (rng->Coords, iv, &x, &y);
-		      gaiaSetPoint (rng2->Coords, iv, x, y);
-		  }
-	    }
-	  break;
-      };
-    return g;
+/* 
+/ inserting a single Elementary Geometry into the output table
+/ all other columns are expected to be already bound
+*/
+    int ret;
+    unsigned char *blob;
+    int size;
+    sqlite3_reset (stmt_out);
+    gaia_elementary_blob_from_item (pt, ln, pg, srid, &blob, &size);
+    if (blob == NULL)
+	sqlite3_bind_null (stmt_out, geom_idx + 2);
+    else
+	sqlite3_bind_blob (stmt_out, geom_idx + 2, blob, size, free);
+    ret = sqlite3_step (stmt_out);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	return 1;
+    spatialite_e ("[OUT]step error: %s\n", sqlite3_errmsg (sqlite));
+    return 0;
 }
 
 SPATIALITE_DECLARE void
@@ -5914,64 +5722,26 @@ elementary_geometries_ex3 (sqlite3 * sqlite,
 								    geom_idx),
 					       sqlite3_column_bytes (stmt_in,
 								     geom_idx));
+		/* 
+		 / binding all attribute columns just once, 
+		 / they'll be shared by all Elementary Geoms
+		 */
+		sqlite3_reset (stmt_out);
+		sqlite3_clear_bindings (stmt_out);
+		sqlite3_bind_int64 (stmt_out, 1, id);
+		for (i = 0; i < n_columns; i++)
+		  {
+		      if (i == geom_idx)
+			  continue;
+		      sqlite3_bind_value (stmt_out, i + 2,
+					  sqlite3_column_value (stmt_in, i));
+		  }
 		if (!g)
 		  {
 		      /* NULL input geometry */
-		      sqlite3_reset (stmt_out);
-		      sqlite3_clear_bindings (stmt_out);
-		      sqlite3_bind_int64 (stmt_out, 1, id);
-		      sqlite3_bind_null (stmt_out, geom_idx + 2);
-
-		      for (i = 0; i < n_columns; i++)
-			{
-			    int type = sqlite3_column_type (stmt_in, i);
-			    if (i == geom_idx)
-				continue;
-			    switch (type)
-			      {
-			      case SQLITE_INTEGER:
-				  sqlite3_bind_int64 (stmt_out, i + 2,
-						      sqlite3_column_int
-						      (stmt_in, i));
-				  break;
-			      case SQLITE_FLOAT:
-				  sqlite3_bind_double (stmt_out, i + 2,
-						       sqlite3_column_double
-						       (stmt_in, i));
-				  break;
-			      case SQLITE_TEXT:
-				  sqlite3_bind_text (stmt_out, i + 2,
-						     (const char *)
-						     sqlite3_column_text
-						     (stmt_in, i),
-						     sqlite3_column_bytes
-						     (stmt_in, i),
-						     SQLITE_STATIC);
-				  break;
-			      case SQLITE_BLOB:
-				  sqlite3_bind_blob (stmt_out, i + 2,
-						     sqlite3_column_blob
-						     (stmt_in, i),
-						     sqlite3_column_bytes
-						     (stmt_in, i),
-						     SQLITE_STATIC);
-				  break;
-			      case SQLITE_NULL:
-			      default:
-				  sqlite3_bind_null (stmt_out, i + 2);
-				  break;
-			      };
-			}
-
-		      ret = sqlite3_step (stmt_out);
-		      if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-			  ;
-		      else
-			{
-			    spatialite_e ("[OUT]step error: %s\n",
-					  sqlite3_errmsg (sqlite));
-			    goto abort;
-			}
+		      if (!elemgeom_insert_item
+			  (sqlite, stmt_out, geom_idx, NULL, NULL, NULL, 0))
+			  goto abort;
 		      inserted++;
 		  }
 		else
@@ -5980,76 +5750,15 @@ elementary_geometries_ex3 (sqlite3 * sqlite,
 		      gaiaPointPtr pt;
 		      gaiaLinestringPtr ln;
 		      gaiaPolygonPtr pg;
-		      gaiaGeomCollPtr outGeom;
 		      pt = g->FirstPoint;
 		      while (pt)
 			{
 			    /* separating Points */
-			    outGeom = elemGeomFromPoint (pt, g->Srid);
-			    sqlite3_reset (stmt_out);
-			    sqlite3_clear_bindings (stmt_out);
-			    sqlite3_bind_int64 (stmt_out, 1, id);
-			    if (!outGeom)
-				sqlite3_bind_null (stmt_out, geom_idx + 2);
-			    else
+			    if (!elemgeom_insert_item
+				(sqlite, stmt_out, geom_idx, pt, NULL, NULL,
+				 g->Srid))
 			      {
-				  unsigned char *blob;
-				  int size;
-				  gaiaToSpatiaLiteBlobWkb (outGeom, &blob,
-							   &size);
-				  sqlite3_bind_blob (stmt_out, geom_idx + 2,
-						     blob, size, free);
-				  gaiaFreeGeomColl (outGeom);
-			      }
-
-			    for (i = 0; i < n_columns; i++)
-			      {
-				  int type = sqlite3_column_type (stmt_in, i);
-				  if (i == geom_idx)
-				      continue;
-				  switch (type)
-				    {
-				    case SQLITE_INTEGER:
-					sqlite3_bind_int64 (stmt_out, i + 2,
-							    sqlite3_column_int
-							    (stmt_in, i));
-					break;
-				    case SQLITE_FLOAT:
-					sqlite3_bind_double (stmt_out, i + 2,
-							     sqlite3_column_double
-							     (stmt_in, i));
-					break;
-				    case SQLITE_TEXT:
-					sqlite3_bind_text (stmt_out, i + 2,
-							   (const char *)
-							   sqlite3_column_text
-							   (stmt_in, i),
-							   sqlite3_column_bytes
-							   (stmt_in, i),
-							   SQLITE_STATIC);
-					break;
-				    case SQLITE_BLOB:
-					sqlite3_bind_blob (stmt_out, i + 2,
-							   sqlite3_column_blob
-							   (stmt_in, i),
-							   sqlite3_column_bytes
-							   (stmt_in, i),
-							   SQLITE_STATIC);
-					break;
-				    case SQLITE_NULL:
-				    default:
-					sqlite3_bind_null (stmt_out, i + 2);
-					break;
-				    };
-			      }
-
-			    ret = sqlite3_step (stmt_out);
-			    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-				;
-			    else
-			      {
-				  spatialite_e ("[OUT]step error: %s\n",
-						sqlite3_errmsg (sqlite));
+				  gaiaFreeGeomColl (g);
 				  goto abort;
 			      }
 			    inserted++;
@@ -6059,71 +5768,11 @@ elementary_geometries_ex3 (sqlite3 * sqlite,
 		      while (ln)
 			{
 			    /* separating Linestrings */
-			    outGeom = elemGeomFromLinestring (ln, g->Srid);
-			    sqlite3_reset (stmt_out);
-			    sqlite3_clear_bindings (stmt_out);
-			    sqlite3_bind_int64 (stmt_out, 1, id);
-			    if (!outGeom)
-				sqlite3_bind_null (stmt_out, geom_idx + 2);
-			    else
-			      {
-				  unsigned char *blob;
-				  int size;
-				  gaiaToSpatiaLiteBlobWkb (outGeom, &blob,
-							   &size);
-				  sqlite3_bind_blob (stmt_out, geom_idx + 2,
-						     blob, size, free);
-				  gaiaFreeGeomColl (outGeom);
-			      }
-
-			    for (i = 0; i < n_columns; i++)
-			      {
-				  int type = sqlite3_column_type (stmt_in, i);
-				  if (i == geom_idx)
-				      continue;
-				  switch (type)
-				    {
-				    case SQLITE_INTEGER:
-					sqlite3_bind_int64 (stmt_out, i + 2,
-							    sqlite3_column_int
-							    (stmt_in, i));
-					break;
-				    case SQLITE_FLOAT:
-					sqlite3_bind_double (stmt_out, i + 2,
-							     sqlite3_column_double
-							     (stmt_in, i));
-					break;
-				    case SQLITE_TEXT:
-					sqlite3_bind_text (stmt_out, i + 2,
-							   (const char *)
-							   sqlite3_column_text
-							   (stmt_in, i),
-							   sqlite3_column_bytes
-							   (stmt_in, i),
-							   SQLITE_STATIC);
-					break;
-				    case SQLITE_BLOB:
-					sqlite3_bind_blob (stmt_out, i + 2,
-							   sqlite3_column_blob
-							   (stmt_in, i),
-							   sqlite3_column_bytes
-							   (stmt_in, i),
-							   SQLITE_STATIC);
-					break;
-				    case SQLITE_NULL:
-				    default:
-					sqlite3_bind_null (stmt_out, i + 2);
-					break;
-				    };
-			      }
-
-			    ret = sqlite3_step (stmt_out);
-			    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-				;
-			    else
+			    if (!elemgeom_insert_item
+				(sqlite, stmt_out, geom_idx, NULL, ln, NULL,
+				 g->Srid))
 			      {
-				  spatialite_e ("[OUT]step error: %s\n",
-						sqlite3_errmsg (sqlite));
+				  gaiaFreeGeomColl (g);
 				  goto abort;
 			      }
 			    inserted++;
@@ -6133,71 +5782,11 @@ elementary_geometries_ex3 (sqlite3 * sqlite,
 		      while (pg)
 			{
 			    /* separating Polygons */
-			    outGeom = elemGeomFromPolygon (pg, g->Srid);
-			    sqlite3_reset (stmt_out);
-			    sqlite3_clear_bindings (stmt_out);
-			    sqlite3_bind_int64 (stmt_out, 1, id);
-			    if (!outGeom)
-				sqlite3_bind_null (stmt_out, geom_idx + 2);
-			    else
-			      {
-				  unsigned char *blob;
-				  int size;
-				  gaiaToSpatiaLiteBlobWkb (outGeom, &blob,
-							   &size);
-				  sqlite3_bind_blob (stmt_out, geom_idx + 2,
-						     blob, size, free);
-				  gaiaFreeGeomColl (outGeom);
-			      }
-
-			    for (i = 0; i < n_columns; i++)
-			      {
-				  int type = sqlite3_column_type (stmt_in, i);
-				  if (i == geom_idx)
-				      continue;
-				  switch (type)
-				    {
-				    case SQLITE_INTEGER:
-					sqlite3_bind_int64 (stmt_out, i + 2,
-							    sqlite3_column_int
-							    (stmt_in, i));
-					break;
-				    case SQLITE_FLOAT:
-					sqlite3_bind_double (stmt_out, i + 2,
-							     sqlite3_column_double
-							     (stmt_in, i));
-					break;
-				    case SQLITE_TEXT:
-					sqlite3_bind_text (stmt_out, i + 2,
-							   (const char *)
-							   sqlite3_column_text
-							   (stmt_in, i),
-							   sqlite3_column_bytes
-							   (stmt_in, i),
-							   SQLITE_STATIC);
-					break;
-				    case SQLITE_BLOB:
-					sqlite3_bind_blob (stmt_out, i + 2,
-							   sqlite3_column_blob
-							   (stmt_in, i),
-							   sqlite3_column_bytes
-							   (stmt_in, i),
-							   SQLITE_STATIC);
-					break;
-				    case SQLITE_NULL:
-				    default:
-					sqlite3_bind_null (stmt_out, i + 2);
-					break;
-				    };
-			      }
-
-			    ret = sqlite3_step (stmt_out);
-			    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-				;
-			    else
+			    if (!elemgeom_insert_item
+				(sqlite, stmt_out, geom_idx, NULL, NULL, pg,
+				 g->Srid))
 			      {
-				  spatialite_e ("[OUT]step error: %s\n",
-						sqlite3_errmsg (sqlite));
+				  gaiaFreeGeomColl (g);
 				  goto abort;
 			      }
 			    inserted++;
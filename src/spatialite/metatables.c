@@ -3061,6 +3061,163 @@ upgradeGeometryTriggers (void *p_sqlite)
     return retcode;
 }
 
+static int
+check_spatial_index_log (sqlite3 * sqlite, const char *table,
+			 const char *column)
+{
+/* checks if a deferred SpatialIndex log table exists */
+    char *sql_statement;
+    char *log_name;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int exists = 0;
+
+    log_name = sqlite3_mprintf ("idxlog_%s_%s", table, column);
+    sql_statement =
+	sqlite3_mprintf ("SELECT name FROM main.sqlite_master "
+			 "WHERE type = 'table' AND Lower(name) = Lower(%Q)",
+			 log_name);
+    sqlite3_free (log_name);
+    ret = sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			     NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows >= 1)
+	exists = 1;
+    sqlite3_free_table (results);
+    return exists;
+}
+
+static int
+create_spatial_index_triggers (sqlite3 * sqlite, const char *table,
+			       const char *column, int deferred,
+			       char **errMsg)
+{
+/* 
+/ (re)creating the INSERT, UPDATE and DELETE triggers supporting
+/ an R*Tree SpatialIndex (current metadata style >= v.4.0.0)
+/
+/ in deferred mode the triggers simply append the new MBRs
+/ to the corresponding "idxlog_<table>_<column>" table, that
+/ will then be merged into the R*Tree in sorted batches
+*/
+    char *raw;
+    char *quoted_trigger;
+    char *quoted_rtree;
+    char *quoted_log;
+    char *quoted_table;
+    char *quoted_column;
+    char *sql_statement;
+    const char *prefix[3] = { "gii", "giu", "gid" };
+    int i;
+    int ret;
+
+/* dropping the previous triggers */
+    for (i = 0; i < 3; i++)
+      {
+	  raw = sqlite3_mprintf ("%s_%s_%s", prefix[i], table, column);
+	  quoted_trigger = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  sql_statement =
+	      sqlite3_mprintf ("DROP TRIGGER IF EXISTS main.\"%s\"",
+			       quoted_trigger);
+	  free (quoted_trigger);
+	  ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, errMsg);
+	  sqlite3_free (sql_statement);
+	  if (ret != SQLITE_OK)
+	      return 0;
+      }
+
+    raw = sqlite3_mprintf ("idx_%s_%s", table, column);
+    quoted_rtree = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    raw = sqlite3_mprintf ("idxlog_%s_%s", table, column);
+    quoted_log = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    quoted_table = gaiaDoubleQuotedSql (table);
+    quoted_column = gaiaDoubleQuotedSql (column);
+    raw = sqlite3_mprintf ("idx_%s_%s", table, column);
+    for (i = 0; i < 3; i++)
+      {
+	  char *trigger = sqlite3_mprintf ("%s_%s_%s", prefix[i], table,
+					   column);
+	  quoted_trigger = gaiaDoubleQuotedSql (trigger);
+	  sqlite3_free (trigger);
+	  if (deferred)
+	    {
+		char *event;
+		if (i == 0)
+		    event = sqlite3_mprintf ("INSERT");
+		else
+		    event = sqlite3_mprintf ("UPDATE OF \"%s\"",
+					     quoted_column);
+		if (i == 2)
+		    sql_statement =
+			sqlite3_mprintf
+			("CREATE TRIGGER \"%s\" AFTER DELETE ON \"%s\"\n"
+			 "FOR EACH ROW BEGIN\n"
+			 "INSERT INTO \"%s\" (pkid) VALUES (OLD.ROWID);\nEND",
+			 quoted_trigger, quoted_table, quoted_log);
+		else
+		    sql_statement =
+			sqlite3_mprintf
+			("CREATE TRIGGER \"%s\" AFTER %s ON \"%s\"\n"
+			 "FOR EACH ROW BEGIN\n"
+			 "INSERT INTO \"%s\" (pkid, xmin, xmax, ymin, ymax) "
+			 "VALUES (NEW.ROWID, MbrMinX(NEW.\"%s\"), "
+			 "MbrMaxX(NEW.\"%s\"), MbrMinY(NEW.\"%s\"), "
+			 "MbrMaxY(NEW.\"%s\"));\nEND", quoted_trigger,
+			 event, quoted_table, quoted_log, quoted_column,
+			 quoted_column, quoted_column, quoted_column);
+		sqlite3_free (event);
+	    }
+	  else
+	    {
+		if (i == 2)
+		    sql_statement =
+			sqlite3_mprintf
+			("CREATE TRIGGER \"%s\" AFTER DELETE ON \"%s\"\n"
+			 "FOR EACH ROW BEGIN\n"
+			 "DELETE FROM \"%s\" WHERE pkid=OLD.ROWID;\nEND",
+			 quoted_trigger, quoted_table, quoted_rtree);
+		else if (i == 1)
+		    sql_statement =
+			sqlite3_mprintf
+			("CREATE TRIGGER \"%s\" AFTER UPDATE OF \"%s\" ON \"%s\"\n"
+			 "FOR EACH ROW BEGIN\n"
+			 "DELETE FROM \"%s\" WHERE pkid=NEW.ROWID;\n"
+			 "SELECT RTreeAlign(%Q, NEW.ROWID, NEW.\"%s\");\nEND",
+			 quoted_trigger, quoted_column, quoted_table,
+			 quoted_rtree, raw, quoted_column);
+		else
+		    sql_statement =
+			sqlite3_mprintf
+			("CREATE TRIGGER \"%s\" AFTER INSERT ON \"%s\"\n"
+			 "FOR EACH ROW BEGIN\n"
+			 "DELETE FROM \"%s\" WHERE pkid=NEW.ROWID;\n"
+			 "SELECT RTreeAlign(%Q, NEW.ROWID, NEW.\"%s\");\nEND",
+			 quoted_trigger, quoted_table, quoted_rtree, raw,
+			 quoted_column);
+	    }
+	  free (quoted_trigger);
+	  ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, errMsg);
+	  sqlite3_free (sql_statement);
+	  if (ret != SQLITE_OK)
+	      break;
+      }
+    sqlite3_free (raw);
+    free (quoted_rtree);
+    free (quoted_log);
+    free (quoted_table);
+    free (quoted_column);
+    if (ret != SQLITE_OK)
+	return 0;
+    return 1;
+}
+
 SPATIALITE_PRIVATE void
 updateGeometryTriggers (void *p_sqlite, const char *table, const char *column)
 {
@@ -3749,6 +3906,38 @@ updateGeometryTriggers (void *p_sqlite, const char *table, const char *column)
 			  goto error;
 		  }
 
+		if (metadata_version == 3
+		    && check_spatial_index_log (sqlite, p_table, p_column))
+		  {
+		      if (index)
+			{
+			    /* preserving the deferred SpatialIndex mode */
+			    if (!create_spatial_index_triggers
+				(sqlite, p_table, p_column, 1, &errMsg))
+				goto error;
+			}
+		      else
+			{
+			    /* no more R*Tree: dropping the deferred log */
+			    raw =
+				sqlite3_mprintf ("idxlog_%s_%s", p_table,
+						 p_column);
+			    quoted_rtree = gaiaDoubleQuotedSql (raw);
+			    sqlite3_free (raw);
+			    sql_statement =
+				sqlite3_mprintf
+				("DROP TABLE IF EXISTS main.\"%s\"",
+				 quoted_rtree);
+			    free (quoted_rtree);
+			    ret =
+				sqlite3_exec (sqlite, sql_statement, NULL,
+					      NULL, &errMsg);
+			    sqlite3_free (sql_statement);
+			    if (ret != SQLITE_OK)
+				goto error;
+			}
+		  }
+
 		if (cached)
 		  {
 		      /* inserting the new INSERT trigger MBRcache */
@@ -4141,6 +4330,276 @@ buildSpatialIndexEx (void *p_sqlite, const unsigned char *table,
     return 0;
 }
 
+SPATIALITE_PRIVATE int
+flushDeferredSpatialIndex (void *p_sqlite, const char *table,
+			   const char *column)
+{
+/* 
+/ merging all pending entries of a deferred SpatialIndex log
+/ into the corresponding R*Tree
+/
+/ returns the number of merged log entries (0 if the SpatialIndex
+/ isn't deferred or nothing was pending) or -1 on failure
+*/
+    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
+    char *p_table = NULL;
+    char *p_column = NULL;
+    char *raw;
+    char *quoted_rtree;
+    char *quoted_log;
+    char *sql_statement;
+    char *errMsg = NULL;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int count = 0;
+
+    if (!getRealSQLnames (sqlite, table, column, &p_table, &p_column))
+	return -1;
+    if (!check_spatial_index_log (sqlite, p_table, p_column))
+      {
+	  free (p_table);
+	  free (p_column);
+	  return 0;
+      }
+    raw = sqlite3_mprintf ("idx_%s_%s", p_table, p_column);
+    quoted_rtree = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    raw = sqlite3_mprintf ("idxlog_%s_%s", p_table, p_column);
+    quoted_log = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    free (p_table);
+    free (p_column);
+
+/* counting the pending entries */
+    sql_statement =
+	sqlite3_mprintf ("SELECT Count(*) FROM main.\"%s\"", quoted_log);
+    ret = sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			     &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+    if (rows >= 1 && results[1] != NULL)
+	count = atoi (results[1]);
+    sqlite3_free_table (results);
+    if (count == 0)
+	goto end;
+
+/*
+/ removing from the R*Tree any entry superseded by the log; readers
+/ always prefer the log, so the SpatialIndex stays consistent even
+/ if the merge is interrupted before the log is cleared
+*/
+    sql_statement =
+	sqlite3_mprintf ("DELETE FROM main.\"%s\" WHERE pkid IN "
+			 "(SELECT pkid FROM main.\"%s\")", quoted_rtree,
+			 quoted_log);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* inserting the latest MBR of each row, sorted so to preserve locality */
+    sql_statement =
+	sqlite3_mprintf ("INSERT INTO main.\"%s\" (pkid, xmin, xmax, ymin, ymax) "
+			 "SELECT pkid, xmin, xmax, ymin, ymax FROM "
+			 "(SELECT pkid, Max(seq), xmin, xmax, ymin, ymax "
+			 "FROM main.\"%s\" GROUP BY pkid) "
+			 "WHERE xmin IS NOT NULL ORDER BY xmin + xmax, ymin + ymax",
+			 quoted_rtree, quoted_log);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* resetting the log */
+    sql_statement = sqlite3_mprintf ("DELETE FROM main.\"%s\"", quoted_log);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+  end:
+    free (quoted_rtree);
+    free (quoted_log);
+    return count;
+
+  error:
+    spatialite_e ("flushDeferredSpatialIndex: \"%s\"\n", errMsg);
+    sqlite3_free (errMsg);
+    free (quoted_rtree);
+    free (quoted_log);
+    return -1;
+}
+
+SPATIALITE_PRIVATE int
+enableDeferredSpatialIndex (void *p_sqlite, const char *table,
+			    const char *column, int batch_size)
+{
+/* 
+/ switching an R*Tree SpatialIndex to deferred mode: the triggers
+/ will append the new MBRs to a log table, automatically merged
+/ into the R*Tree as soon as it contains batch_size entries
+/
+/ returns 1 on success, 0 on failure
+*/
+    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
+    char *p_table = NULL;
+    char *p_column = NULL;
+    char *raw;
+    char *quoted_log;
+    char *quoted_trigger;
+    char *sql_statement;
+    char *errMsg = NULL;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+
+    if (checkSpatialMetaData (sqlite) != 3)
+      {
+	  spatialite_e
+	      ("enableDeferredSpatialIndex: requires current metadata style (>= v.4.0.0)\n");
+	  return 0;
+      }
+    if (batch_size <= 0)
+	return 0;
+    sql_statement =
+	sqlite3_mprintf ("SELECT f_table_name FROM main.geometry_columns "
+			 "WHERE Lower(f_table_name) = Lower(%Q) AND "
+			 "Lower(f_geometry_column) = Lower(%Q) AND "
+			 "spatial_index_enabled = 1", table, column);
+    ret = sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			     NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_free_table (results);
+    if (rows < 1)
+      {
+	  spatialite_e
+	      ("enableDeferredSpatialIndex: \"%s\".\"%s\" has no R*Tree SpatialIndex\n",
+	       table, column);
+	  return 0;
+      }
+    if (!getRealSQLnames (sqlite, table, column, &p_table, &p_column))
+	return 0;
+
+/* creating the log table */
+    raw = sqlite3_mprintf ("idxlog_%s_%s", p_table, p_column);
+    quoted_log = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    sql_statement =
+	sqlite3_mprintf ("CREATE TABLE IF NOT EXISTS main.\"%s\" (\n"
+			 "seq INTEGER PRIMARY KEY,\n"
+			 "pkid INTEGER NOT NULL,\n"
+			 "xmin DOUBLE,\nxmax DOUBLE,\n"
+			 "ymin DOUBLE,\nymax DOUBLE)", quoted_log);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  free (quoted_log);
+	  goto error;
+      }
+
+/* (re)creating the trigger merging the log on size threshold */
+    raw = sqlite3_mprintf ("gil_%s_%s", p_table, p_column);
+    quoted_trigger = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    sql_statement =
+	sqlite3_mprintf ("DROP TRIGGER IF EXISTS main.\"%s\"",
+			 quoted_trigger);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  free (quoted_log);
+	  free (quoted_trigger);
+	  goto error;
+      }
+    sql_statement =
+	sqlite3_mprintf ("CREATE TRIGGER \"%s\" AFTER INSERT ON \"%s\"\n"
+			 "FOR EACH ROW WHEN NEW.seq >= %d BEGIN\n"
+			 "SELECT FlushSpatialIndex(%Q, %Q);\nEND",
+			 quoted_trigger, quoted_log, batch_size, p_table,
+			 p_column);
+    free (quoted_log);
+    free (quoted_trigger);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* redirecting the SpatialIndex triggers to the log */
+    if (!create_spatial_index_triggers (sqlite, p_table, p_column, 1, &errMsg))
+	goto error;
+    free (p_table);
+    free (p_column);
+    return 1;
+
+  error:
+    spatialite_e ("enableDeferredSpatialIndex: \"%s\"\n", errMsg);
+    sqlite3_free (errMsg);
+    free (p_table);
+    free (p_column);
+    return 0;
+}
+
+SPATIALITE_PRIVATE int
+disableDeferredSpatialIndex (void *p_sqlite, const char *table,
+			     const char *column)
+{
+/* 
+/ switching a deferred R*Tree SpatialIndex back to immediate mode:
+/ any pending log entry will be merged before dropping the log
+/
+/ returns 1 on success, 0 on failure
+*/
+    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
+    char *p_table = NULL;
+    char *p_column = NULL;
+    char *raw;
+    char *quoted_log;
+    char *sql_statement;
+    char *errMsg = NULL;
+    int ret;
+
+    if (!getRealSQLnames (sqlite, table, column, &p_table, &p_column))
+	return 0;
+    if (!check_spatial_index_log (sqlite, p_table, p_column))
+	goto stop;
+    if (flushDeferredSpatialIndex (sqlite, p_table, p_column) < 0)
+	goto stop;
+
+/* restoring the immediate SpatialIndex triggers */
+    if (!create_spatial_index_triggers (sqlite, p_table, p_column, 0, &errMsg))
+	goto error;
+
+/* dropping the log table (and its trigger) */
+    raw = sqlite3_mprintf ("idxlog_%s_%s", p_table, p_column);
+    quoted_log = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    sql_statement =
+	sqlite3_mprintf ("DROP TABLE IF EXISTS main.\"%s\"", quoted_log);
+    free (quoted_log);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, &errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+    free (p_table);
+    free (p_column);
+    return 1;
+
+  error:
+    spatialite_e ("disableDeferredSpatialIndex: \"%s\"\n", errMsg);
+    sqlite3_free (errMsg);
+  stop:
+    free (p_table);
+    free (p_column);
+    return 0;
+}
+
 SPATIALITE_PRIVATE int
 getRealSQLnames (void *p_sqlite, const char *table, const char *column,
 		 char **real_table, char **real_column)
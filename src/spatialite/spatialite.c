@@ -2133,6 +2133,8 @@ fnct_InitSpatialMetaData (sqlite3_context * context, int argc,
 		if (strcasecmp (xmode, "WGS84") == 0
 		    || strcasecmp (xmode, "WGS84_ONLY") == 0)
 		    mode = GAIA_EPSG_WGS84_ONLY;
+		if (strcasecmp (xmode, "LAZY") == 0)
+		    mode = GAIA_EPSG_LAZY;
 	    }
 	  else if (sqlite3_value_type (argv[0]) == SQLITE_INTEGER)
 	      transaction = sqlite3_value_int (argv[0]);
@@ -2168,6 +2170,8 @@ fnct_InitSpatialMetaData (sqlite3_context * context, int argc,
 	  if (strcasecmp (xmode, "WGS84") == 0
 	      || strcasecmp (xmode, "WGS84_ONLY") == 0)
 	      mode = GAIA_EPSG_WGS84_ONLY;
+	  if (strcasecmp (xmode, "LAZY") == 0)
+	      mode = GAIA_EPSG_LAZY;
       }
 
     if (transaction)
@@ -2246,6 +2250,7 @@ fnct_InitSpatialMetaData (sqlite3_context * context, int argc,
 	goto error;
 #endif /* end KNN conditional */
 
+
     if (transaction)
       {
 	  /* confirming the still pending Transaction */
@@ -2880,6 +2885,64 @@ fnct_CreateClonedTable (sqlite3_context * context, int argc,
     return;
 }
 
+static void
+fnct_ClusterGeoTable (sqlite3_context * context, int argc,
+		      sqlite3_value ** argv)
+{
+/* SQL function:
+/ ClusterGeoTable(text table, text geometry)
+/ ClusterGeoTable(text table, text geometry, integer resequence)
+/
+/ physically rewrites the table so that its rows are stored in
+/ Hilbert order of their MBR centroids, reloading any SpatialIndex
+/ in the same order
+/ returns the number of clustered rows on success
+/ -1 on failure (NULL on invalid arguments)
+*/
+    const char *table;
+    const char *geom;
+    int resequence = 0;
+    int ret;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	table = (const char *) sqlite3_value_text (argv[0]);
+    else
+      {
+	  spatialite_e
+	      ("ClusterGeoTable() error: argument 1 is not of the String or TEXT type\n");
+	  sqlite3_result_null (context);
+	  return;
+      }
+    if (sqlite3_value_type (argv[1]) == SQLITE_TEXT)
+	geom = (const char *) sqlite3_value_text (argv[1]);
+    else
+      {
+	  spatialite_e
+	      ("ClusterGeoTable() error: argument 2 is not of the String or TEXT type\n");
+	  sqlite3_result_null (context);
+	  return;
+      }
+    if (argc == 3)
+      {
+	  if (sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+	      resequence = sqlite3_value_int (argv[2]);
+	  else
+	    {
+		spatialite_e
+		    ("ClusterGeoTable() error: argument 3 is not of the Integer type\n");
+		sqlite3_result_null (context);
+		return;
+	    }
+      }
+
+    ret = gaiaAuxClusterGeoTable (sqlite, table, geom, resequence);
+    if (ret >= 0)
+	updateSpatiaLiteHistory (sqlite, table, geom,
+				 "table successfully clustered");
+    sqlite3_result_int (context, ret);
+}
+
 static void
 fnct_CheckGeoPackageMetaData (sqlite3_context * context, int argc,
 			      sqlite3_value ** argv)
@@ -3997,6 +4060,8 @@ fnct_AddGeometryColumn (sqlite3_context * context, int argc,
 	  sqlite3_result_int (context, 0);
 	  return;
       }
+/* lazily populated SPATIAL_REF_SYS: inserting the EPSG def on demand */
+    lazy_insert_epsg_srid (sqlite, srid);
 /* trying to add the column */
     switch (xtype)
       {
@@ -4718,6 +4783,8 @@ fnct_RecoverGeometryColumn (sqlite3_context * context, int argc,
 	  sqlite3_result_int (context, 0);
 	  return;
       }
+/* lazily populated SPATIAL_REF_SYS: inserting the EPSG def on demand */
+    lazy_insert_epsg_srid (sqlite, srid);
 /* adjusting the actual GeometryType */
     xxtype = xtype;
     xtype = GAIA_UNKNOWN;
@@ -6580,6 +6647,11 @@ check_spatial_index (sqlite3 * sqlite, const unsigned char *table,
     if (!is_defined)
 	goto err_label;
 
+/* merging any pending entry of a deferred SpatialIndex */
+    if (flushDeferredSpatialIndex
+	(sqlite, (const char *) table, (const char *) geom) < 0)
+	goto err_label;
+
     xgeom = gaiaDoubleQuotedSql ((char *) geom);
     xtable = gaiaDoubleQuotedSql ((char *) table);
     idx_name = sqlite3_mprintf ("idx_%s_%s", table, geom);
@@ -6948,6 +7020,11 @@ recover_spatial_index (sqlite3 * sqlite, const unsigned char *table,
     if (!is_defined)
 	return -1;
 
+/* emptying the log of a deferred SpatialIndex before rebuilding */
+    if (flushDeferredSpatialIndex
+	(sqlite, (const char *) table, (const char *) geom) < 0)
+	return -1;
+
 /* erasing the R*Tree table */
     idx_name = sqlite3_mprintf ("idx_%s_%s", table, geom);
     xidx_name = gaiaDoubleQuotedSql (idx_name);
@@ -7470,6 +7547,601 @@ fnct_CreateMbrCache (sqlite3_context * context, int argc, sqlite3_value ** argv)
     return;
 }
 
+#define ZONEMAP_DEFAULT_BLOCK	4096
+
+static int
+zonemap_check_geometry (sqlite3 * sqlite, const char *table,
+			const char *column)
+{
+/* checks if Table.Column is a registered Geometry */
+    const char *sql_statement;
+    sqlite3_stmt *stmt;
+    int ret;
+    int found = 0;
+
+    sql_statement = "SELECT f_geometry_column FROM geometry_columns "
+	"WHERE Upper(f_table_name) = Upper(?) "
+	"AND Upper(f_geometry_column) = Upper(?)";
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    sqlite3_bind_text (stmt, 1, table, strlen (table), SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 2, column, strlen (column), SQLITE_STATIC);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	      found = 1;
+      }
+    sqlite3_finalize (stmt);
+    return found;
+}
+
+static int
+zonemap_drop (sqlite3 * sqlite, const char *table, const char *column,
+	      char **errMsg)
+{
+/* dropping a ZoneMap and its triggers (if any) */
+    char *raw;
+    char *quoted_zonemap;
+    char *quoted_ins;
+    char *quoted_upd;
+    char *sql_statement;
+    int ret;
+
+    raw = sqlite3_mprintf ("zm_%s_%s", table, column);
+    quoted_zonemap = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    raw = sqlite3_mprintf ("zmi_%s_%s", table, column);
+    quoted_ins = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    raw = sqlite3_mprintf ("zmu_%s_%s", table, column);
+    quoted_upd = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    sql_statement = sqlite3_mprintf ("DROP TRIGGER IF EXISTS \"%s\";\n"
+				     "DROP TRIGGER IF EXISTS \"%s\";\n"
+				     "DROP TABLE IF EXISTS \"%s\"",
+				     quoted_ins, quoted_upd, quoted_zonemap);
+    free (quoted_zonemap);
+    free (quoted_ins);
+    free (quoted_upd);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    return 1;
+}
+
+static void
+zonemap_free_attributes (char **attributes, int count)
+{
+/* memory cleanup - ZoneMap attribute names */
+    int i;
+    if (attributes == NULL)
+	return;
+    for (i = 0; i < count; i++)
+	free (*(attributes + i));
+    free (attributes);
+}
+
+static int
+zonemap_parse_attributes (sqlite3 * sqlite, const char *table,
+			  const char *list, char ***attributes, int *count)
+{
+/*
+/ parsing a comma separated list of attribute names; all them
+/ are expected to be columns of Table, and their real names
+/ will be returned
+*/
+    char *xtable;
+    char *sql_statement;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int i;
+    int max;
+    const char *p = list;
+    char **names = NULL;
+    int n_names = 0;
+
+    *attributes = NULL;
+    *count = 0;
+    xtable = gaiaDoubleQuotedSql (table);
+    sql_statement = sqlite3_mprintf ("PRAGMA table_info(\"%s\")", xtable);
+    free (xtable);
+    ret =
+	sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			   NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    max = rows;
+    if (max > 0)
+	names = malloc (sizeof (char *) * max);
+    while (1)
+      {
+	  const char *start;
+	  char *token;
+	  int len;
+	  int found = -1;
+	  while (*p == ' ' || *p == '\t')
+	      p++;
+	  start = p;
+	  while (*p != ',' && *p != '\0')
+	      p++;
+	  len = p - start;
+	  while (len > 0 && (start[len - 1] == ' ' || start[len - 1] == '\t'))
+	      len--;
+	  if (len == 0)
+	      goto error;	/* empty attribute name */
+	  token = malloc (len + 1);
+	  memcpy (token, start, len);
+	  *(token + len) = '\0';
+	  for (i = 1; i <= rows; i++)
+	    {
+		if (strcasecmp (results[(i * columns) + 1], token) == 0)
+		    found = i;
+	    }
+	  free (token);
+	  if (found < 0 || n_names >= max)
+	      goto error;	/* not existing column */
+	  *(names + n_names) =
+	      malloc (strlen (results[(found * columns) + 1]) + 1);
+	  strcpy (*(names + n_names), results[(found * columns) + 1]);
+	  n_names++;
+	  if (*p == '\0')
+	      break;
+	  p++;
+      }
+    sqlite3_free_table (results);
+    *attributes = names;
+    *count = n_names;
+    return 1;
+
+  error:
+    sqlite3_free_table (results);
+    zonemap_free_attributes (names, n_names);
+    return 0;
+}
+
+static char *
+zonemap_append (char *prev, char *str)
+{
+/* appending a dynamically allocated string to another one */
+    char *out;
+    if (prev == NULL)
+	return str;
+    out = sqlite3_mprintf ("%s%s", prev, str);
+    sqlite3_free (prev);
+    sqlite3_free (str);
+    return out;
+}
+
+static int
+zonemap_create (sqlite3 * sqlite, const char *table, const char *column,
+		int block_size, char **attributes, int n_attributes,
+		char **errMsg)
+{
+/*
+/ creating (or rebuilding) a ZoneMap
+/
+/ every row of "zm_<table>_<column>" summarizes a block of
+/ <block_size> consecutive ROWIDs by the union of their MBRs
+/ and by the min/max Values of each tracked attribute (if any);
+/ the triggers only ever extend a block, so after DELETE
+/ or UPDATE it could become wider than strictly needed but
+/ it will never miss any row
+/
+/ when no attribute is tracked rows with NULL Geometry are
+/ simply ignored; otherwise every row is summarized, and the
+/ MBR of a block containing only NULL Geometries will be NULL
+*/
+    char *raw;
+    char *quoted_table = NULL;
+    char *quoted_column = NULL;
+    char *quoted_zonemap = NULL;
+    char *quoted_trigger;
+    char *block_old = NULL;
+    char *block_new = NULL;
+    char *attr_defs = sqlite3_mprintf ("%s", "");
+    char *attr_cols = sqlite3_mprintf ("%s", "");
+    char *attr_aggr = sqlite3_mprintf ("%s", "");
+    char *attr_sub = sqlite3_mprintf ("%s", "");
+    char *attr_new = sqlite3_mprintf ("%s", "");
+    char *attr_set = sqlite3_mprintf ("%s", "");
+    const char *not_null = " NOT NULL";
+    const char *where = "WHERE MbrMinX(g) IS NOT NULL";
+    char *when = NULL;
+    char *sql_statement;
+    const char *events[2] = { "INSERT", "UPDATE" };
+    const char *prefix[2] = { "zmi", "zmu" };
+    int i;
+    int ret;
+
+    if (!zonemap_drop (sqlite, table, column, errMsg))
+	goto error;
+
+    raw = sqlite3_mprintf ("zm_%s_%s", table, column);
+    quoted_zonemap = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    quoted_table = gaiaDoubleQuotedSql (table);
+    quoted_column = gaiaDoubleQuotedSql (column);
+/* negative ROWIDs are floor-divided, so that blocks never overlap */
+    block_old =
+	sqlite3_mprintf ("CASE WHEN ROWID >= 0 THEN ROWID / %d "
+			 "ELSE ((ROWID + 1) / %d) - 1 END", block_size,
+			 block_size);
+    block_new =
+	sqlite3_mprintf ("CASE WHEN NEW.ROWID >= 0 THEN NEW.ROWID / %d "
+			 "ELSE ((NEW.ROWID + 1) / %d) - 1 END", block_size,
+			 block_size);
+    if (n_attributes > 0)
+      {
+	  not_null = "";
+	  where = "";
+	  when = sqlite3_mprintf ("%s", "");
+      }
+    else
+	when =
+	    sqlite3_mprintf (" WHEN MbrMinX(NEW.\"%s\") IS NOT NULL",
+			     quoted_column);
+
+/* preparing the attribute min/max columns */
+    for (i = 0; i < n_attributes; i++)
+      {
+	  char *quoted_attr = gaiaDoubleQuotedSql (*(attributes + i));
+	  char *quoted_min;
+	  char *quoted_max;
+	  raw = sqlite3_mprintf ("min_%s", *(attributes + i));
+	  quoted_min = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  raw = sqlite3_mprintf ("max_%s", *(attributes + i));
+	  quoted_max = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  attr_defs =
+	      zonemap_append (attr_defs,
+			      sqlite3_mprintf (",\n\"%s\",\n\"%s\"",
+					       quoted_min, quoted_max));
+	  attr_cols =
+	      zonemap_append (attr_cols,
+			      sqlite3_mprintf (", \"%s\", \"%s\"",
+					       quoted_min, quoted_max));
+	  attr_aggr =
+	      zonemap_append (attr_aggr,
+			      sqlite3_mprintf (", Min(a%d), Max(a%d)", i, i));
+	  attr_sub =
+	      zonemap_append (attr_sub,
+			      sqlite3_mprintf (", \"%s\" AS a%d", quoted_attr,
+					       i));
+	  attr_new =
+	      zonemap_append (attr_new,
+			      sqlite3_mprintf (", NEW.\"%s\", NEW.\"%s\"",
+					       quoted_attr, quoted_attr));
+	  attr_set =
+	      zonemap_append (attr_set,
+			      sqlite3_mprintf
+			      (", \"%s\" = Coalesce(Min(\"%s\", NEW.\"%s\"), "
+			       "\"%s\", NEW.\"%s\"), "
+			       "\"%s\" = Coalesce(Max(\"%s\", NEW.\"%s\"), "
+			       "\"%s\", NEW.\"%s\")", quoted_min, quoted_min,
+			       quoted_attr, quoted_min, quoted_attr,
+			       quoted_max, quoted_max, quoted_attr,
+			       quoted_max, quoted_attr));
+	  free (quoted_attr);
+	  free (quoted_min);
+	  free (quoted_max);
+      }
+
+/* creating the ZoneMap table */
+    sql_statement = sqlite3_mprintf ("CREATE TABLE \"%s\" (\n"
+				     "block_id INTEGER NOT NULL PRIMARY KEY,\n"
+				     "first_rowid INTEGER NOT NULL,\n"
+				     "last_rowid INTEGER NOT NULL,\n"
+				     "minx DOUBLE%s,\n"
+				     "miny DOUBLE%s,\n"
+				     "maxx DOUBLE%s,\n"
+				     "maxy DOUBLE%s%s)",
+				     quoted_zonemap, not_null, not_null,
+				     not_null, not_null, attr_defs);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* initial population */
+    sql_statement =
+	sqlite3_mprintf ("INSERT INTO \"%s\" (block_id, first_rowid, "
+			 "last_rowid, minx, miny, maxx, maxy%s) "
+			 "SELECT blk, blk * %d, (blk * %d) + %d, Min(MbrMinX(g)), "
+			 "Min(MbrMinY(g)), Max(MbrMaxX(g)), Max(MbrMaxY(g))%s "
+			 "FROM (SELECT %s AS blk, \"%s\" AS g%s FROM \"%s\") "
+			 "%s GROUP BY blk", quoted_zonemap, attr_cols,
+			 block_size, block_size, block_size - 1, attr_aggr,
+			 block_old, quoted_column, attr_sub, quoted_table,
+			 where);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, errMsg);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* creating the INSERT and UPDATE triggers */
+    for (i = 0; i < 2; i++)
+      {
+	  raw = sqlite3_mprintf ("%s_%s_%s", prefix[i], table, column);
+	  quoted_trigger = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  sql_statement =
+	      sqlite3_mprintf ("CREATE TRIGGER \"%s\" AFTER %s ON \"%s\"\n"
+			       "FOR EACH ROW%s BEGIN\n"
+			       "INSERT OR IGNORE INTO \"%s\" (block_id, first_rowid, "
+			       "last_rowid, minx, miny, maxx, maxy%s) "
+			       "SELECT blk, blk * %d, (blk * %d) + %d, "
+			       "MbrMinX(NEW.\"%s\"), MbrMinY(NEW.\"%s\"), "
+			       "MbrMaxX(NEW.\"%s\"), MbrMaxY(NEW.\"%s\")%s "
+			       "FROM (SELECT %s AS blk);\n"
+			       "UPDATE \"%s\" SET "
+			       "minx = Coalesce(Min(minx, MbrMinX(NEW.\"%s\")), minx, MbrMinX(NEW.\"%s\")), "
+			       "miny = Coalesce(Min(miny, MbrMinY(NEW.\"%s\")), miny, MbrMinY(NEW.\"%s\")), "
+			       "maxx = Coalesce(Max(maxx, MbrMaxX(NEW.\"%s\")), maxx, MbrMaxX(NEW.\"%s\")), "
+			       "maxy = Coalesce(Max(maxy, MbrMaxY(NEW.\"%s\")), maxy, MbrMaxY(NEW.\"%s\"))%s "
+			       "WHERE block_id = %s;\nEND", quoted_trigger,
+			       events[i], quoted_table, when, quoted_zonemap,
+			       attr_cols, block_size, block_size,
+			       block_size - 1, quoted_column, quoted_column,
+			       quoted_column, quoted_column, attr_new,
+			       block_new, quoted_zonemap, quoted_column,
+			       quoted_column, quoted_column, quoted_column,
+			       quoted_column, quoted_column, quoted_column,
+			       quoted_column, attr_set, block_new);
+	  free (quoted_trigger);
+	  ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, errMsg);
+	  sqlite3_free (sql_statement);
+	  if (ret != SQLITE_OK)
+	      goto error;
+      }
+
+    free (quoted_zonemap);
+    free (quoted_table);
+    free (quoted_column);
+    sqlite3_free (block_old);
+    sqlite3_free (block_new);
+    sqlite3_free (when);
+    sqlite3_free (attr_defs);
+    sqlite3_free (attr_cols);
+    sqlite3_free (attr_aggr);
+    sqlite3_free (attr_sub);
+    sqlite3_free (attr_new);
+    sqlite3_free (attr_set);
+    return 1;
+
+  error:
+    if (quoted_zonemap != NULL)
+	free (quoted_zonemap);
+    if (quoted_table != NULL)
+	free (quoted_table);
+    if (quoted_column != NULL)
+	free (quoted_column);
+    sqlite3_free (block_old);
+    sqlite3_free (block_new);
+    sqlite3_free (when);
+    sqlite3_free (attr_defs);
+    sqlite3_free (attr_cols);
+    sqlite3_free (attr_aggr);
+    sqlite3_free (attr_sub);
+    sqlite3_free (attr_new);
+    sqlite3_free (attr_set);
+    return 0;
+}
+
+static void
+fnct_CreateZoneMap (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ CreateZoneMap(table, column )
+/ CreateZoneMap(table, column, block_size )
+/ CreateZoneMap(table, column, block_size, attributes )
+/
+/ creates (or rebuilds) a ZoneMap based on Column and Table,
+/ i.e. a "zm_<table>_<column>" side table storing the MBR union
+/ of every block of <block_size> consecutive ROWIDs (default 4096),
+/ kept up to date by INSERT and UPDATE triggers
+/ <attributes> is an optional comma separated list of columns
+/ whose min/max Values will be stored as "min_<attr>" and "max_<attr>"
+/
+/ the ZoneMap is intended to be queried through the VirtualZoneMap
+/ module, or to be directly joined on a ROWID range, e.g.
+/   SELECT t.* FROM "zm_t_geom" AS z JOIN t
+/     ON (t.ROWID BETWEEN z.first_rowid AND z.last_rowid)
+/   WHERE z.maxx >= :minx AND z.minx <= :maxx
+/     AND z.maxy >= :miny AND z.miny <= :maxy
+/
+/ returns 1 on success
+/ 0 on failure, -1 on invalid arguments
+*/
+    const char *table;
+    const char *column;
+    char *p_table = NULL;
+    char *p_column = NULL;
+    int block_size = ZONEMAP_DEFAULT_BLOCK;
+    const char *attr_list = NULL;
+    char **attributes = NULL;
+    int n_attributes = 0;
+    char sql[1024];
+    char *errMsg = NULL;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("CreateZoneMap() error: argument 1 [table_name] is not of the String type\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    table = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("CreateZoneMap() error: argument 2 [column_name] is not of the String type\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    column = (const char *) sqlite3_value_text (argv[1]);
+    if (argc >= 3)
+      {
+	  if (argc == 4 && sqlite3_value_type (argv[2]) == SQLITE_NULL)
+	      ;			/* default block size */
+	  else if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	    {
+		spatialite_e
+		    ("CreateZoneMap() error: argument 3 [block_size] is not of the Integer type\n");
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+	  else
+	      block_size = sqlite3_value_int (argv[2]);
+	  if (block_size <= 0)
+	    {
+		spatialite_e
+		    ("CreateZoneMap() error: argument 3 [block_size] must be a positive Integer\n");
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
+    if (argc == 4)
+      {
+	  if (sqlite3_value_type (argv[3]) != SQLITE_TEXT)
+	    {
+		spatialite_e
+		    ("CreateZoneMap() error: argument 4 [attributes] is not of the String type\n");
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+	  attr_list = (const char *) sqlite3_value_text (argv[3]);
+      }
+    if (is_without_rowid_table (sqlite, table))
+      {
+	  spatialite_e
+	      ("CreateZoneMap() error: table '%s' is WITHOUT ROWID\n", table);
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (!validateRowid (sqlite, table))
+      {
+	  spatialite_e
+	      ("CreateZoneMap() error: a physical column named ROWID shadows the real ROWID\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    if (!zonemap_check_geometry (sqlite, table, column)
+	|| !getRealSQLnames (sqlite, table, column, &p_table, &p_column))
+      {
+	  spatialite_e
+	      ("CreateZoneMap() error: \"%s\".\"%s\" isn't a Geometry column\n",
+	       table, column);
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    if (attr_list != NULL)
+      {
+	  if (!zonemap_parse_attributes
+	      (sqlite, p_table, attr_list, &attributes, &n_attributes))
+	    {
+		spatialite_e
+		    ("CreateZoneMap() error: argument 4 [attributes] \"%s\" isn't a list of columns of \"%s\"\n",
+		     attr_list, p_table);
+		free (p_table);
+		free (p_column);
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
+    if (!zonemap_create
+	(sqlite, p_table, p_column, block_size, attributes, n_attributes,
+	 &errMsg))
+	goto error;
+    sqlite3_result_int (context, 1);
+    strcpy (sql, "ZoneMap successfully created");
+    updateSpatiaLiteHistory (sqlite, p_table, p_column, sql);
+    zonemap_free_attributes (attributes, n_attributes);
+    free (p_table);
+    free (p_column);
+    return;
+  error:
+    spatialite_e ("CreateZoneMap() error: \"%s\"\n", errMsg);
+    sqlite3_free (errMsg);
+    zonemap_free_attributes (attributes, n_attributes);
+    free (p_table);
+    free (p_column);
+    sqlite3_result_int (context, 0);
+    return;
+}
+
+static void
+fnct_DropZoneMap (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ DropZoneMap(table, column )
+/
+/ drops the ZoneMap based on Column and Table (and its triggers)
+/ returns 1 on success
+/ 0 on failure, -1 on invalid arguments
+*/
+    const char *table;
+    const char *column;
+    char *p_table = NULL;
+    char *p_column = NULL;
+    char sql[1024];
+    char *errMsg = NULL;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("DropZoneMap() error: argument 1 [table_name] is not of the String type\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    table = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("DropZoneMap() error: argument 2 [column_name] is not of the String type\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    column = (const char *) sqlite3_value_text (argv[1]);
+    if (!getRealSQLnames (sqlite, table, column, &p_table, &p_column))
+      {
+	  spatialite_e
+	      ("DropZoneMap() error: not existing Table or Column\n");
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    if (!zonemap_drop (sqlite, p_table, p_column, &errMsg))
+	goto error;
+    sqlite3_result_int (context, 1);
+    strcpy (sql, "ZoneMap successfully removed");
+    updateSpatiaLiteHistory (sqlite, p_table, p_column, sql);
+    free (p_table);
+    free (p_column);
+    return;
+  error:
+    spatialite_e ("DropZoneMap() error: \"%s\"\n", errMsg);
+    sqlite3_free (errMsg);
+    free (p_table);
+    free (p_column);
+    sqlite3_result_int (context, 0);
+    return;
+}
+
 static void
 fnct_DisableSpatialIndex (sqlite3_context * context, int argc,
 			  sqlite3_value ** argv)
@@ -7536,6 +8208,148 @@ fnct_DisableSpatialIndex (sqlite3_context * context, int argc,
     return;
 }
 
+static void
+fnct_EnableDeferredSpatialIndex (sqlite3_context * context, int argc,
+				 sqlite3_value ** argv)
+{
+/* SQL function:
+/ EnableDeferredSpatialIndex(table, column )
+/ EnableDeferredSpatialIndex(table, column, batch_size )
+/
+/ switches an R*Tree SpatialIndex to deferred (write optimized) mode:
+/ the triggers will append the new MBRs to a log table that will be
+/ merged into the R*Tree in sorted batches of batch_size entries
+/ (default 8192) or when FlushSpatialIndex() is called
+/ returns 1 on success
+/ 0 on failure
+*/
+    const char *table;
+    const char *column;
+    int batch_size = 8192;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("EnableDeferredSpatialIndex() error: argument 1 [table_name] is not of the String type\n");
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    table = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("EnableDeferredSpatialIndex() error: argument 2 [column_name] is not of the String type\n");
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    column = (const char *) sqlite3_value_text (argv[1]);
+    if (argc == 3)
+      {
+	  if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	    {
+		spatialite_e
+		    ("EnableDeferredSpatialIndex() error: argument 3 [batch_size] is not of the Integer type\n");
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+	  batch_size = sqlite3_value_int (argv[2]);
+	  if (batch_size <= 0)
+	    {
+		spatialite_e
+		    ("EnableDeferredSpatialIndex() error: argument 3 [batch_size] must be a positive value\n");
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+      }
+    if (!enableDeferredSpatialIndex (sqlite, table, column, batch_size))
+      {
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    sqlite3_result_int (context, 1);
+    updateSpatiaLiteHistory (sqlite, table, column,
+			     "SpatialIndex successfully switched to deferred mode");
+}
+
+static void
+fnct_DisableDeferredSpatialIndex (sqlite3_context * context, int argc,
+				  sqlite3_value ** argv)
+{
+/* SQL function:
+/ DisableDeferredSpatialIndex(table, column )
+/
+/ merges any pending entry into the R*Tree and switches a deferred
+/ SpatialIndex back to immediate mode
+/ returns 1 on success
+/ 0 on failure
+*/
+    const char *table;
+    const char *column;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("DisableDeferredSpatialIndex() error: argument 1 [table_name] is not of the String type\n");
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    table = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("DisableDeferredSpatialIndex() error: argument 2 [column_name] is not of the String type\n");
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    column = (const char *) sqlite3_value_text (argv[1]);
+    if (!disableDeferredSpatialIndex (sqlite, table, column))
+      {
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    sqlite3_result_int (context, 1);
+    updateSpatiaLiteHistory (sqlite, table, column,
+			     "SpatialIndex successfully switched to immediate mode");
+}
+
+static void
+fnct_FlushSpatialIndex (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
+{
+/* SQL function:
+/ FlushSpatialIndex(table, column )
+/
+/ merges all pending entries of a deferred SpatialIndex into
+/ the corresponding R*Tree
+/ returns the number of merged log entries (0 if nothing was pending)
+/ -1 on failure
+*/
+    const char *table;
+    const char *column;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("FlushSpatialIndex() error: argument 1 [table_name] is not of the String type\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    table = (const char *) sqlite3_value_text (argv[0]);
+    if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
+      {
+	  spatialite_e
+	      ("FlushSpatialIndex() error: argument 2 [column_name] is not of the String type\n");
+	  sqlite3_result_int (context, -1);
+	  return;
+      }
+    column = (const char *) sqlite3_value_text (argv[1]);
+    sqlite3_result_int (context,
+			flushDeferredSpatialIndex (sqlite, table, column));
+}
+
 static void
 fnct_RebuildGeometryTriggers (sqlite3_context * context, int argc,
 			      sqlite3_value ** argv)
@@ -7609,17 +8423,71 @@ fnct_UpdateLayerStatistics (sqlite3_context * context, int argc,
 {
 /* SQL function:
 / UpdateLayerStatistics(table, column )
+/ UpdateLayerStatistics(table, column, mode )
+/ UpdateLayerStatistics(table, column, mode, sample_rate )
 /
 / Updates LAYER_STATISTICS [based on Column and Table]
+/ mode is one of 'FULL' (default), 'INCREMENTAL' or 'SAMPLED'
+/ (table and column may be NULL when mode is specified)
 / returns 1 on success
 / 0 on failure
 */
     const char *sql;
     const char *table = NULL;
     const char *column = NULL;
+    int mode = SPLITE_STATS_FULL;
+    double sample_rate = 0.01;
     sqlite3 *sqlite = sqlite3_context_db_handle (context);
     GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (argc >= 1)
+    if (argc >= 3)
+      {
+	  const char *str;
+	  if (sqlite3_value_type (argv[2]) != SQLITE_TEXT)
+	    {
+		spatialite_e
+		    ("UpdateLayerStatistics() error: argument 3 [mode] is not of the String type\n");
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+	  str = (const char *) sqlite3_value_text (argv[2]);
+	  if (strcasecmp (str, "FULL") == 0)
+	      mode = SPLITE_STATS_FULL;
+	  else if (strcasecmp (str, "INCREMENTAL") == 0)
+	      mode = SPLITE_STATS_INCREMENTAL;
+	  else if (strcasecmp (str, "SAMPLED") == 0)
+	      mode = SPLITE_STATS_SAMPLED;
+	  else
+	    {
+		spatialite_e
+		    ("UpdateLayerStatistics() error: argument 3 [mode] is not one of FULL, INCREMENTAL or SAMPLED\n");
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+      }
+    if (argc >= 4)
+      {
+	  if (sqlite3_value_type (argv[3]) == SQLITE_FLOAT)
+	      sample_rate = sqlite3_value_double (argv[3]);
+	  else if (sqlite3_value_type (argv[3]) == SQLITE_INTEGER)
+	      sample_rate = sqlite3_value_int (argv[3]);
+	  else
+	    {
+		spatialite_e
+		    ("UpdateLayerStatistics() error: argument 4 [sample_rate] is not of the Numeric type\n");
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+	  if (sample_rate <= 0.0 || sample_rate > 1.0)
+	    {
+		spatialite_e
+		    ("UpdateLayerStatistics() error: argument 4 [sample_rate] must be > 0.0 and <= 1.0\n");
+		sqlite3_result_int (context, 0);
+		return;
+	    }
+      }
+    if (argc >= 3 && sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	;
+    else if (argc >= 1)
       {
 	  if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
 	    {
@@ -7630,7 +8498,9 @@ fnct_UpdateLayerStatistics (sqlite3_context * context, int argc,
 	    }
 	  table = (const char *) sqlite3_value_text (argv[0]);
       }
-    if (argc >= 2)
+    if (argc >= 3 && sqlite3_value_type (argv[1]) == SQLITE_NULL)
+	;
+    else if (argc >= 2)
       {
 	  if (sqlite3_value_type (argv[1]) != SQLITE_TEXT)
 	    {
@@ -7641,7 +8511,14 @@ fnct_UpdateLayerStatistics (sqlite3_context * context, int argc,
 	    }
 	  column = (const char *) sqlite3_value_text (argv[1]);
       }
-    if (!update_layer_statistics (sqlite, table, column))
+    if (table == NULL && column != NULL)
+      {
+	  spatialite_e
+	      ("UpdateLayerStatistics() error: argument 1 [table_name] is NULL but argument 2 [column_name] is not\n");
+	  sqlite3_result_int (context, 0);
+	  return;
+      }
+    if (!update_layer_statistics_ex (sqlite, table, column, mode, sample_rate))
 	goto error;
     sqlite3_result_int (context, 1);
     sql = "UpdateLayerStatistics";
@@ -19916,6 +20793,79 @@ getEllipsoidParams (void *p_sqlite, int srid, double *a, double *b, double *rf)
     return 0;
 }
 
+SPATIALITE_PRIVATE int
+getEllipsoidParamsEx (const void *p_cache, void *p_sqlite, int srid,
+		      double *a, double *b, double *rf)
+{
+/* 
+/ same as getEllipsoidParams, but caching the ellipsoid params
+/ for the most recently used SRIDs into the connection cache,
+/ so to avoid querying SPATIAL_REF_SYS for every row
+/
+/ the whole cache is discarded as soon as the DB has been
+/ modified (by this or by any other connection) since the
+/ cached items were loaded, so that any change affecting
+/ SPATIAL_REF_SYS will always be immediately visible
+*/
+    struct splite_internal_cache *cache =
+	(struct splite_internal_cache *) p_cache;
+    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
+    struct splite_ellps_cache_item *p;
+    int total_changes;
+    unsigned int data_version = 0;
+    int i;
+    if (cache == NULL)
+	return getEllipsoidParams (p_sqlite, srid, a, b, rf);
+#if SQLITE_VERSION_NUMBER >= 3034000
+    if (sqlite3_txn_state (sqlite, "main") == SQLITE_TXN_NONE)
+      {
+	  /* no open transaction: the data version could be outdated */
+	  return getEllipsoidParams (p_sqlite, srid, a, b, rf);
+      }
+#endif
+    total_changes = sqlite3_total_changes (sqlite);
+#ifdef SQLITE_FCNTL_DATA_VERSION
+    if (sqlite3_file_control
+	(sqlite, "main", SQLITE_FCNTL_DATA_VERSION,
+	 &data_version) != SQLITE_OK)
+	data_version = 0;
+#endif
+    if (total_changes != cache->ellps_total_changes
+	|| data_version != cache->ellps_data_version)
+      {
+	  /* the DB has changed; invalidating the cache */
+	  for (i = 0; i < MAX_ELLPS_CACHE; i++)
+	      cache->ellpsCache[i].srid = -1;
+	  cache->next_ellps_cache = 0;
+	  cache->ellps_total_changes = total_changes;
+	  cache->ellps_data_version = data_version;
+      }
+    for (i = 0; i < MAX_ELLPS_CACHE; i++)
+      {
+	  p = &(cache->ellpsCache[i]);
+	  if (p->srid >= 0 && p->srid == srid)
+	    {
+		/* found a cached item */
+		*a = p->a;
+		*b = p->b;
+		*rf = p->rf;
+		return 1;
+	    }
+      }
+    if (!getEllipsoidParams (p_sqlite, srid, a, b, rf))
+	return 0;
+/* updating the cache */
+    p = &(cache->ellpsCache[cache->next_ellps_cache]);
+    p->srid = srid;
+    p->a = *a;
+    p->b = *b;
+    p->rf = *rf;
+    cache->next_ellps_cache += 1;
+    if (cache->next_ellps_cache >= MAX_ELLPS_CACHE)
+	cache->next_ellps_cache = 0;
+    return 1;
+}
+
 static void
 fnct_FromEWKB (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -21678,7 +22628,8 @@ length_common (const void *p_cache, sqlite3_context * context, int argc,
 	  if (use_ellipsoid >= 0)
 	    {
 		/* attempting to identify the corresponding ellipsoid */
-		if (getEllipsoidParams (sqlite, geo->Srid, &a, &b, &rf))
+		if (getEllipsoidParamsEx
+		    (cache, sqlite, geo->Srid, &a, &b, &rf))
 		  {
 		      double l;
 		      int ib;
@@ -22180,7 +23131,8 @@ fnct_Area (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	    {
 #ifdef ENABLE_RTTOPO		/* only if RTTOPO is enabled */
 		/* attempting to identify the corresponding ellipsoid */
-		if (getEllipsoidParams (sqlite, geo->Srid, &a, &b, &rf))
+		if (getEllipsoidParamsEx
+		    (cache, sqlite, geo->Srid, &a, &b, &rf))
 		    ret =
 			gaiaGeodesicArea (cache, geo, a, b, use_ellipsoid,
 					  &area);
@@ -22299,7 +23251,8 @@ fnct_Circularity (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	    {
 #ifdef ENABLE_RTTOPO		/* only if RTTOPO is enabled */
 		/* attempting to identify the corresponding ellipsoid */
-		if (getEllipsoidParams (sqlite, geo->Srid, &a, &b, &rf))
+		if (getEllipsoidParamsEx
+		    (cache, sqlite, geo->Srid, &a, &b, &rf))
 		    ret = 1;
 		else
 		    ret = 0;
@@ -23810,6 +24763,352 @@ fnct_Contains (sqlite3_context * context, int argc, sqlite3_value ** argv)
     gaiaFreeGeomColl (geo2);
 }
 
+#define PIP_JOIN_BATCH	65536
+
+static int
+pip_join_load_polygons (sqlite3 * sqlite, struct splite_internal_cache *cache,
+			const char *table, const char *column,
+			gaiaGeomCollPtr ** polygons, sqlite3_int64 ** rowids,
+			int *count)
+{
+/* loading all Polygons into memory */
+    char *sql;
+    char *xtable;
+    char *xcolumn;
+    int ret;
+    int max = 0;
+    int gpkg_amphibious = 0;
+    int gpkg_mode = 0;
+    sqlite3_stmt *stmt = NULL;
+
+    *polygons = NULL;
+    *rowids = NULL;
+    *count = 0;
+    if (cache != NULL)
+      {
+	  gpkg_amphibious = cache->gpkg_amphibious_mode;
+	  gpkg_mode = cache->gpkg_mode;
+      }
+    xtable = gaiaDoubleQuotedSql (table);
+    xcolumn = gaiaDoubleQuotedSql (column);
+    sql = sqlite3_mprintf ("SELECT ROWID, \"%s\" FROM \"%s\"", xcolumn,
+			   xtable);
+    free (xtable);
+    free (xcolumn);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  const unsigned char *blob;
+	  int blob_sz;
+	  gaiaGeomCollPtr geom;
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	    {
+		sqlite3_finalize (stmt);
+		return 0;
+	    }
+	  if (sqlite3_column_type (stmt, 1) != SQLITE_BLOB)
+	      continue;
+	  blob = sqlite3_column_blob (stmt, 1);
+	  blob_sz = sqlite3_column_bytes (stmt, 1);
+	  geom =
+	      gaiaFromSpatiaLiteBlobWkbEx (blob, blob_sz, gpkg_mode,
+					   gpkg_amphibious);
+	  if (geom == NULL)
+	      continue;
+	  if (*count >= max)
+	    {
+		max = (max == 0) ? 1024 : max * 2;
+		*polygons = realloc (*polygons, sizeof (gaiaGeomCollPtr) * max);
+		*rowids = realloc (*rowids, sizeof (sqlite3_int64) * max);
+	    }
+	  *(*polygons + *count) = geom;
+	  *(*rowids + *count) = sqlite3_column_int64 (stmt, 0);
+	  *count += 1;
+      }
+    sqlite3_finalize (stmt);
+    return 1;
+}
+
+static int
+pip_join_flush (sqlite3_stmt * stmt, struct splite_internal_cache *cache,
+		void *join, const double *x, const double *y,
+		const sqlite3_int64 * pt_rowids, int n_points,
+		const sqlite3_int64 * pg_rowids, int num_threads, int *count)
+{
+/* joining a batch of Points, then inserting all matching pairs */
+    int i;
+    int ret;
+    int *pairs;
+    int n_pairs;
+    if (!gaiaPointInPolygonJoin
+	(cache, join, x, y, n_points, num_threads, &pairs, &n_pairs))
+	return 0;
+    for (i = 0; i < n_pairs; i++)
+      {
+	  sqlite3_reset (stmt);
+	  sqlite3_clear_bindings (stmt);
+	  sqlite3_bind_int64 (stmt, 1, *(pt_rowids + *(pairs + (i * 2))));
+	  sqlite3_bind_int64 (stmt, 2,
+			      *(pg_rowids + *(pairs + (i * 2) + 1)));
+	  ret = sqlite3_step (stmt);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	    {
+		free (pairs);
+		return 0;
+	    }
+      }
+    if (pairs != NULL)
+	free (pairs);
+    *count += n_pairs;
+    return 1;
+}
+
+static int
+do_point_in_polygon_join (sqlite3 * sqlite,
+			  struct splite_internal_cache *cache,
+			  const char *pt_table, const char *pt_column,
+			  const char *pg_table, const char *pg_column,
+			  const char *out_table, int num_threads)
+{
+/* creating and populating a Point-in-Polygon join table */
+    char *sql;
+    char *xtable;
+    char *xcolumn;
+    int ret;
+    int i;
+    int count = 0;
+    int n_points = 0;
+    int n_polygons = 0;
+    int gpkg_amphibious = 0;
+    int gpkg_mode = 0;
+    gaiaGeomCollPtr *polygons = NULL;
+    sqlite3_int64 *pg_rowids = NULL;
+    sqlite3_int64 *pt_rowids = NULL;
+    double *x = NULL;
+    double *y = NULL;
+    void *join = NULL;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_out = NULL;
+
+    if (cache != NULL)
+      {
+	  gpkg_amphibious = cache->gpkg_amphibious_mode;
+	  gpkg_mode = cache->gpkg_mode;
+      }
+    ret =
+	sqlite3_exec (sqlite, "SAVEPOINT point_in_polygon_join", NULL, NULL,
+		      NULL);
+    if (ret != SQLITE_OK)
+	return -1;
+
+/* loading and indexing all Polygons */
+    if (!pip_join_load_polygons
+	(sqlite, cache, pg_table, pg_column, &polygons, &pg_rowids,
+	 &n_polygons))
+	goto error;
+    if (n_polygons > 0)
+	join = gaiaCreatePointInPolygonJoin (polygons, n_polygons);
+
+/* creating the output table */
+    xtable = gaiaDoubleQuotedSql (out_table);
+    sql = sqlite3_mprintf ("CREATE TABLE \"%s\" (\n"
+			   "\tpoint_rowid INTEGER NOT NULL,\n"
+			   "\tpolygon_rowid INTEGER NOT NULL,\n"
+			   "\tPRIMARY KEY (point_rowid, polygon_rowid))",
+			   xtable);
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtable);
+	  goto error;
+      }
+    sql = sqlite3_mprintf ("INSERT INTO \"%s\" (point_rowid, polygon_rowid) "
+			   "VALUES (?, ?)", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt_out, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    if (join == NULL)
+	goto done;		/* no Polygon at all: nothing to join */
+
+/* streaming all Points by batches */
+    xtable = gaiaDoubleQuotedSql (pt_table);
+    xcolumn = gaiaDoubleQuotedSql (pt_column);
+    sql = sqlite3_mprintf ("SELECT ROWID, \"%s\" FROM \"%s\"", xcolumn,
+			   xtable);
+    free (xtable);
+    free (xcolumn);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt_in, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    pt_rowids = malloc (sizeof (sqlite3_int64) * PIP_JOIN_BATCH);
+    x = malloc (sizeof (double) * PIP_JOIN_BATCH);
+    y = malloc (sizeof (double) * PIP_JOIN_BATCH);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  const unsigned char *blob;
+	  int blob_sz;
+	  gaiaGeomCollPtr geom;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  if (sqlite3_column_type (stmt_in, 1) != SQLITE_BLOB)
+	      continue;
+	  blob = sqlite3_column_blob (stmt_in, 1);
+	  blob_sz = sqlite3_column_bytes (stmt_in, 1);
+	  geom =
+	      gaiaFromSpatiaLiteBlobWkbEx (blob, blob_sz, gpkg_mode,
+					   gpkg_amphibious);
+	  if (geom == NULL)
+	      continue;
+	  if (geom->FirstPoint != NULL && geom->FirstPoint == geom->LastPoint
+	      && geom->FirstLinestring == NULL && geom->FirstPolygon == NULL)
+	    {
+		/* accepting only single Points */
+		*(pt_rowids + n_points) = sqlite3_column_int64 (stmt_in, 0);
+		*(x + n_points) = geom->FirstPoint->X;
+		*(y + n_points) = geom->FirstPoint->Y;
+		n_points++;
+	    }
+	  gaiaFreeGeomColl (geom);
+	  if (n_points == PIP_JOIN_BATCH)
+	    {
+		if (!pip_join_flush
+		    (stmt_out, cache, join, x, y, pt_rowids, n_points,
+		     pg_rowids, num_threads, &count))
+		    goto error;
+		n_points = 0;
+	    }
+      }
+    if (n_points > 0)
+      {
+	  if (!pip_join_flush
+	      (stmt_out, cache, join, x, y, pt_rowids, n_points, pg_rowids,
+	       num_threads, &count))
+	      goto error;
+      }
+
+  done:
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    sqlite3_finalize (stmt_out);
+    stmt_in = NULL;
+    stmt_out = NULL;
+    ret =
+	sqlite3_exec (sqlite, "RELEASE SAVEPOINT point_in_polygon_join", NULL,
+		      NULL, NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    goto cleanup;
+
+  error:
+    spatialite_e ("PointInPolygonJoin() error: %s\n",
+		  sqlite3_errmsg (sqlite));
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_out != NULL)
+	sqlite3_finalize (stmt_out);
+    sqlite3_exec (sqlite, "ROLLBACK TO SAVEPOINT point_in_polygon_join", NULL,
+		  NULL, NULL);
+    sqlite3_exec (sqlite, "RELEASE SAVEPOINT point_in_polygon_join", NULL,
+		  NULL, NULL);
+    count = -1;
+
+  cleanup:
+    if (join != NULL)
+	gaiaFreePointInPolygonJoin (join);
+    for (i = 0; i < n_polygons; i++)
+	gaiaFreeGeomColl (*(polygons + i));
+    if (polygons != NULL)
+	free (polygons);
+    if (pg_rowids != NULL)
+	free (pg_rowids);
+    if (pt_rowids != NULL)
+	free (pt_rowids);
+    if (x != NULL)
+	free (x);
+    if (y != NULL)
+	free (y);
+    return count;
+}
+
+static void
+fnct_PointInPolygonJoin (sqlite3_context * context, int argc,
+			 sqlite3_value ** argv)
+{
+/* SQL function:
+/ PointInPolygonJoin(TEXT points_table, TEXT points_geom,
+/                    TEXT polygons_table, TEXT polygons_geom,
+/                    TEXT out_table)
+/ PointInPolygonJoin(TEXT points_table, TEXT points_geom,
+/                    TEXT polygons_table, TEXT polygons_geom,
+/                    TEXT out_table, int num_threads)
+/
+/ creates a new table (point_rowid, polygon_rowid) containing all
+/ pairs for which the Polygon contains the Point; Polygons are loaded
+/ and indexed just once, then Points are streamed by batches and 
+/ possibly evaluated by many parallel threads
+/
+/ returns:
+/ the number of inserted pairs
+/ NULL on invalid arguments or failure
+*/
+    const char *pt_table;
+    const char *pt_column;
+    const char *pg_table;
+    const char *pg_column;
+    const char *out_table;
+    int num_threads = 1;
+    int count;
+    int i;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    struct splite_internal_cache *cache = sqlite3_user_data (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    for (i = 0; i < 5; i++)
+      {
+	  if (sqlite3_value_type (argv[i]) != SQLITE_TEXT)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+      }
+    pt_table = (const char *) sqlite3_value_text (argv[0]);
+    pt_column = (const char *) sqlite3_value_text (argv[1]);
+    pg_table = (const char *) sqlite3_value_text (argv[2]);
+    pg_column = (const char *) sqlite3_value_text (argv[3]);
+    out_table = (const char *) sqlite3_value_text (argv[4]);
+    if (argc >= 6)
+      {
+	  if (sqlite3_value_type (argv[5]) != SQLITE_INTEGER)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  num_threads = sqlite3_value_int (argv[5]);
+      }
+    count =
+	do_point_in_polygon_join (sqlite, cache, pt_table, pt_column,
+				  pg_table, pg_column, out_table,
+				  num_threads);
+    if (count < 0)
+	sqlite3_result_null (context);
+    else
+	sqlite3_result_int (context, count);
+}
+
 static void
 fnct_Relate (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -23972,6 +25271,81 @@ fnct_RelateMatch (sqlite3_context * context, int argc, sqlite3_value ** argv)
     sqlite3_result_int (context, ret);
 }
 
+static int
+geodesic_points_distance (gaiaGeomCollPtr geo1, gaiaGeomCollPtr geo2,
+			  int use_ellipsoid, double a, double b, double rf,
+			  double *dist)
+{
+/*
+/ computing the minimum geodesic (or great circle) distance between
+/ two sets of Points; all pairs sharing the same first Point are
+/ evaluated by a single batch
+/
+/ returns 0 if any Geometry isn't a (Multi)Point, or on failure
+*/
+    int n2 = 0;
+    int i;
+    int ok = 1;
+    double min = DBL_MAX;
+    double *lat1;
+    double *lon1;
+    double *lat2;
+    double *lon2;
+    double *d;
+    gaiaPointPtr pt;
+    if (geo1->FirstPoint == NULL || geo1->FirstLinestring != NULL
+	|| geo1->FirstPolygon != NULL)
+	return 0;
+    if (geo2->FirstPoint == NULL || geo2->FirstLinestring != NULL
+	|| geo2->FirstPolygon != NULL)
+	return 0;
+    pt = geo2->FirstPoint;
+    while (pt)
+      {
+	  n2++;
+	  pt = pt->Next;
+      }
+    lat1 = malloc (sizeof (double) * n2 * 5);
+    lon1 = lat1 + n2;
+    lat2 = lon1 + n2;
+    lon2 = lat2 + n2;
+    d = lon2 + n2;
+    i = 0;
+    pt = geo2->FirstPoint;
+    while (pt)
+      {
+	  lat2[i] = pt->Y;
+	  lon2[i] = pt->X;
+	  i++;
+	  pt = pt->Next;
+      }
+    pt = geo1->FirstPoint;
+    while (pt && ok)
+      {
+	  for (i = 0; i < n2; i++)
+	    {
+		lat1[i] = pt->Y;
+		lon1[i] = pt->X;
+	    }
+	  if (use_ellipsoid)
+	      ok = gaiaGeodesicDistances (a, b, rf, n2, lat1, lon1, lat2,
+					  lon2, d);
+	  else
+	      gaiaGreatCircleDistances (a, b, n2, lat1, lon1, lat2, lon2, d);
+	  for (i = 0; i < n2; i++)
+	    {
+		if (d[i] < min)
+		    min = d[i];
+	    }
+	  pt = pt->Next;
+      }
+    free (lat1);
+    if (!ok)
+	return 0;
+    *dist = min;
+    return 1;
+}
+
 static void
 fnct_Distance (sqlite3_context * context, int argc, sqlite3_value ** argv)
 {
@@ -24052,9 +25426,29 @@ fnct_Distance (sqlite3_context * context, int argc, sqlite3_value ** argv)
 		  }
 
 		/* attempting to identify the corresponding ellipsoid */
-		if (getEllipsoidParams (sqlite, geo1->Srid, &a, &b, &rf))
+		if (getEllipsoidParamsEx
+		    (cache, sqlite, geo1->Srid, &a, &b, &rf))
 		  {
 		      gaiaGeomCollPtr shortest;
+		      if (!use_ellipsoid)
+			{
+			    a = 6378137.0;
+			    rf = 298.257223563;
+			    b = (a * (1.0 - (1.0 / rf)));
+			}
+		      if (geo1->FirstLinestring == NULL
+			  && geo1->FirstPolygon == NULL
+			  && geo2->FirstLinestring == NULL
+			  && geo2->FirstPolygon == NULL)
+			{
+			    /* Points only: evaluating all pairs by batch */
+			    if (geodesic_points_distance
+				(geo1, geo2, use_ellipsoid, a, b, rf, &dist))
+				sqlite3_result_double (context, dist);
+			    else
+				sqlite3_result_null (context);
+			    goto stop;
+			}
 		      if (data != NULL)
 			  shortest = gaiaShortestLine_r (data, geo1, geo2);
 		      else
@@ -24123,17 +25517,10 @@ fnct_Distance (sqlite3_context * context, int argc, sqlite3_value ** argv)
 								rf, y0,
 								x0, y1, x1);
 				  else
-				    {
-					a = 6378137.0;
-					rf = 298.257223563;
-					b = (a * (1.0 - (1.0 / rf)));
-					dist =
-					    gaiaGreatCircleDistance (a,
-								     b,
-								     y0,
-								     x0,
-								     y1, x1);
-				    }
+				      dist =
+					  gaiaGreatCircleDistance (a, b,
+								   y0, x0,
+								   y1, x1);
 				  if (dist < 0.0)
 				    {
 					/* invalid distance */
@@ -27031,6 +28418,464 @@ fnct_ConcaveHull (sqlite3_context * context, int argc, sqlite3_value ** argv)
     gaiaFreeGeomColl (geo);
 }
 
+static void
+fnct_Subdivide (sqlite3_context * context, int argc, sqlite3_value ** argv)
+{
+/* SQL function:
+/ Subdivide(BLOBencoded geometry, int max_vertices)
+/ Subdivide(BLOBencoded geometry, int max_vertices, int num_threads)
+/
+/ recursively splits the input geometry by quadrant clipping, so that
+/ each returned piece will contain no more than max_vertices
+/ NULL is returned for invalid arguments
+*/
+    unsigned char *p_blob;
+    int n_bytes;
+    gaiaGeomCollPtr geo = NULL;
+    gaiaGeomCollPtr result;
+    int max_vertices;
+    int num_threads = 1;
+    int gpkg_amphibious = 0;
+    int gpkg_mode = 0;
+    struct splite_internal_cache *cache = sqlite3_user_data (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (cache != NULL)
+      {
+	  gpkg_amphibious = cache->gpkg_amphibious_mode;
+	  gpkg_mode = cache->gpkg_mode;
+      }
+    if (sqlite3_value_type (argv[0]) != SQLITE_BLOB)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    max_vertices = sqlite3_value_int (argv[1]);
+    if (argc >= 3)
+      {
+	  if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  num_threads = sqlite3_value_int (argv[2]);
+      }
+    p_blob = (unsigned char *) sqlite3_value_blob (argv[0]);
+    n_bytes = sqlite3_value_bytes (argv[0]);
+    geo =
+	gaiaFromSpatiaLiteBlobWkbEx (p_blob, n_bytes, gpkg_mode,
+				     gpkg_amphibious);
+    if (geo == NULL)
+	sqlite3_result_null (context);
+    else
+      {
+	  result = gaiaSubdivide (cache, geo, max_vertices, num_threads);
+	  if (result == NULL)
+	      sqlite3_result_null (context);
+	  else
+	    {
+		/* builds the BLOB geometry to be returned */
+		int len;
+		unsigned char *p_result = NULL;
+		result->Srid = geo->Srid;
+		gaiaToSpatiaLiteBlobWkbEx (result, &p_result, &len, gpkg_mode);
+		sqlite3_result_blob (context, p_result, len, free);
+		gaiaFreeGeomColl (result);
+	    }
+      }
+    gaiaFreeGeomColl (geo);
+}
+
+static int
+do_insert_subdivided_piece (sqlite3_stmt * stmt, sqlite3_int64 parent_id,
+			    gaiaGeomCollPtr piece, int gpkg_mode)
+{
+/* inserting a single elementary piece into the shadow table */
+    int ret;
+    int len;
+    unsigned char *p_blob = NULL;
+
+    gaiaToSpatiaLiteBlobWkbEx (piece, &p_blob, &len, gpkg_mode);
+    if (p_blob == NULL)
+	return 0;
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    sqlite3_bind_int64 (stmt, 1, parent_id);
+    sqlite3_bind_blob (stmt, 2, p_blob, len, free);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	return 1;
+    return 0;
+}
+
+static int
+do_insert_subdivided (sqlite3_stmt * stmt, sqlite3_int64 parent_id,
+		      gaiaGeomCollPtr pieces, int gtype, int gpkg_mode)
+{
+/* 
+/ inserting all pieces into the shadow table (one row for each piece)
+/
+/ each item is temporarily detached from the list of pieces, so to
+/ be encoded as an elementary Geometry without copying any vertex;
+/ items not matching the shadow table's class (degenerate leftovers
+/ on the quadrant's boundaries) are simply skipped
+*/
+    int count = 0;
+    int ok = 1;
+    gaiaPointPtr pt;
+    gaiaLinestringPtr ln;
+    gaiaPolygonPtr pg;
+    gaiaGeomCollPtr elem = gaiaAllocGeomColl ();
+    elem->Srid = pieces->Srid;
+    elem->DimensionModel = pieces->DimensionModel;
+
+    if (gtype == GAIA_POINT || gtype == GAIA_UNKNOWN)
+      {
+	  pt = pieces->FirstPoint;
+	  while (pt && ok)
+	    {
+		gaiaPointPtr next = pt->Next;
+		pt->Next = NULL;
+		elem->FirstPoint = pt;
+		elem->LastPoint = pt;
+		ok = do_insert_subdivided_piece (stmt, parent_id, elem,
+						 gpkg_mode);
+		pt->Next = next;
+		count++;
+		pt = next;
+	    }
+      }
+    elem->FirstPoint = NULL;
+    elem->LastPoint = NULL;
+    if (gtype == GAIA_LINESTRING || gtype == GAIA_UNKNOWN)
+      {
+	  ln = pieces->FirstLinestring;
+	  while (ln && ok)
+	    {
+		gaiaLinestringPtr next = ln->Next;
+		ln->Next = NULL;
+		elem->FirstLinestring = ln;
+		elem->LastLinestring = ln;
+		ok = do_insert_subdivided_piece (stmt, parent_id, elem,
+						 gpkg_mode);
+		ln->Next = next;
+		count++;
+		ln = next;
+	    }
+      }
+    elem->FirstLinestring = NULL;
+    elem->LastLinestring = NULL;
+    if (gtype == GAIA_POLYGON || gtype == GAIA_UNKNOWN)
+      {
+	  pg = pieces->FirstPolygon;
+	  while (pg && ok)
+	    {
+		gaiaPolygonPtr next = pg->Next;
+		pg->Next = NULL;
+		elem->FirstPolygon = pg;
+		elem->LastPolygon = pg;
+		ok = do_insert_subdivided_piece (stmt, parent_id, elem,
+						 gpkg_mode);
+		pg->Next = next;
+		count++;
+		pg = next;
+	    }
+      }
+    elem->FirstPolygon = NULL;
+    elem->LastPolygon = NULL;
+    gaiaFreeGeomColl (elem);
+    if (!ok)
+	return -1;
+    return count;
+}
+
+static int
+do_subdivide_geotable (sqlite3 * sqlite, struct splite_internal_cache *cache,
+		       const char *in_table, const char *geo_column,
+		       const char *out_table, int max_vertices,
+		       int num_threads)
+{
+/* creating and populating a Subdivide shadow table */
+    char *sql;
+    char *xtable;
+    char *xcolumn;
+    char *xindex;
+    char *index;
+    const char *type = "GEOMETRY";
+    const char *dims = "XY";
+    int gtype = GAIA_UNKNOWN;
+    int srid = -1;
+    int geom_type = -1;
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    int count = 0;
+    int gpkg_amphibious = 0;
+    int gpkg_mode = 0;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_out = NULL;
+
+    if (cache != NULL)
+      {
+	  gpkg_amphibious = cache->gpkg_amphibious_mode;
+	  gpkg_mode = cache->gpkg_mode;
+      }
+
+/* checking the input GeoTable */
+    sql = sqlite3_mprintf ("SELECT srid, geometry_type FROM geometry_columns "
+			   "WHERE Lower(f_table_name) = Lower(%Q) AND "
+			   "Lower(f_geometry_column) = Lower(%Q)", in_table,
+			   geo_column);
+    ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return -1;
+    for (i = 1; i <= rows; i++)
+      {
+	  srid = atoi (results[(i * columns) + 0]);
+	  geom_type = atoi (results[(i * columns) + 1]);
+      }
+    sqlite3_free_table (results);
+    if (geom_type < 0)
+	return -1;
+
+/* the output table must not already exist */
+    sql = sqlite3_mprintf ("SELECT name FROM sqlite_master "
+			   "WHERE Lower(name) = Lower(%Q)", out_table);
+    ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return -1;
+    sqlite3_free_table (results);
+    if (rows > 0)
+	return -1;
+    switch (geom_type % 1000)
+      {
+      case 1:
+      case 4:
+	  type = "POINT";
+	  gtype = GAIA_POINT;
+	  break;
+      case 2:
+      case 5:
+	  type = "LINESTRING";
+	  gtype = GAIA_LINESTRING;
+	  break;
+      case 3:
+      case 6:
+	  type = "POLYGON";
+	  gtype = GAIA_POLYGON;
+	  break;
+      };
+    switch (geom_type / 1000)
+      {
+      case 1:
+	  dims = "XYZ";
+	  break;
+      case 2:
+	  dims = "XYM";
+	  break;
+      case 3:
+	  dims = "XYZM";
+	  break;
+      };
+
+/* creating the shadow table */
+    ret =
+	sqlite3_exec (sqlite, "SAVEPOINT subdivide_geotable", NULL, NULL,
+		      NULL);
+    if (ret != SQLITE_OK)
+	return -1;
+    xtable = gaiaDoubleQuotedSql (out_table);
+    sql = sqlite3_mprintf ("CREATE TABLE \"%s\" (\n"
+			   "\tpk_uid INTEGER PRIMARY KEY AUTOINCREMENT,\n"
+			   "\tparent_id INTEGER NOT NULL)", xtable);
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtable);
+	  goto error;
+      }
+    index = sqlite3_mprintf ("idx_%s_parent", out_table);
+    xindex = gaiaDoubleQuotedSql (index);
+    sqlite3_free (index);
+    sql = sqlite3_mprintf ("CREATE INDEX \"%s\" ON \"%s\" (parent_id)",
+			   xindex, xtable);
+    free (xindex);
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtable);
+	  goto error;
+      }
+    sql = sqlite3_mprintf ("SELECT AddGeometryColumn(%Q, %Q, %d, %Q, %Q)",
+			   out_table, geo_column, srid, type, dims);
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtable);
+	  goto error;
+      }
+    sql = sqlite3_mprintf ("SELECT CreateSpatialIndex(%Q, %Q)", out_table,
+			   geo_column);
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xtable);
+	  goto error;
+      }
+
+/* preparing the SQL statements */
+    xcolumn = gaiaDoubleQuotedSql (geo_column);
+    sql = sqlite3_mprintf ("INSERT INTO \"%s\" (pk_uid, parent_id, \"%s\") "
+			   "VALUES (NULL, ?, ?)", xtable, xcolumn);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt_out, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  free (xcolumn);
+	  goto error;
+      }
+    xtable = gaiaDoubleQuotedSql (in_table);
+    sql = sqlite3_mprintf ("SELECT ROWID, \"%s\" FROM \"%s\"", xcolumn,
+			   xtable);
+    free (xtable);
+    free (xcolumn);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt_in, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  sqlite3_int64 parent_id;
+	  const unsigned char *blob;
+	  int blob_sz;
+	  gaiaGeomCollPtr geom;
+	  gaiaGeomCollPtr pieces;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  if (sqlite3_column_type (stmt_in, 1) != SQLITE_BLOB)
+	      continue;
+	  parent_id = sqlite3_column_int64 (stmt_in, 0);
+	  blob = sqlite3_column_blob (stmt_in, 1);
+	  blob_sz = sqlite3_column_bytes (stmt_in, 1);
+	  geom =
+	      gaiaFromSpatiaLiteBlobWkbEx (blob, blob_sz, gpkg_mode,
+					   gpkg_amphibious);
+	  if (geom == NULL)
+	      continue;
+	  pieces = gaiaSubdivide (cache, geom, max_vertices, num_threads);
+	  gaiaFreeGeomColl (geom);
+	  if (pieces == NULL)
+	      continue;
+	  ret =
+	      do_insert_subdivided (stmt_out, parent_id, pieces, gtype,
+				    gpkg_mode);
+	  gaiaFreeGeomColl (pieces);
+	  if (ret < 0)
+	      goto error;
+	  count += ret;
+      }
+    sqlite3_finalize (stmt_in);
+    sqlite3_finalize (stmt_out);
+    ret =
+	sqlite3_exec (sqlite, "RELEASE SAVEPOINT subdivide_geotable", NULL,
+		      NULL, NULL);
+    if (ret != SQLITE_OK)
+	return -1;
+    return count;
+
+  error:
+    spatialite_e ("SubdivideGeoTable() error: %s\n", sqlite3_errmsg (sqlite));
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_out != NULL)
+	sqlite3_finalize (stmt_out);
+    sqlite3_exec (sqlite, "ROLLBACK TO SAVEPOINT subdivide_geotable", NULL,
+		  NULL, NULL);
+    sqlite3_exec (sqlite, "RELEASE SAVEPOINT subdivide_geotable", NULL, NULL,
+		  NULL);
+    return -1;
+}
+
+static void
+fnct_SubdivideGeoTable (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
+{
+/* SQL function:
+/ SubdivideGeoTable(TEXT in_table, TEXT geo_column, TEXT out_table,
+/                   int max_vertices)
+/ SubdivideGeoTable(TEXT in_table, TEXT geo_column, TEXT out_table,
+/                   int max_vertices, int num_threads)
+/
+/ creates a shadow table (supported by its own Spatial Index) containing
+/ all pieces obtained by subdividing each Geometry of the input table;
+/ each piece will reference the ROWID of the parent row
+/
+/ returns:
+/ the number of inserted pieces
+/ NULL on invalid arguments, if out_table already exists or on failure
+*/
+    const char *in_table;
+    const char *geo_column;
+    const char *out_table;
+    int max_vertices;
+    int num_threads = 1;
+    int count;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    struct splite_internal_cache *cache = sqlite3_user_data (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT
+	|| sqlite3_value_type (argv[1]) != SQLITE_TEXT
+	|| sqlite3_value_type (argv[2]) != SQLITE_TEXT
+	|| sqlite3_value_type (argv[3]) != SQLITE_INTEGER)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    in_table = (const char *) sqlite3_value_text (argv[0]);
+    geo_column = (const char *) sqlite3_value_text (argv[1]);
+    out_table = (const char *) sqlite3_value_text (argv[2]);
+    max_vertices = sqlite3_value_int (argv[3]);
+    if (argc >= 5)
+      {
+	  if (sqlite3_value_type (argv[4]) != SQLITE_INTEGER)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  num_threads = sqlite3_value_int (argv[4]);
+      }
+    if (max_vertices < 5)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    count =
+	do_subdivide_geotable (sqlite, cache, in_table, geo_column, out_table,
+			       max_vertices, num_threads);
+    if (count < 0)
+	sqlite3_result_null (context);
+    else
+	sqlite3_result_int (context, count);
+}
+
 #endif /* end GEOS advanced features */
 
 #ifdef ENABLE_RTTOPO		/* enabling RTTOPO support */
@@ -27576,7 +29421,7 @@ fnct_Azimuth (sqlite3_context * context, int argc, sqlite3_value ** argv)
       }
     gaiaFreeGeomColl (geom);
 
-    if (getEllipsoidParams (sqlite, srid, &a, &b, &rf))
+    if (getEllipsoidParamsEx (cache, sqlite, srid, &a, &b, &rf))
       {
 	  if (gaiaEllipsoidAzimuth (cache, x1, y1, x2, y2, a, b, &azimuth))
 	      sqlite3_result_double (context, azimuth);
@@ -27678,7 +29523,7 @@ fnct_Project (sqlite3_context * context, int argc, sqlite3_value ** argv)
       }
     srid = geom->Srid;
     gaiaFreeGeomColl (geom);
-    if (!getEllipsoidParams (sqlite, srid, &a, &b, &rf))
+    if (!getEllipsoidParamsEx (cache, sqlite, srid, &a, &b, &rf))
       {
 	  sqlite3_result_null (context);
 	  return;
@@ -28421,6 +30266,10 @@ fnct_Cutter (sqlite3_context * context, int argc, sqlite3_value ** argv)
 / ST_Cutter(TEXT in_db_prefix, TEXT input_table, TEXT input_geom,
 /              TEXT blade_db_prefix, TEXT blade_table, TEXT blade_geom,
 /              TEXT output_table, INT transaction, INT ram_temp_store)
+/ ST_Cutter(TEXT in_db_prefix, TEXT input_table, TEXT input_geom,
+/              TEXT blade_db_prefix, TEXT blade_table, TEXT blade_geom,
+/              TEXT output_table, INT transaction, INT ram_temp_store,
+/              INT num_threads)
 /
 / the "input" table-geometry is expected to be declared as POINT,
 / LINESTRING, POLYGON, MULTIPOINT, MULTILINESTRING or MULTIPOLYGON
@@ -28460,6 +30309,7 @@ fnct_Cutter (sqlite3_context * context, int argc, sqlite3_value ** argv)
     const char *output_table = NULL;
     int transaction = 0;
     int ram_tmp_store = 0;
+    int num_threads = 1;
     char **message = NULL;
     struct splite_internal_cache *cache = sqlite3_user_data (context);
     GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
@@ -28533,7 +30383,7 @@ fnct_Cutter (sqlite3_context * context, int argc, sqlite3_value ** argv)
 		return;
 	    }
       }
-    if (argc == 9)
+    if (argc >= 9)
       {
 	  if (sqlite3_value_type (argv[8]) == SQLITE_INTEGER)
 	      ram_tmp_store = sqlite3_value_int (argv[8]);
@@ -28543,12 +30393,22 @@ fnct_Cutter (sqlite3_context * context, int argc, sqlite3_value ** argv)
 		return;
 	    }
       }
+    if (argc == 10)
+      {
+	  if (sqlite3_value_type (argv[9]) == SQLITE_INTEGER)
+	      num_threads = sqlite3_value_int (argv[9]);
+	  else
+	    {
+		sqlite3_result_int (context, -1);
+		return;
+	    }
+      }
 
     sqlite = sqlite3_context_db_handle (context);
     ret =
-	gaiaCutter (sqlite, cache, in_db_prefix, input_table, input_geom,
-		    blade_db_prefix, blade_table, blade_geom, output_table,
-		    transaction, ram_tmp_store, message);
+	gaiaCutterEx (sqlite, cache, in_db_prefix, input_table, input_geom,
+		      blade_db_prefix, blade_table, blade_geom, output_table,
+		      transaction, ram_tmp_store, num_threads, message);
 
     sqlite3_result_int (context, ret);
 }
@@ -30961,7 +32821,7 @@ fnct_BlobToFile (sqlite3_context * context, int argc, sqlite3_value ** argv)
 static int
 load_dxf (sqlite3 * db_handle, struct splite_internal_cache *cache,
 	  char *filename, int srid, int append, int force_dims, int mode,
-	  int special_rings, char *prefix, char *layer_name)
+	  int special_rings, char *prefix, char *layer_name, int num_threads)
 {
 /* scanning a Directory and processing all DXF files */
     int ret;
@@ -30979,7 +32839,8 @@ load_dxf (sqlite3 * db_handle, struct splite_internal_cache *cache,
     if (gaiaParseDxfFile_r (cache, dxf, filename))
       {
 	  /* loading into the DB */
-	  if (!gaiaLoadFromDxfParser (db_handle, dxf, mode, append))
+	  if (!gaiaLoadFromDxfParserEx
+	      (db_handle, dxf, mode, append, num_threads))
 	    {
 		ret = 0;
 		spatialite_e ("DB error while loading: %s\n", filename);
@@ -31009,6 +32870,10 @@ fnct_ImportDXF (sqlite3_context * context, int argc, sqlite3_value ** argv)
 / InportDXF(TEXT filename, INT srid, INT append, TEXT dims,
 /           TEXT mode, TEXT special_rings, TEXT table_prefix,
 /           TEXT layer_name)
+/     or
+/ InportDXF(TEXT filename, INT srid, INT append, TEXT dims,
+/           TEXT mode, TEXT special_rings, TEXT table_prefix,
+/           TEXT layer_name, INT threads)
 /
 / returns:
 / 1 on success
@@ -31024,6 +32889,7 @@ fnct_ImportDXF (sqlite3_context * context, int argc, sqlite3_value ** argv)
     int force_dims = GAIA_DXF_AUTO_2D_3D;
     char *prefix = NULL;
     char *layer_name = NULL;
+    int num_threads = 1;
     sqlite3 *db_handle = sqlite3_context_db_handle (context);
     struct splite_internal_cache *cache = sqlite3_user_data (context);
     GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
@@ -31112,211 +32978,373 @@ fnct_ImportDXF (sqlite3_context * context, int argc, sqlite3_value ** argv)
 		return;
 	    }
       }
-
-    ret =
-	load_dxf (db_handle, cache, filename, srid, append, force_dims, mode,
-		  special_rings, prefix, layer_name);
-    sqlite3_result_int (context, ret);
-}
-
-static int
-is_dxf_file (const char *filename)
-{
-/* testing if a FileName ends with the expected suffix */
-    int len = strlen (filename);
-    int off = len - 4;
-    if (off >= 1)
-      {
-	  if (strcasecmp (filename + off, ".dxf") == 0)
-	      return 1;
-      }
-    return 0;
-}
-
-static int
-scan_dxf_dir (sqlite3 * db_handle, struct splite_internal_cache *cache,
-	      char *dir_path, int srid, int append, int force_dims, int mode,
-	      int special_rings, char *prefix, char *layer_name)
-{
-/* scanning a Directory and processing all DXF files */
-    int cnt = 0;
-    char *filepath;
-#if defined(_WIN32) && !defined(__MINGW32__)
-/* Visual Studio .NET */
-    struct _finddata_t c_file;
-    intptr_t hFile;
-    if (_chdir (dir_path) < 0)
-	return 0;
-    if ((hFile = _findfirst ("*.*", &c_file)) == -1L)
-	;
-    else
-      {
-	  while (1)
-	    {
-		if ((c_file.attrib & _A_RDONLY) == _A_RDONLY
-		    || (c_file.attrib & _A_NORMAL) == _A_NORMAL)
-		  {
-		      if (is_dxf_file (c_file.name))
-			{
-			    filepath =
-				sqlite3_mprintf ("%s/%s", dir_path,
-						 c_file.name);
-			    cnt +=
-				load_dxf (db_handle, cache, filepath, srid,
-					  append, force_dims, mode,
-					  special_rings, prefix, layer_name);
-			    sqlite3_free (filepath);
-			}
-		  }
-		if (_findnext (hFile, &c_file) != 0)
-		    break;
-	    };
-	  _findclose (hFile);
-      }
-#else
-/* not Visual Studio .NET */
-    struct dirent *entry;
-    DIR *dir = opendir (dir_path);
-    if (!dir)
-	return 0;
-    while (1)
-      {
-	  /* scanning dir-entries */
-	  entry = readdir (dir);
-	  if (!entry)
-	      break;
-	  if (is_dxf_file (entry->d_name))
-	    {
-		filepath = sqlite3_mprintf ("%s/%s", dir_path, entry->d_name);
-		cnt +=
-		    load_dxf (db_handle, cache, filepath, srid, append,
-			      force_dims, mode, special_rings, prefix,
-			      layer_name);
-		sqlite3_free (filepath);
-	    }
-      }
-    closedir (dir);
-#endif
-    return cnt;
-}
-
-static void
-fnct_ImportDXFfromDir (sqlite3_context * context, int argc,
-		       sqlite3_value ** argv)
-{
-/* SQL function:
-/ ImportDXFfromDir(TEXT dir_path)
-/     or
-/ InportDXFfromDir(TEXT dir_path, INT srid, INT append, TEXT dims,
-/                  TEXT mode, TEXT special_rings, TEXT table_prefix,
-/                  TEXT layer_name)
-/
-/ returns:
-/ 1 on success
-/ or 0 on failure
-/ NULL on invalid arguments
-*/
-    int ret;
-    char *dir_path;
-    int srid = -1;
-    int append = 0;
-    int special_rings = GAIA_DXF_RING_NONE;
-    int mode = GAIA_DXF_IMPORT_BY_LAYER;
-    int force_dims = GAIA_DXF_AUTO_2D_3D;
-    char *prefix = NULL;
-    char *layer_name = NULL;
-    sqlite3 *db_handle = sqlite3_context_db_handle (context);
-    struct splite_internal_cache *cache = sqlite3_user_data (context);
-    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
-    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
-      {
-	  sqlite3_result_null (context);
-	  return;
-      }
-    dir_path = (char *) sqlite3_value_text (argv[0]);
-    if (argc > 7)
+    if (argc > 8)
+      {
+	  if (sqlite3_value_type (argv[8]) != SQLITE_INTEGER)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  num_threads = sqlite3_value_int (argv[8]);
+	  if (num_threads < 1)
+	      num_threads = 1;
+	  if (num_threads > GAIA_DXF_MAX_THREADS)
+	      num_threads = GAIA_DXF_MAX_THREADS;
+      }
+
+    ret =
+	load_dxf (db_handle, cache, filename, srid, append, force_dims, mode,
+		  special_rings, prefix, layer_name, num_threads);
+    sqlite3_result_int (context, ret);
+}
+
+static int
+is_dxf_file (const char *filename)
+{
+/* testing if a FileName ends with the expected suffix */
+    int len = strlen (filename);
+    int off = len - 4;
+    if (off >= 1)
+      {
+	  if (strcasecmp (filename + off, ".dxf") == 0)
+	      return 1;
+      }
+    return 0;
+}
+
+struct dxf_path_list
+{
+/* a list of DXF file paths */
+    char **paths;
+    int count;
+    int capacity;
+};
+
+static void
+add_dxf_path (struct dxf_path_list *list, char *path)
+{
+/* appending a DXF file path into the list */
+    if (list->count == list->capacity)
+      {
+	  int capacity = (list->capacity == 0) ? 64 : list->capacity * 2;
+	  char **paths = realloc (list->paths, sizeof (char *) * capacity);
+	  if (paths == NULL)
+	    {
+		sqlite3_free (path);
+		return;
+	    }
+	  list->paths = paths;
+	  list->capacity = capacity;
+      }
+    *(list->paths + list->count) = path;
+    list->count += 1;
+}
+
+static int
+load_dxf_files (sqlite3 * db_handle, struct splite_internal_cache *cache,
+		struct dxf_path_list *list, int srid, int append,
+		int force_dims, int mode, int special_rings, char *prefix,
+		char *layer_name, int num_threads)
+{
+/* 
+/ concurrently parsing many DXF files, then loading them into the DB
+/ one at each time and in the same order they were found
+*/
+    int cnt = 0;
+    int base;
+    int i;
+    gaiaDxfParserPtr *parsers;
+    int *results;
+
+    if (num_threads < 1)
+	num_threads = 1;
+    if (num_threads > GAIA_DXF_MAX_THREADS)
+	num_threads = GAIA_DXF_MAX_THREADS;
+    parsers = malloc (sizeof (gaiaDxfParserPtr) * num_threads);
+    results = malloc (sizeof (int) * num_threads);
+    if (parsers == NULL || results == NULL)
+      {
+	  if (parsers != NULL)
+	      free (parsers);
+	  if (results != NULL)
+	      free (results);
+	  return 0;
+      }
+    for (base = 0; base < list->count; base += num_threads)
+      {
+	  int n = list->count - base;
+	  if (n > num_threads)
+	      n = num_threads;
+	  for (i = 0; i < n; i++)
+	      *(parsers + i) =
+		  gaiaCreateDxfParser (srid, force_dims, prefix, layer_name,
+				       special_rings);
+	  gaiaParseDxfFiles_r (cache, parsers,
+			       (const char **) (list->paths + base), results,
+			       n, num_threads);
+	  for (i = 0; i < n; i++)
+	    {
+		gaiaDxfParserPtr dxf = *(parsers + i);
+		const char *filename = *(list->paths + base + i);
+		if (dxf == NULL)
+		    continue;
+		if (*(results + i))
+		  {
+		      /* loading into the DB */
+		      if (!gaiaLoadFromDxfParserEx
+			  (db_handle, dxf, mode, append, num_threads))
+			  spatialite_e ("DB error while loading: %s\n",
+					filename);
+		      spatialite_e ("\n*** DXF file successfully loaded\n");
+		      cnt++;
+		  }
+		else
+		    spatialite_e ("Unable to parse: %s\n", filename);
+		gaiaDestroyDxfParser (dxf);
+	    }
+      }
+    free (parsers);
+    free (results);
+    return cnt;
+}
+
+static int
+scan_dxf_dir (sqlite3 * db_handle, struct splite_internal_cache *cache,
+	      char *dir_path, int srid, int append, int force_dims, int mode,
+	      int special_rings, char *prefix, char *layer_name,
+	      int num_threads)
+{
+/* scanning a Directory and processing all DXF files */
+    int cnt = 0;
+    int i;
+    char *filepath;
+    struct dxf_path_list list;
+#if defined(_WIN32) && !defined(__MINGW32__)
+/* Visual Studio .NET */
+    struct _finddata_t c_file;
+    intptr_t hFile;
+    list.paths = NULL;
+    list.count = 0;
+    list.capacity = 0;
+    if (_chdir (dir_path) < 0)
+	return 0;
+    if ((hFile = _findfirst ("*.*", &c_file)) == -1L)
+	;
+    else
+      {
+	  while (1)
+	    {
+		if ((c_file.attrib & _A_RDONLY) == _A_RDONLY
+		    || (c_file.attrib & _A_NORMAL) == _A_NORMAL)
+		  {
+		      if (is_dxf_file (c_file.name))
+			{
+			    filepath =
+				sqlite3_mprintf ("%s/%s", dir_path,
+						 c_file.name);
+			    if (num_threads > 1)
+			      {
+				  /* deferred: concurrent parsing */
+				  add_dxf_path (&list, filepath);
+			      }
+			    else
+			      {
+				  cnt +=
+				      load_dxf (db_handle, cache, filepath,
+						srid, append, force_dims, mode,
+						special_rings, prefix,
+						layer_name, num_threads);
+				  sqlite3_free (filepath);
+			      }
+			}
+		  }
+		if (_findnext (hFile, &c_file) != 0)
+		    break;
+	    };
+	  _findclose (hFile);
+      }
+#else
+/* not Visual Studio .NET */
+    struct dirent *entry;
+    DIR *dir = opendir (dir_path);
+    list.paths = NULL;
+    list.count = 0;
+    list.capacity = 0;
+    if (!dir)
+	return 0;
+    while (1)
+      {
+	  /* scanning dir-entries */
+	  entry = readdir (dir);
+	  if (!entry)
+	      break;
+	  if (is_dxf_file (entry->d_name))
+	    {
+		filepath = sqlite3_mprintf ("%s/%s", dir_path, entry->d_name);
+		if (num_threads > 1)
+		  {
+		      /* deferred: concurrent parsing */
+		      add_dxf_path (&list, filepath);
+		  }
+		else
+		  {
+		      cnt +=
+			  load_dxf (db_handle, cache, filepath, srid, append,
+				    force_dims, mode, special_rings, prefix,
+				    layer_name, num_threads);
+		      sqlite3_free (filepath);
+		  }
+	    }
+      }
+    closedir (dir);
+#endif
+    if (list.count > 0)
+	cnt +=
+	    load_dxf_files (db_handle, cache, &list, srid, append, force_dims,
+			    mode, special_rings, prefix, layer_name,
+			    num_threads);
+    for (i = 0; i < list.count; i++)
+	sqlite3_free (*(list.paths + i));
+    if (list.paths != NULL)
+	free (list.paths);
+    return cnt;
+}
+
+static void
+fnct_ImportDXFfromDir (sqlite3_context * context, int argc,
+		       sqlite3_value ** argv)
+{
+/* SQL function:
+/ ImportDXFfromDir(TEXT dir_path)
+/     or
+/ InportDXFfromDir(TEXT dir_path, INT srid, INT append, TEXT dims,
+/                  TEXT mode, TEXT special_rings, TEXT table_prefix,
+/                  TEXT layer_name)
+/     or
+/ InportDXFfromDir(TEXT dir_path, INT srid, INT append, TEXT dims,
+/                  TEXT mode, TEXT special_rings, TEXT table_prefix,
+/                  TEXT layer_name, INT threads)
+/
+/ returns:
+/ 1 on success
+/ or 0 on failure
+/ NULL on invalid arguments
+*/
+    int ret;
+    char *dir_path;
+    int srid = -1;
+    int append = 0;
+    int special_rings = GAIA_DXF_RING_NONE;
+    int mode = GAIA_DXF_IMPORT_BY_LAYER;
+    int force_dims = GAIA_DXF_AUTO_2D_3D;
+    char *prefix = NULL;
+    char *layer_name = NULL;
+    int num_threads = 1;
+    sqlite3 *db_handle = sqlite3_context_db_handle (context);
+    struct splite_internal_cache *cache = sqlite3_user_data (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) != SQLITE_TEXT)
+      {
+	  sqlite3_result_null (context);
+	  return;
+      }
+    dir_path = (char *) sqlite3_value_text (argv[0]);
+    if (argc > 7)
+      {
+	  const char *value;
+	  if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  srid = sqlite3_value_int (argv[1]);
+	  if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  append = sqlite3_value_int (argv[2]);
+	  if (sqlite3_value_type (argv[3]) != SQLITE_TEXT)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  value = (const char *) sqlite3_value_text (argv[3]);
+	  if (strcasecmp (value, "2D") == 0)
+	      force_dims = GAIA_DXF_FORCE_2D;
+	  else if (strcasecmp (value, "3D") == 0)
+	      force_dims = GAIA_DXF_FORCE_3D;
+	  else if (strcasecmp (value, "AUTO") == 0)
+	      force_dims = GAIA_DXF_AUTO_2D_3D;
+	  else
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  if (sqlite3_value_type (argv[4]) != SQLITE_TEXT)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  value = (const char *) sqlite3_value_text (argv[4]);
+	  if (strcasecmp (value, "MIXED") == 0)
+	      mode = GAIA_DXF_IMPORT_MIXED;
+	  else if (strcasecmp (value, "DISTINCT") == 0)
+	      mode = GAIA_DXF_IMPORT_BY_LAYER;
+	  else
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  if (sqlite3_value_type (argv[5]) != SQLITE_TEXT)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  value = (const char *) sqlite3_value_text (argv[5]);
+	  if (strcasecmp (value, "LINKED") == 0)
+	      special_rings = GAIA_DXF_RING_LINKED;
+	  else if (strcasecmp (value, "UNLINKED") == 0)
+	      special_rings = GAIA_DXF_RING_UNLINKED;
+	  else if (strcasecmp (value, "NONE") == 0)
+	      special_rings = GAIA_DXF_RING_NONE;
+	  else
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  if (sqlite3_value_type (argv[6]) == SQLITE_TEXT)
+	      prefix = (char *) sqlite3_value_text (argv[6]);
+	  else if (sqlite3_value_type (argv[6]) != SQLITE_NULL)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+	  if (sqlite3_value_type (argv[7]) == SQLITE_TEXT)
+	      layer_name = (char *) sqlite3_value_text (argv[7]);
+	  else if (sqlite3_value_type (argv[7]) != SQLITE_NULL)
+	    {
+		sqlite3_result_null (context);
+		return;
+	    }
+      }
+    if (argc > 8)
       {
-	  const char *value;
-	  if (sqlite3_value_type (argv[1]) != SQLITE_INTEGER)
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  srid = sqlite3_value_int (argv[1]);
-	  if (sqlite3_value_type (argv[2]) != SQLITE_INTEGER)
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  append = sqlite3_value_int (argv[2]);
-	  if (sqlite3_value_type (argv[3]) != SQLITE_TEXT)
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  value = (const char *) sqlite3_value_text (argv[3]);
-	  if (strcasecmp (value, "2D") == 0)
-	      force_dims = GAIA_DXF_FORCE_2D;
-	  else if (strcasecmp (value, "3D") == 0)
-	      force_dims = GAIA_DXF_FORCE_3D;
-	  else if (strcasecmp (value, "AUTO") == 0)
-	      force_dims = GAIA_DXF_AUTO_2D_3D;
-	  else
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  if (sqlite3_value_type (argv[4]) != SQLITE_TEXT)
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  value = (const char *) sqlite3_value_text (argv[4]);
-	  if (strcasecmp (value, "MIXED") == 0)
-	      mode = GAIA_DXF_IMPORT_MIXED;
-	  else if (strcasecmp (value, "DISTINCT") == 0)
-	      mode = GAIA_DXF_IMPORT_BY_LAYER;
-	  else
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  if (sqlite3_value_type (argv[5]) != SQLITE_TEXT)
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  value = (const char *) sqlite3_value_text (argv[5]);
-	  if (strcasecmp (value, "LINKED") == 0)
-	      special_rings = GAIA_DXF_RING_LINKED;
-	  else if (strcasecmp (value, "UNLINKED") == 0)
-	      special_rings = GAIA_DXF_RING_UNLINKED;
-	  else if (strcasecmp (value, "NONE") == 0)
-	      special_rings = GAIA_DXF_RING_NONE;
-	  else
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  if (sqlite3_value_type (argv[6]) == SQLITE_TEXT)
-	      prefix = (char *) sqlite3_value_text (argv[6]);
-	  else if (sqlite3_value_type (argv[6]) != SQLITE_NULL)
-	    {
-		sqlite3_result_null (context);
-		return;
-	    }
-	  if (sqlite3_value_type (argv[7]) == SQLITE_TEXT)
-	      layer_name = (char *) sqlite3_value_text (argv[7]);
-	  else if (sqlite3_value_type (argv[7]) != SQLITE_NULL)
+	  if (sqlite3_value_type (argv[8]) != SQLITE_INTEGER)
 	    {
 		sqlite3_result_null (context);
 		return;
 	    }
+	  num_threads = sqlite3_value_int (argv[8]);
+	  if (num_threads < 1)
+	      num_threads = 1;
+	  if (num_threads > GAIA_DXF_MAX_THREADS)
+	      num_threads = GAIA_DXF_MAX_THREADS;
       }
 
     ret =
 	scan_dxf_dir (db_handle, cache, dir_path, srid, append, force_dims,
-		      mode, special_rings, prefix, layer_name);
+		      mode, special_rings, prefix, layer_name, num_threads);
     sqlite3_result_int (context, ret);
 }
 
@@ -32603,6 +34631,42 @@ fnct_sp_exit (sqlite3_context * context, int argc, sqlite3_value ** argv)
     return;
 }
 
+static void
+fnct_sp_set_stmt_cache (sqlite3_context * context, int argc,
+			sqlite3_value ** argv)
+{
+/* SQL function:
+/ StoredProc_SetStmtCache( enabled BOOLEAN )
+/
+/ returns:
+/ 1 on succes
+/ raises an exception on invalid arguments or errors
+*/
+    const char *msg;
+    struct splite_internal_cache *cache = sqlite3_user_data (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (cache == NULL)
+	goto no_cache;
+    if (sqlite3_value_type (argv[0]) != SQLITE_INTEGER)
+	goto invalid_argument;
+
+    gaia_stored_proc_set_stmt_cache (cache, sqlite3_value_int (argv[0]));
+    sqlite3_result_int (context, 1);
+    return;
+
+  no_cache:
+    msg =
+	"StoredProc_SetStmtCache exception - unable to find a Connection Cache.";
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  invalid_argument:
+    msg =
+	"StoredProc_SetStmtCache exception - illegal argument [not an INTEGER].";
+    sqlite3_result_error (context, msg, -1);
+    return;
+}
+
 static void
 fnct_sp_create_tables (sqlite3_context * context, int argc,
 		       sqlite3_value ** argv)
@@ -32852,7 +34916,7 @@ fnct_sp_stored_execute (sqlite3_context * context, int argc,
     const char *name;
     unsigned char *blob;
     int blob_sz = 0;
-    char *sql;
+    int ret;
     const char *msg;
     char *message;
     SqlProc_VarListPtr variables = NULL;
@@ -32874,18 +34938,16 @@ fnct_sp_stored_execute (sqlite3_context * context, int argc,
     if (variables->Error)
 	goto illegal_variables;
 
-/* replacing Variables */
-    if (!gaia_sql_proc_cooked_sql
-	(sqlite, cache, blob, blob_sz, variables, &sql))
+/* executing the compiled SQL Procedure */
+    ret =
+	gaia_stored_proc_execute_compiled (sqlite, cache, name, blob, blob_sz,
+					   variables);
+    if (ret < 0)
 	goto cooking_error;
     free (blob);
-
-/* executing the SQL Procedure */
-    if (!gaia_sql_proc_execute (sqlite, cache, sql))
+    if (ret == 0)
 	goto sql_error;
     sqlite3_result_int (context, 1);
-    if (sql != NULL)
-	free (sql);
     gaia_sql_proc_destroy_variables (variables);
     return;
 
@@ -32932,8 +34994,6 @@ fnct_sp_stored_execute (sqlite3_context * context, int argc,
     return;
 
   sql_error:
-    if (sql != NULL)
-	free (sql);
     gaia_sql_proc_destroy_variables (variables);
     msg = "SqlProc exception - a fatal SQL error was encountered.";
     sqlite3_result_error (context, msg, -1);
@@ -34599,7 +36659,7 @@ fnct_GeodesicLength (sqlite3_context * context, int argc, sqlite3_value ** argv)
 	sqlite3_result_null (context);
     else
       {
-	  if (getEllipsoidParams (sqlite, geo->Srid, &a, &b, &rf))
+	  if (getEllipsoidParamsEx (cache, sqlite, geo->Srid, &a, &b, &rf))
 	    {
 		line = geo->FirstLinestring;
 		while (line)
@@ -34711,7 +36771,7 @@ fnct_GreatCircleLength (sqlite3_context * context, int argc,
 	sqlite3_result_null (context);
     else
       {
-	  if (getEllipsoidParams (sqlite, geo->Srid, &a, &b, &rf))
+	  if (getEllipsoidParamsEx (cache, sqlite, geo->Srid, &a, &b, &rf))
 	    {
 		line = geo->FirstLinestring;
 		while (line)
@@ -40938,6 +42998,13 @@ fnct_TopoGeo_FromGeoTableNoFace (sqlite3_context * context, int argc,
     fnctaux_TopoGeo_FromGeoTableNoFace (context, argc, argv);
 }
 
+static void
+fnct_TopoGeo_FromGeoTablePartitioned (sqlite3_context * context, int argc,
+				      sqlite3_value ** argv)
+{
+    fnctaux_TopoGeo_FromGeoTablePartitioned (context, argc, argv);
+}
+
 static void
 fnct_TopoGeo_FromGeoTableExt (sqlite3_context * context, int argc,
 			      sqlite3_value ** argv)
@@ -41650,9 +43717,33 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "CreateMbrCache", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
 				fnct_CreateMbrCache, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "CreateZoneMap", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_CreateZoneMap, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "CreateZoneMap", 3,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_CreateZoneMap, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "CreateZoneMap", 4,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_CreateZoneMap, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "DropZoneMap", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_DropZoneMap, 0, 0, 0);
     sqlite3_create_function_v2 (db, "DisableSpatialIndex", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
 				fnct_DisableSpatialIndex, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "EnableDeferredSpatialIndex", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_EnableDeferredSpatialIndex, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "EnableDeferredSpatialIndex", 3,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_EnableDeferredSpatialIndex, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "DisableDeferredSpatialIndex", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_DisableDeferredSpatialIndex, 0, 0, 0);
+/* not deterministic: it's invoked with constant args from within triggers */
+    sqlite3_create_function_v2 (db, "FlushSpatialIndex", 2, SQLITE_UTF8, 0,
+				fnct_FlushSpatialIndex, 0, 0, 0);
     sqlite3_create_function_v2 (db, "RebuildGeometryTriggers", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
 				fnct_RebuildGeometryTriggers, 0, 0, 0);
@@ -41665,6 +43756,12 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "UpdateLayerStatistics", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
 				fnct_UpdateLayerStatistics, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "UpdateLayerStatistics", 3,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_UpdateLayerStatistics, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "UpdateLayerStatistics", 4,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
+				fnct_UpdateLayerStatistics, 0, 0, 0);
     sqlite3_create_function_v2 (db, "GetLayerExtent", 1,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_GetLayerExtent, 0, 0, 0);
@@ -41848,6 +43945,10 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "CreateClonedTable", 14,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, 0,
 				fnct_CreateClonedTable, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ClusterGeoTable", 2, SQLITE_UTF8, 0,
+				fnct_ClusterGeoTable, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ClusterGeoTable", 3, SQLITE_UTF8, 0,
+				fnct_ClusterGeoTable, 0, 0, 0);
 
 #ifndef OMIT_PROJ		/* PROJ.4 is strictly required to support KML */
     sqlite3_create_function_v2 (db, "AsKml", 1,
@@ -43284,6 +45385,8 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
 				fnct_sp_exit, 0, 0, 0);
     sqlite3_create_function_v2 (db, "StoredProc_Exit", 0, SQLITE_UTF8, cache,
 				fnct_sp_exit, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "StoredProc_SetStmtCache", 1, SQLITE_UTF8,
+				cache, fnct_sp_set_stmt_cache, 0, 0, 0);
     sqlite3_create_function_v2 (db, "StoredProc_CreateTables", 0, SQLITE_UTF8,
 				cache, fnct_sp_create_tables, 0, 0, 0);
     sqlite3_create_function_v2 (db, "StoredProc_Register", 3, SQLITE_UTF8,
@@ -43397,12 +45500,18 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
 	  sqlite3_create_function_v2 (db, "ImportDXF", 8,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_ImportDXF, 0, 0, 0);
+	  sqlite3_create_function_v2 (db, "ImportDXF", 9,
+				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				      fnct_ImportDXF, 0, 0, 0);
 	  sqlite3_create_function_v2 (db, "ImportDXFfromDir", 1,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_ImportDXFfromDir, 0, 0, 0);
 	  sqlite3_create_function_v2 (db, "ImportDXFfromDir", 8,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_ImportDXFfromDir, 0, 0, 0);
+	  sqlite3_create_function_v2 (db, "ImportDXFfromDir", 9,
+				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				      fnct_ImportDXFfromDir, 0, 0, 0);
 
 #endif /* GEOS enabled */
 
@@ -44103,6 +46212,10 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "ST_Contains", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_Contains, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "PointInPolygonJoin", 5, SQLITE_UTF8,
+				cache, fnct_PointInPolygonJoin, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "PointInPolygonJoin", 6, SQLITE_UTF8,
+				cache, fnct_PointInPolygonJoin, 0, 0, 0);
     sqlite3_create_function_v2 (db, "Relate", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_Relate, 0, 0, 0);
@@ -44409,6 +46522,22 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "ST_ConcaveHull", 4,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_ConcaveHull, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "Subdivide", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_Subdivide, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "Subdivide", 3,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_Subdivide, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ST_Subdivide", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_Subdivide, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ST_Subdivide", 3,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_Subdivide, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "SubdivideGeoTable", 4, SQLITE_UTF8,
+				cache, fnct_SubdivideGeoTable, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "SubdivideGeoTable", 5, SQLITE_UTF8,
+				cache, fnct_SubdivideGeoTable, 0, 0, 0);
 
 #endif /* end GEOS advanced features */
 
@@ -44572,6 +46701,9 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "ST_Cutter", 9,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_Cutter, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ST_Cutter", 10,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_Cutter, 0, 0, 0);
     sqlite3_create_function_v2 (db, "GetCutterMessage", 0,
 				SQLITE_UTF8, cache,
 				fnct_GetCutterMessage, 0, 0, 0);
@@ -45078,6 +47210,9 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
 	  sqlite3_create_function_v2 (db, "ST_ValidateTopoGeo", 1,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_ValidateTopoGeo, 0, 0, 0);
+	  sqlite3_create_function_v2 (db, "ST_ValidateTopoGeo", 2,
+				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				      fnct_ValidateTopoGeo, 0, 0, 0);
 	  sqlite3_create_function_v2 (db, "ST_CreateTopoGeo", 2,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_CreateTopoGeo, 0, 0, 0);
@@ -45131,6 +47266,9 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
 	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTable", 7,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_TopoGeo_FromGeoTable, 0, 0, 0);
+	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTable", 8,
+				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				      fnct_TopoGeo_FromGeoTable, 0, 0, 0);
 	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTableNoFace", 4,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_TopoGeo_FromGeoTableNoFace, 0, 0, 0);
@@ -45143,6 +47281,22 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
 	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTableNoFace", 7,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_TopoGeo_FromGeoTableNoFace, 0, 0, 0);
+	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTablePartitioned",
+				      6, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+				      cache, fnct_TopoGeo_FromGeoTablePartitioned,
+				      0, 0, 0);
+	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTablePartitioned",
+				      7, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+				      cache, fnct_TopoGeo_FromGeoTablePartitioned,
+				      0, 0, 0);
+	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTablePartitioned",
+				      8, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+				      cache, fnct_TopoGeo_FromGeoTablePartitioned,
+				      0, 0, 0);
+	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTablePartitioned",
+				      9, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+				      cache, fnct_TopoGeo_FromGeoTablePartitioned,
+				      0, 0, 0);
 	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTableExt", 6,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_TopoGeo_FromGeoTableExt, 0, 0, 0);
@@ -45155,6 +47309,9 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
 	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTableExt", 9,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_TopoGeo_FromGeoTableExt, 0, 0, 0);
+	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTableExt", 10,
+				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				      fnct_TopoGeo_FromGeoTableExt, 0, 0, 0);
 	  sqlite3_create_function_v2 (db, "TopoGeo_FromGeoTableNoFaceExt", 6,
 				      SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				      fnct_TopoGeo_FromGeoTableNoFaceExt, 0, 0,
@@ -45369,12 +47526,21 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "ST_SpatNetFromGeom", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_SpatNetFromGeom, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ST_SpatNetFromGeom", 3,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_SpatNetFromGeom, 0, 0, 0);
     sqlite3_create_function_v2 (db, "ST_ValidLogicalNet", 1,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_ValidLogicalNet, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ST_ValidLogicalNet", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_ValidLogicalNet, 0, 0, 0);
     sqlite3_create_function_v2 (db, "ST_ValidSpatialNet", 1,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_ValidSpatialNet, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "ST_ValidSpatialNet", 2,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_ValidSpatialNet, 0, 0, 0);
     sqlite3_create_function_v2 (db, "GetNetNodeByPoint", 2,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_GetNetNodeByPoint, 0, 0, 0);
@@ -45390,6 +47556,9 @@ register_spatialite_sql_functions (void *p_db, const void *p_cache)
     sqlite3_create_function_v2 (db, "TopoNet_FromGeoTable", 4,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_TopoNet_FromGeoTable, 0, 0, 0);
+    sqlite3_create_function_v2 (db, "TopoNet_FromGeoTable", 5,
+				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
+				fnct_TopoNet_FromGeoTable, 0, 0, 0);
     sqlite3_create_function_v2 (db, "TopoNet_ToGeoTable", 5,
 				SQLITE_UTF8 | SQLITE_DETERMINISTIC, cache,
 				fnct_TopoNet_ToGeoTable, 0, 0, 0);
@@ -45458,12 +47627,22 @@ init_spatialite_virtualtables (void *p_db, const void *p_cache)
     virtual_spatialindex_extension_init (db);
 /* initializing the VirtualElementary  extension */
     virtual_elementary_extension_init (db);
+/* initializing the VirtualExif  extension */
+    virtualexif_extension_init (db);
 
 #ifndef OMIT_KNN		/* only if KNN is enabled */
 /* initializing the VirtualKNN  extension */
     virtual_knn_extension_init (db);
 #endif /* end KNN conditional */
 
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+/* initializing the VirtualSpatialJoin  extension */
+    virtual_spatialjoin_extension_init (db, p_cache);
+#endif /* end GEOS conditional */
+
+/* initializing the VirtualZoneMap  extension */
+    virtual_zonemap_extension_init (db);
+
 #ifdef ENABLE_GEOPACKAGE	/* only if GeoPackage support is enabled */
 /* initializing the VirtualFDO  extension */
     virtualgpkg_extension_init (db);
@@ -45540,12 +47719,21 @@ spatialite_splash_screen (int verbose)
 		    ("\t- 'VirtualSpatialIndex'\t[R*Tree metahandler]\n");
 		spatialite_i
 		    ("\t- 'VirtualElementary'\t[ElemGeoms metahandler]\n");
+		spatialite_i
+		    ("\t- 'VirtualExif'\t\t[EXIF/GPS photo directory index]\n");
 
 #ifndef OMIT_KNN		/* only if KNN is enabled */
 		spatialite_i
 		    ("\t- 'VirtualKNN'\t[K-Nearest Neighbors metahandler]\n");
 #endif /* end KNN conditional */
 
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+		spatialite_i
+		    ("\t- 'VirtualSpatialJoin'\t[Spatial Join metahandler]\n");
+#endif /* end GEOS conditional */
+		spatialite_i
+		    ("\t- 'VirtualZoneMap'\t[ZoneMap metahandler]\n");
+
 #ifdef ENABLE_LIBXML2		/* VirtualXPath is supported */
 		spatialite_i
 		    ("\t- 'VirtualXPath'\t[XML Path Language - XPath]\n");
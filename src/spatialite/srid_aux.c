@@ -1899,6 +1899,15 @@ getProjParams (void *p_sqlite, int srid, char **proj_params)
     if (*proj_params != NULL)
 	return;
 
+/* lazily populated spatial_reference_sys: inserting the EPSG def on demand */
+    if (lazy_insert_epsg_srid (sqlite, srid))
+      {
+	  getProjParamsFromSpatialReferenceSystemTable (sqlite, srid,
+							proj_params);
+	  if (*proj_params != NULL)
+	      return;
+      }
+
 /* last opportunity: search within GPKG srs */
     getProjParamsFromGeopackageTable (sqlite, srid, proj_params);
 }
@@ -471,42 +471,13 @@ do_update_virts_layer_statistics (sqlite3 * sqlite, const char *table,
     return 1;
 }
 
-static void
-update_field_infos (struct field_container_infos *infos, int ordinal,
-		    const char *col_name, const char *type, int size, int count)
+static struct field_item_infos *
+add_field_infos_item (struct field_container_infos *infos, int ordinal,
+		      const char *col_name)
 {
-/* updating the field container infos */
+/* inserting a new field into the field container infos */
     int len;
-    struct field_item_infos *p = infos->first;
-    while (p)
-      {
-	  if (strcasecmp (col_name, p->col_name) == 0)
-	    {
-		/* updating an already defined field */
-		if (strcasecmp (type, "null") == 0)
-		    p->null_values += count;
-		if (strcasecmp (type, "integer") == 0)
-		    p->integer_values += count;
-		if (strcasecmp (type, "real") == 0)
-		    p->double_values += count;
-		if (strcasecmp (type, "text") == 0)
-		  {
-		      p->text_values += count;
-		      if (size > p->max_size)
-			  p->max_size = size;
-		  }
-		if (strcasecmp (type, "blob") == 0)
-		  {
-		      p->blob_values += count;
-		      if (size > p->max_size)
-			  p->max_size = size;
-		  }
-		return;
-	    }
-	  p = p->next;
-      }
-/* inserting a new field */
-    p = malloc (sizeof (struct field_item_infos));
+    struct field_item_infos *p = malloc (sizeof (struct field_item_infos));
     p->ordinal = ordinal;
     len = strlen (col_name);
     p->col_name = malloc (len + 1);
@@ -524,6 +495,28 @@ update_field_infos (struct field_container_infos *infos, int ordinal,
     p->dbl_min = 0.0;
     p->dbl_max = 0.0;
     p->next = NULL;
+    if (infos->first == NULL)
+	infos->first = p;
+    if (infos->last != NULL)
+	infos->last->next = p;
+    infos->last = p;
+    return p;
+}
+
+static void
+update_field_infos (struct field_container_infos *infos, int ordinal,
+		    const char *col_name, const char *type, int size, int count)
+{
+/* updating the field container infos */
+    struct field_item_infos *p = infos->first;
+    while (p)
+      {
+	  if (strcasecmp (col_name, p->col_name) == 0)
+	      break;
+	  p = p->next;
+      }
+    if (p == NULL)
+	p = add_field_infos_item (infos, ordinal, col_name);
     if (strcasecmp (type, "null") == 0)
 	p->null_values += count;
     if (strcasecmp (type, "integer") == 0)
@@ -542,11 +535,6 @@ update_field_infos (struct field_container_infos *infos, int ordinal,
 	  if (size > p->max_size)
 	      p->max_size = size;
       }
-    if (infos->first == NULL)
-	infos->first = p;
-    if (infos->last != NULL)
-	infos->last->next = p;
-    infos->last = p;
 }
 
 static void
@@ -559,9 +547,12 @@ update_field_infos_int_minmax (struct field_container_infos *infos,
       {
 	  if (strcasecmp (col_name, p->col_name) == 0)
 	    {
+		/* merging with any range already known */
+		if (!p->int_minmax_set || int_min < p->int_min)
+		    p->int_min = int_min;
+		if (!p->int_minmax_set || int_max > p->int_max)
+		    p->int_max = int_max;
 		p->int_minmax_set = 1;
-		p->int_min = int_min;
-		p->int_max = int_max;
 		return;
 	    }
 	  p = p->next;
@@ -579,9 +570,12 @@ update_field_infos_double_minmax (struct field_container_infos *infos,
       {
 	  if (strcasecmp (col_name, p->col_name) == 0)
 	    {
+		/* merging with any range already known */
+		if (!p->dbl_minmax_set || dbl_min < p->dbl_min)
+		    p->dbl_min = dbl_min;
+		if (!p->dbl_minmax_set || dbl_max > p->dbl_max)
+		    p->dbl_max = dbl_max;
 		p->dbl_minmax_set = 1;
-		p->dbl_min = dbl_min;
-		p->dbl_max = dbl_max;
 		return;
 	    }
 	  p = p->next;
@@ -875,7 +869,7 @@ do_update_virts_field_infos (sqlite3 * sqlite, const char *table,
 }
 
 static int
-do_compute_minmax (sqlite3 * sqlite, const char *table,
+do_compute_minmax (sqlite3 * sqlite, const char *table, const char *where,
 		   struct field_container_infos *infos)
 {
 /* Pass2 - computing Integer / Double min/max ranges */
@@ -904,6 +898,13 @@ do_compute_minmax (sqlite3 * sqlite, const char *table,
     while (ptr)
       {
 	  quoted = gaiaDoubleQuotedSql (ptr->col_name);
+	  /* discarding any previous range no longer applicable */
+	  if (ptr->double_values != 0 || ptr->blob_values != 0
+	      || ptr->text_values != 0)
+	      ptr->int_minmax_set = 0;
+	  if (ptr->integer_values != 0 || ptr->blob_values != 0
+	      || ptr->text_values != 0)
+	      ptr->dbl_minmax_set = 0;
 	  if (ptr->integer_values >= 0 && ptr->double_values == 0
 	      && ptr->blob_values == 0 && ptr->text_values == 0)
 	    {
@@ -953,7 +954,8 @@ do_compute_minmax (sqlite3 * sqlite, const char *table,
 
       }
     quoted = gaiaDoubleQuotedSql (table);
-    sql_statement = sqlite3_mprintf (" FROM \"%s\"", quoted);
+    sql_statement = sqlite3_mprintf (" FROM \"%s\" %s", quoted,
+				     (where == NULL) ? "" : where);
     free (quoted);
     gaiaAppendToOutBuffer (&out_buf, sql_statement);
     sqlite3_free (sql_statement);
@@ -1060,13 +1062,14 @@ copy_attributes_into_layer (struct field_container_infos *infos,
       }
 }
 
-SPATIALITE_PRIVATE int
-doComputeFieldInfos (void *p_sqlite, const char *table,
-		     const char *column, int stat_type, void *p_lyr)
+static int
+do_compute_field_infos (sqlite3 * sqlite, const char *table, const char *where,
+			struct field_container_infos *infos)
 {
-/* computes FIELD_INFOS [single table/geometry] */
-    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
-    gaiaVectorLayerPtr lyr = (gaiaVectorLayerPtr) p_lyr;
+/* 
+/ computes FIELD_INFOS [single table/geometry]
+/ an optional WHERE clause restricts the rows being examined
+*/
     char *sql_statement;
     char *quoted;
     int ret;
@@ -1081,16 +1084,12 @@ doComputeFieldInfos (void *p_sqlite, const char *table,
     const char *sz;
     int size;
     int count;
-    int error = 0;
     int comma = 0;
     gaiaOutBuffer out_buf;
     gaiaOutBuffer group_by;
-    struct field_container_infos infos;
 
     gaiaOutBufferInitialize (&out_buf);
     gaiaOutBufferInitialize (&group_by);
-    infos.first = NULL;
-    infos.last = NULL;
 
 /* retrieving the column names for the current table */
 /* then building the SQL query statement */
@@ -1140,7 +1139,8 @@ doComputeFieldInfos (void *p_sqlite, const char *table,
     if (out_buf.Buffer == NULL)
 	return 0;
     quoted = gaiaDoubleQuotedSql (table);
-    sql_statement = sqlite3_mprintf (" FROM \"%s\" ", quoted);
+    sql_statement = sqlite3_mprintf (" FROM \"%s\" %s ", quoted,
+				     (where == NULL) ? "" : where);
     free (quoted);
     gaiaAppendToOutBuffer (&out_buf, sql_statement);
     sqlite3_free (sql_statement);
@@ -1171,7 +1171,7 @@ doComputeFieldInfos (void *p_sqlite, const char *table,
 			  size = -1;
 		      else
 			  size = atoi (sz);
-		      update_field_infos (&infos, ordinal, col_name, type, size,
+		      update_field_infos (infos, ordinal, col_name, type, size,
 					  count);
 		  }
 	    }
@@ -1179,10 +1179,25 @@ doComputeFieldInfos (void *p_sqlite, const char *table,
     sqlite3_free_table (results);
 
 /* Pass-2: computing INTEGER and DOUBLE min/max ranges */
-    if (!error)
+    return do_compute_minmax (sqlite, table, where, infos);
+}
+
+SPATIALITE_PRIVATE int
+doComputeFieldInfos (void *p_sqlite, const char *table,
+		     const char *column, int stat_type, void *p_lyr)
+{
+/* computes FIELD_INFOS [single table/geometry] */
+    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
+    gaiaVectorLayerPtr lyr = (gaiaVectorLayerPtr) p_lyr;
+    int error = 0;
+    struct field_container_infos infos;
+
+    infos.first = NULL;
+    infos.last = NULL;
+    if (!do_compute_field_infos (sqlite, table, NULL, &infos))
       {
-	  if (!do_compute_minmax (sqlite, table, &infos))
-	      error = 1;
+	  free_field_infos (&infos);
+	  return 0;
       }
 
     switch (stat_type)
@@ -1214,13 +1229,634 @@ doComputeFieldInfos (void *p_sqlite, const char *table,
     return 1;
 }
 
+static int
+check_watermark_table (sqlite3 * sqlite)
+{
+/* testing if the GEOMETRY_COLUMNS_WATERMARK table exists */
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int i;
+    int defined = 0;
+    ret =
+	sqlite3_get_table (sqlite,
+			   "PRAGMA table_info(geometry_columns_watermark)",
+			   &results, &rows, &columns, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows < 1)
+	;
+    else
+      {
+	  for (i = 1; i <= rows; i++)
+	      defined = 1;
+      }
+    sqlite3_free_table (results);
+    return defined;
+}
+
+static int
+do_update_watermark (sqlite3 * sqlite, const char *table, const char *column,
+		     int create)
+{
+/* 
+/ updating GEOMETRY_COLUMNS_WATERMARK 
+/ (the highest ROWID already accounted by current statistics)
+*/
+    char *sql_statement;
+    char *quoted;
+    int ret;
+
+    if (!check_watermark_table (sqlite))
+      {
+	  if (!create)
+	      return 1;
+	  ret =
+	      sqlite3_exec (sqlite,
+			    "CREATE TABLE geometry_columns_watermark (\n"
+			    "f_table_name TEXT NOT NULL,\n"
+			    "f_geometry_column TEXT NOT NULL,\n"
+			    "max_rowid INTEGER NOT NULL,\n"
+			    "last_verified TIMESTAMP,\n"
+			    "CONSTRAINT pk_gc_watermark PRIMARY KEY "
+			    "(f_table_name, f_geometry_column))", NULL, NULL,
+			    NULL);
+	  if (ret != SQLITE_OK)
+	      return 0;
+      }
+
+/* 
+/ last_verified is copied from GEOMETRY_COLUMNS_STATISTICS, so that any 
+/ later update of the statistics not tracking the watermark (e.g. a 
+/ sampled run) will invalidate it
+*/
+    quoted = gaiaDoubleQuotedSql (table);
+    sql_statement =
+	sqlite3_mprintf ("INSERT OR REPLACE INTO geometry_columns_watermark "
+			 "(f_table_name, f_geometry_column, max_rowid, last_verified) "
+			 "SELECT f_table_name, f_geometry_column, "
+			 "IfNull((SELECT Max(ROWID) FROM \"%s\"), 0), last_verified "
+			 "FROM geometry_columns_statistics "
+			 "WHERE Lower(f_table_name) = Lower(%Q) AND "
+			 "Lower(f_geometry_column) = Lower(%Q)", quoted, table,
+			 column);
+    free (quoted);
+    ret = sqlite3_exec (sqlite, sql_statement, NULL, NULL, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    return 1;
+}
+
+static int
+load_field_infos (sqlite3 * sqlite, const char *table, const char *column,
+		  struct field_container_infos *infos)
+{
+/* 
+/ loading the current GEOMETRY_COLUMNS_FIELD_INFOS
+/ returns 0 if they are missing or if the table layout has changed
+*/
+    char *sql_statement;
+    char *quoted;
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    int ok = 1;
+    struct field_item_infos *p;
+
+    sql_statement =
+	sqlite3_mprintf ("SELECT ordinal, column_name, null_values, "
+			 "integer_values, double_values, text_values, "
+			 "blob_values, max_size, integer_min, integer_max, "
+			 "double_min, double_max "
+			 "FROM geometry_columns_field_infos "
+			 "WHERE Lower(f_table_name) = Lower(%Q) AND "
+			 "Lower(f_geometry_column) = Lower(%Q) "
+			 "ORDER BY ordinal", table, column);
+    ret =
+	sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			   NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows < 1)
+	ok = 0;
+    else
+      {
+	  for (i = 1; i <= rows; i++)
+	    {
+		const char **row = (const char **) results + (i * columns);
+		if (row[0] == NULL || row[1] == NULL)
+		  {
+		      ok = 0;
+		      break;
+		  }
+		p = add_field_infos_item (infos, atoi (row[0]), row[1]);
+		p->null_values = (row[2] == NULL) ? 0 : atoi (row[2]);
+		p->integer_values = (row[3] == NULL) ? 0 : atoi (row[3]);
+		p->double_values = (row[4] == NULL) ? 0 : atoi (row[4]);
+		p->text_values = (row[5] == NULL) ? 0 : atoi (row[5]);
+		p->blob_values = (row[6] == NULL) ? 0 : atoi (row[6]);
+		p->max_size = (row[7] == NULL) ? -1 : atoi (row[7]);
+		if (row[8] != NULL && row[9] != NULL)
+		  {
+		      p->int_minmax_set = 1;
+		      p->int_min = atoi (row[8]);
+		      p->int_max = atoi (row[9]);
+		  }
+		if (row[10] != NULL && row[11] != NULL)
+		  {
+		      p->dbl_minmax_set = 1;
+		      p->dbl_min = atof (row[10]);
+		      p->dbl_max = atof (row[11]);
+		  }
+	    }
+      }
+    sqlite3_free_table (results);
+    if (!ok)
+	return 0;
+
+/* checking the table layout against the stored FIELD_INFOS */
+    quoted = gaiaDoubleQuotedSql (table);
+    sql_statement = sqlite3_mprintf ("PRAGMA table_info(\"%s\")", quoted);
+    free (quoted);
+    ret =
+	sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			   NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    p = infos->first;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (p == NULL)
+	    {
+		ok = 0;
+		break;
+	    }
+	  if (atoi (results[(i * columns) + 0]) != p->ordinal
+	      || strcasecmp (results[(i * columns) + 1], p->col_name) != 0)
+	    {
+		ok = 0;
+		break;
+	    }
+	  p = p->next;
+      }
+    if (p != NULL)
+	ok = 0;
+    sqlite3_free_table (results);
+    return ok;
+}
+
+static float
+rtree_node_float (const unsigned char *p)
+{
+/* decoding a big-endian float32 from an R*Tree node */
+    union
+    {
+	unsigned int i;
+	float f;
+    } cvt;
+    cvt.i =
+	((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16) |
+	((unsigned int) p[2] << 8) | (unsigned int) p[3];
+    return cvt.f;
+}
+
+static int
+rtree_root_extent (sqlite3 * sqlite, const char *table, const char *column,
+		   double *min_x, double *min_y, double *max_x, double *max_y)
+{
+/* 
+/ retrieving the full extent from the root node of the Spatial Index
+/ (depth and cell count on 2+2 bytes, followed by 8 bytes id + 
+/ 4 float32 [x1, x2, y1, y2] for each cell, all big-endian)
+*/
+    char *sql_statement;
+    char *raw;
+    char *quoted;
+    int ret;
+    int i;
+    int count;
+    int ok = 0;
+    const unsigned char *blob;
+    int blob_sz;
+    char **results;
+    int rows;
+    int columns;
+    sqlite3_stmt *stmt;
+
+/* checking for an R*Tree Spatial Index */
+    sql_statement =
+	sqlite3_mprintf ("SELECT f_table_name, f_geometry_column "
+			 "FROM geometry_columns "
+			 "WHERE Lower(f_table_name) = Lower(%Q) AND "
+			 "Lower(f_geometry_column) = Lower(%Q) AND "
+			 "spatial_index_enabled = 1", table, column);
+    ret =
+	sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			   NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows < 1)
+      {
+	  sqlite3_free_table (results);
+	  return 0;
+      }
+    raw = sqlite3_mprintf ("idx_%s_%s_node", results[columns + 0],
+			   results[columns + 1]);
+    sqlite3_free_table (results);
+    quoted = gaiaDoubleQuotedSql (raw);
+    sqlite3_free (raw);
+    sql_statement =
+	sqlite3_mprintf ("SELECT data FROM \"%s\" WHERE nodeno = 1", quoted);
+    free (quoted);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+      {
+	  blob = sqlite3_column_blob (stmt, 0);
+	  blob_sz = sqlite3_column_bytes (stmt, 0);
+	  if (blob_sz >= 4)
+	    {
+		count = (blob[2] << 8) | blob[3];
+		if (count > 0 && blob_sz >= 4 + (count * 24))
+		  {
+		      for (i = 0; i < count; i++)
+			{
+			    const unsigned char *cell = blob + 4 + (i * 24) + 8;
+			    double x1 = rtree_node_float (cell);
+			    double x2 = rtree_node_float (cell + 4);
+			    double y1 = rtree_node_float (cell + 8);
+			    double y2 = rtree_node_float (cell + 12);
+			    if (i == 0 || x1 < *min_x)
+				*min_x = x1;
+			    if (i == 0 || y1 < *min_y)
+				*min_y = y1;
+			    if (i == 0 || x2 > *max_x)
+				*max_x = x2;
+			    if (i == 0 || y2 > *max_y)
+				*max_y = y2;
+			}
+		      ok = 1;
+		  }
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static int
+do_incremental_layer_statistics (sqlite3 * sqlite, const char *table,
+				 const char *column, int *done)
+{
+/* 
+/ updating GEOMETRY_COLUMNS_STATISTICS and FIELD_INFOS by only
+/ folding in the rows added after the last run
+/ *done is left to 0 whenever a full scan is required
+*/
+    char *sql_statement;
+    char *quoted;
+    char *col_quoted;
+    char *where;
+    int ret;
+    sqlite3_stmt *stmt;
+    int ok = 0;
+    sqlite3_int64 watermark = 0;
+    int count = 0;
+    int has_coords = 0;
+    double min_x = 0.0;
+    double min_y = 0.0;
+    double max_x = 0.0;
+    double max_y = 0.0;
+    int new_count = 0;
+    int total = -1;
+    struct field_container_infos infos;
+
+    *done = 0;
+    if (!check_watermark_table (sqlite))
+	return 1;
+
+/* 
+/ the watermark is only valid if it was recorded by the same run that
+/ last verified the statistics, and if no row has been updated or deleted
+/ since then
+*/
+    sql_statement =
+	sqlite3_mprintf ("SELECT w.max_rowid, s.row_count, "
+			 "s.extent_min_x, s.extent_min_y, s.extent_max_x, s.extent_max_y "
+			 "FROM geometry_columns_watermark AS w, "
+			 "geometry_columns_statistics AS s, "
+			 "geometry_columns_time AS t "
+			 "WHERE Lower(w.f_table_name) = Lower(%Q) AND "
+			 "Lower(w.f_geometry_column) = Lower(%Q) AND "
+			 "Lower(s.f_table_name) = Lower(w.f_table_name) AND "
+			 "Lower(s.f_geometry_column) = Lower(w.f_geometry_column) AND "
+			 "Lower(t.f_table_name) = Lower(w.f_table_name) AND "
+			 "Lower(t.f_geometry_column) = Lower(w.f_geometry_column) AND "
+			 "w.last_verified = s.last_verified AND "
+			 "s.row_count IS NOT NULL AND "
+			 "t.last_update < s.last_verified AND "
+			 "t.last_delete < s.last_verified", table, column);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  ok = 1;
+	  watermark = sqlite3_column_int64 (stmt, 0);
+	  count = sqlite3_column_int (stmt, 1);
+	  if (sqlite3_column_type (stmt, 2) != SQLITE_NULL
+	      && sqlite3_column_type (stmt, 3) != SQLITE_NULL
+	      && sqlite3_column_type (stmt, 4) != SQLITE_NULL
+	      && sqlite3_column_type (stmt, 5) != SQLITE_NULL)
+	    {
+		has_coords = 1;
+		min_x = sqlite3_column_double (stmt, 2);
+		min_y = sqlite3_column_double (stmt, 3);
+		max_x = sqlite3_column_double (stmt, 4);
+		max_y = sqlite3_column_double (stmt, 5);
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (!ok)
+	return 1;
+
+/* scanning the new rows only; extents come from the BLOB headers */
+    quoted = gaiaDoubleQuotedSql (table);
+    col_quoted = gaiaDoubleQuotedSql (column);
+    sql_statement = sqlite3_mprintf ("SELECT Count(*), "
+				     "Min(MbrMinX(\"%s\")), Min(MbrMinY(\"%s\")), Max(MbrMaxX(\"%s\")), Max(MbrMaxY(\"%s\")), "
+				     "(SELECT Count(*) FROM \"%s\") "
+				     "FROM \"%s\" WHERE ROWID > ?", col_quoted,
+				     col_quoted, col_quoted, col_quoted, quoted,
+				     quoted);
+    free (quoted);
+    free (col_quoted);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 1;
+    sqlite3_bind_int64 (stmt, 1, watermark);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  new_count = sqlite3_column_int (stmt, 0);
+	  total = sqlite3_column_int (stmt, 5);
+	  if (sqlite3_column_type (stmt, 1) != SQLITE_NULL
+	      && sqlite3_column_type (stmt, 2) != SQLITE_NULL
+	      && sqlite3_column_type (stmt, 3) != SQLITE_NULL
+	      && sqlite3_column_type (stmt, 4) != SQLITE_NULL)
+	    {
+		double x1 = sqlite3_column_double (stmt, 1);
+		double y1 = sqlite3_column_double (stmt, 2);
+		double x2 = sqlite3_column_double (stmt, 3);
+		double y2 = sqlite3_column_double (stmt, 4);
+		if (!has_coords || x1 < min_x)
+		    min_x = x1;
+		if (!has_coords || y1 < min_y)
+		    min_y = y1;
+		if (!has_coords || x2 > max_x)
+		    max_x = x2;
+		if (!has_coords || y2 > max_y)
+		    max_y = y2;
+		has_coords = 1;
+	    }
+      }
+    sqlite3_finalize (stmt);
+/* 
+/ rows inserted with an explicit ROWID below the watermark can't be
+/ detected by the timestamps alone: the total row count catches them
+*/
+    if (total != count + new_count)
+	return 1;
+
+    infos.first = NULL;
+    infos.last = NULL;
+    if (!load_field_infos (sqlite, table, column, &infos))
+      {
+	  free_field_infos (&infos);
+	  return 1;
+      }
+    if (new_count > 0)
+      {
+	  where = sqlite3_mprintf ("WHERE ROWID > %lld", watermark);
+	  ret = do_compute_field_infos (sqlite, table, where, &infos);
+	  sqlite3_free (where);
+	  if (!ret)
+	    {
+		free_field_infos (&infos);
+		return 0;
+	    }
+      }
+
+    ok = 1;
+    if (!do_update_layer_statistics_v4
+	(sqlite, table, column, total, has_coords, min_x, min_y, max_x, max_y))
+	ok = 0;
+    if (ok && new_count > 0)
+      {
+	  if (!do_update_field_infos (sqlite, table, column, &infos))
+	      ok = 0;
+      }
+    free_field_infos (&infos);
+    if (!ok)
+	return 0;
+    if (!do_update_watermark (sqlite, table, column, 1))
+	return 0;
+    *done = 1;
+    return 1;
+}
+
+static int
+do_sampled_layer_statistics (sqlite3 * sqlite, const char *table,
+			     const char *column, double sample_rate,
+			     int *done)
+{
+/* 
+/ updating GEOMETRY_COLUMNS_STATISTICS and FIELD_INFOS by only
+/ examining a sample of rows evenly spread across the ROWID range
+/ *done is left to 0 whenever a full scan is required
+*/
+    char *sql_statement;
+    char *quoted;
+    char *col_quoted;
+    char *where;
+    int ret;
+    sqlite3_stmt *stmt;
+    int count = 0;
+    int n_sample;
+    int sampled;
+    double scale;
+    sqlite3_int64 min_rowid = 0;
+    sqlite3_int64 max_rowid = 0;
+    int has_coords;
+    double min_x = 0.0;
+    double min_y = 0.0;
+    double max_x = 0.0;
+    double max_y = 0.0;
+    int ok = 0;
+    struct field_container_infos infos;
+    struct field_item_infos *p;
+
+    *done = 0;
+    quoted = gaiaDoubleQuotedSql (table);
+    sql_statement =
+	sqlite3_mprintf ("SELECT Count(*), Min(ROWID), Max(ROWID) FROM \"%s\"",
+			 quoted);
+    free (quoted);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 1;
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  ok = 1;
+	  count = sqlite3_column_int (stmt, 0);
+	  min_rowid = sqlite3_column_int64 (stmt, 1);
+	  max_rowid = sqlite3_column_int64 (stmt, 2);
+      }
+    sqlite3_finalize (stmt);
+    if (!ok)
+	return 1;
+    n_sample = (int) ceil ((double) count * sample_rate);
+    if (count == 0 || n_sample >= count)
+	return 1;               /* a full scan costs just the same */
+
+/* one ROWID seek for each sample point */
+    quoted = gaiaDoubleQuotedSql (table);
+    where =
+	sqlite3_mprintf ("WHERE ROWID IN (WITH RECURSIVE s(i) AS "
+			 "(SELECT 0 UNION ALL SELECT i + 1 FROM s WHERE i + 1 < %d) "
+			 "SELECT (SELECT ROWID FROM \"%s\" WHERE ROWID >= "
+			 "%lld + CAST(i * %1.6f AS INTEGER) ORDER BY ROWID LIMIT 1) "
+			 "FROM s)", n_sample, quoted, min_rowid,
+			 ((double) (max_rowid - min_rowid) + 1.0) /
+			 (double) n_sample);
+    free (quoted);
+
+/* 
+/ the extent comes from the Spatial Index (once merged any pending
+/ deferred entry) or else from the sample
+*/
+    has_coords = 0;
+    if (flushDeferredSpatialIndex (sqlite, table, column) >= 0)
+	has_coords =
+	    rtree_root_extent (sqlite, table, column, &min_x, &min_y, &max_x,
+			       &max_y);
+    if (!has_coords)
+      {
+	  quoted = gaiaDoubleQuotedSql (table);
+	  col_quoted = gaiaDoubleQuotedSql (column);
+	  sql_statement = sqlite3_mprintf ("SELECT "
+					   "Min(MbrMinX(\"%s\")), Min(MbrMinY(\"%s\")), Max(MbrMaxX(\"%s\")), Max(MbrMaxY(\"%s\")) "
+					   "FROM \"%s\" %s", col_quoted,
+					   col_quoted, col_quoted, col_quoted,
+					   quoted, where);
+	  free (quoted);
+	  free (col_quoted);
+	  ret =
+	      sqlite3_prepare_v2 (sqlite, sql_statement,
+				  strlen (sql_statement), &stmt, NULL);
+	  sqlite3_free (sql_statement);
+	  if (ret != SQLITE_OK)
+	    {
+		sqlite3_free (where);
+		return 0;
+	    }
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_type (stmt, 0) != SQLITE_NULL
+		    && sqlite3_column_type (stmt, 1) != SQLITE_NULL
+		    && sqlite3_column_type (stmt, 2) != SQLITE_NULL
+		    && sqlite3_column_type (stmt, 3) != SQLITE_NULL)
+		  {
+		      has_coords = 1;
+		      min_x = sqlite3_column_double (stmt, 0);
+		      min_y = sqlite3_column_double (stmt, 1);
+		      max_x = sqlite3_column_double (stmt, 2);
+		      max_y = sqlite3_column_double (stmt, 3);
+		  }
+	    }
+	  sqlite3_finalize (stmt);
+      }
+
+    infos.first = NULL;
+    infos.last = NULL;
+    ret = do_compute_field_infos (sqlite, table, where, &infos);
+    sqlite3_free (where);
+    if (!ret)
+      {
+	  free_field_infos (&infos);
+	  return 0;
+      }
+
+/* scaling the sampled counts up to the whole table */
+    p = infos.first;
+    sampled = 0;
+    if (p != NULL)
+	sampled =
+	    p->null_values + p->integer_values + p->double_values +
+	    p->text_values + p->blob_values;
+    if (sampled > 0)
+      {
+	  scale = (double) count / (double) sampled;
+	  while (p)
+	    {
+		p->null_values = (int) floor (p->null_values * scale + 0.5);
+		p->integer_values =
+		    (int) floor (p->integer_values * scale + 0.5);
+		p->double_values = (int) floor (p->double_values * scale + 0.5);
+		p->text_values = (int) floor (p->text_values * scale + 0.5);
+		p->blob_values = (int) floor (p->blob_values * scale + 0.5);
+		p = p->next;
+	    }
+      }
+
+    ok = 1;
+    if (!do_update_layer_statistics_v4
+	(sqlite, table, column, count, has_coords, min_x, min_y, max_x, max_y))
+	ok = 0;
+    if (ok)
+      {
+	  if (!do_update_field_infos (sqlite, table, column, &infos))
+	      ok = 0;
+      }
+    free_field_infos (&infos);
+    if (!ok)
+	return 0;
+    *done = 1;
+    return 1;
+}
+
 static int
 do_compute_layer_statistics (sqlite3 * sqlite, const char *table,
-			     const char *column, int stat_type)
+			     const char *column, int stat_type, int mode,
+			     double sample_rate)
 {
 /* computes LAYER_STATISTICS [single table/geometry] */
     int ret;
     int error = 0;
+    int done = 0;
     int count;
     double min_x = DBL_MAX;
     double min_y = DBL_MAX;
@@ -1233,6 +1869,25 @@ do_compute_layer_statistics (sqlite3 * sqlite, const char *table,
     sqlite3_stmt *stmt;
     int metadata_version = checkSpatialMetaData (sqlite);
 
+    if (stat_type == SPATIALITE_STATISTICS_GENUINE && metadata_version == 3)
+      {
+	  /* incremental and sampled modes: ordinary tables only */
+	  if (mode == SPLITE_STATS_INCREMENTAL)
+	    {
+		if (!do_incremental_layer_statistics
+		    (sqlite, table, column, &done))
+		    return 0;
+	    }
+	  if (mode == SPLITE_STATS_SAMPLED)
+	    {
+		if (!do_sampled_layer_statistics
+		    (sqlite, table, column, sample_rate, &done))
+		    return 0;
+	    }
+	  if (done)
+	      return 1;
+      }
+
     quoted = gaiaDoubleQuotedSql ((const char *) table);
     col_quoted = gaiaDoubleQuotedSql ((const char *) column);
     sql_statement = sqlite3_mprintf ("SELECT Count(*), "
@@ -1309,13 +1964,23 @@ do_compute_layer_statistics (sqlite3 * sqlite, const char *table,
 	  /* current metadata style >= v.4.0.0 */
 	  if (!doComputeFieldInfos (sqlite, table, column, stat_type, NULL))
 	      return 0;
+	  if (stat_type == SPATIALITE_STATISTICS_GENUINE)
+	    {
+		/* 
+		/ recording the watermark for later incremental runs;
+		/ failing here (e.g. WITHOUT ROWID) only means that the
+		/ next incremental run will fall back to a full scan
+		*/
+		do_update_watermark (sqlite, table, column,
+				     mode == SPLITE_STATS_INCREMENTAL);
+	    }
       }
     return 1;
 }
 
 static int
 genuine_layer_statistics_v4 (sqlite3 * sqlite, const char *table,
-			     const char *column)
+			     const char *column, int mode, double sample_rate)
 {
 /* updating GEOMETRY_COLUMNS_STATISTICS Version >= 4.0.0 */
     char *sql_statement;
@@ -1390,7 +2055,7 @@ genuine_layer_statistics_v4 (sqlite3 * sqlite, const char *table,
 		f_geometry_column = results[(i * columns) + 1];
 		if (!do_compute_layer_statistics
 		    (sqlite, f_table_name, f_geometry_column,
-		     SPATIALITE_STATISTICS_GENUINE))
+		     SPATIALITE_STATISTICS_GENUINE, mode, sample_rate))
 		  {
 		      error = 1;
 		      break;
@@ -1405,7 +2070,7 @@ genuine_layer_statistics_v4 (sqlite3 * sqlite, const char *table,
 
 static int
 genuine_layer_statistics (sqlite3 * sqlite, const char *table,
-			  const char *column)
+			  const char *column, int mode, double sample_rate)
 {
 /* updating genuine LAYER_STATISTICS metadata */
     char *sql_statement;
@@ -1422,7 +2087,8 @@ genuine_layer_statistics (sqlite3 * sqlite, const char *table,
     if (metadata_version == 3)
       {
 	  /* current metadata style >= v.4.0.0 */
-	  return genuine_layer_statistics_v4 (sqlite, table, column);
+	  return genuine_layer_statistics_v4 (sqlite, table, column, mode,
+					      sample_rate);
       }
 
     if (table == NULL && column == NULL)
@@ -1466,7 +2132,7 @@ genuine_layer_statistics (sqlite3 * sqlite, const char *table,
 		f_geometry_column = results[(i * columns) + 1];
 		if (!do_compute_layer_statistics
 		    (sqlite, f_table_name, f_geometry_column,
-		     SPATIALITE_STATISTICS_GENUINE))
+		     SPATIALITE_STATISTICS_GENUINE, mode, sample_rate))
 		  {
 		      error = 1;
 		      break;
@@ -1532,7 +2198,7 @@ views_layer_statistics (sqlite3 * sqlite, const char *table, const char *column)
 		view_geometry = results[(i * columns) + 1];
 		if (!do_compute_layer_statistics
 		    (sqlite, view_name, view_geometry,
-		     SPATIALITE_STATISTICS_VIEWS))
+		     SPATIALITE_STATISTICS_VIEWS, SPLITE_STATS_FULL, 0.0))
 		  {
 		      error = 1;
 		      break;
@@ -1598,7 +2264,7 @@ virts_layer_statistics (sqlite3 * sqlite, const char *table, const char *column)
 		f_geometry_column = results[(i * columns) + 1];
 		if (!do_compute_layer_statistics
 		    (sqlite, f_table_name, f_geometry_column,
-		     SPATIALITE_STATISTICS_VIRTS))
+		     SPATIALITE_STATISTICS_VIRTS, SPLITE_STATS_FULL, 0.0))
 		  {
 		      error = 1;
 		      break;
@@ -1668,7 +2334,19 @@ update_layer_statistics (sqlite3 * sqlite, const char *table,
 			 const char *column)
 {
 /* updating LAYER_STATISTICS metadata [main] */
-    if (!genuine_layer_statistics (sqlite, table, column))
+    return update_layer_statistics_ex (sqlite, table, column,
+				       SPLITE_STATS_FULL, 0.0);
+}
+
+SPATIALITE_DECLARE int
+update_layer_statistics_ex (sqlite3 * sqlite, const char *table,
+			    const char *column, int mode, double sample_rate)
+{
+/* updating LAYER_STATISTICS metadata [main - incremental / sampled] */
+    if (mode == SPLITE_STATS_SAMPLED
+	&& (sample_rate <= 0.0 || sample_rate > 1.0))
+	return 0;
+    if (!genuine_layer_statistics (sqlite, table, column, mode, sample_rate))
 	return 0;
     if (has_views_metadata (sqlite))
       {
@@ -1695,6 +2373,7 @@ struct drop_params
     int ok_geometry_columns_auth;
     int ok_geometry_columns_field_infos;
     int ok_geometry_columns_statistics;
+    int ok_geometry_columns_watermark;
     int ok_views_geometry_columns_auth;
     int ok_views_geometry_columns_field_infos;
     int ok_views_geometry_columns_statistics;
@@ -1876,6 +2555,23 @@ do_drop_table (sqlite3 * sqlite, const char *prefix, const char *table,
 		return 0;
 	    }
       }
+    if (aux->ok_geometry_columns_watermark)
+      {
+	  /* deleting from GEOMETRY_COLUMNS_WATERMARK */
+	  q_prefix = gaiaDoubleQuotedSql (prefix);
+	  sql =
+	      sqlite3_mprintf ("DELETE FROM \"%s\".geometry_columns_watermark "
+			       "WHERE lower(f_table_name) = lower(%Q)",
+			       q_prefix, table);
+	  free (q_prefix);
+	  ret = sqlite3_exec (sqlite, sql, NULL, NULL, &errMsg);
+	  sqlite3_free (sql);
+	  if (ret != SQLITE_OK)
+	    {
+		aux->error_message = errMsg;
+		return 0;
+	    }
+      }
     if (aux->ok_views_geometry_columns_auth)
       {
 	  /* deleting from VIEWS_GEOMETRY_COLUMNS_AUTH */
@@ -2102,6 +2798,7 @@ do_drop_sub_view (sqlite3 * sqlite, const char *prefix, const char *table,
     aux2.ok_geometry_columns_auth = aux->ok_geometry_columns_auth;
     aux2.ok_geometry_columns_field_infos = aux->ok_geometry_columns_field_infos;
     aux2.ok_geometry_columns_statistics = aux->ok_geometry_columns_statistics;
+    aux2.ok_geometry_columns_watermark = aux->ok_geometry_columns_watermark;
     aux2.ok_views_geometry_columns_auth = aux->ok_views_geometry_columns_auth;
     aux2.ok_views_geometry_columns_field_infos =
 	aux->ok_views_geometry_columns_field_infos;
@@ -2204,6 +2901,8 @@ check_drop_layout (sqlite3 * sqlite, const char *prefix, const char *table,
 			  aux->ok_virts_geometry_columns_auth = 1;
 		      if (strcasecmp (name, "geometry_columns_statistics") == 0)
 			  aux->ok_geometry_columns_statistics = 1;
+		      if (strcasecmp (name, "geometry_columns_watermark") == 0)
+			  aux->ok_geometry_columns_watermark = 1;
 		      if (strcasecmp (name, "views_geometry_columns_statistics")
 			  == 0)
 			  aux->ok_views_geometry_columns_statistics = 1;
@@ -2246,16 +2945,19 @@ check_drop_layout (sqlite3 * sqlite, const char *prefix, const char *table,
     if (!ret)
 	return 0;
 
-/* identifying any possible R*Tree supporting the main target */
+/* identifying any possible R*Tree (or deferred R*Tree log) supporting the main target */
     q_prefix = gaiaDoubleQuotedSql (prefix);
     sql =
 	sqlite3_mprintf
 	("SELECT name FROM \"%s\".sqlite_master WHERE type = 'table' AND "
-	 "Lower(name) IN (SELECT "
+	 "((Lower(name) IN (SELECT "
 	 "Lower('idx_' || f_table_name || '_' || f_geometry_column) "
 	 "FROM geometry_columns WHERE Lower(f_table_name) = Lower(%Q)) "
-	 "AND sql LIKE('%cvirtual%c') AND sql LIKE('%crtree%c')",
-	 q_prefix, table, jolly, jolly, jolly, jolly);
+	 "AND sql LIKE('%cvirtual%c') AND sql LIKE('%crtree%c')) OR "
+	 "Lower(name) IN (SELECT "
+	 "Lower('idxlog_' || f_table_name || '_' || f_geometry_column) "
+	 "FROM geometry_columns WHERE Lower(f_table_name) = Lower(%Q)))",
+	 q_prefix, table, jolly, jolly, jolly, jolly, table);
     free (q_prefix);
     ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
     sqlite3_free (sql);
@@ -2407,6 +3109,7 @@ gaiaDropTableEx3 (sqlite3 * sqlite, const char *prefix, const char *table,
     aux.ok_geometry_columns_auth = 0;
     aux.ok_geometry_columns_field_infos = 0;
     aux.ok_geometry_columns_statistics = 0;
+    aux.ok_geometry_columns_watermark = 0;
     aux.ok_views_geometry_columns_auth = 0;
     aux.ok_views_geometry_columns_field_infos = 0;
     aux.ok_views_geometry_columns_statistics = 0;
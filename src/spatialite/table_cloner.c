@@ -46,6 +46,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <float.h>
 
 #if defined(_WIN32) && !defined(__MINGW32__)
 #include "config-msvc.h"
@@ -59,6 +60,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <spatialite.h>
 #include <spatialite_private.h>
 #include <spatialite/gaiaaux.h>
+#include <spatialite/gaiageo.h>
 
 #ifdef _WIN32
 #define strcasecmp	_stricmp
@@ -2333,3 +2335,655 @@ gaiaAuxClonerExecute (const void *handle)
       }
     return 1;
 }
+
+struct aux_cluster_item
+{
+/* a row to be clustered: original ROWID and its Hilbert key */
+    sqlite3_int64 rowid;
+    sqlite3_uint64 key;
+};
+
+static sqlite3_uint64
+cluster_hilbert_key (unsigned int x, unsigned int y)
+{
+/* computing the distance along a Hilbert curve of order 16 */
+    sqlite3_uint64 d = 0;
+    unsigned int s;
+    unsigned int rx;
+    unsigned int ry;
+    unsigned int t;
+    for (s = 0x8000; s > 0; s /= 2)
+      {
+	  rx = (x & s) > 0;
+	  ry = (y & s) > 0;
+	  d += (sqlite3_uint64) s *(sqlite3_uint64) s *((3 * rx) ^ ry);
+	  if (ry == 0)
+	    {
+		/* rotating the quadrant */
+		if (rx == 1)
+		  {
+		      x = 0xffff - x;
+		      y = 0xffff - y;
+		  }
+		t = x;
+		x = y;
+		y = t;
+	    }
+      }
+    return d;
+}
+
+static int
+cmp_cluster_items (const void *p1, const void *p2)
+{
+/* compares two rows by Hilbert key, then by ROWID [for qsort] */
+    const struct aux_cluster_item *i1 = (const struct aux_cluster_item *) p1;
+    const struct aux_cluster_item *i2 = (const struct aux_cluster_item *) p2;
+    if (i1->key < i2->key)
+	return -1;
+    if (i1->key > i2->key)
+	return 1;
+    if (i1->rowid < i2->rowid)
+	return -1;
+    if (i1->rowid > i2->rowid)
+	return 1;
+    return 0;
+}
+
+static unsigned int
+cluster_grid_coord (double value, double min, double range)
+{
+/* mapping a coordinate onto the 16-bit Hilbert grid */
+    double v;
+    if (range <= 0.0)
+	return 0;
+    v = ((value - min) / range) * 65535.0;
+    if (v < 0.0)
+	v = 0.0;
+    if (v > 65535.0)
+	v = 65535.0;
+    return (unsigned int) v;
+}
+
+static struct aux_cluster_item *
+cluster_load_items (sqlite3 * sqlite, const char *table, const char *geom,
+		    int *count)
+{
+/* loading all ROWIDs and computing their Hilbert keys */
+    struct aux_cluster_item *items = NULL;
+    double *cx = NULL;
+    double *cy = NULL;
+    int n = 0;
+    int alloc = 0;
+    int valid = 0;
+    double minx = DBL_MAX;
+    double miny = DBL_MAX;
+    double maxx = -DBL_MAX;
+    double maxy = -DBL_MAX;
+    char *xtable;
+    char *xgeom;
+    char *sql;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    int i;
+
+    *count = 0;
+    xtable = gaiaDoubleQuotedSql (table);
+    xgeom = gaiaDoubleQuotedSql (geom);
+    sql =
+	sqlite3_mprintf ("SELECT ROWID, \"%s\" FROM main.\"%s\"", xgeom,
+			 xtable);
+    free (xtable);
+    free (xgeom);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  spatialite_e ("ClusterGeoTable: \"%s\"\n", sqlite3_errmsg (sqlite));
+	  return NULL;
+      }
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret != SQLITE_ROW)
+	    {
+		spatialite_e ("ClusterGeoTable: \"%s\"\n",
+			      sqlite3_errmsg (sqlite));
+		goto error;
+	    }
+	  if (n == alloc)
+	    {
+		struct aux_cluster_item *p_items;
+		double *p_cx;
+		double *p_cy;
+		alloc = (alloc == 0) ? 1024 : alloc * 2;
+		p_items = realloc (items,
+				   sizeof (struct aux_cluster_item) * alloc);
+		if (p_items == NULL)
+		    goto error;
+		items = p_items;
+		p_cx = realloc (cx, sizeof (double) * alloc);
+		if (p_cx == NULL)
+		    goto error;
+		cx = p_cx;
+		p_cy = realloc (cy, sizeof (double) * alloc);
+		if (p_cy == NULL)
+		    goto error;
+		cy = p_cy;
+	    }
+	  items[n].rowid = sqlite3_column_int64 (stmt, 0);
+	  items[n].key = 0xffffffffffffffffULL;
+	  cx[n] = DBL_MAX;
+	  cy[n] = DBL_MAX;
+	  if (sqlite3_column_type (stmt, 1) == SQLITE_BLOB)
+	    {
+		const unsigned char *blob = sqlite3_column_blob (stmt, 1);
+		unsigned int size = sqlite3_column_bytes (stmt, 1);
+		double x1;
+		double y1;
+		double x2;
+		double y2;
+		if (gaiaGetMbrMinX (blob, size, &x1)
+		    && gaiaGetMbrMinY (blob, size, &y1)
+		    && gaiaGetMbrMaxX (blob, size, &x2)
+		    && gaiaGetMbrMaxY (blob, size, &y2))
+		  {
+		      /* using the centroid of the MBR */
+		      cx[n] = (x1 + x2) / 2.0;
+		      cy[n] = (y1 + y2) / 2.0;
+		      if (cx[n] < minx)
+			  minx = cx[n];
+		      if (cx[n] > maxx)
+			  maxx = cx[n];
+		      if (cy[n] < miny)
+			  miny = cy[n];
+		      if (cy[n] > maxy)
+			  maxy = cy[n];
+		      valid++;
+		  }
+	    }
+	  n++;
+      }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+
+    if (valid > 0)
+      {
+	  /* computing the Hilbert keys; NULL geometries will come last */
+	  double range_x = maxx - minx;
+	  double range_y = maxy - miny;
+	  for (i = 0; i < n; i++)
+	    {
+		if (cx[i] == DBL_MAX)
+		    continue;
+		items[i].key =
+		    cluster_hilbert_key (cluster_grid_coord
+					 (cx[i], minx, range_x),
+					 cluster_grid_coord (cy[i], miny,
+							     range_y));
+	    }
+      }
+    if (cx != NULL)
+	free (cx);
+    if (cy != NULL)
+	free (cy);
+    if (n > 1)
+	qsort (items, n, sizeof (struct aux_cluster_item), cmp_cluster_items);
+    *count = n;
+    if (items == NULL)
+      {
+	  /* empty table: returning a dummy allocation */
+	  items = malloc (sizeof (struct aux_cluster_item));
+      }
+    return items;
+
+  error:
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    if (items != NULL)
+	free (items);
+    if (cx != NULL)
+	free (cx);
+    if (cy != NULL)
+	free (cy);
+    return NULL;
+}
+
+static int
+cluster_exec (sqlite3 * sqlite, char *sql)
+{
+/* executing an SQL statement (the statement will be freed) */
+    char *errMsg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &errMsg);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  spatialite_e ("ClusterGeoTable: \"%s\"\n", errMsg);
+	  sqlite3_free (errMsg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+cluster_check_geometry (sqlite3 * sqlite, const char *table,
+			const char *geom, char **real_table, char **real_geom)
+{
+/* checking if the Geometry is registered into geometry_columns */
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int len;
+    *real_table = NULL;
+    *real_geom = NULL;
+    sql = sqlite3_mprintf ("SELECT f_table_name, f_geometry_column "
+			   "FROM main.geometry_columns WHERE "
+			   "Lower(f_table_name) = Lower(%Q) AND "
+			   "Lower(f_geometry_column) = Lower(%Q)", table,
+			   geom);
+    ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows == 1 && results[2] != NULL && results[3] != NULL)
+      {
+	  len = strlen (results[2]);
+	  *real_table = malloc (len + 1);
+	  strcpy (*real_table, results[2]);
+	  len = strlen (results[3]);
+	  *real_geom = malloc (len + 1);
+	  strcpy (*real_geom, results[3]);
+      }
+    sqlite3_free_table (results);
+    if (*real_table == NULL)
+	return 0;
+    return 1;
+}
+
+static int
+cluster_foreign_keys_enabled (sqlite3 * sqlite)
+{
+/* checking if Foreign Keys are currently enforced */
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int enabled = 0;
+    ret =
+	sqlite3_get_table (sqlite, "PRAGMA foreign_keys", &results, &rows,
+			   &columns, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows >= 1 && results[1] != NULL)
+	enabled = atoi (results[1]);
+    sqlite3_free_table (results);
+    return enabled;
+}
+
+static char *
+cluster_column_list (sqlite3 * sqlite, const char *table, int resequence,
+		     int *rowid_pk)
+{
+/* 
+/ building the column list to be copied back; the ROWID alias
+/ (if any) will be excluded when resequencing
+*/
+    char *sql;
+    char *xtable;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int i;
+    int pk_count = 0;
+    int pk_index = -1;
+    char *list = NULL;
+    char *prev;
+    char *xname;
+
+    *rowid_pk = 0;
+    xtable = gaiaDoubleQuotedSql (table);
+    sql = sqlite3_mprintf ("PRAGMA main.table_info(\"%s\")", xtable);
+    free (xtable);
+    ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return NULL;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (atoi (results[(i * columns) + 5]) != 0)
+	    {
+		pk_count++;
+		pk_index = i;
+	    }
+      }
+    if (pk_count == 1)
+      {
+	  const char *type = results[(pk_index * columns) + 2];
+	  if (type != NULL && strcasecmp (type, "INTEGER") == 0)
+	      *rowid_pk = 1;
+      }
+    for (i = 1; i <= rows; i++)
+      {
+	  if (resequence && *rowid_pk && i == pk_index)
+	      continue;
+	  xname = gaiaDoubleQuotedSql (results[(i * columns) + 1]);
+	  if (list == NULL)
+	      list = sqlite3_mprintf ("\"%s\"", xname);
+	  else
+	    {
+		prev = list;
+		list = sqlite3_mprintf ("%s, \"%s\"", prev, xname);
+		sqlite3_free (prev);
+	    }
+	  free (xname);
+      }
+    sqlite3_free_table (results);
+    return list;
+}
+
+SPATIALITE_PRIVATE int
+gaiaAuxClusterGeoTable (const void *p_sqlite, const char *table,
+			const char *geom, int resequence)
+{
+/* 
+/ physically rewriting a Table so that its rows are stored in 
+/ Hilbert order of their MBR centroids, then reloading any
+/ SpatialIndex in the same order
+/
+/ returns the number of clustered rows or -1 on failure
+*/
+    sqlite3 *sqlite = (sqlite3 *) p_sqlite;
+    char *real_table = NULL;
+    char *real_geom = NULL;
+    char *col_list = NULL;
+    char *order_table = NULL;
+    char *data_table = NULL;
+    char *xtable = NULL;
+    char *xorder = NULL;
+    char *xdata = NULL;
+    char *sql;
+    char **results;
+    char **triggers = NULL;
+    int n_triggers = 0;
+    char **indexed = NULL;
+    int n_indexed = 0;
+    struct aux_cluster_item *items = NULL;
+    int count = 0;
+    int rowid_pk;
+    int rows;
+    int columns;
+    int ret;
+    int i;
+    int active = 0;
+    sqlite3_stmt *stmt = NULL;
+
+    if (checkSpatialMetaData (sqlite) < 3)
+      {
+	  spatialite_e ("ClusterGeoTable: obsolete DB-layout (< 4.0.0)\n");
+	  return -1;
+      }
+    if (!cluster_check_geometry (sqlite, table, geom, &real_table, &real_geom))
+      {
+	  spatialite_e
+	      ("ClusterGeoTable: \"%s\".\"%s\" isn't a registered Geometry\n",
+	       table, geom);
+	  goto error;
+      }
+    if (cluster_foreign_keys_enabled (sqlite))
+      {
+	  spatialite_e
+	      ("ClusterGeoTable: can't rewrite \"%s\" while Foreign Keys are enforced\n",
+	       real_table);
+	  goto error;
+      }
+    if (!validateRowid (sqlite, real_table))
+      {
+	  spatialite_e
+	      ("ClusterGeoTable: a physical column named ROWID shadows the real ROWID\n");
+	  goto error;
+      }
+    col_list = cluster_column_list (sqlite, real_table, resequence, &rowid_pk);
+    if (col_list == NULL)
+	goto error;
+    if (rowid_pk && !resequence)
+      {
+	  /* the rows are physically stored by their Primary Key values */
+	  spatialite_e
+	      ("ClusterGeoTable: the Primary Key of \"%s\" is the ROWID; "
+	       "clustering requires resequencing\n", real_table);
+	  goto error;
+      }
+
+/* identifying all the Geometries supported by a SpatialIndex */
+    sql = sqlite3_mprintf ("SELECT f_geometry_column FROM main.geometry_columns "
+			   "WHERE Lower(f_table_name) = Lower(%Q) AND "
+			   "spatial_index_enabled = 1", real_table);
+    ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    if (rows > 0)
+      {
+	  indexed = calloc (rows, sizeof (char *));
+	  for (i = 1; i <= rows; i++)
+	    {
+		const char *name = results[i * columns];
+		int len = strlen (name);
+		indexed[n_indexed] = malloc (len + 1);
+		strcpy (indexed[n_indexed], name);
+		n_indexed++;
+	    }
+      }
+    sqlite3_free_table (results);
+
+    ret = sqlite3_exec (sqlite, "SAVEPOINT cluster_geotable", NULL, NULL,
+			NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    active = 1;
+
+/* merging any pending Deferred SpatialIndex entry */
+    for (i = 0; i < n_indexed; i++)
+      {
+	  if (flushDeferredSpatialIndex (sqlite, real_table, indexed[i]) < 0)
+	      goto error;
+      }
+
+/* computing the Hilbert order */
+    items = cluster_load_items (sqlite, real_table, real_geom, &count);
+    if (items == NULL)
+	goto error;
+
+    xtable = gaiaDoubleQuotedSql (real_table);
+    order_table = sqlite3_mprintf ("tmp_cluster_%s_order", real_table);
+    xorder = gaiaDoubleQuotedSql (order_table);
+    data_table = sqlite3_mprintf ("tmp_cluster_%s_data", real_table);
+    xdata = gaiaDoubleQuotedSql (data_table);
+
+/* storing the Hilbert order into a TEMPORARY table */
+    sql = sqlite3_mprintf ("CREATE TEMPORARY TABLE \"%s\" ("
+			   "seq INTEGER PRIMARY KEY, "
+			   "old_rowid INTEGER NOT NULL)", xorder);
+    if (!cluster_exec (sqlite, sql))
+	goto error;
+    sql = sqlite3_mprintf ("INSERT INTO temp.\"%s\" (seq, old_rowid) "
+			   "VALUES (?, ?)", xorder);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    for (i = 0; i < count; i++)
+      {
+	  sqlite3_reset (stmt);
+	  sqlite3_clear_bindings (stmt);
+	  sqlite3_bind_int (stmt, 1, i + 1);
+	  sqlite3_bind_int64 (stmt, 2, items[i].rowid);
+	  ret = sqlite3_step (stmt);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	    {
+		spatialite_e ("ClusterGeoTable: \"%s\"\n",
+			      sqlite3_errmsg (sqlite));
+		goto error;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+    free (items);
+    items = NULL;
+
+/* saving a copy of all rows, sorted in Hilbert order */
+    sql = sqlite3_mprintf ("CREATE TEMPORARY TABLE \"%s\" AS "
+			   "SELECT t.* FROM main.\"%s\" AS t "
+			   "JOIN temp.\"%s\" AS o ON (t.ROWID = o.old_rowid) "
+			   "ORDER BY o.seq", xdata, xtable, xorder);
+    if (!cluster_exec (sqlite, sql))
+	goto error;
+
+/* saving and then dropping all Triggers */
+    sql = sqlite3_mprintf ("SELECT name, sql FROM main.sqlite_master "
+			   "WHERE type = 'trigger' AND "
+			   "Lower(tbl_name) = Lower(%Q) AND sql IS NOT NULL",
+			   real_table);
+    ret = sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    if (rows > 0)
+      {
+	  triggers = calloc (rows, sizeof (char *));
+	  for (i = 1; i <= rows; i++)
+	    {
+		char *xname = gaiaDoubleQuotedSql (results[(i * columns)]);
+		sql = sqlite3_mprintf ("DROP TRIGGER main.\"%s\"", xname);
+		free (xname);
+		triggers[n_triggers++] =
+		    sqlite3_mprintf ("%s", results[(i * columns) + 1]);
+		if (!cluster_exec (sqlite, sql))
+		  {
+		      sqlite3_free_table (results);
+		      goto error;
+		  }
+	    }
+      }
+    sqlite3_free_table (results);
+
+/* reinserting all rows in Hilbert order */
+    sql = sqlite3_mprintf ("DELETE FROM main.\"%s\"", xtable);
+    if (!cluster_exec (sqlite, sql))
+	goto error;
+    if (resequence)
+      {
+	  /* resetting any AUTOINCREMENT sequence */
+	  sql = sqlite3_mprintf ("SELECT name FROM main.sqlite_master "
+				 "WHERE type = 'table' AND name = 'sqlite_sequence'");
+	  ret =
+	      sqlite3_get_table (sqlite, sql, &results, &rows, &columns, NULL);
+	  sqlite3_free (sql);
+	  if (ret != SQLITE_OK)
+	      goto error;
+	  sqlite3_free_table (results);
+	  if (rows > 0)
+	    {
+		sql = sqlite3_mprintf ("DELETE FROM main.sqlite_sequence "
+				       "WHERE Lower(name) = Lower(%Q)",
+				       real_table);
+		if (!cluster_exec (sqlite, sql))
+		    goto error;
+	    }
+      }
+    sql = sqlite3_mprintf ("INSERT INTO main.\"%s\" (%s) "
+			   "SELECT %s FROM temp.\"%s\" ORDER BY ROWID",
+			   xtable, col_list, col_list, xdata);
+    if (!cluster_exec (sqlite, sql))
+	goto error;
+
+/* restoring all Triggers */
+    for (i = 0; i < n_triggers; i++)
+      {
+	  sql = triggers[i];
+	  triggers[i] = NULL;
+	  if (!cluster_exec (sqlite, sql))
+	      goto error;
+      }
+
+/* reloading all SpatialIndexes following the new ROWID order */
+    for (i = 0; i < n_indexed; i++)
+      {
+	  char *raw = sqlite3_mprintf ("idx_%s_%s", real_table, indexed[i]);
+	  char *xrtree = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  sql = sqlite3_mprintf ("DELETE FROM main.\"%s\"", xrtree);
+	  free (xrtree);
+	  if (!cluster_exec (sqlite, sql))
+	      goto error;
+	  if (buildSpatialIndexEx
+	      (sqlite, (const unsigned char *) real_table, indexed[i]) < 0)
+	      goto error;
+      }
+
+/* cleaning up */
+    sql = sqlite3_mprintf ("DROP TABLE temp.\"%s\"", xdata);
+    if (!cluster_exec (sqlite, sql))
+	goto error;
+    sql = sqlite3_mprintf ("DROP TABLE temp.\"%s\"", xorder);
+    if (!cluster_exec (sqlite, sql))
+	goto error;
+    ret = sqlite3_exec (sqlite, "RELEASE SAVEPOINT cluster_geotable", NULL,
+			NULL, NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    active = 0;
+    goto end;
+
+  error:
+    count = -1;
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    if (active)
+      {
+	  sqlite3_exec (sqlite, "ROLLBACK TO SAVEPOINT cluster_geotable",
+			NULL, NULL, NULL);
+	  sqlite3_exec (sqlite, "RELEASE SAVEPOINT cluster_geotable", NULL,
+			NULL, NULL);
+      }
+  end:
+    if (items != NULL)
+	free (items);
+    if (triggers != NULL)
+      {
+	  for (i = 0; i < n_triggers; i++)
+	    {
+		if (triggers[i] != NULL)
+		    sqlite3_free (triggers[i]);
+	    }
+	  free (triggers);
+      }
+    if (indexed != NULL)
+      {
+	  for (i = 0; i < n_indexed; i++)
+	      free (indexed[i]);
+	  free (indexed);
+      }
+    if (col_list != NULL)
+	sqlite3_free (col_list);
+    if (order_table != NULL)
+	sqlite3_free (order_table);
+    if (data_table != NULL)
+	sqlite3_free (data_table);
+    if (xtable != NULL)
+	free (xtable);
+    if (xorder != NULL)
+	free (xorder);
+    if (xdata != NULL)
+	free (xdata);
+    if (real_table != NULL)
+	free (real_table);
+    if (real_geom != NULL)
+	free (real_geom);
+    return count;
+}
@@ -58,6 +58,7 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <spatialite/spatialite.h>
 #include <spatialite/gaiaaux.h>
 #include <spatialite/gaiageo.h>
+#include <spatialite_private.h>
 
 #ifdef _WIN32
 #define strcasecmp	_stricmp
@@ -83,6 +84,15 @@ typedef struct VirtualElementaryStruct
 } VirtualElementary;
 typedef VirtualElementary *VirtualElementaryPtr;
 
+typedef struct VirtualElementaryItemStruct
+{
+/* a reference to some Elementary Geometry within the origin Geometry */
+    gaiaPointPtr point;
+    gaiaLinestringPtr linestring;
+    gaiaPolygonPtr polygon;
+} VirtualElementaryItem;
+typedef VirtualElementaryItem *VirtualElementaryItemPtr;
+
 typedef struct VirtualElementaryCursorStruct
 {
 /* extends the sqlite3_vtab_cursor struct */
@@ -92,7 +102,8 @@ typedef struct VirtualElementaryCursorStruct
     char *f_table_name;
     char *f_geometry_column;
     sqlite3_int64 origin_rowid;
-    gaiaGeomCollPtr *geometries;
+    gaiaGeomCollPtr geometry;
+    VirtualElementaryItemPtr items;
     int count;
     int current;
 } VirtualElementaryCursor;
@@ -200,223 +211,6 @@ velem_find_geometry (sqlite3 * sqlite, const char *db_prefix,
     return 1;
 }
 
-static gaiaGeomCollPtr
-velem_from_point (gaiaPointPtr pt, int srid)
-{
-/* creating a Geometry containing a single Point */
-    gaiaGeomCollPtr g = NULL;
-    switch (pt->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  g = gaiaAllocGeomCollXYZM ();
-	  break;
-      case GAIA_XY_Z:
-	  g = gaiaAllocGeomCollXYZ ();
-	  break;
-      case GAIA_XY_M:
-	  g = gaiaAllocGeomCollXYM ();
-	  break;
-      default:
-	  g = gaiaAllocGeomColl ();
-	  break;
-      };
-    if (!g)
-	return NULL;
-    g->Srid = srid;
-    g->DeclaredType = GAIA_POINT;
-    switch (pt->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  gaiaAddPointToGeomCollXYZM (g, pt->X, pt->Y, pt->Z, pt->M);
-	  break;
-      case GAIA_XY_Z:
-	  gaiaAddPointToGeomCollXYZ (g, pt->X, pt->Y, pt->Z);
-	  break;
-      case GAIA_XY_M:
-	  gaiaAddPointToGeomCollXYM (g, pt->X, pt->Y, pt->M);
-	  break;
-      default:
-	  gaiaAddPointToGeomColl (g, pt->X, pt->Y);
-	  break;
-      };
-    return g;
-}
-
-static gaiaGeomCollPtr
-velem_from_linestring (gaiaLinestringPtr ln, int srid)
-{
-/* creating a Geometry containing a single Linestring */
-    gaiaGeomCollPtr g = NULL;
-    gaiaLinestringPtr ln2;
-    int iv;
-    double x;
-    double y;
-    double z;
-    double m;
-    switch (ln->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  g = gaiaAllocGeomCollXYZM ();
-	  break;
-      case GAIA_XY_Z:
-	  g = gaiaAllocGeomCollXYZ ();
-	  break;
-      case GAIA_XY_M:
-	  g = gaiaAllocGeomCollXYM ();
-	  break;
-      default:
-	  g = gaiaAllocGeomColl ();
-	  break;
-      };
-    if (!g)
-	return NULL;
-    g->Srid = srid;
-    g->DeclaredType = GAIA_LINESTRING;
-    ln2 = gaiaAddLinestringToGeomColl (g, ln->Points);
-    switch (ln->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPointXYZM (ln->Coords, iv, &x, &y, &z, &m);
-		gaiaSetPointXYZM (ln2->Coords, iv, x, y, z, m);
-	    }
-	  break;
-      case GAIA_XY_Z:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPointXYZ (ln->Coords, iv, &x, &y, &z);
-		gaiaSetPointXYZ (ln2->Coords, iv, x, y, z);
-	    }
-	  break;
-      case GAIA_XY_M:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPointXYM (ln->Coords, iv, &x, &y, &m);
-		gaiaSetPointXYM (ln2->Coords, iv, x, y, m);
-	    }
-	  break;
-      default:
-	  for (iv = 0; iv < ln->Points; iv++)
-	    {
-		gaiaGetPoint (ln->Coords, iv, &x, &y);
-		gaiaSetPoint (ln2->Coords, iv, x, y);
-	    }
-	  break;
-      };
-    return g;
-}
-
-static gaiaGeomCollPtr
-velem_from_polygon (gaiaPolygonPtr pg, int srid)
-{
-/* creating a Geometry containing a single Polygon */
-    gaiaGeomCollPtr g = NULL;
-    gaiaPolygonPtr pg2;
-    gaiaRingPtr rng;
-    gaiaRingPtr rng2;
-    int ib;
-    int iv;
-    double x;
-    double y;
-    double z;
-    double m;
-    switch (pg->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  g = gaiaAllocGeomCollXYZM ();
-	  break;
-      case GAIA_XY_Z:
-	  g = gaiaAllocGeomCollXYZ ();
-	  break;
-      case GAIA_XY_M:
-	  g = gaiaAllocGeomCollXYM ();
-	  break;
-      default:
-	  g = gaiaAllocGeomColl ();
-	  break;
-      };
-    if (!g)
-	return NULL;
-    g->Srid = srid;
-    g->DeclaredType = GAIA_POLYGON;
-    rng = pg->Exterior;
-    pg2 = gaiaAddPolygonToGeomColl (g, rng->Points, pg->NumInteriors);
-    rng2 = pg2->Exterior;
-    switch (pg->DimensionModel)
-      {
-      case GAIA_XY_Z_M:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPointXYZM (rng->Coords, iv, &x, &y, &z, &m);
-		gaiaSetPointXYZM (rng2->Coords, iv, x, y, z, m);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPointXYZM (rng->Coords, iv, &x, &y, &z, &m);
-		      gaiaSetPointXYZM (rng2->Coords, iv, x, y, z, m);
-		  }
-	    }
-	  break;
-      case GAIA_XY_Z:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPointXYZ (rng->Coords, iv, &x, &y, &z);
-		gaiaSetPointXYZ (rng2->Coords, iv, x, y, z);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPointXYZ (rng->Coords, iv, &x, &y, &z);
-		      gaiaSetPointXYZ (rng2->Coords, iv, x, y, z);
-		  }
-	    }
-	  break;
-      case GAIA_XY_M:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPointXYM (rng->Coords, iv, &x, &y, &m);
-		gaiaSetPointXYM (rng2->Coords, iv, x, y, m);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPointXYM (rng->Coords, iv, &x, &y, &m);
-		      gaiaSetPointXYM (rng2->Coords, iv, x, y, m);
-		  }
-	    }
-	  break;
-      default:
-	  for (iv = 0; iv < rng->Points; iv++)
-	    {
-		gaiaGetPoint (rng->Coords, iv, &x, &y);
-		gaiaSetPoint (rng2->Coords, iv, x, y);
-	    }
-	  for (ib = 0; ib < pg->NumInteriors; ib++)
-	    {
-		rng = pg->Interiors + ib;
-		rng2 = gaiaAddInteriorRing (pg2, ib, rng->Points);
-		for (iv = 0; iv < rng->Points; iv++)
-		  {
-		      gaiaGetPoint (rng->Coords, iv, &x, &y);
-		      gaiaSetPoint (rng2->Coords, iv, x, y);
-		  }
-	    }
-	  break;
-      };
-    return g;
-}
-
 static int
 velem_create (sqlite3 * db, void *pAux, int argc, const char *const *argv,
 	      sqlite3_vtab ** ppVTab, char **pzErr)
@@ -478,20 +272,15 @@ velem_reset_cache (VirtualElementaryCursorPtr cursor)
 	free (cursor->f_table_name);
     if (cursor->f_geometry_column != NULL)
 	free (cursor->f_geometry_column);
-    if (cursor->geometries != NULL)
-      {
-	  int i;
-	  for (i = 0; i < cursor->count; i++)
-	    {
-		gaiaGeomCollPtr geom = *(cursor->geometries + i);
-		gaiaFreeGeomColl (geom);
-	    }
-	  free (cursor->geometries);
-      }
+    if (cursor->items != NULL)
+	free (cursor->items);
+    if (cursor->geometry != NULL)
+	gaiaFreeGeomColl (cursor->geometry);
     cursor->db_prefix = NULL;
     cursor->f_table_name = NULL;
     cursor->f_geometry_column = NULL;
-    cursor->geometries = NULL;
+    cursor->geometry = NULL;
+    cursor->items = NULL;
     cursor->count = 0;
     cursor->current = 0;
 }
@@ -602,7 +391,8 @@ velem_open (sqlite3_vtab * pVTab, sqlite3_vtab_cursor ** ppCursor)
     cursor->db_prefix = NULL;
     cursor->f_table_name = NULL;
     cursor->f_geometry_column = NULL;
-    cursor->geometries = NULL;
+    cursor->geometry = NULL;
+    cursor->items = NULL;
     cursor->count = 0;
     cursor->current = 0;
     *ppCursor = (sqlite3_vtab_cursor *) cursor;
@@ -835,37 +625,42 @@ velem_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
 			    count++;
 			    pg = pg->Next;
 			}
+		      /* 
+		       / Elementary Geometries will be lazily encoded
+		       / only when actually fetched, directly from 
+		       / the origin Geometry
+		       */
 		      cursor->count = count;
-		      cursor->geometries =
-			  malloc (sizeof (gaiaGeomCollPtr) * count);
+		      cursor->items =
+			  malloc (sizeof (VirtualElementaryItem) * count);
 		      for (count = 0; count < cursor->count; count++)
-			  *(cursor->geometries + count) = NULL;
+			{
+			    VirtualElementaryItemPtr item =
+				cursor->items + count;
+			    item->point = NULL;
+			    item->linestring = NULL;
+			    item->polygon = NULL;
+			}
 		      count = 0;
 		      pt = geom->FirstPoint;
 		      while (pt)
 			{
-			    gaiaGeomCollPtr elem =
-				velem_from_point (pt, geom->Srid);
-			    *(cursor->geometries + count++) = elem;
+			    (cursor->items + count++)->point = pt;
 			    pt = pt->Next;
 			}
 		      ln = geom->FirstLinestring;
 		      while (ln)
 			{
-			    gaiaGeomCollPtr elem =
-				velem_from_linestring (ln, geom->Srid);
-			    *(cursor->geometries + count++) = elem;
+			    (cursor->items + count++)->linestring = ln;
 			    ln = ln->Next;
 			}
 		      pg = geom->FirstPolygon;
 		      while (pg)
 			{
-			    gaiaGeomCollPtr elem =
-				velem_from_polygon (pg, geom->Srid);
-			    *(cursor->geometries + count++) = elem;
+			    (cursor->items + count++)->polygon = pg;
 			    pg = pg->Next;
 			}
-		      gaiaFreeGeomColl (geom);
+		      cursor->geometry = geom;
 		  }
 	    }
       }
@@ -890,7 +685,7 @@ velem_next (sqlite3_vtab_cursor * pCursor)
 {
 /* fetching next row from cursor */
     VirtualElementaryCursorPtr cursor = (VirtualElementaryCursorPtr) pCursor;
-    if (cursor->geometries == NULL)
+    if (cursor->items == NULL)
 	cursor->eof = 1;
     else
       {
@@ -957,16 +752,21 @@ velem_column (sqlite3_vtab_cursor * pCursor, sqlite3_context * pContext,
     if (column == 5)
       {
 	  /* the "geometry" column */
-	  gaiaGeomCollPtr geom = *(cursor->geometries + cursor->current);
-	  if (geom == NULL)
+	  unsigned char *blob = NULL;
+	  int size = 0;
+	  if (cursor->items != NULL && cursor->current < cursor->count)
+	    {
+		VirtualElementaryItemPtr item =
+		    cursor->items + cursor->current;
+		gaia_elementary_blob_from_item (item->point, item->linestring,
+						item->polygon,
+						cursor->geometry->Srid, &blob,
+						&size);
+	    }
+	  if (blob == NULL)
 	      sqlite3_result_null (pContext);
 	  else
-	    {
-		unsigned char *blob;
-		int size;
-		gaiaToSpatiaLiteBlobWkb (geom, &blob, &size);
-		sqlite3_result_blob (pContext, blob, size, free);
-	    }
+	      sqlite3_result_blob (pContext, blob, size, free);
       }
     return SQLITE_OK;
 }
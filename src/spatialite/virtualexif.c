@@ -0,0 +1,758 @@
+/*
+
+ virtualexif.c -- SQLite3 extension [VIRTUAL TABLE EXIF/GPS photo index]
+
+ version 4.5, 2017 January 16
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2017
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+/*
+
+IMPORTANT NOTE: how VirtualExif works
+
+geotagging a large set of photos by invoking:
+
+  SELECT GetExifGpsCoords(BlobFromFile(path)) ...
+
+requires loading each whole JPEG file into memory and then building
+the full list of its EXIF tags, just for reading a couple of them.
+
+the VirtualExif Virtual Table directly scans a directory:
+
+  CREATE VIRTUAL TABLE photos USING VirtualExif('/home/photos' [, 4]);
+
+and for each *.jpg or *.jpeg file it only reads the leading part
+containing the EXIF APP1 segment, then it directly fetches the
+GPS position (see gaiaScanExifGps) without allocating any tag.
+the optional second argument sets how many threads will concurrently
+parse the photos; rows will be always returned in directory order.
+
+*/
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include <windows.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#endif
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include "config-msvc.h"
+#else
+#include "config.h"
+#endif
+
+#include <spatialite/sqlite.h>
+
+#include <spatialite/spatialite.h>
+#include <spatialite/gaiaaux.h>
+#include <spatialite/gaiageo.h>
+#include <spatialite/gaiaexif.h>
+#include <splite_thread.h>
+
+#ifdef _WIN32
+#define strcasecmp	_stricmp
+#endif /* not WIN32 */
+
+/* max number of photos to be parsed by a single batch */
+#define VEXIF_BATCH		256
+/* leading bytes to be read from each photo (the APP1 segment is <= 64KB) */
+#define VEXIF_PREFIX		131072
+#define VEXIF_MAX_THREADS	64
+
+static struct sqlite3_module my_exif_module;
+
+/******************************************************************************
+/
+/ VirtualTable structs
+/
+******************************************************************************/
+
+typedef struct VirtualExifStruct
+{
+/* extends the sqlite3_vtab struct */
+    const sqlite3_module *pModule;	/* ptr to sqlite module: USED INTERNALLY BY SQLITE */
+    int nRef;			/* # references: USED INTERNALLY BY SQLITE */
+    char *zErrMsg;		/* error message: USE INTERNALLY BY SQLITE */
+    sqlite3 *db;		/* the sqlite db holding the virtual table */
+    char *dir_path;		/* the directory containing the photos */
+    int num_threads;		/* max number of parsing threads */
+} VirtualExif;
+typedef VirtualExif *VirtualExifPtr;
+
+typedef struct VirtualExifPhotoStruct
+{
+/* a single photo */
+    char *path;			/* the photo file path */
+    sqlite3_int64 size;		/* the photo file size (-1 if unreadable) */
+    int exif;			/* TRUE if containing a valid EXIF */
+    int gps;			/* TRUE if containing a valid GPS position */
+    double longitude;
+    double latitude;
+} VirtualExifPhoto;
+typedef VirtualExifPhoto *VirtualExifPhotoPtr;
+
+typedef struct VirtualExifCursorStruct
+{
+/* extends the sqlite3_vtab_cursor struct */
+    VirtualExifPtr pVtab;	/* Virtual table of this cursor */
+    int eof;			/* the EOF marker */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    intptr_t hFile;		/* the directory being scanned */
+    struct _finddata_t c_file;
+    int pending;		/* TRUE if c_file is still to be consumed */
+#else
+    DIR *dir;			/* the directory being scanned */
+#endif
+    int dir_eof;		/* TRUE when no more dir-entries are left */
+    VirtualExifPhoto photos[VEXIF_BATCH];	/* the current batch */
+    int count;
+    int current;
+    sqlite3_int64 current_row;	/* the current row ID */
+} VirtualExifCursor;
+typedef VirtualExifCursor *VirtualExifCursorPtr;
+
+struct vexif_parse_pool
+{
+/* a pool of threads concurrently parsing a batch of photos */
+    VirtualExifPhotoPtr photos;
+    int count;
+    int next_photo;
+    splite_mutex_t mutex;
+};
+
+static int
+vexif_is_jpeg_file (const char *filename)
+{
+/* testing if a FileName ends with the expected suffix */
+    int len = strlen (filename);
+    if (len > 4 && strcasecmp (filename + len - 4, ".jpg") == 0)
+	return 1;
+    if (len > 5 && strcasecmp (filename + len - 5, ".jpeg") == 0)
+	return 1;
+    return 0;
+}
+
+static int
+vexif_read (FILE * in, unsigned char **buf, int *buf_size, int length)
+{
+/* reading the leading part of some file into the (growable) buffer */
+    if (length > *buf_size)
+      {
+	  unsigned char *p = realloc (*buf, length);
+	  if (p == NULL)
+	      return 0;
+	  *buf = p;
+	  *buf_size = length;
+      }
+    rewind (in);
+    if ((int) fread (*buf, 1, length, in) != length)
+	return 0;
+    return 1;
+}
+
+static void
+vexif_parse_photo (VirtualExifPhotoPtr photo, unsigned char **buf,
+		   int *buf_size)
+{
+/*
+/ parsing a single photo
+/
+/ only the leading VEXIF_PREFIX bytes will be usually read; the whole
+/ file will be read only when the EXIF metadata extend beyond them
+*/
+    FILE *in;
+    long size;
+    int length;
+    photo->size = -1;
+    photo->exif = 0;
+    photo->gps = 0;
+    in = fopen (photo->path, "rb");
+    if (in == NULL)
+	return;
+    if (fseek (in, 0, SEEK_END) < 0)
+	goto end;
+    size = ftell (in);
+    if (size < 0)
+	goto end;
+    photo->size = size;
+    length = (size > VEXIF_PREFIX) ? VEXIF_PREFIX : (int) size;
+    if (!vexif_read (in, buf, buf_size, length))
+	goto end;
+    if (gaiaScanExifGps
+	(*buf, length, &(photo->exif), &(photo->gps), &(photo->longitude),
+	 &(photo->latitude)))
+	goto end;
+    if (length < size && size <= 0x7fffffff)
+      {
+	  /* the EXIF metadata are truncated: reading the whole file */
+	  length = (int) size;
+	  if (!vexif_read (in, buf, buf_size, length))
+	      goto end;
+	  gaiaScanExifGps (*buf, length, &(photo->exif), &(photo->gps),
+			   &(photo->longitude), &(photo->latitude));
+      }
+  end:
+    fclose (in);
+}
+
+SPLITE_THREAD_PROC (vexif_parse_worker, arg)
+{
+/* a worker thread parsing photos */
+    struct vexif_parse_pool *pool = (struct vexif_parse_pool *) arg;
+    unsigned char *buf = NULL;
+    int buf_size = 0;
+    while (1)
+      {
+	  int i;
+	  splite_mutex_lock (&(pool->mutex));
+	  i = pool->next_photo;
+	  if (i < pool->count)
+	      pool->next_photo += 1;
+	  splite_mutex_unlock (&(pool->mutex));
+	  if (i >= pool->count)
+	      break;
+	  vexif_parse_photo (pool->photos + i, &buf, &buf_size);
+      }
+    if (buf != NULL)
+	free (buf);
+    SPLITE_THREAD_RETURN;
+}
+
+static void
+vexif_parse_batch (VirtualExifPhotoPtr photos, int count, int num_threads)
+{
+/* concurrently parsing a batch of photos */
+    struct vexif_parse_pool pool;
+    splite_thread_t threads[VEXIF_MAX_THREADS];
+    int started = 0;
+    int i;
+    unsigned char *buf = NULL;
+    int buf_size = 0;
+
+    pool.photos = photos;
+    pool.count = count;
+    pool.next_photo = 0;
+    if (num_threads > count)
+	num_threads = count;
+    if (num_threads > 1)
+      {
+	  splite_mutex_init (&(pool.mutex));
+	  while (started < num_threads)
+	    {
+		if (!splite_thread_start
+		    (threads + started, vexif_parse_worker, &pool))
+		    break;
+		started++;
+	    }
+	  for (i = 0; i < started; i++)
+	      splite_thread_join (threads[i]);
+	  splite_mutex_destroy (&(pool.mutex));
+      }
+
+/* parsing in the calling thread any photo left unclaimed */
+    for (i = pool.next_photo; i < count; i++)
+	vexif_parse_photo (photos + i, &buf, &buf_size);
+    if (buf != NULL)
+	free (buf);
+}
+
+static void
+vexif_free_batch (VirtualExifCursorPtr cursor)
+{
+/* releasing the current batch of photos */
+    int i;
+    for (i = 0; i < cursor->count; i++)
+	sqlite3_free (cursor->photos[i].path);
+    cursor->count = 0;
+    cursor->current = 0;
+}
+
+static void
+vexif_close_dir (VirtualExifCursorPtr cursor)
+{
+/* closing the directory being scanned */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    if (cursor->hFile != -1L)
+	_findclose (cursor->hFile);
+    cursor->hFile = -1L;
+#else
+    if (cursor->dir != NULL)
+	closedir (cursor->dir);
+    cursor->dir = NULL;
+#endif
+    cursor->dir_eof = 1;
+}
+
+static int
+vexif_open_dir (VirtualExifCursorPtr cursor)
+{
+/* starting to scan the directory */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    char *pattern = sqlite3_mprintf ("%s/*.*", cursor->pVtab->dir_path);
+    cursor->hFile = _findfirst (pattern, &(cursor->c_file));
+    sqlite3_free (pattern);
+    if (cursor->hFile == -1L)
+	return 0;
+    cursor->pending = 1;
+#else
+    cursor->dir = opendir (cursor->pVtab->dir_path);
+    if (cursor->dir == NULL)
+	return 0;
+#endif
+    cursor->dir_eof = 0;
+    return 1;
+}
+
+static const char *
+vexif_next_entry (VirtualExifCursorPtr cursor)
+{
+/* fetching the next dir-entry name (NULL when exhausted) */
+#if defined(_WIN32) && !defined(__MINGW32__)
+    if (cursor->hFile == -1L)
+	return NULL;
+    if (!(cursor->pending))
+      {
+	  if (_findnext (cursor->hFile, &(cursor->c_file)) != 0)
+	      return NULL;
+      }
+    cursor->pending = 0;
+    if ((cursor->c_file.attrib & _A_SUBDIR) == _A_SUBDIR)
+	return "";
+    return cursor->c_file.name;
+#else
+    struct dirent *entry;
+    if (cursor->dir == NULL)
+	return NULL;
+    entry = readdir (cursor->dir);
+    if (entry == NULL)
+	return NULL;
+    return entry->d_name;
+#endif
+}
+
+static void
+vexif_fill_batch (VirtualExifCursorPtr cursor)
+{
+/* fetching and parsing the next batch of photos */
+    const char *name;
+    vexif_free_batch (cursor);
+    while (!(cursor->dir_eof) && cursor->count < VEXIF_BATCH)
+      {
+	  name = vexif_next_entry (cursor);
+	  if (name == NULL)
+	    {
+		vexif_close_dir (cursor);
+		break;
+	    }
+	  if (!vexif_is_jpeg_file (name))
+	      continue;
+	  cursor->photos[cursor->count].path =
+	      sqlite3_mprintf ("%s/%s", cursor->pVtab->dir_path, name);
+	  cursor->count += 1;
+      }
+    if (cursor->count > 0)
+	vexif_parse_batch (cursor->photos, cursor->count,
+			   cursor->pVtab->num_threads);
+}
+
+static int
+vexif_create (sqlite3 * db, void *pAux, int argc, const char *const *argv,
+	      sqlite3_vtab ** ppVTab, char **pzErr)
+{
+/* creates the virtual table for scanning some directory */
+    VirtualExifPtr p_vt;
+    char *vtable;
+    char *xname;
+    char *sql;
+    const char *pPath;
+    int len;
+    int num_threads = 1;
+    if (pAux)
+	pAux = pAux;		/* unused arg warning suppression */
+    if (argc == 4 || argc == 5)
+      {
+	  pPath = argv[3];
+	  if (argc == 5)
+	      num_threads = atoi (argv[4]);
+      }
+    else
+      {
+	  *pzErr =
+	      sqlite3_mprintf
+	      ("[VirtualExif module] CREATE VIRTUAL: illegal arg list {dir_path [ , num_threads ] }");
+	  return SQLITE_ERROR;
+      }
+    if (num_threads < 1)
+	num_threads = 1;
+    if (num_threads > VEXIF_MAX_THREADS)
+	num_threads = VEXIF_MAX_THREADS;
+    p_vt = (VirtualExifPtr) sqlite3_malloc (sizeof (VirtualExif));
+    if (!p_vt)
+	return SQLITE_NOMEM;
+    p_vt->pModule = &my_exif_module;
+    p_vt->nRef = 0;
+    p_vt->zErrMsg = NULL;
+    p_vt->db = db;
+    p_vt->num_threads = num_threads;
+    len = strlen (pPath);
+    if (len >= 2 && (*(pPath + 0) == '\'' || *(pPath + 0) == '"')
+	&& (*(pPath + len - 1) == '\'' || *(pPath + len - 1) == '"'))
+      {
+	  /* the path is enclosed between quotes - we need to dequote it */
+	  p_vt->dir_path = sqlite3_mprintf ("%.*s", len - 2, pPath + 1);
+      }
+    else
+	p_vt->dir_path = sqlite3_mprintf ("%s", pPath);
+    if (p_vt->dir_path == NULL)
+      {
+	  sqlite3_free (p_vt);
+	  return SQLITE_NOMEM;
+      }
+/* preparing the COLUMNs for this VIRTUAL TABLE */
+    vtable = gaiaDequotedSql ((char *) argv[2]);
+    xname = gaiaDoubleQuotedSql (vtable);
+    free (vtable);
+    sql = sqlite3_mprintf ("CREATE TABLE \"%s\" (PKUID INTEGER, "
+			   "path TEXT, size INTEGER, exif INTEGER, "
+			   "gps INTEGER, longitude DOUBLE, latitude DOUBLE, "
+			   "geometry BLOB)", xname);
+    free (xname);
+    if (sqlite3_declare_vtab (db, sql) != SQLITE_OK)
+      {
+	  *pzErr =
+	      sqlite3_mprintf
+	      ("[VirtualExif module] CREATE VIRTUAL: invalid SQL statement \"%s\"",
+	       sql);
+	  sqlite3_free (sql);
+	  sqlite3_free (p_vt->dir_path);
+	  sqlite3_free (p_vt);
+	  return SQLITE_ERROR;
+      }
+    sqlite3_free (sql);
+    *ppVTab = (sqlite3_vtab *) p_vt;
+    return SQLITE_OK;
+}
+
+static int
+vexif_connect (sqlite3 * db, void *pAux, int argc, const char *const *argv,
+	       sqlite3_vtab ** ppVTab, char **pzErr)
+{
+/* connects the virtual table - simply aliases vexif_create() */
+    return vexif_create (db, pAux, argc, argv, ppVTab, pzErr);
+}
+
+static int
+vexif_best_index (sqlite3_vtab * pVTab, sqlite3_index_info * pIdxInfo)
+{
+/* best index selection: always a full directory scan */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    pIdxInfo->idxNum = 0;
+    pIdxInfo->estimatedCost = 1000000.0;
+    return SQLITE_OK;
+}
+
+static int
+vexif_disconnect (sqlite3_vtab * pVTab)
+{
+/* disconnects the virtual table */
+    VirtualExifPtr p_vt = (VirtualExifPtr) pVTab;
+    sqlite3_free (p_vt->dir_path);
+    sqlite3_free (p_vt);
+    return SQLITE_OK;
+}
+
+static int
+vexif_destroy (sqlite3_vtab * pVTab)
+{
+/* destroys the virtual table - simply aliases vexif_disconnect() */
+    return vexif_disconnect (pVTab);
+}
+
+static int
+vexif_open (sqlite3_vtab * pVTab, sqlite3_vtab_cursor ** ppCursor)
+{
+/* opening a new cursor */
+    VirtualExifCursorPtr cursor =
+	(VirtualExifCursorPtr) sqlite3_malloc (sizeof (VirtualExifCursor));
+    if (cursor == NULL)
+	return SQLITE_ERROR;
+    cursor->pVtab = (VirtualExifPtr) pVTab;
+#if defined(_WIN32) && !defined(__MINGW32__)
+    cursor->hFile = -1L;
+    cursor->pending = 0;
+#else
+    cursor->dir = NULL;
+#endif
+    cursor->dir_eof = 1;
+    cursor->count = 0;
+    cursor->current = 0;
+    cursor->current_row = 0;
+    cursor->eof = 1;
+    *ppCursor = (sqlite3_vtab_cursor *) cursor;
+    return SQLITE_OK;
+}
+
+static int
+vexif_close (sqlite3_vtab_cursor * pCursor)
+{
+/* closing the cursor */
+    VirtualExifCursorPtr cursor = (VirtualExifCursorPtr) pCursor;
+    vexif_free_batch (cursor);
+    vexif_close_dir (cursor);
+    sqlite3_free (pCursor);
+    return SQLITE_OK;
+}
+
+static int
+vexif_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
+	      int argc, sqlite3_value ** argv)
+{
+/* setting up a cursor filter: (re)starting the directory scan */
+    VirtualExifCursorPtr cursor = (VirtualExifCursorPtr) pCursor;
+    if (idxNum || idxStr || argc || argv)
+	idxNum = idxNum;	/* unused arg warning suppression */
+    vexif_free_batch (cursor);
+    vexif_close_dir (cursor);
+    cursor->current_row = 0;
+    cursor->eof = 1;
+    if (!vexif_open_dir (cursor))
+	return SQLITE_OK;
+    vexif_fill_batch (cursor);
+    if (cursor->count > 0)
+      {
+	  cursor->current_row = 1;
+	  cursor->eof = 0;
+      }
+    return SQLITE_OK;
+}
+
+static int
+vexif_next (sqlite3_vtab_cursor * pCursor)
+{
+/* fetching the next row from the cursor */
+    VirtualExifCursorPtr cursor = (VirtualExifCursorPtr) pCursor;
+    cursor->current += 1;
+    cursor->current_row += 1;
+    if (cursor->current < cursor->count)
+	return SQLITE_OK;
+    vexif_fill_batch (cursor);
+    if (cursor->count == 0)
+	cursor->eof = 1;
+    return SQLITE_OK;
+}
+
+static int
+vexif_eof (sqlite3_vtab_cursor * pCursor)
+{
+/* cursor EOF */
+    VirtualExifCursorPtr cursor = (VirtualExifCursorPtr) pCursor;
+    return cursor->eof;
+}
+
+static int
+vexif_column (sqlite3_vtab_cursor * pCursor, sqlite3_context * pContext,
+	      int column)
+{
+/* fetching value for the Nth column */
+    VirtualExifCursorPtr cursor = (VirtualExifCursorPtr) pCursor;
+    VirtualExifPhotoPtr photo = cursor->photos + cursor->current;
+    switch (column)
+      {
+      case 0:
+	  sqlite3_result_int64 (pContext, cursor->current_row);
+	  break;
+      case 1:
+	  sqlite3_result_text (pContext, photo->path, -1, SQLITE_TRANSIENT);
+	  break;
+      case 2:
+	  if (photo->size < 0)
+	      sqlite3_result_null (pContext);
+	  else
+	      sqlite3_result_int64 (pContext, photo->size);
+	  break;
+      case 3:
+	  sqlite3_result_int (pContext, photo->exif);
+	  break;
+      case 4:
+	  sqlite3_result_int (pContext, photo->gps);
+	  break;
+      case 5:
+	  if (photo->gps)
+	      sqlite3_result_double (pContext, photo->longitude);
+	  else
+	      sqlite3_result_null (pContext);
+	  break;
+      case 6:
+	  if (photo->gps)
+	      sqlite3_result_double (pContext, photo->latitude);
+	  else
+	      sqlite3_result_null (pContext);
+	  break;
+      case 7:
+	  if (photo->gps)
+	    {
+		unsigned char *blob;
+		int blob_size;
+		gaiaGeomCollPtr geom = gaiaAllocGeomColl ();
+		geom->Srid = 4326;
+		gaiaAddPointToGeomColl (geom, photo->longitude,
+					photo->latitude);
+		gaiaToSpatiaLiteBlobWkb (geom, &blob, &blob_size);
+		gaiaFreeGeomColl (geom);
+		sqlite3_result_blob (pContext, blob, blob_size, free);
+	    }
+	  else
+	      sqlite3_result_null (pContext);
+	  break;
+      default:
+	  sqlite3_result_null (pContext);
+	  break;
+      };
+    return SQLITE_OK;
+}
+
+static int
+vexif_rowid (sqlite3_vtab_cursor * pCursor, sqlite_int64 * pRowid)
+{
+/* fetching the ROWID */
+    VirtualExifCursorPtr cursor = (VirtualExifCursorPtr) pCursor;
+    *pRowid = cursor->current_row;
+    return SQLITE_OK;
+}
+
+static int
+vexif_update (sqlite3_vtab * pVTab, int argc, sqlite3_value ** argv,
+	      sqlite_int64 * pRowid)
+{
+/* generic update [INSERT / UPDATE / DELETE */
+    if (pVTab || argc || argv || pRowid)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_READONLY;
+}
+
+static int
+vexif_begin (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vexif_sync (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vexif_commit (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vexif_rollback (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vexif_rename (sqlite3_vtab * pVTab, const char *zNew)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    if (zNew)
+	zNew = zNew;		/* unused arg warning suppression */
+    return SQLITE_ERROR;
+}
+
+static int
+spliteVirtualExifInit (sqlite3 * db)
+{
+    int rc = SQLITE_OK;
+    my_exif_module.iVersion = 1;
+    my_exif_module.xCreate = &vexif_create;
+    my_exif_module.xConnect = &vexif_connect;
+    my_exif_module.xBestIndex = &vexif_best_index;
+    my_exif_module.xDisconnect = &vexif_disconnect;
+    my_exif_module.xDestroy = &vexif_destroy;
+    my_exif_module.xOpen = &vexif_open;
+    my_exif_module.xClose = &vexif_close;
+    my_exif_module.xFilter = &vexif_filter;
+    my_exif_module.xNext = &vexif_next;
+    my_exif_module.xEof = &vexif_eof;
+    my_exif_module.xColumn = &vexif_column;
+    my_exif_module.xRowid = &vexif_rowid;
+    my_exif_module.xUpdate = &vexif_update;
+    my_exif_module.xBegin = &vexif_begin;
+    my_exif_module.xSync = &vexif_sync;
+    my_exif_module.xCommit = &vexif_commit;
+    my_exif_module.xRollback = &vexif_rollback;
+    my_exif_module.xFindFunction = NULL;
+    my_exif_module.xRename = &vexif_rename;
+    sqlite3_create_module_v2 (db, "VirtualExif", &my_exif_module, NULL, 0);
+    return rc;
+}
+
+SPATIALITE_PRIVATE int
+virtualexif_extension_init (void *xdb)
+{
+    sqlite3 *db = (sqlite3 *) xdb;
+    return spliteVirtualExifInit (db);
+}
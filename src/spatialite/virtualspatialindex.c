@@ -75,6 +75,20 @@ static struct sqlite3_module my_spidx_module;
 /
 ******************************************************************************/
 
+struct vspidx_stats
+{
+/* cached statistics about a single R*Tree [query planner] */
+    char *table_name;		/* f_table_name as passed to the query */
+    char *geom_column;		/* f_geometry_column (may be NULL) */
+    int valid;			/* statistics successfully collected */
+    sqlite3_int64 changes;	/* total changes when collected */
+    sqlite3_int64 entries;	/* total number of R*Tree entries */
+    int depth;			/* R*Tree depth */
+    int n_cells;		/* number of cells in the root node */
+    double *cells;		/* root cells: xmin, xmax, ymin, ymax */
+    struct vspidx_stats *next;
+};
+
 typedef struct VirtualSpatialIndexStruct
 {
 /* extends the sqlite3_vtab struct */
@@ -82,6 +96,7 @@ typedef struct VirtualSpatialIndexStruct
     int nRef;			/* # references: USED INTERNALLY BY SQLITE */
     char *zErrMsg;		/* error message: USE INTERNALLY BY SQLITE */
     sqlite3 *db;		/* the sqlite db holding the virtual table */
+    struct vspidx_stats *first_stats;	/* cached R*Tree statistics */
 } VirtualSpatialIndex;
 typedef VirtualSpatialIndex *VirtualSpatialIndexPtr;
 
@@ -515,6 +530,42 @@ vspidx_find_rtree (sqlite3 * sqlite, const char *db_prefix,
     return 1;
 }
 
+static int
+vspidx_check_log (sqlite3 * sqlite, const char *db_prefix,
+		  const char *table_name, const char *geom_column)
+{
+/* checks if the RTree is a deferred one (pending entries log) */
+    char *sql_statement;
+    char *log_name;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int exists = 0;
+    char *quoted_db;
+
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    log_name = sqlite3_mprintf ("idxlog_%s_%s", table_name, geom_column);
+    sql_statement =
+	sqlite3_mprintf ("SELECT name FROM \"%s\".sqlite_master "
+			 "WHERE type = 'table' AND Lower(name) = Lower(%Q)",
+			 quoted_db, log_name);
+    free (quoted_db);
+    sqlite3_free (log_name);
+    ret = sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			     NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows >= 1)
+	exists = 1;
+    sqlite3_free_table (results);
+    return exists;
+}
+
 static void
 vspidx_parse_table_name (const char *tn, char **db_prefix, char **table_name)
 {
@@ -550,6 +601,348 @@ vspidx_parse_table_name (const char *tn, char **db_prefix, char **table_name)
     strcpy (*table_name, tn);
 }
 
+static void
+vspidx_free_stats (struct vspidx_stats *stats)
+{
+/* memory cleanup - destroying the R*Tree statistics */
+    if (stats->table_name != NULL)
+	free (stats->table_name);
+    if (stats->geom_column != NULL)
+	free (stats->geom_column);
+    if (stats->cells != NULL)
+	free (stats->cells);
+    free (stats);
+}
+
+#if SQLITE_VERSION_NUMBER >= 3038000	/* constraint values are required */
+
+#define VSPIDX_PROBE_ROWS	4.0	/* expected hits of an unknown frame */
+
+static double
+vspidx_node_coord (const unsigned char *p)
+{
+/* decoding a big-endian 32 bit float from an R*Tree node */
+    union
+    {
+	unsigned int u;
+	float f;
+    } cvt;
+    cvt.u = ((unsigned int) p[0] << 24) | ((unsigned int) p[1] << 16) |
+	((unsigned int) p[2] << 8) | (unsigned int) p[3];
+    return cvt.f;
+}
+
+static int
+vspidx_parse_root (struct vspidx_stats *stats, const unsigned char *blob,
+		   int size)
+{
+/*
+/ parsing the R*Tree root node: a 2 bytes depth and a 2 bytes
+/ cell count, followed by the cells; each cell is a 64 bit ID
+/ followed by four 32 bit floats [xmin, xmax, ymin, ymax]
+*/
+    int i;
+    int n;
+    const unsigned char *p;
+    if (size < 4)
+	return 0;
+    n = (blob[2] << 8) | blob[3];
+    if (4 + (n * 24) > size)
+	return 0;
+    stats->depth = (blob[0] << 8) | blob[1];
+    if (stats->cells != NULL)
+	free (stats->cells);
+    stats->cells = NULL;
+    stats->n_cells = n;
+    if (n == 0)
+	return 1;
+    stats->cells = malloc (sizeof (double) * 4 * n);
+    if (stats->cells == NULL)
+	return 0;
+    for (i = 0; i < n; i++)
+      {
+	  p = blob + 4 + (i * 24) + 8;
+	  stats->cells[(i * 4) + 0] = vspidx_node_coord (p);
+	  stats->cells[(i * 4) + 1] = vspidx_node_coord (p + 4);
+	  stats->cells[(i * 4) + 2] = vspidx_node_coord (p + 8);
+	  stats->cells[(i * 4) + 3] = vspidx_node_coord (p + 12);
+      }
+    return 1;
+}
+
+static int
+vspidx_load_stats (sqlite3 * sqlite, struct vspidx_stats *stats)
+{
+/* collecting statistics about the R*Tree: entry count and root node */
+    char *db_prefix = NULL;
+    char *table_name = NULL;
+    char *xtable = NULL;
+    char *xgeom = NULL;
+    char *quoted_db;
+    char *name;
+    char *quoted;
+    char *sql_statement;
+    sqlite3_stmt *stmt;
+    int exists;
+    int ret;
+    int ok = 0;
+
+    vspidx_parse_table_name (stats->table_name, &db_prefix, &table_name);
+    if (stats->geom_column != NULL)
+	exists =
+	    vspidx_check_rtree (sqlite, db_prefix, table_name,
+				stats->geom_column, &xtable, &xgeom);
+    else
+	exists =
+	    vspidx_find_rtree (sqlite, db_prefix, table_name, &xtable, &xgeom);
+    if (!exists)
+	goto end;
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+
+/* counting the R*Tree entries */
+    name = sqlite3_mprintf ("idx_%s_%s_rowid", xtable, xgeom);
+    quoted = gaiaDoubleQuotedSql (name);
+    sqlite3_free (name);
+    sql_statement =
+	sqlite3_mprintf ("SELECT Count(*) FROM \"%s\".\"%s\"", quoted_db,
+			 quoted);
+    free (quoted);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  free (quoted_db);
+	  goto end;
+      }
+    if (sqlite3_step (stmt) == SQLITE_ROW)
+      {
+	  stats->entries = sqlite3_column_int64 (stmt, 0);
+	  ok = 1;
+      }
+    sqlite3_finalize (stmt);
+
+/* fetching the root node */
+    name = sqlite3_mprintf ("idx_%s_%s_node", xtable, xgeom);
+    quoted = gaiaDoubleQuotedSql (name);
+    sqlite3_free (name);
+    sql_statement =
+	sqlite3_mprintf ("SELECT data FROM \"%s\".\"%s\" WHERE nodeno = 1",
+			 quoted_db, quoted);
+    free (quoted);
+    free (quoted_db);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  ok = 0;
+	  goto end;
+      }
+    if (ok && sqlite3_step (stmt) == SQLITE_ROW
+	&& sqlite3_column_type (stmt, 0) == SQLITE_BLOB)
+	ok = vspidx_parse_root (stats, sqlite3_column_blob (stmt, 0),
+				sqlite3_column_bytes (stmt, 0));
+    else
+	ok = 0;
+    sqlite3_finalize (stmt);
+
+  end:
+    if (db_prefix != NULL)
+	free (db_prefix);
+    if (table_name != NULL)
+	free (table_name);
+    if (xtable != NULL)
+	free (xtable);
+    if (xgeom != NULL)
+	free (xgeom);
+    return ok;
+}
+
+static struct vspidx_stats *
+vspidx_get_stats (VirtualSpatialIndexPtr p_vt, const char *table_name,
+		  const char *geom_column)
+{
+/*
+/ retrieving the cached statistics about some R*Tree; they'll be
+/ refreshed as soon as this connection has changed about 10% of
+/ the entries since the last time they were collected
+*/
+    int changes = sqlite3_total_changes (p_vt->db);
+    sqlite3_int64 delta;
+    struct vspidx_stats *stats = p_vt->first_stats;
+    int len;
+    while (stats != NULL)
+      {
+	  if (strcasecmp (stats->table_name, table_name) == 0)
+	    {
+		if (stats->geom_column == NULL && geom_column == NULL)
+		    break;
+		if (stats->geom_column != NULL && geom_column != NULL
+		    && strcasecmp (stats->geom_column, geom_column) == 0)
+		    break;
+	    }
+	  stats = stats->next;
+      }
+    if (stats == NULL)
+      {
+	  /* inserting a new item into the cache */
+	  stats = malloc (sizeof (struct vspidx_stats));
+	  if (stats == NULL)
+	      return NULL;
+	  len = strlen (table_name);
+	  stats->table_name = malloc (len + 1);
+	  strcpy (stats->table_name, table_name);
+	  stats->geom_column = NULL;
+	  if (geom_column != NULL)
+	    {
+		len = strlen (geom_column);
+		stats->geom_column = malloc (len + 1);
+		strcpy (stats->geom_column, geom_column);
+	    }
+	  stats->valid = 0;
+	  stats->changes = changes;
+	  stats->entries = 0;
+	  stats->depth = 0;
+	  stats->n_cells = 0;
+	  stats->cells = NULL;
+	  stats->next = p_vt->first_stats;
+	  p_vt->first_stats = stats;
+	  stats->valid = vspidx_load_stats (p_vt->db, stats);
+      }
+    else
+      {
+	  delta = (sqlite3_int64) changes - stats->changes;
+	  if (delta < 0)
+	      delta = -delta;
+	  if (delta > (stats->entries / 10) + 100)
+	    {
+		/* the cached statistics are stale */
+		stats->changes = changes;
+		stats->valid = vspidx_load_stats (p_vt->db, stats);
+	    }
+      }
+    if (!stats->valid)
+	return NULL;
+    return stats;
+}
+
+static double
+vspidx_estimate_rows (struct vspidx_stats *stats, int frame_known,
+		      double minx, double miny, double maxx, double maxy)
+{
+/*
+/ estimating how many R*Tree entries will match the search frame
+/
+/ each root cell is assumed to hold an equal share of the entries,
+/ evenly spread over its own MBR; an unknown frame (e.g. the probe
+/ of a spatial join) is assumed to be comparable to an average
+/ entry, thus matching just a few of them
+*/
+    double per_cell;
+    double rows = 0.0;
+    double fx;
+    double fy;
+    double w;
+    double h;
+    int i;
+    int hits = 0;
+    if (stats->entries <= 0 || stats->n_cells <= 0)
+	return 1.0;
+    if (!frame_known)
+	rows = VSPIDX_PROBE_ROWS;
+    else
+      {
+	  per_cell = (double) (stats->entries) / (double) (stats->n_cells);
+	  for (i = 0; i < stats->n_cells; i++)
+	    {
+		double *cell = stats->cells + (i * 4);
+		if (cell[0] > maxx || cell[1] < minx || cell[2] > maxy
+		    || cell[3] < miny)
+		    continue;
+		hits++;
+		w = cell[1] - cell[0];
+		h = cell[3] - cell[2];
+		fx = 1.0;
+		if (w > 0.0)
+		    fx = ((maxx < cell[1] ? maxx : cell[1]) -
+			  (minx > cell[0] ? minx : cell[0])) / w;
+		fy = 1.0;
+		if (h > 0.0)
+		    fy = ((maxy < cell[3] ? maxy : cell[3]) -
+			  (miny > cell[2] ? miny : cell[2])) / h;
+		rows += per_cell * fx * fy;
+	    }
+	  if (hits > 0 && rows < 1.0)
+	      rows = 1.0;
+      }
+    if (rows > (double) (stats->entries))
+	rows = (double) (stats->entries);
+    if (rows < 1.0)
+	rows = 1.0;
+    return rows;
+}
+
+static void
+vspidx_plan_cost (VirtualSpatialIndexPtr p_vt, sqlite3_index_info * pIdxInfo,
+		  int by_rowid)
+{
+/* feeding the query planner with the estimated cost of this query */
+    const char *table_name = NULL;
+    const char *geom_column = NULL;
+    int frame_known = 0;
+    double minx = 0.0;
+    double miny = 0.0;
+    double maxx = 0.0;
+    double maxy = 0.0;
+    double rows;
+    struct vspidx_stats *stats;
+    sqlite3_value *value;
+    int i;
+    for (i = 0; i < pIdxInfo->nConstraint; i++)
+      {
+	  struct sqlite3_index_constraint *p = &(pIdxInfo->aConstraint[i]);
+	  if (!p->usable)
+	      continue;
+	  value = NULL;
+	  if (sqlite3_vtab_rhs_value (pIdxInfo, i, &value) != SQLITE_OK
+	      || value == NULL)
+	      continue;		/* not known before running the query */
+	  if (p->iColumn == 0 && sqlite3_value_type (value) == SQLITE_TEXT)
+	      table_name = (const char *) sqlite3_value_text (value);
+	  if (p->iColumn == 1 && sqlite3_value_type (value) == SQLITE_TEXT)
+	      geom_column = (const char *) sqlite3_value_text (value);
+	  if (p->iColumn == 2 && sqlite3_value_type (value) == SQLITE_BLOB)
+	    {
+		const unsigned char *blob = sqlite3_value_blob (value);
+		unsigned int size = sqlite3_value_bytes (value);
+		if (gaiaGetMbrMinX (blob, size, &minx)
+		    && gaiaGetMbrMinY (blob, size, &miny)
+		    && gaiaGetMbrMaxX (blob, size, &maxx)
+		    && gaiaGetMbrMaxY (blob, size, &maxy))
+		    frame_known = 1;
+	    }
+      }
+    if (table_name == NULL)
+	return;
+    stats = vspidx_get_stats (p_vt, table_name, geom_column);
+    if (stats == NULL)
+	return;
+    rows = vspidx_estimate_rows (stats, frame_known, minx, miny, maxx, maxy);
+    if (by_rowid)
+	rows = 1.0;		/* just checking a single entry */
+/* descending the tree, then visiting the matching entries */
+    pIdxInfo->estimatedCost = (double) (stats->depth + 1) + rows;
+    pIdxInfo->estimatedRows = (sqlite3_int64) rows;
+}
+
+#endif
+
 static int
 vspidx_create (sqlite3 * db, void *pAux, int argc, const char *const *argv,
 	       sqlite3_vtab ** ppVTab, char **pzErr)
@@ -580,6 +973,7 @@ vspidx_create (sqlite3 * db, void *pAux, int argc, const char *const *argv,
     p_vt->pModule = &my_spidx_module;
     p_vt->nRef = 0;
     p_vt->zErrMsg = NULL;
+    p_vt->first_stats = NULL;
 /* preparing the COLUMNs for this VIRTUAL TABLE */
     xname = gaiaDoubleQuotedSql (vtable);
     buf = sqlite3_mprintf ("CREATE TABLE \"%s\" (f_table_name TEXT, "
@@ -618,15 +1012,21 @@ vspidx_best_index (sqlite3_vtab * pVTab, sqlite3_index_info * pIdxInfo)
     int table = 0;
     int geom = 0;
     int mbr = 0;
-    if (pVTab)
-	pVTab = pVTab;		/* unused arg warning suppression */
+    int rowid = -1;
+    VirtualSpatialIndexPtr p_vt = (VirtualSpatialIndexPtr) pVTab;
     for (i = 0; i < pIdxInfo->nConstraint; i++)
       {
 	  /* verifying the constraints */
 	  struct sqlite3_index_constraint *p = &(pIdxInfo->aConstraint[i]);
 	  if (p->usable)
 	    {
-		if (p->iColumn == 0 && p->op == SQLITE_INDEX_CONSTRAINT_EQ)
+		if (p->iColumn < 0)
+		  {
+		      /* ROWID: a further filter, e.g. from a join */
+		      if (p->op == SQLITE_INDEX_CONSTRAINT_EQ && rowid < 0)
+			  rowid = i;
+		  }
+		else if (p->iColumn == 0 && p->op == SQLITE_INDEX_CONSTRAINT_EQ)
 		    table++;
 		else if (p->iColumn == 1 && p->op == SQLITE_INDEX_CONSTRAINT_EQ)
 		    geom++;
@@ -643,14 +1043,38 @@ vspidx_best_index (sqlite3_vtab * pVTab, sqlite3_index_info * pIdxInfo)
 	      pIdxInfo->idxNum = 1;
 	  else
 	      pIdxInfo->idxNum = 2;
+	  if (rowid >= 0)
+	      pIdxInfo->idxNum += 2;
 	  pIdxInfo->estimatedCost = 1.0;
+#if SQLITE_VERSION_NUMBER >= 3038000
+	  vspidx_plan_cost (p_vt, pIdxInfo, rowid >= 0);
+#else
+	  if (p_vt)
+	      p_vt = p_vt;	/* unused arg warning suppression */
+#endif
 	  for (i = 0; i < pIdxInfo->nConstraint; i++)
 	    {
-		if (pIdxInfo->aConstraint[i].usable)
+		/* passing the args as expected by vspidx_filter() */
+		struct sqlite3_index_constraint *p =
+		    &(pIdxInfo->aConstraint[i]);
+		if (!p->usable)
+		    continue;
+		if (p->iColumn < 0)
 		  {
-		      pIdxInfo->aConstraintUsage[i].argvIndex = i + 1;
-		      pIdxInfo->aConstraintUsage[i].omit = 1;
+		      if (i == rowid)
+			{
+			    pIdxInfo->aConstraintUsage[i].argvIndex = 3 + geom;
+			    pIdxInfo->aConstraintUsage[i].omit = 1;
+			}
+		      continue;
 		  }
+		if (p->iColumn == 0)
+		    pIdxInfo->aConstraintUsage[i].argvIndex = 1;
+		else if (p->iColumn == 1)
+		    pIdxInfo->aConstraintUsage[i].argvIndex = 2;
+		else
+		    pIdxInfo->aConstraintUsage[i].argvIndex = 2 + geom;
+		pIdxInfo->aConstraintUsage[i].omit = 1;
 	    }
 	  err = 0;
       }
@@ -667,6 +1091,15 @@ vspidx_disconnect (sqlite3_vtab * pVTab)
 {
 /* disconnects the virtual table */
     VirtualSpatialIndexPtr p_vt = (VirtualSpatialIndexPtr) pVTab;
+    struct vspidx_stats *stats;
+    struct vspidx_stats *stats_n;
+    stats = p_vt->first_stats;
+    while (stats != NULL)
+      {
+	  stats_n = stats->next;
+	  vspidx_free_stats (stats);
+	  stats = stats_n;
+      }
     sqlite3_free (p_vt);
     return SQLITE_OK;
 }
@@ -733,13 +1166,22 @@ vspidx_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
     float maxy;
     double tic;
     double tic2;
+    sqlite3_int64 rowid = 0;
+    int by_rowid = 0;
+    const char *rowid_clause;
     VirtualSpatialIndexCursorPtr cursor =
 	(VirtualSpatialIndexCursorPtr) pCursor;
     VirtualSpatialIndexPtr spidx = (VirtualSpatialIndexPtr) cursor->pVtab;
     if (idxStr)
 	idxStr = idxStr;	/* unused arg warning suppression */
     cursor->eof = 1;
-    if (idxNum == 1 && argc == 3)
+    if (cursor->stmt != NULL)
+      {
+	  /* the cursor is being reused, e.g. by a nested loop join */
+	  sqlite3_finalize (cursor->stmt);
+	  cursor->stmt = NULL;
+      }
+    if ((idxNum == 1 && argc == 3) || (idxNum == 3 && argc == 4))
       {
 	  /* retrieving the Table/Column/MBR params */
 	  if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
@@ -767,7 +1209,7 @@ vspidx_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
 		goto stop;
 	    }
       }
-    if (idxNum == 2 && argc == 2)
+    if ((idxNum == 2 && argc == 2) || (idxNum == 4 && argc == 3))
       {
 	  /* retrieving the Table/MBR params */
 	  if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
@@ -791,6 +1233,33 @@ vspidx_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
 	    }
       }
 
+    if (idxNum == 3 || idxNum == 4)
+      {
+	  /*
+	  / retrieving the ROWID param; the constraint is omitted, so
+	  / it must match exactly as SQLite itself would (ROWID = '5'
+	  / or ROWID = 5.0 both select the row 5)
+	  */
+	  double drowid;
+	  switch (sqlite3_value_numeric_type (argv[argc - 1]))
+	    {
+	    case SQLITE_INTEGER:
+		rowid = sqlite3_value_int64 (argv[argc - 1]);
+		break;
+	    case SQLITE_FLOAT:
+		drowid = sqlite3_value_double (argv[argc - 1]);
+		if (drowid != floor (drowid) || drowid < -9.2e18
+		    || drowid > 9.2e18)
+		    goto stop;	/* no ROWID could ever match */
+		rowid = (sqlite3_int64) drowid;
+		break;
+	    default:
+		/* NULL, BLOB or not numeric TEXT never matches a ROWID */
+		goto stop;
+	    }
+	  by_rowid = 1;
+      }
+
 /* checking if the corresponding R*Tree exists */
     if (ok_geom)
 	exists =
@@ -804,21 +1273,49 @@ vspidx_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
 	goto stop;
 
 /* building the RTree query */
+    rowid_clause = by_rowid ? " AND pkid = ?5" : "";
     idx_name = sqlite3_mprintf ("idx_%s_%s", xtable, xgeom);
     idx_nameQ = gaiaDoubleQuotedSql (idx_name);
-    if (db_prefix == NULL)
+    if (vspidx_check_log (spidx->db, db_prefix, xtable, xgeom))
+      {
+	  /*
+	  / deferred RTree: the pending log entries (the latest one
+	  / for each row) always supersede the RTree own entries
+	  */
+	  char *log_name = sqlite3_mprintf ("idxlog_%s_%s", xtable, xgeom);
+	  char *log_nameQ = gaiaDoubleQuotedSql (log_name);
+	  char *quoted_db;
+	  sqlite3_free (log_name);
+	  if (db_prefix == NULL)
+	      quoted_db = gaiaDoubleQuotedSql ("main");
+	  else
+	      quoted_db = gaiaDoubleQuotedSql (db_prefix);
+	  sql_statement =
+	      sqlite3_mprintf ("SELECT pkid FROM \"%s\".\"%s\" WHERE "
+			       "xmin <= ?1 AND xmax >= ?2 AND ymin <= ?3 AND ymax >= ?4%s "
+			       "AND pkid NOT IN (SELECT pkid FROM \"%s\".\"%s\") "
+			       "UNION ALL SELECT pkid FROM "
+			       "(SELECT pkid, Max(seq), xmin, xmax, ymin, ymax "
+			       "FROM \"%s\".\"%s\" GROUP BY pkid) WHERE "
+			       "xmin <= ?1 AND xmax >= ?2 AND ymin <= ?3 AND ymax >= ?4%s",
+			       quoted_db, idx_nameQ, rowid_clause, quoted_db,
+			       log_nameQ, quoted_db, log_nameQ, rowid_clause);
+	  free (quoted_db);
+	  free (log_nameQ);
+      }
+    else if (db_prefix == NULL)
       {
 	  sql_statement = sqlite3_mprintf ("SELECT pkid FROM \"%s\" WHERE "
-					   "xmin <= ? AND xmax >= ? AND ymin <= ? AND ymax >= ?",
-					   idx_nameQ);
+					   "xmin <= ? AND xmax >= ? AND ymin <= ? AND ymax >= ?%s",
+					   idx_nameQ, rowid_clause);
       }
     else
       {
 	  char *quoted_db = gaiaDoubleQuotedSql (db_prefix);
 	  sql_statement =
 	      sqlite3_mprintf ("SELECT pkid FROM \"%s\".\"%s\" WHERE "
-			       "xmin <= ? AND xmax >= ? AND ymin <= ? AND ymax >= ?",
-			       quoted_db, idx_nameQ);
+			       "xmin <= ? AND xmax >= ? AND ymin <= ? AND ymax >= ?%s",
+			       quoted_db, idx_nameQ, rowid_clause);
 	  free (quoted_db);
       }
     free (idx_nameQ);
@@ -852,6 +1349,8 @@ vspidx_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
     sqlite3_bind_double (stmt, 2, geom->MinX - tic);
     sqlite3_bind_double (stmt, 3, geom->MaxY + tic);
     sqlite3_bind_double (stmt, 4, geom->MinY - tic);
+    if (by_rowid)
+	sqlite3_bind_int64 (stmt, 5, rowid);
     cursor->stmt = stmt;
     cursor->eof = 0;
 /* fetching the first ResultSet's row */
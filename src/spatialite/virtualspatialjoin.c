@@ -0,0 +1,1072 @@
+/*
+
+ virtualspatialjoin.c -- SQLite3 extension [VIRTUAL TABLE Spatial Join]
+
+ version 4.5, 2017 January 16
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2017
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+/*
+
+IMPORTANT NOTE: how SpatialJoin works
+
+a typical Spatial Join is usually written as:
+
+  SELECT a.id, b.id FROM a, b
+  WHERE ST_Intersects(a.geom, b.geom) = 1 AND b.ROWID IN (
+    SELECT ROWID FROM SpatialIndex WHERE f_table_name = 'b'
+    AND search_frame = a.geom)
+
+so that ST_Intersects() will be invoked once for each candidate
+pair, and each time both Geometries will be decoded and converted
+into GEOS Geometries.
+
+the SpatialJoin Virtual Table directly drives the R*Tree of the
+joined table and then evaluates the Spatial Predicate on the whole
+set of candidates at once, by preparing the reference Geometry just
+once (see gaiaGeomCollPreparedPredicateBatch):
+
+  CREATE VIRTUAL TABLE SpatialJoin USING VirtualSpatialJoin();
+
+  SELECT a.id, j.fid FROM a, SpatialJoin AS j
+  WHERE j.f_table_name = 'b' AND j.ref_geometry = a.geom
+
+supported predicates are: Intersects (default), Contains, Within,
+Covers, CoveredBy, Touches, Crosses and Overlaps; all them will
+be evaluated as Predicate(ref_geometry, candidate)
+
+invalid arguments (unsupported predicate, missing Spatial Index,
+non-BLOB reference Geometry ...) will raise an SQL error; a NULL
+ref_geometry simply returns an empty result set
+
+*/
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include "config-msvc.h"
+#else
+#include "config.h"
+#endif
+
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+
+#include <spatialite/sqlite.h>
+
+#include <spatialite/spatialite.h>
+#include <spatialite/gaiaaux.h>
+#include <spatialite/gaiageo.h>
+
+#ifdef _WIN32
+#define strcasecmp	_stricmp
+#define strncasecmp	_strnicmp
+#endif /* not WIN32 */
+
+/* max number of candidates to be evaluated by a single batch */
+#define VSJOIN_BATCH	1024
+
+static struct sqlite3_module my_sjoin_module;
+
+
+/******************************************************************************
+/
+/ VirtualTable structs
+/
+******************************************************************************/
+
+typedef struct VirtualSpatialJoinStruct
+{
+/* extends the sqlite3_vtab struct */
+    const sqlite3_module *pModule;	/* ptr to sqlite module: USED INTERNALLY BY SQLITE */
+    int nRef;			/* # references: USED INTERNALLY BY SQLITE */
+    char *zErrMsg;		/* error message: USE INTERNALLY BY SQLITE */
+    sqlite3 *db;		/* the sqlite db holding the virtual table */
+    const void *p_cache;	/* pointer to the internal cache */
+} VirtualSpatialJoin;
+typedef VirtualSpatialJoin *VirtualSpatialJoinPtr;
+
+typedef struct VirtualSpatialJoinCursorStruct
+{
+/* extends the sqlite3_vtab_cursor struct */
+    VirtualSpatialJoinPtr pVtab;	/* Virtual table of this cursor */
+    int eof;			/* the EOF marker */
+    char *table_name;		/* the current Table Name arg */
+    char *geom_column;		/* the current Geometry Column */
+    unsigned char *blob;	/* the current Reference Geometry */
+    int blob_size;
+    char *predicate;		/* the current Predicate name */
+    sqlite3_int64 *matches;	/* ROWIDs satisfying the Predicate */
+    int count;
+    int max;
+    int current;
+} VirtualSpatialJoinCursor;
+typedef VirtualSpatialJoinCursor *VirtualSpatialJoinCursorPtr;
+
+static int
+vsjoin_find_rtree (sqlite3 * sqlite, const char *db_prefix,
+		   const char *table_name, const char *geom_column,
+		   char **real_table, char **real_geom)
+{
+/* attempts to find the corresponding RTree Geometry Column */
+    sqlite3_stmt *stmt;
+    char *sql_statement;
+    char *quoted_db;
+    int ret;
+    int count = 0;
+    char *rt = NULL;
+    char *rg = NULL;
+
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    if (geom_column == NULL)
+      {
+	  sql_statement =
+	      sqlite3_mprintf
+	      ("SELECT f_table_name, f_geometry_column FROM \"%s\".geometry_columns "
+	       "WHERE Upper(f_table_name) = Upper(%Q) AND spatial_index_enabled = 1",
+	       quoted_db, table_name);
+      }
+    else
+      {
+	  sql_statement =
+	      sqlite3_mprintf
+	      ("SELECT f_table_name, f_geometry_column FROM \"%s\".geometry_columns "
+	       "WHERE Upper(f_table_name) = Upper(%Q) AND "
+	       "Upper(f_geometry_column) = Upper(%Q) AND spatial_index_enabled = 1",
+	       quoted_db, table_name, geom_column);
+      }
+    free (quoted_db);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		const char *v = (const char *) sqlite3_column_text (stmt, 0);
+		int len = sqlite3_column_bytes (stmt, 0);
+		if (rt)
+		    free (rt);
+		rt = malloc (len + 1);
+		strcpy (rt, v);
+		v = (const char *) sqlite3_column_text (stmt, 1);
+		len = sqlite3_column_bytes (stmt, 1);
+		if (rg)
+		    free (rg);
+		rg = malloc (len + 1);
+		strcpy (rg, v);
+		count++;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (count != 1)
+      {
+	  if (rg != NULL)
+	      free (rg);
+	  if (rt != NULL)
+	      free (rt);
+	  return 0;
+      }
+    *real_table = rt;
+    *real_geom = rg;
+    return 1;
+}
+
+static void
+vsjoin_parse_table_name (const char *tn, char **db_prefix, char **table_name)
+{
+/* attempting to extract an eventual DB prefix */
+    int i;
+    int len = strlen (tn);
+    int i_dot = -1;
+    if (strncasecmp (tn, "DB=", 3) == 0)
+      {
+	  int l_db;
+	  int l_tbl;
+	  for (i = 3; i < len; i++)
+	    {
+		if (tn[i] == '.')
+		  {
+		      i_dot = i;
+		      break;
+		  }
+	    }
+	  if (i_dot > 1)
+	    {
+		l_db = i_dot - 3;
+		l_tbl = len - (i_dot + 1);
+		*db_prefix = malloc (l_db + 1);
+		memset (*db_prefix, '\0', l_db + 1);
+		memcpy (*db_prefix, tn + 3, l_db);
+		*table_name = malloc (l_tbl + 1);
+		strcpy (*table_name, tn + i_dot + 1);
+		return;
+	    }
+      }
+    *table_name = malloc (len + 1);
+    strcpy (*table_name, tn);
+}
+
+static int
+vsjoin_parse_predicate (const char *name)
+{
+/* identifying the requested Spatial Predicate */
+    if (strcasecmp (name, "Intersects") == 0
+	|| strcasecmp (name, "ST_Intersects") == 0)
+	return GAIA_PREDICATE_INTERSECTS;
+    if (strcasecmp (name, "Contains") == 0
+	|| strcasecmp (name, "ST_Contains") == 0)
+	return GAIA_PREDICATE_CONTAINS;
+    if (strcasecmp (name, "Within") == 0
+	|| strcasecmp (name, "ST_Within") == 0)
+	return GAIA_PREDICATE_WITHIN;
+    if (strcasecmp (name, "Covers") == 0
+	|| strcasecmp (name, "ST_Covers") == 0)
+	return GAIA_PREDICATE_COVERS;
+    if (strcasecmp (name, "CoveredBy") == 0
+	|| strcasecmp (name, "ST_CoveredBy") == 0)
+	return GAIA_PREDICATE_COVEREDBY;
+    if (strcasecmp (name, "Touches") == 0
+	|| strcasecmp (name, "ST_Touches") == 0)
+	return GAIA_PREDICATE_TOUCHES;
+    if (strcasecmp (name, "Crosses") == 0
+	|| strcasecmp (name, "ST_Crosses") == 0)
+	return GAIA_PREDICATE_CROSSES;
+    if (strcasecmp (name, "Overlaps") == 0
+	|| strcasecmp (name, "ST_Overlaps") == 0)
+	return GAIA_PREDICATE_OVERLAPS;
+    return 0;
+}
+
+static int
+vsjoin_eval_legacy (int predicate, gaiaGeomCollPtr reference,
+		    gaiaGeomCollPtr * candidates, int count, int *results)
+{
+/* evaluating the Predicate without a connection cache (legacy mode) */
+    int i;
+    for (i = 0; i < count; i++)
+      {
+	  gaiaGeomCollPtr geom = *(candidates + i);
+	  int ret;
+	  if (geom == NULL)
+	    {
+		*(results + i) = -1;
+		continue;
+	    }
+	  switch (predicate)
+	    {
+	    case GAIA_PREDICATE_CONTAINS:
+		ret = gaiaGeomCollContains (reference, geom);
+		break;
+	    case GAIA_PREDICATE_WITHIN:
+		ret = gaiaGeomCollWithin (reference, geom);
+		break;
+	    case GAIA_PREDICATE_COVERS:
+		ret = gaiaGeomCollCovers (reference, geom);
+		break;
+	    case GAIA_PREDICATE_COVEREDBY:
+		ret = gaiaGeomCollCoveredBy (reference, geom);
+		break;
+	    case GAIA_PREDICATE_TOUCHES:
+		ret = gaiaGeomCollTouches (reference, geom);
+		break;
+	    case GAIA_PREDICATE_CROSSES:
+		ret = gaiaGeomCollCrosses (reference, geom);
+		break;
+	    case GAIA_PREDICATE_OVERLAPS:
+		ret = gaiaGeomCollOverlaps (reference, geom);
+		break;
+	    default:
+		ret = gaiaGeomCollIntersects (reference, geom);
+		break;
+	    }
+	  *(results + i) = ret;
+      }
+    return 1;
+}
+
+static void
+vsjoin_add_match (VirtualSpatialJoinCursorPtr cursor, sqlite3_int64 rowid)
+{
+/* appending a matching ROWID */
+    if (cursor->count >= cursor->max)
+      {
+	  cursor->max += VSJOIN_BATCH;
+	  cursor->matches =
+	      realloc (cursor->matches, sizeof (sqlite3_int64) * cursor->max);
+      }
+    *(cursor->matches + cursor->count) = rowid;
+    cursor->count += 1;
+}
+
+static void
+vsjoin_eval_batch (VirtualSpatialJoinCursorPtr cursor, int predicate,
+		   gaiaGeomCollPtr reference, sqlite3_int64 * rowids,
+		   gaiaGeomCollPtr * candidates, int *results, int count)
+{
+/* evaluating a batch of candidates and then releasing them */
+    int i;
+    int ret;
+    if (cursor->pVtab->p_cache != NULL)
+	ret =
+	    gaiaGeomCollPreparedPredicateBatch (cursor->pVtab->p_cache,
+						predicate, reference,
+						candidates, count, results);
+    else
+	ret =
+	    vsjoin_eval_legacy (predicate, reference, candidates, count,
+				results);
+    for (i = 0; i < count; i++)
+      {
+	  if (ret && *(results + i) == 1)
+	      vsjoin_add_match (cursor, *(rowids + i));
+	  if (*(candidates + i) != NULL)
+	      gaiaFreeGeomColl (*(candidates + i));
+	  *(candidates + i) = NULL;
+      }
+}
+
+static void
+vsjoin_set_error (VirtualSpatialJoinCursorPtr cursor, char *msg)
+{
+/* reporting an error message back to SQLite */
+    VirtualSpatialJoinPtr p_vt = cursor->pVtab;
+    if (p_vt->zErrMsg != NULL)
+	sqlite3_free (p_vt->zErrMsg);
+    p_vt->zErrMsg = msg;
+}
+
+static void
+vsjoin_reset_args (VirtualSpatialJoinCursorPtr cursor)
+{
+/* releasing the args of the previous filter */
+    if (cursor->table_name != NULL)
+	free (cursor->table_name);
+    if (cursor->geom_column != NULL)
+	free (cursor->geom_column);
+    if (cursor->blob != NULL)
+	free (cursor->blob);
+    if (cursor->predicate != NULL)
+	free (cursor->predicate);
+    cursor->table_name = NULL;
+    cursor->geom_column = NULL;
+    cursor->blob = NULL;
+    cursor->blob_size = 0;
+    cursor->predicate = NULL;
+}
+
+static char *
+vsjoin_strdup (const char *str)
+{
+/* duplicating a text string */
+    int len = strlen (str);
+    char *dup = malloc (len + 1);
+    strcpy (dup, str);
+    return dup;
+}
+
+static int
+vsjoin_create (sqlite3 * db, void *pAux, int argc, const char *const *argv,
+	       sqlite3_vtab ** ppVTab, char **pzErr)
+{
+/* creates the virtual table for Spatial Join metahandling */
+    VirtualSpatialJoinPtr p_vt;
+    char *buf;
+    char *vtable;
+    char *xname;
+    if (argc == 3)
+      {
+	  vtable = gaiaDequotedSql ((char *) argv[2]);
+      }
+    else
+      {
+	  *pzErr =
+	      sqlite3_mprintf
+	      ("[VirtualSpatialJoin module] CREATE VIRTUAL: illegal arg list {void}\n");
+	  return SQLITE_ERROR;
+      }
+    p_vt = (VirtualSpatialJoinPtr) sqlite3_malloc (sizeof (VirtualSpatialJoin));
+    if (!p_vt)
+	return SQLITE_NOMEM;
+    p_vt->db = db;
+    p_vt->p_cache = pAux;
+    p_vt->pModule = &my_sjoin_module;
+    p_vt->nRef = 0;
+    p_vt->zErrMsg = NULL;
+/* preparing the COLUMNs for this VIRTUAL TABLE */
+    xname = gaiaDoubleQuotedSql (vtable);
+    buf = sqlite3_mprintf ("CREATE TABLE \"%s\" (f_table_name TEXT, "
+			   "f_geometry_column TEXT, ref_geometry BLOB, "
+			   "predicate TEXT, fid INTEGER)", xname);
+    free (xname);
+    free (vtable);
+    if (sqlite3_declare_vtab (db, buf) != SQLITE_OK)
+      {
+	  sqlite3_free (buf);
+	  *pzErr =
+	      sqlite3_mprintf
+	      ("[VirtualSpatialJoin module] CREATE VIRTUAL: invalid SQL statement \"%s\"",
+	       buf);
+	  return SQLITE_ERROR;
+      }
+    sqlite3_free (buf);
+    *ppVTab = (sqlite3_vtab *) p_vt;
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_connect (sqlite3 * db, void *pAux, int argc, const char *const *argv,
+		sqlite3_vtab ** ppVTab, char **pzErr)
+{
+/* connects the virtual table - simply aliases vsjoin_create() */
+    return vsjoin_create (db, pAux, argc, argv, ppVTab, pzErr);
+}
+
+static int
+vsjoin_best_index (sqlite3_vtab * pVTab, sqlite3_index_info * pIdxInfo)
+{
+/*
+/ best index selection
+/
+/ idxNum is a bitmask: 1 = f_geometry_column, 2 = predicate
+/ the args will always be passed in this order: f_table_name,
+/ [f_geometry_column], ref_geometry, [predicate]
+*/
+    int i;
+    int table = -1;
+    int geom = -1;
+    int ref = -1;
+    int pred = -1;
+    int errors = 0;
+    int arg = 1;
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    for (i = 0; i < pIdxInfo->nConstraint; i++)
+      {
+	  /* verifying the constraints */
+	  struct sqlite3_index_constraint *p = &(pIdxInfo->aConstraint[i]);
+	  if (!p->usable || p->op != SQLITE_INDEX_CONSTRAINT_EQ)
+	      continue;
+	  if (p->iColumn == 0)
+	    {
+		if (table >= 0)
+		    errors++;
+		table = i;
+	    }
+	  else if (p->iColumn == 1)
+	    {
+		if (geom >= 0)
+		    errors++;
+		geom = i;
+	    }
+	  else if (p->iColumn == 2)
+	    {
+		if (ref >= 0)
+		    errors++;
+		ref = i;
+	    }
+	  else if (p->iColumn == 3)
+	    {
+		if (pred >= 0)
+		    errors++;
+		pred = i;
+	    }
+      }
+    if (table < 0 || ref < 0 || errors)
+      {
+	  /* illegal query */
+	  pIdxInfo->idxNum = 0;
+	  pIdxInfo->estimatedCost = 1.0e12;
+	  return SQLITE_OK;
+      }
+
+/* this one is a valid SpatialJoin query */
+    pIdxInfo->idxNum = 0;
+    pIdxInfo->aConstraintUsage[table].argvIndex = arg++;
+    pIdxInfo->aConstraintUsage[table].omit = 1;
+    if (geom >= 0)
+      {
+	  pIdxInfo->idxNum |= 1;
+	  pIdxInfo->aConstraintUsage[geom].argvIndex = arg++;
+	  pIdxInfo->aConstraintUsage[geom].omit = 1;
+      }
+    pIdxInfo->aConstraintUsage[ref].argvIndex = arg++;
+    pIdxInfo->aConstraintUsage[ref].omit = 1;
+    if (pred >= 0)
+      {
+	  pIdxInfo->idxNum |= 2;
+	  pIdxInfo->aConstraintUsage[pred].argvIndex = arg++;
+	  pIdxInfo->aConstraintUsage[pred].omit = 1;
+      }
+    pIdxInfo->idxNum |= 4;	/* marking a valid query */
+    pIdxInfo->estimatedCost = 1.0;
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_disconnect (sqlite3_vtab * pVTab)
+{
+/* disconnects the virtual table */
+    VirtualSpatialJoinPtr p_vt = (VirtualSpatialJoinPtr) pVTab;
+    sqlite3_free (p_vt);
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_destroy (sqlite3_vtab * pVTab)
+{
+/* destroys the virtual table - simply aliases vsjoin_disconnect() */
+    return vsjoin_disconnect (pVTab);
+}
+
+static int
+vsjoin_open (sqlite3_vtab * pVTab, sqlite3_vtab_cursor ** ppCursor)
+{
+/* opening a new cursor */
+    VirtualSpatialJoinCursorPtr cursor =
+	(VirtualSpatialJoinCursorPtr)
+	sqlite3_malloc (sizeof (VirtualSpatialJoinCursor));
+    if (cursor == NULL)
+	return SQLITE_ERROR;
+    cursor->pVtab = (VirtualSpatialJoinPtr) pVTab;
+    cursor->eof = 1;
+    cursor->table_name = NULL;
+    cursor->geom_column = NULL;
+    cursor->blob = NULL;
+    cursor->blob_size = 0;
+    cursor->predicate = NULL;
+    cursor->matches = NULL;
+    cursor->count = 0;
+    cursor->max = 0;
+    cursor->current = 0;
+    *ppCursor = (sqlite3_vtab_cursor *) cursor;
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_close (sqlite3_vtab_cursor * pCursor)
+{
+/* closing the cursor */
+    VirtualSpatialJoinCursorPtr cursor = (VirtualSpatialJoinCursorPtr) pCursor;
+    vsjoin_reset_args (cursor);
+    if (cursor->matches != NULL)
+	free (cursor->matches);
+    sqlite3_free (pCursor);
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_filter (sqlite3_vtab_cursor * pCursor, int idxNum, const char *idxStr,
+	       int argc, sqlite3_value ** argv)
+{
+/* setting up a cursor filter */
+    char *db_prefix = NULL;
+    char *table_name = NULL;
+    const char *geom_column = NULL;
+    char *xtable = NULL;
+    char *xgeom = NULL;
+    char *idx_name;
+    char *idx_nameQ;
+    char *quoted_db;
+    char *quoted_table;
+    char *quoted_geom;
+    char *sql_statement;
+    gaiaGeomCollPtr geom = NULL;
+    int predicate = GAIA_PREDICATE_INTERSECTS;
+    const char *pred_name = "Intersects";
+    const unsigned char *blob;
+    int size;
+    int ret;
+    int arg = 0;
+    int n_batch = 0;
+    int rc = SQLITE_OK;
+    sqlite3_stmt *stmt_rtree = NULL;
+    sqlite3_stmt *stmt_geom = NULL;
+    sqlite3_int64 *rowids = NULL;
+    gaiaGeomCollPtr *candidates = NULL;
+    int *results = NULL;
+    float minx;
+    float miny;
+    float maxx;
+    float maxy;
+    double tic;
+    double tic2;
+    VirtualSpatialJoinCursorPtr cursor = (VirtualSpatialJoinCursorPtr) pCursor;
+    VirtualSpatialJoinPtr sjoin = (VirtualSpatialJoinPtr) cursor->pVtab;
+    if (idxStr)
+	idxStr = idxStr;	/* unused arg warning suppression */
+    cursor->eof = 1;
+    cursor->count = 0;
+    cursor->current = 0;
+    vsjoin_reset_args (cursor);
+    if ((idxNum & 4) == 0)
+	goto stop;		/* not a SpatialJoin query: empty result */
+
+/* retrieving the Table/[Column]/Geometry/[Predicate] params */
+    if (arg >= argc || sqlite3_value_type (argv[arg]) != SQLITE_TEXT)
+      {
+	  vsjoin_set_error (cursor,
+			    sqlite3_mprintf
+			    ("[VirtualSpatialJoin module] f_table_name: expected a TEXT value"));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    cursor->table_name =
+	vsjoin_strdup ((const char *) sqlite3_value_text (argv[arg]));
+    vsjoin_parse_table_name (cursor->table_name, &db_prefix, &table_name);
+    arg++;
+    if (idxNum & 1)
+      {
+	  if (arg >= argc || sqlite3_value_type (argv[arg]) != SQLITE_TEXT)
+	    {
+		vsjoin_set_error (cursor,
+				  sqlite3_mprintf
+				  ("[VirtualSpatialJoin module] f_geometry_column: expected a TEXT value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  geom_column = (const char *) sqlite3_value_text (argv[arg]);
+	  arg++;
+      }
+    if (arg >= argc)
+      {
+	  vsjoin_set_error (cursor,
+			    sqlite3_mprintf
+			    ("[VirtualSpatialJoin module] missing ref_geometry"));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    if (sqlite3_value_type (argv[arg]) == SQLITE_NULL)
+	goto stop;		/* NULL reference: empty result */
+    if (sqlite3_value_type (argv[arg]) != SQLITE_BLOB)
+      {
+	  vsjoin_set_error (cursor,
+			    sqlite3_mprintf
+			    ("[VirtualSpatialJoin module] ref_geometry: expected a BLOB value"));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    blob = sqlite3_value_blob (argv[arg]);
+    size = sqlite3_value_bytes (argv[arg]);
+    geom = gaiaFromSpatiaLiteBlobWkb (blob, size);
+    if (geom == NULL)
+      {
+	  vsjoin_set_error (cursor,
+			    sqlite3_mprintf
+			    ("[VirtualSpatialJoin module] ref_geometry: invalid Geometry"));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    cursor->blob = malloc (size);
+    memcpy (cursor->blob, blob, size);
+    cursor->blob_size = size;
+    arg++;
+    if (idxNum & 2)
+      {
+	  if (arg >= argc || sqlite3_value_type (argv[arg]) != SQLITE_TEXT)
+	    {
+		vsjoin_set_error (cursor,
+				  sqlite3_mprintf
+				  ("[VirtualSpatialJoin module] predicate: expected a TEXT value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  pred_name = (const char *) sqlite3_value_text (argv[arg]);
+	  predicate = vsjoin_parse_predicate (pred_name);
+	  if (!predicate)
+	    {
+		vsjoin_set_error (cursor,
+				  sqlite3_mprintf
+				  ("[VirtualSpatialJoin module] unsupported predicate \"%s\"",
+				   pred_name));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  arg++;
+      }
+    cursor->predicate = vsjoin_strdup (pred_name);
+
+/* checking if the corresponding R*Tree exists */
+    if (!vsjoin_find_rtree
+	(sjoin->db, db_prefix, table_name, geom_column, &xtable, &xgeom))
+      {
+	  if (geom_column == NULL)
+	      vsjoin_set_error (cursor,
+				sqlite3_mprintf
+				("[VirtualSpatialJoin module] \"%s\" has no (unique) Geometry supported by a Spatial Index",
+				 table_name));
+	  else
+	      vsjoin_set_error (cursor,
+				sqlite3_mprintf
+				("[VirtualSpatialJoin module] \"%s\".\"%s\" is not supported by a Spatial Index",
+				 table_name, geom_column));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    cursor->geom_column = vsjoin_strdup (xgeom);
+
+/* building the RTree query */
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    idx_name = sqlite3_mprintf ("idx_%s_%s", xtable, xgeom);
+    idx_nameQ = gaiaDoubleQuotedSql (idx_name);
+    sqlite3_free (idx_name);
+    sql_statement = sqlite3_mprintf ("SELECT pkid FROM \"%s\".\"%s\" WHERE "
+				     "xmin <= ? AND xmax >= ? AND ymin <= ? AND ymax >= ?",
+				     quoted_db, idx_nameQ);
+    free (idx_nameQ);
+    ret =
+	sqlite3_prepare_v2 (sjoin->db, sql_statement, strlen (sql_statement),
+			    &stmt_rtree, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  free (quoted_db);
+	  vsjoin_set_error (cursor,
+			    sqlite3_mprintf
+			    ("[VirtualSpatialJoin module] R*Tree query: %s",
+			     sqlite3_errmsg (sjoin->db)));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+
+/* building the candidates query */
+    quoted_table = gaiaDoubleQuotedSql (xtable);
+    quoted_geom = gaiaDoubleQuotedSql (xgeom);
+    sql_statement =
+	sqlite3_mprintf ("SELECT \"%s\" FROM \"%s\".\"%s\" WHERE ROWID = ?",
+			 quoted_geom, quoted_db, quoted_table);
+    free (quoted_db);
+    free (quoted_table);
+    free (quoted_geom);
+    ret =
+	sqlite3_prepare_v2 (sjoin->db, sql_statement, strlen (sql_statement),
+			    &stmt_geom, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  vsjoin_set_error (cursor,
+			    sqlite3_mprintf
+			    ("[VirtualSpatialJoin module] candidates query: %s",
+			     sqlite3_errmsg (sjoin->db)));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+
+/* adjusting the MBR so to compensate for DOUBLE/FLOAT truncations */
+    minx = (float) (geom->MinX);
+    miny = (float) (geom->MinY);
+    maxx = (float) (geom->MaxX);
+    maxy = (float) (geom->MaxY);
+    tic = fabs (geom->MinX - minx);
+    tic2 = fabs (geom->MinY - miny);
+    if (tic2 > tic)
+	tic = tic2;
+    tic2 = fabs (geom->MaxX - maxx);
+    if (tic2 > tic)
+	tic = tic2;
+    tic2 = fabs (geom->MaxY - maxy);
+    if (tic2 > tic)
+	tic = tic2;
+    tic *= 2.0;
+    sqlite3_bind_double (stmt_rtree, 1, geom->MaxX + tic);
+    sqlite3_bind_double (stmt_rtree, 2, geom->MinX - tic);
+    sqlite3_bind_double (stmt_rtree, 3, geom->MaxY + tic);
+    sqlite3_bind_double (stmt_rtree, 4, geom->MinY - tic);
+
+/* collecting the candidates, and evaluating them batch by batch */
+    rowids = malloc (sizeof (sqlite3_int64) * VSJOIN_BATCH);
+    candidates = malloc (sizeof (gaiaGeomCollPtr) * VSJOIN_BATCH);
+    results = malloc (sizeof (int) * VSJOIN_BATCH);
+    while (1)
+      {
+	  /* scrolling the R*Tree result set rows */
+	  ret = sqlite3_step (stmt_rtree);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	    {
+		vsjoin_set_error (cursor,
+				  sqlite3_mprintf
+				  ("[VirtualSpatialJoin module] R*Tree step: %s",
+				   sqlite3_errmsg (sjoin->db)));
+		rc = SQLITE_ERROR;
+		cursor->count = 0;
+		goto stop;
+	    }
+	  *(rowids + n_batch) = sqlite3_column_int64 (stmt_rtree, 0);
+	  *(candidates + n_batch) = NULL;
+	  sqlite3_reset (stmt_geom);
+	  sqlite3_clear_bindings (stmt_geom);
+	  sqlite3_bind_int64 (stmt_geom, 1, *(rowids + n_batch));
+	  ret = sqlite3_step (stmt_geom);
+	  if (ret == SQLITE_ROW
+	      && sqlite3_column_type (stmt_geom, 0) == SQLITE_BLOB)
+	    {
+		blob = sqlite3_column_blob (stmt_geom, 0);
+		size = sqlite3_column_bytes (stmt_geom, 0);
+		*(candidates + n_batch) = gaiaFromSpatiaLiteBlobWkb (blob, size);
+	    }
+	  n_batch++;
+	  if (n_batch == VSJOIN_BATCH)
+	    {
+		vsjoin_eval_batch (cursor, predicate, geom, rowids,
+				   candidates, results, n_batch);
+		n_batch = 0;
+	    }
+      }
+    if (n_batch > 0)
+	vsjoin_eval_batch (cursor, predicate, geom, rowids, candidates,
+			   results, n_batch);
+    n_batch = 0;
+    if (cursor->count > 0)
+	cursor->eof = 0;
+
+  stop:
+    if (candidates != NULL)
+      {
+	  int i;
+	  for (i = 0; i < n_batch; i++)
+	    {
+		if (*(candidates + i) != NULL)
+		    gaiaFreeGeomColl (*(candidates + i));
+	    }
+	  free (candidates);
+      }
+    if (rowids != NULL)
+	free (rowids);
+    if (results != NULL)
+	free (results);
+    if (stmt_rtree != NULL)
+	sqlite3_finalize (stmt_rtree);
+    if (stmt_geom != NULL)
+	sqlite3_finalize (stmt_geom);
+    if (geom)
+	gaiaFreeGeomColl (geom);
+    if (xtable)
+	free (xtable);
+    if (xgeom)
+	free (xgeom);
+    if (db_prefix)
+	free (db_prefix);
+    if (table_name)
+	free (table_name);
+    return rc;
+}
+
+static int
+vsjoin_next (sqlite3_vtab_cursor * pCursor)
+{
+/* fetching a next row from cursor */
+    VirtualSpatialJoinCursorPtr cursor = (VirtualSpatialJoinCursorPtr) pCursor;
+    cursor->current += 1;
+    if (cursor->current >= cursor->count)
+	cursor->eof = 1;
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_eof (sqlite3_vtab_cursor * pCursor)
+{
+/* cursor EOF */
+    VirtualSpatialJoinCursorPtr cursor = (VirtualSpatialJoinCursorPtr) pCursor;
+    return cursor->eof;
+}
+
+static int
+vsjoin_column (sqlite3_vtab_cursor * pCursor, sqlite3_context * pContext,
+	       int column)
+{
+/* fetching value for the Nth column */
+    VirtualSpatialJoinCursorPtr cursor = (VirtualSpatialJoinCursorPtr) pCursor;
+    if (column == 0 && cursor->table_name != NULL)
+      {
+	  /* the Table Name column */
+	  sqlite3_result_text (pContext, cursor->table_name,
+			       strlen (cursor->table_name), SQLITE_STATIC);
+      }
+    else if (column == 1 && cursor->geom_column != NULL)
+      {
+	  /* the GeometryColumn Name column */
+	  sqlite3_result_text (pContext, cursor->geom_column,
+			       strlen (cursor->geom_column), SQLITE_STATIC);
+      }
+    else if (column == 2 && cursor->blob != NULL)
+      {
+	  /* the Reference Geometry column */
+	  sqlite3_result_blob (pContext, cursor->blob, cursor->blob_size,
+			       SQLITE_STATIC);
+      }
+    else if (column == 3 && cursor->predicate != NULL)
+      {
+	  /* the Predicate column */
+	  sqlite3_result_text (pContext, cursor->predicate,
+			       strlen (cursor->predicate), SQLITE_STATIC);
+      }
+    else if (column == 4)
+      {
+	  /* the "fid" column */
+	  sqlite3_result_int64 (pContext,
+				*(cursor->matches + cursor->current));
+      }
+    else
+	sqlite3_result_null (pContext);
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_rowid (sqlite3_vtab_cursor * pCursor, sqlite_int64 * pRowid)
+{
+/* fetching the ROWID */
+    VirtualSpatialJoinCursorPtr cursor = (VirtualSpatialJoinCursorPtr) pCursor;
+    *pRowid = *(cursor->matches + cursor->current);
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_update (sqlite3_vtab * pVTab, int argc, sqlite3_value ** argv,
+	       sqlite_int64 * pRowid)
+{
+/* generic update [INSERT / UPDATE / DELETE */
+    if (pRowid || argc || argv || pVTab)
+	pRowid = pRowid;	/* unused arg warning suppression */
+/* read only datasource */
+    return SQLITE_READONLY;
+}
+
+static int
+vsjoin_begin (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_sync (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_commit (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_rollback (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vsjoin_rename (sqlite3_vtab * pVTab, const char *zNew)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    if (zNew)
+	zNew = zNew;		/* unused arg warning suppression */
+    return SQLITE_ERROR;
+}
+
+static int
+spliteVirtualSpatialJoinInit (sqlite3 * db, void *p_cache)
+{
+    int rc = SQLITE_OK;
+    my_sjoin_module.iVersion = 1;
+    my_sjoin_module.xCreate = &vsjoin_create;
+    my_sjoin_module.xConnect = &vsjoin_connect;
+    my_sjoin_module.xBestIndex = &vsjoin_best_index;
+    my_sjoin_module.xDisconnect = &vsjoin_disconnect;
+    my_sjoin_module.xDestroy = &vsjoin_destroy;
+    my_sjoin_module.xOpen = &vsjoin_open;
+    my_sjoin_module.xClose = &vsjoin_close;
+    my_sjoin_module.xFilter = &vsjoin_filter;
+    my_sjoin_module.xNext = &vsjoin_next;
+    my_sjoin_module.xEof = &vsjoin_eof;
+    my_sjoin_module.xColumn = &vsjoin_column;
+    my_sjoin_module.xRowid = &vsjoin_rowid;
+    my_sjoin_module.xUpdate = &vsjoin_update;
+    my_sjoin_module.xBegin = &vsjoin_begin;
+    my_sjoin_module.xSync = &vsjoin_sync;
+    my_sjoin_module.xCommit = &vsjoin_commit;
+    my_sjoin_module.xRollback = &vsjoin_rollback;
+    my_sjoin_module.xFindFunction = NULL;
+    my_sjoin_module.xRename = &vsjoin_rename;
+    sqlite3_create_module_v2 (db, "VirtualSpatialJoin", &my_sjoin_module,
+			      p_cache, 0);
+    return rc;
+}
+
+SPATIALITE_PRIVATE int
+virtual_spatialjoin_extension_init (void *xdb, const void *p_cache)
+{
+    sqlite3 *db = (sqlite3 *) xdb;
+    return spliteVirtualSpatialJoinInit (db, (void *) p_cache);
+}
+
+#endif /* end GEOS conditional */
@@ -0,0 +1,1160 @@
+/*
+
+ virtualzonemap.c -- SQLite3 extension [VIRTUAL TABLE ZoneMap]
+
+ version 4.5, 2017 January 16
+
+ Author: Sandro Furieri a.furieri@lqt.it
+
+ -----------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2017
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+
+/*
+
+IMPORTANT NOTE: how ZoneMap works
+
+a ZoneMap created by CreateZoneMap() summarizes every block of
+consecutive ROWIDs by the union of their MBRs and (optionally)
+by the min/max Values of some attributes.
+
+the ZoneMap Virtual Table returns the ROWIDs of all rows belonging
+to the blocks that could satisfy the search conditions, in the same
+way as the SpatialIndex Virtual Table does for R*Trees:
+
+  CREATE VIRTUAL TABLE ZoneMap USING VirtualZoneMap();
+
+  SELECT * FROM t WHERE ROWID IN (
+    SELECT ROWID FROM ZoneMap WHERE f_table_name = 't'
+    AND search_frame = BuildMbr(10, 10, 20, 20))
+  AND MbrIntersects(geom, BuildMbr(10, 10, 20, 20)) = 1
+
+  SELECT * FROM t WHERE ROWID IN (
+    SELECT ROWID FROM ZoneMap WHERE f_table_name = 't'
+    AND attribute = 'temperature' AND min_value = 10 AND max_value = 20)
+  AND temperature BETWEEN 10 AND 20
+
+min_value and max_value are the bounds of the searched range, and
+each one of them can be omitted; search_frame and the attribute
+range can be combined.
+
+the result set is always a superset of the exact answer, so the
+search conditions must be evaluated again on the main table.
+
+invalid arguments (missing ZoneMap, untracked attribute, non-BLOB
+search frame ...) will raise an SQL error; a NULL search_frame
+simply returns an empty result set
+
+*/
+
+#include <sys/types.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32) && !defined(__MINGW32__)
+#include "config-msvc.h"
+#else
+#include "config.h"
+#endif
+
+#include <spatialite/sqlite.h>
+
+#include <spatialite/spatialite.h>
+#include <spatialite/gaiaaux.h>
+#include <spatialite/gaiageo.h>
+
+#ifdef _WIN32
+#define strcasecmp	_stricmp
+#define strncasecmp	_strnicmp
+#endif /* not WIN32 */
+
+static struct sqlite3_module my_zonemap_module;
+
+
+/******************************************************************************
+/
+/ VirtualTable structs
+/
+******************************************************************************/
+
+typedef struct VirtualZoneMapStruct
+{
+/* extends the sqlite3_vtab struct */
+    const sqlite3_module *pModule;	/* ptr to sqlite module: USED INTERNALLY BY SQLITE */
+    int nRef;			/* # references: USED INTERNALLY BY SQLITE */
+    char *zErrMsg;		/* error message: USE INTERNALLY BY SQLITE */
+    sqlite3 *db;		/* the sqlite db holding the virtual table */
+} VirtualZoneMap;
+typedef VirtualZoneMap *VirtualZoneMapPtr;
+
+typedef struct VZoneMapValueStruct
+{
+/* a copy of an SQL Value (a range bound) */
+    int type;
+    sqlite3_int64 int_value;
+    double dbl_value;
+    unsigned char *data;	/* TEXT or BLOB */
+    int size;
+} VZoneMapValue;
+typedef VZoneMapValue *VZoneMapValuePtr;
+
+typedef struct VirtualZoneMapCursorStruct
+{
+/* extends the sqlite3_vtab_cursor struct */
+    VirtualZoneMapPtr pVtab;	/* Virtual table of this cursor */
+    int eof;			/* the EOF marker */
+    char *table_name;		/* the current Table Name arg */
+    char *geom_column;		/* the current Geometry Column */
+    unsigned char *blob;	/* the current Search Frame */
+    int blob_size;
+    char *attribute;		/* the current Attribute Name */
+    VZoneMapValue min_value;	/* the current range lower bound */
+    VZoneMapValue max_value;	/* the current range upper bound */
+    sqlite3_stmt *stmt_blocks;	/* the candidate blocks query */
+    sqlite3_stmt *stmt_rows;	/* the ROWID range query */
+    int in_block;		/* TRUE while scrolling a block */
+    sqlite3_int64 block_id;	/* the current block */
+    sqlite3_int64 current_row;	/* the current ROWID */
+} VirtualZoneMapCursor;
+typedef VirtualZoneMapCursor *VirtualZoneMapCursorPtr;
+
+static int
+vzonemap_find_geometry (sqlite3 * sqlite, const char *db_prefix,
+			const char *table_name, const char *geom_column,
+			char **real_table, char **real_geom)
+{
+/* attempts to find the corresponding Geometry Column */
+    sqlite3_stmt *stmt;
+    char *sql_statement;
+    char *quoted_db;
+    int ret;
+    int count = 0;
+    char *rt = NULL;
+    char *rg = NULL;
+
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    if (geom_column == NULL)
+      {
+	  sql_statement =
+	      sqlite3_mprintf
+	      ("SELECT f_table_name, f_geometry_column FROM \"%s\".geometry_columns "
+	       "WHERE Upper(f_table_name) = Upper(%Q)", quoted_db, table_name);
+      }
+    else
+      {
+	  sql_statement =
+	      sqlite3_mprintf
+	      ("SELECT f_table_name, f_geometry_column FROM \"%s\".geometry_columns "
+	       "WHERE Upper(f_table_name) = Upper(%Q) AND "
+	       "Upper(f_geometry_column) = Upper(%Q)", quoted_db, table_name,
+	       geom_column);
+      }
+    free (quoted_db);
+    ret =
+	sqlite3_prepare_v2 (sqlite, sql_statement, strlen (sql_statement),
+			    &stmt, NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		const char *v = (const char *) sqlite3_column_text (stmt, 0);
+		int len = sqlite3_column_bytes (stmt, 0);
+		if (rt)
+		    free (rt);
+		rt = malloc (len + 1);
+		strcpy (rt, v);
+		v = (const char *) sqlite3_column_text (stmt, 1);
+		len = sqlite3_column_bytes (stmt, 1);
+		if (rg)
+		    free (rg);
+		rg = malloc (len + 1);
+		strcpy (rg, v);
+		count++;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    if (count != 1)
+      {
+	  if (rg != NULL)
+	      free (rg);
+	  if (rt != NULL)
+	      free (rt);
+	  return 0;
+      }
+    *real_table = rt;
+    *real_geom = rg;
+    return 1;
+}
+
+static int
+vzonemap_exists (sqlite3 * sqlite, const char *db_prefix,
+		 const char *table_name, const char *geom_column)
+{
+/* checks if the "zm_<table>_<column>" table exists */
+    char *sql_statement;
+    char *quoted_db;
+    char *zonemap;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int count = 0;
+
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    zonemap = sqlite3_mprintf ("zm_%s_%s", table_name, geom_column);
+    sql_statement =
+	sqlite3_mprintf ("SELECT Count(*) FROM \"%s\".sqlite_master "
+			 "WHERE type = 'table' AND Upper(name) = Upper(%Q)",
+			 quoted_db, zonemap);
+    free (quoted_db);
+    sqlite3_free (zonemap);
+    ret =
+	sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			   NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    if (rows == 1)
+	count = atoi (results[1]);
+    sqlite3_free_table (results);
+    return count;
+}
+
+static int
+vzonemap_has_attribute (sqlite3 * sqlite, const char *db_prefix,
+			const char *table_name, const char *geom_column,
+			const char *attribute)
+{
+/* checks if the ZoneMap tracks the min/max Values of some attribute */
+    char *sql_statement;
+    char *quoted_db;
+    char *zonemap;
+    char *quoted_zonemap;
+    char *min_name;
+    char *max_name;
+    char **results;
+    int rows;
+    int columns;
+    int ret;
+    int i;
+    int count = 0;
+
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    zonemap = sqlite3_mprintf ("zm_%s_%s", table_name, geom_column);
+    quoted_zonemap = gaiaDoubleQuotedSql (zonemap);
+    sqlite3_free (zonemap);
+    sql_statement =
+	sqlite3_mprintf ("PRAGMA \"%s\".table_info(\"%s\")", quoted_db,
+			 quoted_zonemap);
+    free (quoted_db);
+    free (quoted_zonemap);
+    ret =
+	sqlite3_get_table (sqlite, sql_statement, &results, &rows, &columns,
+			   NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+	return 0;
+    min_name = sqlite3_mprintf ("min_%s", attribute);
+    max_name = sqlite3_mprintf ("max_%s", attribute);
+    for (i = 1; i <= rows; i++)
+      {
+	  const char *name = results[(i * columns) + 1];
+	  if (strcasecmp (name, min_name) == 0
+	      || strcasecmp (name, max_name) == 0)
+	      count++;
+      }
+    sqlite3_free (min_name);
+    sqlite3_free (max_name);
+    sqlite3_free_table (results);
+    return (count == 2) ? 1 : 0;
+}
+
+static void
+vzonemap_parse_table_name (const char *tn, char **db_prefix,
+			   char **table_name)
+{
+/* attempting to extract an eventual DB prefix */
+    int i;
+    int len = strlen (tn);
+    int i_dot = -1;
+    if (strncasecmp (tn, "DB=", 3) == 0)
+      {
+	  int l_db;
+	  int l_tbl;
+	  for (i = 3; i < len; i++)
+	    {
+		if (tn[i] == '.')
+		  {
+		      i_dot = i;
+		      break;
+		  }
+	    }
+	  if (i_dot > 1)
+	    {
+		l_db = i_dot - 3;
+		l_tbl = len - (i_dot + 1);
+		*db_prefix = malloc (l_db + 1);
+		memset (*db_prefix, '\0', l_db + 1);
+		memcpy (*db_prefix, tn + 3, l_db);
+		*table_name = malloc (l_tbl + 1);
+		strcpy (*table_name, tn + i_dot + 1);
+		return;
+	    }
+      }
+    *table_name = malloc (len + 1);
+    strcpy (*table_name, tn);
+}
+
+static void
+vzonemap_reset_value (VZoneMapValuePtr value)
+{
+/* resetting a range bound */
+    if (value->data != NULL)
+	free (value->data);
+    value->type = SQLITE_NULL;
+    value->int_value = 0;
+    value->dbl_value = 0.0;
+    value->data = NULL;
+    value->size = 0;
+}
+
+static void
+vzonemap_copy_value (VZoneMapValuePtr value, sqlite3_value * arg)
+{
+/* copying a range bound */
+    vzonemap_reset_value (value);
+    value->type = sqlite3_value_type (arg);
+    switch (value->type)
+      {
+      case SQLITE_INTEGER:
+	  value->int_value = sqlite3_value_int64 (arg);
+	  break;
+      case SQLITE_FLOAT:
+	  value->dbl_value = sqlite3_value_double (arg);
+	  break;
+      case SQLITE_TEXT:
+	  value->size = sqlite3_value_bytes (arg);
+	  value->data = malloc (value->size + 1);
+	  memcpy (value->data, sqlite3_value_text (arg), value->size + 1);
+	  break;
+      case SQLITE_BLOB:
+	  value->size = sqlite3_value_bytes (arg);
+	  value->data = malloc (value->size + 1);
+	  memcpy (value->data, sqlite3_value_blob (arg), value->size);
+	  break;
+      };
+}
+
+static void
+vzonemap_result_value (sqlite3_context * pContext, VZoneMapValuePtr value)
+{
+/* returning a range bound */
+    switch (value->type)
+      {
+      case SQLITE_INTEGER:
+	  sqlite3_result_int64 (pContext, value->int_value);
+	  break;
+      case SQLITE_FLOAT:
+	  sqlite3_result_double (pContext, value->dbl_value);
+	  break;
+      case SQLITE_TEXT:
+	  sqlite3_result_text (pContext, (const char *) (value->data),
+			       value->size, SQLITE_STATIC);
+	  break;
+      case SQLITE_BLOB:
+	  sqlite3_result_blob (pContext, value->data, value->size,
+			       SQLITE_STATIC);
+	  break;
+      default:
+	  sqlite3_result_null (pContext);
+	  break;
+      };
+}
+
+static void
+vzonemap_set_error (VirtualZoneMapCursorPtr cursor, char *msg)
+{
+/* reporting an error message back to SQLite */
+    VirtualZoneMapPtr p_vt = cursor->pVtab;
+    if (p_vt->zErrMsg != NULL)
+	sqlite3_free (p_vt->zErrMsg);
+    p_vt->zErrMsg = msg;
+}
+
+static void
+vzonemap_reset_args (VirtualZoneMapCursorPtr cursor)
+{
+/* releasing the args and the queries of the previous filter */
+    if (cursor->table_name != NULL)
+	free (cursor->table_name);
+    if (cursor->geom_column != NULL)
+	free (cursor->geom_column);
+    if (cursor->blob != NULL)
+	free (cursor->blob);
+    if (cursor->attribute != NULL)
+	free (cursor->attribute);
+    if (cursor->stmt_blocks != NULL)
+	sqlite3_finalize (cursor->stmt_blocks);
+    if (cursor->stmt_rows != NULL)
+	sqlite3_finalize (cursor->stmt_rows);
+    cursor->table_name = NULL;
+    cursor->geom_column = NULL;
+    cursor->blob = NULL;
+    cursor->blob_size = 0;
+    cursor->attribute = NULL;
+    vzonemap_reset_value (&(cursor->min_value));
+    vzonemap_reset_value (&(cursor->max_value));
+    cursor->stmt_blocks = NULL;
+    cursor->stmt_rows = NULL;
+    cursor->in_block = 0;
+}
+
+static char *
+vzonemap_strdup (const char *str)
+{
+/* duplicating a text string */
+    int len = strlen (str);
+    char *dup = malloc (len + 1);
+    strcpy (dup, str);
+    return dup;
+}
+
+static int
+vzonemap_create (sqlite3 * db, void *pAux, int argc, const char *const *argv,
+		 sqlite3_vtab ** ppVTab, char **pzErr)
+{
+/* creates the virtual table for ZoneMap metahandling */
+    VirtualZoneMapPtr p_vt;
+    char *buf;
+    char *vtable;
+    char *xname;
+    if (pAux)
+	pAux = pAux;		/* unused arg warning suppression */
+    if (argc == 3)
+      {
+	  vtable = gaiaDequotedSql ((char *) argv[2]);
+      }
+    else
+      {
+	  *pzErr =
+	      sqlite3_mprintf
+	      ("[VirtualZoneMap module] CREATE VIRTUAL: illegal arg list {void}\n");
+	  return SQLITE_ERROR;
+      }
+    p_vt = (VirtualZoneMapPtr) sqlite3_malloc (sizeof (VirtualZoneMap));
+    if (!p_vt)
+	return SQLITE_NOMEM;
+    p_vt->db = db;
+    p_vt->pModule = &my_zonemap_module;
+    p_vt->nRef = 0;
+    p_vt->zErrMsg = NULL;
+/* preparing the COLUMNs for this VIRTUAL TABLE */
+    xname = gaiaDoubleQuotedSql (vtable);
+    buf = sqlite3_mprintf ("CREATE TABLE \"%s\" (f_table_name TEXT, "
+			   "f_geometry_column TEXT, search_frame BLOB, "
+			   "attribute TEXT, min_value, max_value, "
+			   "block_id INTEGER)", xname);
+    free (xname);
+    free (vtable);
+    if (sqlite3_declare_vtab (db, buf) != SQLITE_OK)
+      {
+	  sqlite3_free (buf);
+	  *pzErr =
+	      sqlite3_mprintf
+	      ("[VirtualZoneMap module] CREATE VIRTUAL: invalid SQL statement \"%s\"",
+	       buf);
+	  return SQLITE_ERROR;
+      }
+    sqlite3_free (buf);
+    *ppVTab = (sqlite3_vtab *) p_vt;
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_connect (sqlite3 * db, void *pAux, int argc,
+		  const char *const *argv, sqlite3_vtab ** ppVTab,
+		  char **pzErr)
+{
+/* connects the virtual table - simply aliases vzonemap_create() */
+    return vzonemap_create (db, pAux, argc, argv, ppVTab, pzErr);
+}
+
+static int
+vzonemap_best_index (sqlite3_vtab * pVTab, sqlite3_index_info * pIdxInfo)
+{
+/*
+/ best index selection
+/
+/ idxNum is a bitmask: 1 = f_geometry_column, 2 = search_frame,
+/ 4 = attribute, 8 = min_value, 16 = max_value
+/ the args will always be passed in this order: f_table_name,
+/ [f_geometry_column], [search_frame], [attribute], [min_value],
+/ [max_value]
+*/
+    int i;
+    int cols[6];
+    int errors = 0;
+    int arg = 1;
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    for (i = 0; i < 6; i++)
+	cols[i] = -1;
+    for (i = 0; i < pIdxInfo->nConstraint; i++)
+      {
+	  /* verifying the constraints */
+	  struct sqlite3_index_constraint *p = &(pIdxInfo->aConstraint[i]);
+	  if (!p->usable || p->op != SQLITE_INDEX_CONSTRAINT_EQ)
+	      continue;
+	  if (p->iColumn < 0 || p->iColumn > 5)
+	      continue;
+	  if (cols[p->iColumn] >= 0)
+	      errors++;
+	  cols[p->iColumn] = i;
+      }
+    if (cols[0] < 0 || (cols[2] < 0 && cols[3] < 0) || errors)
+      {
+	  /* illegal query */
+	  pIdxInfo->idxNum = 0;
+	  pIdxInfo->estimatedCost = 1.0e12;
+	  return SQLITE_OK;
+      }
+
+/* this one is a valid ZoneMap query */
+    pIdxInfo->idxNum = 0;
+    pIdxInfo->aConstraintUsage[cols[0]].argvIndex = arg++;
+    pIdxInfo->aConstraintUsage[cols[0]].omit = 1;
+    for (i = 1; i < 6; i++)
+      {
+	  if (cols[i] < 0)
+	      continue;
+	  pIdxInfo->idxNum |= (1 << (i - 1));
+	  pIdxInfo->aConstraintUsage[cols[i]].argvIndex = arg++;
+	  pIdxInfo->aConstraintUsage[cols[i]].omit = 1;
+      }
+    pIdxInfo->idxNum |= 32;	/* marking a valid query */
+    pIdxInfo->estimatedCost = 1.0;
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_disconnect (sqlite3_vtab * pVTab)
+{
+/* disconnects the virtual table */
+    VirtualZoneMapPtr p_vt = (VirtualZoneMapPtr) pVTab;
+    sqlite3_free (p_vt);
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_destroy (sqlite3_vtab * pVTab)
+{
+/* destroys the virtual table - simply aliases vzonemap_disconnect() */
+    return vzonemap_disconnect (pVTab);
+}
+
+static int
+vzonemap_open (sqlite3_vtab * pVTab, sqlite3_vtab_cursor ** ppCursor)
+{
+/* opening a new cursor */
+    VirtualZoneMapCursorPtr cursor =
+	(VirtualZoneMapCursorPtr)
+	sqlite3_malloc (sizeof (VirtualZoneMapCursor));
+    if (cursor == NULL)
+	return SQLITE_ERROR;
+    cursor->pVtab = (VirtualZoneMapPtr) pVTab;
+    cursor->eof = 1;
+    cursor->table_name = NULL;
+    cursor->geom_column = NULL;
+    cursor->blob = NULL;
+    cursor->blob_size = 0;
+    cursor->attribute = NULL;
+    cursor->min_value.data = NULL;
+    vzonemap_reset_value (&(cursor->min_value));
+    cursor->max_value.data = NULL;
+    vzonemap_reset_value (&(cursor->max_value));
+    cursor->stmt_blocks = NULL;
+    cursor->stmt_rows = NULL;
+    cursor->in_block = 0;
+    cursor->block_id = 0;
+    cursor->current_row = 0;
+    *ppCursor = (sqlite3_vtab_cursor *) cursor;
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_close (sqlite3_vtab_cursor * pCursor)
+{
+/* closing the cursor */
+    VirtualZoneMapCursorPtr cursor = (VirtualZoneMapCursorPtr) pCursor;
+    vzonemap_reset_args (cursor);
+    sqlite3_free (pCursor);
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_fetch (VirtualZoneMapCursorPtr cursor)
+{
+/*
+/ fetching the next candidate ROWID: the current block is
+/ scrolled first, then the next candidate block is started
+*/
+    int ret;
+    while (1)
+      {
+	  if (cursor->in_block)
+	    {
+		ret = sqlite3_step (cursor->stmt_rows);
+		if (ret == SQLITE_ROW)
+		  {
+		      cursor->current_row =
+			  sqlite3_column_int64 (cursor->stmt_rows, 0);
+		      return SQLITE_OK;
+		  }
+		if (ret != SQLITE_DONE)
+		    break;
+		cursor->in_block = 0;
+	    }
+	  ret = sqlite3_step (cursor->stmt_blocks);
+	  if (ret == SQLITE_DONE)
+	    {
+		cursor->eof = 1;
+		return SQLITE_OK;
+	    }
+	  if (ret != SQLITE_ROW)
+	      break;
+	  cursor->block_id = sqlite3_column_int64 (cursor->stmt_blocks, 0);
+	  sqlite3_reset (cursor->stmt_rows);
+	  sqlite3_clear_bindings (cursor->stmt_rows);
+	  sqlite3_bind_int64 (cursor->stmt_rows, 1,
+			      sqlite3_column_int64 (cursor->stmt_blocks, 1));
+	  sqlite3_bind_int64 (cursor->stmt_rows, 2,
+			      sqlite3_column_int64 (cursor->stmt_blocks, 2));
+	  cursor->in_block = 1;
+      }
+    vzonemap_set_error (cursor,
+			sqlite3_mprintf ("[VirtualZoneMap module] step: %s",
+					 sqlite3_errmsg (cursor->pVtab->db)));
+    cursor->eof = 1;
+    return SQLITE_ERROR;
+}
+
+static int
+vzonemap_filter (sqlite3_vtab_cursor * pCursor, int idxNum,
+		 const char *idxStr, int argc, sqlite3_value ** argv)
+{
+/* setting up a cursor filter */
+    char *db_prefix = NULL;
+    char *table_name = NULL;
+    const char *geom_column = NULL;
+    char *xtable = NULL;
+    char *xgeom = NULL;
+    char *zonemap;
+    char *quoted_db;
+    char *quoted_zonemap;
+    char *quoted_table;
+    char *where;
+    char *prev;
+    char *sql_statement;
+    gaiaGeomCollPtr geom = NULL;
+    sqlite3_value *min_arg = NULL;
+    sqlite3_value *max_arg = NULL;
+    int ret;
+    int arg = 0;
+    int rc = SQLITE_OK;
+    VirtualZoneMapCursorPtr cursor = (VirtualZoneMapCursorPtr) pCursor;
+    VirtualZoneMapPtr p_vt = (VirtualZoneMapPtr) cursor->pVtab;
+    if (idxStr)
+	idxStr = idxStr;	/* unused arg warning suppression */
+    cursor->eof = 1;
+    vzonemap_reset_args (cursor);
+    if ((idxNum & 32) == 0)
+	goto stop;		/* not a ZoneMap query: empty result */
+
+/* retrieving the Table/[Column]/[Frame]/[Attribute/Min/Max] params */
+    if (arg >= argc || sqlite3_value_type (argv[arg]) != SQLITE_TEXT)
+      {
+	  vzonemap_set_error (cursor,
+			      sqlite3_mprintf
+			      ("[VirtualZoneMap module] f_table_name: expected a TEXT value"));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    cursor->table_name =
+	vzonemap_strdup ((const char *) sqlite3_value_text (argv[arg]));
+    vzonemap_parse_table_name (cursor->table_name, &db_prefix, &table_name);
+    arg++;
+    if (idxNum & 1)
+      {
+	  if (arg >= argc || sqlite3_value_type (argv[arg]) != SQLITE_TEXT)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] f_geometry_column: expected a TEXT value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  geom_column = (const char *) sqlite3_value_text (argv[arg]);
+	  arg++;
+      }
+    if (idxNum & 2)
+      {
+	  const unsigned char *blob;
+	  int size;
+	  if (arg >= argc)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] missing search_frame"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  if (sqlite3_value_type (argv[arg]) == SQLITE_NULL)
+	      goto stop;	/* NULL search frame: empty result */
+	  if (sqlite3_value_type (argv[arg]) != SQLITE_BLOB)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] search_frame: expected a BLOB value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  blob = sqlite3_value_blob (argv[arg]);
+	  size = sqlite3_value_bytes (argv[arg]);
+	  geom = gaiaFromSpatiaLiteBlobWkb (blob, size);
+	  if (geom == NULL)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] search_frame: invalid Geometry"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  cursor->blob = malloc (size);
+	  memcpy (cursor->blob, blob, size);
+	  cursor->blob_size = size;
+	  arg++;
+      }
+    if (idxNum & 4)
+      {
+	  if (arg >= argc || sqlite3_value_type (argv[arg]) != SQLITE_TEXT)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] attribute: expected a TEXT value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  cursor->attribute =
+	      vzonemap_strdup ((const char *) sqlite3_value_text (argv[arg]));
+	  arg++;
+      }
+    if (idxNum & 8)
+      {
+	  if (arg >= argc)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] missing min_value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  min_arg = argv[arg];
+	  vzonemap_copy_value (&(cursor->min_value), min_arg);
+	  arg++;
+      }
+    if (idxNum & 16)
+      {
+	  if (arg >= argc)
+	    {
+		vzonemap_set_error (cursor,
+				    sqlite3_mprintf
+				    ("[VirtualZoneMap module] missing max_value"));
+		rc = SQLITE_ERROR;
+		goto stop;
+	    }
+	  max_arg = argv[arg];
+	  vzonemap_copy_value (&(cursor->max_value), max_arg);
+	  arg++;
+      }
+    if (cursor->attribute == NULL && (min_arg != NULL || max_arg != NULL))
+      {
+	  vzonemap_set_error (cursor,
+			      sqlite3_mprintf
+			      ("[VirtualZoneMap module] min_value/max_value require an attribute"));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    if (cursor->attribute != NULL && min_arg == NULL && max_arg == NULL)
+      {
+	  vzonemap_set_error (cursor,
+			      sqlite3_mprintf
+			      ("[VirtualZoneMap module] attribute \"%s\" requires min_value and/or max_value",
+			       cursor->attribute));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    if ((min_arg != NULL && sqlite3_value_type (min_arg) == SQLITE_NULL)
+	|| (max_arg != NULL && sqlite3_value_type (max_arg) == SQLITE_NULL))
+	goto stop;		/* NULL range bound: empty result */
+
+/* checking if the corresponding ZoneMap exists */
+    if (!vzonemap_find_geometry
+	(p_vt->db, db_prefix, table_name, geom_column, &xtable, &xgeom)
+	|| !vzonemap_exists (p_vt->db, db_prefix, xtable, xgeom))
+      {
+	  if (geom_column == NULL)
+	      vzonemap_set_error (cursor,
+				  sqlite3_mprintf
+				  ("[VirtualZoneMap module] \"%s\" has no (unique) Geometry supported by a ZoneMap",
+				   table_name));
+	  else
+	      vzonemap_set_error (cursor,
+				  sqlite3_mprintf
+				  ("[VirtualZoneMap module] \"%s\".\"%s\" is not supported by a ZoneMap",
+				   table_name, geom_column));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+    cursor->geom_column = vzonemap_strdup (xgeom);
+    if (cursor->attribute != NULL
+	&& !vzonemap_has_attribute (p_vt->db, db_prefix, xtable, xgeom,
+				    cursor->attribute))
+      {
+	  vzonemap_set_error (cursor,
+			      sqlite3_mprintf
+			      ("[VirtualZoneMap module] attribute \"%s\" is not tracked by the ZoneMap",
+			       cursor->attribute));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+
+/* building the candidate blocks query */
+    where = sqlite3_mprintf ("%s", "");
+    if (geom != NULL)
+      {
+	  prev = where;
+	  where =
+	      sqlite3_mprintf ("%s AND maxx >= ? AND minx <= ? "
+			       "AND maxy >= ? AND miny <= ?", prev);
+	  sqlite3_free (prev);
+      }
+    if (min_arg != NULL)
+      {
+	  char *raw = sqlite3_mprintf ("max_%s", cursor->attribute);
+	  char *quoted = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  prev = where;
+	  where = sqlite3_mprintf ("%s AND \"%s\" >= ?", prev, quoted);
+	  sqlite3_free (prev);
+	  free (quoted);
+      }
+    if (max_arg != NULL)
+      {
+	  char *raw = sqlite3_mprintf ("min_%s", cursor->attribute);
+	  char *quoted = gaiaDoubleQuotedSql (raw);
+	  sqlite3_free (raw);
+	  prev = where;
+	  where = sqlite3_mprintf ("%s AND \"%s\" <= ?", prev, quoted);
+	  sqlite3_free (prev);
+	  free (quoted);
+      }
+    if (db_prefix == NULL)
+	quoted_db = gaiaDoubleQuotedSql ("main");
+    else
+	quoted_db = gaiaDoubleQuotedSql (db_prefix);
+    zonemap = sqlite3_mprintf ("zm_%s_%s", xtable, xgeom);
+    quoted_zonemap = gaiaDoubleQuotedSql (zonemap);
+    sqlite3_free (zonemap);
+    sql_statement =
+	sqlite3_mprintf
+	("SELECT block_id, first_rowid, last_rowid FROM \"%s\".\"%s\" "
+	 "WHERE 1%s ORDER BY block_id", quoted_db, quoted_zonemap, where);
+    free (quoted_zonemap);
+    sqlite3_free (where);
+    ret =
+	sqlite3_prepare_v2 (p_vt->db, sql_statement, strlen (sql_statement),
+			    &(cursor->stmt_blocks), NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  free (quoted_db);
+	  vzonemap_set_error (cursor,
+			      sqlite3_mprintf
+			      ("[VirtualZoneMap module] ZoneMap query: %s",
+			       sqlite3_errmsg (p_vt->db)));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+
+/* building the ROWID range query */
+    quoted_table = gaiaDoubleQuotedSql (xtable);
+    sql_statement =
+	sqlite3_mprintf
+	("SELECT ROWID FROM \"%s\".\"%s\" WHERE ROWID BETWEEN ? AND ?",
+	 quoted_db, quoted_table);
+    free (quoted_db);
+    free (quoted_table);
+    ret =
+	sqlite3_prepare_v2 (p_vt->db, sql_statement, strlen (sql_statement),
+			    &(cursor->stmt_rows), NULL);
+    sqlite3_free (sql_statement);
+    if (ret != SQLITE_OK)
+      {
+	  vzonemap_set_error (cursor,
+			      sqlite3_mprintf
+			      ("[VirtualZoneMap module] ROWID query: %s",
+			       sqlite3_errmsg (p_vt->db)));
+	  rc = SQLITE_ERROR;
+	  goto stop;
+      }
+
+/* binding the search conditions */
+    arg = 1;
+    if (geom != NULL)
+      {
+	  sqlite3_bind_double (cursor->stmt_blocks, arg++, geom->MinX);
+	  sqlite3_bind_double (cursor->stmt_blocks, arg++, geom->MaxX);
+	  sqlite3_bind_double (cursor->stmt_blocks, arg++, geom->MinY);
+	  sqlite3_bind_double (cursor->stmt_blocks, arg++, geom->MaxY);
+      }
+    if (min_arg != NULL)
+	sqlite3_bind_value (cursor->stmt_blocks, arg++, min_arg);
+    if (max_arg != NULL)
+	sqlite3_bind_value (cursor->stmt_blocks, arg++, max_arg);
+
+/* fetching the first candidate */
+    cursor->eof = 0;
+    rc = vzonemap_fetch (cursor);
+
+  stop:
+    if (geom)
+	gaiaFreeGeomColl (geom);
+    if (xtable)
+	free (xtable);
+    if (xgeom)
+	free (xgeom);
+    if (db_prefix)
+	free (db_prefix);
+    if (table_name)
+	free (table_name);
+    return rc;
+}
+
+static int
+vzonemap_next (sqlite3_vtab_cursor * pCursor)
+{
+/* fetching a next row from cursor */
+    VirtualZoneMapCursorPtr cursor = (VirtualZoneMapCursorPtr) pCursor;
+    return vzonemap_fetch (cursor);
+}
+
+static int
+vzonemap_eof (sqlite3_vtab_cursor * pCursor)
+{
+/* cursor EOF */
+    VirtualZoneMapCursorPtr cursor = (VirtualZoneMapCursorPtr) pCursor;
+    return cursor->eof;
+}
+
+static int
+vzonemap_column (sqlite3_vtab_cursor * pCursor, sqlite3_context * pContext,
+		 int column)
+{
+/* fetching value for the Nth column */
+    VirtualZoneMapCursorPtr cursor = (VirtualZoneMapCursorPtr) pCursor;
+    if (column == 0 && cursor->table_name != NULL)
+      {
+	  /* the Table Name column */
+	  sqlite3_result_text (pContext, cursor->table_name,
+			       strlen (cursor->table_name), SQLITE_STATIC);
+      }
+    else if (column == 1 && cursor->geom_column != NULL)
+      {
+	  /* the GeometryColumn Name column */
+	  sqlite3_result_text (pContext, cursor->geom_column,
+			       strlen (cursor->geom_column), SQLITE_STATIC);
+      }
+    else if (column == 2 && cursor->blob != NULL)
+      {
+	  /* the Search Frame column */
+	  sqlite3_result_blob (pContext, cursor->blob, cursor->blob_size,
+			       SQLITE_STATIC);
+      }
+    else if (column == 3 && cursor->attribute != NULL)
+      {
+	  /* the Attribute Name column */
+	  sqlite3_result_text (pContext, cursor->attribute,
+			       strlen (cursor->attribute), SQLITE_STATIC);
+      }
+    else if (column == 4)
+      {
+	  /* the range lower bound column */
+	  vzonemap_result_value (pContext, &(cursor->min_value));
+      }
+    else if (column == 5)
+      {
+	  /* the range upper bound column */
+	  vzonemap_result_value (pContext, &(cursor->max_value));
+      }
+    else if (column == 6)
+      {
+	  /* the "block_id" column */
+	  sqlite3_result_int64 (pContext, cursor->block_id);
+      }
+    else
+	sqlite3_result_null (pContext);
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_rowid (sqlite3_vtab_cursor * pCursor, sqlite_int64 * pRowid)
+{
+/* fetching the ROWID */
+    VirtualZoneMapCursorPtr cursor = (VirtualZoneMapCursorPtr) pCursor;
+    *pRowid = cursor->current_row;
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_update (sqlite3_vtab * pVTab, int argc, sqlite3_value ** argv,
+		 sqlite_int64 * pRowid)
+{
+/* generic update [INSERT / UPDATE / DELETE */
+    if (pRowid || argc || argv || pVTab)
+	pRowid = pRowid;	/* unused arg warning suppression */
+/* read only datasource */
+    return SQLITE_READONLY;
+}
+
+static int
+vzonemap_begin (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_sync (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_commit (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_rollback (sqlite3_vtab * pVTab)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    return SQLITE_OK;
+}
+
+static int
+vzonemap_rename (sqlite3_vtab * pVTab, const char *zNew)
+{
+/* BEGIN TRANSACTION */
+    if (pVTab)
+	pVTab = pVTab;		/* unused arg warning suppression */
+    if (zNew)
+	zNew = zNew;		/* unused arg warning suppression */
+    return SQLITE_ERROR;
+}
+
+static int
+spliteVirtualZoneMapInit (sqlite3 * db)
+{
+    int rc = SQLITE_OK;
+    my_zonemap_module.iVersion = 1;
+    my_zonemap_module.xCreate = &vzonemap_create;
+    my_zonemap_module.xConnect = &vzonemap_connect;
+    my_zonemap_module.xBestIndex = &vzonemap_best_index;
+    my_zonemap_module.xDisconnect = &vzonemap_disconnect;
+    my_zonemap_module.xDestroy = &vzonemap_destroy;
+    my_zonemap_module.xOpen = &vzonemap_open;
+    my_zonemap_module.xClose = &vzonemap_close;
+    my_zonemap_module.xFilter = &vzonemap_filter;
+    my_zonemap_module.xNext = &vzonemap_next;
+    my_zonemap_module.xEof = &vzonemap_eof;
+    my_zonemap_module.xColumn = &vzonemap_column;
+    my_zonemap_module.xRowid = &vzonemap_rowid;
+    my_zonemap_module.xUpdate = &vzonemap_update;
+    my_zonemap_module.xBegin = &vzonemap_begin;
+    my_zonemap_module.xSync = &vzonemap_sync;
+    my_zonemap_module.xCommit = &vzonemap_commit;
+    my_zonemap_module.xRollback = &vzonemap_rollback;
+    my_zonemap_module.xFindFunction = NULL;
+    my_zonemap_module.xRename = &vzonemap_rename;
+    sqlite3_create_module_v2 (db, "VirtualZoneMap", &my_zonemap_module, NULL,
+			      0);
+    return rc;
+}
+
+SPATIALITE_PRIVATE int
+virtual_zonemap_extension_init (void *xdb)
+{
+    sqlite3 *db = (sqlite3 *) xdb;
+    return spliteVirtualZoneMapInit (db);
+}
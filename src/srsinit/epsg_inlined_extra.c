@@ -195,6 +195,111 @@ initialize_epsg_extra (int filter, struct epsg_defs **first, struct epsg_defs **
     add_srs_wkt (p, 0, "");
 }
 
+struct epsg_chunk
+{
+/* an SRID range covered by a single inlined function */
+    int min_srid;
+    int max_srid;
+    void (*init) (int filter, struct epsg_defs **first, struct epsg_defs **last);
+};
+
+#ifndef OMIT_EPSG    /* full EPSG initialization enabled */
+/* sorted by SRID, not overlapping: supports binary search */
+static const struct epsg_chunk epsg_chunks[] = {
+    {2000, 2100, initialize_epsg_00},
+    {2101, 2208, initialize_epsg_01},
+    {2209, 2324, initialize_epsg_02},
+    {2325, 2425, initialize_epsg_03},
+    {2426, 2526, initialize_epsg_04},
+    {2527, 2627, initialize_epsg_05},
+    {2628, 2728, initialize_epsg_06},
+    {2729, 2829, initialize_epsg_07},
+    {2830, 2930, initialize_epsg_08},
+    {2931, 3035, initialize_epsg_09},
+    {3036, 3138, initialize_epsg_10},
+    {3140, 3243, initialize_epsg_11},
+    {3244, 3345, initialize_epsg_12},
+    {3346, 3446, initialize_epsg_13},
+    {3447, 3547, initialize_epsg_14},
+    {3548, 3648, initialize_epsg_15},
+    {3649, 3749, initialize_epsg_16},
+    {3750, 3889, initialize_epsg_17},
+    {3890, 4060, initialize_epsg_18},
+    {4061, 4205, initialize_epsg_19},
+    {4206, 4308, initialize_epsg_20},
+    {4309, 4522, initialize_epsg_21},
+    {4523, 4643, initialize_epsg_22},
+    {4644, 4748, initialize_epsg_23},
+    {4749, 4877, initialize_epsg_24},
+    {4878, 5297, initialize_epsg_25},
+    {5298, 5561, initialize_epsg_26},
+    {5562, 5853, initialize_epsg_27},
+    {5854, 6084, initialize_epsg_28},
+    {6085, 6341, initialize_epsg_29},
+    {6342, 6461, initialize_epsg_30},
+    {6462, 6562, initialize_epsg_31},
+    {6563, 6675, initialize_epsg_32},
+    {6676, 20031, initialize_epsg_33},
+    {20032, 21458, initialize_epsg_34},
+    {21459, 23700, initialize_epsg_35},
+    {23830, 24892, initialize_epsg_36},
+    {24893, 26774, initialize_epsg_37},
+    {26775, 26916, initialize_epsg_38},
+    {26917, 27223, initialize_epsg_39},
+    {27224, 28473, initialize_epsg_40},
+    {28474, 30491, initialize_epsg_41},
+    {30492, 31991, initialize_epsg_42},
+    {31992, 32122, initialize_epsg_43},
+    {32123, 32242, initialize_epsg_44},
+    {32243, 32423, initialize_epsg_45},
+    {32424, 32560, initialize_epsg_46},
+};
+
+static const struct epsg_chunk epsg_extra_chunks[] = {
+    {187900, 325833, initialize_epsg_prussian},
+    {40000, 40003, initialize_epsg_extra},
+};
+#endif /* full EPSG initialization enabled/disabled */
+
+static const struct epsg_chunk epsg_wgs84_chunks[] = {
+    {4326, 32733, initialize_epsg_wgs84_00},
+    {32734, 32766, initialize_epsg_wgs84_01},
+};
+
+static void
+initialize_epsg_srid (int srid, struct epsg_defs **first, struct epsg_defs **last)
+{
+/* initializing a single EPSG def - only the chunk(s) covering the SRID */
+    int i;
+#ifndef OMIT_EPSG    /* full EPSG initialization enabled */
+    int lo = 0;
+    int hi = (int) (sizeof (epsg_chunks) / sizeof (struct epsg_chunk)) - 1;
+    while (lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (srid < epsg_chunks[mid].min_srid)
+            hi = mid - 1;
+        else if (srid > epsg_chunks[mid].max_srid)
+            lo = mid + 1;
+        else
+        {
+            epsg_chunks[mid].init (srid, first, last);
+            break;
+        }
+    }
+    for (i = 0; i < (int) (sizeof (epsg_extra_chunks) / sizeof (struct epsg_chunk)); i++)
+    {
+        if (srid >= epsg_extra_chunks[i].min_srid && srid <= epsg_extra_chunks[i].max_srid)
+            epsg_extra_chunks[i].init (srid, first, last);
+    }
+#endif /* full EPSG initialization enabled/disabled */
+    for (i = 0; i < (int) (sizeof (epsg_wgs84_chunks) / sizeof (struct epsg_chunk)); i++)
+    {
+        if (srid >= epsg_wgs84_chunks[i].min_srid && srid <= epsg_wgs84_chunks[i].max_srid)
+            epsg_wgs84_chunks[i].init (srid, first, last);
+    }
+}
+
 SPATIALITE_PRIVATE void
 initialize_epsg (int filter, struct epsg_defs **first, struct epsg_defs **last)
 {
@@ -207,6 +312,13 @@ initialize_epsg (int filter, struct epsg_defs **first, struct epsg_defs **last)
     p = add_epsg_def (filter, first, last, 0, "NONE", 0, "Undefined - Geographic Long/Lat");
     add_proj4text (p, 0, "");
     add_srs_wkt (p, 0, "");
+    if (filter == GAIA_EPSG_NONE || filter == -1 || filter == 0)
+        return;
+    if (filter != GAIA_EPSG_ANY && filter != GAIA_EPSG_WGS84_ONLY)
+    {
+        initialize_epsg_srid (filter, first, last);
+        return;
+    }
 
     if (filter != GAIA_EPSG_WGS84_ONLY)
     {
@@ -405,6 +405,55 @@ open_file_wgs84 (int file_no)
     return out;
 }
 
+static int
+scan_srid_range (const char *path, int *min_srid, int *max_srid)
+{
+/* 
+/ scanning an already generated C source so to identify
+/ the real min/max SRID defined by its add_epsg_def() calls
+*/
+    char line[8192];
+    int count = 0;
+    FILE *in = fopen (path, "rb");
+    if (in == NULL)
+      {
+	  fprintf (stderr, "ERROR: unable to read the \"%s\" file\n", path);
+	  return 0;
+      }
+    while (fgets (line, sizeof (line), in) != NULL)
+      {
+	  int commas = 0;
+	  int srid;
+	  char *p = strstr (line, "add_epsg_def");
+	  if (p == NULL)
+	      continue;
+	  p = strchr (p, '(');
+	  if (p == NULL)
+	      continue;
+	  while (*p != '\0' && commas < 3)
+	    {
+		if (*p == ',')
+		    commas++;
+		p++;
+	    }
+	  if (commas < 3)
+	      continue;
+	  srid = atoi (p);
+	  if (count == 0 || srid < *min_srid)
+	      *min_srid = srid;
+	  if (count == 0 || srid > *max_srid)
+	      *max_srid = srid;
+	  count++;
+      }
+    fclose (in);
+    if (count == 0)
+      {
+	  fprintf (stderr, "ERROR: no SRID found into \"%s\"\n", path);
+	  return 0;
+      }
+    return 1;
+}
+
 static void
 do_prussian (FILE * out)
 {
@@ -1889,6 +1938,14 @@ output_c_code (FILE * out, struct epsg_dict *epsg)
     const char *in;
     int i;
     int pending_footer = 0;
+    int sect_min[1024];
+    int sect_max[1024];
+    int wgs84_min[64];
+    int wgs84_max[64];
+    int prussian_min;
+    int prussian_max;
+    int extra_min;
+    int extra_max;
 
     for (i = 0; i < epsg->count; i++)
       {
@@ -1931,6 +1988,11 @@ output_c_code (FILE * out, struct epsg_dict *epsg)
 	    }
 	  pending_footer = 1;
 
+	  /* updating the SRID range of the current section */
+	  if (def_cnt == 0)
+	      sect_min[sect - 1] = p->srid;
+	  sect_max[sect - 1] = p->srid;
+
 	  /* inserting the main EPSG def */
 	  def_cnt++;
 	  fprintf (out,
@@ -2065,6 +2127,11 @@ output_c_code (FILE * out, struct epsg_dict *epsg)
 	    }
 	  pending_footer = 1;
 
+	  /* updating the SRID range of the current section */
+	  if (def_cnt == 0)
+	      wgs84_min[wgs84_sect - 1] = p->srid;
+	  wgs84_max[wgs84_sect - 1] = p->srid;
+
 	  /* inserting the main EPSG def */
 	  def_cnt++;
 	  fprintf (out,
@@ -2168,6 +2235,9 @@ output_c_code (FILE * out, struct epsg_dict *epsg)
 /* closing the "prussian" output file */
     fclose (out);
     out = NULL;
+    if (!scan_srid_range
+	("epsg_inlined_prussian.c", &prussian_min, &prussian_max))
+	return;
 
 /* opening the "extra" output file */
     out = open_file2 ();
@@ -2247,6 +2317,75 @@ output_c_code (FILE * out, struct epsg_dict *epsg)
 
 /* function footer */
     do_footer (out, 0);
+    fflush (out);
+    if (!scan_srid_range ("epsg_inlined_extra.c", &extra_min, &extra_max))
+      {
+	  fclose (out);
+	  return;
+      }
+
+/* inserting the sorted SRID index supporting single-SRID lookups */
+    fprintf (out, "struct epsg_chunk\n{\n");
+    fprintf (out,
+	     "/* an SRID range covered by a single inlined function */\n");
+    fprintf (out, "    int min_srid;\n    int max_srid;\n");
+    fprintf (out,
+	     "    void (*init) (int filter, struct epsg_defs **first, struct epsg_defs **last);\n};\n\n");
+    fprintf (out,
+	     "#ifndef OMIT_EPSG    /* full EPSG initialization enabled */\n");
+    fprintf (out,
+	     "/* sorted by SRID, not overlapping: supports binary search */\n");
+    fprintf (out, "static const struct epsg_chunk epsg_chunks[] = {\n");
+    for (i = 0; i < sect; i++)
+	fprintf (out, "    {%d, %d, initialize_epsg_%02d},\n", sect_min[i],
+		 sect_max[i], i);
+    fprintf (out, "};\n\n");
+    fprintf (out, "static const struct epsg_chunk epsg_extra_chunks[] = {\n");
+    fprintf (out, "    {%d, %d, initialize_epsg_prussian},\n",
+	     prussian_min, prussian_max);
+    fprintf (out, "    {%d, %d, initialize_epsg_extra},\n};\n", extra_min,
+	     extra_max);
+    fprintf (out, "#endif /* full EPSG initialization enabled/disabled */\n\n");
+    fprintf (out, "static const struct epsg_chunk epsg_wgs84_chunks[] = {\n");
+    for (i = 0; i < wgs84_sect; i++)
+	fprintf (out, "    {%d, %d, initialize_epsg_wgs84_%02d},\n",
+		 wgs84_min[i], wgs84_max[i], i);
+    fprintf (out, "};\n\n");
+    fprintf (out, "static void\n");
+    fprintf (out,
+	     "initialize_epsg_srid (int srid, struct epsg_defs **first, struct epsg_defs **last)\n");
+    fprintf (out,
+	     "{\n/* initializing a single EPSG def - only the chunk(s) covering the SRID */\n");
+    fprintf (out, "    int i;\n");
+    fprintf (out,
+	     "#ifndef OMIT_EPSG    /* full EPSG initialization enabled */\n");
+    fprintf (out, "    int lo = 0;\n");
+    fprintf (out,
+	     "    int hi = (int) (sizeof (epsg_chunks) / sizeof (struct epsg_chunk)) - 1;\n");
+    fprintf (out, "    while (lo <= hi)\n    {\n");
+    fprintf (out, "        int mid = (lo + hi) / 2;\n");
+    fprintf (out, "        if (srid < epsg_chunks[mid].min_srid)\n");
+    fprintf (out, "            hi = mid - 1;\n");
+    fprintf (out, "        else if (srid > epsg_chunks[mid].max_srid)\n");
+    fprintf (out, "            lo = mid + 1;\n");
+    fprintf (out, "        else\n        {\n");
+    fprintf (out,
+	     "            epsg_chunks[mid].init (srid, first, last);\n");
+    fprintf (out, "            break;\n        }\n    }\n");
+    fprintf (out,
+	     "    for (i = 0; i < (int) (sizeof (epsg_extra_chunks) / sizeof (struct epsg_chunk)); i++)\n    {\n");
+    fprintf (out,
+	     "        if (srid >= epsg_extra_chunks[i].min_srid && srid <= epsg_extra_chunks[i].max_srid)\n");
+    fprintf (out,
+	     "            epsg_extra_chunks[i].init (srid, first, last);\n    }\n");
+    fprintf (out, "#endif /* full EPSG initialization enabled/disabled */\n");
+    fprintf (out,
+	     "    for (i = 0; i < (int) (sizeof (epsg_wgs84_chunks) / sizeof (struct epsg_chunk)); i++)\n    {\n");
+    fprintf (out,
+	     "        if (srid >= epsg_wgs84_chunks[i].min_srid && srid <= epsg_wgs84_chunks[i].max_srid)\n");
+    fprintf (out,
+	     "            epsg_wgs84_chunks[i].init (srid, first, last);\n    }\n");
+    fprintf (out, "}\n\n");
 
 /* inserting the pilot function */
     fprintf (out, "SPATIALITE_PRIVATE void\n");
@@ -2262,7 +2401,14 @@ output_c_code (FILE * out, struct epsg_dict *epsg)
     fprintf (out,
 	     "    p = add_epsg_def (filter, first, last, 0, \"NONE\", 0, \"Undefined - Geographic Long/Lat\");\n");
     fprintf (out, "    add_proj4text (p, 0, \"\");\n");
-    fprintf (out, "    add_srs_wkt (p, 0, \"\");\n\n");
+    fprintf (out, "    add_srs_wkt (p, 0, \"\");\n");
+    fprintf (out,
+	     "    if (filter == GAIA_EPSG_NONE || filter == -1 || filter == 0)\n");
+    fprintf (out, "        return;\n");
+    fprintf (out,
+	     "    if (filter != GAIA_EPSG_ANY && filter != GAIA_EPSG_WGS84_ONLY)\n    {\n");
+    fprintf (out, "        initialize_epsg_srid (filter, first, last);\n");
+    fprintf (out, "        return;\n    }\n\n");
     fprintf (out, "    if (filter != GAIA_EPSG_WGS84_ONLY)\n    {\n");
     fprintf (out,
 	     "#ifndef OMIT_EPSG    /* full EPSG initialization enabled */\n");
@@ -57,6 +57,9 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include <spatialite.h>
 #include <spatialite_private.h>
 
+/* the SPATIALITE_HISTORY event marking a lazily populated SPATIAL_REF_SYS */
+#define SRS_LAZY_EVENT "table successfully populated [lazy]"
+
 static void
 free_epsg_def (struct epsg_defs *ptr)
 {
@@ -305,7 +308,7 @@ add_epsg_def_ex (int filter_srid, struct epsg_defs **first,
 SPATIALITE_PRIVATE void
 add_proj4text (struct epsg_defs *p, int count, const char *text)
 {
-/* creating the PROJ4TEXT string */
+/* creating the PROJ4TEXT string - appending in place */
     int len;
     int olen;
     char *string;
@@ -317,25 +320,23 @@ add_proj4text (struct epsg_defs *p, int count, const char *text)
 	  p->proj4text = malloc (len + 1);
 	  if (p->proj4text == NULL)
 	      return;
-	  strcpy (p->proj4text, text);
+	  memcpy (p->proj4text, text, len + 1);
 	  return;
       }
     if (p->proj4text == NULL)
 	return;
     olen = strlen (p->proj4text);
-    string = malloc (len + olen + 1);
+    string = realloc (p->proj4text, olen + len + 1);
     if (string == NULL)
 	return;
-    strcpy (string, p->proj4text);
-    free (p->proj4text);
+    memcpy (string + olen, text, len + 1);
     p->proj4text = string;
-    strcat (p->proj4text, text);
 }
 
 SPATIALITE_PRIVATE void
 add_srs_wkt (struct epsg_defs *p, int count, const char *text)
 {
-/* creating the SRS_WKT string */
+/* creating the SRS_WKT string - appending in place */
     int len;
     int olen;
     char *string;
@@ -347,19 +348,17 @@ add_srs_wkt (struct epsg_defs *p, int count, const char *text)
 	  p->srs_wkt = malloc (len + 1);
 	  if (p->srs_wkt == NULL)
 	      return;
-	  strcpy (p->srs_wkt, text);
+	  memcpy (p->srs_wkt, text, len + 1);
 	  return;
       }
     if (p->srs_wkt == NULL)
 	return;
     olen = strlen (p->srs_wkt);
-    string = malloc (len + olen + 1);
+    string = realloc (p->srs_wkt, olen + len + 1);
     if (string == NULL)
 	return;
-    strcpy (string, p->srs_wkt);
-    free (p->srs_wkt);
+    memcpy (string + olen, text, len + 1);
     p->srs_wkt = string;
-    strcat (p->srs_wkt, text);
 }
 
 SPATIALITE_PRIVATE void
@@ -415,183 +414,181 @@ create_spatial_ref_sys_aux (sqlite3 * handle)
 }
 
 static int
-populate_spatial_ref_sys (sqlite3 * handle, int mode)
+prepare_epsg_stmts (sqlite3 * handle, sqlite3_stmt ** stmt,
+		    sqlite3_stmt ** stmt_aux)
 {
-/* populating the EPSG dataset into the SPATIAL_REF_SYS table */
-    struct epsg_defs *first = NULL;
-    struct epsg_defs *last = NULL;
-    struct epsg_defs *p;
+/* preparing the SQL parameterized statements (main and aux) */
     char sql[1024];
     int ret;
-    sqlite3_stmt *stmt = NULL;
-    sqlite3_stmt *stmt_aux = NULL;
-    int ok_aux;
 
-/* initializing the EPSG defs list */
-    initialize_epsg (mode, &first, &last);
-
-    create_spatial_ref_sys_aux (handle);
-/* preparing the SQL parameterized statement (main) */
+    *stmt = NULL;
+    *stmt_aux = NULL;
     strcpy (sql, "INSERT INTO spatial_ref_sys ");
     strcat (sql,
 	    "(srid, auth_name, auth_srid, ref_sys_name, proj4text, srtext) ");
     strcat (sql, "VALUES (?, ?, ?, ?, ?, ?)");
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), stmt, NULL);
     if (ret != SQLITE_OK)
       {
 	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
-	  goto error;
+	  return 0;
       }
-/* preparing the SQL parameterized statement (aux) */
     strcpy (sql, "INSERT INTO spatial_ref_sys_aux ");
     strcat (sql,
 	    "(srid, is_geographic, has_flipped_axes, spheroid, prime_meridian, ");
     strcat (sql, "datum, projection, unit, axis_1_name, axis_1_orientation, ");
     strcat (sql, "axis_2_name, axis_2_orientation) ");
     strcat (sql, "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_aux, NULL);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), stmt_aux, NULL);
     if (ret != SQLITE_OK)
       {
 	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
-	  goto error;
+	  sqlite3_finalize (*stmt);
+	  *stmt = NULL;
+	  return 0;
       }
+    return 1;
+}
 
-    p = first;
-    while (p)
+static void
+bind_epsg_aux_text (sqlite3_stmt * stmt_aux, int pos, const char *value,
+		    int *ok_aux)
+{
+/* binding an optional SPATIAL_REF_SYS_AUX text value */
+    if (value == NULL)
+	sqlite3_bind_null (stmt_aux, pos);
+    else
       {
-	  if (p->auth_name == NULL)
-	      break;
-	  /* inserting into SPATIAL_REF_SYS */
-	  sqlite3_reset (stmt);
-	  sqlite3_clear_bindings (stmt);
-	  sqlite3_bind_int (stmt, 1, p->srid);
-	  sqlite3_bind_text (stmt, 2, p->auth_name, strlen (p->auth_name),
-			     SQLITE_STATIC);
-	  sqlite3_bind_int (stmt, 3, p->auth_srid);
-	  sqlite3_bind_text (stmt, 4, p->ref_sys_name, strlen (p->ref_sys_name),
-			     SQLITE_STATIC);
-	  sqlite3_bind_text (stmt, 5, p->proj4text, strlen (p->proj4text),
+	  sqlite3_bind_text (stmt_aux, pos, value, strlen (value),
 			     SQLITE_STATIC);
-	  if (strlen (p->srs_wkt) == 0)
-	      sqlite3_bind_text (stmt, 6, "Undefined", 9, SQLITE_STATIC);
-	  else
-	      sqlite3_bind_text (stmt, 6, p->srs_wkt, strlen (p->srs_wkt),
-				 SQLITE_STATIC);
-	  ret = sqlite3_step (stmt);
+	  *ok_aux = 1;
+      }
+}
+
+static int
+insert_epsg_def (sqlite3 * handle, sqlite3_stmt * stmt,
+		 sqlite3_stmt * stmt_aux, struct epsg_defs *p)
+{
+/* inserting a single EPSG def into SPATIAL_REF_SYS and SPATIAL_REF_SYS_AUX */
+    int ret;
+    int ok_aux = 0;
+
+/* inserting into SPATIAL_REF_SYS */
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    sqlite3_bind_int (stmt, 1, p->srid);
+    sqlite3_bind_text (stmt, 2, p->auth_name, strlen (p->auth_name),
+		       SQLITE_STATIC);
+    sqlite3_bind_int (stmt, 3, p->auth_srid);
+    sqlite3_bind_text (stmt, 4, p->ref_sys_name, strlen (p->ref_sys_name),
+		       SQLITE_STATIC);
+    sqlite3_bind_text (stmt, 5, p->proj4text, strlen (p->proj4text),
+		       SQLITE_STATIC);
+    if (strlen (p->srs_wkt) == 0)
+	sqlite3_bind_text (stmt, 6, "Undefined", 9, SQLITE_STATIC);
+    else
+	sqlite3_bind_text (stmt, 6, p->srs_wkt, strlen (p->srs_wkt),
+			   SQLITE_STATIC);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+	;
+    else
+      {
+	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
+	  return 0;
+      }
+
+/* inserting into SPATIAL_REF_SYS_AUX */
+    sqlite3_reset (stmt_aux);
+    sqlite3_clear_bindings (stmt_aux);
+    sqlite3_bind_int (stmt_aux, 1, p->srid);
+    if (p->is_geographic < 0)
+	sqlite3_bind_null (stmt_aux, 2);
+    else
+      {
+	  sqlite3_bind_int (stmt_aux, 2, p->is_geographic);
+	  ok_aux = 1;
+      }
+    if (p->flipped_axes < 0)
+	sqlite3_bind_null (stmt_aux, 3);
+    else
+      {
+	  sqlite3_bind_int (stmt_aux, 3, p->flipped_axes);
+	  ok_aux = 1;
+      }
+    bind_epsg_aux_text (stmt_aux, 4, p->spheroid, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 5, p->prime_meridian, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 6, p->datum, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 7, p->projection, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 8, p->unit, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 9, p->axis_1, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 10, p->orientation_1, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 11, p->axis_2, &ok_aux);
+    bind_epsg_aux_text (stmt_aux, 12, p->orientation_2, &ok_aux);
+    if (ok_aux)
+      {
+	  ret = sqlite3_step (stmt_aux);
 	  if (ret == SQLITE_DONE || ret == SQLITE_ROW)
 	      ;
 	  else
 	    {
 		spatialite_e ("%s\n", sqlite3_errmsg (handle));
-		goto error;
+		return 0;
 	    }
+      }
+    return 1;
+}
 
-	  /* inserting into SPATIAL_REF_SYS_AUX */
-	  ok_aux = 0;
-	  sqlite3_reset (stmt_aux);
-	  sqlite3_clear_bindings (stmt_aux);
-	  sqlite3_bind_int (stmt_aux, 1, p->srid);
-	  if (p->is_geographic < 0)
-	      sqlite3_bind_null (stmt_aux, 2);
-	  else
-	    {
-		sqlite3_bind_int (stmt_aux, 2, p->is_geographic);
-		ok_aux = 1;
-	    }
-	  if (p->flipped_axes < 0)
-	      sqlite3_bind_null (stmt_aux, 3);
-	  else
-	    {
-		sqlite3_bind_int (stmt_aux, 3, p->flipped_axes);
-		ok_aux = 1;
-	    }
-	  if (p->spheroid == NULL)
-	      sqlite3_bind_null (stmt_aux, 4);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 4, p->spheroid,
-				   strlen (p->spheroid), SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->prime_meridian == NULL)
-	      sqlite3_bind_null (stmt_aux, 5);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 5, p->prime_meridian,
-				   strlen (p->prime_meridian), SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->datum == NULL)
-	      sqlite3_bind_null (stmt_aux, 6);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 6, p->datum, strlen (p->datum),
-				   SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->projection == NULL)
-	      sqlite3_bind_null (stmt_aux, 7);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 7, p->projection,
-				   strlen (p->projection), SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->unit == NULL)
-	      sqlite3_bind_null (stmt_aux, 8);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 8, p->unit, strlen (p->unit),
-				   SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->axis_1 == NULL)
-	      sqlite3_bind_null (stmt_aux, 9);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 9, p->axis_1, strlen (p->axis_1),
-				   SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->orientation_1 == NULL)
-	      sqlite3_bind_null (stmt_aux, 10);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 10, p->orientation_1,
-				   strlen (p->orientation_1), SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->axis_2 == NULL)
-	      sqlite3_bind_null (stmt_aux, 11);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 11, p->axis_2, strlen (p->axis_2),
-				   SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (p->orientation_2 == NULL)
-	      sqlite3_bind_null (stmt_aux, 12);
-	  else
-	    {
-		sqlite3_bind_text (stmt_aux, 12, p->orientation_2,
-				   strlen (p->orientation_2), SQLITE_STATIC);
-		ok_aux = 1;
-	    }
-	  if (ok_aux)
-	    {
-		ret = sqlite3_step (stmt_aux);
-		if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-		    ;
-		else
-		  {
-		      spatialite_e ("%s\n", sqlite3_errmsg (handle));
-		      goto error;
-		  }
-	    }
+static int
+populate_spatial_ref_sys (sqlite3 * handle, int mode)
+{
+/* populating the EPSG dataset into the SPATIAL_REF_SYS table */
+    struct epsg_defs *first = NULL;
+    struct epsg_defs *last = NULL;
+    struct epsg_defs *p;
+    sqlite3_stmt *stmt = NULL;
+    sqlite3_stmt *stmt_aux = NULL;
+    int savepoint = 0;
+
+/* initializing the EPSG defs list */
+    initialize_epsg (mode, &first, &last);
+
+    create_spatial_ref_sys_aux (handle);
+    if (!prepare_epsg_stmts (handle, &stmt, &stmt_aux))
+	goto error;
+
+/* 
+/ all the EPSG defs will be inserted within a single SAVEPOINT,
+/ so to avoid paying a journal commit for each row when the caller
+/ is running in autocommit mode
+*/
+    if (sqlite3_exec (handle, "SAVEPOINT epsg_init", NULL, NULL, NULL) !=
+	SQLITE_OK)
+      {
+	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
+	  goto error;
+      }
+    savepoint = 1;
+
+    p = first;
+    while (p)
+      {
+	  if (p->auth_name == NULL)
+	      break;
+	  if (!insert_epsg_def (handle, stmt, stmt_aux, p))
+	      goto error;
 	  p = p->next;
       }
     sqlite3_finalize (stmt);
     sqlite3_finalize (stmt_aux);
+    stmt = NULL;
+    stmt_aux = NULL;
+    if (sqlite3_exec (handle, "RELEASE SAVEPOINT epsg_init", NULL, NULL, NULL)
+	!= SQLITE_OK)
+      {
+	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
+	  goto error;
+      }
 
 /* freeing the EPSG defs list */
     free_epsg (first);
@@ -602,6 +599,13 @@ populate_spatial_ref_sys (sqlite3 * handle, int mode)
 	sqlite3_finalize (stmt);
     if (stmt_aux)
 	sqlite3_finalize (stmt_aux);
+    if (savepoint)
+      {
+	  sqlite3_exec (handle, "ROLLBACK TO SAVEPOINT epsg_init", NULL, NULL,
+			NULL);
+	  sqlite3_exec (handle, "RELEASE SAVEPOINT epsg_init", NULL, NULL,
+			NULL);
+      }
 /* freeing the EPSG defs list */
     free_epsg (first);
 
@@ -768,12 +772,19 @@ spatial_ref_sys_init2 (sqlite3 * handle, int mode, int verbose)
 	  return 0;
       }
     if (mode == GAIA_EPSG_ANY || mode == GAIA_EPSG_NONE
-	|| mode == GAIA_EPSG_WGS84_ONLY)
+	|| mode == GAIA_EPSG_WGS84_ONLY || mode == GAIA_EPSG_LAZY)
 	;
     else
 	mode = GAIA_EPSG_ANY;
-    if (populate_spatial_ref_sys (handle, mode))
+    if (populate_spatial_ref_sys
+	(handle, (mode == GAIA_EPSG_LAZY) ? GAIA_EPSG_WGS84_ONLY : mode))
       {
+	  if (mode == GAIA_EPSG_LAZY)
+	    {
+		/* marking SPATIAL_REF_SYS as lazily populated */
+		updateSpatiaLiteHistory (handle, "spatial_ref_sys", NULL,
+					 SRS_LAZY_EVENT);
+	    }
 	  if (verbose && mode != GAIA_EPSG_NONE)
 	      spatialite_e
 		  ("OK: the SPATIAL_REF_SYS table was successfully populated\n");
@@ -782,18 +793,87 @@ spatial_ref_sys_init2 (sqlite3 * handle, int mode, int verbose)
     return 0;
 }
 
+static int
+is_lazy_spatial_ref_sys (sqlite3 * handle)
+{
+/* checking if SPATIAL_REF_SYS was initialized in LAZY mode */
+    int ret;
+    int lazy = 0;
+    sqlite3_stmt *stmt = NULL;
+    const char *sql = "SELECT Count(*) FROM spatialite_history "
+	"WHERE table_name = 'spatial_ref_sys' AND event = ?";
+
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_text (stmt, 1, SRS_LAZY_EVENT, strlen (SRS_LAZY_EVENT),
+		       SQLITE_STATIC);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	    {
+		if (sqlite3_column_int (stmt, 0) > 0)
+		    lazy = 1;
+	    }
+	  else
+	      break;
+      }
+    sqlite3_finalize (stmt);
+    return lazy;
+}
+
+static int
+exists_srid (sqlite3 * handle, int srid)
+{
+/* checking if some SRID is already defined in SPATIAL_REF_SYS */
+    int ret;
+    int found = 0;
+    sqlite3_stmt *stmt = NULL;
+    const char *sql = "SELECT srid FROM spatial_ref_sys WHERE srid = ?";
+
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+    sqlite3_bind_int (stmt, 1, srid);
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+	found = 1;
+    sqlite3_finalize (stmt);
+    return found;
+}
+
+SPATIALITE_PRIVATE int
+lazy_insert_epsg_srid (void *p_sqlite, int srid)
+{
+/* 
+/ on-demand insertion of some EPSG definition into SPATIAL_REF_SYS
+/ [only if SPATIAL_REF_SYS was initialized in LAZY mode]
+/
+/ returns 1 if the SRID was inserted, 0 otherwise
+*/
+    sqlite3 *handle = (sqlite3 *) p_sqlite;
+    if (srid <= 0)
+	return 0;
+    if (!is_lazy_spatial_ref_sys (handle))
+	return 0;
+    if (exists_srid (handle, srid))
+	return 0;
+    return insert_epsg_srid (handle, srid);
+}
+
 SPATIALITE_DECLARE int
 insert_epsg_srid (sqlite3 * handle, int srid)
 {
 /* inserting a single EPSG definition into the SPATIAL_REF_SYS table */
     struct epsg_defs *first = NULL;
     struct epsg_defs *last = NULL;
-    char sql[1024];
-    int ret;
     int error = 0;
     sqlite3_stmt *stmt = NULL;
     sqlite3_stmt *stmt_aux = NULL;
-    int ok_aux;
 
     if (!exists_spatial_ref_sys (handle))
       {
@@ -817,161 +897,14 @@ insert_epsg_srid (sqlite3 * handle, int srid)
       }
 
     create_spatial_ref_sys_aux (handle);
-/* preparing the SQL parameterized statement */
-    strcpy (sql, "INSERT INTO spatial_ref_sys ");
-    strcat (sql,
-	    "(srid, auth_name, auth_srid, ref_sys_name, proj4text, srtext) ");
-    strcat (sql, "VALUES (?, ?, ?, ?, ?, ?)");
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt, NULL);
-    if (ret != SQLITE_OK)
-      {
-	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
-	  error = 1;
-	  goto stop;
-      }
-/* preparing the SQL parameterized statement (aux) */
-    strcpy (sql, "INSERT INTO spatial_ref_sys_aux ");
-    strcat (sql,
-	    "(srid, is_geographic, has_flipped_axes, spheroid, prime_meridian, ");
-    strcat (sql, "datum, projection, unit, axis_1_name, axis_1_orientation, ");
-    strcat (sql, "axis_2_name, axis_2_orientation) ");
-    strcat (sql, "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
-    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_aux, NULL);
-    if (ret != SQLITE_OK)
-      {
-	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
-	  error = 1;
-	  goto stop;
-      }
-
-    /* inserting into SPATIAL_REF_SYS_AUX */
-    sqlite3_reset (stmt);
-    sqlite3_clear_bindings (stmt);
-    sqlite3_bind_int (stmt, 1, first->srid);
-    sqlite3_bind_text (stmt, 2, first->auth_name, strlen (first->auth_name),
-		       SQLITE_STATIC);
-    sqlite3_bind_int (stmt, 3, first->auth_srid);
-    sqlite3_bind_text (stmt, 4, first->ref_sys_name,
-		       strlen (first->ref_sys_name), SQLITE_STATIC);
-    sqlite3_bind_text (stmt, 5, first->proj4text, strlen (first->proj4text),
-		       SQLITE_STATIC);
-    if (strlen (first->srs_wkt) == 0)
-	sqlite3_bind_text (stmt, 6, "Undefined", 9, SQLITE_STATIC);
-    else
-	sqlite3_bind_text (stmt, 6, first->srs_wkt, strlen (first->srs_wkt),
-			   SQLITE_STATIC);
-    ret = sqlite3_step (stmt);
-    if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-	;
-    else
+    if (!prepare_epsg_stmts (handle, &stmt, &stmt_aux))
       {
-	  spatialite_e ("%s\n", sqlite3_errmsg (handle));
 	  error = 1;
 	  goto stop;
       }
+    if (!insert_epsg_def (handle, stmt, stmt_aux, first))
+	error = 1;
 
-    /* inserting into SPATIAL_REF_SYS_AUX */
-    ok_aux = 0;
-    sqlite3_reset (stmt_aux);
-    sqlite3_clear_bindings (stmt_aux);
-    sqlite3_bind_int (stmt_aux, 1, first->srid);
-    if (first->is_geographic < 0)
-	sqlite3_bind_null (stmt_aux, 2);
-    else
-      {
-	  sqlite3_bind_int (stmt_aux, 2, first->is_geographic);
-	  ok_aux = 1;
-      }
-    if (first->flipped_axes < 0)
-	sqlite3_bind_null (stmt_aux, 3);
-    else
-      {
-	  sqlite3_bind_int (stmt_aux, 3, first->flipped_axes);
-	  ok_aux = 1;
-      }
-    if (first->spheroid == NULL)
-	sqlite3_bind_null (stmt_aux, 4);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 4, first->spheroid,
-			     strlen (first->spheroid), SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->prime_meridian == NULL)
-	sqlite3_bind_null (stmt_aux, 5);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 5, first->prime_meridian,
-			     strlen (first->prime_meridian), SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->datum == NULL)
-	sqlite3_bind_null (stmt_aux, 6);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 6, first->datum, strlen (first->datum),
-			     SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->projection == NULL)
-	sqlite3_bind_null (stmt_aux, 7);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 7, first->projection,
-			     strlen (first->projection), SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->unit == NULL)
-	sqlite3_bind_null (stmt_aux, 8);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 8, first->unit, strlen (first->unit),
-			     SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->axis_1 == NULL)
-	sqlite3_bind_null (stmt_aux, 9);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 9, first->axis_1, strlen (first->axis_1),
-			     SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->orientation_1 == NULL)
-	sqlite3_bind_null (stmt_aux, 10);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 10, first->orientation_1,
-			     strlen (first->orientation_1), SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->axis_2 == NULL)
-	sqlite3_bind_null (stmt_aux, 11);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 11, first->axis_2,
-			     strlen (first->axis_2), SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (first->orientation_2 == NULL)
-	sqlite3_bind_null (stmt_aux, 11);
-    else
-      {
-	  sqlite3_bind_text (stmt_aux, 11, first->orientation_2,
-			     strlen (first->orientation_2), SQLITE_STATIC);
-	  ok_aux = 1;
-      }
-    if (ok_aux)
-      {
-	  ret = sqlite3_step (stmt_aux);
-	  if (ret == SQLITE_DONE || ret == SQLITE_ROW)
-	      ;
-	  else
-	    {
-		spatialite_e ("%s\n", sqlite3_errmsg (handle));
-		goto stop;
-	    }
-      }
   stop:
     if (stmt != NULL)
 	sqlite3_finalize (stmt);
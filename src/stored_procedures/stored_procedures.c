@@ -1448,6 +1448,7 @@ gaia_stored_proc_delete (sqlite3 * handle, const void *cache, const char *name)
     sqlite3_finalize (stmt);
     if (sqlite3_changes (handle) == 0)
 	return 0;
+    gaia_stored_proc_reset_compiled (cache, name);
     return 1;
 }
 
@@ -1535,6 +1536,7 @@ gaia_stored_proc_update_sql (sqlite3 * handle, const void *cache,
     sqlite3_finalize (stmt);
     if (sqlite3_changes (handle) == 0)
 	return 0;
+    gaia_stored_proc_reset_compiled (cache, name);
     return 1;
 }
 
@@ -2241,3 +2243,1115 @@ gaia_sql_proc_logfile (const void *ctx, const char *filepath, int append)
     cache->SqlProcLog = log;
     return 1;
 }
+
+/*
+/ compiled Stored Procedures
+/
+/ the Raw SQL Body of a Stored Procedure is split into its individual
+/ statements only once, and the outcome is kept in the connection cache
+/ keyed by the Stored Procedure name.
+/ when the current Value of a Variable is a plain SQL literal (NULL, a
+/ number or a quoted string) and the statement is a SELECT/DML one, the
+/ Variable will be replaced by a numbered SQL parameter and its Value
+/ will be bound at execution time; any other Value will be textually
+/ replaced exactly as gaia_sql_proc_cooked_sql() does.
+*/
+
+#define SP_QUOTE_NONE		0
+#define SP_QUOTE_SINGLE		1
+#define SP_QUOTE_DOUBLE		2
+#define SP_QUOTE_BRACKET	3
+#define SP_QUOTE_BACKTICK	4
+#define SP_QUOTE_LINE		5
+#define SP_QUOTE_BLOCK_START	6
+#define SP_QUOTE_BLOCK		7
+#define SP_QUOTE_BLOCK_END	8
+
+struct sp_compiled_stmt
+{
+/* a single statement of a compiled Stored Procedure */
+    char *raw;			/* the Raw SQL statement */
+    int bindable;		/* TRUE if literal Values could be bound */
+    char *expanded;		/* the SQL text the statement was prepared from */
+    int variables;		/* number of Variable references */
+    int textual;		/* TRUE if some Value was replaced as text */
+    int *types;			/* literal types the statement was prepared for */
+    int n_types;
+    sqlite3_stmt *stmt;		/* the prepared statement */
+    struct sp_compiled_stmt *next;
+};
+
+struct sp_compiled_proc
+{
+/* a compiled Stored Procedure */
+    char *name;
+    unsigned char *blob;
+    int blob_sz;
+    int busy;			/* TRUE while being executed */
+    int stale;			/* TRUE if invalidated while being executed */
+    struct sp_compiled_stmt *first;
+    struct sp_compiled_stmt *last;
+    struct sp_compiled_proc *next;
+};
+
+struct sp_bound_value
+{
+/* a Variable Value resolved for a single execution */
+    char *varname;
+    char *value;		/* the textual replacement Value */
+    int type;			/* the literal type; 0 if not a literal */
+    sqlite3_int64 int_value;
+    double dbl_value;
+    char *txt_value;		/* unquoted TEXT literal */
+};
+
+struct sp_bound_values
+{
+/* the list of Variable Values resolved for a single execution */
+    struct sp_bound_value *values;
+    int count;
+    int alloc;
+};
+
+struct sp_text_buffer
+{
+/* a dynamically growing text buffer */
+    char *buf;
+    int len;
+    int alloc;
+};
+
+static void
+sp_text_append (struct sp_text_buffer *out, const char *str, int len)
+{
+/* appending some text into a dynamic buffer */
+    if (out->len + len + 1 > out->alloc)
+      {
+	  int sz = out->alloc * 2;
+	  if (sz < out->len + len + 1)
+	      sz = out->len + len + 1024;
+	  out->buf = realloc (out->buf, sz);
+	  out->alloc = sz;
+      }
+    memcpy (out->buf + out->len, str, len);
+    out->len += len;
+    *(out->buf + out->len) = '\0';
+}
+
+static int
+sp_quote_state (int state, const char *p)
+{
+/* updating the quoting state after consuming the current char */
+    char c = *p;
+    switch (state)
+      {
+      case SP_QUOTE_NONE:
+	  if (c == '\'')
+	      return SP_QUOTE_SINGLE;
+	  if (c == '"')
+	      return SP_QUOTE_DOUBLE;
+	  if (c == '[')
+	      return SP_QUOTE_BRACKET;
+	  if (c == '`')
+	      return SP_QUOTE_BACKTICK;
+	  if (c == '-' && *(p + 1) == '-')
+	      return SP_QUOTE_LINE;
+	  if (c == '/' && *(p + 1) == '*')
+	      return SP_QUOTE_BLOCK_START;
+	  break;
+      case SP_QUOTE_SINGLE:
+	  if (c == '\'')
+	      return SP_QUOTE_NONE;
+	  break;
+      case SP_QUOTE_DOUBLE:
+	  if (c == '"')
+	      return SP_QUOTE_NONE;
+	  break;
+      case SP_QUOTE_BRACKET:
+	  if (c == ']')
+	      return SP_QUOTE_NONE;
+	  break;
+      case SP_QUOTE_BACKTICK:
+	  if (c == '`')
+	      return SP_QUOTE_NONE;
+	  break;
+      case SP_QUOTE_LINE:
+	  if (c == '\n')
+	      return SP_QUOTE_NONE;
+	  break;
+      case SP_QUOTE_BLOCK_START:
+	  return SP_QUOTE_BLOCK;
+      case SP_QUOTE_BLOCK:
+	  if (c == '*' && *(p + 1) == '/')
+	      return SP_QUOTE_BLOCK_END;
+	  break;
+      case SP_QUOTE_BLOCK_END:
+	  return SP_QUOTE_NONE;
+      };
+    return state;
+}
+
+static int
+sp_is_bindable_stmt (const char *raw)
+{
+/* testing if a Raw SQL statement could safely accept bound Values */
+    const char *p = raw;
+    char word[16];
+    int len = 0;
+    int state = SP_QUOTE_NONE;
+    while (*p != '\0' && len < 15)
+      {
+	  char c = *p;
+	  if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+	      word[len++] = c;
+	  else
+	      break;
+	  p++;
+      }
+    word[len] = '\0';
+    if (strcasecmp (word, "SELECT") != 0 && strcasecmp (word, "INSERT") != 0
+	&& strcasecmp (word, "UPDATE") != 0 && strcasecmp (word, "DELETE") != 0
+	&& strcasecmp (word, "REPLACE") != 0 && strcasecmp (word, "WITH") != 0
+	&& strcasecmp (word, "VALUES") != 0)
+	return 0;
+
+/* explicit SQL parameters would clash with the numbered ones */
+    for (p = raw; *p != '\0'; p++)
+      {
+	  if (state == SP_QUOTE_NONE && (*p == '?' || *p == ':'))
+	      return 0;
+	  state = sp_quote_state (state, p);
+      }
+    return 1;
+}
+
+static void
+sp_free_compiled_stmt (struct sp_compiled_stmt *stmt)
+{
+/* destroying a compiled statement */
+    if (stmt == NULL)
+	return;
+    if (stmt->stmt != NULL)
+	sqlite3_finalize (stmt->stmt);
+    if (stmt->expanded != NULL)
+	free (stmt->expanded);
+    if (stmt->types != NULL)
+	free (stmt->types);
+    if (stmt->raw != NULL)
+	free (stmt->raw);
+    free (stmt);
+}
+
+static void
+sp_release_compiled_stmts (struct sp_compiled_proc *proc)
+{
+/* finalizing all prepared statements of a compiled Stored Procedure */
+    struct sp_compiled_stmt *stmt = proc->first;
+    while (stmt != NULL)
+      {
+	  if (stmt->stmt != NULL)
+	      sqlite3_finalize (stmt->stmt);
+	  stmt->stmt = NULL;
+	  if (stmt->expanded != NULL)
+	      free (stmt->expanded);
+	  stmt->expanded = NULL;
+	  if (stmt->types != NULL)
+	      free (stmt->types);
+	  stmt->types = NULL;
+	  stmt->n_types = 0;
+	  stmt = stmt->next;
+      }
+}
+
+static void
+sp_free_compiled_proc (struct sp_compiled_proc *proc)
+{
+/* destroying a compiled Stored Procedure */
+    struct sp_compiled_stmt *stmt;
+    struct sp_compiled_stmt *nstmt;
+    if (proc == NULL)
+	return;
+    stmt = proc->first;
+    while (stmt != NULL)
+      {
+	  nstmt = stmt->next;
+	  sp_free_compiled_stmt (stmt);
+	  stmt = nstmt;
+      }
+    if (proc->name != NULL)
+	free (proc->name);
+    if (proc->blob != NULL)
+	free (proc->blob);
+    free (proc);
+}
+
+static void
+sp_unlink_compiled_proc (struct splite_internal_cache *cache,
+			 struct sp_compiled_proc *proc)
+{
+/* removing a compiled Stored Procedure from the connection cache */
+    struct sp_compiled_proc *prev = NULL;
+    struct sp_compiled_proc *p = cache->SqlProcCompiled;
+    while (p != NULL)
+      {
+	  if (p == proc)
+	    {
+		if (prev == NULL)
+		    cache->SqlProcCompiled = p->next;
+		else
+		    prev->next = p->next;
+		break;
+	    }
+	  prev = p;
+	  p = p->next;
+      }
+    sp_free_compiled_proc (proc);
+}
+
+static struct sp_compiled_proc *
+sp_compile_proc (const char *name, const unsigned char *blob, int blob_sz)
+{
+/* splitting the Raw SQL Body into individual statements */
+    struct sp_compiled_proc *proc;
+    char *raw;
+    const char *p;
+    int len;
+
+    raw = gaia_sql_proc_raw_sql (blob, blob_sz);
+    if (raw == NULL)
+	return NULL;
+    if (strlen (raw) == 0)
+      {
+	  free (raw);
+	  return NULL;
+      }
+
+    proc = malloc (sizeof (struct sp_compiled_proc));
+    len = strlen (name);
+    proc->name = malloc (len + 1);
+    strcpy (proc->name, name);
+    proc->blob = malloc (blob_sz);
+    memcpy (proc->blob, blob, blob_sz);
+    proc->blob_sz = blob_sz;
+    proc->busy = 0;
+    proc->stale = 0;
+    proc->first = NULL;
+    proc->last = NULL;
+    proc->next = NULL;
+
+    p = raw;
+    while (1)
+      {
+	  struct sp_compiled_stmt *stmt;
+	  const char *end;
+	  char *sql;
+	  p = consume_empty_sql (p);
+	  if (*p == '\0')
+	      break;
+	  end = p + strlen (p);
+	  len = 0;
+	  while (*(p + len) != '\0')
+	    {
+		/* searching for the end of the current statement */
+		if (*(p + len) == ';')
+		  {
+		      char *candidate = malloc (len + 2);
+		      int complete;
+		      memcpy (candidate, p, len + 1);
+		      *(candidate + len + 1) = '\0';
+		      complete = sqlite3_complete (candidate);
+		      free (candidate);
+		      if (complete)
+			{
+			    end = p + len + 1;
+			    break;
+			}
+		  }
+		len++;
+	    }
+	  len = end - p;
+	  sql = malloc (len + 1);
+	  memcpy (sql, p, len);
+	  *(sql + len) = '\0';
+	  p = end;
+	  stmt = malloc (sizeof (struct sp_compiled_stmt));
+	  stmt->raw = sql;
+	  stmt->bindable = sp_is_bindable_stmt (sql);
+	  stmt->expanded = NULL;
+	  stmt->variables = 0;
+	  stmt->textual = 0;
+	  stmt->types = NULL;
+	  stmt->n_types = 0;
+	  stmt->stmt = NULL;
+	  stmt->next = NULL;
+	  if (proc->first == NULL)
+	      proc->first = stmt;
+	  if (proc->last != NULL)
+	      proc->last->next = stmt;
+	  proc->last = stmt;
+      }
+    free (raw);
+    return proc;
+}
+
+static void
+sp_classify_value (struct sp_bound_value *value)
+{
+/* checking if a replacement Value is a plain SQL literal */
+    const char *p = value->value;
+    int len = strlen (p);
+    int digits = 0;
+    int dot = 0;
+    int exp = 0;
+    int i;
+
+    value->type = 0;
+    if (strcasecmp (p, "NULL") == 0)
+      {
+	  value->type = SQLITE_NULL;
+	  return;
+      }
+    if (len >= 2 && *p == '\'' && *(p + len - 1) == '\'')
+      {
+	  /* could be a quoted TEXT string */
+	  char *out;
+	  for (i = 1; i < len - 1; i++)
+	    {
+		if (*(p + i) == '\'')
+		  {
+		      if (i < len - 2 && *(p + i + 1) == '\'')
+			  i++;
+		      else
+			  return;	/* not a single literal */
+		  }
+	    }
+	  value->txt_value = malloc (len);
+	  out = value->txt_value;
+	  for (i = 1; i < len - 1; i++)
+	    {
+		*out++ = *(p + i);
+		if (*(p + i) == '\'')
+		    i++;
+	    }
+	  *out = '\0';
+	  value->type = SQLITE_TEXT;
+	  return;
+      }
+
+/* could be an unsigned number */
+    for (i = 0; i < len; i++)
+      {
+	  char c = *(p + i);
+	  if (c >= '0' && c <= '9')
+	    {
+		if (!exp)
+		    digits++;
+		continue;
+	    }
+	  if (c == '.' && !dot && !exp)
+	    {
+		dot = 1;
+		continue;
+	    }
+	  if ((c == 'e' || c == 'E') && digits > 0 && !exp && i < len - 1)
+	    {
+		exp = 1;
+		if (*(p + i + 1) == '+' || *(p + i + 1) == '-')
+		    i++;
+		if (i == len - 1)
+		    return;
+		continue;
+	    }
+	  return;
+      }
+    if (digits == 0)
+	return;
+    if (!dot && !exp)
+      {
+	  if (digits > 18)
+	      return;		/* may overflow a 64 bit integer */
+	  value->int_value = atoll (p);
+	  value->type = SQLITE_INTEGER;
+	  return;
+      }
+    value->dbl_value = atof (p);
+    value->type = SQLITE_FLOAT;
+}
+
+static int
+sp_add_bound_value (struct sp_bound_values *list, const char *varname,
+		    const char *value)
+{
+/* adding a resolved Variable Value into the list */
+    struct sp_bound_value *item;
+    int len;
+    if (list->count >= list->alloc)
+      {
+	  list->alloc += 16;
+	  list->values =
+	      realloc (list->values,
+		       sizeof (struct sp_bound_value) * list->alloc);
+      }
+    item = list->values + list->count;
+    len = strlen (varname);
+    item->varname = malloc (len + 1);
+    strcpy (item->varname, varname);
+    len = strlen (value);
+    item->value = malloc (len + 1);
+    strcpy (item->value, value);
+    item->txt_value = NULL;
+    sp_classify_value (item);
+    list->count += 1;
+    return list->count - 1;
+}
+
+static void
+sp_free_bound_values (struct sp_bound_values *list)
+{
+/* destroying a list of resolved Variable Values */
+    int i;
+    for (i = 0; i < list->count; i++)
+      {
+	  struct sp_bound_value *item = list->values + i;
+	  free (item->varname);
+	  free (item->value);
+	  if (item->txt_value != NULL)
+	      free (item->txt_value);
+      }
+    if (list->values != NULL)
+	free (list->values);
+    list->values = NULL;
+    list->count = 0;
+    list->alloc = 0;
+}
+
+static int
+sp_resolve_value (sqlite3 * handle, sqlite3_stmt * stmt,
+		  SqlProc_VarListPtr variables, struct sp_bound_values *list,
+		  const char *varname)
+{
+/* resolving a Variable Value; returns its index in the list */
+    const char *replacement_value;
+    char *stored_var = NULL;
+    int i;
+    int ret;
+    for (i = 0; i < list->count; i++)
+      {
+	  if (strcmp ((list->values + i)->varname, varname) == 0)
+	      return i;
+      }
+
+    replacement_value = search_replacement_value (variables, varname);
+    if (replacement_value == NULL)
+      {
+	  /* attempting to get a Stored Variable */
+	  if (stmt == NULL)
+	      stored_var = search_stored_var (handle, varname);
+	  else
+	    {
+		sqlite3_reset (stmt);
+		sqlite3_clear_bindings (stmt);
+		sqlite3_bind_text (stmt, 1, varname, strlen (varname),
+				   SQLITE_STATIC);
+		while (1)
+		  {
+		      /* scrolling the result set rows */
+		      ret = sqlite3_step (stmt);
+		      if (ret == SQLITE_ROW)
+			{
+			    if (sqlite3_column_type (stmt, 0) == SQLITE_TEXT
+				&& stored_var == NULL)
+				stored_var =
+				    sqlite3_mprintf ("%s",
+						     (const char *)
+						     sqlite3_column_text (stmt,
+									  0));
+			}
+		      else
+			  break;
+		  }
+		sqlite3_reset (stmt);
+	    }
+	  replacement_value = stored_var;
+      }
+    if (replacement_value == NULL)
+	replacement_value = "NULL";
+    i = sp_add_bound_value (list, varname, replacement_value);
+    if (stored_var != NULL)
+	sqlite3_free (stored_var);
+    return i;
+}
+
+static void
+sp_end_word (char *word, int *word_len, char *prev_word, int *order_by)
+{
+/* a keyword or identifier ends here */
+    if (*word_len == 0)
+	return;
+    *(word + *word_len) = '\0';
+    if (strcasecmp (word, "BY") == 0
+	&& (strcasecmp (prev_word, "ORDER") == 0
+	    || strcasecmp (prev_word, "GROUP") == 0))
+	*order_by = 1;
+    strcpy (prev_word, word);
+    *word_len = 0;
+}
+
+static char *
+sp_expand_stmt (sqlite3 * handle, const char *raw,
+		SqlProc_VarListPtr variables, struct sp_bound_values *list,
+		int bind, int *references, int *textual)
+{
+/* 
+/ replacing all Variables within a single Raw SQL statement
+/ (adopting the same rules of gaia_sql_proc_cooked_sql)
+/
+/ on completion *references will contain the number of Variables found
+/ and *textual will be TRUE if some Value was replaced as text
+*/
+    int len = strlen (raw);
+    int i;
+    int start_line = 1;
+    int macro = 0;
+    int comment = 0;
+    int variable = 0;
+    char varMark = '\0';
+    int varStart = 0;
+    int state = SP_QUOTE_NONE;
+    char word[16];
+    char prev_word[16];
+    int word_len = 0;
+    int order_by = 0;
+    struct sp_text_buffer out;
+
+    out.alloc = len + 1024;
+    out.buf = malloc (out.alloc);
+    out.len = 0;
+    *(out.buf) = '\0';
+    *prev_word = '\0';
+    *references = 0;
+    *textual = 0;
+
+    for (i = 0; i < len; i++)
+      {
+	  char c = raw[i];
+	  if (c == '\n')
+	    {
+		/* EndOfLine found */
+		macro = 0;
+		comment = 0;
+		variable = 0;
+		start_line = 1;
+		sp_end_word (word, &word_len, prev_word, &order_by);
+		state = sp_quote_state (state, raw + i);
+		sp_text_append (&out, raw + i, 1);
+		continue;
+	    }
+	  if (start_line && (c == ' ' || c == '\t'))
+	    {
+		/* skipping leading blanks */
+		sp_end_word (word, &word_len, prev_word, &order_by);
+		state = sp_quote_state (state, raw + i);
+		sp_text_append (&out, raw + i, 1);
+		continue;
+	    }
+	  if (start_line && c == '.')
+	      macro = 1;
+	  if (start_line && c == '-')
+	    {
+		if (i < len - 1)
+		  {
+		      if (raw[i + 1] == '-')
+			  comment = 1;
+		  }
+	    }
+	  start_line = 0;
+	  if (macro || comment)
+	    {
+		state = sp_quote_state (state, raw + i);
+		sp_text_append (&out, raw + i, 1);
+		continue;
+	    }
+	  if (c == '@' || c == '$')
+	    {
+		if (variable && c == varMark)
+		  {
+		      /* a variable name ends here */
+		      int sz = i - varStart;
+		      int j;
+		      int k;
+		      int idx;
+		      struct sp_bound_value *value;
+		      char *varname = malloc (sz);
+		      for (k = 0, j = varStart + 1; j < i; j++, k++)
+			  *(varname + k) = raw[j];
+		      *(varname + k) = '\0';
+		      idx = sp_resolve_value (handle, NULL, variables, list,
+					      varname);
+		      free (varname);
+		      value = list->values + idx;
+		      *references += 1;
+		      sp_end_word (word, &word_len, prev_word, &order_by);
+		      if (bind && state == SP_QUOTE_NONE && value->type != 0
+			  && !(value->type == SQLITE_INTEGER && order_by))
+			{
+			    /* replacing by a numbered SQL parameter */
+			    char param[32];
+			    sprintf (param, "?%d ", idx + 1);
+			    sp_text_append (&out, param, strlen (param));
+			}
+		      else
+			{
+			    sp_text_append (&out, value->value,
+					    strlen (value->value));
+			    *textual = 1;
+			}
+		      variable = 0;
+		  }
+		else
+		  {
+		      /* a variable name may start here */
+		      variable = 1;
+		      varMark = c;
+		      varStart = i;
+		  }
+		continue;
+	    }
+	  if (!variable)
+	    {
+		if (state == SP_QUOTE_NONE
+		    && ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+			|| (c >= '0' && c <= '9') || c == '_'))
+		  {
+		      if (word_len < 15)
+			  word[word_len++] = c;
+		  }
+		else
+		    sp_end_word (word, &word_len, prev_word, &order_by);
+		state = sp_quote_state (state, raw + i);
+		sp_text_append (&out, raw + i, 1);
+	    }
+      }
+    return out.buf;
+}
+
+static int
+sp_can_reuse_stmt (struct sp_compiled_stmt *cs, struct sp_bound_values *list)
+{
+/* 
+/ checking if an already prepared statement can be reused as it is
+/ without expanding its Raw SQL again: this is safe when no Value was
+/ replaced as text and all literal Values still have the same types
+*/
+    int i;
+    if (cs->stmt == NULL || cs->textual)
+	return 0;
+    if (cs->variables == 0)
+	return 1;
+    if (cs->n_types != list->count)
+	return 0;
+    for (i = 0; i < list->count; i++)
+      {
+	  if (cs->types[i] != list->values[i].type)
+	      return 0;
+      }
+    return 1;
+}
+
+static void
+sp_save_types (struct sp_compiled_stmt *cs, struct sp_bound_values *list)
+{
+/* saving the literal types a statement has been prepared for */
+    int i;
+    if (cs->types != NULL)
+	free (cs->types);
+    cs->types = NULL;
+    cs->n_types = list->count;
+    if (list->count == 0)
+	return;
+    cs->types = malloc (sizeof (int) * list->count);
+    for (i = 0; i < list->count; i++)
+	cs->types[i] = list->values[i].type;
+}
+
+static void
+sp_bind_values (sqlite3_stmt * stmt, struct sp_bound_values *list)
+{
+/* binding all literal Values to a prepared statement */
+    int n_params = sqlite3_bind_parameter_count (stmt);
+    int i;
+    sqlite3_reset (stmt);
+    sqlite3_clear_bindings (stmt);
+    for (i = 0; i < list->count && i < n_params; i++)
+      {
+	  struct sp_bound_value *value = list->values + i;
+	  switch (value->type)
+	    {
+	    case SQLITE_INTEGER:
+		sqlite3_bind_int64 (stmt, i + 1, value->int_value);
+		break;
+	    case SQLITE_FLOAT:
+		sqlite3_bind_double (stmt, i + 1, value->dbl_value);
+		break;
+	    case SQLITE_TEXT:
+		sqlite3_bind_text (stmt, i + 1, value->txt_value,
+				   strlen (value->txt_value), SQLITE_STATIC);
+		break;
+	    default:
+		sqlite3_bind_null (stmt, i + 1);
+		break;
+	    };
+      }
+}
+
+static int
+sp_has_more_stmts (sqlite3 * handle, const char *tail)
+{
+/* testing if some further SQL statement follows the current one */
+    const char *p = tail;
+    while (1)
+      {
+	  sqlite3_stmt *stmt = NULL;
+	  int ret;
+	  p = consume_empty_sql (p);
+	  if (*p == '\0')
+	      return 0;
+	  ret = sqlite3_prepare_v2 (handle, p, strlen (p), &stmt, &p);
+	  if (ret != SQLITE_OK)
+	      return 1;
+	  if (stmt != NULL)
+	    {
+		sqlite3_finalize (stmt);
+		return 1;
+	    }
+      }
+}
+
+static int
+sp_execute_multi (sqlite3 * handle, struct splite_internal_cache *cache,
+		  const char *sql)
+{
+/* 
+/ executing an expanded statement containing many SQL statements
+/ (some Variable Value was itself a sequence of statements)
+*/
+    const char *p = sql;
+    while (1)
+      {
+	  sqlite3_stmt *stmt = NULL;
+	  int ret;
+	  if (cache->SqlProcContinue == 0)
+	      break;		/* found a pending EXIT request */
+	  p = consume_empty_sql (p);
+	  if (*p == '\0')
+	      break;
+	  ret = sqlite3_prepare_v2 (handle, p, strlen (p), &stmt, &p);
+	  if (ret != SQLITE_OK)
+	      goto error;
+	  if (stmt == NULL)
+	      continue;		/* empty statement (just comments) */
+	  while (1)
+	    {
+		/* executing an SQL statement */
+		ret = sqlite3_step (stmt);
+		if (ret == SQLITE_DONE)
+		    break;
+		else if (ret == SQLITE_ROW)
+		    continue;
+		else
+		  {
+		      sqlite3_finalize (stmt);
+		      goto error;
+		  }
+	    }
+	  sqlite3_finalize (stmt);
+      }
+    return 1;
+
+  error:
+    {
+	char *errmsg = sqlite3_mprintf ("gaia_sql_proc_execute: %s",
+					sqlite3_errmsg (handle));
+	gaia_sql_proc_set_error (cache, errmsg);
+	sqlite3_free (errmsg);
+    }
+    return 0;
+}
+
+static int
+sp_execute_classic (sqlite3 * handle, const void *cache,
+		    const unsigned char *blob, int blob_sz,
+		    SqlProc_VarListPtr variables)
+{
+/* executing a Stored Procedure by fully cooking its SQL Body */
+    char *sql;
+    int ret;
+    if (!gaia_sql_proc_cooked_sql
+	(handle, cache, blob, blob_sz, variables, &sql))
+	return -1;
+    ret = gaia_sql_proc_execute (handle, cache, sql);
+    free (sql);
+    return ret;
+}
+
+SQLPROC_DECLARE int
+gaia_stored_proc_execute_compiled (sqlite3 * handle, const void *ctx,
+				   const char *name,
+				   const unsigned char *blob, int blob_sz,
+				   SqlProc_VarListPtr variables)
+{
+/* executing a permanently registered Stored Procedure via its compiled form */
+    struct splite_internal_cache *cache = (struct splite_internal_cache *) ctx;
+    struct sp_compiled_proc *proc;
+    struct sp_compiled_stmt *cs;
+    struct sp_bound_values list;
+    struct sp_var_list *var_list = NULL;
+    struct sp_var_item *item;
+    sqlite3_stmt *stmt_var = NULL;
+    const char *sql;
+    int ret;
+    int retval = 0;
+
+    if (cache == NULL || name == NULL)
+	return sp_execute_classic (handle, cache, blob, blob_sz, variables);
+    if (cache->SqlProcLog != NULL)
+      {
+	  /* the Logfile expects the classic execution */
+	  return sp_execute_classic (handle, cache, blob, blob_sz, variables);
+      }
+
+    proc = cache->SqlProcCompiled;
+    while (proc != NULL)
+      {
+	  if (strcmp (proc->name, name) == 0)
+	      break;
+	  proc = proc->next;
+      }
+    if (proc != NULL && proc->busy)
+      {
+	  /* recursive invocation */
+	  return sp_execute_classic (handle, cache, blob, blob_sz, variables);
+      }
+    if (proc != NULL
+	&& (proc->blob_sz != blob_sz
+	    || memcmp (proc->blob, blob, blob_sz) != 0))
+      {
+	  /* the SQL Body has changed since it was compiled */
+	  sp_unlink_compiled_proc (cache, proc);
+	  proc = NULL;
+      }
+
+    stored_proc_reset_error (cache);
+    if (variables == NULL)
+      {
+	  const char *errmsg = "NULL Variables List (Arguments)\n";
+	  gaia_sql_proc_set_error (cache, errmsg);
+	  return -1;
+      }
+    if (proc == NULL)
+      {
+	  proc = sp_compile_proc (name, blob, blob_sz);
+	  if (proc == NULL)
+	    {
+		const char *errmsg = "Empty Raw SQL body\n";
+		gaia_sql_proc_set_error (cache, errmsg);
+		return -1;
+	    }
+	  proc->next = cache->SqlProcCompiled;
+	  cache->SqlProcCompiled = proc;
+      }
+
+/* resolving all Variable Values before executing anything */
+    list.values = NULL;
+    list.count = 0;
+    list.alloc = 0;
+    var_list = build_var_list (blob, blob_sz);
+    if (var_list == NULL)
+      {
+	  const char *errmsg = "NULL Variables List (Raw SQL)\n";
+	  gaia_sql_proc_set_error (cache, errmsg);
+	  return -1;
+      }
+    sql = "SELECT value FROM stored_variables WHERE name = ?";
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_var, NULL);
+    if (ret != SQLITE_OK)
+	stmt_var = NULL;
+    item = var_list->first;
+    while (item != NULL)
+      {
+	  sp_resolve_value (handle, stmt_var, variables, &list, item->varname);
+	  item = item->next;
+      }
+    if (stmt_var != NULL)
+	sqlite3_finalize (stmt_var);
+    free_var_list (var_list);
+
+    proc->busy = 1;
+    cache->SqlProcContinue = 1;
+    cs = proc->first;
+    while (cs != NULL)
+      {
+	  char *expanded;
+	  int references;
+	  int textual;
+	  if (cache->SqlProcContinue == 0)
+	      break;		/* found a pending EXIT request */
+	  expanded = NULL;
+	  if (!sp_can_reuse_stmt (cs, &list))
+	      expanded =
+		  sp_expand_stmt (handle, cs->raw, variables, &list,
+				  cs->bindable, &references, &textual);
+	  if (expanded == NULL)
+	      ;			/* reusing the already prepared statement as it is */
+	  else if (cs->stmt != NULL && cs->expanded != NULL
+		   && strcmp (cs->expanded, expanded) == 0)
+	    {
+		/* reusing the already prepared statement */
+		free (expanded);
+		cs->variables = references;
+		cs->textual = textual;
+		sp_save_types (cs, &list);
+	    }
+	  else
+	    {
+		sqlite3_stmt *stmt = NULL;
+		const char *tail = NULL;
+		if (cs->stmt != NULL)
+		    sqlite3_finalize (cs->stmt);
+		cs->stmt = NULL;
+		if (cs->expanded != NULL)
+		    free (cs->expanded);
+		cs->expanded = NULL;
+		ret =
+		    sqlite3_prepare_v2 (handle, expanded, strlen (expanded),
+					&stmt, &tail);
+		if (ret != SQLITE_OK && cs->bindable)
+		  {
+		      /* falling back to plain textual replacement */
+		      free (expanded);
+		      expanded =
+			  sp_expand_stmt (handle, cs->raw, variables, &list, 0,
+					  &references, &textual);
+		      ret =
+			  sqlite3_prepare_v2 (handle, expanded,
+					      strlen (expanded), &stmt, &tail);
+		  }
+		if (ret != SQLITE_OK)
+		  {
+		      free (expanded);
+		      goto stop;
+		  }
+		if (sp_has_more_stmts (handle, tail))
+		  {
+		      /* 
+		       / the expanded Variables produced many statements:
+		       / executing all of them (never cached)
+		       */
+		      int ok;
+		      if (stmt != NULL)
+			  sqlite3_finalize (stmt);
+		      free (expanded);
+		      expanded =
+			  sp_expand_stmt (handle, cs->raw, variables, &list, 0,
+					  &references, &textual);
+		      ok = sp_execute_multi (handle, cache, expanded);
+		      free (expanded);
+		      if (!ok)
+			  goto stop;
+		      cs = cs->next;
+		      continue;
+		  }
+		cs->stmt = stmt;
+		cs->expanded = expanded;
+		cs->variables = references;
+		cs->textual = textual;
+		sp_save_types (cs, &list);
+	    }
+	  if (cs->stmt == NULL)
+	    {
+		/* empty statement (just comments) */
+		cs = cs->next;
+		continue;
+	    }
+	  sp_bind_values (cs->stmt, &list);
+	  while (1)
+	    {
+		/* executing an SQL statement */
+		ret = sqlite3_step (cs->stmt);
+		if (ret == SQLITE_DONE)
+		    break;
+		else if (ret == SQLITE_ROW)
+		    continue;
+		else
+		  {
+		      char *errmsg =
+			  sqlite3_mprintf ("gaia_sql_proc_execute: %s",
+					   sqlite3_errmsg (handle));
+		      gaia_sql_proc_set_error (cache, errmsg);
+		      sqlite3_free (errmsg);
+		      sqlite3_reset (cs->stmt);
+		      goto stop;
+		  }
+	    }
+	  sqlite3_reset (cs->stmt);
+	  sqlite3_clear_bindings (cs->stmt);
+	  cs = cs->next;
+      }
+    retval = 1;
+
+  stop:
+    proc->busy = 0;
+    if (proc->stale)
+	sp_unlink_compiled_proc (cache, proc);
+    else if (!cache->SqlProcStmtCache)
+	sp_release_compiled_stmts (proc);
+    sp_free_bound_values (&list);
+    return retval;
+}
+
+SQLPROC_DECLARE void
+gaia_stored_proc_reset_compiled (const void *ctx, const char *name)
+{
+/* discarding compiled Stored Procedures */
+    struct splite_internal_cache *cache = (struct splite_internal_cache *) ctx;
+    struct sp_compiled_proc *proc;
+    struct sp_compiled_proc *nproc;
+    if (cache == NULL)
+	return;
+
+    proc = cache->SqlProcCompiled;
+    while (proc != NULL)
+      {
+	  nproc = proc->next;
+	  if (name == NULL || strcmp (proc->name, name) == 0)
+	    {
+		if (proc->busy)
+		    proc->stale = 1;	/* will be discarded later */
+		else
+		    sp_unlink_compiled_proc (cache, proc);
+	    }
+	  proc = nproc;
+      }
+}
+
+SQLPROC_DECLARE void
+gaia_stored_proc_set_stmt_cache (const void *ctx, int mode)
+{
+/* enabling/disabling the retention of prepared statements */
+    struct splite_internal_cache *cache = (struct splite_internal_cache *) ctx;
+    struct sp_compiled_proc *proc;
+    if (cache == NULL)
+	return;
+
+    cache->SqlProcStmtCache = mode ? 1 : 0;
+    if (cache->SqlProcStmtCache)
+	return;
+    proc = cache->SqlProcCompiled;
+    while (proc != NULL)
+      {
+	  /* releasing all retained statements */
+	  if (!proc->busy)
+	      sp_release_compiled_stmts (proc);
+	  proc = proc->next;
+      }
+}
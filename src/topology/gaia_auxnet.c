@@ -1254,6 +1254,8 @@ gaiaNetworkFromDBMS (sqlite3 * handle, const void *p_cache,
     ptr->spatial = 0;
     ptr->allow_coincident = 0;
     ptr->last_error_message = NULL;
+    ptr->origin_handle = NULL;
+    ptr->origin_cache = NULL;
     ptr->lwn_iface = lwn_CreateBackendIface (ctx, (const LWN_BE_DATA *) ptr);
     ptr->prev = cache->lastNetwork;
     ptr->next = NULL;
@@ -1347,6 +1349,209 @@ gaiaNetworkDestroy (GaiaNetworkAccessorPtr net_ptr)
 	cache->lastNetwork = prev;
 }
 
+static const char *net_node_columns[] = { "node_id", "geometry" };
+static const char *net_link_columns[] =
+    { "link_id", "start_node", "end_node", "geometry" };
+
+static int
+do_copy_net_next_ids (sqlite3 * from, sqlite3 * to, const char *network_name,
+		      int raise_only)
+{
+/* aligning both next_node_id and next_link_id */
+    char *sql;
+    int ret;
+    sqlite3_int64 next_node_id;
+    sqlite3_int64 next_link_id;
+
+    sql = sqlite3_mprintf ("SELECT next_node_id FROM MAIN.networks "
+			   "WHERE Lower(network_name) = Lower(%Q)",
+			   network_name);
+    next_node_id = auxtopo_get_sequence (from, sql);
+    sqlite3_free (sql);
+    if (next_node_id < 0)
+	return 0;
+    sql = sqlite3_mprintf ("SELECT next_link_id FROM MAIN.networks "
+			   "WHERE Lower(network_name) = Lower(%Q)",
+			   network_name);
+    next_link_id = auxtopo_get_sequence (from, sql);
+    sqlite3_free (sql);
+    if (next_link_id < 0)
+	return 0;
+    if (raise_only)
+	sql =
+	    sqlite3_mprintf ("UPDATE MAIN.networks SET next_node_id = "
+			     "Max(next_node_id, %lld), next_link_id = "
+			     "Max(next_link_id, %lld) WHERE "
+			     "Lower(network_name) = Lower(%Q)", next_node_id,
+			     next_link_id, network_name);
+    else
+	sql =
+	    sqlite3_mprintf ("UPDATE MAIN.networks SET next_node_id = %lld, "
+			     "next_link_id = %lld WHERE Lower(network_name) = "
+			     "Lower(%Q)", next_node_id, next_link_id,
+			     network_name);
+    ret = sqlite3_exec (to, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    return 1;
+}
+
+GAIANET_DECLARE GaiaNetworkAccessorPtr
+gaiaNetworkMemoryCreate (GaiaNetworkAccessorPtr accessor)
+{
+/* creating a memory-resident replica of some Network */
+    struct gaia_network *net = (struct gaia_network *) accessor;
+    struct gaia_network *mem;
+    sqlite3 *mem_db = NULL;
+    void *mem_cache = NULL;
+    char *msg;
+    GaiaNetworkAccessorPtr mem_accessor;
+
+    if (net == NULL)
+	return NULL;
+    if (net->origin_handle != NULL)
+	return NULL;            /* already a memory replica */
+
+/* creating an in-memory DB */
+    if (!auxtopo_open_replica (net->db_handle, net->srid, &mem_db, &mem_cache))
+      {
+	  gaianet_set_last_error_msg (accessor,
+				      "TopoNet in-memory replica error: "
+				      "unable to create the in-memory DB");
+	  return NULL;
+      }
+
+/* creating the Network replica */
+    if (!gaiaNetworkCreate
+	(mem_db, net->network_name, net->spatial, net->srid, net->has_z,
+	 net->allow_coincident))
+	goto error;
+    if (!do_copy_net_next_ids (net->db_handle, mem_db, net->network_name, 0))
+	goto error;
+
+/* copying Nodes and Links */
+    if (!auxtopo_copy_rows
+	(net->db_handle, mem_db, net->network_name, "node", net_node_columns,
+	 2))
+	goto error;
+    if (!auxtopo_copy_rows
+	(net->db_handle, mem_db, net->network_name, "link", net_link_columns,
+	 4))
+	goto error;
+    if (!auxtopo_copy_sequence
+	(net->db_handle, mem_db, net->network_name, "node"))
+	goto error;
+    if (!auxtopo_copy_sequence
+	(net->db_handle, mem_db, net->network_name, "link"))
+	goto error;
+
+/* creating the Network Accessor for the replica */
+    mem_accessor = gaiaNetworkFromDBMS (mem_db, mem_cache, net->network_name);
+    if (mem_accessor == NULL)
+	goto error;
+    mem = (struct gaia_network *) mem_accessor;
+    mem->origin_handle = net->db_handle;
+    mem->origin_cache = net->cache;
+    return mem_accessor;
+
+  error:
+    msg = sqlite3_mprintf ("TopoNet in-memory replica error: \"%s\"",
+			   sqlite3_errmsg (mem_db));
+    gaianet_set_last_error_msg (accessor, msg);
+    sqlite3_free (msg);
+    auxtopo_close_reader (mem_db, mem_cache);
+    return NULL;
+}
+
+GAIANET_DECLARE int
+gaiaNetworkMemoryFlush (GaiaNetworkAccessorPtr accessor)
+{
+/* writing back a memory-resident Network into its own DB */
+    struct gaia_network *net = (struct gaia_network *) accessor;
+    char *msg;
+
+    if (net == NULL)
+	return 0;
+    if (net->origin_handle == NULL)
+	return 0;               /* not a memory replica */
+
+/* inserting or updating all Nodes and Links */
+    if (!auxtopo_copy_rows
+	(net->db_handle, net->origin_handle, net->network_name, "node",
+	 net_node_columns, 2))
+	goto error;
+    if (!auxtopo_copy_rows
+	(net->db_handle, net->origin_handle, net->network_name, "link",
+	 net_link_columns, 4))
+	goto error;
+
+/* removing any vanished Link or Node */
+    if (!auxtopo_purge_rows
+	(net->db_handle, net->origin_handle, net->network_name, "link",
+	 "link_id"))
+	goto error;
+    if (!auxtopo_purge_rows
+	(net->db_handle, net->origin_handle, net->network_name, "node",
+	 "node_id"))
+	goto error;
+
+/* updating the AUTOINCREMENT sequences of Nodes and Links */
+    if (!auxtopo_copy_sequence
+	(net->db_handle, net->origin_handle, net->network_name, "node"))
+	goto error;
+    if (!auxtopo_copy_sequence
+	(net->db_handle, net->origin_handle, net->network_name, "link"))
+	goto error;
+
+/* updating the next Node and Link IDs */
+    if (!do_copy_net_next_ids
+	(net->db_handle, net->origin_handle, net->network_name, 1))
+	goto error;
+    return 1;
+
+  error:
+    msg = sqlite3_mprintf ("TopoNet in-memory flush error: \"%s\"",
+			   sqlite3_errmsg (net->origin_handle));
+    gaianet_set_last_error_msg (accessor, msg);
+    sqlite3_free (msg);
+    return 0;
+}
+
+GAIANET_DECLARE void
+gaiaNetworkMemoryDestroy (GaiaNetworkAccessorPtr accessor)
+{
+/* destroying a memory-resident Network replica */
+    struct gaia_network *net = (struct gaia_network *) accessor;
+    struct gaia_network *origin;
+    sqlite3 *mem_db;
+    void *mem_cache;
+    const char *msg;
+
+    if (net == NULL)
+	return;
+    if (net->origin_handle == NULL)
+	return;                 /* not a memory replica */
+    mem_db = net->db_handle;
+    mem_cache = (void *) (net->cache);
+
+/* forwarding any pending error message to the main Network */
+    msg = lwn_GetErrorMsg (net->lwn_iface);
+    if (msg == NULL)
+	msg = net->last_error_message;
+    origin =
+	(struct gaia_network *) gaiaNetworkFromCache (net->origin_cache,
+						      net->network_name);
+    if (msg != NULL && origin != NULL)
+      {
+	  lwn_SetErrorMsg (origin->lwn_iface, msg);
+	  gaianet_set_last_error_msg ((GaiaNetworkAccessorPtr) origin, msg);
+      }
+
+    gaiaNetworkDestroy (accessor);
+    auxtopo_close_reader (mem_db, mem_cache);
+}
+
 NETWORK_PRIVATE void
 finalize_toponet_prepared_stmts (GaiaNetworkAccessorPtr accessor)
 {
@@ -2032,56 +2237,6 @@ do_loginet_check_links (GaiaNetworkAccessorPtr accessor, sqlite3_stmt * stmt)
     return 0;
 }
 
-GAIANET_DECLARE int
-gaiaValidLogicalNet (GaiaNetworkAccessorPtr accessor)
-{
-/* generating a validity report for a given Logical Network */
-    char *table;
-    char *xtable;
-    char *sql;
-    int ret;
-    sqlite3_stmt *stmt = NULL;
-    struct gaia_network *net = (struct gaia_network *) accessor;
-    if (net == NULL)
-	return 0;
-
-    if (!do_check_create_valid_logicalnet_table (accessor))
-	return 0;
-
-    table = sqlite3_mprintf ("%s_valid_logicalnet", net->network_name);
-    xtable = gaiaDoubleQuotedSql (table);
-    sqlite3_free (table);
-    sql =
-	sqlite3_mprintf
-	("INSERT INTO TEMP.\"%s\" (error, primitive1, primitive2) VALUES (?, ?, ?)",
-	 xtable);
-    free (xtable);
-    ret = sqlite3_prepare_v2 (net->db_handle, sql, strlen (sql), &stmt, NULL);
-    sqlite3_free (sql);
-    if (ret != SQLITE_OK)
-      {
-	  char *msg = sqlite3_mprintf ("ST_ValidLogicalNet error: \"%s\"",
-				       sqlite3_errmsg (net->db_handle));
-	  gaianet_set_last_error_msg (accessor, msg);
-	  sqlite3_free (msg);
-	  goto error;
-      }
-
-    if (!do_loginet_check_nodes (accessor, stmt))
-	goto error;
-
-    if (!do_loginet_check_links (accessor, stmt))
-	goto error;
-
-    sqlite3_finalize (stmt);
-    return 1;
-
-  error:
-    if (stmt != NULL)
-	sqlite3_finalize (stmt);
-    return 0;
-}
-
 static int
 do_check_create_valid_spatialnet_table (GaiaNetworkAccessorPtr accessor)
 {
@@ -2489,23 +2644,39 @@ do_spatnet_check_end_nodes (GaiaNetworkAccessorPtr accessor,
     return 0;
 }
 
-GAIANET_DECLARE int
-gaiaValidSpatialNet (GaiaNetworkAccessorPtr accessor)
+struct net_validate_job
 {
-/* generating a validity report for a given Spatial Network */
+/* a struct wrapping a single Network validation check */
+    sqlite3 *handle;
+    void *cache;
+    GaiaNetworkAccessorPtr accessor;
+    int spatial;
+    int status;
+};
+
+static sqlite3_stmt *
+do_prepare_valid_net (GaiaNetworkAccessorPtr accessor, int spatial)
+{
+/* creating the target table and preparing the INSERT statement */
     char *table;
     char *xtable;
     char *sql;
     int ret;
     sqlite3_stmt *stmt = NULL;
     struct gaia_network *net = (struct gaia_network *) accessor;
-    if (net == NULL)
-	return 0;
-
-    if (!do_check_create_valid_spatialnet_table (accessor))
-	return 0;
 
-    table = sqlite3_mprintf ("%s_valid_spatialnet", net->network_name);
+    if (spatial)
+      {
+	  if (!do_check_create_valid_spatialnet_table (accessor))
+	      return NULL;
+	  table = sqlite3_mprintf ("%s_valid_spatialnet", net->network_name);
+      }
+    else
+      {
+	  if (!do_check_create_valid_logicalnet_table (accessor))
+	      return NULL;
+	  table = sqlite3_mprintf ("%s_valid_logicalnet", net->network_name);
+      }
     xtable = gaiaDoubleQuotedSql (table);
     sqlite3_free (table);
     sql =
@@ -2517,24 +2688,183 @@ gaiaValidSpatialNet (GaiaNetworkAccessorPtr accessor)
     sqlite3_free (sql);
     if (ret != SQLITE_OK)
       {
-	  char *msg = sqlite3_mprintf ("ST_ValidSpatialNet error: \"%s\"",
+	  char *msg = sqlite3_mprintf ("%s error: \"%s\"",
+				       spatial ? "ST_ValidSpatialNet" :
+				       "ST_ValidLogicalNet",
 				       sqlite3_errmsg (net->db_handle));
 	  gaianet_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
-	  goto error;
+	  return NULL;
       }
+    return stmt;
+}
 
-    if (!do_spatnet_check_nodes (accessor, stmt))
-	goto error;
+static int
+do_net_validate_check (GaiaNetworkAccessorPtr accessor, sqlite3_stmt * stmt,
+		       int spatial, int check)
+{
+/* performing a single validation check */
+    if (!spatial)
+      {
+	  if (check == 0)
+	      return do_loginet_check_nodes (accessor, stmt);
+	  return do_loginet_check_links (accessor, stmt);
+      }
+    switch (check)
+      {
+      case 0:
+	  return do_spatnet_check_nodes (accessor, stmt);
+      case 1:
+	  return do_spatnet_check_links (accessor, stmt);
+      case 2:
+	  return do_spatnet_check_start_nodes (accessor, stmt);
+      };
+    return do_spatnet_check_end_nodes (accessor, stmt);
+}
 
-    if (!do_spatnet_check_links (accessor, stmt))
-	goto error;
+static void
+do_net_validate_job (void *data, int check)
+{
+/* performing a single validation check on its own connection */
+    struct net_validate_job *job = (struct net_validate_job *) data + check;
+    sqlite3_stmt *stmt = do_prepare_valid_net (job->accessor, job->spatial);
+    if (stmt == NULL)
+      {
+	  job->status = 0;
+	  return;
+      }
+    job->status =
+	do_net_validate_check (job->accessor, stmt, job->spatial, check);
+    sqlite3_finalize (stmt);
+}
 
-    if (!do_spatnet_check_start_nodes (accessor, stmt))
-	goto error;
+static int
+do_net_validate_parallel (GaiaNetworkAccessorPtr accessor, int spatial,
+			  int count, int num_threads,
+			  void (*progress_callback) (int, void *),
+			  void *callback_ptr)
+{
+/* performing all validation checks concurrently */
+    struct net_validate_job jobs[4];
+    struct gaia_network *net = (struct gaia_network *) accessor;
+    sqlite3_stmt *stmt = NULL;
+    char *table;
+    int i;
+    int ok = 1;
 
-    if (!do_spatnet_check_end_nodes (accessor, stmt))
-	goto error;
+/* opening a read-only connection for each check */
+    memset (jobs, 0, sizeof (jobs));
+    for (i = 0; i < count; i++)
+      {
+	  struct net_validate_job *job = jobs + i;
+	  job->spatial = spatial;
+	  if (!auxtopo_open_reader (net->db_handle, &(job->handle),
+				    &(job->cache)))
+	    {
+		ok = -1;
+		break;
+	    }
+	  job->accessor =
+	      gaiaNetworkFromDBMS (job->handle, job->cache,
+				   net->network_name);
+	  if (job->accessor == NULL)
+	    {
+		ok = -1;
+		break;
+	    }
+      }
+    if (ok < 0)
+	goto stop;
+
+    auxtopo_run_parallel (do_net_validate_job, jobs, count, num_threads,
+			  progress_callback, callback_ptr);
+
+/* merging all findings into the validation table */
+    stmt = do_prepare_valid_net (accessor, spatial);
+    if (stmt == NULL)
+      {
+	  ok = 0;
+	  goto stop;
+      }
+    if (spatial)
+	table = sqlite3_mprintf ("%s_valid_spatialnet", net->network_name);
+    else
+	table = sqlite3_mprintf ("%s_valid_logicalnet", net->network_name);
+    for (i = 0; i < count; i++)
+      {
+	  struct net_validate_job *job = jobs + i;
+	  if (!(job->status))
+	    {
+		struct gaia_network *worker =
+		    (struct gaia_network *) (job->accessor);
+		gaianet_set_last_error_msg (accessor,
+					    worker->last_error_message);
+		ok = 0;
+		break;
+	    }
+	  if (!auxtopo_copy_validation_report (job->handle, table, stmt))
+	    {
+		char *msg = sqlite3_mprintf ("%s error: \"%s\"",
+					     spatial ? "ST_ValidSpatialNet" :
+					     "ST_ValidLogicalNet",
+					     sqlite3_errmsg (net->db_handle));
+		gaianet_set_last_error_msg (accessor, msg);
+		sqlite3_free (msg);
+		ok = 0;
+		break;
+	    }
+      }
+    sqlite3_free (table);
+    sqlite3_finalize (stmt);
+
+  stop:
+    for (i = 0; i < count; i++)
+      {
+	  struct net_validate_job *job = jobs + i;
+	  if (job->accessor != NULL)
+	      gaiaNetworkDestroy (job->accessor);
+	  auxtopo_close_reader (job->handle, job->cache);
+      }
+    return ok;
+}
+
+static int
+do_net_validate (GaiaNetworkAccessorPtr accessor, int spatial,
+		 int num_threads, void (*progress_callback) (int, void *),
+		 void *callback_ptr)
+{
+/* generating a validity report for a given Network */
+    int i;
+    int count = spatial ? 4 : 2;
+    sqlite3_stmt *stmt = NULL;
+    struct gaia_network *net = (struct gaia_network *) accessor;
+    if (net == NULL)
+	return 0;
+
+    if (num_threads > 1)
+      {
+	  /* 
+	  / attempting to run all checks concurrently; falling back
+	  / to sequential mode when further connections can't be opened
+	  */
+	  int ret = do_net_validate_parallel (accessor, spatial, count,
+					      num_threads, progress_callback,
+					      callback_ptr);
+	  if (ret >= 0)
+	      return ret;
+      }
+
+    stmt = do_prepare_valid_net (accessor, spatial);
+    if (stmt == NULL)
+	return 0;
+
+    for (i = 0; i < count; i++)
+      {
+	  if (!do_net_validate_check (accessor, stmt, spatial, i))
+	      goto error;
+	  if (progress_callback != NULL)
+	      progress_callback (i + 1, callback_ptr);
+      }
 
     sqlite3_finalize (stmt);
     return 1;
@@ -2545,6 +2875,40 @@ gaiaValidSpatialNet (GaiaNetworkAccessorPtr accessor)
     return 0;
 }
 
+GAIANET_DECLARE int
+gaiaValidLogicalNet (GaiaNetworkAccessorPtr accessor)
+{
+/* generating a validity report for a given Logical Network */
+    return do_net_validate (accessor, 0, 1, NULL, NULL);
+}
+
+GAIANET_DECLARE int
+gaiaValidLogicalNetEx (GaiaNetworkAccessorPtr accessor, int num_threads,
+		       void (*progress_callback) (int, void *),
+		       void *callback_ptr)
+{
+/* generating a validity report for a given Logical Network - Extended mode */
+    return do_net_validate (accessor, 0, num_threads, progress_callback,
+			    callback_ptr);
+}
+
+GAIANET_DECLARE int
+gaiaValidSpatialNet (GaiaNetworkAccessorPtr accessor)
+{
+/* generating a validity report for a given Spatial Network */
+    return do_net_validate (accessor, 1, 1, NULL, NULL);
+}
+
+GAIANET_DECLARE int
+gaiaValidSpatialNetEx (GaiaNetworkAccessorPtr accessor, int num_threads,
+		       void (*progress_callback) (int, void *),
+		       void *callback_ptr)
+{
+/* generating a validity report for a given Spatial Network - Extended mode */
+    return do_net_validate (accessor, 1, num_threads, progress_callback,
+			    callback_ptr);
+}
+
 NETWORK_PRIVATE int
 auxnet_insert_into_network (GaiaNetworkAccessorPtr accessor,
 			    gaiaGeomCollPtr geom)
@@ -2688,13 +3052,23 @@ gaiaTopoNet_FromGeoTable (GaiaNetworkAccessorPtr accessor,
     char *xcolumn;
     int gpkg_amphibious = 0;
     int gpkg_mode = 0;
+    sqlite3 *sqlite;
+    const void *p_cache;
 
     if (net == NULL)
 	return 0;
-    if (net->cache != NULL)
+    sqlite = net->db_handle;
+    p_cache = net->cache;
+    if (net->origin_handle != NULL)
+      {
+	  /* memory-resident Network: reading from the main DB */
+	  sqlite = net->origin_handle;
+	  p_cache = net->origin_cache;
+      }
+    if (p_cache != NULL)
       {
 	  struct splite_internal_cache *cache =
-	      (struct splite_internal_cache *) (net->cache);
+	      (struct splite_internal_cache *) p_cache;
 	  gpkg_amphibious = cache->gpkg_amphibious_mode;
 	  gpkg_mode = cache->gpkg_mode;
       }
@@ -2709,12 +3083,12 @@ gaiaTopoNet_FromGeoTable (GaiaNetworkAccessorPtr accessor,
     free (xprefix);
     free (xtable);
     free (xcolumn);
-    ret = sqlite3_prepare_v2 (net->db_handle, sql, strlen (sql), &stmt, NULL);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
     sqlite3_free (sql);
     if (ret != SQLITE_OK)
       {
 	  char *msg = sqlite3_mprintf ("TopoNet_FromGeoTable error: \"%s\"",
-				       sqlite3_errmsg (net->db_handle));
+				       sqlite3_errmsg (sqlite));
 	  gaianet_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
 	  goto error;
@@ -2774,7 +3148,7 @@ gaiaTopoNet_FromGeoTable (GaiaNetworkAccessorPtr accessor,
 	    {
 		char *msg =
 		    sqlite3_mprintf ("TopoNet_FromGeoTable error: \"%s\"",
-				     sqlite3_errmsg (net->db_handle));
+				     sqlite3_errmsg (sqlite));
 		gaianet_set_last_error_msg (accessor, msg);
 		sqlite3_free (msg);
 		goto error;
@@ -78,6 +78,7 @@ CIG: 6038019AE5
 
 #include <spatialite.h>
 #include <spatialite_private.h>
+#include <splite_thread.h>
 
 #include <librttopo.h>
 
@@ -2181,6 +2182,8 @@ gaiaTopologyFromDBMS (sqlite3 * handle, const void *p_cache,
     ptr->tolerance = 0;
     ptr->has_z = 0;
     ptr->last_error_message = NULL;
+    ptr->origin_handle = NULL;
+    ptr->origin_cache = NULL;
     ptr->rtt_iface = rtt_CreateBackendIface (ctx, (const RTT_BE_DATA *) ptr);
     ptr->prev = cache->lastTopology;
     ptr->next = NULL;
@@ -2305,6 +2308,628 @@ gaiaTopologyDestroy (GaiaTopologyAccessorPtr topo_ptr)
 	cache->lastTopology = prev;
 }
 
+TOPOLOGY_PRIVATE void
+auxtopo_bind_value (sqlite3_stmt * stmt, int pos, sqlite3_stmt * stmt_in,
+		    int col)
+{
+/* binding a value exactly as it was read from some other statement */
+    switch (sqlite3_column_type (stmt_in, col))
+      {
+      case SQLITE_INTEGER:
+	  sqlite3_bind_int64 (stmt, pos, sqlite3_column_int64 (stmt_in, col));
+	  break;
+      case SQLITE_FLOAT:
+	  sqlite3_bind_double (stmt, pos,
+			       sqlite3_column_double (stmt_in, col));
+	  break;
+      case SQLITE_TEXT:
+	  sqlite3_bind_text (stmt, pos,
+			     (const char *) sqlite3_column_text (stmt_in,
+								 col),
+			     sqlite3_column_bytes (stmt_in, col),
+			     SQLITE_STATIC);
+	  break;
+      case SQLITE_BLOB:
+	  sqlite3_bind_blob (stmt, pos, sqlite3_column_blob (stmt_in, col),
+			     sqlite3_column_bytes (stmt_in, col),
+			     SQLITE_STATIC);
+	  break;
+      default:
+	  sqlite3_bind_null (stmt, pos);
+	  break;
+      };
+}
+
+TOPOLOGY_PRIVATE int
+auxtopo_copy_rows (sqlite3 * from, sqlite3 * to, const char *name,
+		   const char *suffix, const char **columns, int n_cols)
+{
+/* 
+/ copying all rows of a Topology (or Network) table from a connection
+/ to another; rows already existing on the target side will be updated
+/ only when some value has really changed, so that unaffected Edges,
+/ Nodes, Links and Faces never touch their Spatial Index
+*/
+    char *sql;
+    char *prev;
+    char *table;
+    char *xtable;
+    char *list;
+    char *values;
+    char *sets;
+    char *diffs;
+    int i;
+    int ret;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_ins = NULL;
+    sqlite3_stmt *stmt_upd = NULL;
+
+    list = sqlite3_mprintf ("%s", columns[0]);
+    values = sqlite3_mprintf ("?1");
+    sets = sqlite3_mprintf ("%s = ?2", columns[1]);
+    diffs = sqlite3_mprintf ("%s IS NOT ?2", columns[1]);
+    for (i = 1; i < n_cols; i++)
+      {
+	  prev = list;
+	  list = sqlite3_mprintf ("%s, %s", prev, columns[i]);
+	  sqlite3_free (prev);
+	  prev = values;
+	  values = sqlite3_mprintf ("%s, ?%d", prev, i + 1);
+	  sqlite3_free (prev);
+	  if (i == 1)
+	      continue;
+	  prev = sets;
+	  sets = sqlite3_mprintf ("%s, %s = ?%d", prev, columns[i], i + 1);
+	  sqlite3_free (prev);
+	  prev = diffs;
+	  diffs =
+	      sqlite3_mprintf ("%s OR %s IS NOT ?%d", prev, columns[i], i + 1);
+	  sqlite3_free (prev);
+      }
+    table = sqlite3_mprintf ("%s_%s", name, suffix);
+    xtable = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+
+    sql = sqlite3_mprintf ("SELECT %s FROM MAIN.\"%s\"", list, xtable);
+    ret = sqlite3_prepare_v2 (from, sql, strlen (sql), &stmt_in, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql =
+	sqlite3_mprintf ("INSERT OR IGNORE INTO MAIN.\"%s\" (%s) VALUES (%s)",
+			 xtable, list, values);
+    ret = sqlite3_prepare_v2 (to, sql, strlen (sql), &stmt_ins, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql =
+	sqlite3_mprintf ("UPDATE MAIN.\"%s\" SET %s WHERE %s = ?1 AND (%s)",
+			 xtable, sets, columns[0], diffs);
+    ret = sqlite3_prepare_v2 (to, sql, strlen (sql), &stmt_upd, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  sqlite3_reset (stmt_ins);
+	  sqlite3_clear_bindings (stmt_ins);
+	  for (i = 0; i < n_cols; i++)
+	      auxtopo_bind_value (stmt_ins, i + 1, stmt_in, i);
+	  ret = sqlite3_step (stmt_ins);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+	  if (sqlite3_changes (to) > 0)
+	      continue;
+	  /* already existing: updating */
+	  sqlite3_reset (stmt_upd);
+	  sqlite3_clear_bindings (stmt_upd);
+	  for (i = 0; i < n_cols; i++)
+	      auxtopo_bind_value (stmt_upd, i + 1, stmt_in, i);
+	  ret = sqlite3_step (stmt_upd);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_in);
+    sqlite3_finalize (stmt_ins);
+    sqlite3_finalize (stmt_upd);
+    sqlite3_free (list);
+    sqlite3_free (values);
+    sqlite3_free (sets);
+    sqlite3_free (diffs);
+    free (xtable);
+    return 1;
+
+  error:
+    spatialite_e ("in-memory copy (%s_%s) - error: %s\n", name, suffix,
+		  sqlite3_errmsg (to));
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_ins != NULL)
+	sqlite3_finalize (stmt_ins);
+    if (stmt_upd != NULL)
+	sqlite3_finalize (stmt_upd);
+    sqlite3_free (list);
+    sqlite3_free (values);
+    sqlite3_free (sets);
+    sqlite3_free (diffs);
+    free (xtable);
+    return 0;
+}
+
+TOPOLOGY_PRIVATE int
+auxtopo_purge_rows (sqlite3 * mem_db, sqlite3 * handle, const char *name,
+		    const char *suffix, const char *id_column)
+{
+/* removing from the DB all rows no longer existing in the memory replica */
+    char *sql;
+    char *table;
+    char *xtable;
+    int ret;
+    int i;
+    int count = 0;
+    int max = 0;
+    sqlite3_int64 *ids = NULL;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_mem = NULL;
+    sqlite3_stmt *stmt_del = NULL;
+
+    table = sqlite3_mprintf ("%s_%s", name, suffix);
+    xtable = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("SELECT %s FROM MAIN.\"%s\"", id_column, xtable);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_in, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql =
+	sqlite3_mprintf ("SELECT %s FROM MAIN.\"%s\" WHERE %s = ?",
+			 id_column, xtable, id_column);
+    ret = sqlite3_prepare_v2 (mem_db, sql, strlen (sql), &stmt_mem, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql =
+	sqlite3_mprintf ("DELETE FROM MAIN.\"%s\" WHERE %s = ?", xtable,
+			 id_column);
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_del, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* identifying all the vanished rows */
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  sqlite3_int64 id;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  id = sqlite3_column_int64 (stmt_in, 0);
+	  sqlite3_reset (stmt_mem);
+	  sqlite3_clear_bindings (stmt_mem);
+	  sqlite3_bind_int64 (stmt_mem, 1, id);
+	  ret = sqlite3_step (stmt_mem);
+	  if (ret == SQLITE_ROW)
+	      continue;
+	  if (ret != SQLITE_DONE)
+	      goto error;
+	  if (count >= max)
+	    {
+		max += 1024;
+		ids = realloc (ids, sizeof (sqlite3_int64) * max);
+	    }
+	  ids[count++] = id;
+      }
+
+/* deleting them */
+    for (i = 0; i < count; i++)
+      {
+	  sqlite3_reset (stmt_del);
+	  sqlite3_clear_bindings (stmt_del);
+	  sqlite3_bind_int64 (stmt_del, 1, ids[i]);
+	  ret = sqlite3_step (stmt_del);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_in);
+    sqlite3_finalize (stmt_mem);
+    sqlite3_finalize (stmt_del);
+    if (ids != NULL)
+	free (ids);
+    free (xtable);
+    return 1;
+
+  error:
+    spatialite_e ("in-memory flush (%s_%s) - error: %s\n", name, suffix,
+		  sqlite3_errmsg (handle));
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_mem != NULL)
+	sqlite3_finalize (stmt_mem);
+    if (stmt_del != NULL)
+	sqlite3_finalize (stmt_del);
+    if (ids != NULL)
+	free (ids);
+    free (xtable);
+    return 0;
+}
+
+TOPOLOGY_PRIVATE sqlite3_int64
+auxtopo_get_sequence (sqlite3 * handle, const char *sql)
+{
+/* retrieving a single ID value (sequence, next_edge_id, next_link_id) */
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    sqlite3_int64 value = -1;
+
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    if (ret != SQLITE_OK)
+	return -1;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (results[(i * columns) + 0] != NULL)
+	      value = atoll (results[(i * columns) + 0]);
+      }
+    sqlite3_free_table (results);
+    return value;
+}
+
+TOPOLOGY_PRIVATE int
+auxtopo_copy_sequence (sqlite3 * handle, sqlite3 * mem_db, const char *name,
+		       const char *suffix)
+{
+/* 
+/ aligning the AUTOINCREMENT sequence of the target connection (either
+/ the memory replica or the DB), so that deleted IDs will never be
+/ recycled on either side
+*/
+    char *sql;
+    char *table;
+    int ret;
+    sqlite3_int64 seq;
+
+    table = sqlite3_mprintf ("%s_%s", name, suffix);
+    sql =
+	sqlite3_mprintf ("SELECT seq FROM MAIN.sqlite_sequence WHERE name = %Q",
+			 table);
+    seq = auxtopo_get_sequence (handle, sql);
+    sqlite3_free (sql);
+    if (seq <= 0)
+      {
+	  sqlite3_free (table);
+	  return 1;
+      }
+    sql =
+	sqlite3_mprintf ("UPDATE MAIN.sqlite_sequence SET seq = %lld "
+			 "WHERE name = %Q AND seq < %lld", seq, table, seq);
+    ret = sqlite3_exec (mem_db, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret == SQLITE_OK && sqlite3_changes (mem_db) == 0)
+      {
+	  sql =
+	      sqlite3_mprintf ("INSERT INTO MAIN.sqlite_sequence (name, seq) "
+			       "SELECT %Q, %lld WHERE NOT EXISTS (SELECT 1 "
+			       "FROM MAIN.sqlite_sequence WHERE name = %Q)",
+			       table, seq, table);
+	  ret = sqlite3_exec (mem_db, sql, NULL, NULL, NULL);
+	  sqlite3_free (sql);
+      }
+    sqlite3_free (table);
+    if (ret != SQLITE_OK)
+	return 0;
+    return 1;
+}
+
+TOPOLOGY_PRIVATE int
+auxtopo_open_replica (sqlite3 * handle, int srid, sqlite3 ** mem_db,
+		      void **mem_cache)
+{
+/* 
+/ creating an in-memory DB intended to host a Topology (or Network)
+/ replica; the whole replica lives within a single never committed
+/ transaction, and the SRID definition is copied from the DB
+*/
+    sqlite3 *db = NULL;
+    void *cache = NULL;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_out = NULL;
+    const char *sql;
+    int ret;
+    int i;
+
+    *mem_db = NULL;
+    *mem_cache = NULL;
+    ret =
+	sqlite3_open_v2 (":memory:", &db,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  spatialite_e ("auxtopo_open_replica: sqlite3_open_v2 error: %s\n",
+			sqlite3_errmsg (db));
+	  sqlite3_close (db);
+	  return 0;
+      }
+    cache = spatialite_alloc_connection ();
+    spatialite_internal_init (db, cache);
+    ret =
+	sqlite3_exec (db, "SELECT InitSpatialMetadata(1, 'NONE')", NULL,
+		      NULL, NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    ret = sqlite3_exec (db, "BEGIN", NULL, NULL, NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+
+/* copying the SRID definition */
+    sql = "SELECT srid, auth_name, auth_srid, ref_sys_name, proj4text, "
+	"srtext FROM MAIN.spatial_ref_sys WHERE srid = ?";
+    ret = sqlite3_prepare_v2 (handle, sql, strlen (sql), &stmt_in, NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    sql = "INSERT OR IGNORE INTO MAIN.spatial_ref_sys (srid, auth_name, "
+	"auth_srid, ref_sys_name, proj4text, srtext) "
+	"VALUES (?, ?, ?, ?, ?, ?)";
+    ret = sqlite3_prepare_v2 (db, sql, strlen (sql), &stmt_out, NULL);
+    if (ret != SQLITE_OK)
+	goto error;
+    sqlite3_bind_int (stmt_in, 1, srid);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  sqlite3_reset (stmt_out);
+	  sqlite3_clear_bindings (stmt_out);
+	  for (i = 0; i < 6; i++)
+	      auxtopo_bind_value (stmt_out, i + 1, stmt_in, i);
+	  ret = sqlite3_step (stmt_out);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_in);
+    sqlite3_finalize (stmt_out);
+    *mem_db = db;
+    *mem_cache = cache;
+    return 1;
+
+  error:
+    spatialite_e ("auxtopo_open_replica: error: %s\n", sqlite3_errmsg (db));
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_out != NULL)
+	sqlite3_finalize (stmt_out);
+    sqlite3_close (db);
+    spatialite_internal_cleanup (cache);
+    return 0;
+}
+
+static const char *topo_face_columns[] = { "face_id", "mbr" };
+static const char *topo_node_columns[] =
+    { "node_id", "containing_face", "geom" };
+static const char *topo_edge_columns[] =
+    { "edge_id", "start_node", "end_node", "next_left_edge",
+    "next_right_edge", "left_face", "right_face", "geom"
+};
+
+GAIATOPO_DECLARE GaiaTopologyAccessorPtr
+gaiaTopologyMemoryCreate (GaiaTopologyAccessorPtr accessor)
+{
+/* creating a memory-resident replica of some Topology */
+    struct gaia_topology *topo = (struct gaia_topology *) accessor;
+    struct gaia_topology *mem;
+    sqlite3 *mem_db = NULL;
+    void *mem_cache = NULL;
+    sqlite3_stmt *stmt_out = NULL;
+    char *sql;
+    int ret;
+    sqlite3_int64 next_edge_id;
+    GaiaTopologyAccessorPtr mem_accessor;
+
+    if (topo == NULL)
+	return NULL;
+    if (topo->origin_handle != NULL)
+	return NULL;            /* already a memory replica */
+
+/* creating an in-memory DB */
+    if (!auxtopo_open_replica (topo->db_handle, topo->srid, &mem_db,
+			       &mem_cache))
+      {
+	  gaiatopo_set_last_error_msg (accessor,
+				       "TopoGeo in-memory replica error: "
+				       "unable to create the in-memory DB");
+	  return NULL;
+      }
+
+/* creating the Topology replica */
+    if (!gaiaTopologyCreate
+	(mem_db, topo->topology_name, topo->srid, topo->tolerance,
+	 topo->has_z))
+	goto error;
+    sql = sqlite3_mprintf ("SELECT next_edge_id FROM MAIN.topologies "
+			   "WHERE Lower(topology_name) = Lower(%Q)",
+			   topo->topology_name);
+    next_edge_id = auxtopo_get_sequence (topo->db_handle, sql);
+    sqlite3_free (sql);
+    if (next_edge_id < 0)
+	goto error;
+    sql = sqlite3_mprintf ("UPDATE MAIN.topologies SET tolerance = ?, "
+			   "next_edge_id = ? WHERE Lower(topology_name) = "
+			   "Lower(%Q)", topo->topology_name);
+    ret = sqlite3_prepare_v2 (mem_db, sql, strlen (sql), &stmt_out, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sqlite3_bind_double (stmt_out, 1, topo->tolerance);
+    sqlite3_bind_int64 (stmt_out, 2, next_edge_id);
+    ret = sqlite3_step (stmt_out);
+    sqlite3_finalize (stmt_out);
+    stmt_out = NULL;
+    if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	goto error;
+
+/* copying Faces, Nodes and Edges */
+    if (!auxtopo_copy_rows
+	(topo->db_handle, mem_db, topo->topology_name, "face",
+	 topo_face_columns, 2))
+	goto error;
+    if (!auxtopo_copy_rows
+	(topo->db_handle, mem_db, topo->topology_name, "node",
+	 topo_node_columns, 3))
+	goto error;
+    if (!auxtopo_copy_rows
+	(topo->db_handle, mem_db, topo->topology_name, "edge",
+	 topo_edge_columns, 8))
+	goto error;
+    if (!auxtopo_copy_sequence
+	(topo->db_handle, mem_db, topo->topology_name, "face"))
+	goto error;
+    if (!auxtopo_copy_sequence
+	(topo->db_handle, mem_db, topo->topology_name, "node"))
+	goto error;
+
+/* creating the Topology Accessor for the replica */
+    mem_accessor =
+	gaiaTopologyFromDBMS (mem_db, mem_cache, topo->topology_name);
+    if (mem_accessor == NULL)
+	goto error;
+    mem = (struct gaia_topology *) mem_accessor;
+    mem->origin_handle = topo->db_handle;
+    mem->origin_cache = topo->cache;
+    return mem_accessor;
+
+  error:
+    if (stmt_out != NULL)
+	sqlite3_finalize (stmt_out);
+    sql = sqlite3_mprintf ("TopoGeo in-memory replica error: \"%s\"",
+			   sqlite3_errmsg (mem_db));
+    gaiatopo_set_last_error_msg (accessor, sql);
+    sqlite3_free (sql);
+    sqlite3_close (mem_db);
+    spatialite_internal_cleanup (mem_cache);
+    return NULL;
+}
+
+GAIATOPO_DECLARE int
+gaiaTopologyMemoryFlush (GaiaTopologyAccessorPtr accessor)
+{
+/* writing back a memory-resident Topology into its own DB */
+    struct gaia_topology *topo = (struct gaia_topology *) accessor;
+    char *sql;
+    char *msg;
+    int ret;
+    sqlite3_int64 next_edge_id;
+
+    if (topo == NULL)
+	return 0;
+    if (topo->origin_handle == NULL)
+	return 0;               /* not a memory replica */
+
+/* inserting or updating all Faces, Nodes and Edges */
+    if (!auxtopo_copy_rows
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "face",
+	 topo_face_columns, 2))
+	goto error;
+    if (!auxtopo_copy_rows
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "node",
+	 topo_node_columns, 3))
+	goto error;
+    if (!auxtopo_copy_rows
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "edge",
+	 topo_edge_columns, 8))
+	goto error;
+
+/* removing any vanished Edge, Node or Face */
+    if (!auxtopo_purge_rows
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "edge",
+	 "edge_id"))
+	goto error;
+    if (!auxtopo_purge_rows
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "node",
+	 "node_id"))
+	goto error;
+    if (!auxtopo_purge_rows
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "face",
+	 "face_id"))
+	goto error;
+
+/* updating the AUTOINCREMENT sequences of Faces and Nodes */
+    if (!auxtopo_copy_sequence
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "face"))
+	goto error;
+    if (!auxtopo_copy_sequence
+	(topo->db_handle, topo->origin_handle, topo->topology_name, "node"))
+	goto error;
+
+/* updating the next Edge ID */
+    sql = sqlite3_mprintf ("SELECT next_edge_id FROM MAIN.topologies "
+			   "WHERE Lower(topology_name) = Lower(%Q)",
+			   topo->topology_name);
+    next_edge_id = auxtopo_get_sequence (topo->db_handle, sql);
+    sqlite3_free (sql);
+    if (next_edge_id < 0)
+	goto error;
+    sql = sqlite3_mprintf ("UPDATE MAIN.topologies SET next_edge_id = %lld "
+			   "WHERE Lower(topology_name) = Lower(%Q) AND "
+			   "next_edge_id < %lld", next_edge_id,
+			   topo->topology_name, next_edge_id);
+    ret = sqlite3_exec (topo->origin_handle, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    return 1;
+
+  error:
+    msg = sqlite3_mprintf ("TopoGeo in-memory flush error: \"%s\"",
+			   sqlite3_errmsg (topo->origin_handle));
+    gaiaSetRtTopoErrorMsg (topo->cache, msg);
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_free (msg);
+    return 0;
+}
+
+GAIATOPO_DECLARE void
+gaiaTopologyMemoryDestroy (GaiaTopologyAccessorPtr accessor)
+{
+/* destroying a memory-resident Topology replica */
+    struct gaia_topology *topo = (struct gaia_topology *) accessor;
+    sqlite3 *mem_db;
+    const void *mem_cache;
+    const char *msg;
+
+    if (topo == NULL)
+	return;
+    if (topo->origin_handle == NULL)
+	return;                 /* not a memory replica */
+    mem_db = topo->db_handle;
+    mem_cache = topo->cache;
+
+/* forwarding any pending error message to the main connection */
+    msg = gaiaGetRtTopoErrorMsg (mem_cache);
+    if (msg == NULL)
+	msg = topo->last_error_message;
+    if (msg != NULL)
+	gaiaSetRtTopoErrorMsg (topo->origin_cache, msg);
+
+    gaiaTopologyDestroy (accessor);
+    sqlite3_close (mem_db);
+    spatialite_internal_cleanup (mem_cache);
+}
+
 TOPOLOGY_PRIVATE void
 finalize_topogeo_prepared_stmts (GaiaTopologyAccessorPtr accessor)
 {
@@ -3696,6 +4321,182 @@ gaiaGetFaceEdges (GaiaTopologyAccessorPtr accessor, sqlite3_int64 face)
     return 1;
 }
 
+#define TOPO_MAX_THREADS	64
+
+struct topo_parallel
+{
+/* a struct wrapping a pool of worker threads */
+    void (*job) (void *, int);
+    void *data;
+    int count;
+    int next_job;
+    int done;
+    void (*progress_callback) (int, void *);
+    void *callback_ptr;
+    splite_mutex_t mutex;
+};
+
+SPLITE_THREAD_PROC (do_topo_parallel_worker, arg)
+{
+/* a worker thread running jobs until none is left */
+    struct topo_parallel *pool = (struct topo_parallel *) arg;
+    while (1)
+      {
+	  int i;
+	  splite_mutex_lock (&(pool->mutex));
+	  i = pool->next_job;
+	  pool->next_job += 1;
+	  splite_mutex_unlock (&(pool->mutex));
+	  if (i >= pool->count)
+	      break;
+	  pool->job (pool->data, i);
+	  splite_mutex_lock (&(pool->mutex));
+	  pool->done += 1;
+	  if (pool->progress_callback != NULL)
+	      pool->progress_callback (pool->done, pool->callback_ptr);
+	  splite_mutex_unlock (&(pool->mutex));
+      }
+    SPLITE_THREAD_RETURN;
+}
+
+TOPOLOGY_PRIVATE void
+auxtopo_run_parallel (void (*job) (void *, int), void *data, int count,
+		      int num_threads, void (*progress_callback) (int,
+								  void *),
+		      void *callback_ptr)
+{
+/* running a set of independent jobs on a pool of worker threads */
+    splite_thread_t threads[TOPO_MAX_THREADS];
+    struct topo_parallel pool;
+    int started = 0;
+    int i;
+
+    if (num_threads > TOPO_MAX_THREADS)
+	num_threads = TOPO_MAX_THREADS;
+    if (num_threads > count)
+	num_threads = count;
+    if (!sqlite3_threadsafe ())
+	num_threads = 1;
+    pool.job = job;
+    pool.data = data;
+    pool.count = count;
+    pool.next_job = 0;
+    pool.done = 0;
+    pool.progress_callback = progress_callback;
+    pool.callback_ptr = callback_ptr;
+    splite_mutex_init (&(pool.mutex));
+    for (i = 1; i < num_threads; i++)
+      {
+	  if (!splite_thread_start
+	      (threads + started, do_topo_parallel_worker, &pool))
+	      break;
+	  started++;
+      }
+/* the calling thread always acts as a worker as well */
+    do_topo_parallel_worker (&pool);
+    for (i = 0; i < started; i++)
+	splite_thread_join (threads[i]);
+    splite_mutex_destroy (&(pool.mutex));
+}
+
+TOPOLOGY_PRIVATE int
+auxtopo_open_reader (sqlite3 * handle, sqlite3 ** reader, void **reader_cache)
+{
+/* opening a further read-only connection to the same DB */
+    const char *path;
+    sqlite3 *db = NULL;
+    int ret;
+
+    *reader = NULL;
+    *reader_cache = NULL;
+    path = sqlite3_db_filename (handle, "main");
+    if (path == NULL || *path == '\0')
+	return 0;               /* memory-resident or temporary DB */
+#if SQLITE_VERSION_NUMBER >= 3034000
+    if (sqlite3_txn_state (handle, "main") == SQLITE_TXN_WRITE)
+	return 0;               /* uncommitted changes would be invisible */
+#else
+    if (!sqlite3_get_autocommit (handle))
+	return 0;               /* some open transaction: may be a pending write */
+#endif
+    ret = sqlite3_open_v2 (path, &db, SQLITE_OPEN_READONLY, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  sqlite3_close (db);
+	  return 0;
+      }
+    sqlite3_busy_timeout (db, 5000);
+    *reader_cache = spatialite_alloc_connection ();
+    spatialite_internal_init (db, *reader_cache);
+    *reader = db;
+    return 1;
+}
+
+TOPOLOGY_PRIVATE void
+auxtopo_close_reader (sqlite3 * reader, void *reader_cache)
+{
+/* closing a read-only connection */
+    if (reader != NULL)
+	sqlite3_close (reader);
+    if (reader_cache != NULL)
+	spatialite_internal_cleanup (reader_cache);
+}
+
+TOPOLOGY_PRIVATE int
+auxtopo_copy_validation_report (sqlite3 * reader, const char *table,
+				sqlite3_stmt * stmt)
+{
+/* copying all findings collected by some read-only connection */
+    char *sql;
+    char *xtable;
+    int ret;
+    sqlite3_stmt *stmt_in = NULL;
+
+    xtable = gaiaDoubleQuotedSql (table);
+    sql =
+	sqlite3_mprintf
+	("SELECT error, primitive1, primitive2 FROM TEMP.\"%s\" "
+	 "ORDER BY ROWID", xtable);
+    free (xtable);
+    ret = sqlite3_prepare_v2 (reader, sql, strlen (sql), &stmt_in, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  int i;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  sqlite3_reset (stmt);
+	  sqlite3_clear_bindings (stmt);
+	  sqlite3_bind_text (stmt, 1,
+			     (const char *) sqlite3_column_text (stmt_in, 0),
+			     sqlite3_column_bytes (stmt_in, 0),
+			     SQLITE_TRANSIENT);
+	  for (i = 1; i <= 2; i++)
+	    {
+		if (sqlite3_column_type (stmt_in, i) == SQLITE_NULL)
+		    sqlite3_bind_null (stmt, i + 1);
+		else
+		    sqlite3_bind_int64 (stmt, i + 1,
+					sqlite3_column_int64 (stmt_in, i));
+	    }
+	  ret = sqlite3_step (stmt);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_in);
+    return 1;
+
+  error:
+    sqlite3_finalize (stmt_in);
+    return 0;
+}
+
 static int
 do_check_create_validate_topogeo_table (GaiaTopologyAccessorPtr accessor)
 {
@@ -3862,7 +4663,7 @@ do_topo_check_edge_node (GaiaTopologyAccessorPtr accessor, sqlite3_stmt * stmt)
     table = sqlite3_mprintf ("%s_node", topo->topology_name);
     xtable2 = gaiaDoubleQuotedSql (table);
     sql = sqlite3_mprintf ("SELECT e.edge_id, n.node_id FROM MAIN.\"%s\" AS e "
-			   "JOIN MAIN.\"%s\" AS n ON (ST_Distance(e.geom, n.geom) <= 0 "
+			   "JOIN MAIN.\"%s\" AS n ON (ST_Intersects(e.geom, n.geom) = 1 "
 			   "AND ST_Disjoint(ST_StartPoint(e.geom), n.geom) = 1 AND "
 			   "ST_Disjoint(ST_EndPoint(e.geom), n.geom) = 1 AND n.node_id IN "
 			   "(SELECT rowid FROM SpatialIndex WHERE f_table_name = %Q AND "
@@ -4051,6 +4852,7 @@ do_topo_check_edge_edge (GaiaTopologyAccessorPtr accessor, sqlite3_stmt * stmt)
     sql =
 	sqlite3_mprintf ("SELECT e1.edge_id, e2.edge_id FROM MAIN.\"%s\" AS e1 "
 			 "JOIN MAIN.\"%s\" AS e2 ON (e1.edge_id <> e2.edge_id AND "
+			 "ST_Intersects(e1.geom, e2.geom) = 1 AND "
 			 "ST_RelateMatch(ST_Relate(e1.geom, e2.geom), '0******0*') = 1 AND e2.edge_id IN "
 			 "(SELECT rowid FROM SpatialIndex WHERE f_table_name = %Q AND "
 			 "f_geometry_column = 'geom' AND search_frame = e1.geom))",
@@ -4988,21 +5790,30 @@ do_topo_check_drop_aux_faces (GaiaTopologyAccessorPtr accessor)
     return 1;
 }
 
-GAIATOPO_DECLARE int
-gaiaValidateTopoGeo (GaiaTopologyAccessorPtr accessor)
+#define TOPO_VALIDATE_CHECKS	9
+
+struct topo_validate_job
 {
-/* generating a validity report for a given Topology */
+/* a struct wrapping a single Topology validation check */
+    sqlite3 *handle;
+    void *cache;
+    GaiaTopologyAccessorPtr accessor;
+    int status;
+};
+
+static sqlite3_stmt *
+do_prepare_validate_topogeo (GaiaTopologyAccessorPtr accessor)
+{
+/* creating the target table and preparing the INSERT statement */
     char *table;
     char *xtable;
     char *sql;
     int ret;
     sqlite3_stmt *stmt = NULL;
     struct gaia_topology *topo = (struct gaia_topology *) accessor;
-    if (topo == NULL)
-	return 0;
 
     if (!do_check_create_validate_topogeo_table (accessor))
-	return 0;
+	return NULL;
 
     table = sqlite3_mprintf ("%s_validate_topogeo", topo->topology_name);
     xtable = gaiaDoubleQuotedSql (table);
@@ -5020,47 +5831,190 @@ gaiaValidateTopoGeo (GaiaTopologyAccessorPtr accessor)
 				       sqlite3_errmsg (topo->db_handle));
 	  gaiatopo_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
-	  goto error;
+	  return NULL;
       }
+    return stmt;
+}
 
-    if (!do_topo_check_coincident_nodes (accessor, stmt))
-	goto error;
-
-    if (!do_topo_check_edge_node (accessor, stmt))
-	goto error;
+static int
+do_topo_validate_check (GaiaTopologyAccessorPtr accessor, sqlite3_stmt * stmt,
+			int check)
+{
+/* performing a single validation check */
+    switch (check)
+      {
+      case 0:
+	  return do_topo_check_coincident_nodes (accessor, stmt);
+      case 1:
+	  return do_topo_check_edge_node (accessor, stmt);
+      case 2:
+	  return do_topo_check_non_simple (accessor, stmt);
+      case 3:
+	  return do_topo_check_edge_edge (accessor, stmt);
+      case 4:
+	  return do_topo_check_start_nodes (accessor, stmt);
+      case 5:
+	  return do_topo_check_end_nodes (accessor, stmt);
+      case 6:
+	  return do_topo_check_face_no_edges (accessor, stmt);
+      case 7:
+	  return do_topo_check_no_universal_face (accessor, stmt);
+      case 8:
+	  /* all Face checks share the same aux-Face table */
+	  if (!do_topo_check_create_aux_faces (accessor))
+	      return 0;
+	  if (!do_topo_check_build_aux_faces (accessor, stmt))
+	      return 0;
+	  if (!do_topo_check_overlapping_faces (accessor, stmt))
+	      return 0;
+	  if (!do_topo_check_face_within_face (accessor, stmt))
+	      return 0;
+	  return do_topo_check_drop_aux_faces (accessor);
+      };
+    return 0;
+}
 
-    if (!do_topo_check_non_simple (accessor, stmt))
-	goto error;
+static void
+do_topo_validate_job (void *data, int check)
+{
+/* performing a single validation check on its own connection */
+    struct topo_validate_job *job = (struct topo_validate_job *) data + check;
+    sqlite3_stmt *stmt = do_prepare_validate_topogeo (job->accessor);
+    if (stmt == NULL)
+      {
+	  job->status = 0;
+	  return;
+      }
+    job->status = do_topo_validate_check (job->accessor, stmt, check);
+    sqlite3_finalize (stmt);
+}
 
-    if (!do_topo_check_edge_edge (accessor, stmt))
-	goto error;
+static int
+do_topo_validate_parallel (GaiaTopologyAccessorPtr accessor, int num_threads,
+			   void (*progress_callback) (int, void *),
+			   void *callback_ptr)
+{
+/* performing all validation checks concurrently */
+    struct topo_validate_job jobs[TOPO_VALIDATE_CHECKS];
+    struct gaia_topology *topo = (struct gaia_topology *) accessor;
+    sqlite3_stmt *stmt = NULL;
+    char *table;
+    int i;
+    int ok = 1;
 
-    if (!do_topo_check_start_nodes (accessor, stmt))
-	goto error;
+/* opening a read-only connection for each check */
+    memset (jobs, 0, sizeof (jobs));
+    for (i = 0; i < TOPO_VALIDATE_CHECKS; i++)
+      {
+	  struct topo_validate_job *job = jobs + i;
+	  if (!auxtopo_open_reader (topo->db_handle, &(job->handle),
+				    &(job->cache)))
+	    {
+		ok = -1;
+		break;
+	    }
+	  job->accessor =
+	      gaiaTopologyFromDBMS (job->handle, job->cache,
+				    topo->topology_name);
+	  if (job->accessor == NULL)
+	    {
+		ok = -1;
+		break;
+	    }
+      }
+    if (ok < 0)
+	goto stop;
 
-    if (!do_topo_check_end_nodes (accessor, stmt))
-	goto error;
+    auxtopo_run_parallel (do_topo_validate_job, jobs, TOPO_VALIDATE_CHECKS,
+			  num_threads, progress_callback, callback_ptr);
 
-    if (!do_topo_check_face_no_edges (accessor, stmt))
-	goto error;
+/* merging all findings into the validation table */
+    stmt = do_prepare_validate_topogeo (accessor);
+    if (stmt == NULL)
+      {
+	  ok = 0;
+	  goto stop;
+      }
+    table = sqlite3_mprintf ("%s_validate_topogeo", topo->topology_name);
+    for (i = 0; i < TOPO_VALIDATE_CHECKS; i++)
+      {
+	  struct topo_validate_job *job = jobs + i;
+	  if (!(job->status))
+	    {
+		struct gaia_topology *worker =
+		    (struct gaia_topology *) (job->accessor);
+		gaiatopo_set_last_error_msg (accessor,
+					     worker->last_error_message);
+		ok = 0;
+		break;
+	    }
+	  if (!auxtopo_copy_validation_report (job->handle, table, stmt))
+	    {
+		char *msg = sqlite3_mprintf ("ST_ValidateTopoGeo error: \"%s\"",
+					     sqlite3_errmsg (topo->db_handle));
+		gaiatopo_set_last_error_msg (accessor, msg);
+		sqlite3_free (msg);
+		ok = 0;
+		break;
+	    }
+      }
+    sqlite3_free (table);
+    sqlite3_finalize (stmt);
 
-    if (!do_topo_check_no_universal_face (accessor, stmt))
-	goto error;
+  stop:
+    for (i = 0; i < TOPO_VALIDATE_CHECKS; i++)
+      {
+	  struct topo_validate_job *job = jobs + i;
+	  if (job->accessor != NULL)
+	      gaiaTopologyDestroy (job->accessor);
+	  auxtopo_close_reader (job->handle, job->cache);
+      }
+    return ok;
+}
 
-    if (!do_topo_check_create_aux_faces (accessor))
-	goto error;
+GAIATOPO_DECLARE int
+gaiaValidateTopoGeo (GaiaTopologyAccessorPtr accessor)
+{
+/* generating a validity report for a given Topology */
+    return gaiaValidateTopoGeoEx (accessor, 1, NULL, NULL);
+}
 
-    if (!do_topo_check_build_aux_faces (accessor, stmt))
-	goto error;
+GAIATOPO_DECLARE int
+gaiaValidateTopoGeoEx (GaiaTopologyAccessorPtr accessor, int num_threads,
+		       void (*progress_callback) (int, void *),
+		       void *callback_ptr)
+{
+/* generating a validity report for a given Topology - Extended mode */
+    int i;
+    sqlite3_stmt *stmt = NULL;
+    struct gaia_topology *topo = (struct gaia_topology *) accessor;
+    if (topo == NULL)
+	return 0;
 
-    if (!do_topo_check_overlapping_faces (accessor, stmt))
-	goto error;
+    if (num_threads > 1 && topo->origin_handle == NULL)
+      {
+	  /* 
+	  / attempting to run all checks concurrently; falling back
+	  / to sequential mode when further connections can't be opened
+	  */
+	  int ret = do_topo_validate_parallel (accessor, num_threads,
+					       progress_callback,
+					       callback_ptr);
+	  if (ret >= 0)
+	      return ret;
+      }
 
-    if (!do_topo_check_face_within_face (accessor, stmt))
-	goto error;
+    stmt = do_prepare_validate_topogeo (accessor);
+    if (stmt == NULL)
+	return 0;
 
-    if (!do_topo_check_drop_aux_faces (accessor))
-	goto error;
+    for (i = 0; i < TOPO_VALIDATE_CHECKS; i++)
+      {
+	  if (!do_topo_validate_check (accessor, stmt, i))
+	      goto error;
+	  if (progress_callback != NULL)
+	      progress_callback (i + 1, callback_ptr);
+      }
 
     sqlite3_finalize (stmt);
     return 1;
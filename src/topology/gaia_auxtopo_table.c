@@ -109,13 +109,23 @@ gaiaTopoGeo_FromGeoTable (GaiaTopologyAccessorPtr accessor,
     char *xcolumn;
     int gpkg_amphibious = 0;
     int gpkg_mode = 0;
+    sqlite3 *sqlite;
+    const void *p_cache;
 
     if (topo == NULL)
 	return 0;
-    if (topo->cache != NULL)
+    sqlite = topo->db_handle;
+    p_cache = topo->cache;
+    if (topo->origin_handle != NULL)
+      {
+	  /* memory-resident Topology: reading from the main DB */
+	  sqlite = topo->origin_handle;
+	  p_cache = topo->origin_cache;
+      }
+    if (p_cache != NULL)
       {
 	  struct splite_internal_cache *cache =
-	      (struct splite_internal_cache *) (topo->cache);
+	      (struct splite_internal_cache *) p_cache;
 	  gpkg_amphibious = cache->gpkg_amphibious_mode;
 	  gpkg_mode = cache->gpkg_mode;
       }
@@ -130,12 +140,12 @@ gaiaTopoGeo_FromGeoTable (GaiaTopologyAccessorPtr accessor,
     free (xprefix);
     free (xtable);
     free (xcolumn);
-    ret = sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt, NULL);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
     sqlite3_free (sql);
     if (ret != SQLITE_OK)
       {
 	  char *msg = sqlite3_mprintf ("TopoGeo_FromGeoTable error: \"%s\"",
-				       sqlite3_errmsg (topo->db_handle));
+				       sqlite3_errmsg (sqlite));
 	  gaiatopo_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
 	  goto error;
@@ -197,7 +207,7 @@ gaiaTopoGeo_FromGeoTable (GaiaTopologyAccessorPtr accessor,
 	    {
 		char *msg =
 		    sqlite3_mprintf ("TopoGeo_FromGeoTable error: \"%s\"",
-				     sqlite3_errmsg (topo->db_handle));
+				     sqlite3_errmsg (sqlite));
 		gaiatopo_set_last_error_msg (accessor, msg);
 		sqlite3_free (msg);
 		goto error;
@@ -400,11 +410,19 @@ do_FromGeoTableExtended_block (GaiaTopologyAccessorPtr accessor,
     int gpkg_mode = 0;
     int totcnt = 0;
     sqlite3_int64 last_rowid;
+    sqlite3 *sqlite = topo->db_handle;
+    const void *p_cache = topo->cache;
 
-    if (topo->cache != NULL)
+    if (topo->origin_handle != NULL)
+      {
+	  /* memory-resident Topology: input and dustbin live on the main DB */
+	  sqlite = topo->origin_handle;
+	  p_cache = topo->origin_cache;
+      }
+    if (p_cache != NULL)
       {
 	  struct splite_internal_cache *cache =
-	      (struct splite_internal_cache *) (topo->cache);
+	      (struct splite_internal_cache *) p_cache;
 	  gpkg_amphibious = cache->gpkg_amphibious_mode;
 	  gpkg_mode = cache->gpkg_mode;
       }
@@ -479,7 +497,7 @@ do_FromGeoTableExtended_block (GaiaTopologyAccessorPtr accessor,
 				  if (tolerance < 0.0)
 				      tolerance = topo->tolerance;
 				  if (!insert_into_dustbin
-				      (topo->db_handle, topo->cache,
+				      (sqlite, p_cache,
 				       stmt_dustbin, rowid, msg, tolerance,
 				       dustbin_count, failing_geometry))
 				    {
@@ -492,8 +510,7 @@ do_FromGeoTableExtended_block (GaiaTopologyAccessorPtr accessor,
 				  last_rowid = rowid;
 				  *invalid = rowid;
 				  *dustbin_row =
-				      sqlite3_last_insert_rowid
-				      (topo->db_handle);
+				      sqlite3_last_insert_rowid (sqlite);
 				  return 0;
 			      }
 			    gaiaFreeGeomColl (geom);
@@ -508,7 +525,7 @@ do_FromGeoTableExtended_block (GaiaTopologyAccessorPtr accessor,
 			    if (tolerance < 0.0)
 				tolerance = topo->tolerance;
 			    if (!insert_into_dustbin
-				(topo->db_handle, topo->cache, stmt_dustbin,
+				(sqlite, p_cache, stmt_dustbin,
 				 rowid,
 				 "TopoGeo_FromGeoTableExt error: Invalid Geometry",
 				 tolerance, dustbin_count, NULL))
@@ -520,7 +537,7 @@ do_FromGeoTableExtended_block (GaiaTopologyAccessorPtr accessor,
 		  {
 		      rollback_topo_savepoint (topo->db_handle, topo->cache);
 		      if (!insert_into_dustbin
-			  (topo->db_handle, topo->cache, stmt_dustbin, rowid,
+			  (sqlite, p_cache, stmt_dustbin, rowid,
 			   "TopoGeo_FromGeoTableExt error: not a BLOB value",
 			   tolerance, dustbin_count, NULL))
 			  goto error;
@@ -530,7 +547,7 @@ do_FromGeoTableExtended_block (GaiaTopologyAccessorPtr accessor,
 	    {
 		char *msg =
 		    sqlite3_mprintf ("TopoGeo_FromGeoTableExt error: \"%s\"",
-				     sqlite3_errmsg (topo->db_handle));
+				     sqlite3_errmsg (sqlite));
 		gaiatopo_set_last_error_msg (accessor, msg);
 		sqlite3_free (msg);
 		rollback_topo_savepoint (topo->db_handle, topo->cache);
@@ -562,9 +579,13 @@ gaiaTopoGeo_FromGeoTableExtended (GaiaTopologyAccessorPtr accessor,
     sqlite3_int64 last;
     sqlite3_int64 invalid = -1;
     sqlite3_int64 dustbin_row = -1;
+    sqlite3 *sqlite;
 
     if (topo == NULL)
 	return 0;
+    sqlite = topo->db_handle;
+    if (topo->origin_handle != NULL)
+	sqlite = topo->origin_handle;	/* memory-resident Topology */
     if (sql_in == NULL)
 	return 0;
     if (sql_out == NULL)
@@ -572,12 +593,12 @@ gaiaTopoGeo_FromGeoTableExtended (GaiaTopologyAccessorPtr accessor,
 
 /* building the SQL statement */
     ret =
-	sqlite3_prepare_v2 (topo->db_handle, sql_in, strlen (sql_in), &stmt,
+	sqlite3_prepare_v2 (sqlite, sql_in, strlen (sql_in), &stmt,
 			    NULL);
     if (ret != SQLITE_OK)
       {
 	  char *msg = sqlite3_mprintf ("TopoGeo_FromGeoTableExt error: \"%s\"",
-				       sqlite3_errmsg (topo->db_handle));
+				       sqlite3_errmsg (sqlite));
 	  gaiatopo_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
 	  goto error;
@@ -585,12 +606,12 @@ gaiaTopoGeo_FromGeoTableExtended (GaiaTopologyAccessorPtr accessor,
 
 /* building the SQL dustbin statement */
     ret =
-	sqlite3_prepare_v2 (topo->db_handle, sql_out, strlen (sql_out),
+	sqlite3_prepare_v2 (sqlite, sql_out, strlen (sql_out),
 			    &stmt_dustbin, NULL);
     if (ret != SQLITE_OK)
       {
 	  char *msg = sqlite3_mprintf ("TopoGeo_FromGeoTableExt error: \"%s\"",
-				       sqlite3_errmsg (topo->db_handle));
+				       sqlite3_errmsg (sqlite));
 	  gaiatopo_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
 	  goto error;
@@ -598,12 +619,12 @@ gaiaTopoGeo_FromGeoTableExtended (GaiaTopologyAccessorPtr accessor,
 
 /* building the SQL retry statement */
     ret =
-	sqlite3_prepare_v2 (topo->db_handle, sql_in2, strlen (sql_in2),
+	sqlite3_prepare_v2 (sqlite, sql_in2, strlen (sql_in2),
 			    &stmt_retry, NULL);
     if (ret != SQLITE_OK)
       {
 	  char *msg = sqlite3_mprintf ("TopoGeo_FromGeoTableExt error: \"%s\"",
-				       sqlite3_errmsg (topo->db_handle));
+				       sqlite3_errmsg (sqlite));
 	  gaiatopo_set_last_error_msg (accessor, msg);
 	  sqlite3_free (msg);
 	  goto error;
@@ -779,6 +800,1331 @@ gaiaTopoGeo_FromGeoTableNoFaceExtended (GaiaTopologyAccessorPtr accessor,
     return -1;
 }
 
+struct topo_tile
+{
+/* a struct wrapping a single Tile of a partitioned Topology build */
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+    double inner_minx;
+    double inner_miny;
+    double inner_maxx;
+    double inner_maxy;
+    gaiaGeomCollPtr geom;
+    GaiaTopologyAccessorPtr accessor;
+    int status;
+};
+
+struct topo_partition
+{
+/* a struct wrapping a partitioned Topology build */
+    int srid;
+    int has_z;
+    double tolerance;
+    int line_max_points;
+    double max_length;
+    int tiles_x;
+    int tiles_y;
+    double *bound_x;
+    double *bound_y;
+    struct topo_tile *tiles;
+    int count;
+    double *cuts;
+    int cuts_count;
+    int cuts_max;
+};
+
+struct topo_tile_edge
+{
+/* a struct wrapping an Edge from some Tile */
+    sqlite3_int64 edge_id;
+    sqlite3_int64 start_node;
+    sqlite3_int64 end_node;
+    sqlite3_int64 next_left;
+    sqlite3_int64 next_right;
+    int interior;
+};
+
+static void
+do_get_tile_vertex (const double *coords, int dims, int iv, double *x,
+		    double *y, double *z)
+{
+/* fetching a Vertex from a Linestring or Ring */
+    double m;
+    *z = 0.0;
+    if (dims == GAIA_XY_Z)
+      {
+	  gaiaGetPointXYZ (coords, iv, x, y, z);
+      }
+    else if (dims == GAIA_XY_M)
+      {
+	  gaiaGetPointXYM (coords, iv, x, y, &m);
+      }
+    else if (dims == GAIA_XY_Z_M)
+      {
+	  gaiaGetPointXYZM (coords, iv, x, y, z, &m);
+      }
+    else
+      {
+	  gaiaGetPoint (coords, iv, x, y);
+      }
+}
+
+static void
+do_cross_tile_boundary (double x1, double y1, double z1, double x2,
+			double y2, double z2, int side, double value,
+			double *x, double *y, double *z)
+{
+/* 
+/ computing the intersection between a segment and a Tile boundary
+/
+/ the segment end-points are always taken in canonical order, so that
+/ the very same segment will always produce exactly the same point
+/ on both sides of a seam, whatever its direction could be
+*/
+    double t;
+    if (x1 > x2 || (x1 == x2 && y1 > y2))
+      {
+	  double swap = x1;
+	  x1 = x2;
+	  x2 = swap;
+	  swap = y1;
+	  y1 = y2;
+	  y2 = swap;
+	  swap = z1;
+	  z1 = z2;
+	  z2 = swap;
+      }
+    if (side <= 2)
+      {
+	  /* vertical boundary */
+	  t = (value - x1) / (x2 - x1);
+	  *x = value;
+	  *y = y1 + (t * (y2 - y1));
+      }
+    else
+      {
+	  /* horizontal boundary */
+	  t = (value - y1) / (y2 - y1);
+	  *x = x1 + (t * (x2 - x1));
+	  *y = value;
+      }
+    *z = z1 + (t * (z2 - z1));
+}
+
+static double
+do_get_tile_side (struct topo_tile *tile, int side)
+{
+/* returning the coordinate of some Tile side */
+    switch (side)
+      {
+      case 1:
+	  return tile->minx;
+      case 2:
+	  return tile->maxx;
+      case 3:
+	  return tile->miny;
+      };
+    return tile->maxy;
+}
+
+static void
+do_add_tile_cut (struct topo_partition *part, double x, double y)
+{
+/* registering a Node artificially introduced by clipping */
+    if (part->cuts_count >= part->cuts_max)
+      {
+	  part->cuts_max += 4096;
+	  part->cuts =
+	      realloc (part->cuts, sizeof (double) * 2 * part->cuts_max);
+      }
+    part->cuts[part->cuts_count * 2] = x;
+    part->cuts[(part->cuts_count * 2) + 1] = y;
+    part->cuts_count += 1;
+}
+
+static void
+do_flush_tile_piece (struct topo_partition *part, struct topo_tile *tile,
+		     double *piece, int count)
+{
+/* adding a clipped Linestring to the Tile */
+    gaiaLinestringPtr ln;
+    int iv;
+    if (count < 2)
+	return;
+    if (tile->geom == NULL)
+      {
+	  if (part->has_z)
+	      tile->geom = gaiaAllocGeomCollXYZ ();
+	  else
+	      tile->geom = gaiaAllocGeomColl ();
+	  tile->geom->Srid = part->srid;
+      }
+    ln = gaiaAddLinestringToGeomColl (tile->geom, count);
+    for (iv = 0; iv < count; iv++)
+      {
+	  if (part->has_z)
+	    {
+		gaiaSetPointXYZ (ln->Coords, iv, piece[iv * 3],
+				 piece[(iv * 3) + 1], piece[(iv * 3) + 2]);
+	    }
+	  else
+	    {
+		gaiaSetPoint (ln->Coords, iv, piece[iv * 3],
+			      piece[(iv * 3) + 1]);
+	    }
+      }
+}
+
+static void
+do_append_tile_vertex (double *piece, int *count, double x, double y,
+		       double z)
+{
+/* appending a Vertex to a clipped Linestring (skipping repeated points) */
+    int last = *count - 1;
+    if (last >= 0 && piece[last * 3] == x && piece[(last * 3) + 1] == y)
+	return;
+    piece[*count * 3] = x;
+    piece[(*count * 3) + 1] = y;
+    piece[(*count * 3) + 2] = z;
+    *count += 1;
+}
+
+static void
+do_clip_tile_line (struct topo_partition *part, struct topo_tile *tile,
+		   const double *coords, int points, int dims, double *piece)
+{
+/* clipping a Linestring (or Ring) against a Tile rectangle */
+    int iv;
+    int count = 0;
+    double x1;
+    double y1;
+    double z1;
+    double x2;
+    double y2;
+    double z2;
+    for (iv = 1; iv < points; iv++)
+      {
+	  /* Liang-Barsky clipping of each segment */
+	  double p[4];
+	  double q[4];
+	  double t0 = 0.0;
+	  double t1 = 1.0;
+	  int side0 = 0;
+	  int side1 = 0;
+	  int k;
+	  int reject = 0;
+	  double x;
+	  double y;
+	  double z;
+	  do_get_tile_vertex (coords, dims, iv - 1, &x1, &y1, &z1);
+	  do_get_tile_vertex (coords, dims, iv, &x2, &y2, &z2);
+	  p[0] = -(x2 - x1);
+	  p[1] = x2 - x1;
+	  p[2] = -(y2 - y1);
+	  p[3] = y2 - y1;
+	  q[0] = x1 - tile->minx;
+	  q[1] = tile->maxx - x1;
+	  q[2] = y1 - tile->miny;
+	  q[3] = tile->maxy - y1;
+	  for (k = 0; k < 4; k++)
+	    {
+		double r;
+		if (p[k] == 0.0)
+		  {
+		      if (q[k] < 0.0)
+			  reject = 1;
+		      continue;
+		  }
+		r = q[k] / p[k];
+		if (p[k] < 0.0)
+		  {
+		      if (r > t0)
+			{
+			    t0 = r;
+			    side0 = k + 1;
+			}
+		  }
+		else
+		  {
+		      if (r < t1)
+			{
+			    t1 = r;
+			    side1 = k + 1;
+			}
+		  }
+	    }
+	  if (reject || t0 >= t1)
+	    {
+		/* the segment is outside the Tile */
+		if (count > 0)
+		  {
+		      do_flush_tile_piece (part, tile, piece, count);
+		      if (count > 1)
+			  do_add_tile_cut (part, piece[(count - 1) * 3],
+					   piece[((count - 1) * 3) + 1]);
+		      count = 0;
+		  }
+		continue;
+	    }
+	  if (count == 0)
+	    {
+		/* starting a new Linestring */
+		if (side0 == 0)
+		  {
+		      x = x1;
+		      y = y1;
+		      z = z1;
+		  }
+		else
+		    do_cross_tile_boundary (x1, y1, z1, x2, y2, z2, side0,
+					    do_get_tile_side (tile, side0),
+					    &x, &y, &z);
+		do_append_tile_vertex (piece, &count, x, y, z);
+		if (side0 != 0 || iv > 1)
+		    do_add_tile_cut (part, x, y);
+	    }
+	  if (side1 == 0)
+	    {
+		x = x2;
+		y = y2;
+		z = z2;
+	    }
+	  else
+	      do_cross_tile_boundary (x1, y1, z1, x2, y2, z2, side1,
+				      do_get_tile_side (tile, side1), &x, &y,
+				      &z);
+	  do_append_tile_vertex (piece, &count, x, y, z);
+	  if (side1 != 0)
+	    {
+		/* leaving the Tile */
+		do_flush_tile_piece (part, tile, piece, count);
+		if (count > 1)
+		    do_add_tile_cut (part, x, y);
+		count = 0;
+	    }
+      }
+    do_flush_tile_piece (part, tile, piece, count);
+}
+
+static void
+do_find_tiles (const double *bounds, int n, double min, double max, int *first,
+	       int *last)
+{
+/* identifying the range of Tiles intersecting some interval */
+    int i = 0;
+    int j = n - 1;
+    while (i < n - 1 && bounds[i + 1] < min)
+	i++;
+    while (j > 0 && bounds[j] > max)
+	j--;
+    *first = i;
+    *last = j;
+}
+
+static int
+do_find_tile (const double *bounds, int n, double value)
+{
+/* identifying the Tile containing some value */
+    int i = 0;
+    while (i < n - 1 && value >= bounds[i + 1])
+	i++;
+    return i;
+}
+
+static void
+do_partition_line (struct topo_partition *part, const double *coords,
+		   int points, int dims)
+{
+/* distributing a Linestring (or Ring) between all Tiles */
+    int iv;
+    int ix;
+    int iy;
+    int first_x;
+    int last_x;
+    int first_y;
+    int last_y;
+    double minx = DBL_MAX;
+    double miny = DBL_MAX;
+    double maxx = -DBL_MAX;
+    double maxy = -DBL_MAX;
+    double *piece;
+    for (iv = 0; iv < points; iv++)
+      {
+	  double x;
+	  double y;
+	  double z;
+	  do_get_tile_vertex (coords, dims, iv, &x, &y, &z);
+	  if (x < minx)
+	      minx = x;
+	  if (x > maxx)
+	      maxx = x;
+	  if (y < miny)
+	      miny = y;
+	  if (y > maxy)
+	      maxy = y;
+      }
+    do_find_tiles (part->bound_x, part->tiles_x, minx, maxx, &first_x,
+		   &last_x);
+    do_find_tiles (part->bound_y, part->tiles_y, miny, maxy, &first_y,
+		   &last_y);
+    piece = malloc (sizeof (double) * 3 * ((points * 2) + 2));
+    for (iy = first_y; iy <= last_y; iy++)
+      {
+	  for (ix = first_x; ix <= last_x; ix++)
+	    {
+		struct topo_tile *tile =
+		    part->tiles + (iy * part->tiles_x) + ix;
+		do_clip_tile_line (part, tile, coords, points, dims, piece);
+	    }
+      }
+    free (piece);
+}
+
+static void
+do_partition_geometry (struct topo_partition *part, gaiaGeomCollPtr geom)
+{
+/* distributing all items of some input Geometry between all Tiles */
+    gaiaPointPtr pt;
+    gaiaLinestringPtr ln;
+    gaiaPolygonPtr pg;
+    int ib;
+
+    pt = geom->FirstPoint;
+    while (pt != NULL)
+      {
+	  /* each Point belongs to a single Tile */
+	  int ix = do_find_tile (part->bound_x, part->tiles_x, pt->X);
+	  int iy = do_find_tile (part->bound_y, part->tiles_y, pt->Y);
+	  struct topo_tile *tile = part->tiles + (iy * part->tiles_x) + ix;
+	  if (tile->geom == NULL)
+	    {
+		if (part->has_z)
+		    tile->geom = gaiaAllocGeomCollXYZ ();
+		else
+		    tile->geom = gaiaAllocGeomColl ();
+		tile->geom->Srid = part->srid;
+	    }
+	  if (part->has_z)
+	      gaiaAddPointToGeomCollXYZ (tile->geom, pt->X, pt->Y, pt->Z);
+	  else
+	      gaiaAddPointToGeomColl (tile->geom, pt->X, pt->Y);
+	  pt = pt->Next;
+      }
+    ln = geom->FirstLinestring;
+    while (ln != NULL)
+      {
+	  do_partition_line (part, ln->Coords, ln->Points, ln->DimensionModel);
+	  ln = ln->Next;
+      }
+    pg = geom->FirstPolygon;
+    while (pg != NULL)
+      {
+	  /* Polygons are always imported as Rings */
+	  do_partition_line (part, pg->Exterior->Coords, pg->Exterior->Points,
+			     pg->Exterior->DimensionModel);
+	  for (ib = 0; ib < pg->NumInteriors; ib++)
+	    {
+		gaiaRingPtr rng = pg->Interiors + ib;
+		do_partition_line (part, rng->Coords, rng->Points,
+				   rng->DimensionModel);
+	    }
+	  pg = pg->Next;
+      }
+}
+
+static void
+do_build_tile (struct topo_partition *part, struct topo_tile *tile)
+{
+/* building the Topology of a single Tile */
+    if (tile->accessor == NULL || tile->geom == NULL)
+      {
+	  tile->status = 1;
+	  return;
+      }
+    tile->status =
+	auxtopo_insert_into_topology (tile->accessor, tile->geom,
+				      part->tolerance, part->line_max_points,
+				      part->max_length,
+				      GAIA_MODE_TOPO_NO_FACE, NULL);
+}
+
+static void
+do_build_tile_job (void *data, int i)
+{
+/* a worker job building a single Tile */
+    struct topo_partition *part = (struct topo_partition *) data;
+    do_build_tile (part, part->tiles + i);
+}
+
+static int
+cmp_tile_edges (const void *p1, const void *p2)
+{
+/* comparing two Tile Edges (qsort / bsearch) */
+    const struct topo_tile_edge *e1 = (const struct topo_tile_edge *) p1;
+    const struct topo_tile_edge *e2 = (const struct topo_tile_edge *) p2;
+    if (e1->edge_id == e2->edge_id)
+	return 0;
+    if (e1->edge_id > e2->edge_id)
+	return 1;
+    return -1;
+}
+
+static int
+cmp_tile_nodes (const void *p1, const void *p2)
+{
+/* comparing two Node IDs (qsort / bsearch) */
+    sqlite3_int64 n1 = *((const sqlite3_int64 *) p1);
+    sqlite3_int64 n2 = *((const sqlite3_int64 *) p2);
+    if (n1 == n2)
+	return 0;
+    if (n1 > n2)
+	return 1;
+    return -1;
+}
+
+static struct topo_tile_edge *
+do_find_tile_edge (struct topo_tile_edge *edges, int count,
+		   sqlite3_int64 edge_id)
+{
+/* searching a Tile Edge by ID */
+    struct topo_tile_edge key;
+    key.edge_id = edge_id;
+    return bsearch (&key, edges, count, sizeof (struct topo_tile_edge),
+		    cmp_tile_edges);
+}
+
+static sqlite3_int64
+do_skip_seam_edges (struct topo_tile_edge *edges, int count,
+		    sqlite3_int64 next)
+{
+/* 
+/ resolving the next Edge around a Node once all Seam Edges are
+/ removed: the successor of a removed half-edge is replaced by the
+/ successor of its twin, until some interior Edge is found
+*/
+    int i;
+    for (i = 0; i <= count; i++)
+      {
+	  struct topo_tile_edge *edge =
+	      do_find_tile_edge (edges, count, next < 0 ? -next : next);
+	  if (edge == NULL || edge->interior)
+	      return next;
+	  if (next > 0)
+	      next = edge->next_right;
+	  else
+	      next = edge->next_left;
+      }
+    return next;
+}
+
+static sqlite3_int64
+do_get_tile_max_id (sqlite3 * handle, const char *sql)
+{
+/* retrieving some max ID value */
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    sqlite3_int64 value = 0;
+
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    if (ret != SQLITE_OK)
+	return -1;
+    for (i = 1; i <= rows; i++)
+      {
+	  if (results[(i * columns) + 0] != NULL)
+	      value = atoll (results[(i * columns) + 0]);
+      }
+    sqlite3_free_table (results);
+    return value;
+}
+
+static int
+do_merge_tile (struct topo_tile *tile, struct gaia_topology *target)
+{
+/* 
+/ merging a Tile into the target Topology
+/
+/ all Nodes and Edges laying far enough from any seam are directly
+/ copied (simply renumbering their IDs); all other Edges will be
+/ then inserted by the usual way, so to be stitched together
+*/
+    struct gaia_topology *topo = (struct gaia_topology *) (tile->accessor);
+    struct topo_tile_edge *edges = NULL;
+    sqlite3_int64 *nodes = NULL;
+    int count = 0;
+    int max = 0;
+    int n_nodes = 0;
+    int ret;
+    char *sql;
+    char *table;
+    char *xedges;
+    char *xnodes;
+    char *xtarget;
+    sqlite3_int64 node_offset;
+    sqlite3_int64 edge_offset;
+    sqlite3_stmt *stmt_in = NULL;
+    sqlite3_stmt *stmt_out = NULL;
+    sqlite3_stmt *stmt_seam = NULL;
+
+    table = sqlite3_mprintf ("%s_edge", topo->topology_name);
+    xedges = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    table = sqlite3_mprintf ("%s_node", topo->topology_name);
+    xnodes = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+
+/* loading all Edges and classifying them */
+    sql =
+	sqlite3_mprintf ("SELECT edge_id, start_node, end_node, "
+			 "next_left_edge, next_right_edge, "
+			 "MbrMinX(geom) > ? AND MbrMaxX(geom) < ? AND "
+			 "MbrMinY(geom) > ? AND MbrMaxY(geom) < ? "
+			 "FROM MAIN.\"%s\" ORDER BY edge_id", xedges);
+    ret =
+	sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt_in,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    sqlite3_bind_double (stmt_in, 1, tile->inner_minx);
+    sqlite3_bind_double (stmt_in, 2, tile->inner_maxx);
+    sqlite3_bind_double (stmt_in, 3, tile->inner_miny);
+    sqlite3_bind_double (stmt_in, 4, tile->inner_maxy);
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  struct topo_tile_edge *edge;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  if (count >= max)
+	    {
+		max += 4096;
+		edges =
+		    realloc (edges, sizeof (struct topo_tile_edge) * max);
+		nodes = realloc (nodes, sizeof (sqlite3_int64) * 2 * max);
+	    }
+	  edge = edges + count;
+	  edge->edge_id = sqlite3_column_int64 (stmt_in, 0);
+	  edge->start_node = sqlite3_column_int64 (stmt_in, 1);
+	  edge->end_node = sqlite3_column_int64 (stmt_in, 2);
+	  edge->next_left = sqlite3_column_int64 (stmt_in, 3);
+	  edge->next_right = sqlite3_column_int64 (stmt_in, 4);
+	  edge->interior = sqlite3_column_int (stmt_in, 5);
+	  if (edge->interior)
+	    {
+		nodes[n_nodes++] = edge->start_node;
+		nodes[n_nodes++] = edge->end_node;
+	    }
+	  count++;
+      }
+    sqlite3_finalize (stmt_in);
+    stmt_in = NULL;
+    if (count == 0)
+	goto done;
+    if (n_nodes > 0)
+	qsort (nodes, n_nodes, sizeof (sqlite3_int64), cmp_tile_nodes);
+
+/* current IDs on the target Topology */
+    sql =
+	sqlite3_mprintf ("SELECT Max(node_id) FROM MAIN.\"%s_node\"",
+			 target->topology_name);
+    node_offset = do_get_tile_max_id (target->db_handle, sql);
+    sqlite3_free (sql);
+    sql = sqlite3_mprintf ("SELECT next_edge_id - 1 FROM MAIN.topologies "
+			   "WHERE Lower(topology_name) = Lower(%Q)",
+			   target->topology_name);
+    edge_offset = do_get_tile_max_id (target->db_handle, sql);
+    sqlite3_free (sql);
+    if (node_offset < 0 || edge_offset < 0)
+	goto error;
+
+/* copying all Nodes referenced by interior Edges */
+    sql = sqlite3_mprintf ("SELECT node_id, containing_face, geom "
+			   "FROM MAIN.\"%s\"", xnodes);
+    ret =
+	sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt_in,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    table = sqlite3_mprintf ("%s_node", target->topology_name);
+    xtarget = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("INSERT INTO MAIN.\"%s\" (node_id, "
+			   "containing_face, geom) VALUES (?, ?, ?)",
+			   xtarget);
+    free (xtarget);
+    ret =
+	sqlite3_prepare_v2 (target->db_handle, sql, strlen (sql), &stmt_out,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    while (n_nodes > 0)
+      {
+	  /* scrolling the result set rows */
+	  sqlite3_int64 node_id;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  node_id = sqlite3_column_int64 (stmt_in, 0);
+	  if (bsearch
+	      (&node_id, nodes, n_nodes, sizeof (sqlite3_int64),
+	       cmp_tile_nodes) == NULL)
+	      continue;
+	  sqlite3_reset (stmt_out);
+	  sqlite3_clear_bindings (stmt_out);
+	  sqlite3_bind_int64 (stmt_out, 1, node_id + node_offset);
+	  if (sqlite3_column_type (stmt_in, 1) == SQLITE_NULL)
+	      sqlite3_bind_null (stmt_out, 2);
+	  else
+	      sqlite3_bind_int64 (stmt_out, 2,
+				  sqlite3_column_int64 (stmt_in, 1));
+	  sqlite3_bind_blob (stmt_out, 3, sqlite3_column_blob (stmt_in, 2),
+			     sqlite3_column_bytes (stmt_in, 2),
+			     SQLITE_STATIC);
+	  ret = sqlite3_step (stmt_out);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_in);
+    stmt_in = NULL;
+    sqlite3_finalize (stmt_out);
+    stmt_out = NULL;
+
+/* copying all interior Edges */
+    sql = sqlite3_mprintf ("SELECT edge_id, left_face, right_face, geom "
+			   "FROM MAIN.\"%s\"", xedges);
+    ret =
+	sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt_in,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    table = sqlite3_mprintf ("%s_edge", target->topology_name);
+    xtarget = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("INSERT INTO MAIN.\"%s\" (edge_id, start_node, "
+			   "end_node, next_left_edge, next_right_edge, "
+			   "left_face, right_face, geom) "
+			   "VALUES (?, ?, ?, ?, ?, ?, ?, ?)", xtarget);
+    free (xtarget);
+    ret =
+	sqlite3_prepare_v2 (target->db_handle, sql, strlen (sql), &stmt_out,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  struct topo_tile_edge *edge;
+	  sqlite3_int64 next;
+	  ret = sqlite3_step (stmt_in);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  edge =
+	      do_find_tile_edge (edges, count,
+				 sqlite3_column_int64 (stmt_in, 0));
+	  if (edge == NULL || !(edge->interior))
+	      continue;
+	  sqlite3_reset (stmt_out);
+	  sqlite3_clear_bindings (stmt_out);
+	  sqlite3_bind_int64 (stmt_out, 1, edge->edge_id + edge_offset);
+	  sqlite3_bind_int64 (stmt_out, 2, edge->start_node + node_offset);
+	  sqlite3_bind_int64 (stmt_out, 3, edge->end_node + node_offset);
+	  next = do_skip_seam_edges (edges, count, edge->next_left);
+	  sqlite3_bind_int64 (stmt_out, 4,
+			      next < 0 ? next - edge_offset : next +
+			      edge_offset);
+	  next = do_skip_seam_edges (edges, count, edge->next_right);
+	  sqlite3_bind_int64 (stmt_out, 5,
+			      next < 0 ? next - edge_offset : next +
+			      edge_offset);
+	  if (sqlite3_column_type (stmt_in, 1) == SQLITE_NULL)
+	      sqlite3_bind_null (stmt_out, 6);
+	  else
+	      sqlite3_bind_int64 (stmt_out, 6,
+				  sqlite3_column_int64 (stmt_in, 1));
+	  if (sqlite3_column_type (stmt_in, 2) == SQLITE_NULL)
+	      sqlite3_bind_null (stmt_out, 7);
+	  else
+	      sqlite3_bind_int64 (stmt_out, 7,
+				  sqlite3_column_int64 (stmt_in, 2));
+	  sqlite3_bind_blob (stmt_out, 8, sqlite3_column_blob (stmt_in, 3),
+			     sqlite3_column_bytes (stmt_in, 3),
+			     SQLITE_STATIC);
+	  ret = sqlite3_step (stmt_out);
+	  if (ret != SQLITE_DONE && ret != SQLITE_ROW)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_in);
+    stmt_in = NULL;
+    sqlite3_finalize (stmt_out);
+    stmt_out = NULL;
+
+/* stitching all seam Edges */
+    sql = sqlite3_mprintf ("SELECT edge_id, geom FROM MAIN.\"%s\"", xedges);
+    ret =
+	sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt_seam,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto error;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  struct topo_tile_edge *edge;
+	  gaiaGeomCollPtr geom;
+	  sqlite3_int64 *ids = NULL;
+	  int ids_count;
+	  ret = sqlite3_step (stmt_seam);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  edge =
+	      do_find_tile_edge (edges, count,
+				 sqlite3_column_int64 (stmt_seam, 0));
+	  if (edge == NULL || edge->interior)
+	      continue;
+	  geom =
+	      gaiaFromSpatiaLiteBlobWkb (sqlite3_column_blob (stmt_seam, 1),
+					 sqlite3_column_bytes (stmt_seam,
+							       1));
+	  if (geom == NULL)
+	      goto error;
+	  if (geom->FirstLinestring == NULL)
+	    {
+		gaiaFreeGeomColl (geom);
+		continue;
+	    }
+	  ret =
+	      gaiaTopoGeo_AddLineStringNoFace ((GaiaTopologyAccessorPtr)
+					       target,
+					       geom->FirstLinestring,
+					       target->tolerance, &ids,
+					       &ids_count);
+	  gaiaFreeGeomColl (geom);
+	  if (ids != NULL)
+	      free (ids);
+	  if (!ret)
+	      goto error;
+      }
+    sqlite3_finalize (stmt_seam);
+    stmt_seam = NULL;
+
+  done:
+    if (edges != NULL)
+	free (edges);
+    if (nodes != NULL)
+	free (nodes);
+    free (xedges);
+    free (xnodes);
+    return 1;
+
+  error:
+    if (stmt_in != NULL)
+	sqlite3_finalize (stmt_in);
+    if (stmt_out != NULL)
+	sqlite3_finalize (stmt_out);
+    if (stmt_seam != NULL)
+	sqlite3_finalize (stmt_seam);
+    if (edges != NULL)
+	free (edges);
+    if (nodes != NULL)
+	free (nodes);
+    free (xedges);
+    free (xnodes);
+    return 0;
+}
+
+static int
+do_merge_tile_isolated_nodes (struct topo_tile *tile,
+			      struct gaia_topology *target)
+{
+/* inserting all isolated Nodes from a Tile */
+    struct gaia_topology *topo = (struct gaia_topology *) (tile->accessor);
+    char *sql;
+    char *table;
+    char *xnodes;
+    char *xedges;
+    int ret;
+    sqlite3_stmt *stmt = NULL;
+
+    table = sqlite3_mprintf ("%s_node", topo->topology_name);
+    xnodes = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    table = sqlite3_mprintf ("%s_edge", topo->topology_name);
+    xedges = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("SELECT n.geom FROM MAIN.\"%s\" AS n "
+			   "WHERE NOT EXISTS (SELECT 1 FROM MAIN.\"%s\" AS e "
+			   "WHERE e.start_node = n.node_id) AND NOT EXISTS "
+			   "(SELECT 1 FROM MAIN.\"%s\" AS e "
+			   "WHERE e.end_node = n.node_id)", xnodes, xedges,
+			   xedges);
+    free (xnodes);
+    free (xedges);
+    ret =
+	sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  gaiaGeomCollPtr geom;
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret != SQLITE_ROW)
+	      goto error;
+	  geom =
+	      gaiaFromSpatiaLiteBlobWkb (sqlite3_column_blob (stmt, 0),
+					 sqlite3_column_bytes (stmt, 0));
+	  if (geom == NULL)
+	      goto error;
+	  if (geom->FirstPoint != NULL)
+	    {
+		if (gaiaTopoGeo_AddPoint
+		    ((GaiaTopologyAccessorPtr) target, geom->FirstPoint,
+		     target->tolerance) < 0)
+		  {
+		      gaiaFreeGeomColl (geom);
+		      goto error;
+		  }
+	    }
+	  gaiaFreeGeomColl (geom);
+      }
+    sqlite3_finalize (stmt);
+    return 1;
+
+  error:
+    sqlite3_finalize (stmt);
+    return 0;
+}
+
+static void
+do_heal_tile_cuts (struct topo_partition *part, struct gaia_topology *target)
+{
+/* removing all Nodes artificially introduced by clipping along seams */
+    char *sql;
+    char *table;
+    char *xnodes;
+    char *xedges;
+    int ret;
+    int i;
+    sqlite3_stmt *stmt_node = NULL;
+    sqlite3_stmt *stmt_edges = NULL;
+
+    if (part->cuts_count == 0)
+	return;
+    table = sqlite3_mprintf ("%s_node", target->topology_name);
+    xnodes = gaiaDoubleQuotedSql (table);
+    sql = sqlite3_mprintf ("SELECT node_id FROM MAIN.\"%s\" "
+			   "WHERE ST_X(geom) = ?1 AND ST_Y(geom) = ?2 AND "
+			   "ROWID IN (SELECT ROWID FROM SpatialIndex "
+			   "WHERE f_table_name = %Q AND f_geometry_column = "
+			   "'geom' AND search_frame = BuildMbr(?1, ?2, ?1, ?2))",
+			   xnodes, table);
+    sqlite3_free (table);
+    free (xnodes);
+    ret =
+	sqlite3_prepare_v2 (target->db_handle, sql, strlen (sql), &stmt_node,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto stop;
+    table = sqlite3_mprintf ("%s_edge", target->topology_name);
+    xedges = gaiaDoubleQuotedSql (table);
+    sqlite3_free (table);
+    sql = sqlite3_mprintf ("SELECT edge_id FROM MAIN.\"%s\" "
+			   "WHERE start_node = ?1 UNION "
+			   "SELECT edge_id FROM MAIN.\"%s\" "
+			   "WHERE end_node = ?1", xedges, xedges);
+    free (xedges);
+    ret =
+	sqlite3_prepare_v2 (target->db_handle, sql, strlen (sql), &stmt_edges,
+			    NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto stop;
+
+    for (i = 0; i < part->cuts_count; i++)
+      {
+	  sqlite3_int64 node_id = -1;
+	  sqlite3_int64 edge_ids[2];
+	  int n_edges = 0;
+	  sqlite3_reset (stmt_node);
+	  sqlite3_clear_bindings (stmt_node);
+	  sqlite3_bind_double (stmt_node, 1, part->cuts[i * 2]);
+	  sqlite3_bind_double (stmt_node, 2, part->cuts[(i * 2) + 1]);
+	  while (sqlite3_step (stmt_node) == SQLITE_ROW)
+	      node_id = sqlite3_column_int64 (stmt_node, 0);
+	  if (node_id < 0)
+	      continue;
+	  sqlite3_reset (stmt_edges);
+	  sqlite3_clear_bindings (stmt_edges);
+	  sqlite3_bind_int64 (stmt_edges, 1, node_id);
+	  while (sqlite3_step (stmt_edges) == SQLITE_ROW)
+	    {
+		if (n_edges < 2)
+		    edge_ids[n_edges] = sqlite3_column_int64 (stmt_edges, 0);
+		n_edges++;
+	    }
+	  sqlite3_reset (stmt_edges);
+	  if (n_edges != 2)
+	      continue;         /* not a simple pass-through Node */
+	  gaiaModEdgeHeal ((GaiaTopologyAccessorPtr) target, edge_ids[0],
+			   edge_ids[1]);
+      }
+    gaiaResetRtTopoMsg (target->cache);
+
+  stop:
+    if (stmt_node != NULL)
+	sqlite3_finalize (stmt_node);
+    if (stmt_edges != NULL)
+	sqlite3_finalize (stmt_edges);
+}
+
+static void
+do_free_partition (struct topo_partition *part)
+{
+/* memory cleanup - destroying a partitioned Topology build */
+    int i;
+    if (part->tiles != NULL)
+      {
+	  for (i = 0; i < part->count; i++)
+	    {
+		struct topo_tile *tile = part->tiles + i;
+		if (tile->geom != NULL)
+		    gaiaFreeGeomColl (tile->geom);
+		if (tile->accessor != NULL)
+		    gaiaTopologyMemoryDestroy (tile->accessor);
+	    }
+	  free (part->tiles);
+      }
+    if (part->bound_x != NULL)
+	free (part->bound_x);
+    if (part->bound_y != NULL)
+	free (part->bound_y);
+    if (part->cuts != NULL)
+	free (part->cuts);
+}
+
+static int
+do_check_empty_topology (struct gaia_topology *topo)
+{
+/* checking if the target Topology is still empty */
+    char *sql;
+    sqlite3_int64 count;
+    sql = sqlite3_mprintf ("SELECT Count(*) FROM (SELECT node_id FROM "
+			   "MAIN.\"%s_node\" LIMIT 1)", topo->topology_name);
+    count = do_get_tile_max_id (topo->db_handle, sql);
+    sqlite3_free (sql);
+    if (count != 0)
+	return 0;
+    return 1;
+}
+
+GAIATOPO_DECLARE int
+gaiaTopoGeo_FromGeoTablePartitioned (GaiaTopologyAccessorPtr accessor,
+				     const char *db_prefix,
+				     const char *table, const char *column,
+				     double tolerance, int line_max_points,
+				     double max_length, int tiles,
+				     int num_threads)
+{
+/* attempting to import a whole GeoTable into a Topology-Geometry - Partitioned mode */
+    struct gaia_topology *topo = (struct gaia_topology *) accessor;
+    struct gaia_topology *target = NULL;
+    struct topo_partition part;
+    sqlite3_stmt *stmt = NULL;
+    int ret;
+    int i;
+    int ix;
+    int iy;
+    char *sql;
+    char *msg;
+    char *xprefix;
+    char *xtable;
+    char *xcolumn;
+    int gpkg_amphibious = 0;
+    int gpkg_mode = 0;
+    int pass;
+    double minx = DBL_MAX;
+    double miny = DBL_MAX;
+    double maxx = -DBL_MAX;
+    double maxy = -DBL_MAX;
+    double margin;
+
+    if (topo == NULL)
+	return 0;
+    if (topo->origin_handle != NULL)
+	return 0;               /* already a memory-resident Topology */
+    if (topo->cache != NULL)
+      {
+	  struct splite_internal_cache *cache =
+	      (struct splite_internal_cache *) (topo->cache);
+	  gpkg_amphibious = cache->gpkg_amphibious_mode;
+	  gpkg_mode = cache->gpkg_mode;
+      }
+    if (tiles < 1)
+	tiles = 1;
+    if (tolerance < 0.0)
+	tolerance = topo->tolerance;
+    memset (&part, 0, sizeof (struct topo_partition));
+    part.srid = topo->srid;
+    part.has_z = topo->has_z;
+    part.tolerance = tolerance;
+    part.line_max_points = line_max_points;
+    part.max_length = max_length;
+    if (!do_check_empty_topology (topo))
+      {
+	  msg =
+	      sqlite3_mprintf
+	      ("TopoGeo_FromGeoTablePartitioned error: the target Topology is not empty");
+	  gaiatopo_set_last_error_msg (accessor, msg);
+	  gaiaSetRtTopoErrorMsg (topo->cache, msg);
+	  sqlite3_free (msg);
+	  return 0;
+      }
+
+/* building the SQL statement */
+    xprefix = gaiaDoubleQuotedSql (db_prefix);
+    xtable = gaiaDoubleQuotedSql (table);
+    xcolumn = gaiaDoubleQuotedSql (column);
+    sql =
+	sqlite3_mprintf ("SELECT \"%s\" FROM \"%s\".\"%s\"", xcolumn,
+			 xprefix, xtable);
+    free (xprefix);
+    free (xtable);
+    free (xcolumn);
+    ret =
+	sqlite3_prepare_v2 (topo->db_handle, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	goto sql_error;
+
+    for (pass = 0; pass < 2; pass++)
+      {
+	  /* 
+	  / first pass: determining the full extent
+	  / second pass: distributing all Geometries between Tiles
+	  */
+	  sqlite3_reset (stmt);
+	  while (1)
+	    {
+		/* scrolling the result set rows */
+		gaiaGeomCollPtr geom;
+		ret = sqlite3_step (stmt);
+		if (ret == SQLITE_DONE)
+		    break;	/* end of result set */
+		if (ret != SQLITE_ROW)
+		    goto sql_error;
+		if (sqlite3_column_type (stmt, 0) == SQLITE_NULL)
+		    continue;
+		if (sqlite3_column_type (stmt, 0) != SQLITE_BLOB)
+		  {
+		      msg =
+			  sqlite3_mprintf
+			  ("TopoGeo_FromGeoTablePartitioned error: not a BLOB value");
+		      goto error;
+		  }
+		geom =
+		    gaiaFromSpatiaLiteBlobWkbEx (sqlite3_column_blob
+						 (stmt, 0),
+						 sqlite3_column_bytes (stmt,
+								       0),
+						 gpkg_mode, gpkg_amphibious);
+		if (geom == NULL)
+		  {
+		      msg =
+			  sqlite3_mprintf
+			  ("TopoGeo_FromGeoTablePartitioned error: Invalid Geometry");
+		      goto error;
+		  }
+		if (pass == 0)
+		  {
+		      gaiaMbrGeometry (geom);
+		      if (geom->MinX < minx)
+			  minx = geom->MinX;
+		      if (geom->MinY < miny)
+			  miny = geom->MinY;
+		      if (geom->MaxX > maxx)
+			  maxx = geom->MaxX;
+		      if (geom->MaxY > maxy)
+			  maxy = geom->MaxY;
+		  }
+		else
+		    do_partition_geometry (&part, geom);
+		gaiaFreeGeomColl (geom);
+	    }
+	  if (pass > 0)
+	      break;
+	  if (minx > maxx)
+	    {
+		/* empty input table */
+		sqlite3_finalize (stmt);
+		return 1;
+	    }
+
+	  /* preparing the Tiles */
+	  part.tiles_x = (maxx > minx) ? tiles : 1;
+	  part.tiles_y = (maxy > miny) ? tiles : 1;
+	  part.bound_x = malloc (sizeof (double) * (part.tiles_x + 1));
+	  part.bound_y = malloc (sizeof (double) * (part.tiles_y + 1));
+	  for (ix = 0; ix <= part.tiles_x; ix++)
+	      part.bound_x[ix] =
+		  minx + (((maxx - minx) * (double) ix) /
+			  (double) (part.tiles_x));
+	  for (iy = 0; iy <= part.tiles_y; iy++)
+	      part.bound_y[iy] =
+		  miny + (((maxy - miny) * (double) iy) /
+			  (double) (part.tiles_y));
+	  part.bound_x[part.tiles_x] = maxx;
+	  part.bound_y[part.tiles_y] = maxy;
+	  margin = (3.0 * tolerance) + (((maxx - minx) + (maxy - miny)) *
+					0.000001);
+	  part.count = part.tiles_x * part.tiles_y;
+	  part.tiles = malloc (sizeof (struct topo_tile) * part.count);
+	  for (iy = 0; iy < part.tiles_y; iy++)
+	    {
+		for (ix = 0; ix < part.tiles_x; ix++)
+		  {
+		      struct topo_tile *tile =
+			  part.tiles + (iy * part.tiles_x) + ix;
+		      tile->minx = part.bound_x[ix];
+		      tile->maxx = part.bound_x[ix + 1];
+		      tile->miny = part.bound_y[iy];
+		      tile->maxy = part.bound_y[iy + 1];
+		      /* only true seams require stitching */
+		      tile->inner_minx =
+			  (ix == 0) ? -DBL_MAX : tile->minx + margin;
+		      tile->inner_maxx =
+			  (ix == part.tiles_x - 1) ? DBL_MAX : tile->maxx -
+			  margin;
+		      tile->inner_miny =
+			  (iy == 0) ? -DBL_MAX : tile->miny + margin;
+		      tile->inner_maxy =
+			  (iy == part.tiles_y - 1) ? DBL_MAX : tile->maxy -
+			  margin;
+		      tile->geom = NULL;
+		      tile->accessor = NULL;
+		      tile->status = -1;
+		  }
+	    }
+      }
+    sqlite3_finalize (stmt);
+    stmt = NULL;
+
+/* creating an in-memory Topology for each Tile */
+    for (i = 0; i < part.count; i++)
+      {
+	  struct topo_tile *tile = part.tiles + i;
+	  if (tile->geom == NULL)
+	      continue;
+	  tile->accessor = gaiaTopologyMemoryCreate (accessor);
+	  if (tile->accessor == NULL)
+	    {
+		msg =
+		    sqlite3_mprintf
+		    ("TopoGeo_FromGeoTablePartitioned error: unable to create an in-memory Topology");
+		goto error;
+	    }
+      }
+
+/* building all Tiles in parallel */
+    auxtopo_run_parallel (do_build_tile_job, &part, part.count, num_threads,
+			  NULL, NULL);
+    for (i = 0; i < part.count; i++)
+      {
+	  struct topo_tile *tile = part.tiles + i;
+	  if (tile->status == 1)
+	      continue;
+	  /* the failing Tile will forward its own error message */
+	  gaiaTopologyMemoryDestroy (tile->accessor);
+	  tile->accessor = NULL;
+	  do_free_partition (&part);
+	  return 0;
+      }
+
+/* merging all Tiles into an in-memory copy of the target Topology */
+    target = (struct gaia_topology *) gaiaTopologyMemoryCreate (accessor);
+    if (target == NULL)
+      {
+	  msg =
+	      sqlite3_mprintf
+	      ("TopoGeo_FromGeoTablePartitioned error: unable to create an in-memory Topology");
+	  goto error;
+      }
+    for (i = 0; i < part.count; i++)
+      {
+	  struct topo_tile *tile = part.tiles + i;
+	  if (tile->accessor == NULL)
+	      continue;
+	  if (!do_merge_tile (tile, target))
+	      goto merge_error;
+      }
+    if (!gaiaTopoGeo_Polygonize ((GaiaTopologyAccessorPtr) target))
+	goto merge_error;
+    for (i = 0; i < part.count; i++)
+      {
+	  struct topo_tile *tile = part.tiles + i;
+	  if (tile->accessor == NULL)
+	      continue;
+	  if (!do_merge_tile_isolated_nodes (tile, target))
+	      goto merge_error;
+      }
+    do_heal_tile_cuts (&part, target);
+
+/* writing back the whole Topology */
+    if (!gaiaTopologyMemoryFlush ((GaiaTopologyAccessorPtr) target))
+	goto merge_error;
+    gaiaTopologyMemoryDestroy ((GaiaTopologyAccessorPtr) target);
+    do_free_partition (&part);
+    return 1;
+
+  sql_error:
+    msg =
+	sqlite3_mprintf ("TopoGeo_FromGeoTablePartitioned error: \"%s\"",
+			 sqlite3_errmsg (topo->db_handle));
+  error:
+    gaiatopo_set_last_error_msg (accessor, msg);
+    gaiaSetRtTopoErrorMsg (topo->cache, msg);
+    sqlite3_free (msg);
+    if (stmt != NULL)
+	sqlite3_finalize (stmt);
+    do_free_partition (&part);
+    return 0;
+
+  merge_error:
+    if (gaiaGetRtTopoErrorMsg (target->cache) == NULL)
+      {
+	  msg =
+	      sqlite3_mprintf
+	      ("TopoGeo_FromGeoTablePartitioned error: \"%s\"",
+	       sqlite3_errmsg (target->db_handle));
+	  gaiaSetRtTopoErrorMsg (target->cache, msg);
+	  sqlite3_free (msg);
+      }
+    gaiaTopologyMemoryDestroy ((GaiaTopologyAccessorPtr) target);
+    do_free_partition (&part);
+    return 0;
+}
+
 GAIATOPO_DECLARE gaiaGeomCollPtr
 gaiaGetEdgeSeed (GaiaTopologyAccessorPtr accessor, sqlite3_int64 edge)
 {
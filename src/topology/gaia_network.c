@@ -2246,6 +2246,7 @@ fnctaux_ValidLogicalNet (const void *xcontext, int argc, const void *xargv)
 {
 /* SQL function:
 / ST_ValidLogicalNet ( text network-name )
+/ ST_ValidLogicalNet ( text network-name , int threads )
 /
 / create/update a table containing an validation report for a given
 / Logical Network
@@ -2255,6 +2256,7 @@ fnctaux_ValidLogicalNet (const void *xcontext, int argc, const void *xargv)
 */
     const char *network_name;
     int ret;
+    int num_threads = 1;
     GaiaNetworkAccessorPtr accessor;
     struct gaia_network *net;
     sqlite3_context *context = (sqlite3_context *) xcontext;
@@ -2268,6 +2270,13 @@ fnctaux_ValidLogicalNet (const void *xcontext, int argc, const void *xargv)
 	network_name = (const char *) sqlite3_value_text (argv[0]);
     else
 	goto invalid_arg;
+    if (argc >= 2)
+      {
+	  if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
+	      num_threads = sqlite3_value_int (argv[1]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Network Accessor */
     accessor = gaiaGetNetwork (sqlite, cache, network_name);
@@ -2281,7 +2290,7 @@ fnctaux_ValidLogicalNet (const void *xcontext, int argc, const void *xargv)
 
     gaianet_reset_last_error_msg (accessor);
     start_net_savepoint (sqlite, cache);
-    ret = gaiaValidLogicalNet (accessor);
+    ret = gaiaValidLogicalNetEx (accessor, num_threads, NULL, NULL);
     if (!ret)
 	rollback_net_savepoint (sqlite, cache);
     else
@@ -2329,6 +2338,7 @@ fnctaux_ValidSpatialNet (const void *xcontext, int argc, const void *xargv)
 {
 /* SQL function:
 / ST_ValidSpatialNet ( text network-name )
+/ ST_ValidSpatialNet ( text network-name , int threads )
 /
 / create/update a table containing an validation report for a given
 / Spatial Network
@@ -2338,6 +2348,7 @@ fnctaux_ValidSpatialNet (const void *xcontext, int argc, const void *xargv)
 */
     const char *network_name;
     int ret;
+    int num_threads = 1;
     GaiaNetworkAccessorPtr accessor;
     struct gaia_network *net;
     sqlite3_context *context = (sqlite3_context *) xcontext;
@@ -2351,6 +2362,13 @@ fnctaux_ValidSpatialNet (const void *xcontext, int argc, const void *xargv)
 	network_name = (const char *) sqlite3_value_text (argv[0]);
     else
 	goto invalid_arg;
+    if (argc >= 2)
+      {
+	  if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
+	      num_threads = sqlite3_value_int (argv[1]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Network Accessor */
     accessor = gaiaGetNetwork (sqlite, cache, network_name);
@@ -2364,7 +2382,7 @@ fnctaux_ValidSpatialNet (const void *xcontext, int argc, const void *xargv)
 
     gaianet_reset_last_error_msg (accessor);
     start_net_savepoint (sqlite, cache);
-    ret = gaiaValidSpatialNet (accessor);
+    ret = gaiaValidSpatialNetEx (accessor, num_threads, NULL, NULL);
     if (!ret)
 	rollback_net_savepoint (sqlite, cache);
     else
@@ -2412,6 +2430,8 @@ fnctaux_SpatNetFromGeom (const void *xcontext, int argc, const void *xargv)
 {
 /* SQL function:
 / ST_SpatNetFromGeom ( text network-name , blob geom-collection )
+/ ST_SpatNetFromGeom ( text network-name , blob geom-collection ,
+/                      int in_memory )
 /
 / creates and populates an empty Network by importing a Geometry-collection
 /
@@ -2425,7 +2445,9 @@ fnctaux_SpatNetFromGeom (const void *xcontext, int argc, const void *xargv)
     gaiaGeomCollPtr geom = NULL;
     int gpkg_amphibious = 0;
     int gpkg_mode = 0;
+    int in_memory = 0;
     GaiaNetworkAccessorPtr accessor;
+    GaiaNetworkAccessorPtr mem_accessor = NULL;
     struct gaia_network *net;
     sqlite3_context *context = (sqlite3_context *) xcontext;
     sqlite3_value **argv = (sqlite3_value **) xargv;
@@ -2457,6 +2479,13 @@ fnctaux_SpatNetFromGeom (const void *xcontext, int argc, const void *xargv)
 	goto invalid_arg;
     if (geom == NULL)
 	goto not_geom;
+    if (argc >= 3)
+      {
+	  if (sqlite3_value_type (argv[2]) == SQLITE_INTEGER)
+	      in_memory = sqlite3_value_int (argv[2]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Network Accessor */
     accessor = gaiaGetNetwork (sqlite, cache, network_name);
@@ -2471,8 +2500,25 @@ fnctaux_SpatNetFromGeom (const void *xcontext, int argc, const void *xargv)
 	goto invalid_geom;
 
     gaianet_reset_last_error_msg (accessor);
+    if (in_memory)
+      {
+	  /* building the Network on a memory-resident replica */
+	  mem_accessor = gaiaNetworkMemoryCreate (accessor);
+	  if (mem_accessor == NULL)
+	      goto no_memory;
+      }
+
     start_net_savepoint (sqlite, cache);
-    ret = auxnet_insert_into_network (accessor, geom);
+    ret =
+	auxnet_insert_into_network (mem_accessor !=
+				    NULL ? mem_accessor : accessor, geom);
+    if (mem_accessor != NULL)
+      {
+	  /* writing back the whole Network in a single pass */
+	  if (ret)
+	      ret = gaiaNetworkMemoryFlush (mem_accessor);
+	  gaiaNetworkMemoryDestroy (mem_accessor);
+      }
     if (!ret)
 	rollback_net_savepoint (sqlite, cache);
     else
@@ -2496,6 +2542,14 @@ fnctaux_SpatNetFromGeom (const void *xcontext, int argc, const void *xargv)
 			  -1);
     return;
 
+  no_memory:
+    if (geom != NULL)
+	gaiaFreeGeomColl (geom);
+    sqlite3_result_error (context,
+			  "SQL/MM Spatial exception - unable to create the in-memory Network.",
+			  -1);
+    return;
+
   logical_err:
     sqlite3_result_error (context,
 			  "ST_ValidSpatialNet() cannot be applied to Logical Network.",
@@ -3002,6 +3056,8 @@ fnctaux_TopoNet_FromGeoTable (const void *xcontext, int argc, const void *xargv)
 /* SQL function:
 / TopoNet_FromGeoTable ( text network-name, text db-prefix, text table,
 /                        text column )
+/ TopoNet_FromGeoTable ( text network-name, text db-prefix, text table,
+/                        text column, int in_memory )
 /
 / returns: 1 on success
 / raises an exception on failure
@@ -3016,7 +3072,9 @@ fnctaux_TopoNet_FromGeoTable (const void *xcontext, int argc, const void *xargv)
     int srid;
     int dims;
     int linear;
+    int in_memory = 0;
     GaiaNetworkAccessorPtr accessor;
+    GaiaNetworkAccessorPtr mem_accessor = NULL;
     struct gaia_network *net;
     sqlite3_context *context = (sqlite3_context *) xcontext;
     sqlite3_value **argv = (sqlite3_value **) xargv;
@@ -3045,6 +3103,13 @@ fnctaux_TopoNet_FromGeoTable (const void *xcontext, int argc, const void *xargv)
 	column = (const char *) sqlite3_value_text (argv[3]);
     else
 	goto invalid_arg;
+    if (argc >= 5)
+      {
+	  if (sqlite3_value_type (argv[4]) == SQLITE_INTEGER)
+	      in_memory = sqlite3_value_int (argv[4]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Network Accessor */
     accessor = gaiaGetNetwork (sqlite, cache, network_name);
@@ -3063,8 +3128,26 @@ fnctaux_TopoNet_FromGeoTable (const void *xcontext, int argc, const void *xargv)
 	goto invalid_geom;
 
     gaianet_reset_last_error_msg (accessor);
+    if (in_memory)
+      {
+	  /* building the Network on a memory-resident replica */
+	  mem_accessor = gaiaNetworkMemoryCreate (accessor);
+	  if (mem_accessor == NULL)
+	      goto no_memory;
+      }
+
     start_net_savepoint (sqlite, cache);
-    ret = gaiaTopoNet_FromGeoTable (accessor, db_prefix, xtable, xcolumn);
+    ret =
+	gaiaTopoNet_FromGeoTable (mem_accessor !=
+				  NULL ? mem_accessor : accessor, db_prefix,
+				  xtable, xcolumn);
+    if (mem_accessor != NULL)
+      {
+	  /* writing back the whole Network in a single pass */
+	  if (ret)
+	      ret = gaiaNetworkMemoryFlush (mem_accessor);
+	  gaiaNetworkMemoryDestroy (mem_accessor);
+      }
     if (!ret)
 	rollback_net_savepoint (sqlite, cache);
     else
@@ -3091,6 +3174,16 @@ fnctaux_TopoNet_FromGeoTable (const void *xcontext, int argc, const void *xargv)
 			  -1);
     return;
 
+  no_memory:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    sqlite3_result_error (context,
+			  "SQL/MM Spatial exception - unable to create the in-memory Network.",
+			  -1);
+    return;
+
   no_input:
     if (xtable != NULL)
 	free (xtable);
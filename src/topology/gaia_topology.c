@@ -2348,6 +2348,7 @@ fnctaux_ValidateTopoGeo (const void *xcontext, int argc, const void *xargv)
 {
 /* SQL function:
 / ST_ValidateTopoGeo ( text topology-name )
+/ ST_ValidateTopoGeo ( text topology-name , int threads )
 /
 / create/update a table containing an validation report for a given TopoGeo
 /
@@ -2357,6 +2358,7 @@ fnctaux_ValidateTopoGeo (const void *xcontext, int argc, const void *xargv)
     const char *msg;
     const char *topo_name;
     int ret;
+    int num_threads = 1;
     GaiaTopologyAccessorPtr accessor = NULL;
     struct gaia_topology *topo;
     sqlite3_context *context = (sqlite3_context *) xcontext;
@@ -2370,6 +2372,13 @@ fnctaux_ValidateTopoGeo (const void *xcontext, int argc, const void *xargv)
 	topo_name = (const char *) sqlite3_value_text (argv[0]);
     else
 	goto invalid_arg;
+    if (argc >= 2)
+      {
+	  if (sqlite3_value_type (argv[1]) == SQLITE_INTEGER)
+	      num_threads = sqlite3_value_int (argv[1]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Topology Accessor */
     accessor = gaiaGetTopology (sqlite, cache, topo_name);
@@ -2381,7 +2390,7 @@ fnctaux_ValidateTopoGeo (const void *xcontext, int argc, const void *xargv)
 	goto empty;
 
     start_topo_savepoint (sqlite, cache);
-    ret = gaiaValidateTopoGeo (accessor);
+    ret = gaiaValidateTopoGeoEx (accessor, num_threads, NULL, NULL);
     if (!ret)
 	rollback_topo_savepoint (sqlite, cache);
     else
@@ -4465,6 +4474,9 @@ fnctaux_TopoGeo_FromGeoTable (const void *xcontext, int argc, const void *xargv)
 / TopoGeo_FromGeoTable ( text topology-name, text db-prefix, text table,
 /                        text column, int line_max_points, double max_length, 
 /                        double tolerance )
+/ TopoGeo_FromGeoTable ( text topology-name, text db-prefix, text table,
+/                        text column, int line_max_points, double max_length, 
+/                        double tolerance, int in_memory )
 /
 / returns: 1 on success
 / raises an exception on failure
@@ -4483,7 +4495,9 @@ fnctaux_TopoGeo_FromGeoTable (const void *xcontext, int argc, const void *xargv)
     int line_max_points = -1;
     double max_length = -1.0;
     double tolerance = -1;
+    int in_memory = 0;
     GaiaTopologyAccessorPtr accessor = NULL;
+    GaiaTopologyAccessorPtr mem_accessor = NULL;
     sqlite3_context *context = (sqlite3_context *) xcontext;
     sqlite3_value **argv = (sqlite3_value **) xargv;
     sqlite3 *sqlite = sqlite3_context_db_handle (context);
@@ -4561,6 +4575,13 @@ fnctaux_TopoGeo_FromGeoTable (const void *xcontext, int argc, const void *xargv)
 	  if (tolerance < 0.0)
 	      goto negative_tolerance;
       }
+    if (argc >= 8)
+      {
+	  if (sqlite3_value_type (argv[7]) == SQLITE_INTEGER)
+	      in_memory = sqlite3_value_int (argv[7]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Topology Accessor */
     accessor = gaiaGetTopology (sqlite, cache, topo_name);
@@ -4576,10 +4597,27 @@ fnctaux_TopoGeo_FromGeoTable (const void *xcontext, int argc, const void *xargv)
     if (!check_matching_srid_dims (accessor, srid, dims))
 	goto invalid_geom;
 
+    if (in_memory)
+      {
+	  /* building the Topology on a memory-resident replica */
+	  mem_accessor = gaiaTopologyMemoryCreate (accessor);
+	  if (mem_accessor == NULL)
+	      goto no_memory;
+      }
+
     start_topo_savepoint (sqlite, cache);
     ret =
-	gaiaTopoGeo_FromGeoTable (accessor, db_prefix, xtable, xcolumn,
-				  tolerance, line_max_points, max_length);
+	gaiaTopoGeo_FromGeoTable (mem_accessor !=
+				  NULL ? mem_accessor : accessor, db_prefix,
+				  xtable, xcolumn, tolerance, line_max_points,
+				  max_length);
+    if (mem_accessor != NULL)
+      {
+	  /* writing back the whole Topology in a single pass */
+	  if (ret)
+	      ret = gaiaTopologyMemoryFlush (mem_accessor);
+	  gaiaTopologyMemoryDestroy (mem_accessor);
+      }
     if (!ret)
 	rollback_topo_savepoint (sqlite, cache);
     else
@@ -4606,6 +4644,16 @@ fnctaux_TopoGeo_FromGeoTable (const void *xcontext, int argc, const void *xargv)
     sqlite3_result_error (context, msg, -1);
     return;
 
+  no_memory:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - unable to create the in-memory Topology.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
   no_input:
     if (xtable != NULL)
 	free (xtable);
@@ -4917,6 +4965,250 @@ fnctaux_TopoGeo_FromGeoTableNoFace (const void *xcontext, int argc,
     return;
 }
 
+SPATIALITE_PRIVATE void
+fnctaux_TopoGeo_FromGeoTablePartitioned (const void *xcontext, int argc,
+					 const void *xargv)
+{
+/* SQL function:
+/ TopoGeo_FromGeoTablePartitioned ( text topology-name, text db-prefix,
+/                        text table, text column, int tiles, int threads )
+/ TopoGeo_FromGeoTablePartitioned ( text topology-name, text db-prefix,
+/                        text table, text column, int tiles, int threads,
+/                        int line_max_points )
+/ TopoGeo_FromGeoTablePartitioned ( text topology-name, text db-prefix,
+/                        text table, text column, int tiles, int threads,
+/                        int line_max_points, double max_length )
+/ TopoGeo_FromGeoTablePartitioned ( text topology-name, text db-prefix,
+/                        text table, text column, int tiles, int threads,
+/                        int line_max_points, double max_length, 
+/                        double tolerance )
+/
+/ returns: 1 on success
+/ raises an exception on failure
+*/
+    const char *msg;
+    int ret;
+    const char *topo_name;
+    const char *db_prefix;
+    const char *table;
+    const char *column;
+    char *xtable = NULL;
+    char *xcolumn = NULL;
+    int srid;
+    int family;
+    int dims;
+    int line_max_points = -1;
+    double max_length = -1.0;
+    double tolerance = -1;
+    int tiles;
+    int num_threads;
+    GaiaTopologyAccessorPtr accessor = NULL;
+    sqlite3_context *context = (sqlite3_context *) xcontext;
+    sqlite3_value **argv = (sqlite3_value **) xargv;
+    sqlite3 *sqlite = sqlite3_context_db_handle (context);
+    struct splite_internal_cache *cache = sqlite3_user_data (context);
+    GAIA_UNUSED ();		/* LCOV_EXCL_LINE */
+    if (sqlite3_value_type (argv[0]) == SQLITE_NULL)
+	goto null_arg;
+    else if (sqlite3_value_type (argv[0]) == SQLITE_TEXT)
+	topo_name = (const char *) sqlite3_value_text (argv[0]);
+    else
+	goto invalid_arg;
+    if (sqlite3_value_type (argv[1]) == SQLITE_NULL)
+	db_prefix = "main";
+    else if (sqlite3_value_type (argv[1]) == SQLITE_TEXT)
+	db_prefix = (const char *) sqlite3_value_text (argv[1]);
+    else
+	goto invalid_arg;
+    if (sqlite3_value_type (argv[2]) == SQLITE_NULL)
+	goto null_arg;
+    else if (sqlite3_value_type (argv[2]) == SQLITE_TEXT)
+	table = (const char *) sqlite3_value_text (argv[2]);
+    else
+	goto invalid_arg;
+    if (sqlite3_value_type (argv[3]) == SQLITE_NULL)
+	column = NULL;
+    else if (sqlite3_value_type (argv[3]) == SQLITE_TEXT)
+	column = (const char *) sqlite3_value_text (argv[3]);
+    else
+	goto invalid_arg;
+    if (sqlite3_value_type (argv[4]) == SQLITE_INTEGER)
+	tiles = sqlite3_value_int (argv[4]);
+    else
+	goto invalid_arg;
+    if (tiles < 1)
+	goto invalid_arg;
+    if (sqlite3_value_type (argv[5]) == SQLITE_INTEGER)
+	num_threads = sqlite3_value_int (argv[5]);
+    else
+	goto invalid_arg;
+    if (argc >= 7)
+      {
+	  if (sqlite3_value_type (argv[6]) == SQLITE_NULL)
+	      ;
+	  else if (sqlite3_value_type (argv[6]) == SQLITE_INTEGER)
+	    {
+		line_max_points = sqlite3_value_int (argv[6]);
+		if (line_max_points < 2)
+		    goto illegal_max_points;
+	    }
+	  else
+	      goto invalid_arg;
+      }
+    if (argc >= 8)
+      {
+	  if (sqlite3_value_type (argv[7]) == SQLITE_NULL)
+	      ;
+	  else
+	    {
+		if (sqlite3_value_type (argv[7]) == SQLITE_INTEGER)
+		  {
+		      int max = sqlite3_value_int (argv[7]);
+		      max_length = max;
+		  }
+		else if (sqlite3_value_type (argv[7]) == SQLITE_FLOAT)
+		    max_length = sqlite3_value_double (argv[7]);
+		else
+		    goto invalid_arg;
+		if (max_length <= 0.0)
+		    goto nonpositive_max_length;
+	    }
+      }
+    if (argc >= 9)
+      {
+	  if (sqlite3_value_type (argv[8]) == SQLITE_NULL)
+	      goto null_arg;
+	  else if (sqlite3_value_type (argv[8]) == SQLITE_INTEGER)
+	    {
+		int t = sqlite3_value_int (argv[8]);
+		tolerance = t;
+	    }
+	  else if (sqlite3_value_type (argv[8]) == SQLITE_FLOAT)
+	      tolerance = sqlite3_value_double (argv[8]);
+	  else
+	      goto invalid_arg;
+	  if (tolerance < 0.0)
+	      goto negative_tolerance;
+      }
+
+/* attempting to get a Topology Accessor */
+    accessor = gaiaGetTopology (sqlite, cache, topo_name);
+    if (accessor == NULL)
+	goto no_topo;
+    gaiatopo_reset_last_error_msg (accessor);
+
+/* checking the input GeoTable */
+    if (!check_input_geo_table
+	(sqlite, db_prefix, table, column, &xtable, &xcolumn, &srid, &family,
+	 &dims))
+	goto no_input;
+    if (!check_matching_srid_dims (accessor, srid, dims))
+	goto invalid_geom;
+
+    start_topo_savepoint (sqlite, cache);
+
+    ret =
+	gaiaTopoGeo_FromGeoTablePartitioned (accessor, db_prefix, xtable,
+					     xcolumn, tolerance, line_max_points,
+					     max_length, tiles, num_threads);
+    if (!ret)
+	rollback_topo_savepoint (sqlite, cache);
+    else
+	release_topo_savepoint (sqlite, cache);
+    free (xtable);
+    free (xcolumn);
+    if (!ret)
+      {
+	  msg = gaiaGetRtTopoErrorMsg (cache);
+	  gaiatopo_set_last_error_msg (accessor, msg);
+	  sqlite3_result_error (context, msg, -1);
+	  return;
+      }
+    sqlite3_result_int (context, 1);
+    return;
+
+  no_topo:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - invalid topology name.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  no_input:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - invalid input GeoTable.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  null_arg:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - null argument.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  invalid_arg:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - invalid argument.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  invalid_geom:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg =
+	"SQL/MM Spatial exception - invalid GeoTable (mismatching SRID or dimensions).";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  negative_tolerance:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - illegal negative tolerance.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  illegal_max_points:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - max_points should be >= 2.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
+  nonpositive_max_length:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    msg = "SQL/MM Spatial exception - max_length should be > 0.0.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+}
+
 static int
 create_dustbin_table (sqlite3 * sqlite, const char *db_prefix,
 		      const char *table, const char *dustbin_table)
@@ -5352,6 +5644,10 @@ fnctaux_TopoGeo_FromGeoTableExt (const void *xcontext, int argc,
 /                           text column, text dustbin-table, text dustbin-view,
 /                           int line_max_points, double max_length , 
 /                           double tolerance )
+/ TopoGeo_FromGeoTableExt ( text topology-name, text db-prefix, text table,
+/                           text column, text dustbin-table, text dustbin-view,
+/                           int line_max_points, double max_length , 
+/                           double tolerance, int in_memory )
 /
 / returns: 1 on success
 / raises an exception on failure
@@ -5372,10 +5668,12 @@ fnctaux_TopoGeo_FromGeoTableExt (const void *xcontext, int argc,
     int line_max_points = -1;
     double max_length = -1.0;
     double tolerance = -1;
+    int in_memory = 0;
     char *sql_in = NULL;
     char *sql_out = NULL;
     char *sql_in2 = NULL;
     GaiaTopologyAccessorPtr accessor = NULL;
+    GaiaTopologyAccessorPtr mem_accessor = NULL;
     sqlite3_context *context = (sqlite3_context *) xcontext;
     sqlite3_value **argv = (sqlite3_value **) xargv;
     sqlite3 *sqlite = sqlite3_context_db_handle (context);
@@ -5465,6 +5763,13 @@ fnctaux_TopoGeo_FromGeoTableExt (const void *xcontext, int argc,
 	  if (tolerance < 0.0)
 	      goto negative_tolerance;
       }
+    if (argc >= 10)
+      {
+	  if (sqlite3_value_type (argv[9]) == SQLITE_INTEGER)
+	      in_memory = sqlite3_value_int (argv[9]);
+	  else
+	      goto invalid_arg;
+      }
 
 /* attempting to get a Topology Accessor */
     accessor = gaiaGetTopology (sqlite, cache, topo_name);
@@ -5496,10 +5801,32 @@ fnctaux_TopoGeo_FromGeoTableExt (const void *xcontext, int argc,
       }
     release_topo_savepoint (sqlite, cache);
 
-    ret =
-	gaiaTopoGeo_FromGeoTableExtended (accessor, sql_in, sql_out, sql_in2,
-					  tolerance, line_max_points,
-					  max_length);
+    if (in_memory)
+      {
+	  /* building the Topology on a memory-resident replica */
+	  mem_accessor = gaiaTopologyMemoryCreate (accessor);
+	  if (mem_accessor == NULL)
+	      goto no_memory;
+	  ret =
+	      gaiaTopoGeo_FromGeoTableExtended (mem_accessor, sql_in, sql_out,
+						sql_in2, tolerance,
+						line_max_points, max_length);
+	  /* writing back the whole Topology in a single pass */
+	  start_topo_savepoint (sqlite, cache);
+	  if (gaiaTopologyMemoryFlush (mem_accessor))
+	      release_topo_savepoint (sqlite, cache);
+	  else
+	    {
+		rollback_topo_savepoint (sqlite, cache);
+		ret = -1;
+	    }
+	  gaiaTopologyMemoryDestroy (mem_accessor);
+      }
+    else
+	ret =
+	    gaiaTopoGeo_FromGeoTableExtended (accessor, sql_in, sql_out,
+					      sql_in2, tolerance,
+					      line_max_points, max_length);
     free (xtable);
     free (xcolumn);
     sqlite3_free (sql_in);
@@ -5524,6 +5851,22 @@ fnctaux_TopoGeo_FromGeoTableExt (const void *xcontext, int argc,
     sqlite3_result_error (context, msg, -1);
     return;
 
+  no_memory:
+    if (xtable != NULL)
+	free (xtable);
+    if (xcolumn != NULL)
+	free (xcolumn);
+    if (sql_in != NULL)
+	sqlite3_free (sql_in);
+    if (sql_out != NULL)
+	sqlite3_free (sql_out);
+    if (sql_in2 != NULL)
+	sqlite3_free (sql_in2);
+    msg = "SQL/MM Spatial exception - unable to create the in-memory Topology.";
+    gaiatopo_set_last_error_msg (accessor, msg);
+    sqlite3_result_error (context, msg, -1);
+    return;
+
   no_input:
     if (xtable != NULL)
 	free (xtable);
@@ -70,6 +70,8 @@ struct gaia_network
     int has_z;
     int allow_coincident;
     char *last_error_message;
+    sqlite3 *origin_handle;
+    const void *origin_cache;
     sqlite3_stmt *stmt_getNetNodeWithinDistance2D;
     sqlite3_stmt *stmt_getLinkWithinDistance2D;
     sqlite3_stmt *stmt_insertNetNodes;
@@ -72,6 +72,8 @@ struct gaia_topology
     double tolerance;
     int has_z;
     char *last_error_message;
+    sqlite3 *origin_handle;
+    const void *origin_cache;
     sqlite3_stmt *stmt_getNodeWithinDistance2D;
     sqlite3_stmt *stmt_insertNodes;
     sqlite3_stmt *stmt_getEdgeWithinDistance2D;
@@ -211,6 +213,47 @@ TOPOLOGY_PRIVATE int auxtopo_insert_into_topology (GaiaTopologyAccessorPtr
 						   gaiaGeomCollPtr *
 						   failing_geometry);
 
+TOPOLOGY_PRIVATE void auxtopo_run_parallel (void (*job) (void *, int),
+					    void *data, int count,
+					    int num_threads,
+					    void (*progress_callback) (int,
+								       void *),
+					    void *callback_ptr);
+
+TOPOLOGY_PRIVATE int auxtopo_open_reader (sqlite3 * handle,
+					  sqlite3 ** reader,
+					  void **reader_cache);
+
+TOPOLOGY_PRIVATE void auxtopo_close_reader (sqlite3 * reader,
+					    void *reader_cache);
+
+TOPOLOGY_PRIVATE int auxtopo_copy_validation_report (sqlite3 * reader,
+						     const char *table,
+						     sqlite3_stmt * stmt);
+
+TOPOLOGY_PRIVATE void auxtopo_bind_value (sqlite3_stmt * stmt, int pos,
+					  sqlite3_stmt * stmt_in, int col);
+
+TOPOLOGY_PRIVATE int auxtopo_open_replica (sqlite3 * handle, int srid,
+					   sqlite3 ** mem_db,
+					   void **mem_cache);
+
+TOPOLOGY_PRIVATE int auxtopo_copy_rows (sqlite3 * from, sqlite3 * to,
+					const char *name, const char *suffix,
+					const char **columns, int n_cols);
+
+TOPOLOGY_PRIVATE int auxtopo_purge_rows (sqlite3 * mem_db, sqlite3 * handle,
+					 const char *name, const char *suffix,
+					 const char *id_column);
+
+TOPOLOGY_PRIVATE sqlite3_int64 auxtopo_get_sequence (sqlite3 * handle,
+						     const char *sql);
+
+TOPOLOGY_PRIVATE int auxtopo_copy_sequence (sqlite3 * handle,
+					    sqlite3 * mem_db,
+					    const char *name,
+					    const char *suffix);
+
 
 /* prototypes for functions creating some SQL prepared statement */
 TOPOLOGY_PRIVATE sqlite3_stmt
@@ -77,9 +77,13 @@ Regione Toscana - Settore Sistema Informativo Territoriale ed Ambientale
 
 #include <libxml/parser.h>
 #include <libxml/nanohttp.h>
+#include <libxml/xmlreader.h>
 
 #define MAX_GTYPES	28
 
+/* invoking the progress callback every N streamed features */
+#define WFS_STREAM_PROGRESS	1024
+
 #ifdef _WIN32
 #define atoll	_atoi64
 #endif /* not WIN32 */
@@ -152,7 +156,7 @@ struct wfs_geometry_def
     int dims;
     int is_nullable;
     struct wfs_geom_type *types;
-    char *geometry_value;
+    xmlNodePtr geometry_node;
     struct wfs_geometry_def *next;
 };
 
@@ -292,7 +296,7 @@ alloc_wfs_geometry (const char *name, int type, int is_nullable)
     geo->types[26].count = 0;
     geo->types[27].type = GAIA_GEOMETRYCOLLECTIONZM;
     geo->types[27].count = 0;
-    geo->geometry_value = NULL;
+    geo->geometry_node = NULL;
     geo->next = NULL;
     return geo;
 }
@@ -307,8 +311,6 @@ free_wfs_geometry (struct wfs_geometry_def *geo)
 	free (geo->geometry_name);
     if (geo->types != NULL)
 	free (geo->types);
-    if (geo->geometry_value != NULL)
-	free (geo->geometry_value);
     free (geo);
 }
 
@@ -379,11 +381,7 @@ reset_wfs_values (struct wfs_layer_schema *ptr)
     geo = ptr->first_geo;
     while (geo != NULL)
       {
-	  if (geo->geometry_value != NULL)
-	    {
-		free (geo->geometry_value);
-		geo->geometry_value = NULL;
-	    }
+	  geo->geometry_node = NULL;
 	  geo = geo->next;
       }
 }
@@ -407,7 +405,7 @@ count_wfs_values (struct wfs_layer_schema *ptr)
     geo = ptr->first_geo;
     while (geo != NULL)
       {
-	  if (geo->geometry_value != NULL)
+	  if (geo->geometry_node != NULL)
 	      count++;
 	  geo = geo->next;
       }
@@ -979,13 +977,12 @@ find_describe_uri (xmlNodePtr node, char **describe_uri)
 }
 
 static int
-get_DescribeFeatureType_uri (xmlDocPtr xml_doc, char **describe_uri)
+get_DescribeFeatureType_uri (xmlNodePtr root, char **describe_uri)
 {
 /*
 / attempting to retrieve the URI identifying the DescribeFeatureType service
 */
     const char *name;
-    xmlNodePtr root = xmlDocGetRootElement (xml_doc);
     struct _xmlAttr *attr;
     if (root == NULL)
 	return 0;
@@ -1481,17 +1478,119 @@ reassemble_gml (xmlNodePtr node, gaiaOutBufferPtr buf)
       }
 }
 
+static int
+feed_gml_tree (xmlNodePtr node, void *tree)
+{
+/* 
+/ recursively feeding the XML-DOM nodes into a GML tree
+/ exactly as reassemble_gml() would print them
+*/
+    struct _xmlAttr *attr;
+    xmlNodePtr child;
+    const xmlChar *namespace;
+    int has_children;
+    int has_text;
+
+    while (node)
+      {
+	  if (node->type == XML_ELEMENT_NODE)
+	    {
+		has_children = 0;
+		has_text = 0;
+		child = node->children;
+		while (child)
+		  {
+		      if (child->type == XML_ELEMENT_NODE)
+			  has_children = 1;
+		      if (child->type == XML_TEXT_NODE)
+			  has_text++;
+		      child = child->next;
+		  }
+		if (has_children)
+		    has_text = 0;
+		if (has_text && node->children->type != XML_TEXT_NODE)
+		    return 0;	/* reassemble_gml() would print a broken tag */
+
+		namespace = NULL;
+		if (node->ns != NULL)
+		    namespace = node->ns->prefix;
+		gaia_gml_tree_open_tag (tree, (const char *) namespace,
+					(const char *) (node->name),
+					(!has_text && !has_children));
+		attr = node->properties;
+		while (attr != NULL)
+		  {
+		      /* attributes */
+		      if (attr->type == XML_ATTRIBUTE_NODE)
+			{
+			    xmlNodePtr text = attr->children;
+			    const xmlChar *value = NULL;
+			    if (text != NULL)
+			      {
+				  if (text->type == XML_TEXT_NODE)
+				      value = text->content;
+			      }
+			    namespace = NULL;
+			    if (attr->ns != NULL)
+				namespace = attr->ns->prefix;
+			    gaia_gml_tree_add_attribute (tree,
+							 (const char *)
+							 namespace,
+							 (const char *)
+							 (attr->name),
+							 (const char *) value);
+			}
+		      attr = attr->next;
+		  }
+		if (has_text)
+		    gaia_gml_tree_add_coords (tree,
+					      (const char
+					       *) (node->children->content));
+		if (has_children)
+		  {
+		      /* recursively expanding all children */
+		      if (!feed_gml_tree (node->children, tree))
+			  return 0;
+		  }
+		if (has_text || has_children)
+		  {
+		      namespace = NULL;
+		      if (node->ns != NULL)
+			  namespace = node->ns->prefix;
+		      gaia_gml_tree_close_tag (tree, (const char *) namespace,
+					       (const char *) (node->name));
+		  }
+	    }
+	  node = node->next;
+      }
+    return 1;
+}
+
+static gaiaGeomCollPtr
+parse_gml_nodes (xmlNodePtr node, sqlite3 * sqlite)
+{
+/* directly decoding a GML geometry from the XML-DOM nodes */
+    gaiaGeomCollPtr geom = NULL;
+    void *tree = gaia_gml_tree_alloc ();
+    if (feed_gml_tree (node, tree))
+	geom = gaia_gml_tree_geometry (NULL, tree, sqlite);
+    gaia_gml_tree_free (tree);
+    return geom;
+}
+
 static void
 set_feature_geom (xmlNodePtr node, struct wfs_geometry_def *geo)
 {
-/* saving a geometry value */
-    gaiaOutBuffer gml;
-    gaiaOutBufferInitialize (&gml);
-
-    /* reassembling the GML expression */
-    reassemble_gml (node, &gml);
-    if (gml.Buffer != NULL)
-	geo->geometry_value = gml.Buffer;
+/* saving a geometry value (just referencing the XML-DOM nodes) */
+    xmlNodePtr cur_node;
+    for (cur_node = node; cur_node; cur_node = cur_node->next)
+      {
+	  if (cur_node->type == XML_ELEMENT_NODE)
+	    {
+		geo->geometry_node = node;
+		return;
+	    }
+      }
 }
 
 static void
@@ -1861,12 +1960,11 @@ do_insert (struct wfs_layer_schema *schema, char **err_msg)
     while (geo != NULL)
       {
 	  /* we have a Geometry column */
-	  if (geo->geometry_value != NULL)
+	  if (geo->geometry_node != NULL)
 	    {
 		/* preparing the Geometry value */
 		gaiaGeomCollPtr geom =
-		    gaiaParseGml ((unsigned char *) (geo->geometry_value),
-				  schema->sqlite);
+		    parse_gml_nodes (geo->geometry_node, schema->sqlite);
 		if (geom == NULL)
 		    sqlite3_bind_null (stmt, ind);
 		else
@@ -1965,11 +2063,13 @@ save_geometry (struct wfs_feature *feature, struct wfs_geometry_def *geo)
 		if (geometry->geometry_value != NULL)
 		    free (geometry->geometry_value);
 		geometry->geometry_value = NULL;
-		if (geo->geometry_value != NULL)
+		if (geo->geometry_node != NULL)
 		  {
-		      int len = strlen (geo->geometry_value);
-		      geometry->geometry_value = malloc (len + 1);
-		      strcpy (geometry->geometry_value, geo->geometry_value);
+		      /* reassembling the GML expression */
+		      gaiaOutBuffer gml;
+		      gaiaOutBufferInitialize (&gml);
+		      reassemble_gml (geo->geometry_node, &gml);
+		      geometry->geometry_value = gml.Buffer;
 		  }
 		return;
 	    }
@@ -2006,6 +2106,24 @@ do_save_feature (struct wfs_layer_schema *schema, struct wfs_feature *feature)
     return 1;
 }
 
+static int
+is_wfs_feature (xmlNodePtr node, struct wfs_layer_schema *schema)
+{
+/* testing if some XML element actually is a Feature of the WFS layer */
+    int ret = 0;
+    char *entity_name;
+    if (node->ns != NULL)
+	entity_name =
+	    sqlite3_mprintf ("%s:%s", node->ns->prefix, node->name);
+    else
+	entity_name = sqlite3_mprintf ("%s", node->name);
+    if (strcmp (schema->layer_name, entity_name) == 0
+	|| strcmp (schema->layer_name, (const char *) (node->name)) == 0)
+	ret = 1;
+    sqlite3_free (entity_name);
+    return ret;
+}
+
 static void
 parse_wfs_features (xmlNodePtr node, struct wfs_layer_schema *schema, int *rows,
 		    char **err_msg)
@@ -2017,16 +2135,7 @@ parse_wfs_features (xmlNodePtr node, struct wfs_layer_schema *schema, int *rows,
       {
 	  if (cur_node->type == XML_ELEMENT_NODE)
 	    {
-		char *entity_name;
-		if (cur_node->ns != NULL)
-		    entity_name =
-			sqlite3_mprintf ("%s:%s", cur_node->ns->prefix,
-					 cur_node->name);
-		else
-		    entity_name = sqlite3_mprintf ("%s", cur_node->name);
-		if (strcmp (schema->layer_name, entity_name) == 0
-		    || strcmp (schema->layer_name,
-			       (const char *) (cur_node->name)) == 0)
+		if (is_wfs_feature (cur_node, schema))
 		  {
 		      if (parse_wfs_single_feature (cur_node->children, schema))
 			{
@@ -2040,7 +2149,6 @@ parse_wfs_features (xmlNodePtr node, struct wfs_layer_schema *schema, int *rows,
 		else
 		    parse_wfs_features (cur_node->children, schema, rows,
 					err_msg);
-		sqlite3_free (entity_name);
 	    }
       }
 }
@@ -3397,6 +3505,228 @@ do_adjust_geoms (sqlite3 * sqlite, const char *table, const char *geometry,
       }
 }
 
+static void
+adjust_geometry_types (sqlite3 * sqlite, const char *table,
+		       struct wfs_layer_schema *schema)
+{
+/* final adjustement for generic Geometry columns */
+    struct wfs_geometry_def *geo = schema->first_geo;
+    while (geo != NULL)
+      {
+	  if (geo->geometry_type == GAIA_GEOMETRYCOLLECTION)
+	    {
+		/* attempting to set a more precise GeometryType */
+		int type;
+		int cast_type;
+		int cast_dims;
+		if (check_real_type (geo, &type, &cast_type, &cast_dims))
+		  {
+		      do_adjust_geoms (sqlite, table, geo->geometry_name, type,
+				       cast_type, cast_dims);
+		  }
+	    }
+	  geo = geo->next;
+      }
+}
+
+static void
+set_wfs_error (char **err_msg, const char *msg)
+{
+/* reporting an error message */
+    int len;
+    if (err_msg == NULL || msg == NULL)
+	return;
+    if (*err_msg != NULL)
+	free (*err_msg);
+    len = strlen (msg);
+    *err_msg = malloc (len + 1);
+    strcpy (*err_msg, msg);
+}
+
+static int
+load_from_wfs_stream (sqlite3 * sqlite, const char *path_or_url,
+		      const char *alt_describe_uri, const char *layer_name,
+		      int swap_axes, const char *table,
+		      const char *pk_column_name, int spatial_index,
+		      int *rows, char **err_msg,
+		      void (*progress_callback) (int, void *),
+		      void *callback_ptr)
+{
+/* 
+/ attempting to load data from some WFS source [streaming]
+/
+/ the WFS payload is read by a pull-parser, and each Feature is
+/ expanded, inserted and then immediately released, so that the
+/ memory footprint doesn't depend on the size of the response
+*/
+    xmlTextReaderPtr reader = NULL;
+    xmlNodePtr node;
+    struct wfs_layer_schema *schema = NULL;
+    int len;
+    int ret;
+    int retry;
+    char *describe_uri = NULL;
+    gaiaOutBuffer errBuf;
+    int ok = 0;
+    int prepared = 0;
+    xmlGenericErrorFunc parsingError = (xmlGenericErrorFunc) wfsParsingError;
+
+    gaiaOutBufferInitialize (&errBuf);
+    xmlSetGenericErrorFunc (&errBuf, parsingError);
+
+    retry = 0;
+    while (1)
+      {
+	  /* retry loop */
+	  reader = xmlReaderForFile (path_or_url, NULL, 0);
+	  if (reader != NULL)
+	    {
+		ret = xmlTextReaderRead (reader);
+		if (ret == 1)
+		    break;
+		xmlFreeTextReader (reader);
+		reader = NULL;
+	    }
+	  retry++;
+	  if (retry > 5)
+	      break;
+	  sqlite3_sleep (10000 * retry);
+      }
+    if (reader == NULL)
+	goto xml_error;
+
+    while (ret == 1)
+      {
+	  if (xmlTextReaderNodeType (reader) != XML_READER_TYPE_ELEMENT)
+	    {
+		ret = xmlTextReaderRead (reader);
+		continue;
+	    }
+	  node = xmlTextReaderCurrentNode (reader);
+	  if (schema == NULL)
+	    {
+		/* the root element: loading the WFS schema */
+		if (alt_describe_uri != NULL)
+		  {
+		      /* using the DescribeFeatureType URI from GetCapabilities */
+		      len = strlen (alt_describe_uri);
+		      describe_uri = malloc (len + 1);
+		      strcpy (describe_uri, alt_describe_uri);
+		  }
+		else
+		  {
+		      /* attempting to extract the DescribeFeatureType from the GetFeature root */
+		      if (!get_DescribeFeatureType_uri (node, &describe_uri))
+			{
+			    set_wfs_error (err_msg,
+					   "Unable to retrieve the DescribeFeatureType URI");
+			    goto end;
+			}
+		  }
+		schema =
+		    load_wfs_schema (describe_uri, layer_name, swap_axes,
+				     err_msg);
+		xmlSetGenericErrorFunc (&errBuf, parsingError);
+		if (schema == NULL)
+		    goto end;
+		ret = xmlTextReaderRead (reader);
+		continue;
+	    }
+	  if (!is_wfs_feature (node, schema))
+	    {
+		ret = xmlTextReaderRead (reader);
+		continue;
+	    }
+
+	  /* fully expanding the current Feature */
+	  node = xmlTextReaderExpand (reader);
+	  if (node == NULL)
+	    {
+		ret = -1;
+		break;
+	    }
+	  if (!prepared)
+	    {
+		/* creating the output table */
+		sniff_wfs_single_feature (node->children, schema);
+		if (!prepare_sql
+		    (sqlite, schema, table, pk_column_name, spatial_index,
+		     err_msg))
+		    goto end;
+		prepared = 1;
+	    }
+	  if (parse_wfs_single_feature (node->children, schema))
+	    {
+		if (schema->error == 0)
+		  {
+		      if (do_insert (schema, err_msg))
+			{
+			    *rows += 1;
+			    if (progress_callback != NULL
+				&& (*rows % WFS_STREAM_PROGRESS) == 0)
+				progress_callback (*rows, callback_ptr);
+			}
+		  }
+	    }
+	  reset_wfs_values (schema);
+
+	  /* skipping to the next sibling; the Feature will be released */
+	  ret = xmlTextReaderNext (reader);
+      }
+    if (ret != 0)
+      {
+	  /* parsing error; not a well-formed XML */
+	  if (prepared)
+	      do_rollback (sqlite, schema);
+	  *rows = 0;
+	  goto xml_error;
+      }
+    if (schema == NULL)
+	goto end;
+
+    if (!prepared)
+      {
+	  /* the WFS payload doesn't contain any Feature at all */
+	  if (!prepare_sql
+	      (sqlite, schema, table, pk_column_name, spatial_index, err_msg))
+	      goto end;
+      }
+    if (progress_callback != NULL)
+      {
+	  /* invoking the progress callback */
+	  int ext_rows = *rows;
+	  progress_callback (ext_rows, callback_ptr);
+      }
+    if (schema->error)
+	do_rollback (sqlite, schema);
+    else
+	do_commit (sqlite, schema);
+    if (schema->error)
+      {
+	  *rows = 0;
+	  goto end;
+      }
+    adjust_geometry_types (sqlite, table, schema);
+    ok = 1;
+    goto end;
+
+  xml_error:
+    if (errBuf.Buffer != NULL)
+	set_wfs_error (err_msg, errBuf.Buffer);
+    else
+	set_wfs_error (err_msg, "loadwfs: unable to read the WFS payload");
+  end:
+    if (reader != NULL)
+	xmlFreeTextReader (reader);
+    if (schema != NULL)
+	free_wfs_layer_schema (schema);
+    if (describe_uri != NULL)
+	free (describe_uri);
+    gaiaOutBufferReset (&errBuf);
+    xmlSetGenericErrorFunc ((void *) stderr, NULL);
+    return ok;
+}
+
 SPATIALITE_DECLARE int
 load_from_wfs_paged (sqlite3 * sqlite, const char *path_or_url,
 		     const char *alt_describe_uri, const char *layer_name,
@@ -3427,7 +3757,6 @@ load_from_wfs_paged_ex (sqlite3 * sqlite, const char *wfs_version,
     xmlDocPtr xml_doc = NULL;
     xmlNodePtr root;
     struct wfs_layer_schema *schema = NULL;
-    struct wfs_geometry_def *geo;
     int len;
     int ret;
     char *describe_uri = NULL;
@@ -3447,6 +3776,15 @@ load_from_wfs_paged_ex (sqlite3 * sqlite, const char *wfs_version,
 	*err_msg = NULL;
     if (path_or_url == NULL)
 	return 0;
+    if (page_size <= 0)
+      {
+	  /* not-paged: streaming the whole WFS payload */
+	  return load_from_wfs_stream (sqlite, path_or_url, alt_describe_uri,
+				       layer_name, swap_axes, table,
+				       pk_column_name, spatial_index, rows,
+				       err_msg, progress_callback,
+				       callback_ptr);
+      }
 
     while (1)
       {
@@ -3510,8 +3848,8 @@ load_from_wfs_paged_ex (sqlite3 * sqlite, const char *wfs_version,
 		else
 		  {
 		      /* attempting to extract the DescribeFeatureType from the GetFeature document */
-		      ret =
-			  get_DescribeFeatureType_uri (xml_doc, &describe_uri);
+		      root = xmlDocGetRootElement (xml_doc);
+		      ret = get_DescribeFeatureType_uri (root, &describe_uri);
 		  }
 		if (ret == 0)
 		  {
@@ -3624,23 +3962,7 @@ load_from_wfs_paged_ex (sqlite3 * sqlite, const char *wfs_version,
 	  startIdx += nRows;
       }
 
-    geo = schema->first_geo;
-    while (geo != NULL)
-      {
-	  if (geo->geometry_type == GAIA_GEOMETRYCOLLECTION)
-	    {
-		/* attempting to set a more precise GeometryType */
-		int type;
-		int cast_type;
-		int cast_dims;
-		if (check_real_type (geo, &type, &cast_type, &cast_dims))
-		  {
-		      do_adjust_geoms (sqlite, table, geo->geometry_name, type,
-				       cast_type, cast_dims);
-		  }
-	    }
-	  geo = geo->next;
-      }
+    adjust_geometry_types (sqlite, table, schema);
     ok = 1;
   end:
     if (schema != NULL)
@@ -0,0 +1,266 @@
+/*
+
+ check_cluster_table.c -- SpatiaLite Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2015
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+struct cluster_check
+{
+/* an SQL query expected to return a single Integer */
+    const char *sql;
+    int expected;
+};
+
+static int
+query_int (sqlite3 * sqlite, const char *sql, int *value, int *is_null)
+{
+/* executing an SQL query returning a single Integer */
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    *value = 0;
+    *is_null = 1;
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+	  return 0;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW)
+      {
+	  if (sqlite3_column_type (stmt, 0) != SQLITE_NULL)
+	    {
+		*value = sqlite3_column_int (stmt, 0);
+		*is_null = 0;
+	    }
+	  ok = 1;
+      }
+    else
+	fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static int
+locality (sqlite3 * sqlite, int *value)
+{
+/* summing the distances between rows adjacent in ROWID order */
+    int is_null;
+    return query_int (sqlite,
+		      "SELECT CastToInteger(Sum(Abs(X(a.geom) - X(b.geom)) + "
+		      "Abs(Y(a.geom) - Y(b.geom)))) FROM pts AS a "
+		      "JOIN pts AS b ON (b.ROWID = a.ROWID + 1)", value,
+		      &is_null);
+}
+
+int
+main (int argc, char *argv[])
+{
+    sqlite3 *db_handle = NULL;
+    int ret;
+    int i;
+    int value;
+    int is_null;
+    int before;
+    int after;
+    char *err_msg = NULL;
+    void *cache = spatialite_alloc_connection ();
+    const char *setup[] = {
+	"SELECT InitSpatialMetadata(1)",
+	"CREATE TABLE pts (id INTEGER PRIMARY KEY, name TEXT NOT NULL)",
+	"SELECT AddGeometryColumn('pts', 'geom', 4326, 'POINT', 'XY')",
+	"SELECT CreateSpatialIndex('pts', 'geom')",
+	"CREATE INDEX pts_name ON pts (name)",
+	"CREATE TABLE pts_log (id INTEGER, action TEXT)",
+	"CREATE TRIGGER pts_upd AFTER UPDATE OF name ON pts BEGIN "
+	    "INSERT INTO pts_log VALUES (NEW.id, 'update'); END",
+	"WITH RECURSIVE s(n) AS (SELECT 0 UNION ALL SELECT n + 1 FROM s "
+	    "WHERE n < 2499) INSERT INTO pts (name, geom) "
+	    "SELECT printf('%d_%d', (n * 7919) % 50, ((n * 7919) / 50) % 50), "
+	    "MakePoint((n * 7919) % 50, ((n * 7919) / 50) % 50, 4326) FROM s",
+	"INSERT INTO pts (name, geom) VALUES ('null', NULL)",
+	"CREATE TABLE zones (code TEXT NOT NULL PRIMARY KEY, n INTEGER)",
+	"SELECT AddGeometryColumn('zones', 'geom', 4326, 'POINT', 'XY')",
+	"SELECT CreateSpatialIndex('zones', 'geom')",
+	"INSERT INTO zones (code, n, geom) SELECT 'z' || id, id, geom "
+	    "FROM pts WHERE id <= 500 ORDER BY id DESC",
+	NULL
+    };
+    struct cluster_check checks[] = {
+	/* invalid arguments */
+	{"SELECT ClusterGeoTable(1, 'geom') IS NULL", 1},
+	{"SELECT ClusterGeoTable('pts', 'geom', 'yes') IS NULL", 1},
+	/* not a registered Geometry */
+	{"SELECT ClusterGeoTable('pts', 'name')", -1},
+	{"SELECT ClusterGeoTable('nothing', 'geom')", -1},
+	/* the Primary Key is the ROWID: resequencing is required */
+	{"SELECT ClusterGeoTable('pts', 'geom')", -1},
+	{"SELECT ClusterGeoTable('pts', 'geom', 1)", 2501},
+	/* all rows, indexes and triggers must survive */
+	{"SELECT Count(*) FROM pts", 2501},
+	{"SELECT Min(id) = 1 AND Max(id) = 2501 FROM pts", 1},
+	{"SELECT Count(*) FROM pts WHERE name = "
+	 "printf('%d_%d', CastToInteger(X(geom)), CastToInteger(Y(geom)))",
+	 2500},
+	{"SELECT id FROM pts WHERE geom IS NULL", 2501},
+	{"SELECT Count(*) FROM sqlite_master WHERE type = 'index' "
+	 "AND name = 'pts_name'", 1},
+	{"SELECT Count(*) FROM sqlite_master WHERE type = 'trigger' "
+	 "AND name = 'pts_upd'", 1},
+	{"SELECT Count(*) FROM sqlite_master WHERE type = 'trigger' "
+	 "AND tbl_name = 'pts' AND name LIKE 'g%'", 5},
+	{"SELECT CheckSpatialIndex('pts', 'geom')", 1},
+	{"SELECT Count(*) FROM idx_pts_geom", 2500},
+	{"SELECT Count(*) FROM sqlite_master WHERE type = 'table' "
+	 "AND name LIKE 'tmp_cluster_%'", 0},
+	{"SELECT Count(*) FROM sqlite_temp_master", 0},
+	/* triggers still working */
+	{"UPDATE pts SET name = name WHERE id = 1", 0},
+	{"SELECT Count(*) FROM pts_log", 1},
+	/* a TEXT Primary Key is preserved as it is */
+	{"SELECT ClusterGeoTable('zones', 'geom')", 500},
+	{"SELECT Count(*) FROM zones AS z JOIN pts AS p "
+	 "ON (z.code = 'z' || z.n) WHERE p.name = printf('%d_%d', "
+	 "CastToInteger(X(z.geom)), CastToInteger(Y(z.geom)))", 500},
+	{"SELECT CheckSpatialIndex('zones', 'geom')", 1},
+	/* refused while Foreign Keys are enforced */
+	{"PRAGMA foreign_keys = 1", 0},
+	{"SELECT ClusterGeoTable('zones', 'geom')", -1},
+	{NULL, 0}
+    };
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    ret =
+	sqlite3_open_v2 (":memory:", &db_handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory db: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  sqlite3_close (db_handle);
+	  db_handle = NULL;
+	  return -1;
+      }
+
+    spatialite_init_ex (db_handle, cache, 0);
+
+    for (i = 0; setup[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (db_handle, setup[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", setup[i], err_msg);
+		sqlite3_free (err_msg);
+		sqlite3_close (db_handle);
+		return -2;
+	    }
+      }
+
+    if (!locality (db_handle, &before))
+      {
+	  sqlite3_close (db_handle);
+	  return -3;
+      }
+
+    for (i = 0; checks[i].sql != NULL; i++)
+      {
+	  if (strncmp (checks[i].sql, "SELECT", 6) != 0)
+	    {
+		/* not a query */
+		ret =
+		    sqlite3_exec (db_handle, checks[i].sql, NULL, NULL,
+				  &err_msg);
+		if (ret != SQLITE_OK)
+		  {
+		      fprintf (stderr, "\"%s\" error: %s\n", checks[i].sql,
+			       err_msg);
+		      sqlite3_free (err_msg);
+		      sqlite3_close (db_handle);
+		      return -4;
+		  }
+		continue;
+	    }
+	  if (!query_int (db_handle, checks[i].sql, &value, &is_null))
+	    {
+		sqlite3_close (db_handle);
+		return -5;
+	    }
+	  if (is_null || value != checks[i].expected)
+	    {
+		fprintf (stderr, "\"%s\": expected %d, got %d%s\n",
+			 checks[i].sql, checks[i].expected, value,
+			 is_null ? " (NULL)" : "");
+		sqlite3_close (db_handle);
+		return -6;
+	    }
+      }
+
+/* rows adjacent in storage order must now be spatially close */
+    if (!locality (db_handle, &after))
+      {
+	  sqlite3_close (db_handle);
+	  return -7;
+      }
+    if (after * 4 > before)
+      {
+	  fprintf (stderr, "poor clustering: %d before, %d after\n", before,
+		   after);
+	  sqlite3_close (db_handle);
+	  return -8;
+      }
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    spatialite_shutdown ();
+
+    return 0;
+}
@@ -621,6 +621,249 @@ check_cutter_main (sqlite3 * handle, int *retcode)
 	  return 0;
       }
 
+/* cutting Linestrings XY - Blade XY - multi-threaded */
+    sql =
+	"SELECT ST_Cutter(NULL, 'lines_xy', NULL, NULL, 'blades_xy', NULL, 'out_lines_xy_xy_mt', 1, 1, 4)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 49;
+	  return 0;
+      }
+    sql =
+	"SELECT (SELECT Count(*) FROM out_lines_xy_xy) = (SELECT Count(*) FROM out_lines_xy_xy_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_lines_xy_xy EXCEPT SELECT * FROM out_lines_xy_xy_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_lines_xy_xy_mt EXCEPT SELECT * FROM out_lines_xy_xy)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 50;
+	  return 0;
+      }
+
+/* cutting Polygons XY - Blade XY - multi-threaded */
+    sql =
+	"SELECT ST_Cutter(NULL, 'polygs_xy', NULL, NULL, 'blades_xy', NULL, 'out_polygs_xy_xy_mt', 1, 1, 4)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 51;
+	  return 0;
+      }
+    sql =
+	"SELECT (SELECT Count(*) FROM out_polygs_xy_xy) = (SELECT Count(*) FROM out_polygs_xy_xy_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_polygs_xy_xy EXCEPT SELECT * FROM out_polygs_xy_xy_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_polygs_xy_xy_mt EXCEPT SELECT * FROM out_polygs_xy_xy)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 52;
+	  return 0;
+      }
+
+    return 1;
+}
+
+static int
+check_cutter_threads (sqlite3 * handle, int *retcode)
+{
+/* testing ST_Cutter - multi-threaded, many jobs */
+    const char *sql;
+    char *err_msg = NULL;
+    int ret;
+    int i;
+    const char *populate[] = {
+	"CREATE TABLE mt_lines (pk_id INTEGER PRIMARY KEY)",
+	"SELECT AddGeometryColumn('mt_lines', 'geometry', 4326, 'LINESTRING', 'XY')",
+	"WITH RECURSIVE s(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM s "
+	    "WHERE i < 4999) INSERT INTO mt_lines SELECT NULL, "
+	    "MakeLine(MakePoint(i % 100, i / 100, 4326), "
+	    "MakePoint((i % 100) + 1.5, (i / 100) + 0.7, 4326)) FROM s",
+	"CREATE TABLE mt_polygs (pk_id INTEGER PRIMARY KEY)",
+	"SELECT AddGeometryColumn('mt_polygs', 'geometry', 4326, 'POLYGON', 'XY')",
+	"WITH RECURSIVE s(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM s "
+	    "WHERE i < 1999) INSERT INTO mt_polygs SELECT NULL, "
+	    "BuildMbr((i % 50) * 2, (i / 50) * 1.5, (i % 50) * 2 + 1.3, "
+	    "(i / 50) * 1.5 + 1.3, 4326) FROM s",
+	"CREATE TABLE mt_blades (pk_id INTEGER PRIMARY KEY)",
+	"SELECT AddGeometryColumn('mt_blades', 'geometry', 4326, 'POLYGON', 'XY')",
+	"WITH RECURSIVE s(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM s "
+	    "WHERE i < 149) INSERT INTO mt_blades SELECT NULL, "
+	    "BuildMbr((i % 15) * 7, (i / 15) * 7, (i % 15) * 7 + 7, "
+	    "(i / 15) * 7 + 7, 4326) FROM s WHERE i <> 77",
+	NULL
+    };
+
+    for (i = 0; populate[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (handle, populate[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", populate[i], err_msg);
+		sqlite3_free (err_msg);
+		*retcode -= 1;
+		return 0;
+	    }
+      }
+
+/* cutting Linestrings - single-threaded and multi-threaded */
+    sql =
+	"SELECT ST_Cutter(NULL, 'mt_lines', NULL, NULL, 'mt_blades', NULL, 'out_mt_lines_st', 1, 1, 1)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 2;
+	  return 0;
+      }
+    sql =
+	"SELECT ST_Cutter(NULL, 'mt_lines', NULL, NULL, 'mt_blades', NULL, 'out_mt_lines_mt', 1, 1, 4)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 3;
+	  return 0;
+      }
+    sql =
+	"SELECT (SELECT Count(*) FROM out_mt_lines_st) > 5000 "
+	"AND (SELECT Count(*) FROM out_mt_lines_st) = (SELECT Count(*) FROM out_mt_lines_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_mt_lines_st EXCEPT SELECT * FROM out_mt_lines_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_mt_lines_mt EXCEPT SELECT * FROM out_mt_lines_st)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 4;
+	  return 0;
+      }
+
+/* cutting Polygons - single-threaded and multi-threaded */
+    sql =
+	"SELECT ST_Cutter(NULL, 'mt_polygs', NULL, NULL, 'mt_blades', NULL, 'out_mt_polygs_st', 1, 1, 1)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 5;
+	  return 0;
+      }
+    sql =
+	"SELECT ST_Cutter(NULL, 'mt_polygs', NULL, NULL, 'mt_blades', NULL, 'out_mt_polygs_mt', 1, 1, 4)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 6;
+	  return 0;
+      }
+    sql =
+	"SELECT (SELECT Count(*) FROM out_mt_polygs_st) > 2000 "
+	"AND (SELECT Count(*) FROM out_mt_polygs_st) = (SELECT Count(*) FROM out_mt_polygs_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_mt_polygs_st EXCEPT SELECT * FROM out_mt_polygs_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_mt_polygs_mt EXCEPT SELECT * FROM out_mt_polygs_st)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 7;
+	  return 0;
+      }
+
+    return 1;
+}
+
+static int
+check_cutter_elba (sqlite3 * handle, int *retcode)
+{
+/* testing ST_Cutter - multi-threaded, real data (Elba census sections) */
+    const char *sql;
+    char *err_msg = NULL;
+    int ret;
+    int i;
+    const char *populate[] = {
+	"ATTACH DATABASE \"./elba-sezcen.sqlite\" AS elba",
+	"CREATE TABLE sez2011_polygs (pk_id INTEGER PRIMARY KEY, sez2011 INTEGER)",
+	"SELECT AddGeometryColumn('sez2011_polygs', 'geometry', 32632, 'MULTIPOLYGON', 'XY')",
+	"INSERT INTO sez2011_polygs SELECT NULL, sez2011, geometry FROM elba.sezcen_2011",
+	"CREATE TABLE sez2011_lines (pk_id INTEGER PRIMARY KEY, sez2011 INTEGER)",
+	"SELECT AddGeometryColumn('sez2011_lines', 'geometry', 32632, 'MULTILINESTRING', 'XY')",
+	"INSERT INTO sez2011_lines SELECT NULL, sez2011, "
+	    "CastToMultiLinestring(ST_Boundary(geometry)) FROM elba.sezcen_2011",
+	"CREATE TABLE sez2001_blades (pk_id INTEGER PRIMARY KEY, sez2001 INTEGER)",
+	"SELECT AddGeometryColumn('sez2001_blades', 'geometry', 32632, 'POLYGON', 'XY')",
+	"INSERT INTO sez2001_blades SELECT NULL, sez2001, geometry FROM elba.sezcen_2001",
+	"SELECT CreateSpatialIndex('sez2001_blades', 'geometry')",
+	"DETACH DATABASE elba",
+	NULL
+    };
+
+    for (i = 0; populate[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (handle, populate[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", populate[i], err_msg);
+		sqlite3_free (err_msg);
+		*retcode -= 1;
+		return 0;
+	    }
+      }
+
+/* cutting the 2011 boundaries by the 2001 sections */
+    sql =
+	"SELECT ST_Cutter(NULL, 'sez2011_lines', NULL, NULL, 'sez2001_blades', NULL, 'out_sez_lines_st', 1, 1, 1)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 2;
+	  return 0;
+      }
+    sql =
+	"SELECT ST_Cutter(NULL, 'sez2011_lines', NULL, NULL, 'sez2001_blades', NULL, 'out_sez_lines_mt', 1, 1, 4)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 3;
+	  return 0;
+      }
+    sql =
+	"SELECT (SELECT Count(*) FROM out_sez_lines_st) > "
+	"(SELECT Count(*) FROM sez2011_lines) "
+	"AND (SELECT Count(*) FROM out_sez_lines_st) = (SELECT Count(*) FROM out_sez_lines_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_sez_lines_st EXCEPT SELECT * FROM out_sez_lines_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_sez_lines_mt EXCEPT SELECT * FROM out_sez_lines_st)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 4;
+	  return 0;
+      }
+
+/* cutting the 2011 sections by the 2001 sections */
+    sql =
+	"SELECT ST_Cutter(NULL, 'sez2011_polygs', NULL, NULL, 'sez2001_blades', NULL, 'out_sez_polygs_st', 1, 1, 1)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 5;
+	  return 0;
+      }
+    sql =
+	"SELECT ST_Cutter(NULL, 'sez2011_polygs', NULL, NULL, 'sez2001_blades', NULL, 'out_sez_polygs_mt', 1, 1, 4)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 6;
+	  return 0;
+      }
+    sql =
+	"SELECT (SELECT Count(*) FROM out_sez_polygs_st) > "
+	"(SELECT Count(*) FROM sez2011_polygs) "
+	"AND (SELECT Count(*) FROM out_sez_polygs_st) = (SELECT Count(*) FROM out_sez_polygs_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_sez_polygs_st EXCEPT SELECT * FROM out_sez_polygs_mt) "
+	"AND NOT EXISTS (SELECT * FROM out_sez_polygs_mt EXCEPT SELECT * FROM out_sez_polygs_st)";
+    ret = test_query (handle, sql);
+    if (!ret)
+      {
+	  *retcode -= 7;
+	  return 0;
+      }
+
     return 1;
 }
 
@@ -2743,6 +2986,15 @@ main (int argc, char *argv[])
     if (!check_cutter_main (handle, &retcode))
 	return retcode;
 
+/* testing ST_Cutter - multi-threaded, many jobs */
+    retcode = -850;
+    if (!check_cutter_threads (handle, &retcode))
+	return retcode;
+/* testing ST_Cutter - multi-threaded, real data */
+    retcode = -900;
+    if (!check_cutter_elba (handle, &retcode))
+	return retcode;
+
     ret = sqlite3_close (handle);
     if (ret != SQLITE_OK)
       {
@@ -1395,6 +1395,190 @@ check_symbol_legacy (int cache_mode)
     return 0;
 }
 
+static int
+count_differences (sqlite3 * handle, const char *table1, const char *table2)
+{
+/* counting the rows differing between two tables */
+    int ret;
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int diffs = -1;
+
+    sql =
+	sqlite3_mprintf
+	("SELECT (SELECT Count(*) FROM (SELECT * FROM \"%w\" EXCEPT "
+	 "SELECT * FROM \"%w\")) + (SELECT Count(*) FROM (SELECT * FROM "
+	 "\"%w\" EXCEPT SELECT * FROM \"%w\")) + abs((SELECT Count(*) "
+	 "FROM \"%w\") - (SELECT Count(*) FROM \"%w\"))", table1, table2,
+	 table2, table1, table1, table2);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "compare %s / %s error: %s\n", table1, table2,
+		   sqlite3_errmsg (handle));
+	  return -1;
+      }
+    if (rows == 1 && results[1] != NULL)
+	diffs = atoi (results[1]);
+    sqlite3_free_table (results);
+    return diffs;
+}
+
+static int
+create_many_dxf (const char *path)
+{
+/* 
+/ creating a DXF file containing enough POINTs and LINEs to be encoded
+/ in many chunks by the worker threads
+*/
+    int i;
+    FILE *out = fopen (path, "wb");
+    if (out == NULL)
+	return 0;
+    fprintf (out, "  0\nSECTION\n  2\nENTITIES\n");
+    for (i = 0; i < 600; i++)
+	fprintf (out, "  0\nPOINT\n  8\npts\n 10\n%1.2f\n 20\n%1.2f\n"
+		 " 30\n%1.2f\n", 1000.0 + (10.5 * (i % 30)),
+		 2000.0 + (7.0 * (i / 30)), 0.5 * (i % 7));
+    for (i = 0; i < 600; i++)
+	fprintf (out, "  0\nLINE\n  8\nlns\n 10\n%1.2f\n 20\n%1.2f\n"
+		 " 30\n0.00\n 11\n%1.2f\n 21\n%1.2f\n 31\n0.00\n",
+		 1000.0 + (10.5 * (i % 30)), 2000.0 + (7.0 * (i / 30)),
+		 1003.5 + (10.5 * (i % 30)), 2001.75 + (7.0 * (i / 30)));
+    fprintf (out, "  0\nENDSEC\n  0\nEOF\n");
+    fclose (out);
+    return 1;
+}
+
+static int
+load_many (sqlite3 * handle, void *cache, const char *prefix, int mode,
+	   int num_threads)
+{
+/* loading "many.dxf" by using the given number of threads */
+    int ret;
+    gaiaDxfParserPtr dxf;
+
+    dxf =
+	gaiaCreateDxfParser (4326, GAIA_DXF_AUTO_2D_3D, prefix, NULL,
+			     GAIA_DXF_RING_NONE);
+    if (dxf == NULL)
+	return 0;
+    ret = gaiaParseDxfFile_r (cache, dxf, "./many.dxf");
+    if (ret)
+	ret = gaiaLoadFromDxfParserEx (handle, dxf, mode, 0, num_threads);
+    gaiaDestroyDxfParser (dxf);
+    return ret;
+}
+
+static int
+check_many_threads ()
+{
+/* multithreaded encoding must produce the same tables as a single thread */
+    int ret;
+    sqlite3 *handle;
+    void *cache = spatialite_alloc_connection ();
+    const char *pairs[] = {
+	"st_pts_point_3d", "mt_pts_point_3d",
+	"st_lns_line_2d", "mt_lns_line_2d",
+	"stx_point_layer_3d", "mtx_point_layer_3d",
+	"stx_line_layer_2d", "mtx_line_layer_2d",
+	NULL
+    };
+    int i;
+
+    ret =
+	sqlite3_open_v2 (":memory:", &handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory database: %s\n",
+		   sqlite3_errmsg (handle));
+	  sqlite3_close (handle);
+	  return -1;
+      }
+    spatialite_init_ex (handle, cache, 0);
+    ret =
+	sqlite3_exec (handle, "SELECT InitSpatialMetadata(1)", NULL, NULL,
+		      NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadata() error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return -2;
+      }
+    if (!create_many_dxf ("./many.dxf"))
+      {
+	  fprintf (stderr, "Unable to create \"many.dxf\"\n");
+	  return -11;
+      }
+
+    if (!load_many (handle, cache, "st_", GAIA_DXF_IMPORT_BY_LAYER, 1))
+      {
+	  fprintf (stderr, "Unable to load \"many.dxf\" byLayer 1 thread\n");
+	  return -3;
+      }
+    if (!load_many (handle, cache, "mt_", GAIA_DXF_IMPORT_BY_LAYER, 4))
+      {
+	  fprintf (stderr, "Unable to load \"many.dxf\" byLayer 4 threads\n");
+	  return -4;
+      }
+    if (!load_many (handle, cache, "stx_", GAIA_DXF_IMPORT_MIXED, 1))
+      {
+	  fprintf (stderr, "Unable to load \"many.dxf\" mixed 1 thread\n");
+	  return -5;
+      }
+    if (!load_many (handle, cache, "mtx_", GAIA_DXF_IMPORT_MIXED, 3))
+      {
+	  fprintf (stderr, "Unable to load \"many.dxf\" mixed 3 threads\n");
+	  return -6;
+      }
+
+    for (i = 0; pairs[i] != NULL; i += 2)
+      {
+	  ret = count_differences (handle, pairs[i], pairs[i + 1]);
+	  if (ret != 0)
+	    {
+		fprintf (stderr, "%s / %s: unexpected differences %d\n",
+			 pairs[i], pairs[i + 1], ret);
+		return -7;
+	    }
+      }
+
+/* out of range thread counts are clamped */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT ImportDXF('./many.dxf', 4326, 0, 'auto', 'distinct', "
+		      "'none', 'neg_', NULL, -5)", NULL, NULL, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "ImportDXF() error: %s\n", sqlite3_errmsg (handle));
+	  return -8;
+      }
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT ImportDXF('./many.dxf', 4326, 0, 'auto', 'distinct', "
+		      "'none', 'big_', NULL, 100000)", NULL, NULL, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "ImportDXF() error: %s\n", sqlite3_errmsg (handle));
+	  return -9;
+      }
+    if (count_differences (handle, "st_pts_point_3d", "neg_pts_point_3d") != 0
+	|| count_differences (handle, "st_lns_line_2d", "big_lns_line_2d") != 0)
+      {
+	  fprintf (stderr, "ImportDXF(): unexpected clamped results\n");
+	  return -10;
+      }
+
+    sqlite3_close (handle);
+    spatialite_cleanup_ex (cache);
+    unlink ("./many.dxf");
+    return 0;
+}
+
 #endif /* GEOS enabled */
 
 int
@@ -1453,6 +1637,9 @@ main (int argc, char *argv[])
 	      return -12;
       }
 
+    if (check_many_threads () != 0)
+	return -13;
+
 #endif /* GEOS enabled */
 
     spatialite_shutdown ();
@@ -0,0 +1,455 @@
+/*
+
+ check_geodesic.c -- SpatiaLite Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2015
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+#include "spatialite/gaiageo.h"
+
+#define TEST_DB	"check_geodesic.sqlite"
+
+#define WGS84_A		6378137.0
+#define WGS84_RF	298.257223563
+
+static int
+do_test_batch (void)
+{
+/* testing the batch APIs against the single pair ones */
+    double a = WGS84_A;
+    double b = WGS84_A * (1.0 - (1.0 / WGS84_RF));
+    double lat1[] = { 0.0, 45.5, -33.9, 51.5, 89.0, 10.0, 0.0, -60.0 };
+    double lon1[] = { 0.0, 9.2, 18.4, -0.1, 0.0, 179.5, 0.0, -70.0 };
+    double lat2[] = { 10.0, 41.9, -34.6, 40.7, 89.0, 10.0, 0.0, 59.0 };
+    double lon2[] = { 10.0, 12.5, -58.4, -74.0, 90.0, -179.5, 0.0, 109.0 };
+    double anti_lat1[] = { 10.0, -60.0 };
+    double anti_lon1[] = { 10.0, -70.0 };
+    double anti_lat2[] = { 20.0, 60.0 };
+    double anti_lon2[] = { 20.0, 110.0 };
+    double dist[8];
+    double ref;
+    int count = 8;
+    int ret;
+    int i;
+
+    gaiaGreatCircleDistances (a, b, count, lat1, lon1, lat2, lon2, dist);
+    for (i = 0; i < count; i++)
+      {
+	  ref =
+	      gaiaGreatCircleDistance (a, b, lat1[i], lon1[i], lat2[i],
+				       lon2[i]);
+	  if (fabs (dist[i] - ref) > 0.000001)
+	    {
+		fprintf (stderr,
+			 "gaiaGreatCircleDistances #%d: got %1.6f expected %1.6f\n",
+			 i, dist[i], ref);
+		return -1;
+	    }
+      }
+
+    if (!gaiaGeodesicDistances
+	(a, b, WGS84_RF, count, lat1, lon1, lat2, lon2, dist))
+      {
+	  fprintf (stderr, "gaiaGeodesicDistances: unexpected failure\n");
+	  return -2;
+      }
+    for (i = 0; i < count; i++)
+      {
+	  ref =
+	      gaiaGeodesicDistance (a, b, WGS84_RF, lat1[i], lon1[i], lat2[i],
+				    lon2[i]);
+	  if (fabs (dist[i] - ref) > 0.000001)
+	    {
+		fprintf (stderr,
+			 "gaiaGeodesicDistances #%d: got %1.6f expected %1.6f\n",
+			 i, dist[i], ref);
+		return -3;
+	    }
+      }
+    if (dist[6] != 0.0)
+      {
+	  fprintf (stderr, "gaiaGeodesicDistances: coincident points %1.6f\n",
+		   dist[6]);
+	  return -4;
+      }
+
+/* nearly antipodal points: the result must be consistent */
+    ret =
+	gaiaGeodesicDistances (a, b, WGS84_RF, 2, anti_lat1, anti_lon1,
+			       anti_lat2, anti_lon2, dist);
+    ref =
+	gaiaGeodesicDistance (a, b, WGS84_RF, anti_lat1[1], anti_lon1[1],
+			      anti_lat2[1], anti_lon2[1]);
+    if ((ret && ref < 0.0) || (!ret && ref >= 0.0) || dist[1] != ref
+	|| dist[0] <= 0.0)
+      {
+	  fprintf (stderr,
+		   "gaiaGeodesicDistances: antipodal %d %1.6f expected %1.6f\n",
+		   ret, dist[1], ref);
+	  return -5;
+      }
+
+/* an empty array is a legitimate request */
+    gaiaGreatCircleDistances (a, b, 0, lat1, lon1, lat2, lon2, dist);
+    if (!gaiaGeodesicDistances
+	(a, b, WGS84_RF, 0, lat1, lon1, lat2, lon2, dist))
+      {
+	  fprintf (stderr, "gaiaGeodesicDistances: empty array failure\n");
+	  return -6;
+      }
+
+/* invalid coordinates must be reported as a failure */
+    lat1[0] = NAN;
+    ret =
+	gaiaGeodesicDistances (a, b, WGS84_RF, 1, lat1, lon1, lat2, lon2,
+			       dist);
+    if (ret || dist[0] >= 0.0
+	|| gaiaGeodesicDistance (a, b, WGS84_RF, lat1[0], lon1[0], lat2[0],
+				 lon2[0]) >= 0.0)
+      {
+	  fprintf (stderr, "gaiaGeodesicDistances: NaN %d %1.6f\n", ret,
+		   dist[0]);
+	  return -7;
+      }
+    return 0;
+}
+
+#define MANY_VERTICES	600
+
+static int
+do_test_many (void)
+{
+/* testing batches spanning many chunks */
+    double a = WGS84_A;
+    double b = WGS84_A * (1.0 - (1.0 / WGS84_RF));
+    double coords[MANY_VERTICES * 2];
+    double lat1[MANY_VERTICES - 1];
+    double lon1[MANY_VERTICES - 1];
+    double lat2[MANY_VERTICES - 1];
+    double lon2[MANY_VERTICES - 1];
+    double dist[MANY_VERTICES - 1];
+    double geod = 0.0;
+    double gc = 0.0;
+    double len;
+    int i;
+
+    for (i = 0; i < MANY_VERTICES; i++)
+      {
+	  coords[i * 2] = -70.0 + (i * 0.13);
+	  coords[(i * 2) + 1] = -40.0 + (sin (i * 0.1) * 30.0);
+      }
+    for (i = 0; i < MANY_VERTICES - 1; i++)
+      {
+	  lon1[i] = coords[i * 2];
+	  lat1[i] = coords[(i * 2) + 1];
+	  lon2[i] = coords[(i + 1) * 2];
+	  lat2[i] = coords[((i + 1) * 2) + 1];
+	  geod +=
+	      gaiaGeodesicDistance (a, b, WGS84_RF, lat1[i], lon1[i], lat2[i],
+				    lon2[i]);
+	  gc += gaiaGreatCircleDistance (a, b, lat1[i], lon1[i], lat2[i],
+					 lon2[i]);
+      }
+
+    if (!gaiaGeodesicDistances
+	(a, b, WGS84_RF, MANY_VERTICES - 1, lat1, lon1, lat2, lon2, dist))
+      {
+	  fprintf (stderr, "gaiaGeodesicDistances: many pairs failure\n");
+	  return -30;
+      }
+    for (i = 0; i < MANY_VERTICES - 1; i++)
+      {
+	  if (dist[i] !=
+	      gaiaGeodesicDistance (a, b, WGS84_RF, lat1[i], lon1[i], lat2[i],
+				    lon2[i]))
+	    {
+		fprintf (stderr, "gaiaGeodesicDistances: many pairs #%d\n",
+			 i);
+		return -31;
+	    }
+      }
+    len =
+	gaiaGeodesicTotalLength (a, b, WGS84_RF, GAIA_XY, coords,
+				 MANY_VERTICES);
+    if (len != geod)
+      {
+	  fprintf (stderr,
+		   "gaiaGeodesicTotalLength: got %1.6f expected %1.6f\n", len,
+		   geod);
+	  return -32;
+      }
+    len = gaiaGreatCircleTotalLength (a, b, GAIA_XY, coords, MANY_VERTICES);
+    if (len != gc)
+      {
+	  fprintf (stderr,
+		   "gaiaGreatCircleTotalLength: got %1.6f expected %1.6f\n",
+		   len, gc);
+	  return -33;
+      }
+    return 0;
+}
+
+static int
+query_lengths (sqlite3 * sqlite, int from_table, double *geodesic,
+	       double *great_circle)
+{
+/* measuring the same Linestring by both methods */
+    const char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    if (from_table)
+	sql = "SELECT GeodesicLength(geom), GreatCircleLength(geom) "
+	    "FROM lines";
+    else
+	sql =
+	    "SELECT GeodesicLength(GeomFromText('LINESTRING(0 0, 10 10, "
+	    "20 0)', 4326)), GreatCircleLength(GeomFromText('LINESTRING("
+	    "0 0, 10 10, 20 0)', 4326))";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+	  return 0;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_FLOAT
+	&& sqlite3_column_type (stmt, 1) == SQLITE_FLOAT)
+      {
+	  *geodesic = sqlite3_column_double (stmt, 0);
+	  *great_circle = sqlite3_column_double (stmt, 1);
+	  ok = 1;
+      }
+    else
+	fprintf (stderr, "\"%s\" unexpected result\n", sql);
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+static int
+do_test_distance (sqlite3 * sqlite)
+{
+/* testing Distance(..., use_ellipsoid) on MultiPoints */
+    const char *sql;
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    sql = "SELECT ST_Distance(GeomFromText('MULTIPOINT(0 0, 10 80, 50 50)', "
+	"4326), GeomFromText('MULTIPOINT(170 80, 100 -50)', 4326), 1), "
+	"ST_Distance(MakePoint(10, 80, 4326), MakePoint(170, 80, 4326), 1), "
+	"ST_Distance(GeomFromText('MULTIPOINT(0 0, 10 80, 50 50)', 4326), "
+	"GeomFromText('MULTIPOINT(170 80, 100 -50)', 4326), 0), "
+	"ST_Distance(MakePoint(10, 80, 4326), MakePoint(170, 80, 4326), 0)";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+	  return -40;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW && sqlite3_column_type (stmt, 0) == SQLITE_FLOAT
+	&& sqlite3_column_type (stmt, 2) == SQLITE_FLOAT)
+      {
+	  /* the nearest pair is the one crossing the North Pole */
+	  if (sqlite3_column_double (stmt, 0) ==
+	      sqlite3_column_double (stmt, 1)
+	      && sqlite3_column_double (stmt, 2) ==
+	      sqlite3_column_double (stmt, 3))
+	      ok = 1;
+	  else
+	      fprintf (stderr, "Distance MultiPoint: %1.6f %1.6f %1.6f %1.6f\n",
+		       sqlite3_column_double (stmt, 0),
+		       sqlite3_column_double (stmt, 1),
+		       sqlite3_column_double (stmt, 2),
+		       sqlite3_column_double (stmt, 3));
+      }
+    else
+	fprintf (stderr, "\"%s\" unexpected result\n", sql);
+    sqlite3_finalize (stmt);
+    return ok ? 0 : -41;
+}
+#endif /* end GEOS conditional */
+
+static int
+exec_sql (sqlite3 * sqlite, const char *sql)
+{
+/* executing an SQL statement */
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+do_test_ellps_cache (sqlite3 * handle, sqlite3 * other, int from_table)
+{
+/* testing the Ellipsoid cache against changes in SPATIAL_REF_SYS */
+    double geod_wgs84;
+    double gc_wgs84;
+    double geod;
+    double gc;
+    int i;
+
+/* populating the cache */
+    for (i = 0; i < 3; i++)
+      {
+	  if (!query_lengths (handle, from_table, &geod_wgs84, &gc_wgs84))
+	      return -10;
+      }
+
+/* changing the Ellipsoid on the same connection */
+    if (!exec_sql
+	(handle,
+	 "UPDATE spatial_ref_sys SET proj4text = "
+	 "'+proj=longlat +ellps=intl +no_defs' WHERE srid = 4326"))
+	return -11;
+    if (!query_lengths (handle, from_table, &geod, &gc))
+	return -12;
+    if (fabs (geod - geod_wgs84) < 1.0 || fabs (gc - gc_wgs84) < 1.0)
+      {
+	  fprintf (stderr,
+		   "stale Ellipsoid (same connection): %1.6f %1.6f\n", geod,
+		   gc);
+	  return -13;
+      }
+
+/* restoring the Ellipsoid from another connection */
+    if (!exec_sql
+	(other,
+	 "UPDATE spatial_ref_sys SET proj4text = "
+	 "'+proj=longlat +datum=WGS84 +no_defs' WHERE srid = 4326"))
+	return -14;
+    if (!query_lengths (handle, from_table, &geod, &gc))
+	return -15;
+    if (geod != geod_wgs84 || gc != gc_wgs84)
+      {
+	  fprintf (stderr,
+		   "stale Ellipsoid (other connection): %1.6f %1.6f\n", geod,
+		   gc);
+	  return -16;
+      }
+    return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+    sqlite3 *db_handle = NULL;
+    sqlite3 *other = NULL;
+    int ret;
+    void *cache = spatialite_alloc_connection ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    ret = do_test_batch ();
+    if (ret == 0)
+	ret = do_test_many ();
+    if (ret != 0)
+      {
+	  spatialite_cleanup_ex (cache);
+	  return ret;
+      }
+
+    unlink (TEST_DB);
+    ret =
+	sqlite3_open_v2 (TEST_DB, &db_handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open \"%s\": %s\n", TEST_DB,
+		   sqlite3_errmsg (db_handle));
+	  sqlite3_close (db_handle);
+	  spatialite_cleanup_ex (cache);
+	  return -20;
+      }
+    spatialite_init_ex (db_handle, cache, 0);
+    if (!exec_sql (db_handle, "SELECT InitSpatialMetadata(1)")
+	|| !exec_sql (db_handle, "CREATE TABLE lines (geom BLOB)")
+	|| !exec_sql (db_handle,
+		      "INSERT INTO lines VALUES (GeomFromText("
+		      "'LINESTRING(0 0, 10 10, 20 0)', 4326))"))
+      {
+	  ret = -21;
+	  goto end;
+      }
+
+    ret = sqlite3_open_v2 (TEST_DB, &other, SQLITE_OPEN_READWRITE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open \"%s\": %s\n", TEST_DB,
+		   sqlite3_errmsg (other));
+	  ret = -22;
+	  goto end;
+      }
+
+    ret = do_test_ellps_cache (db_handle, other, 1);
+    if (ret == 0)
+	ret = do_test_ellps_cache (db_handle, other, 0);
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+    if (ret == 0)
+	ret = do_test_distance (db_handle);
+#endif /* end GEOS conditional */
+
+  end:
+    if (other != NULL)
+	sqlite3_close (other);
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    unlink (TEST_DB);
+    spatialite_shutdown ();
+    return ret;
+}
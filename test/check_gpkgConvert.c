@@ -197,6 +197,83 @@ open_connections (const char *path_origin, const char *path_destination,
     return 0;
 }
 
+static int
+check_round_trip (sqlite3 * handle, const char *path_origin)
+{
+/* checking that all Geometries survived the SpatiaLite/GPKG round trip */
+    int ret;
+    int i;
+    char **results;
+    int rows;
+    int columns;
+    char *sql;
+    char *sql_err = NULL;
+    char **results2;
+    int rows2;
+    int columns2;
+    int mismatching;
+
+    sql = sqlite3_mprintf ("ATTACH DATABASE %Q AS orig", path_origin);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, &sql_err);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "ATTACH DATABASE error: %s\n", sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT f_table_name, f_geometry_column FROM main.geometry_columns",
+			   &results, &rows, &columns, &sql_err);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "SELECT geometry_columns error: %s\n", sql_err);
+	  sqlite3_free (sql_err);
+	  return 0;
+      }
+    if (rows < 1)
+      {
+	  fprintf (stderr, "Round trip: no Geometry Table found\n");
+	  sqlite3_free_table (results);
+	  return 0;
+      }
+    for (i = 1; i <= rows; i++)
+      {
+	  const char *table = results[(i * columns) + 0];
+	  const char *geom = results[(i * columns) + 1];
+	  sql =
+	      sqlite3_mprintf
+	      ("SELECT Count(*) FROM main.\"%w\" AS a JOIN orig.\"%w\" AS b "
+	       "ON (a.ROWID = b.ROWID) WHERE a.\"%w\" IS NOT b.\"%w\"",
+	       table, table, geom, geom);
+	  ret =
+	      sqlite3_get_table (handle, sql, &results2, &rows2, &columns2,
+				 &sql_err);
+	  sqlite3_free (sql);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "Round trip \"%s\" error: %s\n", table,
+			 sql_err);
+		sqlite3_free (sql_err);
+		sqlite3_free_table (results);
+		return 0;
+	    }
+	  mismatching = atoi (results2[1]);
+	  sqlite3_free_table (results2);
+	  if (mismatching != 0)
+	    {
+		fprintf (stderr,
+			 "Round trip \"%s\": %d mismatching Geometries\n",
+			 table, mismatching);
+		sqlite3_free_table (results);
+		return 0;
+	    }
+      }
+    sqlite3_free_table (results);
+    return 1;
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -259,6 +336,11 @@ main (int argc, char *argv[])
 	  do_unlink_all ();
 	  return -1;
       }
+    if (!check_round_trip (handle_out, "./copy-gpkg_test.sqlite"))
+      {
+	  do_unlink_all ();
+	  return -1;
+      }
     sqlite3_close (handle_in);
     sqlite3_close (handle_out);
     spatialite_cleanup_ex (cache_in);
@@ -50,6 +50,170 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include "sqlite3.h"
 #include "spatialite.h"
 
+#ifndef OMIT_EPSG
+/* only if full EPSG support is enabled */
+static int
+check_every_srid (void)
+{
+/* 
+/ each SRID must be inserted one at a time exactly 
+/ as it is by the full initialization
+*/
+    int ret;
+    int i;
+    sqlite3 *handle;
+    char *err_msg = NULL;
+    char **results;
+    int rows;
+    int columns;
+    void *cache = spatialite_alloc_connection ();
+    const char *sql[] = {
+	"SELECT InitSpatialMetadata(1)",
+	"CREATE TABLE ref AS SELECT * FROM spatial_ref_sys WHERE srid > 0",
+	"CREATE TABLE ref_aux AS SELECT * FROM spatial_ref_sys_aux",
+	"DELETE FROM spatial_ref_sys_aux",
+	"DELETE FROM spatial_ref_sys",
+	NULL
+    };
+    const char *checks[] = {
+	"SELECT Count(*) FROM ref WHERE srid = 325833",
+	"SELECT Count(*) FROM ref WHERE InsertEpsgSrid(srid) <> 1",
+	"SELECT Count(*) FROM (SELECT * FROM ref EXCEPT "
+	    "SELECT * FROM spatial_ref_sys)",
+	"SELECT Count(*) FROM (SELECT * FROM spatial_ref_sys EXCEPT "
+	    "SELECT * FROM ref)",
+	"SELECT Count(*) FROM (SELECT * FROM ref_aux EXCEPT "
+	    "SELECT * FROM spatial_ref_sys_aux)",
+	NULL
+    };
+    const char *expected[] = { "1", "0", "0", "0", "0" };
+
+    ret =
+	sqlite3_open_v2 (":memory:", &handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory db: %s\n",
+		   sqlite3_errmsg (handle));
+	  sqlite3_close (handle);
+	  spatialite_cleanup_ex (cache);
+	  return 0;
+      }
+    spatialite_init_ex (handle, cache, 0);
+
+    for (i = 0; sql[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (handle, sql[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", sql[i], err_msg);
+		sqlite3_free (err_msg);
+		goto error;
+	    }
+      }
+    for (i = 0; checks[i] != NULL; i++)
+      {
+	  ret =
+	      sqlite3_get_table (handle, checks[i], &results, &rows, &columns,
+				 &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", checks[i], err_msg);
+		sqlite3_free (err_msg);
+		goto error;
+	    }
+	  if (rows != 1 || columns != 1
+	      || strcmp (results[1], expected[i]) != 0)
+	    {
+		fprintf (stderr, "\"%s\" unexpected result: %s\n", checks[i],
+			 (rows == 1 && columns == 1) ? results[1] : "?");
+		sqlite3_free_table (results);
+		goto error;
+	    }
+	  sqlite3_free_table (results);
+      }
+
+    sqlite3_close (handle);
+    spatialite_cleanup_ex (cache);
+    return 1;
+
+  error:
+    sqlite3_close (handle);
+    spatialite_cleanup_ex (cache);
+    return 0;
+}
+
+static int
+check_lazy_validation (sqlite3 * handle)
+{
+/* SRIDs must be lazily inserted only by valid requests */
+    int ret;
+    int i;
+    char *err_msg = NULL;
+    char **results;
+    int rows;
+    int columns;
+    const char *checks[] = {
+	/* invalid requests */
+	"SELECT AddGeometryColumn('lazy_test', 'bad1', 3004, 'CIRCLE', 'XY')",
+	"0",
+	"SELECT AddGeometryColumn('no_table', 'bad2', 3004, 'POINT', 'XY')",
+	"0",
+	"SELECT RecoverGeometryColumn('lazy_test', 'bad3', 3004, 'CIRCLE', 'XY')",
+	"0",
+	"SELECT RecoverGeometryColumn('no_table', 'bad4', 3004, 'POINT', 'XY')",
+	"0",
+	"SELECT Count(*) FROM spatial_ref_sys WHERE srid = 3004",
+	"0",
+	/* a valid RecoverGeometryColumn */
+	"CREATE TABLE lazy_recover (id INTEGER PRIMARY KEY, geom BLOB)",
+	NULL,
+	"INSERT INTO lazy_recover VALUES (1, MakePoint(1, 2, 3004))",
+	NULL,
+	"SELECT RecoverGeometryColumn('lazy_recover', 'geom', 3004, 'POINT', 'XY')",
+	"1",
+	"SELECT Count(*) FROM spatial_ref_sys WHERE srid = 3004",
+	"1",
+	NULL, NULL
+    };
+
+    for (i = 0; checks[i] != NULL; i += 2)
+      {
+	  if (checks[i + 1] == NULL)
+	    {
+		ret = sqlite3_exec (handle, checks[i], NULL, NULL, &err_msg);
+		if (ret != SQLITE_OK)
+		  {
+		      fprintf (stderr, "\"%s\" error: %s\n", checks[i],
+			       err_msg);
+		      sqlite3_free (err_msg);
+		      return 0;
+		  }
+		continue;
+	    }
+	  ret =
+	      sqlite3_get_table (handle, checks[i], &results, &rows, &columns,
+				 &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", checks[i], err_msg);
+		sqlite3_free (err_msg);
+		return 0;
+	    }
+	  if (rows != 1 || columns != 1
+	      || strcmp (results[1], checks[i + 1]) != 0)
+	    {
+		fprintf (stderr, "\"%s\" unexpected result: %s\n", checks[i],
+			 (rows == 1 && columns == 1) ? results[1] : "?");
+		sqlite3_free_table (results);
+		return 0;
+	    }
+	  sqlite3_free_table (results);
+      }
+    return 1;
+}
+#endif
+
 int
 main (int argc, char *argv[])
 {
@@ -421,5 +585,128 @@ main (int argc, char *argv[])
 
     spatialite_cleanup_ex (cache);
 
+    cache = spatialite_alloc_connection ();
+    ret =
+	sqlite3_open_v2 (":memory:", &handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory db: %s\n",
+		   sqlite3_errmsg (handle));
+	  sqlite3_close (handle);
+	  return -37;
+      }
+
+    spatialite_init_ex (handle, cache, 0);
+
+    ret =
+	sqlite3_get_table (handle, "SELECT InitSpatialMetadata(1, \"LAZY\")",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "Error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -38;
+      }
+    if ((rows != 1) || (columns != 1) || strcmp (results[1], "1") != 0)
+      {
+	  fprintf (stderr,
+		   "Unexpected result InitSpatialMetadata(\"LAZY\") bad result\n");
+	  return -39;
+      }
+    sqlite3_free_table (results);
+
+#ifndef OMIT_EPSG
+/* only if full EPSG support is enabled */
+    ret =
+	sqlite3_exec (handle,
+		      "CREATE TABLE lazy_test (id INTEGER PRIMARY KEY)", NULL,
+		      NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE lazy_test error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -40;
+      }
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT AddGeometryColumn('lazy_test', 'geom', 3003, 'POINT', 'XY')",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "AddGeometryColumn lazy_test error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  return -41;
+      }
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT Count(*) FROM spatial_ref_sys WHERE srid = 3003",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "Error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -42;
+      }
+    if ((rows != 1) || (columns != 1) || strcmp (results[1], "1") != 0)
+      {
+	  fprintf (stderr,
+		   "Unexpected result: lazy SRID 3003 was not inserted\n");
+	  return -43;
+      }
+    sqlite3_free_table (results);
+
+/* an SRID defined far away from its chunk siblings */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT AddGeometryColumn('lazy_test', 'geom2', 325833, 'POINT', 'XY')",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "AddGeometryColumn lazy_test error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  return -45;
+      }
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT Count(*) FROM geometry_columns AS g "
+			   "JOIN spatial_ref_sys AS s ON (g.srid = s.srid) "
+			   "WHERE g.srid = 325833",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "Error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -46;
+      }
+    if ((rows != 1) || (columns != 1) || strcmp (results[1], "1") != 0)
+      {
+	  fprintf (stderr,
+		   "Unexpected result: lazy SRID 325833 was not inserted\n");
+	  return -47;
+      }
+    sqlite3_free_table (results);
+    if (!check_lazy_validation (handle))
+	return -49;
+#endif
+
+    ret = sqlite3_close (handle);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_close() error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return -44;
+      }
+
+    spatialite_cleanup_ex (cache);
+
+#ifndef OMIT_EPSG
+/* only if full EPSG support is enabled */
+    if (!check_every_srid ())
+	return -48;
+#endif
+
     return 0;
 }
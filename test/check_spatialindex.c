@@ -1634,6 +1634,569 @@ do_test_rowid (sqlite3 * handle)
     return 0;
 }
 
+static int
+stats_query (sqlite3 * handle, const char *sql, char *value, int len)
+{
+/* fetching a single value from some SQL query */
+    char **results;
+    int rows;
+    int columns;
+    char *err_msg = NULL;
+    int ret = sqlite3_get_table (handle, sql, &results, &rows, &columns,
+				 &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    if (rows != 1 || columns != 1)
+      {
+	  fprintf (stderr, "\"%s\" unexpected result %i/%i\n", sql, rows,
+		   columns);
+	  sqlite3_free_table (results);
+	  return 0;
+      }
+    if (results[1] == NULL)
+	strcpy (value, "NULL");
+    else
+	snprintf (value, len, "%s", results[1]);
+    sqlite3_free_table (results);
+    return 1;
+}
+
+static int
+backdate_statistics (sqlite3 * handle)
+{
+/*
+/ moving the last run of UpdateLayerStatistics into the past, so that
+/ any following change will surely be seen as more recent regardless
+/ of the timestamps resolution; the watermark keeps matching
+*/
+    char *err_msg = NULL;
+    int ret = sqlite3_exec (handle,
+			    "UPDATE geometry_columns_statistics SET "
+			    "last_verified = '2000-01-01T00:00:00.000Z' "
+			    "WHERE f_table_name = 'stats_pts'; "
+			    "UPDATE geometry_columns_watermark SET "
+			    "last_verified = '2000-01-01T00:00:00.000Z' "
+			    "WHERE f_table_name = 'stats_pts'", NULL, NULL,
+			    &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "backdating statistics error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+do_test_statistics_modes (sqlite3 * handle)
+{
+/* testing UpdateLayerStatistics - INCREMENTAL and SAMPLED modes */
+    int ret;
+    int i;
+    char *err_msg = NULL;
+    char incr[1024];
+    char full[1024];
+    char value[1024];
+    const char *stats =
+	"SELECT row_count || ',' || extent_min_x || ',' || extent_min_y || ',' || "
+	"extent_max_x || ',' || extent_max_y || '|' || "
+	"(SELECT group_concat(column_name || ':' || null_values || ':' || "
+	"integer_values || ':' || double_values || ':' || text_values || ':' || "
+	"blob_values || ':' || IfNull(max_size, '') || ':' || "
+	"IfNull(integer_min, '') || ':' || IfNull(integer_max, '') || ':' || "
+	"IfNull(double_min, '') || ':' || IfNull(double_max, ''), ';') "
+	"FROM (SELECT * FROM geometry_columns_field_infos "
+	"WHERE f_table_name = 'stats_pts' ORDER BY ordinal)) "
+	"FROM geometry_columns_statistics WHERE f_table_name = 'stats_pts'";
+    const char *sql[] = {
+	"CREATE TABLE stats_pts (id INTEGER PRIMARY KEY, name TEXT, "
+	    "val DOUBLE, mix)",
+	"SELECT AddGeometryColumn('stats_pts', 'geom', 4326, 'POINT', 'XY')",
+	"SELECT CreateSpatialIndex('stats_pts', 'geom')",
+	"WITH RECURSIVE s(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM s "
+	    "WHERE i < 1000) INSERT INTO stats_pts (name, val, mix, geom) "
+	    "SELECT 'p' || i, i * 0.5, CASE WHEN i % 3 = 0 THEN 'x' END, "
+	    "MakePoint(i % 360 - 180.0, i % 170 - 85.0, 4326) FROM s",
+	NULL
+    };
+
+    for (i = 0; sql[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (handle, sql[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", sql[i], err_msg);
+		sqlite3_free (err_msg);
+		return -1;
+	    }
+      }
+
+/* the first incremental run is a full scan recording the watermark */
+    if (!stats_query
+	(handle,
+	 "SELECT UpdateLayerStatistics('stats_pts', 'geom', 'INCREMENTAL')",
+	 value, sizeof (value)))
+	return -2;
+    if (strcmp (value, "1") != 0)
+      {
+	  fprintf (stderr, "UpdateLayerStatistics INCREMENTAL (1): %s\n",
+		   value);
+	  return -3;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT max_rowid FROM geometry_columns_watermark "
+	 "WHERE f_table_name = 'stats_pts'", value, sizeof (value)))
+	return -4;
+    if (strcmp (value, "1000") != 0)
+      {
+	  fprintf (stderr, "unexpected watermark: %s\n", value);
+	  return -5;
+      }
+
+/* appending rows: only these will be examined */
+    if (!backdate_statistics (handle))
+	return -33;
+    ret =
+	sqlite3_exec (handle,
+		      "WITH RECURSIVE s(i) AS (SELECT 1 UNION ALL SELECT i + 1 "
+		      "FROM s WHERE i < 50) INSERT INTO stats_pts "
+		      "(name, val, mix, geom) SELECT 'appended_' || i, NULL, 7, "
+		      "MakePoint(200.0 + i, -90.0, 4326) FROM s", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT INTO stats_pts error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -6;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT UpdateLayerStatistics('stats_pts', 'geom', 'INCREMENTAL')",
+	 value, sizeof (value)))
+	return -7;
+    if (!stats_query (handle, stats, incr, sizeof (incr)))
+	return -8;
+    if (!stats_query
+	(handle,
+	 "SELECT max_rowid FROM geometry_columns_watermark "
+	 "WHERE f_table_name = 'stats_pts'", value, sizeof (value)))
+	return -9;
+    if (strcmp (value, "1050") != 0)
+      {
+	  fprintf (stderr, "unexpected watermark: %s\n", value);
+	  return -10;
+      }
+
+/* the incremental results must match a full scan */
+    if (!stats_query
+	(handle, "SELECT InvalidateLayerStatistics('stats_pts', 'geom')",
+	 value, sizeof (value)))
+	return -11;
+    if (!stats_query
+	(handle, "SELECT UpdateLayerStatistics('stats_pts', 'geom', 'FULL')",
+	 value, sizeof (value)))
+	return -12;
+    if (!stats_query (handle, stats, full, sizeof (full)))
+	return -13;
+    if (strcmp (incr, full) != 0)
+      {
+	  fprintf (stderr, "INCREMENTAL mismatch:\n%s\n%s\n", incr, full);
+	  return -14;
+      }
+
+/* updated rows always require a full scan */
+    if (!backdate_statistics (handle))
+	return -34;
+    ret =
+	sqlite3_exec (handle,
+		      "UPDATE stats_pts SET name = 'a much longer name' "
+		      "WHERE id = 1", NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "UPDATE stats_pts error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -15;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT UpdateLayerStatistics('stats_pts', 'geom', 'INCREMENTAL')",
+	 value, sizeof (value)))
+	return -16;
+    if (!stats_query
+	(handle,
+	 "SELECT max_size FROM geometry_columns_field_infos "
+	 "WHERE f_table_name = 'stats_pts' AND column_name = 'name'", value,
+	 sizeof (value)))
+	return -17;
+    if (strcmp (value, "18") != 0)
+      {
+	  fprintf (stderr, "unexpected max_size after UPDATE: %s\n", value);
+	  return -18;
+      }
+
+/* sampled: exact row count, extent from the R*Tree root */
+    if (!stats_query
+	(handle, "SELECT InvalidateLayerStatistics('stats_pts', 'geom')",
+	 value, sizeof (value)))
+	return -19;
+    if (!stats_query
+	(handle,
+	 "SELECT UpdateLayerStatistics(NULL, NULL, 'SAMPLED', 0.1)", value,
+	 sizeof (value)))
+	return -20;
+    if (strcmp (value, "1") != 0)
+      {
+	  fprintf (stderr, "UpdateLayerStatistics SAMPLED: %s\n", value);
+	  return -21;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT row_count || ',' || extent_min_x || ',' || extent_min_y || ',' || "
+	 "extent_max_x || ',' || extent_max_y FROM geometry_columns_statistics "
+	 "WHERE f_table_name = 'stats_pts'", value, sizeof (value)))
+	return -22;
+    if (strcmp (value, "1050,-180.0,-90.0,250.0,84.0") != 0)
+      {
+	  fprintf (stderr, "unexpected SAMPLED statistics: %s\n", value);
+	  return -23;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT null_values + integer_values + double_values + text_values "
+	 "+ blob_values FROM geometry_columns_field_infos "
+	 "WHERE f_table_name = 'stats_pts' AND column_name = 'geom'", value,
+	 sizeof (value)))
+	return -24;
+    if (strcmp (value, "1050") != 0)
+      {
+	  fprintf (stderr, "unexpected SAMPLED field infos: %s\n", value);
+	  return -25;
+      }
+
+/* expected failures */
+    if (!stats_query
+	(handle, "SELECT UpdateLayerStatistics('stats_pts', 'geom', 'BOGUS')",
+	 value, sizeof (value)))
+	return -26;
+    if (strcmp (value, "0") != 0)
+      {
+	  fprintf (stderr, "UpdateLayerStatistics BOGUS: %s\n", value);
+	  return -27;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT UpdateLayerStatistics('stats_pts', 'geom', 'SAMPLED', 1.5)",
+	 value, sizeof (value)))
+	return -28;
+    if (strcmp (value, "0") != 0)
+      {
+	  fprintf (stderr, "UpdateLayerStatistics SAMPLED 1.5: %s\n", value);
+	  return -29;
+      }
+
+/* dropping the table also removes the watermark */
+    if (!stats_query
+	(handle, "SELECT DropGeoTable('stats_pts')", value, sizeof (value)))
+	return -30;
+    if (!stats_query
+	(handle,
+	 "SELECT Count(*) FROM geometry_columns_watermark "
+	 "WHERE f_table_name = 'stats_pts'", value, sizeof (value)))
+	return -31;
+    if (strcmp (value, "0") != 0)
+      {
+	  fprintf (stderr, "unexpected watermark after DropGeoTable: %s\n",
+		   value);
+	  return -32;
+      }
+    return 0;
+}
+
+static int
+do_test_deferred_index (sqlite3 * handle)
+{
+/* testing a deferred (write optimized) SpatialIndex */
+    int ret;
+    int i;
+    char *err_msg = NULL;
+    char value[1024];
+    const char *search =
+	"SELECT group_concat(rowid) FROM (SELECT rowid FROM SpatialIndex "
+	"WHERE f_table_name = 'defer_pts' AND search_frame = "
+	"BuildMbr(0, 0, 12, 12) ORDER BY rowid)";
+    const char *sql[] = {
+	"CREATE TABLE defer_pts (id INTEGER PRIMARY KEY)",
+	"SELECT AddGeometryColumn('defer_pts', 'geom', 4326, 'POINT', 'XY')",
+	"SELECT CreateSpatialIndex('defer_pts', 'geom')",
+	"SELECT EnableDeferredSpatialIndex('defer_pts', 'geom', 100)",
+	"WITH RECURSIVE s(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM s "
+	    "WHERE i < 250) INSERT INTO defer_pts (id, geom) "
+	    "SELECT i, MakePoint(i, i, 4326) FROM s",
+	"UPDATE defer_pts SET geom = MakePoint(1000, 1000, 4326) WHERE id = 5",
+	"DELETE FROM defer_pts WHERE id = 10",
+	NULL
+    };
+
+    for (i = 0; sql[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (handle, sql[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", sql[i], err_msg);
+		sqlite3_free (err_msg);
+		return -1;
+	    }
+      }
+
+/* the log has been merged twice on reaching 100 entries */
+    if (!stats_query
+	(handle, "SELECT Count(*) FROM idx_defer_pts_geom", value,
+	 sizeof (value)))
+	return -2;
+    if (strcmp (value, "200") != 0)
+      {
+	  fprintf (stderr, "unexpected deferred R*Tree count: %s\n", value);
+	  return -3;
+      }
+    if (!stats_query
+	(handle, "SELECT Count(*) FROM idxlog_defer_pts_geom", value,
+	 sizeof (value)))
+	return -4;
+    if (strcmp (value, "52") != 0)
+      {
+	  fprintf (stderr, "unexpected deferred log count: %s\n", value);
+	  return -5;
+      }
+
+/* the SpatialIndex Virtual Table is aware of the pending entries */
+    if (!stats_query (handle, search, value, sizeof (value)))
+	return -6;
+    if (strcmp (value, "1,2,3,4,6,7,8,9,11,12") != 0)
+      {
+	  fprintf (stderr, "unexpected deferred SpatialIndex (1): %s\n",
+		   value);
+	  return -7;
+      }
+
+/* explicitly merging the log */
+    if (!stats_query
+	(handle, "SELECT FlushSpatialIndex('defer_pts', 'geom')", value,
+	 sizeof (value)))
+	return -8;
+    if (strcmp (value, "52") != 0)
+      {
+	  fprintf (stderr, "FlushSpatialIndex: %s\n", value);
+	  return -9;
+      }
+    if (!stats_query
+	(handle, "SELECT CheckSpatialIndex('defer_pts', 'geom')", value,
+	 sizeof (value)))
+	return -10;
+    if (strcmp (value, "1") != 0)
+      {
+	  fprintf (stderr, "CheckSpatialIndex (deferred): %s\n", value);
+	  return -11;
+      }
+
+/* back to immediate mode */
+    ret =
+	sqlite3_exec (handle,
+		      "INSERT INTO defer_pts (id, geom) VALUES (500, MakePoint(3, 3, 4326))",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT (deferred) error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -12;
+      }
+    if (!stats_query
+	(handle, "SELECT DisableDeferredSpatialIndex('defer_pts', 'geom')",
+	 value, sizeof (value)))
+	return -13;
+    if (strcmp (value, "1") != 0)
+      {
+	  fprintf (stderr, "DisableDeferredSpatialIndex: %s\n", value);
+	  return -14;
+      }
+    ret =
+	sqlite3_exec (handle,
+		      "INSERT INTO defer_pts (id, geom) VALUES (501, MakePoint(4, 4, 4326))",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT (immediate) error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -15;
+      }
+    if (!stats_query (handle, search, value, sizeof (value)))
+	return -16;
+    if (strcmp (value, "1,2,3,4,6,7,8,9,11,12,500,501") != 0)
+      {
+	  fprintf (stderr, "unexpected deferred SpatialIndex (2): %s\n",
+		   value);
+	  return -17;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT Count(*) FROM sqlite_master WHERE name = 'idxlog_defer_pts_geom'",
+	 value, sizeof (value)))
+	return -18;
+    if (strcmp (value, "0") != 0)
+      {
+	  fprintf (stderr, "unexpected deferred log after disabling\n");
+	  return -19;
+      }
+
+/* DropGeoTable removes the log as well */
+    if (!stats_query
+	(handle, "SELECT EnableDeferredSpatialIndex('defer_pts', 'geom')",
+	 value, sizeof (value)))
+	return -20;
+    if (!stats_query
+	(handle, "SELECT DropGeoTable('defer_pts')", value, sizeof (value)))
+	return -21;
+    if (!stats_query
+	(handle,
+	 "SELECT Count(*) FROM sqlite_master WHERE name LIKE '%defer_pts%'",
+	 value, sizeof (value)))
+	return -22;
+    if (strcmp (value, "0") != 0)
+      {
+	  fprintf (stderr, "unexpected leftovers after DropGeoTable: %s\n",
+		   value);
+	  return -23;
+      }
+    return 0;
+}
+
+static int
+do_test_planner_cost (sqlite3 * handle)
+{
+/* testing the SpatialIndex cost estimates (literal and correlated frames) */
+    int ret;
+    int i;
+    char *err_msg = NULL;
+    char value[1024];
+    const char *sql[] = {
+	"CREATE TABLE plan_big (id INTEGER PRIMARY KEY, cat INTEGER)",
+	"SELECT AddGeometryColumn('plan_big', 'geom', 4326, 'POINT', 'XY')",
+	"SELECT CreateSpatialIndex('plan_big', 'geom')",
+	"CREATE INDEX plan_big_cat ON plan_big (cat)",
+	"WITH RECURSIVE s(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM s "
+	    "WHERE i < 9999) INSERT INTO plan_big (cat, geom) "
+	    "SELECT i % 2, MakePoint(i % 100, i / 100, 4326) FROM s",
+	"CREATE TABLE plan_probe (id INTEGER PRIMARY KEY)",
+	"SELECT AddGeometryColumn('plan_probe', 'geom', 4326, 'POINT', 'XY')",
+	"INSERT INTO plan_probe (geom) VALUES (MakePoint(50, 50, 4326)), "
+	    "(MakePoint(0, 0, 4326)), (MakePoint(99, 99, 4326))",
+	NULL
+    };
+    struct
+    {
+	const char *sql;
+	const char *expected;
+    } checks[] = {
+	/* literal frames */
+	{"SELECT Count(*) FROM SpatialIndex AS s JOIN plan_big AS b "
+	 "ON (b.ROWID = s.ROWID) WHERE s.f_table_name = 'plan_big' "
+	 "AND s.search_frame = BuildMbr(10, 10, 19, 19)", "100"},
+	{"SELECT Count(*) FROM plan_big WHERE cat = 1 AND ROWID IN "
+	 "(SELECT ROWID FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND f_geometry_column = 'geom' AND "
+	 "search_frame = BuildMbr(-10, -10, 200, 200))", "5000"},
+	{"SELECT Count(*) FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND search_frame = BuildMbr(500, 500, 600, 600)", "0"},
+	/* correlated frames: unknown when the query is prepared */
+	{"SELECT Count(*) FROM plan_probe AS p JOIN plan_big AS b "
+	 "ON (b.ROWID IN (SELECT ROWID FROM SpatialIndex WHERE "
+	 "f_table_name = 'plan_big' AND search_frame = "
+	 "BuildCircleMbr(X(p.geom), Y(p.geom), 1.5)))", "17"},
+	{"SELECT Count(*) FROM plan_probe AS p, SpatialIndex AS s "
+	 "WHERE s.f_table_name = 'plan_big' AND s.search_frame = "
+	 "BuildCircleMbr(X(p.geom), Y(p.geom), 1.5)", "17"},
+	/* ROWID constraints: mixed attribute and spatial filters */
+	{"SELECT Sum(b.id) FROM plan_big AS b, SpatialIndex AS s "
+	 "WHERE s.f_table_name = 'plan_big' AND s.search_frame = "
+	 "BuildMbr(-10, -10, 200, 200) AND b.ROWID = s.ROWID "
+	 "AND b.id IN (5, 7)", "12"},
+	{"SELECT Sum(b.id) FROM plan_big AS b, SpatialIndex AS s "
+	 "WHERE s.f_table_name = 'plan_big' AND s.search_frame = "
+	 "BuildMbr(0, 0, 5, 5) AND b.ROWID = s.ROWID AND b.id IN (5, 7)",
+	 "5"},
+	{"SELECT Count(*) FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND f_geometry_column = 'geom' AND search_frame = "
+	 "BuildMbr(0, 0, 5, 5) AND ROWID = 5", "1"},
+	/* ROWID constraints: not INTEGER values are compared as SQLite does */
+	{"SELECT Count(*) FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND search_frame = BuildMbr(0, 0, 5, 5) AND ROWID = '5'", "1"},
+	{"SELECT Count(*) FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND search_frame = BuildMbr(0, 0, 5, 5) AND ROWID = 5.0", "1"},
+	{"SELECT Count(*) FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND search_frame = BuildMbr(0, 0, 5, 5) AND ROWID = 5.5", "0"},
+	{"SELECT Count(*) FROM SpatialIndex WHERE f_table_name = 'plan_big' "
+	 "AND search_frame = BuildMbr(0, 0, 5, 5) AND ROWID = 'five'", "0"},
+	{"SELECT Sum(b.id) FROM plan_big AS b, SpatialIndex AS s "
+	 "WHERE s.f_table_name = 'plan_big' AND s.search_frame = "
+	 "BuildMbr(0, 0, 5, 5) AND s.ROWID = CAST(b.id AS TEXT) "
+	 "AND b.id IN (5, 7)", "5"},
+	{NULL, NULL}
+    };
+
+    for (i = 0; sql[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (handle, sql[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", sql[i], err_msg);
+		sqlite3_free (err_msg);
+		return -1;
+	    }
+      }
+    for (i = 0; checks[i].sql != NULL; i++)
+      {
+	  if (!stats_query (handle, checks[i].sql, value, sizeof (value)))
+	      return -2;
+	  if (strcmp (value, checks[i].expected) != 0)
+	    {
+		fprintf (stderr, "\"%s\": expected %s, got %s\n",
+			 checks[i].sql, checks[i].expected, value);
+		return -3;
+	    }
+      }
+
+/* the cached statistics are refreshed after massive changes */
+    ret =
+	sqlite3_exec (handle,
+		      "INSERT INTO plan_big (cat, geom) SELECT 2, "
+		      "MakePoint(X(geom) + 0.5, Y(geom) + 0.5, 4326) "
+		      "FROM plan_big WHERE cat = 0", NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "INSERT (planner) error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return -4;
+      }
+    if (!stats_query
+	(handle,
+	 "SELECT Count(*) FROM SpatialIndex AS s JOIN plan_big AS b "
+	 "ON (b.ROWID = s.ROWID) WHERE s.f_table_name = 'plan_big' "
+	 "AND s.search_frame = BuildMbr(10, 10, 19, 19)", value,
+	 sizeof (value)))
+	return -5;
+    if (strcmp (value, "145") != 0)
+      {
+	  fprintf (stderr, "unexpected SpatialIndex count (planner): %s\n",
+		   value);
+	  return -6;
+      }
+    return 0;
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1760,6 +2323,31 @@ main (int argc, char *argv[])
 		   "error while testing current style metadata layout (WITHOUT ROWID / false)\n");
 	  return ret;
       }
+    if (sqlite3_libversion_number () >= 3008003)
+      {
+	  /* testing INCREMENTAL / SAMPLED statistics and deferred SpatialIndex (requires SQLite 3.8.3 or later) */
+	  ret = do_test_statistics_modes (handle);
+	  if (ret != 0)
+	    {
+		fprintf (stderr,
+			 "error while testing current style metadata layout (statistics modes)\n");
+		return ret;
+	    }
+	  ret = do_test_deferred_index (handle);
+	  if (ret != 0)
+	    {
+		fprintf (stderr,
+			 "error while testing current style metadata layout (deferred SpatialIndex)\n");
+		return ret;
+	    }
+	  ret = do_test_planner_cost (handle);
+	  if (ret != 0)
+	    {
+		fprintf (stderr,
+			 "error while testing current style metadata layout (SpatialIndex cost estimates)\n");
+		return ret;
+	    }
+      }
 
     ret = sqlite3_close (handle);
     if (ret != SQLITE_OK)
@@ -1278,6 +1278,223 @@ do_level5_tests (sqlite3 * handle, int *retcode)
     return 1;
 }
 
+static int
+check_int_result (sqlite3 * handle, const char *sql, int expected,
+		  int *retcode, int code)
+{
+/* executing an SQL query returning a single INTEGER */
+    int ret;
+    char *err_msg = NULL;
+    char **results;
+    int rows;
+    int columns;
+
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "%s error: %s\n", sql, err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = code;
+	  return 0;
+      }
+    if (rows != 1 || columns != 1)
+      {
+	  fprintf (stderr, "%s error: rows=%d columns=%d\n", sql, rows,
+		   columns);
+	  sqlite3_free_table (results);
+	  *retcode = code - 1;
+	  return 0;
+      }
+    if (*(results + 1) == NULL || atoi (*(results + 1)) != expected)
+      {
+	  fprintf (stderr, "%s unexpected result: %s (expected %d)\n", sql,
+		   *(results + 1) == NULL ? "NULL" : *(results + 1), expected);
+	  sqlite3_free_table (results);
+	  *retcode = code - 2;
+	  return 0;
+      }
+    sqlite3_free_table (results);
+    return 1;
+}
+
+static int
+do_level6_tests (sqlite3 * handle, int *retcode)
+{
+/* performing Level 6 tests - compiled Stored Procedures */
+    int ret;
+    char *err_msg = NULL;
+
+/* disabling the SQL Logfile */
+    if (!check_int_result
+	(handle, "SELECT SqlProc_SetLogfile(NULL)", 1, retcode, -112))
+	return 0;
+
+    ret = sqlite3_exec (handle, "CREATE TABLE test_3 ("
+			"id INTEGER PRIMARY KEY AUTOINCREMENT,\n"
+			"name TEXT, value DOUBLE)", NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE test_3 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -115;
+	  return 0;
+      }
+
+/* registering a Stored Procedure mixing literal and textual Values */
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Register('compiled', 'compiled test', "
+	 "SqlProc_FromText('INSERT INTO test_3 (name, value) VALUES (@name@, @value@);\n"
+	 "-- a comment line @ignored@\n"
+	 "INSERT INTO @table@ (name, value) SELECT name || ''@suffix@'', value * 2 "
+	 "FROM test_3 WHERE name = @name@ ORDER BY @col@;'))", 1,
+	 retcode, -116))
+	return 0;
+
+/* executing with prepared statements retention enabled */
+    if (!check_int_result
+	(handle, "SELECT StoredProc_SetStmtCache(1)", 1, retcode, -119))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Execute('compiled', '@name@=''it''''s''', "
+	 "'@value@=1.5', '@table@=test_3', '@suffix@=_a', '@col@=1')", 1,
+	 retcode, -122))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Execute('compiled', '@name@=''beta''', "
+	 "'@value@=10', '@table@=test_3', '@suffix@=_b', '@col@=2')", 1,
+	 retcode, -125))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Execute('compiled', '@name@=''gamma''', "
+	 "'@value@=abs(-3)', '@table@=\"test_3\"', '@suffix@=_c', '@col@=1')",
+	 1, retcode, -128))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT Count(*) FROM test_3 WHERE (name = 'it''s' AND value = 1.5) "
+	 "OR (name = 'it''s_a' AND value = 3) OR (name = 'beta' AND value = 10) "
+	 "OR (name = 'beta_b' AND value = 20) OR (name = 'gamma' AND value = 3) "
+	 "OR (name = 'gamma_c' AND value = 6)", 6, retcode, -131))
+	return 0;
+
+/* replacing the SQL Body must discard the compiled statements */
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_UpdateSqlBody('compiled', "
+	 "SqlProc_FromText('DELETE FROM test_3 WHERE value > @value@;'))", 1,
+	 retcode, -134))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('compiled', '@value@=5')", 1,
+	 retcode, -137))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT Count(*) FROM test_3", 3, retcode, -140))
+	return 0;
+
+/* releasing all retained statements */
+    if (!check_int_result
+	(handle, "SELECT StoredProc_SetStmtCache(0)", 1, retcode, -143))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('compiled', '@value@=2')", 1,
+	 retcode, -146))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT Count(*) FROM test_3", 1, retcode, -149))
+	return 0;
+
+/* a Variable Value containing many statements */
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Register('multi', 'multi test', "
+	 "SqlProc_FromText('@body@'))", 1, retcode, -152))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Execute('multi', "
+	 "'@body@=CREATE TABLE multi_a(x); CREATE TABLE multi_b(x);')", 1,
+	 retcode, -155))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_SetStmtCache(1)", 1, retcode, -158))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Execute('multi', "
+	 "'@body@=INSERT INTO multi_a VALUES (1); /* comment */ "
+	 "INSERT INTO multi_b VALUES (2); ')", 1, retcode, -161))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Execute('multi', "
+	 "'@body@=INSERT INTO multi_b VALUES (3); -- trailing comment')", 1,
+	 retcode, -164))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT (SELECT Sum(x) FROM multi_a) * 10 + "
+	 "(SELECT Sum(x) FROM multi_b)", 15, retcode, -167))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_SetStmtCache(0)", 1, retcode, -170))
+	return 0;
+
+/* retained statements reused while the Value types are unchanged */
+    if (!check_int_result
+	(handle, "SELECT StoredProc_SetStmtCache(1)", 1, retcode, -173))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT StoredProc_Register('typed', 'typed test', "
+	 "SqlProc_FromText('CREATE TABLE IF NOT EXISTS test_4 (v);\n"
+	 "INSERT INTO test_4 (v) VALUES (@v@);'))", 1, retcode, -176))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=1')", 1,
+	 retcode, -179))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=2')", 1,
+	 retcode, -182))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=''abc''')", 1,
+	 retcode, -185))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=length(''ab'')')",
+	 1, retcode, -188))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=length(''abcd'')')",
+	 1, retcode, -191))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=8.5')", 1,
+	 retcode, -194))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_Execute('typed', '@v@=16')", 1,
+	 retcode, -197))
+	return 0;
+    if (!check_int_result
+	(handle,
+	 "SELECT Count(*) * 1000 + Sum(CASE WHEN typeof(v) = 'integer' "
+	 "THEN v ELSE 0 END) + 100 * Sum(v = 'abc') + 10 * Sum(v = 8.5) "
+	 "FROM test_4", 7135, retcode, -200))
+	return 0;
+    if (!check_int_result
+	(handle, "SELECT StoredProc_SetStmtCache(0)", 1, retcode, -203))
+	return 0;
+
+    return 1;
+}
+
 #endif
 
 int
@@ -1383,6 +1600,10 @@ main (int argc, char *argv[])
     if (!do_level5_tests (handle, &retcode))
 	goto end;
 
+/*tests: level 6 */
+    if (!do_level6_tests (handle, &retcode))
+	goto end;
+
   end:
 
 #else
@@ -54,6 +54,244 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #ifdef ENABLE_RTTOPO		/* only if RTTOPO is enabled */
 #ifndef OMIT_ICONV		/* only if ICONV is enabled */
 
+static int
+check_same_topology (sqlite3 * handle, const char *topo_name,
+		     const char *ref_name)
+{
+/* checking a Topology against a reference one built in the ordinary way */
+    int ret;
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int ok = 0;
+
+    sql = sqlite3_mprintf ("SELECT ST_ValidateTopoGeo(%Q)", topo_name);
+    ret = sqlite3_exec (handle, sql, NULL, NULL, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+	return 0;
+    sql =
+	sqlite3_mprintf
+	("SELECT (SELECT Count(*) FROM \"%w_face\") = "
+	 "(SELECT Count(*) FROM \"%w_face\") AND "
+	 "(SELECT Count(*) FROM \"%w_node\") = "
+	 "(SELECT Count(*) FROM \"%w_node\") AND "
+	 "(SELECT Count(*) FROM \"%w_edge\") = "
+	 "(SELECT Count(*) FROM \"%w_edge\") AND "
+	 "ST_Equals((SELECT ST_Union(geom) FROM \"%w_edge\"), "
+	 "(SELECT ST_Union(geom) FROM \"%w_edge\")) = 1 AND "
+	 "(SELECT Count(*) FROM TEMP.\"%w_validate_topogeo\") = 0",
+	 topo_name, ref_name, topo_name, ref_name, topo_name, ref_name,
+	 topo_name, ref_name, topo_name);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "check_same_topology error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return 0;
+      }
+    if (rows == 1 && results[1] != NULL && atoi (results[1]) == 1)
+	ok = 1;
+    sqlite3_free_table (results);
+    return ok;
+}
+
+static int
+check_same_report (sqlite3 * handle, const char *report, const char *ref)
+{
+/* checking a concurrent validity report against the sequential one */
+    int ret;
+    char *sql;
+    char **results;
+    int rows;
+    int columns;
+    int ok = 0;
+
+    sql =
+	sqlite3_mprintf
+	("SELECT (SELECT Count(*) FROM \"%w\") > 0 AND "
+	 "(SELECT Count(*) FROM \"%w\") = (SELECT Count(*) FROM \"%w\") AND "
+	 "NOT EXISTS (SELECT * FROM \"%w\" EXCEPT SELECT * FROM \"%w\") AND "
+	 "NOT EXISTS (SELECT * FROM \"%w\" EXCEPT SELECT * FROM \"%w\")",
+	 ref, report, ref, report, ref, ref, report);
+    ret = sqlite3_get_table (handle, sql, &results, &rows, &columns, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "check_same_report error: %s\n",
+		   sqlite3_errmsg (handle));
+	  return 0;
+      }
+    if (rows == 1 && results[1] != NULL && atoi (results[1]) == 1)
+	ok = 1;
+    sqlite3_free_table (results);
+    return ok;
+}
+
+static int
+do_level12_tests (sqlite3 * handle, int *retcode)
+{
+/* performing basic tests: Level 12 - concurrent mode on a DB-file */
+    int ret;
+    char *err_msg = NULL;
+    int i;
+    sqlite3 *db = NULL;
+    sqlite3_backup *backup;
+    void *cache = NULL;
+    int ok = 0;
+    const char *dirty[] = {
+	"INSERT INTO elbaref_node (node_id, containing_face, geom) "
+	    "SELECT NULL, NULL, ST_PointN(geom, 2) FROM elbaref_edge "
+	    "WHERE ST_NumPoints(geom) > 2 ORDER BY edge_id LIMIT 1",
+	"INSERT INTO elbaref_node (node_id, containing_face, geom) "
+	    "SELECT NULL, NULL, geom FROM elbaref_node ORDER BY node_id LIMIT 1",
+	"UPDATE roads_link SET geometry = NULL WHERE link_id = "
+	    "(SELECT Min(link_id) FROM roads_link)",
+	"UPDATE loginet_link SET geometry = GeomFromText('LINESTRING(0 0, 1 1)', -1) "
+	    "WHERE link_id = 1",
+	NULL
+    };
+    const char *validate[] = {
+	"SELECT ST_ValidateTopoGeo('elbaref')",
+	"CREATE TABLE elbaref_report AS SELECT * FROM TEMP.elbaref_validate_topogeo",
+	"SELECT ST_ValidateTopoGeo('elbaref', 4)",
+	"SELECT ST_ValidSpatialNet('roads')",
+	"CREATE TABLE roads_report AS SELECT * FROM TEMP.roads_valid_spatialnet",
+	"SELECT ST_ValidSpatialNet('roads', 4)",
+	"SELECT ST_ValidLogicalNet('loginet')",
+	"CREATE TABLE loginet_report AS SELECT * FROM TEMP.loginet_valid_logicalnet",
+	"SELECT ST_ValidLogicalNet('loginet', 4)",
+	NULL
+    };
+    const char *partition[] = {
+	"ATTACH DATABASE \"./elba-sezcen.sqlite\" AS sezDB",
+	"SELECT CreateTopology('sezref', 32632, 0)",
+	"SELECT TopoGeo_FromGeoTable('sezref', 'sezDB', 'sezcen_2011', 'geometry')",
+	"SELECT CreateTopology('sezpart', 32632, 0)",
+	"SELECT TopoGeo_FromGeoTablePartitioned('sezpart', 'sezDB', 'sezcen_2011', 'geometry', 4, 4)",
+	"SELECT CreateTopology('sezpart3', 32632, 0)",
+	"SELECT TopoGeo_FromGeoTablePartitioned('sezpart3', 'sezDB', 'sezcen_2011', 'geometry', 3, 2)",
+	"DETACH DATABASE sezDB",
+	NULL
+    };
+
+/* copying the in-memory DB into a DB-file, so that readers can be opened */
+    unlink ("./check_topoplus_mt.sqlite");
+    ret =
+	sqlite3_open_v2 ("./check_topoplus_mt.sqlite", &db,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open \"check_topoplus_mt.sqlite\": %s\n",
+		   sqlite3_errmsg (db));
+	  *retcode = -334;
+	  goto end;
+      }
+    backup = sqlite3_backup_init (db, "main", handle, "main");
+    if (backup == NULL)
+      {
+	  fprintf (stderr, "sqlite3_backup_init() error: %s\n",
+		   sqlite3_errmsg (db));
+	  *retcode = -335;
+	  goto end;
+      }
+    sqlite3_backup_step (backup, -1);
+    ret = sqlite3_backup_finish (backup);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "sqlite3_backup_finish() error: %s\n",
+		   sqlite3_errmsg (db));
+	  *retcode = -336;
+	  goto end;
+      }
+    cache = spatialite_alloc_connection ();
+    spatialite_init_ex (db, cache, 0);
+
+/* dirtying the Topology and both Networks */
+    for (i = 0; dirty[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (db, dirty[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", dirty[i], err_msg);
+		sqlite3_free (err_msg);
+		*retcode = -337;
+		goto end;
+	    }
+      }
+
+/* validating sequentially, then concurrently */
+    for (i = 0; validate[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (db, validate[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", validate[i], err_msg);
+		sqlite3_free (err_msg);
+		*retcode = -338;
+		goto end;
+	    }
+      }
+    if (!check_same_report
+	(db, "elbaref_validate_topogeo", "elbaref_report"))
+      {
+	  fprintf (stderr, "ValidateTopoGeo() #4: mismatching report\n");
+	  *retcode = -339;
+	  goto end;
+      }
+    if (!check_same_report (db, "roads_valid_spatialnet", "roads_report"))
+      {
+	  fprintf (stderr, "ValidSpatialNet() #3: mismatching report\n");
+	  *retcode = -340;
+	  goto end;
+      }
+    if (!check_same_report (db, "loginet_valid_logicalnet", "loginet_report"))
+      {
+	  fprintf (stderr, "ValidLogicalNet() #3: mismatching report\n");
+	  *retcode = -341;
+	  goto end;
+      }
+
+/* loading the Elba census sections - ordinary and partitioned mode */
+    for (i = 0; partition[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (db, partition[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", partition[i], err_msg);
+		sqlite3_free (err_msg);
+		*retcode = -342;
+		goto end;
+	    }
+      }
+    if (!check_same_topology (db, "sezpart", "sezref"))
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #4: mismatching Topology\n");
+	  *retcode = -343;
+	  goto end;
+      }
+    if (!check_same_topology (db, "sezpart3", "sezref"))
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #5: mismatching Topology\n");
+	  *retcode = -344;
+	  goto end;
+      }
+    ok = 1;
+
+  end:
+    if (cache != NULL)
+	spatialite_finalize_topologies (cache);
+    sqlite3_close (db);
+    if (cache != NULL)
+	spatialite_cleanup_ex (cache);
+    unlink ("./check_topoplus_mt.sqlite");
+    return ok;
+}
+
 static int
 do_level11_tests (sqlite3 * handle, int *retcode)
 {
@@ -971,6 +1209,9 @@ do_level7_tests (sqlite3 * handle, int *retcode)
 /* performing basic tests: Level 7 */
     int ret;
     char *err_msg = NULL;
+    char **results;
+    int rows;
+    int columns;
 
 /* creating a Topology 2D */
     ret =
@@ -1483,6 +1724,282 @@ do_level7_tests (sqlite3 * handle, int *retcode)
 	  return 0;
       }
 
+/* creating a Topology 2D */
+    ret =
+	sqlite3_exec (handle, "SELECT CreateTopology('elbamem', 32632, 0)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateTopology() #8 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -278;
+	  return 0;
+      }
+
+/* loading a Polygon GeoTable - in-memory mode */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT TopoGeo_FromGeoTable('elbamem', 'main', 'elba_pg', 'geometry', 256, 1000, 0, 1)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoGeo_FromGeoTable() #8 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -279;
+	  return 0;
+      }
+
+/* checking the in-memory Topology against the ordinary one */
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT (SELECT Count(*) FROM elbamem_edge) = "
+			   "(SELECT Count(*) FROM elbasplit_edge) AND "
+			   "(SELECT Count(*) FROM elbamem_node) = "
+			   "(SELECT Count(*) FROM elbasplit_node) AND "
+			   "(SELECT Count(*) FROM elbamem_face) = "
+			   "(SELECT Count(*) FROM elbasplit_face)",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoGeo_FromGeoTable() #8 check error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -280;
+	  return 0;
+      }
+    if (rows != 1 || results[1] == NULL || atoi (results[1]) != 1)
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTable() #8: mismatching in-memory Topology\n");
+	  sqlite3_free_table (results);
+	  *retcode = -281;
+	  return 0;
+      }
+    sqlite3_free_table (results);
+
+/* loading the same GeoTable into a reference Topology */
+    ret =
+	sqlite3_exec (handle, "SELECT CreateTopology('elbaref', 32632, 0)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateTopology() #10 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -328;
+	  return 0;
+      }
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT TopoGeo_FromGeoTable('elbaref', 'main', 'elba_pg', 'geometry', 256, 1000)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoGeo_FromGeoTable() #10 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -329;
+	  return 0;
+      }
+
+/* the in-memory Topology must hold the same Edges, and never recycle IDs */
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT (SELECT Count(*) FROM elbamem_edge AS a "
+			   "WHERE NOT EXISTS (SELECT 1 FROM elbaref_edge AS b "
+			   "WHERE ST_Equals(a.geom, b.geom) = 1)) = 0 AND "
+			   "(SELECT Count(*) FROM elbamem_edge) = "
+			   "(SELECT Count(*) FROM elbaref_edge) AND "
+			   "(SELECT seq FROM sqlite_sequence WHERE name = "
+			   "'elbamem_face') = (SELECT seq FROM sqlite_sequence "
+			   "WHERE name = 'elbaref_face') AND (SELECT seq FROM "
+			   "sqlite_sequence WHERE name = 'elbamem_node') = "
+			   "(SELECT seq FROM sqlite_sequence WHERE name = "
+			   "'elbaref_node')", &results, &rows, &columns,
+			   &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoGeo_FromGeoTable() #8 check error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -326;
+	  return 0;
+      }
+    if (rows != 1 || results[1] == NULL || atoi (results[1]) != 1)
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTable() #8: mismatching in-memory Edges or sequences\n");
+	  sqlite3_free_table (results);
+	  *retcode = -327;
+	  return 0;
+      }
+    sqlite3_free_table (results);
+
+/* creating a Network 2D */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT CreateNetwork('roadsmem', 1, 32632, 0, 0)", NULL,
+		      NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateNetwork() #6 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -322;
+	  return 0;
+      }
+
+/* loading a GeoTable into a TopoNet - in-memory mode */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT TopoNet_FromGeoTable('roadsmem', NULL, 'roads', 'geometry', 1)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoNet_FromGeoTable() #2 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -323;
+	  return 0;
+      }
+
+/* checking the in-memory Network against the ordinary one */
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT (SELECT Count(*) FROM roadsmem_link) = "
+			   "(SELECT Count(*) FROM roads_link) AND "
+			   "(SELECT Count(*) FROM roadsmem_node) = "
+			   "(SELECT Count(*) FROM roads_node) AND "
+			   "(SELECT Count(*) FROM roadsmem_link AS a "
+			   "WHERE NOT EXISTS (SELECT 1 FROM roads_link AS b "
+			   "WHERE ST_Equals(a.geometry, b.geometry) = 1)) = 0 "
+			   "AND (SELECT next_link_id FROM networks WHERE "
+			   "network_name = 'roadsmem') > "
+			   "(SELECT Max(link_id) FROM roadsmem_link) AND "
+			   "(SELECT seq FROM sqlite_sequence WHERE name = "
+			   "'roadsmem_link') = (SELECT seq FROM sqlite_sequence "
+			   "WHERE name = 'roads_link') AND (SELECT seq FROM "
+			   "sqlite_sequence WHERE name = 'roadsmem_node') = "
+			   "(SELECT seq FROM sqlite_sequence WHERE name = "
+			   "'roads_node')",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoNet_FromGeoTable() #2 check error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -324;
+	  return 0;
+      }
+    if (rows != 1 || results[1] == NULL || atoi (results[1]) != 1)
+      {
+	  fprintf (stderr,
+		   "TopoNet_FromGeoTable() #2: mismatching in-memory Links or sequences\n");
+	  sqlite3_free_table (results);
+	  *retcode = -325;
+	  return 0;
+      }
+    sqlite3_free_table (results);
+
+/* creating a Topology 2D */
+    ret =
+	sqlite3_exec (handle, "SELECT CreateTopology('elbapart', 32632, 0)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateTopology() #9 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -282;
+	  return 0;
+      }
+
+/* loading a Polygon GeoTable - partitioned mode */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT TopoGeo_FromGeoTablePartitioned('elbapart', 'main', 'elba_pg', 'geometry', 4, 4, 256, 1000)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoGeo_FromGeoTablePartitioned() #1 error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -283;
+	  return 0;
+      }
+
+/* checking the partitioned Topology against the ordinary one */
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT (SELECT Count(*) FROM elbapart_face) = "
+			   "(SELECT Count(*) FROM elbasplit_face)",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #1 check error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -284;
+	  return 0;
+      }
+    if (rows != 1 || results[1] == NULL || atoi (results[1]) != 1)
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #1: mismatching Faces\n");
+	  sqlite3_free_table (results);
+	  *retcode = -285;
+	  return 0;
+      }
+    sqlite3_free_table (results);
+    if (!check_same_topology (handle, "elbapart", "elbaref"))
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #1: mismatching Topology\n");
+	  *retcode = -330;
+	  return 0;
+      }
+
+/* a different tile grid moves all seams; a single worker thread */
+    ret =
+	sqlite3_exec (handle, "SELECT CreateTopology('elbapart3', 32632, 0)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateTopology() #11 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -331;
+	  return 0;
+      }
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT TopoGeo_FromGeoTablePartitioned('elbapart3', 'main', 'elba_pg', 'geometry', 3, 1, 256, 1000)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "TopoGeo_FromGeoTablePartitioned() #3 error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -332;
+	  return 0;
+      }
+    if (!check_same_topology (handle, "elbapart3", "elbaref"))
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #3: mismatching Topology\n");
+	  *retcode = -333;
+	  return 0;
+      }
+
+/* loading again into a non-empty Topology - expected failure */
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT TopoGeo_FromGeoTablePartitioned('elbapart', 'main', 'elba_pg', 'geometry', 4, 4)",
+		      NULL, NULL, &err_msg);
+    if (ret == SQLITE_OK)
+      {
+	  fprintf (stderr,
+		   "TopoGeo_FromGeoTablePartitioned() #2: unexpected success\n");
+	  *retcode = -286;
+	  return 0;
+      }
+    sqlite3_free (err_msg);
+
     return 1;
 }
 
@@ -1493,6 +2010,9 @@ do_level6_tests (sqlite3 * handle, int *retcode)
 /* performing basic tests: Level 6 */
     int ret;
     char *err_msg = NULL;
+    char **results;
+    int rows;
+    int columns;
 
 /* Validating a Topology - valid */
     ret =
@@ -1670,6 +2190,52 @@ do_level6_tests (sqlite3 * handle, int *retcode)
 	  return 0;
       }
 
+/* Validating a Topology - concurrent checks */
+    ret =
+	sqlite3_exec (handle,
+		      "CREATE TEMP TABLE elba_report AS SELECT * FROM TEMP.elba_validate_topogeo",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "ValidateTopoGeo() #3 report error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -196;
+	  return 0;
+      }
+    ret =
+	sqlite3_exec (handle,
+		      "SELECT ST_ValidateTopoGeo('elba', 4)",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "ValidateTopoGeo() #3 error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -197;
+	  return 0;
+      }
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT (SELECT Count(*) FROM (SELECT * FROM TEMP.elba_report "
+			   "EXCEPT SELECT * FROM TEMP.elba_validate_topogeo)) + "
+			   "(SELECT Count(*) FROM (SELECT * FROM TEMP.elba_validate_topogeo "
+			   "EXCEPT SELECT * FROM TEMP.elba_report))",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "ValidateTopoGeo() #3 check error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  *retcode = -198;
+	  return 0;
+      }
+    if (rows != 1 || results[1] == NULL || atoi (results[1]) != 0)
+      {
+	  fprintf (stderr, "ValidateTopoGeo() #3: mismatching report\n");
+	  sqlite3_free_table (results);
+	  *retcode = -199;
+	  return 0;
+      }
+    sqlite3_free_table (results);
+
     return 1;
 }
 
@@ -4644,6 +5210,10 @@ main (int argc, char *argv[])
     if (!do_level11_tests (handle, &retcode))
 	goto end;
 
+/* basic tests: level 12 */
+    if (!do_level12_tests (handle, &retcode))
+	goto end;
+
   end:
     spatialite_finalize_topologies (cache);
     sqlite3_close (handle);
@@ -1012,6 +1012,107 @@ test_polygon_xyzm (sqlite3 * sqlite)
     return 1;
 }
 
+static int
+test_elementary_content (sqlite3 * sqlite)
+{
+/* testing the content of each Elementary Geometry */
+    int ret;
+    int i;
+    char *err_msg = NULL;
+    sqlite3_stmt *stmt;
+    const char *setup[] = {
+	"CREATE TABLE mix (id INTEGER PRIMARY KEY, name TEXT NOT NULL)",
+	"SELECT AddGeometryColumn('mix', 'geom', 4326, 'GEOMETRY', 'XYZ')",
+	"INSERT INTO mix VALUES (1, 'alpha', GeomFromText("
+	    "'GEOMETRYCOLLECTIONZ(POINTZ(1 2 3), LINESTRINGZ(0 0 0, 1 1 1), "
+	    "POINTZ(4 5 6), POLYGONZ((0 0 0, 10 0 0, 10 10 0, 0 0 0), "
+	    "(1 1 0, 2 1 0, 2 2 0, 1 1 0)))', 4326))",
+	"INSERT INTO mix VALUES (2, 'beta', GeomFromText("
+	    "'MULTILINESTRINGZ((0 0 1, 1 0 1), (2 2 2, 3 3 3, 4 4 4), "
+	    "(5 5 5, 6 6 6))', 4326))",
+	"INSERT INTO mix VALUES (3, 'gamma', NULL)",
+	NULL
+    };
+    const char *checks[] = {
+	/* the VirtualElementary path */
+	"SELECT group_concat(item_no || ':' || AsEWKT(geometry), ';') "
+	    "FROM ElementaryGeometries WHERE f_table_name = 'mix' "
+	    "AND origin_rowid = 1",
+	"0:SRID=4326;POINT(1 2 3);1:SRID=4326;POINT(4 5 6);"
+	    "2:SRID=4326;LINESTRING(0 0 0,1 1 1);3:SRID=4326;"
+	    "POLYGON((0 0 0,10 0 0,10 10 0,0 0 0),(1 1 0,2 1 0,2 2 0,1 1 0))",
+	"SELECT group_concat(item_no || ':' || AsEWKT(geometry), ';') "
+	    "FROM ElementaryGeometries WHERE f_table_name = 'mix' "
+	    "AND origin_rowid = 2",
+	"0:SRID=4326;LINESTRING(0 0 1,1 0 1);"
+	    "1:SRID=4326;LINESTRING(2 2 2,3 3 3,4 4 4);"
+	    "2:SRID=4326;LINESTRING(5 5 5,6 6 6)",
+	"SELECT group_concat(item_no || ':' || (geometry IS NULL), ';') "
+	    "FROM ElementaryGeometries WHERE f_table_name = 'mix' "
+	    "AND origin_rowid = 3",
+	"0:1",
+	/* the ElementaryGeometries() path */
+	"SELECT ElementaryGeometries('mix', 'geom', 'mix_elem', "
+	    "'out_pk', 'out_multi_id')",
+	"8",
+	"SELECT group_concat(out_multi_id || ':' || name, ';') "
+	    "FROM mix_elem WHERE geom IS NULL",
+	"2:gamma",
+	"SELECT group_concat(out_multi_id || ':' || name || ':' || "
+	    "AsEWKT(geom), ';') FROM (SELECT * FROM mix_elem ORDER BY out_pk)",
+	"0:alpha:SRID=4326;POINT(1 2 3);0:alpha:SRID=4326;POINT(4 5 6);"
+	    "0:alpha:SRID=4326;LINESTRING(0 0 0,1 1 1);0:alpha:SRID=4326;"
+	    "POLYGON((0 0 0,10 0 0,10 10 0,0 0 0),(1 1 0,2 1 0,2 2 0,1 1 0));"
+	    "1:beta:SRID=4326;LINESTRING(0 0 1,1 0 1);"
+	    "1:beta:SRID=4326;LINESTRING(2 2 2,3 3 3,4 4 4);"
+	    "1:beta:SRID=4326;LINESTRING(5 5 5,6 6 6)",
+	/* the input Geometries must be left untouched */
+	"SELECT group_concat(AsEWKT(geom), ';') FROM mix",
+	"SRID=4326;GEOMETRYCOLLECTION(POINT(1 2 3),POINT(4 5 6),"
+	    "LINESTRING(0 0 0,1 1 1),POLYGON((0 0 0,10 0 0,10 10 0,0 0 0),"
+	    "(1 1 0,2 1 0,2 2 0,1 1 0)));SRID=4326;MULTILINESTRING("
+	    "(0 0 1,1 0 1),(2 2 2,3 3 3,4 4 4),(5 5 5,6 6 6))",
+	NULL, NULL
+    };
+
+    for (i = 0; setup[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (sqlite, setup[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", setup[i], err_msg);
+		sqlite3_free (err_msg);
+		return 0;
+	    }
+      }
+
+    for (i = 0; checks[i] != NULL; i += 2)
+      {
+	  const char *value = NULL;
+	  ret =
+	      sqlite3_prepare_v2 (sqlite, checks[i], strlen (checks[i]), &stmt,
+				  NULL);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", checks[i],
+			 sqlite3_errmsg (sqlite));
+		return 0;
+	    }
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_ROW)
+	      value = (const char *) sqlite3_column_text (stmt, 0);
+	  if (value == NULL || strcmp (value, checks[i + 1]) != 0)
+	    {
+		fprintf (stderr, "\"%s\"\nunexpected result: %s\n",
+			 checks[i], value == NULL ? "NULL" : value);
+		sqlite3_finalize (stmt);
+		return 0;
+	    }
+	  sqlite3_finalize (stmt);
+      }
+    return 1;
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1125,6 +1226,12 @@ main (int argc, char *argv[])
 	  sqlite3_close (db_handle);
 	  return -14;
       }
+    ret = test_elementary_content (db_handle);
+    if (!ret)
+      {
+	  sqlite3_close (db_handle);
+	  return -15;
+      }
 
     sqlite3_close (db_handle);
     spatialite_cleanup_ex (cache);
@@ -0,0 +1,262 @@
+/*
+
+ check_virtualexif.c -- SpatiaLite Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2015
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#include <spatialite/gaiaexif.h>
+
+static int
+check_photos (sqlite3 * sqlite, const char *sql, int *exif, int *gps)
+{
+/* scanning the VirtualExif table and checking each GPS position */
+    int ret;
+    int rows = 0;
+    sqlite3_stmt *stmt;
+
+    *exif = 0;
+    *gps = 0;
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+	  return -1;
+      }
+    while (1)
+      {
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;
+	  if (ret != SQLITE_ROW)
+	    {
+		fprintf (stderr, "step error: %s\n", sqlite3_errmsg (sqlite));
+		sqlite3_finalize (stmt);
+		return -1;
+	    }
+	  rows++;
+	  if (sqlite3_column_int64 (stmt, 0) != rows)
+	    {
+		fprintf (stderr, "unexpected PKUID %d\n", rows);
+		sqlite3_finalize (stmt);
+		return -1;
+	    }
+	  if (sqlite3_column_int (stmt, 2))
+	      *exif += 1;
+	  if (sqlite3_column_int (stmt, 3))
+	    {
+		/* the GPS position must match GetExifGpsCoords() */
+		const char *path =
+		    (const char *) sqlite3_column_text (stmt, 1);
+		double x = sqlite3_column_double (stmt, 4);
+		double y = sqlite3_column_double (stmt, 5);
+		double gx;
+		double gy;
+		unsigned char *blob;
+		long size;
+		FILE *in = fopen (path, "rb");
+		if (in == NULL)
+		  {
+		      fprintf (stderr, "cannot open \"%s\"\n", path);
+		      sqlite3_finalize (stmt);
+		      return -1;
+		  }
+		fseek (in, 0, SEEK_END);
+		size = ftell (in);
+		rewind (in);
+		blob = malloc (size);
+		fread (blob, 1, size, in);
+		fclose (in);
+		ret = gaiaGetGpsCoords (blob, size, &gx, &gy);
+		free (blob);
+		if (!ret || gx != x || gy != y
+		    || sqlite3_column_type (stmt, 6) != SQLITE_BLOB)
+		  {
+		      fprintf (stderr, "\"%s\": mismatching GPS position\n",
+			       path);
+		      sqlite3_finalize (stmt);
+		      return -1;
+		  }
+		*gps += 1;
+	    }
+	  else if (sqlite3_column_type (stmt, 6) != SQLITE_NULL)
+	    {
+		fprintf (stderr, "unexpected GPS geometry\n");
+		sqlite3_finalize (stmt);
+		return -1;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    return rows;
+}
+
+int
+main (int argc, char *argv[])
+{
+    sqlite3 *db_handle = NULL;
+    int ret;
+    int exif;
+    int gps;
+    char *err_msg = NULL;
+    void *cache = spatialite_alloc_connection ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    ret =
+	sqlite3_open_v2 (":memory:", &db_handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory db: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  sqlite3_close (db_handle);
+	  db_handle = NULL;
+	  return -1;
+      }
+
+    spatialite_init_ex (db_handle, cache, 0);
+
+    ret =
+	sqlite3_exec (db_handle,
+		      "CREATE VIRTUAL TABLE photos USING "
+		      "VirtualExif('sql_stmt_tests')", NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE VIRTUAL TABLE photos error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_close (db_handle);
+	  return -2;
+      }
+    ret =
+	sqlite3_exec (db_handle,
+		      "CREATE VIRTUAL TABLE photos4 USING "
+		      "VirtualExif('sql_stmt_tests', 4)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE VIRTUAL TABLE photos4 error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_close (db_handle);
+	  return -3;
+      }
+
+/* Testing VirtualExif - #1 (single thread) */
+    ret =
+	check_photos (db_handle,
+		      "SELECT PKUID, path, exif, gps, longitude, latitude, "
+		      "geometry FROM photos", &exif, &gps);
+    if (ret != 5 || exif != 4 || gps != 1)
+      {
+	  fprintf (stderr,
+		   "Check VirtualExif #1: unexpected result %d/%d/%d\n", ret,
+		   exif, gps);
+	  sqlite3_close (db_handle);
+	  return -4;
+      }
+
+/* Testing VirtualExif - #2 (four threads) */
+    ret =
+	check_photos (db_handle,
+		      "SELECT PKUID, path, exif, gps, longitude, latitude, "
+		      "geometry FROM photos4", &exif, &gps);
+    if (ret != 5 || exif != 4 || gps != 1)
+      {
+	  fprintf (stderr,
+		   "Check VirtualExif #2: unexpected result %d/%d/%d\n", ret,
+		   exif, gps);
+	  sqlite3_close (db_handle);
+	  return -5;
+      }
+
+/* Testing VirtualExif - #3 (not existing directory) */
+    ret =
+	sqlite3_exec (db_handle,
+		      "CREATE VIRTUAL TABLE nophotos USING "
+		      "VirtualExif('./not-existing-dir')", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE VIRTUAL TABLE nophotos error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_close (db_handle);
+	  return -6;
+      }
+    ret =
+	check_photos (db_handle,
+		      "SELECT PKUID, path, exif, gps, longitude, latitude, "
+		      "geometry FROM nophotos", &exif, &gps);
+    if (ret != 0)
+      {
+	  fprintf (stderr, "Check VirtualExif #3: unexpected result %d\n",
+		   ret);
+	  sqlite3_close (db_handle);
+	  return -7;
+      }
+
+/* Testing VirtualExif - #4 (illegal arg list) */
+    ret =
+	sqlite3_exec (db_handle,
+		      "CREATE VIRTUAL TABLE badphotos USING VirtualExif()",
+		      NULL, NULL, &err_msg);
+    if (ret == SQLITE_OK)
+      {
+	  fprintf (stderr, "Check VirtualExif #4: unexpected success\n");
+	  sqlite3_close (db_handle);
+	  return -8;
+      }
+    sqlite3_free (err_msg);
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    spatialite_shutdown ();
+
+    return 0;
+}
@@ -0,0 +1,490 @@
+/*
+
+ check_virtualspatialjoin.c -- SpatiaLite Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+ 
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+ 
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+ 
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+ 
+Portions created by the Initial Developer are Copyright (C) 2015
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+ 
+*/
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+
+static int
+create_table (sqlite3 * sqlite)
+{
+/* creating and populating a test table */
+    int ret;
+    char *err_msg = NULL;
+    const char *sql;
+    sqlite3_stmt *stmt;
+    double x;
+    double y;
+
+    sql = "CREATE TABLE points (id INTEGER PRIMARY KEY AUTOINCREMENT)";
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE TABLE \"points\" error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+
+    sql = "SELECT AddGeometryColumn('points', 'geom', 32632, 'POINT', 'XY')";
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "AddGeometryColumn \"points.geom\" error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+
+    sql = "SELECT CreateSpatialIndex('points', 'geom')";
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CreateSpatialIndex \"points.geom\" error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+
+    sql = "INSERT INTO points VALUES (NULL, MakePoint(?, ?, 32632))";
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+	return 0;
+
+    ret = sqlite3_exec (sqlite, "BEGIN", NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "BEGIN TRANSACTION error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_finalize (stmt);
+	  return 0;
+      }
+
+    for (y = 4000000.0; y < 4001000.0; y += 10.0)
+      {
+	  for (x = 100000.0; x < 101000.0; x += 10.0)
+	    {
+		sqlite3_reset (stmt);
+		sqlite3_clear_bindings (stmt);
+		sqlite3_bind_double (stmt, 1, x);
+		sqlite3_bind_double (stmt, 2, y);
+		ret = sqlite3_step (stmt);
+		if (ret == SQLITE_DONE || ret == SQLITE_ROW)
+		    ;
+		else
+		  {
+		      fprintf (stderr, "INSERT error: %s\n",
+			       sqlite3_errmsg (sqlite));
+		      sqlite3_finalize (stmt);
+		      return 0;
+		  }
+	    }
+      }
+    sqlite3_finalize (stmt);
+
+    ret = sqlite3_exec (sqlite, "COMMIT", NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "COMMIT TRANSACTION error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  return 0;
+      }
+
+    return 1;
+}
+
+static int
+count_rows (sqlite3 * sqlite, const char *sql, int *count)
+{
+/* counting the rows returned by some query */
+    int ret;
+    sqlite3_stmt *stmt = NULL;
+    int rows = 0;
+
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\": %s\n", sql, sqlite3_errmsg (sqlite));
+	  return 0;
+      }
+    while (1)
+      {
+	  /* scrolling the result set rows */
+	  ret = sqlite3_step (stmt);
+	  if (ret == SQLITE_DONE)
+	      break;		/* end of result set */
+	  if (ret == SQLITE_ROW)
+	      rows++;
+	  else
+	    {
+		sqlite3_finalize (stmt);
+		return 0;
+	    }
+      }
+    sqlite3_finalize (stmt);
+    *count = rows;
+    return 1;
+}
+
+static int
+test_join (sqlite3 * sqlite, const char *join_sql, const char *plain_sql)
+{
+/* comparing the SpatialJoin result set against a plain full scan */
+    int join_rows;
+    int plain_rows;
+
+    if (!count_rows (sqlite, join_sql, &join_rows))
+	return 0;
+    if (!count_rows (sqlite, plain_sql, &plain_rows))
+	return 0;
+    if (join_rows != plain_rows || join_rows == 0)
+      {
+	  fprintf (stderr, "SpatialJoin mismatch: %d rows (expected %d)\n",
+		   join_rows, plain_rows);
+	  return 0;
+      }
+    return 1;
+}
+
+static int
+create_polygons (sqlite3 * sqlite)
+{
+/* creating and populating a test table of Polygons */
+    int ret;
+    char *err_msg = NULL;
+    const char *sql;
+
+    sql = "CREATE TABLE polys (id INTEGER PRIMARY KEY AUTOINCREMENT)";
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	fprintf (stderr, "CREATE TABLE \"polys\" error: %s\n", err_msg);
+	sqlite3_free (err_msg);
+	return 0;
+      }
+
+    sql = "SELECT AddGeometryColumn('polys', 'geom', 32632, 'POLYGON', 'XY')";
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	fprintf (stderr, "AddGeometryColumn \"polys.geom\" error: %s\n",
+		 err_msg);
+	sqlite3_free (err_msg);
+	return 0;
+      }
+
+    sql = "INSERT INTO polys (id, geom) VALUES "
+	"(NULL, BuildMbr(100200, 4000200, 100455, 4000455, 32632)), "
+	"(NULL, BuildMbr(100100, 4000100, 100300, 4000300, 32632)), "
+	"(NULL, ST_Buffer(MakePoint(100500, 4000500, 32632), 75)), "
+	"(NULL, GeomFromText('POLYGON((100600 4000600, 100900 4000600, "
+	"100900 4000900, 100600 4000900, 100600 4000600), "
+	"(100700 4000700, 100800 4000700, 100800 4000800, "
+	"100700 4000800, 100700 4000700))', 32632))";
+    ret = sqlite3_exec (sqlite, sql, NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	fprintf (stderr, "INSERT INTO \"polys\" error: %s\n", err_msg);
+	sqlite3_free (err_msg);
+	return 0;
+      }
+    return 1;
+}
+
+static int
+test_pip_join (sqlite3 * sqlite, const char *out_table, int num_threads)
+{
+/* comparing the PointInPolygonJoin result against a plain full scan */
+    int ret;
+    int rows;
+    int expected;
+    char *sql;
+    sqlite3_stmt *stmt = NULL;
+    const char *plain =
+	"SELECT p.id, g.id FROM points AS p, polys AS g "
+	"WHERE ST_Contains(g.geom, p.geom) = 1";
+
+    sql =
+	sqlite3_mprintf
+	("SELECT PointInPolygonJoin('points', 'geom', 'polys', 'geom', %Q, %d)",
+	 out_table, num_threads);
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    sqlite3_free (sql);
+    if (ret != SQLITE_OK)
+      {
+	fprintf (stderr, "PointInPolygonJoin: %s\n", sqlite3_errmsg (sqlite));
+	return 0;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret != SQLITE_ROW || sqlite3_column_type (stmt, 0) != SQLITE_INTEGER)
+      {
+	fprintf (stderr, "PointInPolygonJoin: unexpected result\n");
+	sqlite3_finalize (stmt);
+	return 0;
+      }
+    rows = sqlite3_column_int (stmt, 0);
+    sqlite3_finalize (stmt);
+
+    if (!count_rows (sqlite, plain, &expected))
+	return 0;
+    if (rows != expected || rows == 0)
+      {
+	fprintf (stderr,
+		 "PointInPolygonJoin mismatch: %d pairs (expected %d)\n",
+		 rows, expected);
+	return 0;
+      }
+    sql =
+	sqlite3_mprintf
+	("SELECT point_rowid, polygon_rowid FROM \"%s\" EXCEPT %s",
+	 out_table, plain);
+    ret = count_rows (sqlite, sql, &rows);
+    sqlite3_free (sql);
+    if (!ret || rows != 0)
+      {
+	fprintf (stderr, "PointInPolygonJoin: unexpected pairs\n");
+	return 0;
+      }
+    return 1;
+}
+
+#endif
+
+int
+main (int argc, char *argv[])
+{
+    sqlite3 *db_handle = NULL;
+    int ret;
+    int rows;
+    char *err_msg = NULL;
+    void *cache = spatialite_alloc_connection ();
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    ret =
+	sqlite3_open_v2 (":memory:", &db_handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory db: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  sqlite3_close (db_handle);
+	  db_handle = NULL;
+	  return -1;
+      }
+
+    spatialite_init_ex (db_handle, cache, 0);
+
+#ifndef OMIT_GEOS		/* only if GEOS is enabled */
+
+    ret =
+	sqlite3_exec (db_handle, "SELECT InitSpatialMetadata(1)", NULL, NULL,
+		      &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "InitSpatialMetadata() error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_close (db_handle);
+	  return -2;
+      }
+
+/* Creating and populating the test table */
+    ret = create_table (db_handle);
+    if (!ret)
+      {
+	  sqlite3_close (db_handle);
+	  return -3;
+      }
+
+/* creating the SpatialJoin Virtual Table */
+    ret =
+	sqlite3_exec (db_handle,
+		      "CREATE VIRTUAL TABLE SpatialJoin USING VirtualSpatialJoin()",
+		      NULL, NULL, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "CREATE VIRTUAL TABLE SpatialJoin error: %s\n",
+		   err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_close (db_handle);
+	  return -12;
+      }
+
+/* Testing SpatialJoin - #1 (default predicate) */
+    ret =
+	test_join (db_handle,
+		   "SELECT fid FROM SpatialJoin WHERE f_table_name = 'points' "
+		   "AND ref_geometry = ST_Buffer(MakePoint(100500, 4000500, 32632), 75)",
+		   "SELECT id FROM points WHERE ST_Intersects(geom, "
+		   "ST_Buffer(MakePoint(100500, 4000500, 32632), 75)) = 1");
+    if (!ret)
+      {
+	  fprintf (stderr, "Check SpatialJoin #1: unexpected failure\n");
+	  sqlite3_close (db_handle);
+	  return -4;
+      }
+
+/* Testing SpatialJoin - #2 (explicit column and predicate) */
+    ret =
+	test_join (db_handle,
+		   "SELECT fid FROM SpatialJoin WHERE f_table_name = 'DB=main.points' "
+		   "AND f_geometry_column = 'geom' AND predicate = 'Contains' "
+		   "AND ref_geometry = BuildMbr(100200, 4000200, 100455, 4000455, 32632)",
+		   "SELECT id FROM points WHERE ST_Contains("
+		   "BuildMbr(100200, 4000200, 100455, 4000455, 32632), geom) = 1");
+    if (!ret)
+      {
+	  fprintf (stderr, "Check SpatialJoin #2: unexpected failure\n");
+	  sqlite3_close (db_handle);
+	  return -5;
+      }
+
+/* Testing SpatialJoin - #3 (unsupported predicate) */
+    ret =
+	count_rows (db_handle,
+		    "SELECT fid FROM SpatialJoin WHERE f_table_name = 'points' "
+		    "AND predicate = 'Equals' "
+		    "AND ref_geometry = MakePoint(100500, 4000500, 32632)",
+		    &rows);
+    if (ret)
+      {
+	  fprintf (stderr, "Check SpatialJoin #3: unexpected success\n");
+	  sqlite3_close (db_handle);
+	  return -6;
+      }
+
+/* Testing SpatialJoin - #4 (no Spatial Index) */
+    ret =
+	count_rows (db_handle,
+		    "SELECT fid FROM SpatialJoin WHERE f_table_name = 'pointsx' "
+		    "AND ref_geometry = MakePoint(100500, 4000500, 32632)",
+		    &rows);
+    if (ret)
+      {
+	  fprintf (stderr, "Check SpatialJoin #4: unexpected success\n");
+	  sqlite3_close (db_handle);
+	  return -7;
+      }
+
+/* Testing SpatialJoin - #5 (NULL reference Geometry) */
+    ret =
+	count_rows (db_handle,
+		    "SELECT fid FROM SpatialJoin WHERE f_table_name = 'points' "
+		    "AND ref_geometry = (SELECT geom FROM points WHERE id < 0)",
+		    &rows);
+    if (!ret || rows != 0)
+      {
+	  fprintf (stderr, "Check SpatialJoin #5: unexpected result\n");
+	  sqlite3_close (db_handle);
+	  return -13;
+      }
+
+/* Testing SpatialJoin - #6 (echoing back the bound args) */
+    ret =
+	count_rows (db_handle,
+		    "SELECT fid FROM SpatialJoin WHERE f_table_name = 'points' "
+		    "AND ref_geometry = MakePoint(100500, 4000500, 32632) "
+		    "AND f_table_name || '|' || f_geometry_column || '|' || "
+		    "predicate = 'points|geom|Intersects' AND "
+		    "ST_Equals(ref_geometry, MakePoint(100500, 4000500, 32632)) = 1",
+		    &rows);
+    if (!ret || rows != 1)
+      {
+	  fprintf (stderr, "Check SpatialJoin #6: unexpected result\n");
+	  sqlite3_close (db_handle);
+	  return -14;
+      }
+
+/* Creating and populating the Polygons table */
+    ret = create_polygons (db_handle);
+    if (!ret)
+      {
+	sqlite3_close (db_handle);
+	return -8;
+      }
+
+/* Testing PointInPolygonJoin - #1 (single thread) */
+    ret = test_pip_join (db_handle, "pip_join1", 1);
+    if (!ret)
+      {
+	fprintf (stderr, "Check PointInPolygonJoin #1: unexpected failure\n");
+	sqlite3_close (db_handle);
+	return -9;
+      }
+
+/* Testing PointInPolygonJoin - #2 (parallel threads) */
+    ret = test_pip_join (db_handle, "pip_join2", 4);
+    if (!ret)
+      {
+	fprintf (stderr, "Check PointInPolygonJoin #2: unexpected failure\n");
+	sqlite3_close (db_handle);
+	return -10;
+      }
+
+/* Testing PointInPolygonJoin - #3 (already existing output table) */
+    ret =
+	count_rows (db_handle,
+		    "SELECT 1 WHERE PointInPolygonJoin('points', 'geom', "
+		    "'polys', 'geom', 'pip_join1') IS NULL", &rows);
+    if (!ret || rows != 1)
+      {
+	  fprintf (stderr, "Check PointInPolygonJoin #3: unexpected success\n");
+	  sqlite3_close (db_handle);
+	  return -11;
+      }
+
+#endif /* end GEOS conditional */
+
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    spatialite_shutdown ();
+
+    return 0;
+}
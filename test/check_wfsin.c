@@ -51,6 +51,16 @@ the terms of any one of the MPL, the GPL or the LGPL.
 #include "spatialite.h"
 #include "spatialite/gg_wfs.h"
 
+#ifdef ENABLE_LIBXML2		/* only if LIBXML2 is supported */
+static void
+progress_callback (int rows, void *ptr)
+{
+/* saving the last notified row count */
+    int *last_rows = (int *) ptr;
+    *last_rows = rows;
+}
+#endif
+
 int
 main (int argc, char *argv[])
 {
@@ -70,6 +80,11 @@ main (int argc, char *argv[])
     int type;
     int dims;
     int nillable;
+    int last_rows = -1;
+    char cwd[4096];
+    char **results;
+    int rows;
+    int columns;
 #endif
     void *cache = spatialite_alloc_connection ();
 
@@ -139,6 +154,62 @@ main (int argc, char *argv[])
 	  return -6;
       }
 
+/* streaming a local file:// URL */
+    if (getcwd (cwd, sizeof (cwd)) == NULL)
+      {
+	  fprintf (stderr, "getcwd() error\n");
+	  sqlite3_close (handle);
+	  return -78;
+      }
+    str = sqlite3_mprintf ("file://%s/test.wfs", cwd);
+    ret =
+	load_from_wfs (handle, str, NULL, "topp:p02", 0, "test_wfs3",
+		       "objectid", 0, &row_count, &err_msg, progress_callback,
+		       &last_rows);
+    sqlite3_free (str);
+    if (!ret)
+      {
+	  fprintf (stderr, "load_from_wfs() error for test.wfs (3): %s\n",
+		   err_msg);
+	  free (err_msg);
+	  sqlite3_close (handle);
+	  return -79;
+      }
+    if (row_count != 3 || last_rows != 3)
+      {
+	  fprintf (stderr,
+		   "unexpected row count for test_wfs (3): %i (callback %i)\n",
+		   row_count, last_rows);
+	  sqlite3_close (handle);
+	  return -80;
+      }
+
+/* checking the directly decoded GML geometries */
+    ret =
+	sqlite3_get_table (handle,
+			   "SELECT AsText(a.geometry), Count(*) FROM test_wfs1 AS a "
+			   "JOIN test_wfs3 AS b ON (a.objectid = b.objectid "
+			   "AND a.geometry = b.geometry) WHERE a.objectid = 400041",
+			   &results, &rows, &columns, &err_msg);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "Error: %s\n", err_msg);
+	  sqlite3_free (err_msg);
+	  sqlite3_close (handle);
+	  return -81;
+      }
+    if (rows != 1 || results[2] == NULL || results[3] == NULL
+	|| strcmp (results[2], "POINT(664642.363686 5169415.339218)") != 0
+	|| strcmp (results[3], "1") != 0)
+      {
+	  fprintf (stderr, "unexpected test_wfs geometry: %s\n",
+		   results[2] ? results[2] : "NULL");
+	  sqlite3_free_table (results);
+	  sqlite3_close (handle);
+	  return -82;
+      }
+    sqlite3_free_table (results);
+
     catalog = create_wfs_catalog ("./getcapabilities-1.0.0.wfs", &err_msg);
     if (catalog == NULL)
       {
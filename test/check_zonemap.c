@@ -0,0 +1,339 @@
+/*
+
+ check_zonemap.c -- SpatiaLite Test Case
+
+ Author: Sandro Furieri <a.furieri@lqt.it>
+
+ ------------------------------------------------------------------------------
+
+ Version: MPL 1.1/GPL 2.0/LGPL 2.1
+
+ The contents of this file are subject to the Mozilla Public License Version
+ 1.1 (the "License"); you may not use this file except in compliance with
+ the License. You may obtain a copy of the License at
+ http://www.mozilla.org/MPL/
+
+Software distributed under the License is distributed on an "AS IS" basis,
+WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License
+for the specific language governing rights and limitations under the
+License.
+
+The Original Code is the SpatiaLite library
+
+The Initial Developer of the Original Code is Alessandro Furieri
+
+Portions created by the Initial Developer are Copyright (C) 2015
+the Initial Developer. All Rights Reserved.
+
+Contributor(s):
+
+Alternatively, the contents of this file may be used under the terms of
+either the GNU General Public License Version 2 or later (the "GPL"), or
+the GNU Lesser General Public License Version 2.1 or later (the "LGPL"),
+in which case the provisions of the GPL or the LGPL are applicable instead
+of those above. If you wish to allow use of your version of this file only
+under the terms of either the GPL or the LGPL, and not to allow others to
+use your version of this file under the terms of the MPL, indicate your
+decision by deleting the provisions above and replace them with the notice
+and other provisions required by the GPL or the LGPL. If you do not delete
+the provisions above, a recipient may use your version of this file under
+the terms of any one of the MPL, the GPL or the LGPL.
+
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+
+#include "sqlite3.h"
+#include "spatialite.h"
+
+struct zonemap_check
+{
+/* an SQL query expected to return a single Integer */
+    const char *sql;
+    int expected;
+};
+
+/* the candidate rows of a 10x10 window around POINT(355 5) */
+#define ZM_PRUNED "SELECT Count(*) FROM \"zm_pts_geom\" AS z JOIN pts AS t " \
+    "ON (t.ROWID BETWEEN z.first_rowid AND z.last_rowid) " \
+    "WHERE z.maxx >= 350 AND z.minx <= 360 AND z.maxy >= 0 AND z.miny <= 10"
+
+static int
+query_int (sqlite3 * sqlite, const char *sql, int *value, int *full_scan)
+{
+/* executing an SQL query returning a single Integer */
+    sqlite3_stmt *stmt;
+    int ret;
+    int ok = 0;
+
+    *value = 0;
+    ret = sqlite3_prepare_v2 (sqlite, sql, strlen (sql), &stmt, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+	  return 0;
+      }
+    ret = sqlite3_step (stmt);
+    if (ret == SQLITE_ROW || ret == SQLITE_DONE)
+      {
+	  if (ret == SQLITE_ROW)
+	      *value = sqlite3_column_int (stmt, 0);
+	  ok = 1;
+      }
+    else
+	fprintf (stderr, "\"%s\" error: %s\n", sql, sqlite3_errmsg (sqlite));
+    if (full_scan != NULL)
+	*full_scan =
+	    sqlite3_stmt_status (stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 0);
+    sqlite3_finalize (stmt);
+    return ok;
+}
+
+static int
+do_test_pruning (sqlite3 * sqlite)
+{
+/* the ZoneMap must avoid a full scan of the main table */
+    int value;
+    int pruned_scan;
+    int brute_scan;
+
+    if (!query_int (sqlite, ZM_PRUNED, &value, &pruned_scan))
+	return -20;
+    if (value != 100)
+      {
+	  fprintf (stderr, "ZoneMap candidates: got %d expected 100\n", value);
+	  return -21;
+      }
+    if (!query_int
+	(sqlite,
+	 "SELECT Count(*) FROM pts WHERE MbrIntersects(geom, "
+	 "BuildMbr(350, 0, 360, 10))", &value, &brute_scan))
+	return -22;
+    if (value != 11)
+      {
+	  fprintf (stderr, "brute force: got %d expected 11\n", value);
+	  return -23;
+      }
+    if (pruned_scan >= 100 || brute_scan < 1000)
+      {
+	  fprintf (stderr, "no pruning: %d full scan steps (brute force %d)\n",
+		   pruned_scan, brute_scan);
+	  return -24;
+      }
+    return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+    sqlite3 *db_handle = NULL;
+    int ret;
+    int i;
+    int value;
+    char *err_msg = NULL;
+    void *cache = spatialite_alloc_connection ();
+    const char *setup[] = {
+	"SELECT InitSpatialMetadata(1)",
+	"CREATE TABLE pts (id INTEGER PRIMARY KEY, name TEXT)",
+	"SELECT AddGeometryColumn('pts', 'geom', 4326, 'POINT', 'XY')",
+	"WITH RECURSIVE s(n) AS (SELECT 1 UNION ALL SELECT n + 1 FROM s "
+	    "WHERE n < 1000) INSERT INTO pts (id, name, geom) "
+	    "SELECT n, 'p' || n, MakePoint(n, n % 10, 4326) FROM s",
+	"INSERT INTO pts (id, name, geom) VALUES (1001, 'null', NULL)",
+	"SELECT CreateZoneMap('pts', 'geom', 100)",
+	NULL
+    };
+    struct zonemap_check checks[] = {
+	/* initial population */
+	{"SELECT Count(*) FROM \"zm_pts_geom\"", 11},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 3 "
+	 "AND first_rowid = 300 AND last_rowid = 399 AND minx = 300 "
+	 "AND miny = 0 AND maxx = 399 AND maxy = 9", 1},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 0 "
+	 "AND minx = 1 AND maxx = 99", 1},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 10 "
+	 "AND minx = 1000 AND maxx = 1000", 1},
+	{"SELECT Count(*) FROM sqlite_master WHERE type = 'trigger' "
+	 "AND name IN ('zmi_pts_geom', 'zmu_pts_geom')", 2},
+	/* rebuilding is allowed */
+	{"SELECT CreateZoneMap('pts', 'geom', 100)", 1},
+	{"SELECT Count(*) FROM \"zm_pts_geom\"", 11},
+	/* INSERT widening an existing block */
+	{"INSERT INTO pts (id, name, geom) VALUES (1002, 'far', "
+	 "MakePoint(5000, 50, 4326))", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 10 "
+	 "AND minx = 1000 AND miny = 0 AND maxx = 5000 AND maxy = 50", 1},
+	/* INSERT starting a new block */
+	{"INSERT INTO pts (id, name, geom) VALUES (2550, 'new', "
+	 "MakePoint(-5, -5, 4326))", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 25 "
+	 "AND first_rowid = 2500 AND last_rowid = 2599 AND minx = -5 "
+	 "AND maxx = -5", 1},
+	/* negative ROWIDs */
+	{"INSERT INTO pts (id, name, geom) VALUES (-1, 'neg', "
+	 "MakePoint(7, 7, 4326))", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = -1 "
+	 "AND first_rowid = -100 AND last_rowid = -1", 1},
+	/* NULL Geometries are simply ignored */
+	{"INSERT INTO pts (id, name, geom) VALUES (9000, 'null', NULL)", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\"", 13},
+	/* UPDATE widening an existing block */
+	{"UPDATE pts SET geom = MakePoint(-10, -20, 4326) WHERE id = 305", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 3 "
+	 "AND minx = -10 AND miny = -20 AND maxx = 399 AND maxy = 9", 1},
+	/* the moved row is still found through the ZoneMap */
+	{"SELECT Count(*) FROM \"zm_pts_geom\" AS z JOIN pts AS t "
+	 "ON (t.ROWID BETWEEN z.first_rowid AND z.last_rowid) "
+	 "WHERE z.maxx >= -11 AND z.minx <= -9 AND z.maxy >= -21 "
+	 "AND z.miny <= -19 AND MbrIntersects(t.geom, "
+	 "BuildMbr(-11, -21, -9, -19))", 1},
+	/* UPDATE of another column leaves the ZoneMap unchanged */
+	{"UPDATE pts SET name = 'renamed' WHERE id = 1002", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\"", 13},
+	/* dropping */
+	{"SELECT DropZoneMap('pts', 'geom')", 1},
+	{"SELECT Count(*) FROM sqlite_master WHERE name IN "
+	 "('zm_pts_geom', 'zmi_pts_geom', 'zmu_pts_geom')", 0},
+	{"INSERT INTO pts (id, name, geom) VALUES (9001, 'after', "
+	 "MakePoint(1, 1, 4326))", 0},
+	/* tracking attribute min/max */
+	{"SELECT CreateZoneMap('pts', 'geom', 100, 'id, NAME')", 1},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 3 "
+	 "AND min_id = 300 AND max_id = 399 AND min_name = 'p300' "
+	 "AND max_name = 'p399'", 1},
+	/* a block containing only NULL Geometries */
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 90 "
+	 "AND minx IS NULL AND min_id = 9000 AND max_id = 9001", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 90 "
+	 "AND minx = 1 AND min_id = 9000 AND max_id = 9001", 1},
+	{"INSERT INTO pts (id, name, geom) VALUES (7000, 'q', NULL)", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 70 "
+	 "AND minx IS NULL AND min_id = 7000 AND max_name = 'q'", 1},
+	{"UPDATE pts SET geom = MakePoint(3, 4, 4326), name = 'a' "
+	 "WHERE id = 7000", 0},
+	{"SELECT Count(*) FROM \"zm_pts_geom\" WHERE block_id = 70 "
+	 "AND minx = 3 AND maxy = 4 AND min_name = 'a' AND max_name = 'q'", 1},
+	/* the VirtualZoneMap module */
+	{"CREATE VIRTUAL TABLE ZoneMap USING VirtualZoneMap()", 0},
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND search_frame = BuildMbr(350, 0, 360, 10)", 100},
+	{"SELECT Count(*) FROM pts WHERE ROWID IN (SELECT ROWID FROM ZoneMap "
+	 "WHERE f_table_name = 'pts' AND f_geometry_column = 'geom' "
+	 "AND search_frame = BuildMbr(350, 0, 360, 10)) "
+	 "AND MbrIntersects(geom, BuildMbr(350, 0, 360, 10))", 11},
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND attribute = 'id' AND min_value = 7000 AND max_value = 7000", 1},
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND attribute = 'id' AND min_value = 9000", 2},
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND attribute = 'id' AND max_value = -1", 1},
+	/* TEXT values are compared by their collating order */
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND attribute = 'name' AND min_value = 'p500' "
+	 "AND max_value = 'p500'", 203},
+	{"SELECT Count(*) FROM pts WHERE ROWID IN (SELECT ROWID FROM ZoneMap "
+	 "WHERE f_table_name = 'pts' AND attribute = 'name' "
+	 "AND min_value = 'p500' AND max_value = 'p500') AND name = 'p500'", 1},
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND search_frame = BuildMbr(2, 3, 4, 5) AND attribute = 'id' "
+	 "AND min_value = 5000", 1},
+	{"SELECT Count(*) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND search_frame = NULL", 0},
+	{"SELECT Sum(block_id = 3) FROM ZoneMap WHERE f_table_name = 'pts' "
+	 "AND attribute = 'id' AND min_value = 305 AND max_value = 305", 100},
+	{NULL, 0}
+    };
+    const char *errors[] = {
+	"SELECT ROWID FROM ZoneMap WHERE f_table_name = 'pts' "
+	    "AND attribute = 'id'",
+	"SELECT ROWID FROM ZoneMap WHERE f_table_name = 'pts' "
+	    "AND attribute = 'value' AND min_value = 1",
+	"SELECT ROWID FROM ZoneMap WHERE f_table_name = 'pts' "
+	    "AND search_frame = 'abc'",
+	"SELECT ROWID FROM ZoneMap WHERE f_table_name = 'none' "
+	    "AND search_frame = BuildMbr(0, 0, 1, 1)",
+	NULL
+    };
+
+    if (argc > 1 || argv[0] == NULL)
+	argc = 1;		/* silencing stupid compiler warnings */
+
+    ret =
+	sqlite3_open_v2 (":memory:", &db_handle,
+			 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK)
+      {
+	  fprintf (stderr, "cannot open in-memory db: %s\n",
+		   sqlite3_errmsg (db_handle));
+	  sqlite3_close (db_handle);
+	  db_handle = NULL;
+	  return -1;
+      }
+
+    spatialite_init_ex (db_handle, cache, 0);
+
+    for (i = 0; setup[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (db_handle, setup[i], NULL, NULL, &err_msg);
+	  if (ret != SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\" error: %s\n", setup[i], err_msg);
+		sqlite3_free (err_msg);
+		sqlite3_close (db_handle);
+		spatialite_cleanup_ex (cache);
+		return -2;
+	    }
+      }
+
+    ret = do_test_pruning (db_handle);
+    if (ret != 0)
+	goto end;
+
+    for (i = 0; checks[i].sql != NULL; i++)
+      {
+	  if (!query_int (db_handle, checks[i].sql, &value, NULL))
+	    {
+		ret = -3;
+		goto end;
+	    }
+	  if (value != checks[i].expected)
+	    {
+		fprintf (stderr, "\"%s\"\nunexpected result: %d (expected %d)\n",
+			 checks[i].sql, value, checks[i].expected);
+		ret = -4;
+		goto end;
+	    }
+      }
+
+/* invalid ZoneMap queries are expected to fail */
+    for (i = 0; errors[i] != NULL; i++)
+      {
+	  ret = sqlite3_exec (db_handle, errors[i], NULL, NULL, &err_msg);
+	  if (ret == SQLITE_OK)
+	    {
+		fprintf (stderr, "\"%s\"\nunexpected success\n", errors[i]);
+		ret = -5;
+		goto end;
+	    }
+	  sqlite3_free (err_msg);
+	  err_msg = NULL;
+      }
+    if (!query_int
+	(db_handle, "SELECT CreateZoneMap('pts', 'geom', 100, 'id, unknown')",
+	 &value, NULL) || value != -1)
+      {
+	  fprintf (stderr, "CreateZoneMap(): unknown attribute accepted\n");
+	  ret = -6;
+	  goto end;
+      }
+    ret = 0;
+
+  end:
+    sqlite3_close (db_handle);
+    spatialite_cleanup_ex (cache);
+    spatialite_shutdown ();
+    return ret;
+}